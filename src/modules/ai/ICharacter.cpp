@@ -0,0 +1,18 @@
+/**
+ * @file
+ */
+
+#include "ICharacter.h"
+#include "group/GroupMgr.h"
+
+namespace ai {
+
+void ICharacter::setPosition(const glm::vec3& position) {
+	_position = position;
+	GroupMgr* groupMgr = _groupMgr.load(std::memory_order_acquire);
+	if (groupMgr != nullptr) {
+		groupMgr->onMoved(*this);
+	}
+}
+
+}
@@ -13,6 +13,8 @@
 
 namespace ai {
 
+class GroupMgr;
+
 /**
  * @brief Defines some standard names for @c ICharacter attributes. None of these must be used. But if you
  * use them, the remote debugger can make use of known values to render more information into the view.
@@ -50,6 +52,12 @@ typedef std::unordered_map<std::string, std::string> CharacterAttributes;
  * @ai{character_cast} function in your @ai{TreeNode}, @ai{IFilter} or @ai{ICondition} implementations.
  */
 class ICharacter : public NonCopyable, public std::enable_shared_from_this<ICharacter> {
+private:
+	friend class GroupMgr;
+	// the group manager that is notified about position changes as long as the character is in a group
+	std::atomic<GroupMgr*> _groupMgr;
+	std::atomic_bool _groupMoveScheduled;
+
 protected:
 	const CharacterId _id;
 	glm::vec3 _position;
@@ -60,7 +68,7 @@ protected:
 
 public:
 	explicit ICharacter(CharacterId id) :
-			_id(id), _orientation(0.0f), _speed(0.0f) {
+			_groupMgr(nullptr), _groupMoveScheduled(false), _id(id), _orientation(0.0f), _speed(0.0f) {
 	}
 
 	virtual ~ICharacter() {
@@ -72,7 +80,8 @@ public:
 	CharacterId getId() const;
 	/**
 	 * @note This is virtual because you might want to override this in your implementation to
-	 * make sure that the new position is also forwarded to your AI controlled entity.
+	 * make sure that the new position is also forwarded to your AI controlled entity. Make sure to
+	 * call the base implementation - it updates the position of the groups the character is part of.
 	 */
 	virtual void setPosition(const glm::vec3& position);
 
@@ -133,10 +142,6 @@ public:
 	}
 };
 
-inline void ICharacter::setPosition(const glm::vec3& position) {
-	_position = position;
-}
-
 inline void ICharacter::setOrientation (float orientation) {
 	_orientation = orientation;
 }
@@ -0,0 +1,109 @@
+/**
+ * @file
+ */
+
+#include "core/benchmark/AbstractBenchmark.h"
+#include "AI.h"
+#include "ICharacter.h"
+#include "movement/BatchedSteering.h"
+#include "movement/TargetSeek.h"
+#include "movement/Wander.h"
+#include "movement/WeightedSteering.h"
+#include <vector>
+
+class MovementBenchmark: public core::AbstractBenchmark {
+protected:
+	std::vector<ai::AIPtr> _ais;
+	const int64_t _deltaMillis = 100;
+
+	void createCharacters(int amount) {
+		_ais.clear();
+		_ais.reserve(amount);
+		for (int i = 0; i < amount; ++i) {
+			const ai::AIPtr& ai = std::make_shared<ai::AI>(ai::TreeNodePtr());
+			const ai::ICharacterPtr& chr = std::make_shared<ai::ICharacter>(i + 1);
+			chr->setPosition(glm::vec3((float)(i % 100), 0.0f, (float)(i / 100)));
+			chr->setOrientation((float)i);
+			chr->setSpeed(10.0f);
+			ai->setCharacter(chr);
+			_ais.push_back(ai);
+		}
+	}
+
+	/**
+	 * @brief The same that the @c Steer node does in the behaviour tree tick
+	 */
+	void scalar(const ai::movement::WeightedSteering& w) {
+		const float deltaSeconds = static_cast<float>(_deltaMillis) / 1000.0f;
+		for (const ai::AIPtr& ai : _ais) {
+			const ai::ICharacterPtr& chr = ai->getCharacter();
+			const ai::MoveVector& mv = w.execute(ai, chr->getSpeed());
+			chr->setPosition(chr->getPosition() + (mv.getVector() * deltaSeconds));
+			chr->setOrientation(fmodf(chr->getOrientation() + mv.getRotation() * deltaSeconds, glm::two_pi<float>()));
+		}
+	}
+
+	void batched(ai::movement::BatchedSteering& batched, const ai::movement::WeightedSteering& w) {
+		for (const ai::AIPtr& ai : _ais) {
+			batched.add(&w, ai, _deltaMillis);
+		}
+		batched.execute();
+	}
+
+	static ai::movement::WeightedSteering wander() {
+		ai::movement::WeightedSteerings s;
+		s.push_back(ai::movement::WeightedData(std::make_shared<ai::movement::Wander>("")));
+		return ai::movement::WeightedSteering(s);
+	}
+
+	static ai::movement::WeightedSteering seek() {
+		ai::movement::WeightedSteerings s;
+		s.push_back(ai::movement::WeightedData(std::make_shared<ai::movement::TargetSeek>("50:0:50")));
+		return ai::movement::WeightedSteering(s);
+	}
+};
+
+BENCHMARK_DEFINE_F(MovementBenchmark, wanderScalar) (benchmark::State& state) {
+	createCharacters(state.range(0));
+	const ai::movement::WeightedSteering& w = wander();
+	for (auto _ : state) {
+		scalar(w);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_DEFINE_F(MovementBenchmark, wanderBatched) (benchmark::State& state) {
+	createCharacters(state.range(0));
+	const ai::movement::WeightedSteering& w = wander();
+	ai::movement::BatchedSteering b;
+	for (auto _ : state) {
+		batched(b, w);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_DEFINE_F(MovementBenchmark, seekScalar) (benchmark::State& state) {
+	createCharacters(state.range(0));
+	const ai::movement::WeightedSteering& w = seek();
+	for (auto _ : state) {
+		scalar(w);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_DEFINE_F(MovementBenchmark, seekBatched) (benchmark::State& state) {
+	createCharacters(state.range(0));
+	const ai::movement::WeightedSteering& w = seek();
+	ai::movement::BatchedSteering b;
+	for (auto _ : state) {
+		batched(b, w);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_REGISTER_F(MovementBenchmark, wanderScalar)->Arg(1000)->Arg(10000);
+BENCHMARK_REGISTER_F(MovementBenchmark, wanderBatched)->Arg(1000)->Arg(10000);
+BENCHMARK_REGISTER_F(MovementBenchmark, seekScalar)->Arg(1000)->Arg(10000);
+BENCHMARK_REGISTER_F(MovementBenchmark, seekBatched)->Arg(1000)->Arg(10000);
+
+BENCHMARK_MAIN();
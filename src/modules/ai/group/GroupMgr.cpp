@@ -3,155 +3,303 @@
  */
 
 #include "GroupMgr.h"
+#include <algorithm>
 
 namespace ai {
 
-struct AveragePositionFunctor {
-	glm::vec3 operator()(const glm::vec3& result, const AIPtr& ai) {
-		return ai->getCharacter()->getPosition() + result;
+GroupMgr::~GroupMgr() {
+	for (auto& e : _memberships) {
+		e.first->_groupMgr.store(nullptr, std::memory_order_release);
 	}
-};
+}
+
+int GroupMgr::slot(GroupId id) const {
+	auto i = _slots.find(id);
+	if (i == _slots.end()) {
+		return -1;
+	}
+	return i->second;
+}
+
+const GroupMgr::MemberRefs* GroupMgr::memberships(const AIPtr& ai) const {
+	if (!ai) {
+		return nullptr;
+	}
+	auto i = _memberships.find(ai->getCharacter().get());
+	if (i == _memberships.end()) {
+		return nullptr;
+	}
+	return &i->second;
+}
+
+void GroupMgr::onMoved(ICharacter& chr) {
+	if (_deferred.load(std::memory_order_acquire)) {
+		// only remember the character once - the current position is picked up in update()
+		if (chr._groupMoveScheduled.exchange(true, std::memory_order_acq_rel)) {
+			return;
+		}
+		ScopedWriteLock scopedLock(_scheduleLock);
+		_moved.push_back(&chr);
+		return;
+	}
+	ScopedWriteLock scopedLock(_lock);
+	doMove(chr);
+}
+
+void GroupMgr::doMove(ICharacter& chr) {
+	auto i = _memberships.find(&chr);
+	if (i == _memberships.end()) {
+		return;
+	}
+	const glm::vec3& pos = chr.getPosition();
+	for (const MemberRef& r : i->second) {
+		Group& group = _groups[r.group];
+		glm::vec3& oldPos = group.positions[r.index];
+		group.sum += pos - oldPos;
+		oldPos = pos;
+		group.position = group.sum * (1.0f / (float) group.members.size());
+	}
+}
+
+bool GroupMgr::schedule(ScheduledChange::Type type, GroupId id, const AIPtr& ai) {
+	if (!_deferred.load(std::memory_order_acquire)) {
+		return false;
+	}
+	ScopedWriteLock scopedLock(_scheduleLock);
+	_scheduled.push_back(ScheduledChange{type, id, ai});
+	return true;
+}
+
+void GroupMgr::beginUpdate() {
+	ScopedWriteLock scopedLock(_lock);
+	_deferred.store(true, std::memory_order_release);
+}
 
 void GroupMgr::update(int64_t) {
-	ScopedReadLock scopedLock(_lock);
-	for (auto i = _groups.begin(); i != _groups.end(); ++i) {
-		Group& group = i->second;
-		glm::vec3 averagePosition(0.0f);
-		{
-			ScopedReadLock lock(_groupLock);
-			averagePosition = std::accumulate(group.members.begin(), group.members.end(), glm::vec3(0.0f), AveragePositionFunctor());
-			averagePosition *= 1.0f / (float) group.members.size();
+	std::vector<ScheduledChange> scheduled;
+	std::vector<ICharacter*> moved;
+	{
+		ScopedWriteLock scopedLock(_scheduleLock);
+		scheduled.swap(_scheduled);
+		moved.swap(_moved);
+	}
+
+	ScopedWriteLock scopedLock(_lock);
+	_deferred.store(false, std::memory_order_release);
+	// the moved characters are still members here - the scheduled removals are applied afterwards
+	for (ICharacter* chr : moved) {
+		chr->_groupMoveScheduled.store(false, std::memory_order_release);
+		doMove(*chr);
+	}
+	for (const ScheduledChange& change : scheduled) {
+		switch (change.type) {
+		case ScheduledChange::Type::Add:
+			doAdd(change.id, change.ai);
+			break;
+		case ScheduledChange::Type::Remove:
+			doRemove(change.id, change.ai);
+			break;
+		case ScheduledChange::Type::RemoveAll:
+			doRemoveFromAllGroups(change.ai);
+			break;
 		}
-		ScopedWriteLock lock(_groupLock);
-		group.position = averagePosition;
 	}
 }
 
 bool GroupMgr::add(GroupId id, const AIPtr& ai) {
+	if (schedule(ScheduledChange::Type::Add, id, ai)) {
+		return !doIsInGroup(id, ai);
+	}
 	ScopedWriteLock scopedLock(_lock);
-	GroupsIter i = _groups.find(id);
-	if (i == _groups.end()) {
-		Group group;
+	return doAdd(id, ai);
+}
+
+bool GroupMgr::doAdd(GroupId id, const AIPtr& ai) {
+	if (doIsInGroup(id, ai)) {
+		return false;
+	}
+	int s = slot(id);
+	if (s == -1) {
+		if (_freeSlots.empty()) {
+			s = (int)_groups.size();
+			_groups.emplace_back();
+		} else {
+			s = _freeSlots.back();
+			_freeSlots.pop_back();
+		}
+		_slots.insert(std::make_pair(id, s));
+		Group& group = _groups[s];
+		group.id = id;
 		group.leader = ai;
-		i = _groups.insert(std::pair<GroupId, Group>(id, group)).first;
+		group.sum = glm::vec3(0.0f);
 	}
 
-	Group& group = i->second;
-	ScopedWriteLock lock(_groupLock);
-	std::pair<GroupMembersSetIter, bool> ret = group.members.insert(ai);
-	if (ret.second) {
-		_groupMembers.insert(GroupMembers::value_type(ai, id));
-		return true;
+	Group& group = _groups[s];
+	ICharacter* chr = ai->getCharacter().get();
+	const glm::vec3& pos = chr->getPosition();
+	MemberRefs& refs = _memberships[chr];
+	if (refs.empty()) {
+		chr->_groupMgr.store(this, std::memory_order_release);
 	}
-	return false;
+	refs.push_back(MemberRef{s, (int)group.members.size()});
+	group.members.push_back(ai);
+	group.positions.push_back(pos);
+	group.sum += pos;
+	group.position = group.sum * (1.0f / (float) group.members.size());
+	return true;
 }
 
 bool GroupMgr::remove(GroupId id, const AIPtr& ai) {
+	if (schedule(ScheduledChange::Type::Remove, id, ai)) {
+		return doIsInGroup(id, ai);
+	}
 	ScopedWriteLock scopedLock(_lock);
-	const GroupsIter& i = _groups.find(id);
-	if (i == _groups.end()) {
+	return doRemove(id, ai);
+}
+
+bool GroupMgr::doRemove(GroupId id, const AIPtr& ai) {
+	const int s = slot(id);
+	if (s == -1 || !ai) {
 		return false;
 	}
-	Group& group = i->second;
-	GroupMembersSetIter si;
-	{
-		ScopedReadLock lock(_groupLock);
-		si = group.members.find(ai);
-		if (si == group.members.end()) {
-			return false;
-		}
+	ICharacter* chr = ai->getCharacter().get();
+	auto mi = _memberships.find(chr);
+	if (mi == _memberships.end()) {
+		return false;
 	}
-	{
-		ScopedWriteLock lock(_groupLock);
-		group.members.erase(si);
-		if (group.members.empty()) {
-			_groups.erase(i);
-		} else if (group.leader == ai) {
-			group.leader = *group.members.begin();
-		}
+	MemberRefs& refs = mi->second;
+	auto ref = std::find_if(refs.begin(), refs.end(), [s] (const MemberRef& r) { return r.group == s; });
+	if (ref == refs.end()) {
+		return false;
+	}
+	const int index = ref->index;
+	refs.erase(ref);
+	if (refs.empty()) {
+		_memberships.erase(mi);
+		chr->_groupMgr.store(nullptr, std::memory_order_release);
 	}
 
-	auto range = _groupMembers.equal_range(ai);
-	for (auto it = range.first; it != range.second; ++it) {
-		if (it->second == id) {
-			_groupMembers.erase(it);
-			break;
+	Group& group = _groups[s];
+	const int last = (int)group.members.size() - 1;
+	group.sum -= group.positions[index];
+	if (index != last) {
+		// swap the last member into the free index and fix its back reference
+		group.members[index] = std::move(group.members[last]);
+		group.positions[index] = group.positions[last];
+		MemberRefs& movedRefs = _memberships[group.members[index]->getCharacter().get()];
+		for (MemberRef& r : movedRefs) {
+			if (r.group == s) {
+				r.index = index;
+				break;
+			}
 		}
 	}
+	group.members.pop_back();
+	group.positions.pop_back();
+
+	if (group.members.empty()) {
+		group.leader = AIPtr();
+		group.id = -1;
+		_slots.erase(id);
+		_freeSlots.push_back(s);
+		return true;
+	}
+	if (group.leader == ai) {
+		group.leader = group.members.front();
+	}
+	group.position = group.sum * (1.0f / (float) group.members.size());
 	return true;
 }
 
 bool GroupMgr::removeFromAllGroups(const AIPtr& ai) {
-	std::list<GroupId> groups;
-	{
-		ScopedReadLock scopedLock(_lock);
-		auto range = _groupMembers.equal_range(ai);
-		for (auto it = range.first; it != range.second; ++it) {
-			groups.push_back(it->second);
-		}
+	if (schedule(ScheduledChange::Type::RemoveAll, -1, ai)) {
+		return true;
+	}
+	ScopedWriteLock scopedLock(_lock);
+	return doRemoveFromAllGroups(ai);
+}
+
+bool GroupMgr::doRemoveFromAllGroups(const AIPtr& ai) {
+	const MemberRefs* refs = memberships(ai);
+	if (refs == nullptr) {
+		return true;
+	}
+	std::vector<GroupId> groups;
+	groups.reserve(refs->size());
+	for (const MemberRef& r : *refs) {
+		groups.push_back(_groups[r.group].id);
 	}
 	for (GroupId groupId : groups) {
-		remove(groupId, ai);
+		doRemove(groupId, ai);
 	}
 	return true;
 }
 
 AIPtr GroupMgr::getLeader(GroupId id) const {
-	ScopedReadLock scopedLock(_lock);
-	const GroupsConstIter& i = _groups.find(id);
-	if (i == _groups.end()) {
+	ScopedGroupReadLock scopedLock(*this);
+	const int s = slot(id);
+	if (s == -1) {
 		return AIPtr();
 	}
-
-	ScopedReadLock lock(_groupLock);
-	return i->second.leader;
+	return _groups[s].leader;
 }
 
 glm::vec3 GroupMgr::getPosition(GroupId id) const {
-	ScopedReadLock scopedLock(_lock);
-	const GroupsConstIter& i = _groups.find(id);
-	if (i == _groups.end()) {
+	ScopedGroupReadLock scopedLock(*this);
+	const int s = slot(id);
+	if (s == -1) {
 		return VEC3_INFINITE;
 	}
-
-	ScopedReadLock lock(_groupLock);
-	return i->second.position;
+	return _groups[s].position;
 }
 
 bool GroupMgr::isGroupLeader(GroupId id, const AIPtr& ai) const {
-	ScopedReadLock scopedLock(_lock);
-	const GroupsConstIter& i = _groups.find(id);
-	if (i == _groups.end()) {
-		return 0;
+	ScopedGroupReadLock scopedLock(*this);
+	const int s = slot(id);
+	if (s == -1) {
+		return false;
 	}
-	ScopedReadLock lock(_groupLock);
-	return i->second.leader == ai;
+	return _groups[s].leader == ai;
 }
 
 int GroupMgr::getGroupSize(GroupId id) const {
-	ScopedReadLock scopedLock(_lock);
-	const GroupsConstIter& i = _groups.find(id);
-	if (i == _groups.end()) {
+	ScopedGroupReadLock scopedLock(*this);
+	const int s = slot(id);
+	if (s == -1) {
 		return 0;
 	}
-	ScopedReadLock lock(_groupLock);
-	return static_cast<int>(std::distance(i->second.members.begin(), i->second.members.end()));
+	return static_cast<int>(_groups[s].members.size());
+}
+
+bool GroupMgr::doIsInAnyGroup(const AIPtr& ai) const {
+	return memberships(ai) != nullptr;
 }
 
 bool GroupMgr::isInAnyGroup(const AIPtr& ai) const {
-	ScopedReadLock scopedLock(_lock);
-	return _groupMembers.find(ai) != _groupMembers.end();
+	ScopedGroupReadLock scopedLock(*this);
+	return doIsInAnyGroup(ai);
 }
 
-bool GroupMgr::isInGroup(GroupId id, const AIPtr& ai) const {
-	ScopedReadLock scopedLock(_lock);
-	auto range = _groupMembers.equal_range(ai);
-	for (auto it = range.first; it != range.second; ++it) {
-		if (it->second == id) {
+bool GroupMgr::doIsInGroup(GroupId id, const AIPtr& ai) const {
+	const MemberRefs* refs = memberships(ai);
+	if (refs == nullptr) {
+		return false;
+	}
+	const int s = slot(id);
+	if (s == -1) {
+		return false;
+	}
+	for (const MemberRef& r : *refs) {
+		if (r.group == s) {
 			return true;
 		}
 	}
 	return false;
 }
 
+bool GroupMgr::isInGroup(GroupId id, const AIPtr& ai) const {
+	ScopedGroupReadLock scopedLock(*this);
+	return doIsInGroup(id, ai);
+}
+
 }
@@ -8,11 +8,10 @@
 #include "common/Math.h"
 #include "ICharacter.h"
 #include "AI.h"
-#include <map>
+#include <atomic>
 #include <memory>
-#include <numeric>
 #include <unordered_map>
-#include <unordered_set>
+#include <vector>
 
 namespace ai {
 
@@ -22,36 +21,111 @@ namespace ai {
  * remove it from the groups.
  *
  * Every @ai{Zone} has its own @c GroupMgr instance. It is automatically updated with the zone.
- * The average group position is only updated once per @c update() call.
+ *
+ * The groups are stored in a dense array that is indexed by a slot that is looked up once per
+ * @ai{GroupId}. The members of a group, their cached positions and the sum of these positions
+ * are stored in arrays of the group - every character knows the slots and the member indices of all
+ * the groups it is part of. The centroid of a group is maintained incrementally: adding or removing
+ * a member and moving a member via @ai{ICharacter::setPosition()} only applies the difference to the
+ * sum of the member positions - there is no per tick loop over all the members.
+ *
+ * While the zone executes the behaviour trees in parallel (see @c beginUpdate()), the group
+ * manager is read-only: all reads are done without locking, and @c add(), @c remove() and
+ * @c removeFromAllGroups() are scheduled and applied in the next @c update() call - the way the
+ * @ai{Zone} defers adding and removing @c AI instances.
  */
 class GroupMgr {
 private:
-	typedef std::unordered_set<AIPtr> GroupMembersSet;
-	typedef GroupMembersSet::iterator GroupMembersSetIter;
-	typedef GroupMembersSet::const_iterator GroupMembersSetConstIter;
-
-	ReadWriteLock _groupLock = {"groupmgr-group"};
 	struct Group {
+		GroupId id = -1;
 		AIPtr leader;
-		GroupMembersSet members;
-		glm::vec3 position;
+		std::vector<AIPtr> members;
+		// the positions of the members that are part of the sum
+		std::vector<glm::vec3> positions;
+		glm::vec3 sum {0.0f};
+		glm::vec3 position {0.0f};
+
+		inline bool valid() const {
+			return !members.empty();
+		}
+	};
+
+	/**
+	 * @brief The group slot and the index in the member arrays of that group
+	 */
+	struct MemberRef {
+		int group;
+		int index;
 	};
+	typedef std::vector<MemberRef> MemberRefs;
+
+	struct ScheduledChange {
+		enum class Type {
+			Add, Remove, RemoveAll
+		};
+		Type type;
+		GroupId id;
+		AIPtr ai;
+	};
+
+	mutable ReadWriteLock _lock = {"groupmgr"};
+	ReadWriteLock _scheduleLock = {"groupmgr-schedulelock"};
+	std::atomic_bool _deferred { false };
+
+	std::vector<Group> _groups;
+	std::vector<int> _freeSlots;
+	std::unordered_map<GroupId, int> _slots;
+	std::unordered_map<ICharacter*, MemberRefs> _memberships;
+	std::vector<ScheduledChange> _scheduled;
+	// the members that moved during the read-only phase
+	std::vector<ICharacter*> _moved;
+
+	int slot(GroupId id) const;
+	const MemberRefs* memberships(const AIPtr& ai) const;
 
-	typedef std::unordered_multimap<AIPtr, GroupId> GroupMembers;
-	typedef std::unordered_map<GroupId, Group> Groups;
-	typedef Groups::const_iterator GroupsConstIter;
-	typedef Groups::iterator GroupsIter;
+	friend class ICharacter;
+	/**
+	 * @brief Called by the character of a group member whenever its position changed
+	 */
+	void onMoved(ICharacter& chr);
+	void doMove(ICharacter& chr);
 
-	GroupMembersSet _empty;
-	ReadWriteLock _lock = {"groupmgr"};
-	Groups _groups;
-	GroupMembers _groupMembers;
+	bool doAdd(GroupId id, const AIPtr& ai);
+	bool doRemove(GroupId id, const AIPtr& ai);
+	bool doRemoveFromAllGroups(const AIPtr& ai);
+	bool doIsInGroup(GroupId id, const AIPtr& ai) const;
+	bool doIsInAnyGroup(const AIPtr& ai) const;
+
+	/**
+	 * @return @c true if the change was scheduled for the next @c update() call
+	 */
+	bool schedule(ScheduledChange::Type type, GroupId id, const AIPtr& ai);
+
+	/**
+	 * @brief Locks the group manager for reading - unless we are in the read-only phase of the zone update
+	 */
+	class ScopedGroupReadLock {
+	private:
+		const GroupMgr& _mgr;
+		const bool _locked;
+	public:
+		explicit ScopedGroupReadLock(const GroupMgr& mgr) :
+				_mgr(mgr), _locked(!mgr._deferred.load(std::memory_order_acquire)) {
+			if (_locked) {
+				_mgr._lock.lockRead();
+			}
+		}
+		~ScopedGroupReadLock() {
+			if (_locked) {
+				_mgr._lock.unlockRead();
+			}
+		}
+	};
 
 public:
 	GroupMgr () {
 	}
-	virtual ~GroupMgr () {
-	}
+	virtual ~GroupMgr ();
 
 	/**
 	 * @brief Adds a new group member to the given @ai{GroupId}. If the group does not yet
@@ -65,10 +139,22 @@ public:
 	 * whenever you destroy the @ai{AI} instance.
 	 * @return @c true if the add to the group was successful.
 	 *
-	 * @note This method performs a write lock on the group manager
+	 * @note This method performs a write lock on the group manager. Between @c beginUpdate() and
+	 * @c update() the add is scheduled and the return value is based on the state of the last tick.
 	 */
 	bool add(GroupId id, const AIPtr& ai);
 
+	/**
+	 * @brief Switches the group manager into the read-only phase. Until the next @c update()
+	 * call all reads are lock free and all modifications are scheduled.
+	 * @note This is called by the @ai{Zone} before the behaviour trees are executed
+	 */
+	void beginUpdate();
+
+	/**
+	 * @brief Applies the scheduled modifications and the positions of the members that moved in
+	 * the read-only phase that was started with @c beginUpdate() and ends this phase.
+	 */
 	void update(int64_t deltaTime);
 
 	/**
@@ -82,7 +168,8 @@ public:
 	 * @c false if the removal failed (e.g. the @ai{AI} instance was not part of
 	 * the group)
 	 *
-	 * @note This method performs a write lock on the group manager
+	 * @note This method performs a write lock on the group manager. Between @c beginUpdate() and
+	 * @c update() the removal is scheduled and the return value is based on the state of the last tick.
 	 */
 	bool remove(GroupId id, const AIPtr& ai);
 
@@ -98,7 +185,8 @@ public:
 	 * @brief Returns the average position of the group
 	 *
 	 * @note If the given group doesn't exist or some other error occurred, this method returns @c glm::vec3::VEC3_INFINITE
-	 * @note The position of a group is calculated once per @c update() call.
+	 * @note The position of a group is updated whenever a member is added, removed or moved. Between @c beginUpdate()
+	 * and @c update() these changes are deferred.
 	 *
 	 * @note This method performs a read lock on the group manager
 	 */
@@ -118,13 +206,12 @@ public:
 	 */
 	template<typename Func>
 	void visit(GroupId id, Func& func) const {
-		ScopedReadLock scopedLock(_lock);
-		const GroupsConstIter& i = _groups.find(id);
-		if (i == _groups.end()) {
+		ScopedGroupReadLock scopedLock(*this);
+		const int s = slot(id);
+		if (s == -1) {
 			return;
 		}
-		for (GroupMembersSetConstIter it = i->second.members.begin(); it != i->second.members.end(); ++it) {
-			const AIPtr& chr = *it;
+		for (const AIPtr& chr : _groups[s].members) {
 			if (!func(chr))
 				break;
 		}
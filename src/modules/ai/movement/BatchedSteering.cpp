@@ -0,0 +1,235 @@
+/**
+ * @file
+ */
+
+#include "BatchedSteering.h"
+#include "WeightedSteering.h"
+#include "AI.h"
+#include "ICharacter.h"
+#include "common/Random.h"
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <math.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AI_BATCH_SSE 1
+#include <emmintrin.h>
+#else
+#define AI_BATCH_SSE 0
+#endif
+
+namespace ai {
+namespace movement {
+
+namespace {
+
+/**
+ * @brief out[i] += in[i] * weight
+ */
+void weightedAdd(float* out, const float* in, float weight, size_t n) {
+	size_t i = 0u;
+#if AI_BATCH_SSE
+	const __m128 w = _mm_set1_ps(weight);
+	for (; i + 4u <= n; i += 4u) {
+		const __m128 o = _mm_loadu_ps(out + i);
+		_mm_storeu_ps(out + i, _mm_add_ps(o, _mm_mul_ps(_mm_loadu_ps(in + i), w)));
+	}
+#endif
+	for (; i < n; ++i) {
+		out[i] += in[i] * weight;
+	}
+}
+
+/**
+ * @brief Computes the direction to (seek) or away from (flee) the target and scales it by the speed of the character
+ *
+ * @param[in] sign @c 1.0 for seeking, @c -1.0 for fleeing
+ * @param[out] dirX The unnormalized x direction - used for the orientation
+ * @param[out] dirZ The unnormalized z direction - used for the orientation
+ */
+void seekKernel(const glm::vec3& target, float sign, const float* posX, const float* posY, const float* posZ, const float* speed,
+		float* velX, float* velY, float* velZ, float* dirX, float* dirZ, size_t n) {
+	size_t i = 0u;
+#if AI_BATCH_SSE
+	const __m128 s = _mm_set1_ps(sign);
+	const __m128 tx = _mm_set1_ps(target.x);
+	const __m128 ty = _mm_set1_ps(target.y);
+	const __m128 tz = _mm_set1_ps(target.z);
+	for (; i + 4u <= n; i += 4u) {
+		const __m128 dx = _mm_mul_ps(_mm_sub_ps(tx, _mm_loadu_ps(posX + i)), s);
+		const __m128 dy = _mm_mul_ps(_mm_sub_ps(ty, _mm_loadu_ps(posY + i)), s);
+		const __m128 dz = _mm_mul_ps(_mm_sub_ps(tz, _mm_loadu_ps(posZ + i)), s);
+		const __m128 len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+		const __m128 scale = _mm_div_ps(_mm_loadu_ps(speed + i), _mm_sqrt_ps(len2));
+		_mm_storeu_ps(velX + i, _mm_mul_ps(dx, scale));
+		_mm_storeu_ps(velY + i, _mm_mul_ps(dy, scale));
+		_mm_storeu_ps(velZ + i, _mm_mul_ps(dz, scale));
+		_mm_storeu_ps(dirX + i, dx);
+		_mm_storeu_ps(dirZ + i, dz);
+	}
+#endif
+	for (; i < n; ++i) {
+		const float dx = (target.x - posX[i]) * sign;
+		const float dy = (target.y - posY[i]) * sign;
+		const float dz = (target.z - posZ[i]) * sign;
+		const float scale = speed[i] / sqrtf(dx * dx + dy * dy + dz * dz);
+		velX[i] = dx * scale;
+		velY[i] = dy * scale;
+		velZ[i] = dz * scale;
+		dirX[i] = dx;
+		dirZ[i] = dz;
+	}
+}
+
+/**
+ * @brief pos[i] += vel[i] * scale * deltaSeconds[i]
+ */
+void integrate(float* pos, const float* vel, float scale, const float* deltaSeconds, size_t n) {
+	size_t i = 0u;
+#if AI_BATCH_SSE
+	const __m128 s = _mm_set1_ps(scale);
+	for (; i + 4u <= n; i += 4u) {
+		const __m128 v = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(vel + i), s), _mm_loadu_ps(deltaSeconds + i));
+		_mm_storeu_ps(pos + i, _mm_add_ps(_mm_loadu_ps(pos + i), v));
+	}
+#endif
+	for (; i < n; ++i) {
+		pos[i] += vel[i] * scale * deltaSeconds[i];
+	}
+}
+
+}
+
+bool BatchedSteering::add(const WeightedSteering* steering, const AIPtr& ai, int64_t deltaMillis) {
+	if (steering == nullptr || !steering->isBatchable()) {
+		return false;
+	}
+	const float deltaSeconds = static_cast<float>(deltaMillis) / 1000.0f;
+	ICharacterPtr chr = ai->getCharacter();
+	ScopedWriteLock scopedLock(_lock);
+	_entries.push_back(Entry{steering, std::move(chr), deltaSeconds});
+	return true;
+}
+
+size_t BatchedSteering::size() const {
+	ScopedReadLock scopedLock(_lock);
+	return _entries.size();
+}
+
+void BatchedSteering::resize(size_t n) {
+	for (std::vector<float>* v : {&_posX, &_posY, &_posZ, &_orientation, &_speed, &_deltaSeconds,
+			&_velX, &_velY, &_velZ, &_rotation,
+			&_kernelX, &_kernelY, &_kernelZ, &_kernelRotation, &_dirX, &_dirZ}) {
+		v->resize(n);
+	}
+}
+
+void BatchedSteering::executeGroup(const WeightedSteering* steering, const Entry* entries, size_t n) {
+	resize(n);
+
+	// gather
+	for (size_t i = 0u; i < n; ++i) {
+		const ICharacter* chr = entries[i].chr.get();
+		const glm::vec3& pos = chr->getPosition();
+		_posX[i] = pos.x;
+		_posY[i] = pos.y;
+		_posZ[i] = pos.z;
+		_orientation[i] = chr->getOrientation();
+		_speed[i] = chr->getSpeed();
+		_deltaSeconds[i] = entries[i].deltaSeconds;
+	}
+	std::fill(_velX.begin(), _velX.end(), 0.0f);
+	std::fill(_velY.begin(), _velY.end(), 0.0f);
+	std::fill(_velZ.begin(), _velZ.end(), 0.0f);
+	std::fill(_rotation.begin(), _rotation.end(), 0.0f);
+
+	// evaluate - batchable steerings never fail, so the total weight is the same for all characters
+	float totalWeight = 0.0f;
+	for (const WeightedBatchData& wbd : steering->getBatchData()) {
+		const BatchData& data = wbd.data;
+		const float weight = wbd.weight;
+		totalWeight += weight;
+		switch (data.kernel) {
+		case BatchKernel::Wander:
+			// trigonometry and the random numbers are evaluated in a scalar pass
+			for (size_t i = 0u; i < n; ++i) {
+				const float speed = _speed[i];
+				_kernelX[i] = cosf(_orientation[i]) * speed;
+				_kernelZ[i] = sinf(_orientation[i]) * speed;
+				_kernelRotation[i] = ai::randomBinomial() * data.rotation;
+			}
+			weightedAdd(_velX.data(), _kernelX.data(), weight, n);
+			weightedAdd(_velZ.data(), _kernelZ.data(), weight, n);
+			weightedAdd(_rotation.data(), _kernelRotation.data(), weight, n);
+			break;
+		case BatchKernel::TargetSeek:
+		case BatchKernel::TargetFlee: {
+			const float sign = data.kernel == BatchKernel::TargetSeek ? 1.0f : -1.0f;
+			seekKernel(data.target, sign, _posX.data(), _posY.data(), _posZ.data(), _speed.data(),
+					_kernelX.data(), _kernelY.data(), _kernelZ.data(), _dirX.data(), _dirZ.data(), n);
+			for (size_t i = 0u; i < n; ++i) {
+				_kernelRotation[i] = atan2f(_dirZ[i], _dirX[i]);
+			}
+			weightedAdd(_velX.data(), _kernelX.data(), weight, n);
+			weightedAdd(_velY.data(), _kernelY.data(), weight, n);
+			weightedAdd(_velZ.data(), _kernelZ.data(), weight, n);
+			weightedAdd(_rotation.data(), _kernelRotation.data(), weight, n);
+			break;
+		}
+		case BatchKernel::None:
+			break;
+		}
+	}
+	if (totalWeight <= 0.0000001f) {
+		return;
+	}
+
+	// integrate
+	const float scale = 1.0f / totalWeight;
+	integrate(_posX.data(), _velX.data(), scale, _deltaSeconds.data(), n);
+	integrate(_posY.data(), _velY.data(), scale, _deltaSeconds.data(), n);
+	integrate(_posZ.data(), _velZ.data(), scale, _deltaSeconds.data(), n);
+
+	// scatter
+	const float twoPi = glm::two_pi<float>();
+	for (size_t i = 0u; i < n; ++i) {
+		ICharacter* chr = entries[i].chr.get();
+		const float rotation = fmodf(_rotation[i] * scale, twoPi);
+		chr->setPosition(glm::vec3(_posX[i], _posY[i], _posZ[i]));
+		chr->setOrientation(fmodf(_orientation[i] + rotation * _deltaSeconds[i], twoPi));
+	}
+}
+
+size_t BatchedSteering::execute() {
+	std::vector<Entry> entries;
+	{
+		ScopedWriteLock scopedLock(_lock);
+		entries.swap(_entries);
+		// keep the capacity for the next update
+		_entries.reserve(entries.size());
+	}
+	if (entries.empty()) {
+		return 0u;
+	}
+	// group all characters that use the same steering configuration
+	auto bySteering = [] (const Entry& a, const Entry& b) {
+		return std::less<const WeightedSteering*>()(a.steering, b.steering);
+	};
+	if (!std::is_sorted(entries.begin(), entries.end(), bySteering)) {
+		std::sort(entries.begin(), entries.end(), bySteering);
+	}
+	size_t start = 0u;
+	const size_t size = entries.size();
+	for (size_t i = 1u; i <= size; ++i) {
+		if (i < size && entries[i].steering == entries[start].steering) {
+			continue;
+		}
+		executeGroup(entries[start].steering, &entries[start], i - start);
+		start = i;
+	}
+	return size;
+}
+
+}
+}
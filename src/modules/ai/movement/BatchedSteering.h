@@ -0,0 +1,87 @@
+/**
+ * @file
+ */
+#pragma once
+
+#include "common/Thread.h"
+#include <vector>
+#include <memory>
+#include <stdint.h>
+
+namespace ai {
+
+class AI;
+typedef std::shared_ptr<AI> AIPtr;
+class ICharacter;
+typedef std::shared_ptr<ICharacter> ICharacterPtr;
+
+namespace movement {
+
+class WeightedSteering;
+
+/**
+ * @brief Batched movement stage that evaluates the steerings of many characters at once.
+ *
+ * Instead of evaluating the @c WeightedSteering for each character in the behaviour tree tick, the
+ * @c Steer node can queue the character here (see @c Zone::setBatchedMovement()). After all behaviour
+ * trees of the zone were executed, all characters that use the same @c WeightedSteering instance are
+ * gathered into structure-of-arrays buffers, evaluated by SIMD kernels and the results are written back
+ * via @c ICharacter::setPosition() and @c ICharacter::setOrientation().
+ *
+ * Only steerings that report a @c BatchKernel (see @c ISteering::getBatchData()) can be batched - all other
+ * steerings keep using @c WeightedSteering::execute().
+ */
+class BatchedSteering {
+private:
+	struct Entry {
+		const WeightedSteering* steering;
+		// keeps the character alive until the movement was applied
+		ICharacterPtr chr;
+		float deltaSeconds;
+	};
+	std::vector<Entry> _entries;
+	ReadWriteLock _lock {"batchedsteering"};
+
+	// structure of arrays buffers - reused between the updates
+	std::vector<float> _posX;
+	std::vector<float> _posY;
+	std::vector<float> _posZ;
+	std::vector<float> _orientation;
+	std::vector<float> _speed;
+	std::vector<float> _deltaSeconds;
+	std::vector<float> _velX;
+	std::vector<float> _velY;
+	std::vector<float> _velZ;
+	std::vector<float> _rotation;
+	// output of a single kernel before it is blended into the velocity and rotation buffers
+	std::vector<float> _kernelX;
+	std::vector<float> _kernelY;
+	std::vector<float> _kernelZ;
+	std::vector<float> _kernelRotation;
+	std::vector<float> _dirX;
+	std::vector<float> _dirZ;
+
+	void resize(size_t n);
+	void executeGroup(const WeightedSteering* steering, const Entry* entries, size_t n);
+public:
+	/**
+	 * @brief Queue the movement of the given character for the next @c execute() call.
+	 * @note This is thread safe and can be called from within the parallel behaviour tree execution
+	 * @return @c false if the given steering can't be batched
+	 */
+	bool add(const WeightedSteering* steering, const AIPtr& ai, int64_t deltaMillis);
+
+	/**
+	 * @brief Evaluates all the queued movements and applies them to the characters
+	 * @return The amount of moved characters
+	 */
+	size_t execute();
+
+	/**
+	 * @return The amount of queued movements
+	 */
+	size_t size() const;
+};
+
+}
+}
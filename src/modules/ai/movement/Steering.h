@@ -41,6 +41,25 @@ public: \
 		return FACTORY; \
 	}
 
+/**
+ * @brief The kernels that the @c BatchedSteering stage can evaluate for many characters at once
+ */
+enum class BatchKernel {
+	None,
+	Wander,
+	TargetSeek,
+	TargetFlee
+};
+
+/**
+ * @brief The parameters of a steering for the @c BatchedSteering stage
+ */
+struct BatchData {
+	BatchKernel kernel = BatchKernel::None;
+	glm::vec3 target {0.0f};
+	float rotation = 0.0f;
+};
+
 /**
  * @brief Steering interface
  */
@@ -54,6 +73,16 @@ public:
 	 * because there was an error.
 	 */
 	virtual MoveVector execute (const AIPtr& ai, float speed) const = 0;
+
+	/**
+	 * @brief Steerings that only depend on the position, orientation and speed of the character can
+	 * be evaluated for all characters of a zone at once by the @c BatchedSteering stage.
+	 *
+	 * @return @c false if the steering can't be batched and @c execute() must be used.
+	 */
+	virtual bool getBatchData(BatchData& /*data*/) const {
+		return false;
+	}
 };
 
 /**
@@ -35,6 +35,15 @@ public:
 		const MoveVector d(v * speed, orientation);
 		return d;
 	}
+
+	bool getBatchData(BatchData& data) const override {
+		if (!isValid()) {
+			return false;
+		}
+		data.kernel = BatchKernel::TargetFlee;
+		data.target = _target;
+		return true;
+	}
 };
 
 
@@ -19,5 +19,11 @@ MoveVector Wander::execute (const AIPtr& ai, float speed) const {
 	return d;
 }
 
+bool Wander::getBatchData(BatchData& data) const {
+	data.kernel = BatchKernel::Wander;
+	data.rotation = _rotation;
+	return true;
+}
+
 }
 }
@@ -23,6 +23,8 @@ public:
 	explicit Wander(const std::string& parameter);
 
 	MoveVector execute (const AIPtr& ai, float speed) const override;
+
+	bool getBatchData(BatchData& data) const override;
 };
 
 }
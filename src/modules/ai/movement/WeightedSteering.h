@@ -24,15 +24,51 @@ struct WeightedData {
 typedef std::vector<WeightedData> WeightedSteerings;
 typedef WeightedSteerings::const_iterator WeightedSteeringsIter;
 
+/**
+ * @brief @c BatchData and weight of one of the steerings of a batchable @c WeightedSteering
+ */
+struct WeightedBatchData {
+	BatchData data;
+	float weight;
+};
+typedef std::vector<WeightedBatchData> WeightedBatchDatas;
+
 /**
  * @brief This class allows you to weight several steering methods and get a blended @c MoveVector out of it.
  */
 class WeightedSteering {
 private:
 	WeightedSteerings _steerings;
+	WeightedBatchDatas _batchData;
+	bool _batchable;
 public:
 	explicit WeightedSteering(const WeightedSteerings& steerings) :
-			_steerings(steerings) {
+			_steerings(steerings), _batchable(!steerings.empty()) {
+		_batchData.reserve(steerings.size());
+		for (const WeightedData& wd : _steerings) {
+			WeightedBatchData batchData;
+			if (!wd.steering->getBatchData(batchData.data)) {
+				_batchable = false;
+				_batchData.clear();
+				break;
+			}
+			batchData.weight = wd.weight;
+			_batchData.push_back(batchData);
+		}
+	}
+
+	/**
+	 * @return @c true if all the steerings can be evaluated by the @c BatchedSteering stage
+	 */
+	inline bool isBatchable() const {
+		return _batchable;
+	}
+
+	/**
+	 * @return The kernel parameters of all steerings if @c isBatchable() returned @c true
+	 */
+	inline const WeightedBatchDatas& getBatchData() const {
+		return _batchData;
 	}
 
 	MoveVector execute (const AIPtr& ai, float speed) const {
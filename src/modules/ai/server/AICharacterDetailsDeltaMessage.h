@@ -0,0 +1,135 @@
+/**
+ * @file
+ */
+#pragma once
+
+#include "IProtocolMessage.h"
+#include "AIStubTypes.h"
+#include <utility>
+#include <vector>
+
+namespace ai {
+
+/**
+ * @brief Message for the remote debugging interface
+ *
+ * Delta of the @c AICharacterDetailsMessage for the selected character against the last details that were
+ * sent to the particular client. The aggro list is only included (in full) if it changed - and from the behaviour
+ * tree only the nodes whose status, condition, running state or execution time changed are included.
+ *
+ * @see AIStateNode::applyDelta()
+ */
+class AICharacterDetailsDeltaMessage: public IProtocolMessage {
+private:
+	typedef std::vector<AIStateNodeStatus> Nodes;
+	CharacterId _chrId;
+	int64_t _elapsedMillis;
+	bool _aggroChanged = false;
+	AIStateAggro _aggro;
+	Nodes _nodes;
+
+public:
+	AICharacterDetailsDeltaMessage(const CharacterId& id, int64_t elapsedMillis) :
+			IProtocolMessage(PROTO_CHARACTER_DETAILS_DELTA), _chrId(id), _elapsedMillis(elapsedMillis) {
+	}
+
+	explicit AICharacterDetailsDeltaMessage(streamContainer& in) :
+			IProtocolMessage(PROTO_CHARACTER_DETAILS_DELTA) {
+		_chrId = readInt(in);
+		_elapsedMillis = readLong(in);
+		_aggroChanged = readBool(in);
+		if (_aggroChanged) {
+			const int aggroSize = readShort(in);
+			_aggro.reserve(aggroSize);
+			for (int i = 0; i < aggroSize; ++i) {
+				const CharacterId chrId = readInt(in);
+				const float aggroVal = readFloat(in);
+				_aggro.addAggro(AIStateAggroEntry(chrId, aggroVal));
+			}
+		}
+		const int nodeSize = readShort(in);
+		_nodes.reserve(nodeSize);
+		for (int i = 0; i < nodeSize; ++i) {
+			const int32_t nodeId = readInt(in);
+			const std::string& condition = readString(in);
+			const int64_t lastRun = readLong(in);
+			const TreeNodeStatus status = static_cast<TreeNodeStatus>(readByte(in));
+			const bool running = readBool(in);
+			_nodes.emplace_back(nodeId, condition, lastRun, status, running);
+		}
+	}
+
+	/**
+	 * @brief Includes the aggro list in the message - only call this if it changed
+	 */
+	inline void setAggro(AIStateAggro&& aggro) {
+		_aggro = std::move(aggro);
+		_aggroChanged = true;
+	}
+
+	/**
+	 * @note The nodes must be added ordered by their id
+	 */
+	inline void addNode(const AIStateNodeStatus& node) {
+		_nodes.push_back(node);
+	}
+
+	void serialize(streamContainer& out) const override {
+		addByte(out, _id);
+		addInt(out, _chrId);
+		addLong(out, _elapsedMillis);
+		addBool(out, _aggroChanged);
+		if (_aggroChanged) {
+			const std::vector<AIStateAggroEntry>& a = _aggro.getAggro();
+			addShort(out, static_cast<int16_t>(a.size()));
+			for (const AIStateAggroEntry& e : a) {
+				addInt(out, e.id);
+				addFloat(out, e.aggro);
+			}
+		}
+		addShort(out, static_cast<int16_t>(_nodes.size()));
+		for (const AIStateNodeStatus& n : _nodes) {
+			addInt(out, n.nodeId);
+			addString(out, n.condition);
+			addLong(out, n.lastRun);
+			addByte(out, n.status);
+			addBool(out, n.running);
+		}
+	}
+
+	inline const CharacterId& getCharacterId() const {
+		return _chrId;
+	}
+
+	/**
+	 * @return The milliseconds since the last details message for this character
+	 */
+	inline int64_t getElapsedMillis() const {
+		return _elapsedMillis;
+	}
+
+	/**
+	 * @return @c false if the aggro list didn't change since the last details message - the client should
+	 * keep its current list in that case
+	 */
+	inline bool hasAggro() const {
+		return _aggroChanged;
+	}
+
+	inline const AIStateAggro& getAggro() const {
+		return _aggro;
+	}
+
+	/**
+	 * @return @c true if the client doesn't need to get this message
+	 */
+	inline bool empty() const {
+		return !_aggroChanged && _nodes.empty();
+	}
+
+	inline const std::vector<AIStateNodeStatus>& getNodes() const {
+		return _nodes;
+	}
+};
+
+}
@@ -0,0 +1,61 @@
+/**
+ * @file
+ */
+#pragma once
+
+#include "AIStateMessage.h"
+
+namespace ai {
+
+/**
+ * @brief Message for the remote debugging interface
+ *
+ * Delta of the world state against the last @c AIStateMessage or @c AIStateDeltaMessage that was sent
+ * to the particular client. Only the changed characters are included - characters that are no longer
+ * part of the debugged zone are listed in the removed list. Characters that are not mentioned at all
+ * keep their last known state.
+ */
+class AIStateDeltaMessage: public AIStateMessage {
+private:
+	typedef std::vector<CharacterId> Removed;
+	Removed _removed;
+
+public:
+	AIStateDeltaMessage() :
+			AIStateMessage(PROTO_STATE_DELTA) {
+	}
+
+	explicit AIStateDeltaMessage(streamContainer& in) :
+			AIStateMessage(PROTO_STATE_DELTA, in) {
+		const int removedSize = readInt(in);
+		_removed.reserve(removedSize);
+		for (int i = 0; i < removedSize; ++i) {
+			_removed.push_back(readInt(in));
+		}
+	}
+
+	void addRemoved(const CharacterId& id) {
+		_removed.push_back(id);
+	}
+
+	/**
+	 * @return @c true if there is nothing to send
+	 */
+	inline bool empty() const {
+		return _states.empty() && _removed.empty();
+	}
+
+	void serialize(streamContainer& out) const override {
+		AIStateMessage::serialize(out);
+		addInt(out, static_cast<int>(_removed.size()));
+		for (const CharacterId& id : _removed) {
+			addInt(out, id);
+		}
+	}
+
+	inline const std::vector<CharacterId>& getRemoved() const {
+		return _removed;
+	}
+};
+
+}
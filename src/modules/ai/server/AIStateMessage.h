@@ -15,7 +15,7 @@ namespace ai {
  * State of the world. You receive basic information about every watched AI controller entity
  */
 class AIStateMessage: public IProtocolMessage {
-private:
+protected:
 	typedef std::vector<AIStateWorld> States;
 	States _states;
 
@@ -61,19 +61,28 @@ private:
 		}
 	}
 
-public:
-	AIStateMessage() :
-			IProtocolMessage(PROTO_STATE) {
+	explicit AIStateMessage(const ProtocolId& id) :
+			IProtocolMessage(id) {
 	}
 
-	explicit AIStateMessage(streamContainer& in) :
-			IProtocolMessage(PROTO_STATE) {
+	AIStateMessage(const ProtocolId& id, streamContainer& in) :
+			IProtocolMessage(id) {
 		const int treeSize = readInt(in);
+		_states.reserve(treeSize);
 		for (int i = 0; i < treeSize; ++i) {
 			readState(in);
 		}
 	}
 
+public:
+	AIStateMessage() :
+			IProtocolMessage(PROTO_STATE) {
+	}
+
+	explicit AIStateMessage(streamContainer& in) :
+			AIStateMessage(PROTO_STATE, in) {
+	}
+
 	void addState(const AIStateWorld& tree) {
 		_states.push_back(tree);
 	}
@@ -82,6 +91,10 @@ public:
 		_states.push_back(std::move(tree));
 	}
 
+	void reserve(size_t states) {
+		_states.reserve(states);
+	}
+
 	void serialize(streamContainer& out) const override {
 		addByte(out, _id);
 		addInt(out, static_cast<int>(_states.size()));
@@ -5,6 +5,7 @@
 
 #include <vector>
 #include <string>
+#include <algorithm>
 #include "ICharacter.h"
 #include "common/Math.h"
 #include "tree/TreeNode.h"
@@ -100,6 +101,22 @@ public:
 	}
 };
 
+/**
+ * @brief The changed runtime values of a single behaviour tree node
+ *
+ * @see AICharacterDetailsDeltaMessage
+ */
+struct AIStateNodeStatus {
+	AIStateNodeStatus(int32_t _nodeId, const std::string& _condition, int64_t _lastRun, TreeNodeStatus _status, bool _running) :
+			nodeId(_nodeId), condition(_condition), lastRun(_lastRun), status(_status), running(_running) {
+	}
+	int32_t nodeId;
+	std::string condition;
+	int64_t lastRun;
+	TreeNodeStatus status;
+	bool running;
+};
+
 /**
  * @brief This is a representation of a behaviour tree node for the serialization
  */
@@ -166,6 +183,32 @@ public:
 	inline bool isRunning() const {
 		return _currentlyRunning;
 	}
+
+	/**
+	 * @brief Applies a node status delta to this node and all of its children.
+	 *
+	 * @param[in] elapsedMillis The milliseconds that passed since the last full or delta state. This
+	 * is added to the last run value of every node that was already executed.
+	 * @param[in] changed The nodes that changed since the last state - sorted by node id
+	 */
+	void applyDelta(int64_t elapsedMillis, const std::vector<AIStateNodeStatus>& changed) {
+		if (_lastRun != -1L) {
+			_lastRun += elapsedMillis;
+		}
+		if (!changed.empty()) {
+			auto i = std::lower_bound(changed.begin(), changed.end(), _nodeId,
+					[] (const AIStateNodeStatus& s, int32_t id) { return s.nodeId < id; });
+			if (i != changed.end() && i->nodeId == _nodeId) {
+				_condition = i->condition;
+				_lastRun = i->lastRun;
+				_status = i->status;
+				_currentlyRunning = i->running;
+			}
+		}
+		for (AIStateNode& child : _children) {
+			child.applyDelta(elapsedMillis, changed);
+		}
+	}
 };
 
 /**
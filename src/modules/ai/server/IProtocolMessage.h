@@ -7,7 +7,7 @@
 #include <stddef.h>
 #include <limits.h>
 #include <string>
-#include <deque>
+#include "RingBuffer.h"
 #define AI_LIL_ENDIAN  1234
 #define AI_BIG_ENDIAN  4321
 #ifdef __linux__
@@ -36,7 +36,7 @@
 namespace ai {
 
 typedef uint8_t ProtocolId;
-typedef std::deque<uint8_t> streamContainer;
+typedef RingBuffer streamContainer;
 
 const ProtocolId PROTO_PING = 0;
 const ProtocolId PROTO_STATE = 1;
@@ -51,6 +51,8 @@ const ProtocolId PROTO_STEP = 9;
 const ProtocolId PROTO_UPDATENODE = 10;
 const ProtocolId PROTO_DELETENODE = 11;
 const ProtocolId PROTO_ADDNODE = 12;
+const ProtocolId PROTO_STATE_DELTA = 13;
+const ProtocolId PROTO_CHARACTER_DETAILS_DELTA = 14;
 
 /**
  * @brief A protocol message is used for the serialization of the ai states for remote debugging
@@ -209,87 +211,52 @@ inline std::string IProtocolMessage::readString(streamContainer& in) {
 }
 
 inline void IProtocolMessage::addString(streamContainer& out, const std::string& string) {
-	const std::size_t length = string.length();
-	for (std::size_t i = 0; i < length; ++i) {
-		out.push_back(uint8_t(string[i]));
-	}
-	out.push_back(uint8_t('\0'));
+	// including the terminating null byte
+	out.append(string.c_str(), string.length() + 1);
 }
 
 inline void IProtocolMessage::addShort(streamContainer& out, int16_t word) {
 	const int16_t swappedWord = AI_SwapLE16(word);
-	out.push_back(uint8_t(swappedWord));
-	out.push_back(uint8_t(swappedWord >> CHAR_BIT));
+	out.append(&swappedWord, sizeof(swappedWord));
 }
 
 inline void IProtocolMessage::addInt(streamContainer& out, int32_t dword) {
-	int32_t swappedDWord = AI_SwapLE32(dword);
-	out.push_back(uint8_t(swappedDWord));
-	out.push_back(uint8_t(swappedDWord >>= CHAR_BIT));
-	out.push_back(uint8_t(swappedDWord >>= CHAR_BIT));
-	out.push_back(uint8_t(swappedDWord >> CHAR_BIT));
+	const int32_t swappedDWord = AI_SwapLE32(dword);
+	out.append(&swappedDWord, sizeof(swappedDWord));
 }
 
 inline void IProtocolMessage::addLong(streamContainer& out, int64_t dword) {
-	int64_t swappedDWord = AI_SwapLE64(dword);
-	out.push_back(uint8_t(swappedDWord));
-	out.push_back(uint8_t(swappedDWord >>= CHAR_BIT));
-	out.push_back(uint8_t(swappedDWord >>= CHAR_BIT));
-	out.push_back(uint8_t(swappedDWord >>= CHAR_BIT));
-	out.push_back(uint8_t(swappedDWord >>= CHAR_BIT));
-	out.push_back(uint8_t(swappedDWord >>= CHAR_BIT));
-	out.push_back(uint8_t(swappedDWord >>= CHAR_BIT));
-	out.push_back(uint8_t(swappedDWord >> CHAR_BIT));
+	const int64_t swappedDWord = AI_SwapLE64(dword);
+	out.append(&swappedDWord, sizeof(swappedDWord));
 }
 
 inline int16_t IProtocolMessage::readShort(streamContainer& in) {
-	uint8_t buf[2];
-	const int l = sizeof(buf);
-	for (int i = 0; i < l; ++i) {
-		buf[i] = in.front();
-		in.pop_front();
-	}
-	const int16_t *word = (const int16_t*) (void*) &buf;
-	const int16_t val = AI_SwapLE16(*word);
+	int16_t word = 0;
+	in.read(&word, sizeof(word));
+	const int16_t val = AI_SwapLE16(word);
 	return val;
 }
 
 inline int32_t IProtocolMessage::readInt(streamContainer& in) {
-	uint8_t buf[4];
-	const int l = sizeof(buf);
-	for (int i = 0; i < l; ++i) {
-		buf[i] = in.front();
-		in.pop_front();
-	}
-	const int32_t *word = (const int32_t*) (void*) &buf;
-	const int32_t val = AI_SwapLE32(*word);
+	int32_t word = 0;
+	in.read(&word, sizeof(word));
+	const int32_t val = AI_SwapLE32(word);
 	return val;
 }
 
 inline int32_t IProtocolMessage::peekInt(const streamContainer& in) {
-	uint8_t buf[4];
-	const int l = sizeof(buf);
-	streamContainer::const_iterator it = in.begin();
-	for (int i = 0; i < l; ++i) {
-		if (it == in.end())
-			return -1;
-		buf[i] = *it;
-		++it;
+	int32_t word;
+	if (!in.peek(&word, sizeof(word))) {
+		return -1;
 	}
-	const int32_t *word = (const int32_t*) (void*) &buf;
-	const int32_t val = AI_SwapLE32(*word);
+	const int32_t val = AI_SwapLE32(word);
 	return val;
 }
 
 inline int64_t IProtocolMessage::readLong(streamContainer& in) {
-	uint8_t buf[8];
-	const int l = sizeof(buf);
-	for (int i = 0; i < l; ++i) {
-		buf[i] = in.front();
-		in.pop_front();
-	}
-	const int64_t *word = (const int64_t*) (void*) &buf;
-	const int64_t val = AI_SwapLE64(*word);
+	int64_t word = 0;
+	in.read(&word, sizeof(word));
+	const int64_t val = AI_SwapLE64(word);
 	return val;
 }
 
@@ -11,10 +11,13 @@
 #ifdef WIN32
 #define network_cleanup() WSACleanup()
 #define network_return int
+#define network_wouldblock() (WSAGetLastError() == WSAEWOULDBLOCK)
 #else
 #define network_return ssize_t
+#define network_wouldblock() (errno == EAGAIN || errno == EWOULDBLOCK)
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <sys/ioctl.h>
 #include <sys/time.h>
 #include <unistd.h>
@@ -30,7 +33,7 @@
 #define network_cleanup()
 #endif
 #include <string.h>
-#include <deque>
+#include <errno.h>
 #include <algorithm>
 #include <assert.h>
 #include <stddef.h>
@@ -41,7 +44,8 @@
 namespace ai {
 
 Network::Network(uint16_t port, const std::string& hostname) :
-		_port(port), _hostname(hostname), _socketFD(INVALID_SOCKET), _time(0L) {
+		_port(port), _hostname(hostname), _socketFD(INVALID_SOCKET), _time(0L), _serializeBuffer(16384),
+		_sentBytes(0u), _sentMessages(0u) {
 	FD_ZERO(&_readFDSet);
 	FD_ZERO(&_writeFDSet);
 }
@@ -131,25 +135,44 @@ Network::ClientSocketsIter Network::closeClient(ClientSocketsIter& iter) {
 }
 
 bool Network::sendMessage(Client& client) {
-	if (client.out.empty()) {
-		return true;
-	}
-
-	core::Array<uint8_t, 16384> buf;
 	while (!client.out.empty()) {
-		const size_t len = core_min(buf.size(), client.out.size());
-		std::copy_n(client.out.begin(), len, buf.begin());
+		// hand the (at most two) contiguous segments of the ring buffer to the socket
+		// in one call - no copy into a temporary buffer needed
+		streamContainer::Segment segments[2];
+		const int n = client.out.segments(segments);
 		const SOCKET clientSocket = client.socket;
-		const network_return sent = send(clientSocket, (const char*)&buf[0], len, 0);
+#ifdef WIN32
+		WSABUF bufs[2];
+		for (int i = 0; i < n; ++i) {
+			bufs[i].buf = (char*)segments[i].data;
+			bufs[i].len = (ULONG)segments[i].size;
+		}
+		DWORD sentBytes = 0;
+		const network_return sent = WSASend(clientSocket, bufs, n, &sentBytes, 0, nullptr, nullptr) == 0 ? (network_return)sentBytes : -1;
+#else
+		struct iovec iov[2];
+		for (int i = 0; i < n; ++i) {
+			iov[i].iov_base = (void*)segments[i].data;
+			iov[i].iov_len = segments[i].size;
+		}
+		const network_return sent = writev(clientSocket, iov, n);
+#endif
 		if (sent < 0) {
+			if (network_wouldblock()) {
+				// better luck next time - but don't block others
+				return true;
+			}
 			return false;
 		}
 		if (sent == 0) {
 			// better luck next time - but don't block others
 			return true;
 		}
-		client.out.erase(client.out.begin(), std::next(client.out.begin(), sent));
+		client.out.skip(sent);
+		_sentBytes += sent;
 	}
+	// nothing left to write - don't let select wake us up for this socket
+	FD_CLR(client.socket, &_writeFDSet);
 	return true;
 }
 
@@ -176,6 +199,13 @@ void Network::update(int64_t deltaTime) {
 	if (_socketFD != INVALID_SOCKET && FD_ISSET(_socketFD, &readFDsOut)) {
 		const SOCKET clientSocket = accept(_socketFD, nullptr, nullptr);
 		if (clientSocket != INVALID_SOCKET) {
+#ifdef O_NONBLOCK
+			fcntl(clientSocket, F_SETFL, O_NONBLOCK);
+#endif
+#ifdef WIN32
+			unsigned long mode = 1;
+			ioctlsocket(clientSocket, FIONBIO, &mode);
+#endif
 			FD_SET(clientSocket, &_readFDSet);
 			const Client c(clientSocket);
 			_clientSockets.push_back(c);
@@ -204,46 +234,57 @@ void Network::update(int64_t deltaTime) {
 		if (FD_ISSET(clientSocket, &readFDsOut)) {
 			core::Array<uint8_t, 16384> buf;
 			const network_return len = recv(clientSocket, (char*)&buf[0], buf.size(), 0);
-			if (len < 0) {
+			if (len < 0 && !network_wouldblock()) {
 				i = closeClient(i);
 				continue;
 			}
-			std::copy_n(buf.begin(), len, std::back_inserter(client.in));
+			if (len > 0) {
+				client.in.append(&buf[0], len);
+			}
 		}
 
 		ProtocolMessageFactory& factory = ProtocolMessageFactory::get();
-		if (factory.isNewMessageAvailable(client.in)) {
+		bool failed = false;
+		while (factory.isNewMessageAvailable(client.in)) {
 			IProtocolMessage* msg = factory.create(client.in);
 			if (!msg) {
-				i = closeClient(i);
-				continue;
+				failed = true;
+				break;
 			}
 			IProtocolHandler* handler = ProtocolHandlerRegistry::get().getHandler(*msg);
 			if (handler) {
 				handler->execute(clientId, *msg);
 			}
 		}
+		if (failed) {
+			i = closeClient(i);
+			continue;
+		}
 		++i;
 	}
 }
 
+void Network::queueMessage(Client& client) {
+	IProtocolMessage::addInt(client.out, static_cast<int32_t>(_serializeBuffer.size()));
+	client.out.append(_serializeBuffer);
+	FD_SET(client.socket, &_writeFDSet);
+	++_sentMessages;
+}
+
 bool Network::broadcast(const IProtocolMessage& msg) {
 	if (_clientSockets.empty()) {
 		return false;
 	}
 	_time = 0L;
-	streamContainer out;
-	msg.serialize(out);
-	for (ClientSocketsIter i = _clientSockets.begin(); i != _clientSockets.end(); ++i) {
-		Client& client = *i;
+	// serialize only once for all clients
+	_serializeBuffer.clear();
+	msg.serialize(_serializeBuffer);
+	for (Client& client : _clientSockets) {
+		// closed in the next update
 		if (client.socket == INVALID_SOCKET) {
-			i = closeClient(i);
 			continue;
 		}
-
-		IProtocolMessage::addInt(client.out, static_cast<int32_t>(out.size()));
-		std::copy(out.begin(), out.end(), std::back_inserter(client.out));
-		FD_SET(client.socket, &_writeFDSet);
+		queueMessage(client);
 	}
 
 	return true;
@@ -255,16 +296,14 @@ bool Network::sendToClient(Client* client, const IProtocolMessage& msg) {
 		return false;
 	}
 
-	streamContainer out;
-	msg.serialize(out);
-
-	IProtocolMessage::addInt(client->out, static_cast<int32_t>(out.size()));
-	std::copy(out.begin(), out.end(), std::back_inserter(client->out));
-	FD_SET(client->socket, &_writeFDSet);
+	_serializeBuffer.clear();
+	msg.serialize(_serializeBuffer);
+	queueMessage(*client);
 	return true;
 }
 
 #undef network_cleanup
+#undef network_wouldblock
 #undef INVALID_SOCKET
 #ifndef WIN32
 #undef closesocket
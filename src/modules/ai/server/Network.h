@@ -31,6 +31,7 @@ struct Client {
 	SOCKET socket;
 	bool finished;
 	streamContainer in;
+	// the pending bytes that weren't yet accepted by the socket
 	streamContainer out;
 };
 
@@ -60,7 +61,14 @@ protected:
 	typedef std::list<INetworkListener*> Listeners;
 	Listeners _listeners;
 
+	// reused memory for serializing the messages - the size of a message must be known
+	// before it can be put into the client stream
+	streamContainer _serializeBuffer;
+	uint64_t _sentBytes;
+	uint64_t _sentMessages;
+
 	bool sendMessage(Client& client);
+	void queueMessage(Client& client);
 public:
 	Network(uint16_t port = 10001, const std::string& hostname = "0.0.0.0");
 	virtual ~Network();
@@ -78,12 +86,37 @@ public:
 	 */
 	bool broadcast(const IProtocolMessage& msg);
 	bool sendToClient(Client* client, const IProtocolMessage& msg);
+
+	/**
+	 * @return The amount of bytes that were handed over to the sockets since the start
+	 */
+	uint64_t getSentBytes() const;
+	/**
+	 * @return The amount of messages that were queued for sending since the start
+	 */
+	uint64_t getSentMessages() const;
+	/**
+	 * @return The amount of bytes that are queued for the given client but not yet accepted by the socket
+	 */
+	size_t getPendingBytes(const Client* client) const;
 };
 
 inline int Network::getConnectedClients() const {
 	return static_cast<int>(_clientSockets.size());
 }
 
+inline uint64_t Network::getSentBytes() const {
+	return _sentBytes;
+}
+
+inline uint64_t Network::getSentMessages() const {
+	return _sentMessages;
+}
+
+inline size_t Network::getPendingBytes(const Client* client) const {
+	return client->out.size();
+}
+
 inline void Network::addListener(INetworkListener* listener) {
 	_listeners.push_back(listener);
 }
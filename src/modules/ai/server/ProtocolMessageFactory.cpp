@@ -14,6 +14,8 @@
 #include "AIUpdateNodeMessage.h"
 #include "AIAddNodeMessage.h"
 #include "AIDeleteNodeMessage.h"
+#include "AIStateDeltaMessage.h"
+#include "AICharacterDetailsDeltaMessage.h"
 
 namespace ai {
 
@@ -30,7 +32,9 @@ ProtocolMessageFactory::ProtocolMessageFactory() :
 	_aiCharacterStatic(new uint8_t[sizeof(AICharacterStaticMessage)]),
 	_aiUpdateNode(new uint8_t[sizeof(AIUpdateNodeMessage)]),
 	_aiAddNode(new uint8_t[sizeof(AIAddNodeMessage)]),
-	_aiDeleteNode(new uint8_t[sizeof(AIDeleteNodeMessage)]) {
+	_aiDeleteNode(new uint8_t[sizeof(AIDeleteNodeMessage)]),
+	_aiStateDelta(new uint8_t[sizeof(AIStateDeltaMessage)]),
+	_aiCharacterDetailsDelta(new uint8_t[sizeof(AICharacterDetailsDeltaMessage)]) {
 }
 
 ProtocolMessageFactory::~ProtocolMessageFactory() {
@@ -47,6 +51,8 @@ ProtocolMessageFactory::~ProtocolMessageFactory() {
 	delete[] _aiUpdateNode;
 	delete[] _aiAddNode;
 	delete[] _aiDeleteNode;
+	delete[] _aiStateDelta;
+	delete[] _aiCharacterDetailsDelta;
 }
 
 bool ProtocolMessageFactory::isNewMessageAvailable(const streamContainer& in) const {
@@ -65,7 +71,7 @@ bool ProtocolMessageFactory::isNewMessageAvailable(const streamContainer& in) co
 
 IProtocolMessage *ProtocolMessageFactory::create(streamContainer& in) {
 	// remove the size from the stream
-	in.erase(in.begin(), std::next(in.begin(), sizeof(int32_t)));
+	in.skip(sizeof(int32_t));
 	// get the message type
 	const uint8_t type = in.front();
 	in.pop_front();
@@ -95,6 +101,10 @@ IProtocolMessage *ProtocolMessageFactory::create(streamContainer& in) {
 		return new (_aiAddNode) AIAddNodeMessage(in);
 	} else if (type == PROTO_DELETENODE) {
 		return new (_aiDeleteNode) AIDeleteNodeMessage(in);
+	} else if (type == PROTO_STATE_DELTA) {
+		return new (_aiStateDelta) AIStateDeltaMessage(in);
+	} else if (type == PROTO_CHARACTER_DETAILS_DELTA) {
+		return new (_aiCharacterDetailsDelta) AICharacterDetailsDeltaMessage(in);
 	}
 
 	return nullptr;
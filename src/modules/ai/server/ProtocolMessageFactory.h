@@ -23,6 +23,8 @@ private:
 	uint8_t *_aiUpdateNode;
 	uint8_t *_aiAddNode;
 	uint8_t *_aiDeleteNode;
+	uint8_t *_aiStateDelta;
+	uint8_t *_aiCharacterDetailsDelta;
 
 	ProtocolMessageFactory();
 public:
@@ -0,0 +1,288 @@
+/**
+ * @file
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <iterator>
+#include "common/Assert.h"
+
+namespace ai {
+
+/**
+ * @brief Contiguous byte ring buffer that is used for the remote debugging protocol streams.
+ *
+ * The storage is a single power-of-two sized block. Bytes are appended at the tail and consumed from
+ * the head, so the readable bytes are at most two contiguous segments which can be handed over to
+ * vectored socket writes (see @c segments()) without copying them into a temporary buffer first.
+ *
+ * The interface mimics the subset of @c std::deque that was used by the protocol code before, but
+ * also offers bulk operations (@c append(), @c read(), @c peek(), @c skip()) that should be preferred.
+ */
+class RingBuffer {
+private:
+	uint8_t* _buf = nullptr;
+	size_t _capacity = 0u;
+	size_t _head = 0u;
+	size_t _size = 0u;
+
+	inline size_t mask(size_t index) const {
+		return index & (_capacity - 1u);
+	}
+
+	void grow(size_t required) {
+		size_t newCapacity = _capacity == 0u ? 16u : _capacity;
+		while (newCapacity < required) {
+			newCapacity <<= 1;
+		}
+		if (newCapacity == _capacity) {
+			return;
+		}
+		uint8_t* newBuf = (uint8_t*)malloc(newCapacity);
+		// linearize the content while we are at it
+		peek(newBuf, _size);
+		free(_buf);
+		_buf = newBuf;
+		_capacity = newCapacity;
+		_head = 0u;
+	}
+
+public:
+	class const_iterator {
+	private:
+		const RingBuffer* _ring;
+		size_t _index;
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef uint8_t value_type;
+		typedef ptrdiff_t difference_type;
+		typedef const uint8_t* pointer;
+		typedef const uint8_t& reference;
+
+		const_iterator(const RingBuffer* ring, size_t index) :
+				_ring(ring), _index(index) {
+		}
+
+		inline reference operator*() const {
+			return _ring->_buf[_ring->mask(_ring->_head + _index)];
+		}
+
+		inline const_iterator& operator++() {
+			++_index;
+			return *this;
+		}
+
+		inline const_iterator operator++(int) {
+			const_iterator tmp(*this);
+			++_index;
+			return tmp;
+		}
+
+		inline bool operator==(const const_iterator& other) const {
+			return _index == other._index;
+		}
+
+		inline bool operator!=(const const_iterator& other) const {
+			return _index != other._index;
+		}
+	};
+	typedef const_iterator iterator;
+
+	/**
+	 * @brief A readable chunk of the ring buffer memory
+	 */
+	struct Segment {
+		const uint8_t* data;
+		size_t size;
+	};
+
+	RingBuffer() {
+	}
+
+	explicit RingBuffer(size_t capacity) {
+		reserve(capacity);
+	}
+
+	RingBuffer(const RingBuffer& other) {
+		reserve(other._size);
+		other.peek(_buf, other._size);
+		_size = other._size;
+	}
+
+	RingBuffer(RingBuffer&& other) :
+			_buf(other._buf), _capacity(other._capacity), _head(other._head), _size(other._size) {
+		other._buf = nullptr;
+		other._capacity = other._head = other._size = 0u;
+	}
+
+	~RingBuffer() {
+		free(_buf);
+	}
+
+	RingBuffer& operator=(const RingBuffer& other) {
+		if (this != &other) {
+			clear();
+			reserve(other._size);
+			other.peek(_buf, other._size);
+			_size = other._size;
+		}
+		return *this;
+	}
+
+	RingBuffer& operator=(RingBuffer&& other) {
+		if (this != &other) {
+			free(_buf);
+			_buf = other._buf;
+			_capacity = other._capacity;
+			_head = other._head;
+			_size = other._size;
+			other._buf = nullptr;
+			other._capacity = other._head = other._size = 0u;
+		}
+		return *this;
+	}
+
+	inline size_t size() const {
+		return _size;
+	}
+
+	inline bool empty() const {
+		return _size == 0u;
+	}
+
+	inline size_t capacity() const {
+		return _capacity;
+	}
+
+	/**
+	 * @brief Drops the content, but keeps the memory for the next usage
+	 */
+	inline void clear() {
+		_head = 0u;
+		_size = 0u;
+	}
+
+	inline void reserve(size_t capacity) {
+		if (capacity > _capacity) {
+			grow(capacity);
+		}
+	}
+
+	inline const_iterator begin() const {
+		return const_iterator(this, 0u);
+	}
+
+	inline const_iterator end() const {
+		return const_iterator(this, _size);
+	}
+
+	inline void push_back(uint8_t byte) {
+		if (_size == _capacity) {
+			grow(_size + 1u);
+		}
+		_buf[mask(_head + _size)] = byte;
+		++_size;
+	}
+
+	/**
+	 * @brief Appends the given bytes with at most two @c memcpy calls
+	 */
+	void append(const void* data, size_t len) {
+		if (len == 0u) {
+			return;
+		}
+		if (_size + len > _capacity) {
+			grow(_size + len);
+		}
+		const size_t tail = mask(_head + _size);
+		const size_t first = len < _capacity - tail ? len : _capacity - tail;
+		memcpy(_buf + tail, data, first);
+		memcpy(_buf, (const uint8_t*)data + first, len - first);
+		_size += len;
+	}
+
+	inline void append(const RingBuffer& other) {
+		Segment s[2];
+		const int n = other.segments(s);
+		for (int i = 0; i < n; ++i) {
+			append(s[i].data, s[i].size);
+		}
+	}
+
+	inline uint8_t front() const {
+		ai_assert(_size > 0u, "RingBuffer underflow");
+		return _buf[_head];
+	}
+
+	inline void pop_front() {
+		skip(1u);
+	}
+
+	/**
+	 * @brief Copies @c len bytes starting at @c offset into @c out without consuming them
+	 * @return @c false if not enough bytes are available
+	 */
+	bool peek(void* out, size_t len, size_t offset = 0u) const {
+		if (offset + len > _size) {
+			return false;
+		}
+		if (len == 0u) {
+			return true;
+		}
+		const size_t start = mask(_head + offset);
+		const size_t first = len < _capacity - start ? len : _capacity - start;
+		memcpy(out, _buf + start, first);
+		memcpy((uint8_t*)out + first, _buf, len - first);
+		return true;
+	}
+
+	/**
+	 * @brief Consumes @c len bytes from the front
+	 */
+	inline void skip(size_t len) {
+		ai_assert(len <= _size, "RingBuffer underflow");
+		_size -= len;
+		if (_size == 0u) {
+			// keep the writes contiguous as long as possible
+			_head = 0u;
+		} else {
+			_head = mask(_head + len);
+		}
+	}
+
+	/**
+	 * @brief Copies and consumes @c len bytes from the front
+	 */
+	inline bool read(void* out, size_t len) {
+		if (!peek(out, len)) {
+			return false;
+		}
+		skip(len);
+		return true;
+	}
+
+	/**
+	 * @brief Fills the given array with the (at most two) contiguous memory segments that hold
+	 * the readable bytes - in the order they were written.
+	 * @return The amount of filled segments
+	 */
+	int segments(Segment out[2]) const {
+		if (_size == 0u) {
+			return 0;
+		}
+		const size_t first = _size < _capacity - _head ? _size : _capacity - _head;
+		out[0].data = _buf + _head;
+		out[0].size = first;
+		if (first == _size) {
+			return 1;
+		}
+		out[1].data = _buf;
+		out[1].size = _size - first;
+		return 2;
+	}
+};
+
+}
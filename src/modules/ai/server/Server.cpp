@@ -14,18 +14,86 @@
 
 #include "AIPauseMessage.h"
 #include "AIStateMessage.h"
+#include "AIStateDeltaMessage.h"
 #include "AINamesMessage.h"
 #include "AICharacterDetailsMessage.h"
+#include "AICharacterDetailsDeltaMessage.h"
 #include "AICharacterStaticMessage.h"
 
 #include "conditions/ConditionParser.h"
 #include "tree/TreeNodeParser.h"
+#include <algorithm>
+#include <chrono>
+#include <string.h>
 
 namespace ai {
 
 namespace {
 const int SV_BROADCAST_CHRDETAILS = 1 << 0;
 const int SV_BROADCAST_STATE      = 1 << 1;
+
+// FNV-1a - only used to detect changes between two broadcasts
+inline uint32_t hashBytes(uint32_t hash, const void* data, size_t len) {
+	const uint8_t* bytes = (const uint8_t*)data;
+	for (size_t i = 0; i < len; ++i) {
+		hash ^= bytes[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+inline uint32_t hashString(uint32_t hash, const std::string& str) {
+	// include the terminator to separate keys and values
+	return hashBytes(hash, str.c_str(), str.size() + 1);
+}
+
+const uint32_t HashSeed = 2166136261u;
+
+uint32_t hashState(const ICharacterPtr& chr) {
+	uint32_t hash = HashSeed;
+	const glm::vec3& pos = chr->getPosition();
+	const float orientation = chr->getOrientation();
+	hash = hashBytes(hash, &pos, sizeof(pos));
+	hash = hashBytes(hash, &orientation, sizeof(orientation));
+	for (const auto& e : chr->getAttributes()) {
+		hash = hashString(hash, e.first);
+		hash = hashString(hash, e.second);
+	}
+	return hash;
+}
+
+uint32_t hashAggro(const AggroMgr::Entries& entries) {
+	uint32_t hash = HashSeed;
+	for (const Entry& entry : entries) {
+		const CharacterId id = entry.getCharacterId();
+		const float aggro = entry.getAggro();
+		hash = hashBytes(hash, &id, sizeof(id));
+		hash = hashBytes(hash, &aggro, sizeof(aggro));
+	}
+	return hash;
+}
+
+/**
+ * @brief The milliseconds since the last execution of the node - in the time of the ai, because that is
+ * the clock the execution times are recorded with. @c -1 if the node wasn't executed yet.
+ */
+inline int64_t lastRunMillis(const AIPtr& ai, int64_t lastExec) {
+	return lastExec == -1 ? -1 : ai->getTime() - lastExec;
+}
+
+class ScopedMicros {
+private:
+	uint64_t& _target;
+	const std::chrono::steady_clock::time_point _start;
+public:
+	explicit ScopedMicros(uint64_t& target) :
+			_target(target), _start(std::chrono::steady_clock::now()) {
+	}
+	~ScopedMicros() {
+		const auto delta = std::chrono::steady_clock::now() - _start;
+		_target += std::chrono::duration_cast<std::chrono::microseconds>(delta).count();
+	}
+};
 }
 
 Server::Server(AIRegistry& aiRegistry, short port, const std::string& hostname) :
@@ -64,13 +132,15 @@ void Server::enqueueEvent(const Event& event) {
 }
 
 void Server::onConnect(Client* client) {
+	_clients[client] = ClientState();
 	Event event;
 	event.type = EV_NEWCONNECTION;
 	event.data.newClient = client;
 	enqueueEvent(event);
 }
 
-void Server::onDisconnect(Client* /*client*/) {
+void Server::onDisconnect(Client* client) {
+	_clients.erase(client);
 	ai_log("remote debugger disconnect (%i)", _network.getConnectedClients());
 	Zone* zone = _zone;
 	if (zone == nullptr) {
@@ -111,31 +181,93 @@ void Server::addChildren(const TreeNodePtr& node, AIStateNode& parent, const AIP
 	const TreeNodes& children = node->getChildren();
 	std::vector<bool> currentlyRunning(children.size());
 	node->getRunningChildren(ai, currentlyRunning);
-	const int64_t aiTime = ai->_time;
 	const std::size_t length = children.size();
 	for (std::size_t i = 0; i < length; ++i) {
 		const TreeNodePtr& childNode = children[i];
 		const int32_t id = childNode->getId();
 		const ConditionPtr& condition = childNode->getCondition();
 		const std::string conditionStr = condition ? condition->getNameWithConditions(ai) : "";
-		const int64_t lastRun = childNode->getLastExecMillis(ai);
-		const int64_t delta = lastRun == -1 ? -1 : aiTime - lastRun;
-		AIStateNode child(id, conditionStr, delta, childNode->getLastStatus(ai), currentlyRunning[i]);
+		const int64_t lastRun = lastRunMillis(ai, childNode->getLastExecMillis(ai));
+		AIStateNode child(id, conditionStr, lastRun, childNode->getLastStatus(ai), currentlyRunning[i]);
 		addChildren(childNode, child, ai);
 		parent.addChildren(child);
 	}
 }
 
+bool Server::isThrottled(Client* client) {
+	if (_network.getPendingBytes(client) <= _maxPendingBytes) {
+		return false;
+	}
+	// the client will get the delta against its last state once it caught up
+	++_stats.throttled;
+	return true;
+}
+
 void Server::broadcastState(const Zone* zone) {
 	_broadcastMask |= SV_BROADCAST_STATE;
-	AIStateMessage msg;
+	ScopedMicros timer(_stats.broadcastMicros);
+	++_stats.broadcasts;
+
+	// hash the current state only once - the attributes are only copied for changed characters
+	_stateSnapshots.clear();
 	auto func = [&] (const AIPtr& ai) {
-		const ICharacterPtr& chr = ai->getCharacter();
-		const AIStateWorld b(chr->getId(), chr->getPosition(), chr->getOrientation(), chr->getAttributes());
-		msg.addState(b);
+		_stateSnapshots.push_back(StateSnapshot{ai, hashState(ai->getCharacter())});
 	};
 	zone->execute(func);
-	_network.broadcast(msg);
+
+	for (auto& e : _clients) {
+		Client* client = e.first;
+		ClientState& clientState = e.second;
+		if (isThrottled(client)) {
+			continue;
+		}
+		const uint32_t generation = ++clientState.generation;
+		if (clientState.fullState) {
+			clientState.fullState = false;
+			clientState.states.clear();
+			AIStateMessage msg;
+			msg.reserve(_stateSnapshots.size());
+			for (const StateSnapshot& snapshot : _stateSnapshots) {
+				const ICharacterPtr& chr = snapshot.ai->getCharacter();
+				msg.addState(AIStateWorld(chr->getId(), chr->getPosition(), chr->getOrientation(), chr->getAttributes()));
+				clientState.states[chr->getId()] = std::make_pair(snapshot.hash, generation);
+			}
+			_network.sendToClient(client, msg);
+			++_stats.fullMessages;
+			continue;
+		}
+
+		AIStateDeltaMessage msg;
+		for (const StateSnapshot& snapshot : _stateSnapshots) {
+			const ICharacterPtr& chr = snapshot.ai->getCharacter();
+			auto i = clientState.states.find(chr->getId());
+			if (i == clientState.states.end()) {
+				clientState.states.emplace(chr->getId(), std::make_pair(snapshot.hash, generation));
+			} else {
+				i->second.second = generation;
+				if (i->second.first == snapshot.hash) {
+					continue;
+				}
+				i->second.first = snapshot.hash;
+			}
+			msg.addState(AIStateWorld(chr->getId(), chr->getPosition(), chr->getOrientation(), chr->getAttributes()));
+		}
+		// everything that wasn't touched in this generation is gone
+		for (auto i = clientState.states.begin(); i != clientState.states.end();) {
+			if (i->second.second == generation) {
+				++i;
+				continue;
+			}
+			msg.addRemoved(i->first);
+			i = clientState.states.erase(i);
+		}
+		if (msg.empty()) {
+			continue;
+		}
+		_network.sendToClient(client, msg);
+		++_stats.deltaMessages;
+	}
+	_stateSnapshots.clear();
 }
 
 void Server::broadcastStaticCharacterDetails(const Zone* zone) {
@@ -163,6 +295,27 @@ void Server::broadcastStaticCharacterDetails(const Zone* zone) {
 	}
 }
 
+void Server::addNodeSnapshots(const TreeNodePtr& node, const AIPtr& ai, bool running) {
+	const ConditionPtr& condition = node->getCondition();
+	const std::string conditionStr = condition ? condition->getNameWithConditions(ai) : "";
+	const int64_t lastExec = node->getLastExecMillis(ai);
+	const TreeNodeStatus status = node->getLastStatus(ai);
+	const int64_t lastRun = lastRunMillis(ai, lastExec);
+	uint32_t hash = hashString(HashSeed, conditionStr);
+	hash = hashBytes(hash, &lastExec, sizeof(lastExec));
+	hash = hashBytes(hash, &status, sizeof(status));
+	hash = hashBytes(hash, &running, sizeof(running));
+	_nodeSnapshots.push_back(NodeSnapshot{AIStateNodeStatus(node->getId(), conditionStr, lastRun, status, running), hash});
+
+	const TreeNodes& children = node->getChildren();
+	std::vector<bool> currentlyRunning(children.size());
+	node->getRunningChildren(ai, currentlyRunning);
+	const std::size_t length = children.size();
+	for (std::size_t i = 0; i < length; ++i) {
+		addNodeSnapshots(children[i], ai, currentlyRunning[i]);
+	}
+}
+
 void Server::broadcastCharacterDetails(const Zone* zone) {
 	_broadcastMask |= SV_BROADCAST_CHRDETAILS;
 	const CharacterId id = _selectedCharacterId;
@@ -170,33 +323,93 @@ void Server::broadcastCharacterDetails(const Zone* zone) {
 		return;
 	}
 
-	static const auto func = [&] (const AIPtr& ai) {
+	ScopedMicros timer(_stats.broadcastMicros);
+	auto func = [&] (const AIPtr& ai) {
 		if (!ai) {
 			return false;
 		}
 		const TreeNodePtr& node = ai->getBehaviour();
-		const int32_t nodeId = node->getId();
-		const ConditionPtr& condition = node->getCondition();
-		const std::string conditionStr = condition ? condition->getNameWithConditions(ai) : "";
-		AIStateNode root(nodeId, conditionStr, _time - node->getLastExecMillis(ai), node->getLastStatus(ai), true);
-		addChildren(node, root, ai);
+		_nodeSnapshots.clear();
+		addNodeSnapshots(node, ai, true);
+		std::sort(_nodeSnapshots.begin(), _nodeSnapshots.end(), [] (const NodeSnapshot& a, const NodeSnapshot& b) {
+			return a.status.nodeId < b.status.nodeId;
+		});
 
-		AIStateAggro aggro;
 		const ai::AggroMgr::Entries& entries = ai->getAggroMgr().getEntries();
-		aggro.reserve(entries.size());
-		for (const Entry& e : entries) {
-			aggro.addAggro(AIStateAggroEntry(e.getCharacterId(), e.getAggro()));
-		}
+		const uint32_t aggroHash = hashAggro(entries);
+		for (auto& e : _clients) {
+			Client* client = e.first;
+			ClientState& clientState = e.second;
+			if (isThrottled(client)) {
+				continue;
+			}
+			if (clientState.detailsId != id) {
+				clientState.detailsId = id;
+				clientState.detailsTime = ai->getTime();
+				clientState.aggroHash = aggroHash;
+				clientState.nodes.clear();
+				for (const NodeSnapshot& snapshot : _nodeSnapshots) {
+					clientState.nodes[snapshot.status.nodeId] = snapshot.hash;
+				}
 
-		const AICharacterDetailsMessage msg(ai->getId(), aggro, root);
-		_network.broadcast(msg);
+				const int32_t nodeId = node->getId();
+				const ConditionPtr& condition = node->getCondition();
+				const std::string conditionStr = condition ? condition->getNameWithConditions(ai) : "";
+				AIStateNode root(nodeId, conditionStr, lastRunMillis(ai, node->getLastExecMillis(ai)), node->getLastStatus(ai), true);
+				addChildren(node, root, ai);
+
+				AIStateAggro aggro;
+				aggro.reserve(entries.size());
+				for (const Entry& entry : entries) {
+					aggro.addAggro(AIStateAggroEntry(entry.getCharacterId(), entry.getAggro()));
+				}
+
+				const AICharacterDetailsMessage msg(ai->getId(), aggro, root);
+				_network.sendToClient(client, msg);
+				++_stats.fullMessages;
+				continue;
+			}
+
+			AICharacterDetailsDeltaMessage msg(id, ai->getTime() - clientState.detailsTime);
+			if (clientState.aggroHash != aggroHash) {
+				clientState.aggroHash = aggroHash;
+				AIStateAggro aggro;
+				aggro.reserve(entries.size());
+				for (const Entry& entry : entries) {
+					aggro.addAggro(AIStateAggroEntry(entry.getCharacterId(), entry.getAggro()));
+				}
+				msg.setAggro(std::move(aggro));
+			}
+			for (const NodeSnapshot& snapshot : _nodeSnapshots) {
+				uint32_t& hash = clientState.nodes[snapshot.status.nodeId];
+				if (hash == snapshot.hash) {
+					continue;
+				}
+				hash = snapshot.hash;
+				msg.addNode(snapshot.status);
+			}
+			if (msg.empty()) {
+				// the elapsed time is accumulated until something changed
+				continue;
+			}
+			clientState.detailsTime = ai->getTime();
+			_network.sendToClient(client, msg);
+			++_stats.deltaMessages;
+		}
 		return true;
 	};
+	++_stats.broadcasts;
 	if (!zone->execute(id, func)) {
 		resetSelection();
 	}
 }
 
+void Server::resetClientStates() {
+	for (auto& e : _clients) {
+		e.second = ClientState();
+	}
+}
+
 void Server::handleEvents(Zone* zone, bool pauseState) {
 	std::vector<Event> events;
 	{
@@ -259,6 +472,10 @@ void Server::handleEvents(Zone* zone, bool pauseState) {
 			break;
 		}
 		case EV_UPDATESTATICCHRDETAILS: {
+			// the node ids might have changed - the next details are sent in full
+			for (auto& e : _clients) {
+				e.second.detailsId = AI_NOTHING_SELECTED;
+			}
 			broadcastStaticCharacterDetails(event.data.zone);
 			break;
 		}
@@ -280,7 +497,9 @@ void Server::handleEvents(Zone* zone, bool pauseState) {
 			break;
 		}
 		case EV_ZONEREMOVE: {
-			_zone.compare_exchange_strong(event.data.zone, nullptr);
+			if (_zone.compare_exchange_strong(event.data.zone, nullptr)) {
+				resetClientStates();
+			}
 			if (_zones.erase(event.data.zone) != 1) {
 				return;
 			}
@@ -299,6 +518,7 @@ void Server::handleEvents(Zone* zone, bool pauseState) {
 			Zone* nullzone = nullptr;
 			_zone = nullzone;
 			resetSelection();
+			resetClientStates();
 
 			for (Zone* z : _zones) {
 				const bool debug = z->getName() == event.strData;
@@ -493,7 +713,8 @@ void Server::update(int64_t deltaTime) {
 	handleEvents(zone, pauseState);
 
 	if (clients > 0 && zone != nullptr) {
-		if (!pauseState) {
+		if (!pauseState && _time - _lastBroadcast >= _broadcastInterval) {
+			_lastBroadcast = _time;
 			if ((_broadcastMask & SV_BROADCAST_STATE) == 0) {
 				broadcastState(zone);
 			}
@@ -506,6 +727,7 @@ void Server::update(int64_t deltaTime) {
 		resetSelection();
 	}
 	_network.update(deltaTime);
+	_stats.sentBytes = _network.getSentBytes();
 }
 
 }
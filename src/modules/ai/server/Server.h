@@ -6,6 +6,7 @@
 #include "common/Thread.h"
 #include "tree/TreeNode.h"
 #include <unordered_set>
+#include <unordered_map>
 #include "Network.h"
 #include "zone/Zone.h"
 #include "AIRegistry.h"
@@ -40,8 +41,32 @@ class NopHandler;
  * will also broadcast an @ai{AICharacterDetailsMessage} to all connected clients.
  *
  * You can only debug one @ai{Zone} at the same time. The debugging session is shared between all connected clients.
+ *
+ * To keep the costs of an attached debugger bounded, the world state and the character details are only broadcasted
+ * once per broadcast interval (see @ai{setBroadcastInterval()}). After the first full state, each client only
+ * receives the delta against the state that it already got (@ai{AIStateDeltaMessage} and
+ * @ai{AICharacterDetailsDeltaMessage}). Clients that don't consume their data fast enough don't get new states
+ * until their pending bytes dropped below @ai{setMaxPendingBytes()}.
  */
 class Server: public INetworkListener {
+public:
+	/**
+	 * @brief Counters to measure the costs of the debug server
+	 */
+	struct Stats {
+		// the amount of broadcasts of the world state and character details
+		uint64_t broadcasts = 0u;
+		// the amount of full state messages that were sent
+		uint64_t fullMessages = 0u;
+		// the amount of delta state messages that were sent
+		uint64_t deltaMessages = 0u;
+		// the amount of times a client was skipped because it didn't consume the pending bytes
+		uint64_t throttled = 0u;
+		// the microseconds that were spent in collecting and serializing the states
+		uint64_t broadcastMicros = 0u;
+		// the bytes that were handed over to the sockets
+		uint64_t sentBytes = 0u;
+	};
 protected:
 	typedef std::unordered_set<Zone*> Zones;
 	typedef Zones::const_iterator ZoneConstIter;
@@ -66,6 +91,47 @@ protected:
 	ReadWriteLock _lock = {"server"};
 	std::vector<std::string> _names;
 	uint32_t _broadcastMask = 0u;
+	int64_t _broadcastInterval = 100L;
+	int64_t _lastBroadcast = 0L;
+	size_t _maxPendingBytes = 1024u * 1024u;
+	Stats _stats;
+
+	/**
+	 * @brief The state that was already sent to a particular client - used for the delta encoding
+	 */
+	struct ClientState {
+		// if true, the next world state is sent in full
+		bool fullState = true;
+		uint32_t generation = 0u;
+		// character id to the hash and the generation of the last sent world state
+		std::unordered_map<CharacterId, std::pair<uint32_t, uint32_t> > states;
+		// the character the node hashes belong to
+		CharacterId detailsId = AI_NOTHING_SELECTED;
+		// the time of the ai when the last details were sent
+		int64_t detailsTime = 0L;
+		uint32_t aggroHash = 0u;
+		// node id to the hash of the last sent node status
+		std::unordered_map<int32_t, uint32_t> nodes;
+	};
+	std::unordered_map<Client*, ClientState> _clients;
+
+	/**
+	 * @brief Flattened runtime state of a behaviour tree node of the selected character
+	 */
+	struct NodeSnapshot {
+		AIStateNodeStatus status;
+		uint32_t hash;
+	};
+	std::vector<NodeSnapshot> _nodeSnapshots;
+
+	/**
+	 * @brief Current world state of a character of the debugged zone
+	 */
+	struct StateSnapshot {
+		AIPtr ai;
+		uint32_t hash;
+	};
+	std::vector<StateSnapshot> _stateSnapshots;
 
 	enum EventType {
 		EV_SELECTION,
@@ -98,6 +164,9 @@ protected:
 
 	void addChildren(const TreeNodePtr& node, std::vector<AIStateNodeStatic>& out) const;
 	void addChildren(const TreeNodePtr& node, AIStateNode& parent, const AIPtr& ai) const;
+	void addNodeSnapshots(const TreeNodePtr& node, const AIPtr& ai, bool running);
+	bool isThrottled(Client* client);
+	void resetClientStates();
 
 	// only call these from the Server::update method
 	void broadcastState(const Zone* zone);
@@ -203,10 +272,39 @@ public:
 	 */
 	void step(int64_t stepMillis = 1L);
 
+	/**
+	 * @brief Set the minimum milliseconds between two broadcasts of the world state and the character details.
+	 * Explicit debugger actions like stepping or pausing are still broadcasted immediately.
+	 */
+	void setBroadcastInterval(int64_t millis);
+
+	/**
+	 * @brief Set the amount of unsent bytes a client may have in its queue before it gets no further
+	 * world states or character details.
+	 */
+	void setMaxPendingBytes(size_t bytes);
+
+	/**
+	 * @return Counters that measure the costs of the debug server
+	 */
+	const Stats& getStats() const;
+
 	/**
 	 * @brief call this to update the server - should get called somewhere from your game tick
 	 */
 	void update(int64_t deltaTime);
 };
 
+inline void Server::setBroadcastInterval(int64_t millis) {
+	_broadcastInterval = millis;
+}
+
+inline void Server::setMaxPendingBytes(size_t bytes) {
+	_maxPendingBytes = bytes;
+}
+
+inline const Server::Stats& Server::getStats() const {
+	return _stats;
+}
+
 }
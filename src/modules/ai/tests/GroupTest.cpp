@@ -192,3 +192,92 @@ TEST_F(GroupTest, testGroupRemove) {
 	ASSERT_TRUE(groupMgr.remove(id, entity3));
 	ASSERT_EQ(0, groupMgr.getGroupSize(id));
 }
+
+TEST_F(GroupTest, testGroupAveragePositionAfterRemove) {
+	const ai::GroupId id = 1;
+	ai::GroupMgr groupMgr;
+	ai::AIPtr entity1(new ai::AI(ai::TreeNodePtr()));
+	entity1->setCharacter(ai::ICharacterPtr(new ai::ICharacter(1)));
+	entity1->getCharacter()->setPosition(glm::vec3(1.0f, 1.0f, 0.0f));
+	ai::AIPtr entity2(new ai::AI(ai::TreeNodePtr()));
+	entity2->setCharacter(ai::ICharacterPtr(new ai::ICharacter(2)));
+	entity2->getCharacter()->setPosition(glm::vec3(3.0f, 3.0f, 0.0f));
+	ai::AIPtr entity3(new ai::AI(ai::TreeNodePtr()));
+	entity3->setCharacter(ai::ICharacterPtr(new ai::ICharacter(3)));
+	entity3->getCharacter()->setPosition(glm::vec3(5.0f, 5.0f, 0.0f));
+	ASSERT_TRUE(groupMgr.add(id, entity1));
+	ASSERT_TRUE(groupMgr.add(id, entity2));
+	ASSERT_TRUE(groupMgr.add(id, entity3));
+	// the centroid is maintained on add and remove without an update
+	ASSERT_EQ(glm::vec3(3.0f, 3.0f, 0.0f), groupMgr.getPosition(id));
+	ASSERT_TRUE(groupMgr.remove(id, entity1));
+	ASSERT_EQ(glm::vec3(4.0f, 4.0f, 0.0f), groupMgr.getPosition(id));
+	ASSERT_TRUE(groupMgr.isInGroup(id, entity2));
+	ASSERT_TRUE(groupMgr.isInGroup(id, entity3));
+
+	entity2->getCharacter()->setPosition(glm::vec3(1.0f, 1.0f, 0.0f));
+	groupMgr.update(0);
+	ASSERT_EQ(glm::vec3(3.0f, 3.0f, 0.0f), groupMgr.getPosition(id));
+}
+
+TEST_F(GroupTest, testGroupAveragePositionMove) {
+	const ai::GroupId id = 1;
+	ai::GroupMgr groupMgr;
+	ai::AIPtr entity1(new ai::AI(ai::TreeNodePtr()));
+	entity1->setCharacter(ai::ICharacterPtr(new ai::ICharacter(1)));
+	entity1->getCharacter()->setPosition(glm::vec3(1.0f, 1.0f, 0.0f));
+	ai::AIPtr entity2(new ai::AI(ai::TreeNodePtr()));
+	entity2->setCharacter(ai::ICharacterPtr(new ai::ICharacter(2)));
+	entity2->getCharacter()->setPosition(glm::vec3(3.0f, 3.0f, 0.0f));
+	ASSERT_TRUE(groupMgr.add(id, entity1));
+	ASSERT_TRUE(groupMgr.add(id, entity2));
+	ASSERT_EQ(glm::vec3(2.0f, 2.0f, 0.0f), groupMgr.getPosition(id));
+
+	// moving a member updates the centroid immediately
+	entity1->getCharacter()->setPosition(glm::vec3(5.0f, 5.0f, 0.0f));
+	ASSERT_EQ(glm::vec3(4.0f, 4.0f, 0.0f), groupMgr.getPosition(id));
+
+	// in the read-only phase the moves are applied with the update
+	groupMgr.beginUpdate();
+	entity1->getCharacter()->setPosition(glm::vec3(7.0f, 7.0f, 0.0f));
+	entity1->getCharacter()->setPosition(glm::vec3(9.0f, 9.0f, 0.0f));
+	ASSERT_EQ(glm::vec3(4.0f, 4.0f, 0.0f), groupMgr.getPosition(id));
+	groupMgr.update(0);
+	ASSERT_EQ(glm::vec3(6.0f, 6.0f, 0.0f), groupMgr.getPosition(id));
+
+	// a removed member doesn't influence the centroid anymore
+	ASSERT_TRUE(groupMgr.remove(id, entity1));
+	entity1->getCharacter()->setPosition(glm::vec3(100.0f, 100.0f, 0.0f));
+	ASSERT_EQ(glm::vec3(3.0f, 3.0f, 0.0f), groupMgr.getPosition(id));
+}
+
+TEST_F(GroupTest, testGroupDeferredChanges) {
+	const ai::GroupId id = 1;
+	ai::GroupMgr groupMgr;
+	ai::AIPtr entity1(new ai::AI(ai::TreeNodePtr()));
+	entity1->setCharacter(ai::ICharacterPtr(new ai::ICharacter(1)));
+	ai::AIPtr entity2(new ai::AI(ai::TreeNodePtr()));
+	entity2->setCharacter(ai::ICharacterPtr(new ai::ICharacter(2)));
+	ASSERT_TRUE(groupMgr.add(id, entity1));
+
+	groupMgr.beginUpdate();
+	ASSERT_TRUE(groupMgr.add(id, entity2));
+	ASSERT_TRUE(groupMgr.remove(id, entity1));
+	// nothing changes until the update was executed
+	ASSERT_EQ(1, groupMgr.getGroupSize(id));
+	ASSERT_TRUE(groupMgr.isInGroup(id, entity1));
+	ASSERT_FALSE(groupMgr.isInGroup(id, entity2));
+	groupMgr.update(0);
+
+	ASSERT_EQ(1, groupMgr.getGroupSize(id));
+	ASSERT_FALSE(groupMgr.isInGroup(id, entity1));
+	ASSERT_TRUE(groupMgr.isInGroup(id, entity2));
+	ASSERT_TRUE(groupMgr.isGroupLeader(id, entity2));
+
+	groupMgr.beginUpdate();
+	ASSERT_TRUE(groupMgr.removeFromAllGroups(entity2));
+	ASSERT_TRUE(groupMgr.isInAnyGroup(entity2));
+	groupMgr.update(0);
+	ASSERT_FALSE(groupMgr.isInAnyGroup(entity2));
+	ASSERT_EQ(0, groupMgr.getGroupSize(id));
+}
@@ -10,6 +10,8 @@
 #include "server/AINamesMessage.h"
 #include "server/AICharacterDetailsMessage.h"
 #include "server/AIStateMessage.h"
+#include "server/AIStateDeltaMessage.h"
+#include "server/AICharacterDetailsDeltaMessage.h"
 
 class MessageTest: public TestSuite {
 protected:
@@ -123,3 +125,113 @@ TEST_F(MessageTest, testIProtocolMessageReset) {
 	ai::IProtocolMessage* d = serializeDeserialize(m);
 	ASSERT_EQ(m.getId(), d->getId());
 }
+
+TEST_F(MessageTest, testAIStateDeltaMessage) {
+	ai::AIStateDeltaMessage m;
+	ASSERT_TRUE(m.empty());
+	m.addState(ai::AIStateWorld(1, ai::ZERO, 1.0f));
+	m.addRemoved(2);
+	m.addRemoved(3);
+	ASSERT_FALSE(m.empty());
+
+	ai::AIStateDeltaMessage* d = serializeDeserialize(m);
+	ASSERT_EQ(ai::PROTO_STATE_DELTA, d->getId());
+	ASSERT_EQ(1u, d->getStates().size());
+	ASSERT_EQ(1, d->getStates()[0].getId());
+	ASSERT_FLOAT_EQ(1.0f, d->getStates()[0].getOrientation());
+	ASSERT_EQ(2u, d->getRemoved().size());
+	ASSERT_EQ(2, d->getRemoved()[0]);
+	ASSERT_EQ(3, d->getRemoved()[1]);
+}
+
+TEST_F(MessageTest, testAICharacterDetailsDeltaMessage) {
+	ai::AICharacterDetailsDeltaMessage m(1, 100L);
+	ai::AIStateAggro aggro;
+	aggro.addAggro(ai::AIStateAggroEntry(2, 1.0f));
+	m.setAggro(std::move(aggro));
+	m.addNode(ai::AIStateNodeStatus(3, "condition", 0L, ai::FINISHED, false));
+
+	ai::AICharacterDetailsDeltaMessage* d = serializeDeserialize(m);
+	ASSERT_EQ(ai::PROTO_CHARACTER_DETAILS_DELTA, d->getId());
+	ASSERT_EQ(1, d->getCharacterId());
+	ASSERT_EQ(100L, d->getElapsedMillis());
+	ASSERT_TRUE(d->hasAggro());
+	ASSERT_EQ(1u, d->getAggro().getAggro().size());
+	ASSERT_EQ(2, d->getAggro().getAggro()[0].id);
+	ASSERT_EQ(1u, d->getNodes().size());
+	ASSERT_EQ(3, d->getNodes()[0].nodeId);
+	ASSERT_EQ("condition", d->getNodes()[0].condition);
+	ASSERT_EQ(ai::FINISHED, d->getNodes()[0].status);
+	ASSERT_FALSE(d->getNodes()[0].running);
+}
+
+TEST_F(MessageTest, testAICharacterDetailsDeltaMessageUnchangedAggro) {
+	ai::AICharacterDetailsDeltaMessage m(1, 100L);
+	ASSERT_TRUE(m.empty());
+	m.addNode(ai::AIStateNodeStatus(3, "condition", 0L, ai::FINISHED, false));
+	ASSERT_FALSE(m.empty());
+
+	ai::AICharacterDetailsDeltaMessage* d = serializeDeserialize(m);
+	ASSERT_FALSE(d->hasAggro());
+	ASSERT_TRUE(d->getAggro().getAggro().empty());
+	ASSERT_EQ(1u, d->getNodes().size());
+}
+
+TEST_F(MessageTest, testAIStateNodeApplyDelta) {
+	ai::AIStateNode root(1, "root", 10L, ai::RUNNING, true);
+	root.addChildren(ai::AIStateNode(2, "child", -1L, ai::UNKNOWN, false));
+	root.addChildren(ai::AIStateNode(3, "child", 5L, ai::FINISHED, false));
+
+	std::vector<ai::AIStateNodeStatus> changed;
+	changed.emplace_back(2, "changed", 0L, ai::RUNNING, true);
+	root.applyDelta(100L, changed);
+
+	ASSERT_EQ(110L, root.getLastRun());
+	const ai::AIStateNode& child1 = root.getChildren()[0];
+	ASSERT_EQ("changed", child1.getCondition());
+	ASSERT_EQ(0L, child1.getLastRun());
+	ASSERT_EQ(ai::RUNNING, child1.getStatus());
+	ASSERT_TRUE(child1.isRunning());
+	const ai::AIStateNode& child2 = root.getChildren()[1];
+	ASSERT_EQ(105L, child2.getLastRun());
+	ASSERT_EQ(ai::FINISHED, child2.getStatus());
+}
+
+TEST_F(MessageTest, testRingBufferWrapAround) {
+	ai::RingBuffer buf(16);
+	const uint8_t data[12] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+	buf.append(data, sizeof(data));
+	buf.skip(10);
+	// this wraps around the end of the storage
+	buf.append(data, sizeof(data));
+	ASSERT_EQ(14u, buf.size());
+	ASSERT_EQ(16u, buf.capacity());
+	ai::RingBuffer::Segment segments[2];
+	ASSERT_EQ(2, buf.segments(segments));
+	ASSERT_EQ(14u, segments[0].size + segments[1].size);
+	uint8_t out[14];
+	ASSERT_TRUE(buf.read(out, sizeof(out)));
+	ASSERT_EQ(10, out[0]);
+	ASSERT_EQ(11, out[1]);
+	ASSERT_EQ(0, out[2]);
+	ASSERT_EQ(11, out[13]);
+	ASSERT_TRUE(buf.empty());
+}
+
+TEST_F(MessageTest, testRingBufferGrow) {
+	ai::RingBuffer buf(16);
+	for (int i = 0; i < 10; ++i) {
+		buf.push_back(i);
+	}
+	buf.skip(8);
+	for (int i = 0; i < 20; ++i) {
+		ai::IProtocolMessage::addInt(buf, i);
+	}
+	ASSERT_EQ(2u + 20u * 4u, buf.size());
+	ASSERT_EQ(8, ai::IProtocolMessage::readByte(buf));
+	ASSERT_EQ(9, ai::IProtocolMessage::readByte(buf));
+	for (int i = 0; i < 20; ++i) {
+		ASSERT_EQ(i, ai::IProtocolMessage::readInt(buf));
+	}
+	ASSERT_TRUE(buf.empty());
+}
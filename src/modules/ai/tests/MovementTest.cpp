@@ -3,6 +3,7 @@
  */
 
 #include "TestShared.h"
+#include "movement/BatchedSteering.h"
 #include "movement/SelectionSeek.h"
 #include "movement/SelectionFlee.h"
 #include "movement/GroupFlee.h"
@@ -115,3 +116,65 @@ TEST_F(MovementTest, testWeightedSteering) {
 	const glm::vec3 result = glm::vec3(-_speed, 0.0f, 0.0f) * 0.8f + glm::vec3(_speed, 0.0f, 0.0f) * 0.2f;
 	EXPECT_EQ(result, mv.getVector());
 }
+
+TEST_F(MovementTest, testBatchedSteeringMatchesScalar) {
+	const ai::SteeringPtr& seek = std::make_shared<ai::movement::TargetSeek>("10:2:-5");
+	const ai::SteeringPtr& flee = std::make_shared<ai::movement::TargetFlee>("-3:0:7");
+	const ai::SteeringPtr& wander = std::make_shared<ai::movement::Wander>("0");
+
+	ai::movement::WeightedSteerings s;
+	s.push_back(ai::movement::WeightedData(seek, 0.5f));
+	s.push_back(ai::movement::WeightedData(flee, 0.3f));
+	s.push_back(ai::movement::WeightedData(wander, 0.2f));
+	const ai::movement::WeightedSteering w(s);
+	ASSERT_TRUE(w.isBatchable());
+
+	// not a multiple of the simd width to also cover the scalar tail
+	const int amount = 11;
+	const int64_t deltaMillis = 100;
+	const float deltaSeconds = static_cast<float>(deltaMillis) / 1000.0f;
+	ai::movement::BatchedSteering batched;
+	std::vector<ai::ICharacterPtr> characters;
+	std::vector<glm::vec3> expectedPositions;
+	std::vector<float> expectedOrientations;
+	for (int i = 0; i < amount; ++i) {
+		const ai::AIPtr& ai = std::make_shared<ai::AI>(ai::TreeNodePtr());
+		const ai::ICharacterPtr& entity = std::make_shared<ai::ICharacter>(i + 1);
+		ai->setCharacter(entity);
+		entity->setPosition(glm::vec3(i * 3.0f - 10.0f, (float)(i % 3), 20.0f - i * 4.0f));
+		entity->setOrientation(i * 0.5f);
+		entity->setSpeed(10.0f + i);
+
+		const ai::MoveVector& mv = w.execute(ai, entity->getSpeed());
+		expectedPositions.push_back(entity->getPosition() + mv.getVector() * deltaSeconds);
+		expectedOrientations.push_back(fmodf(entity->getOrientation() + mv.getRotation() * deltaSeconds, glm::two_pi<float>()));
+		characters.push_back(entity);
+		ASSERT_TRUE(batched.add(&w, ai, deltaMillis));
+	}
+	EXPECT_EQ((size_t)amount, batched.size());
+	EXPECT_EQ((size_t)amount, batched.execute());
+	EXPECT_EQ(0u, batched.size());
+
+	const float eps = 0.0001f;
+	for (int i = 0; i < amount; ++i) {
+		const glm::vec3& pos = characters[i]->getPosition();
+		EXPECT_NEAR(expectedPositions[i].x, pos.x, eps) << "character " << i;
+		EXPECT_NEAR(expectedPositions[i].y, pos.y, eps) << "character " << i;
+		EXPECT_NEAR(expectedPositions[i].z, pos.z, eps) << "character " << i;
+		EXPECT_NEAR(expectedOrientations[i], characters[i]->getOrientation(), eps) << "character " << i;
+	}
+}
+
+TEST_F(MovementTest, testBatchedSteeringRejectsUnsupported) {
+	ai::movement::WeightedSteerings s;
+	s.push_back(ai::movement::WeightedData(std::make_shared<ai::movement::Wander>("0"), 0.5f));
+	s.push_back(ai::movement::WeightedData(std::make_shared<ai::movement::GroupSeek>("1"), 0.5f));
+	const ai::movement::WeightedSteering w(s);
+	EXPECT_FALSE(w.isBatchable());
+
+	ai::movement::BatchedSteering batched;
+	const ai::AIPtr& ai = std::make_shared<ai::AI>(ai::TreeNodePtr());
+	ai->setCharacter(std::make_shared<ai::ICharacter>(1));
+	EXPECT_FALSE(batched.add(&w, ai, 100));
+	EXPECT_EQ(0u, batched.execute());
+}
@@ -0,0 +1,166 @@
+/**
+ * @file
+ */
+
+#include "TestShared.h"
+#include "server/Server.h"
+#include "server/ProtocolMessageFactory.h"
+#include "server/AIStateMessage.h"
+#include "server/AIStateDeltaMessage.h"
+#include "server/AICharacterDetailsMessage.h"
+#include "server/AICharacterDetailsDeltaMessage.h"
+#include "tree/PrioritySelector.h"
+#include "tree/Idle.h"
+
+namespace {
+
+/**
+ * @brief Broadcasts to a client that is not backed by a connection - the queued bytes are never sent, so
+ * the test can read the messages from the stream of the client.
+ */
+class TestServer : public ai::Server {
+public:
+	ai::Client client { 0 };
+
+	TestServer(ai::AIRegistry& registry) :
+			ai::Server(registry) {
+		_clients[&client] = ClientState();
+	}
+
+	void select(ai::CharacterId id) {
+		_selectedCharacterId = id;
+	}
+
+	void broadcastState(const ai::Zone* zone) {
+		ai::Server::broadcastState(zone);
+	}
+
+	void broadcastCharacterDetails(const ai::Zone* zone) {
+		ai::Server::broadcastCharacterDetails(zone);
+	}
+
+	/**
+	 * @return The id of the next queued message or @c -1 if nothing is queued
+	 */
+	int next(ai::IProtocolMessage** msg) {
+		ai::ProtocolMessageFactory& f = ai::ProtocolMessageFactory::get();
+		if (!f.isNewMessageAvailable(client.out)) {
+			return -1;
+		}
+		*msg = f.create(client.out);
+		return (*msg)->getId();
+	}
+};
+
+}
+
+class ServerTest: public TestSuite {
+protected:
+	ai::Zone _zone {"server"};
+	ai::AIPtr _ai;
+	ai::AIPtr _ai2;
+
+	void SetUp() override {
+		TestSuite::SetUp();
+		ai::TreeNodePtr root = std::make_shared<ai::PrioritySelector>("root", "", ai::True::get());
+		root->addChild(std::make_shared<ai::Idle>("idle", "1000", ai::True::get()));
+		_ai = std::make_shared<ai::AI>(root);
+		_ai->setCharacter(std::make_shared<TestEntity>(1));
+		_ai2 = std::make_shared<ai::AI>(root);
+		_ai2->setCharacter(std::make_shared<TestEntity>(2));
+		ASSERT_TRUE(_zone.addAI(_ai));
+		ASSERT_TRUE(_zone.addAI(_ai2));
+		_zone.setDebug(true);
+		_zone.update(1);
+	}
+
+	void TearDown() override {
+		_zone.removeAI(_ai);
+		_zone.removeAI(_ai2);
+		_zone.update(0);
+		_ai = ai::AIPtr();
+		_ai2 = ai::AIPtr();
+		TestSuite::TearDown();
+	}
+};
+
+TEST_F(ServerTest, testStateDelta) {
+	TestServer server(_registry);
+	ai::IProtocolMessage* msg = nullptr;
+
+	server.broadcastState(&_zone);
+	ASSERT_EQ(ai::PROTO_STATE, server.next(&msg));
+	EXPECT_EQ(2u, static_cast<ai::AIStateMessage*>(msg)->getStates().size());
+	EXPECT_EQ(-1, server.next(&msg));
+
+	server.broadcastState(&_zone);
+	EXPECT_EQ(-1, server.next(&msg)) << "Nothing changed - nothing should be sent";
+
+	_ai->getCharacter()->setOrientation(1.0f);
+	ASSERT_TRUE(_zone.removeAI(_ai2));
+	_zone.update(1);
+	server.broadcastState(&_zone);
+	ASSERT_EQ(ai::PROTO_STATE_DELTA, server.next(&msg));
+	const ai::AIStateDeltaMessage* delta = static_cast<ai::AIStateDeltaMessage*>(msg);
+	ASSERT_EQ(1u, delta->getStates().size());
+	EXPECT_EQ(1, delta->getStates()[0].getId());
+	ASSERT_EQ(1u, delta->getRemoved().size());
+	EXPECT_EQ(2, delta->getRemoved()[0]);
+	EXPECT_EQ(1u, server.getStats().fullMessages);
+	EXPECT_EQ(1u, server.getStats().deltaMessages);
+}
+
+TEST_F(ServerTest, testCharacterDetailsDelta) {
+	TestServer server(_registry);
+	server.select(_ai->getId());
+	ai::IProtocolMessage* msg = nullptr;
+
+	server.broadcastCharacterDetails(&_zone);
+	ASSERT_EQ(ai::PROTO_CHARACTER_DETAILS, server.next(&msg));
+	const ai::AICharacterDetailsMessage* full = static_cast<ai::AICharacterDetailsMessage*>(msg);
+	const int64_t lastExec = _ai->getBehaviour()->getLastExecMillis(_ai);
+	ASSERT_NE(-1L, lastExec);
+	EXPECT_EQ(_ai->getTime() - lastExec, full->getNode().getLastRun()) << "The root must use the clock of the ai";
+	EXPECT_EQ(-1, server.next(&msg));
+
+	server.broadcastCharacterDetails(&_zone);
+	EXPECT_EQ(-1, server.next(&msg)) << "Nothing changed - no empty delta should be sent";
+
+	_ai->getAggroMgr().addAggro(2, 1.0f);
+	server.broadcastCharacterDetails(&_zone);
+	ASSERT_EQ(ai::PROTO_CHARACTER_DETAILS_DELTA, server.next(&msg));
+	const ai::AICharacterDetailsDeltaMessage* delta = static_cast<ai::AICharacterDetailsDeltaMessage*>(msg);
+	ASSERT_TRUE(delta->hasAggro());
+	ASSERT_EQ(1u, delta->getAggro().getAggro().size());
+	EXPECT_EQ(2, delta->getAggro().getAggro()[0].id);
+	EXPECT_TRUE(delta->getNodes().empty());
+
+	_zone.update(10);
+	server.broadcastCharacterDetails(&_zone);
+	ASSERT_EQ(ai::PROTO_CHARACTER_DETAILS_DELTA, server.next(&msg));
+	delta = static_cast<ai::AICharacterDetailsDeltaMessage*>(msg);
+	EXPECT_FALSE(delta->hasAggro()) << "The aggro didn't change";
+	EXPECT_FALSE(delta->getNodes().empty()) << "The behaviour was executed again";
+	EXPECT_EQ(10L, delta->getElapsedMillis());
+}
+
+TEST_F(ServerTest, testThrottle) {
+	TestServer server(_registry);
+	server.setMaxPendingBytes(16u);
+	ai::IProtocolMessage* msg = nullptr;
+
+	server.broadcastState(&_zone);
+	ASSERT_GT(server.client.out.size(), 16u);
+	_ai->getCharacter()->setOrientation(1.0f);
+	server.broadcastState(&_zone);
+	EXPECT_EQ(1u, server.getStats().throttled);
+	ASSERT_EQ(ai::PROTO_STATE, server.next(&msg));
+	EXPECT_EQ(-1, server.next(&msg)) << "The client should be skipped while its pending bytes are above the limit";
+
+	// the client caught up and gets the delta against the state it already received
+	server.broadcastState(&_zone);
+	ASSERT_EQ(ai::PROTO_STATE_DELTA, server.next(&msg));
+	const ai::AIStateDeltaMessage* delta = static_cast<ai::AIStateDeltaMessage*>(msg);
+	ASSERT_EQ(1u, delta->getStates().size());
+	EXPECT_EQ(1, delta->getStates()[0].getId());
+}
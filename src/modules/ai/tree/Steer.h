@@ -50,6 +50,12 @@ public:
 	}
 
 	TreeNodeStatus doAction(const AIPtr& entity, int64_t deltaMillis) override {
+		Zone* zone = entity->getZone();
+		if (zone != nullptr && zone->isBatchedMovement() && _w.isBatchable()) {
+			// batchable steerings never fail - the movement is applied at the end of the zone update
+			zone->getBatchedSteering().add(&_w, entity, deltaMillis);
+			return FINISHED;
+		}
 		const ICharacterPtr& chr = entity->getCharacter();
 		const MoveVector& mv = _w.execute(entity, chr->getSpeed());
 		if (isInfinite(mv.getVector())) {
@@ -115,7 +115,10 @@ void Zone::update(int64_t dt) {
 		ai->update(dt, _debug);
 		ai->getBehaviour()->execute(ai, dt);
 	};
+	// the groups are read-only while the behaviour trees are executed - changes are applied in the group update
+	_groupManager.beginUpdate();
 	executeParallel(func);
+	_batchedSteering.execute();
 	_groupManager.update(dt);
 }
 
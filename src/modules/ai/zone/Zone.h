@@ -15,6 +15,7 @@
 
 #include "ICharacter.h"
 #include "group/GroupMgr.h"
+#include "movement/BatchedSteering.h"
 #include "common/Thread.h"
 #include "core/ThreadPool.h"
 #include "common/CharacterId.h"
@@ -51,9 +52,11 @@ protected:
 	AIScheduleList _scheduledRemove;
 	CharacterIdList _scheduledDestroy;
 	bool _debug;
+	bool _batchedMovement = false;
 	ReadWriteLock _lock {"zone"};
 	ReadWriteLock _scheduleLock {"zone-schedulelock"};
 	ai::GroupMgr _groupManager;
+	movement::BatchedSteering _batchedSteering;
 	mutable core::ThreadPool _threadPool;
 
 	/**
@@ -159,6 +162,16 @@ public:
 	void setDebug(bool debug);
 	bool isDebug () const;
 
+	/**
+	 * @brief Let the @c Steer nodes queue their movement into the @c movement::BatchedSteering stage
+	 * that is executed after all behaviour trees of this zone were ticked.
+	 * @note Only steerings that support batching are affected - all others are still executed in the tree tick.
+	 */
+	void setBatchedMovement(bool batchedMovement);
+	bool isBatchedMovement() const;
+
+	movement::BatchedSteering& getBatchedSteering();
+
 	GroupMgr& getGroupMgr();
 
 	const GroupMgr& getGroupMgr() const;
@@ -334,6 +347,18 @@ inline const std::string& Zone::getName() const {
 	return _name;
 }
 
+inline void Zone::setBatchedMovement(bool batchedMovement) {
+	_batchedMovement = batchedMovement;
+}
+
+inline bool Zone::isBatchedMovement() const {
+	return _batchedMovement;
+}
+
+inline movement::BatchedSteering& Zone::getBatchedSteering() {
+	return _batchedSteering;
+}
+
 inline GroupMgr& Zone::getGroupMgr() {
 	return _groupManager;
 }
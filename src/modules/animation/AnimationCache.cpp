@@ -7,17 +7,10 @@
 namespace animation {
 
 bool AnimationCache::load(const std::string& filename, size_t meshIndex, const voxel::Mesh* (&meshes)[AnimationSettings::MAX_ENTRIES]) {
-	voxel::Mesh& mesh = cacheEntry(filename.c_str());
-	if (mesh.getNoOfVertices() > 0) {
-		meshes[meshIndex] = &mesh;
-		return true;
-	}
-	if (loadMesh(filename.c_str(), mesh)) {
-		meshes[meshIndex] = &mesh;
-		return true;
-	}
-	meshes[meshIndex] = nullptr;
-	return false;
+	const voxelformat::MeshPtr& mesh = this->mesh(filename.c_str());
+	// the cache keeps the mesh alive - there is no memory budget that could evict it
+	meshes[meshIndex] = mesh.get();
+	return mesh != nullptr;
 }
 
 bool AnimationCache::getMeshes(const AnimationSettings& settings, const voxel::Mesh* (&meshes)[AnimationSettings::MAX_ENTRIES],
@@ -46,11 +39,9 @@ bool AnimationCache::getMeshes(const AnimationSettings& settings, const voxel::M
 }
 
 bool AnimationCache::getModel(const AnimationSettings& settings, const char *fullPath, BoneId boneId, Vertices& vertices, Indices& indices) {
-	voxel::Mesh& mesh = cacheEntry(fullPath);
-	if (mesh.getNoOfVertices() <= 0) {
-		if (!loadMesh(fullPath, mesh)) {
-			return false;
-		}
+	const voxelformat::MeshPtr& mesh = this->mesh(fullPath);
+	if (!mesh) {
+		return false;
 	}
 
 	vertices.clear();
@@ -61,14 +52,14 @@ bool AnimationCache::getModel(const AnimationSettings& settings, const char *ful
 		Log::error("Could not get bone id mapping for %s", toBoneId(boneId));
 		return false;
 	}
-	vertices.reserve(mesh.getNoOfVertices());
-	for (const voxel::VoxelVertex& v : mesh.getVertexVector()) {
+	vertices.reserve(mesh->getNoOfVertices());
+	for (const voxel::VoxelVertex& v : mesh->getVertexVector()) {
 		vertices.emplace_back(Vertex{v.position, v.colorIndex, (uint8_t)boneIdx, v.ambientOcclusion});
 	}
 	//vertices.resize(mesh.getNoOfVertices());
 
-	indices.reserve(mesh.getNoOfIndices());
-	for (voxel::IndexType idx : mesh.getIndexVector()) {
+	indices.reserve(mesh->getNoOfIndices());
+	for (voxel::IndexType idx : mesh->getIndexVector()) {
 		indices.push_back((IndexType)idx);
 	}
 	//indices.resize(mesh.getNoOfIndices());
@@ -37,16 +37,11 @@ bool Character::loadGlider(const AnimationCachePtr& cache, const AnimationSettin
 	}
 	// TODO: model via inventory
 	const char *fullPath = "models/glider.vox";
-	voxel::Mesh& mesh = cache->cacheEntry(fullPath);
-	if (mesh.getNoOfVertices() > 0) {
-		meshes[idx] = &mesh;
+	const voxelformat::MeshPtr& mesh = cache->mesh(fullPath);
+	meshes[idx] = mesh.get();
+	if (mesh) {
 		return true;
 	}
-	if (cache->loadMesh(fullPath, mesh)) {
-		meshes[idx] = &mesh;
-		return true;
-	}
-	meshes[idx] = nullptr;
 	Log::error("Failed to load glider");
 	return false;
 }
@@ -83,26 +78,26 @@ bool Character::updateTool(const AnimationCachePtr& cache, const stock::Stock& s
 
 	// TODO: pick the biggest
 	const auto& citem = items[0];
-	const stock::ItemId id = citem.item->id();
+	const stock::ItemId id = citem.data->id();
 	if (id == _toolId) {
 		return true;
 	}
 
 	_toolId = id;
-	_toolAnim = toToolAnimationEnum(citem.item->label("anim"));
+	_toolAnim = toToolAnimationEnum(citem.data->label("anim"));
 	if (_toolAnim == ToolAnimationType::Max) {
-		Log::warn("Invalid label 'anim' found on item '%s'", citem.item->name());
+		Log::warn("Invalid label 'anim' found on item '%s'", citem.data->name());
 		_toolAnim = ToolAnimationType::None;
 	}
 
-	const char *itemName = citem.item->name();
+	const char *itemName = citem.data->name();
 	char fullPath[128];
 	if (!core::string::formatBuf(fullPath, sizeof(fullPath), "models/items/%s.vox", itemName)) {
 		Log::error("Failed to initialize the item path buffer. Can't load item %s.", itemName);
 		return false;
 	}
 	if (!cache->getModel(_settings, fullPath, BoneId::Tool, _toolVertices, _toolIndices)) {
-		Log::warn("Could not get item model for %s", citem.item->name());
+		Log::warn("Could not get item model for %s", citem.data->name());
 		return false;
 	}
 
@@ -4,103 +4,160 @@
 
 #include "Attributes.h"
 #include "core/Common.h"
-#include "core/collection/Set.h"
-#include <unordered_set>
+#include <math.h>
 
 namespace attrib {
 
 Attributes::Attributes(Attributes* parent) :
-		_dirty(false), _lock("Attributes"), _attribLock("Attributes2"), _parent(parent) {
+		_lock("Attributes"), _attribLock("Attributes2"), _parent(parent) {
+}
+
+bool Attributes::needsUpdate() const {
+	if (dirty()) {
+		return true;
+	}
+	if (_parent == nullptr) {
+		return false;
+	}
+	return _parent->needsUpdate() || _parent->_revision.load(std::memory_order_acquire) != _parentRevision;
+}
+
+int Attributes::update(Attributes* const* attributes, size_t amount, long dt) {
+	int updated = 0;
+	for (size_t i = 0; i < amount; ++i) {
+		Attributes* attribs = attributes[i];
+		if (!attribs->needsUpdate()) {
+			continue;
+		}
+		if (attribs->update(dt)) {
+			++updated;
+		}
+	}
+	return updated;
 }
 
 bool Attributes::update(long dt) {
 	bool updated = false;
 	if (_parent != nullptr) {
 		updated = _parent->update(dt);
-		if (updated) {
-			_dirty = true;
+		const uint32_t parentRevision = _parent->_revision.load(std::memory_order_acquire);
+		if (parentRevision != _parentRevision) {
+			_parentRevision = parentRevision;
+			// the parent might contribute to any type
+			_dirtyTypes.fetch_or(AllTypes);
+			updated = true;
 		}
 	}
-	if (!_dirty.exchange(false)) {
+	const TypeMask dirtyTypes = _dirtyTypes.exchange(0u);
+	if (dirtyTypes == 0u) {
 		return updated;
 	}
 
-	Values max;
-	Values percentages;
-	calculateMax(max, percentages);
+	TypeValues absolutes {};
+	TypeValues percentages {};
+	const TypeMask types = calculateMax(absolutes, percentages);
 
-	for (const auto& p : percentages) {
-		max[p.first] *= 1.0 + (p.second * 0.01);
-	}
-
-	core::ScopedReadLock scopedLock(_attribLock);
-	if (!_listeners.empty()) {
-		const TypeSet& diff = core::mapFindChangedValues(_max, max);
-		for (const auto& listener : _listeners) {
-			for (const Type& e : diff) {
-				listener(DirtyValue{e, false, max[e]});
+	DirtyValue changes[TypeCount];
+	int changeCount = 0;
+	{
+		core::ScopedWriteLock scopedLock(_attribLock);
+		for (int i = 0; i < TypeCount; ++i) {
+			const TypeMask bit = (TypeMask)1u << i;
+			if ((dirtyTypes & bit) == 0u) {
+				continue;
+			}
+			const bool hasMax = (types & bit) != 0u;
+			const double max = hasMax ? absolutes[i] * (1.0 + (percentages[i] * 0.01)) : 0.0;
+			const bool hadMax = (_maxTypes & bit) != 0u;
+			if (hadMax != hasMax || fabs(max - _max[i]) > 0.000001) {
+				changes[changeCount++] = DirtyValue{static_cast<Type>(i), false, max};
 			}
+			_max[i] = max;
+			if (!hasMax) {
+				_maxTypes &= ~bit;
+				continue;
+			}
+			_maxTypes |= bit;
+			// cap your currents to the max allowed value
+			_current[i] = core_min(max, _current[i]);
 		}
 	}
-	_max = max;
-
-	// cap your currents to the max allowed value
-	for (ValuesIter i = _current.begin(); i != _current.end(); ++i) {
-		ValuesIter mi = _max.find(i->first);
-		if (mi == _max.end()) {
-			continue;
+	for (const auto& listener : _listeners) {
+		for (int i = 0; i < changeCount; ++i) {
+			listener(changes[i]);
 		}
-		i->second = core_min(mi->second, i->second);
 	}
+	_revision.fetch_add(1u, std::memory_order_release);
 	return true;
 }
 
-void Attributes::calculateMax(Values& absolutes, Values& percentages) const {
+Attributes::TypeMask Attributes::calculateMax(TypeValues& absolutes, TypeValues& percentages) const {
+	TypeMask types = 0u;
 	if (_parent != nullptr) {
-		_parent->calculateMax(absolutes, percentages);
+		types = _parent->calculateMax(absolutes, percentages);
 	}
 
-	Containers containers;
-	{
-		core::ScopedReadLock scopedLock(_lock);
-		containers = _containers;
-	}
-	for (const auto& e : containers) {
-		const Container& c = e.second;
-		const double stackCount = c.stackCount();
-		const Values& abs = c.absolute();
-		for (ValuesConstIter i = abs.begin(); i != abs.end(); ++i) {
-			absolutes[i->first] += i->second * stackCount;
+	core::ScopedReadLock scopedLock(_lock);
+	for (int i = 0; i < TypeCount; ++i) {
+		if (_containerTypes[i] == 0u) {
+			continue;
+		}
+		absolutes[i] += _absolutes[i];
+		percentages[i] += _percentages[i];
+		types |= (TypeMask)1u << i;
+	}
+	return types;
+}
+
+void Attributes::applyContainer(const Container& container, int stackDelta, int typeDelta) {
+	TypeMask dirtyTypes = 0u;
+	TypeMask containerTypes = 0u;
+	const double factor = (double)stackDelta;
+	for (const auto& e : container.absolute()) {
+		const int i = static_cast<int>(e.first);
+		_absolutes[i] += e.second * factor;
+		containerTypes |= (TypeMask)1u << i;
+	}
+	for (const auto& e : container.percentage()) {
+		const int i = static_cast<int>(e.first);
+		_percentages[i] += e.second * factor;
+		containerTypes |= (TypeMask)1u << i;
+	}
+	for (int i = 0; i < TypeCount; ++i) {
+		const TypeMask bit = (TypeMask)1u << i;
+		if ((containerTypes & bit) == 0u) {
+			continue;
 		}
-		const Values& rel = c.percentage();
-		for (ValuesConstIter i = rel.begin(); i != rel.end(); ++i) {
-			percentages[i->first] += i->second * stackCount;
+		dirtyTypes |= bit;
+		_containerTypes[i] += typeDelta;
+		if (_containerTypes[i] == 0u) {
+			// prevent that rounding errors of the incremental updates survive the last container
+			_absolutes[i] = 0.0;
+			_percentages[i] = 0.0;
 		}
 	}
+	_dirtyTypes.fetch_or(dirtyTypes);
 }
 
-void Attributes::add(const Container& container) {
-	core::ScopedWriteLock scopedLock(_lock);
+void Attributes::addContainer(const Container& container) {
 	const auto& i = _containers.insert(std::make_pair(container.name(), container));
 	if (i.second) {
-		_dirty = true;
+		applyContainer(i.first->second, i.first->second.stackCount(), 1);
 		return;
 	}
 	if (i.first->second.increaseStackCount()) {
-		_dirty = true;
+		applyContainer(i.first->second, 1, 0);
 	}
 }
 
+void Attributes::add(const Container& container) {
+	core::ScopedWriteLock scopedLock(_lock);
+	addContainer(container);
+}
+
 void Attributes::add(Container&& container) {
 	core::ScopedWriteLock scopedLock(_lock);
-	const auto& i = _containers.insert(std::make_pair(container.name(), container));
-	if (i.second) {
-		_dirty = true;
-		return;
-	}
-	if (i.first->second.increaseStackCount()) {
-		_dirty = true;
-	}
+	addContainer(container);
 }
 
 void Attributes::add(const ContainerPtr& container) {
@@ -109,14 +166,7 @@ void Attributes::add(const ContainerPtr& container) {
 	}
 	core::ScopedWriteLock scopedLock(_lock);
 	_containerPtrs.insert(std::make_pair(container->name(), container));
-	const auto& i = _containers.insert(std::make_pair(container->name(), *container.get()));
-	if (i.second) {
-		_dirty = true;
-		return;
-	}
-	if (i.first->second.increaseStackCount()) {
-		_dirty = true;
-	}
+	addContainer(*container.get());
 }
 
 void Attributes::remove(const Container& container) {
@@ -138,42 +188,57 @@ void Attributes::remove(const std::string& name) {
 		return;
 	}
 	if (i->second.decreaseStackCount()) {
-		_dirty = true;
+		applyContainer(i->second, -1, 0);
 		return;
 	}
-	const auto& erased = _containers.erase(i);
-	if (erased != _containers.end()) {
-		_dirty = true;
-	}
+	applyContainer(i->second, -i->second.stackCount(), -1);
+	_containers.erase(i);
 }
 
 double Attributes::setCurrent(Type type, double value) {
-	core::ScopedWriteLock scopedLock(_attribLock);
-	auto i = _max.find(type);
-	if (i == _max.end()) {
-		_current[type] = value;
-		for (const auto& listener : _listeners) {
-			listener(DirtyValue{type, true, value});
+	const int i = static_cast<int>(type);
+	const TypeMask bit = typeBit(type);
+	double current = value;
+	{
+		core::ScopedWriteLock scopedLock(_attribLock);
+		if ((_maxTypes & bit) != 0u) {
+			current = core_min(_max[i], value);
 		}
-		return value;
+		_current[i] = current;
+		_currentTypes |= bit;
 	}
-	const double max = core_min(i->second, value);
-	_current[type] = max;
 	for (const auto& listener : _listeners) {
-		listener(DirtyValue{type, true, max});
+		listener(DirtyValue{type, true, current});
 	}
-	return max;
+	return current;
 }
 
 void Attributes::markAsDirty() {
-	for (ValuesIter i = _current.begin(); i != _current.end(); ++i) {
+	TypeValues current;
+	TypeValues max;
+	TypeMask currentTypes;
+	TypeMask maxTypes;
+	{
+		core::ScopedReadLock scopedLock(_attribLock);
+		current = _current;
+		max = _max;
+		currentTypes = _currentTypes;
+		maxTypes = _maxTypes;
+	}
+	for (int i = 0; i < TypeCount; ++i) {
+		if ((currentTypes & ((TypeMask)1u << i)) == 0u) {
+			continue;
+		}
 		for (const auto& listener : _listeners) {
-			listener(DirtyValue{i->first, true, i->second});
+			listener(DirtyValue{static_cast<Type>(i), true, current[i]});
 		}
 	}
-	for (ValuesIter i = _max.begin(); i != _max.end(); ++i) {
+	for (int i = 0; i < TypeCount; ++i) {
+		if ((maxTypes & ((TypeMask)1u << i)) == 0u) {
+			continue;
+		}
 		for (const auto& listener : _listeners) {
-			listener(DirtyValue{i->first, false, i->second});
+			listener(DirtyValue{static_cast<Type>(i), false, max[i]});
 		}
 	}
 }
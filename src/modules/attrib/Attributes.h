@@ -6,8 +6,11 @@
 
 #include "Container.h"
 #include "core/ReadWriteLock.h"
-#include <queue>
+#include <array>
+#include <atomic>
 #include <functional>
+#include <vector>
+#include <stdint.h>
 
 #undef max
 
@@ -66,20 +69,64 @@ namespace attrib {
  * @sa ShadowAttributes
  */
 class Attributes {
+public:
+	static constexpr int TypeCount = static_cast<int>(Type::MAX) + 1;
+	static_assert(TypeCount <= 32, "The type masks don't fit into 32 bits");
+	/**
+	 * @brief One value per @c attrib::Type - indexed by the type
+	 */
+	typedef std::array<double, TypeCount> TypeValues;
+	/**
+	 * @brief Bit mask with one bit per @c attrib::Type
+	 */
+	typedef uint32_t TypeMask;
+	static constexpr TypeMask AllTypes = (TypeMask)((1ull << TypeCount) - 1ull);
+
+	static constexpr inline TypeMask typeBit(Type type) {
+		return (TypeMask)1u << static_cast<int>(type);
+	}
+
 protected:
-	std::atomic_bool _dirty;
-	Values _current;
-	Values _max;
+	// the types that need a recalculation of their max value in the next update() call
+	std::atomic<TypeMask> _dirtyTypes { 0u };
+	// increased whenever the max values were recalculated - used to detect updates of the parent
+	std::atomic_uint32_t _revision { 0u };
+	uint32_t _parentRevision = 0u;
+
+	// protected by _attribLock
+	TypeValues _current {};
+	TypeValues _max {};
+	TypeMask _currentTypes = 0u;
+	TypeMask _maxTypes = 0u;
+
+	// protected by _lock - the sums of the own containers are maintained when containers are added or removed
 	Containers _containers;
 	// keep them here for ref counting
 	std::unordered_map<std::string, ContainerPtr> _containerPtrs;
+	TypeValues _absolutes {};
+	TypeValues _percentages {};
+	// the amount of containers that provide a value for a type
+	std::array<uint16_t, TypeCount> _containerTypes {};
+
 	core::ReadWriteLock _lock;
 	core::ReadWriteLock _attribLock;
 	Attributes* _parent;
 	std::string _name = "unnamed";
 	std::vector<std::function<void(const DirtyValue&)> > _listeners;
 
-	void calculateMax(Values& absolutes, Values& percentages) const;
+	/**
+	 * @brief Adds the values of the own and the parent containers
+	 * @return The types that have any container values assigned
+	 */
+	TypeMask calculateMax(TypeValues& absolutes, TypeValues& percentages) const;
+
+	/**
+	 * @brief Applies the values of the given container @c stackDelta times to the sums
+	 * @param[in] typeDelta @c 1 if the container was added, @c -1 if it was removed, @c 0 if only the stack count changed
+	 */
+	void applyContainer(const Container& container, int stackDelta, int typeDelta);
+	void addContainer(const Container& container);
+	bool needsUpdate() const;
 
 public:
 	/**
@@ -108,6 +155,11 @@ public:
 
 	void markAsDirty();
 
+	/**
+	 * @return @c true if the max values must be recalculated in the next @c update() call
+	 */
+	bool dirty() const;
+
 	/**
 	 * @brief Adds a new listener that will get notified whenever a @c attrib::Type value has changed.
 	 * @param f The functor, lambda or method object. It has to accept @c attrib::DirtyValue.
@@ -126,6 +178,12 @@ public:
 	 */
 	bool update(long dt);
 
+	/**
+	 * @brief Updates all given instances - the clean ones are skipped without touching their locks
+	 * @return The amount of instances that were updated
+	 */
+	static int update(Attributes* const* attributes, size_t amount, long dt);
+
 	/**
 	 * @note Locks the object (container)
 	 */
@@ -178,20 +236,16 @@ public:
 
 inline double Attributes::current(Type type) const {
 	core::ScopedReadLock scopedLock(_attribLock);
-	auto i = _current.find(type);
-	if (i == _current.end()) {
-		return 0.0;
-	}
-	return i->second;
+	return _current[static_cast<int>(type)];
 }
 
 inline double Attributes::max(Type type) const {
 	core::ScopedReadLock scopedLock(_attribLock);
-	auto i = _max.find(type);
-	if (i == _max.end()) {
-		return 0.0;
-	}
-	return i->second;
+	return _max[static_cast<int>(type)];
+}
+
+inline bool Attributes::dirty() const {
+	return _dirtyTypes.load(std::memory_order_relaxed) != 0u;
 }
 
 inline void Attributes::setName(const std::string& name) {
@@ -0,0 +1,73 @@
+/**
+ * @file
+ */
+
+#include "core/benchmark/AbstractBenchmark.h"
+#include "attrib/Attributes.h"
+#include <memory>
+#include <vector>
+
+class AttributesBenchmark: public core::AbstractBenchmark {
+protected:
+	std::vector<std::unique_ptr<attrib::Attributes>> _attributes;
+	std::vector<attrib::Attributes*> _batch;
+
+	void create(int amount) {
+		attrib::ContainerBuilder base("base");
+		base.addAbsolute(attrib::Type::HEALTH, 100.0).addAbsolute(attrib::Type::SPEED, 10.0).addAbsolute(attrib::Type::STRENGTH, 5.0);
+		const attrib::Container& baseContainer = base.create();
+		_attributes.clear();
+		_batch.clear();
+		for (int i = 0; i < amount; ++i) {
+			std::unique_ptr<attrib::Attributes> attribs(new attrib::Attributes());
+			attribs->addListener([] (const attrib::DirtyValue&) {});
+			attribs->add(baseContainer);
+			attribs->update(0L);
+			attribs->setCurrent(attrib::Type::HEALTH, 100.0);
+			_batch.push_back(attribs.get());
+			_attributes.push_back(std::move(attribs));
+		}
+	}
+};
+
+BENCHMARK_DEFINE_F(AttributesBenchmark, UpdateClean) (benchmark::State& state) {
+	create(state.range(0));
+	for (auto _ : state) {
+		for (attrib::Attributes* attribs : _batch) {
+			attribs->update(1L);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_DEFINE_F(AttributesBenchmark, UpdateCleanBatched) (benchmark::State& state) {
+	create(state.range(0));
+	for (auto _ : state) {
+		attrib::Attributes::update(_batch.data(), _batch.size(), 1L);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_DEFINE_F(AttributesBenchmark, AddRemoveContainer) (benchmark::State& state) {
+	create(state.range(0));
+	attrib::ContainerBuilder buff("buff");
+	buff.addPercentage(attrib::Type::HEALTH, 10.0).addAbsolute(attrib::Type::SPEED, 1.0);
+	const attrib::Container& buffContainer = buff.create();
+	for (auto _ : state) {
+		for (attrib::Attributes* attribs : _batch) {
+			attribs->add(buffContainer);
+		}
+		attrib::Attributes::update(_batch.data(), _batch.size(), 1L);
+		for (attrib::Attributes* attribs : _batch) {
+			attribs->remove(buffContainer);
+		}
+		attrib::Attributes::update(_batch.data(), _batch.size(), 1L);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_REGISTER_F(AttributesBenchmark, UpdateClean)->Arg(10000);
+BENCHMARK_REGISTER_F(AttributesBenchmark, UpdateCleanBatched)->Arg(10000);
+BENCHMARK_REGISTER_F(AttributesBenchmark, AddRemoveContainer)->Arg(10000);
+
+BENCHMARK_MAIN();
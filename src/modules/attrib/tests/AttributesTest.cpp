@@ -4,6 +4,7 @@
 
 #include "core/tests/AbstractTest.h"
 #include "attrib/Attributes.h"
+#include "core/ArrayLength.h"
 
 namespace attrib {
 
@@ -155,4 +156,89 @@ TEST_F(AttributesTest, testListeners) {
 	ASSERT_EQ(changes[static_cast<int>(Type::SPEED)], 1);
 }
 
+TEST_F(AttributesTest, testRemoveLastContainer) {
+	Attributes attributes;
+	ContainerBuilder test1("test1");
+	test1.addAbsolute(Type::HEALTH, 10).addAbsolute(Type::SPEED, 2);
+	attributes.add(test1.create());
+	ASSERT_TRUE(attributes.update(1L));
+	ASSERT_EQ(10, attributes.max(Type::HEALTH));
+
+	int changes[static_cast<int>(Type::MAX) + 1];
+	SDL_zero(changes);
+	attributes.addListener([&] (const DirtyValue& v) {
+		if (!v.current) {
+			++changes[static_cast<int>(v.type)];
+		}
+	});
+
+	// the first remove only decreases the stack count
+	attributes.remove(test1.create());
+	ASSERT_TRUE(attributes.update(1L));
+	ASSERT_EQ(0, attributes.max(Type::HEALTH));
+	attributes.remove(test1.create());
+	ASSERT_TRUE(attributes.update(1L));
+	ASSERT_EQ(0, attributes.max(Type::HEALTH));
+	ASSERT_EQ(2, changes[static_cast<int>(Type::HEALTH)]);
+	ASSERT_EQ(2, changes[static_cast<int>(Type::SPEED)]);
+	ASSERT_EQ(0, changes[static_cast<int>(Type::STRENGTH)]);
+
+	// without a max value, the current isn't capped anymore
+	ASSERT_EQ(100, attributes.setCurrent(Type::HEALTH, 100));
+}
+
+TEST_F(AttributesTest, testOnlyChangedTypesAreNotified) {
+	Attributes attributes;
+	ContainerBuilder test1("test1");
+	test1.addAbsolute(Type::HEALTH, 10).addAbsolute(Type::SPEED, 2);
+	attributes.add(test1.create());
+	ASSERT_TRUE(attributes.update(1L));
+
+	int changes[static_cast<int>(Type::MAX) + 1];
+	SDL_zero(changes);
+	attributes.addListener([&] (const DirtyValue& v) {
+		++changes[static_cast<int>(v.type)];
+	});
+	ContainerBuilder test2("test2");
+	test2.addPercentage(Type::SPEED, 50.0);
+	attributes.add(test2.create());
+	ASSERT_TRUE(attributes.update(1L));
+	ASSERT_EQ(3, attributes.max(Type::SPEED));
+	ASSERT_EQ(10, attributes.max(Type::HEALTH));
+	ASSERT_EQ(1, changes[static_cast<int>(Type::SPEED)]);
+	ASSERT_EQ(0, changes[static_cast<int>(Type::HEALTH)]);
+}
+
+TEST_F(AttributesTest, testParentUpdatedBefore) {
+	Attributes parent;
+	Attributes attributes(&parent);
+	ContainerBuilder test1("test1");
+	test1.addAbsolute(Type::HEALTH, 1);
+	parent.add(test1.create());
+	ASSERT_TRUE(parent.update(1L));
+	ASSERT_TRUE(attributes.update(1L)) << "The parent was updated by someone else, but the child must still be updated";
+	ASSERT_EQ(1, attributes.max(Type::HEALTH));
+	ASSERT_FALSE(attributes.update(1L));
+}
+
+TEST_F(AttributesTest, testBatchUpdate) {
+	Attributes parent;
+	Attributes child1(&parent);
+	Attributes child2;
+	Attributes child3;
+	Attributes* batch[] = { &parent, &child1, &child2, &child3 };
+
+	ContainerBuilder test1("test1");
+	test1.addAbsolute(Type::HEALTH, 1);
+	parent.add(test1.create());
+	child2.add(test1.create());
+	ASSERT_TRUE(parent.dirty());
+	ASSERT_FALSE(child3.dirty());
+	ASSERT_EQ(3, Attributes::update(batch, lengthof(batch), 1L));
+	ASSERT_EQ(1, child1.max(Type::HEALTH));
+	ASSERT_EQ(1, child2.max(Type::HEALTH));
+	ASSERT_EQ(0, child3.max(Type::HEALTH));
+	ASSERT_EQ(0, Attributes::update(batch, lengthof(batch), 1L));
+}
+
 }
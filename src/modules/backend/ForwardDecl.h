@@ -11,6 +11,11 @@ typedef std::shared_ptr<WorldMgr> WorldMgrPtr;
 class WorldPager;
 typedef std::shared_ptr<WorldPager> WorldPagerPtr;
 
+class PathService;
+
+struct PathRequest;
+typedef std::shared_ptr<PathRequest> PathRequestPtr;
+
 }
 
 namespace voxelformat {
@@ -123,6 +128,9 @@ namespace core {
 class TimeProvider;
 typedef std::shared_ptr<TimeProvider> TimeProviderPtr;
 
+class TimerWheel;
+typedef std::shared_ptr<TimerWheel> TimerWheelPtr;
+
 class EventBus;
 typedef std::shared_ptr<EventBus> EventBusPtr;
 
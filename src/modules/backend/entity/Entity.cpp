@@ -55,15 +55,27 @@ bool Entity::attack(EntityId victimId) {
 	return map()->attackMgr().startAttack(id(), victimId);
 }
 
-void Entity::sendToVisible(flatbuffers::FlatBufferBuilder& fbb, network::ServerMsgType type,
+network::SendHint Entity::sendHint(network::ServerMsgType type, const Entity& receiver) const {
+	const network::SendHint& hint = network::sendHint(type, id());
+	if (&receiver == this) {
+		return hint;
+	}
+	const float distance = glm::distance(pos(), receiver.pos());
+	return network::relevance(hint, distance, aggroTarget() == receiver.id());
+}
+
+void Entity::sendToVisible(network::PacketBuilder& fbb, network::ServerMsgType type,
 		flatbuffers::Offset<void> data, bool sendToSelf, uint32_t flags) const {
 	const EntitySet& visible = visibleCopy();
 	std::vector<ENetPeer*> peers;
+	std::vector<network::SendHint> hints;
 	peers.reserve(visible.size() + 1);
+	hints.reserve(visible.size() + 1);
 	if (sendToSelf) {
 		ENetPeer* p = peer();
 		if (p != nullptr) {
 			peers.push_back(p);
+			hints.push_back(sendHint(type, *this));
 		}
 	}
 	for (const EntityPtr& e : visible) {
@@ -72,11 +84,13 @@ void Entity::sendToVisible(flatbuffers::FlatBufferBuilder& fbb, network::ServerM
 			continue;
 		}
 		peers.push_back(peer);
+		hints.push_back(sendHint(type, *e));
 	}
 	if (peers.empty()) {
+		fbb.Clear();
 		return;
 	}
-	_messageSender->sendServerMessage(&peers[0], peers.size(), fbb, type, data, flags);
+	_messageSender->sendServerMessage(&peers[0], &hints[0], peers.size(), fbb, type, data, flags);
 }
 
 void Entity::init() {
@@ -185,7 +199,8 @@ void Entity::sendEntityUpdate(const EntityPtr& entity) const {
 	const glm::vec3& _pos = entity->pos();
 	const network::Vec3 pos { _pos.x, _pos.y, _pos.z };
 	_entityUpdateFBB.Clear();
-	_messageSender->sendServerMessage(_peer, _entityUpdateFBB, network::ServerMsgType::EntityUpdate,
+	const network::SendHint& hint = entity->sendHint(network::ServerMsgType::EntityUpdate, *this);
+	_messageSender->sendServerMessage(_peer, hint, _entityUpdateFBB, network::ServerMsgType::EntityUpdate,
 			network::CreateEntityUpdate(_entityUpdateFBB, entity->id(), &pos, entity->orientation(), entity->animation()).Union());
 }
 
@@ -207,7 +222,9 @@ void Entity::sendEntityRemove(const EntityPtr& entity) const {
 		return;
 	}
 	_entityRemoveFBB.Clear();
-	_messageSender->sendServerMessage(_peer, _entityRemoveFBB, network::ServerMsgType::EntityRemove,
+	// drops the queued updates of the removed entity
+	const network::SendHint& hint = network::sendHint(network::ServerMsgType::EntityRemove, entity->id());
+	_messageSender->sendServerMessage(_peer, hint, _entityRemoveFBB, network::ServerMsgType::EntityRemove,
 			network::CreateEntityRemove(_entityRemoveFBB, entity->id()).Union());
 }
 
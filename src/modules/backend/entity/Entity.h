@@ -12,6 +12,8 @@
 #include "backend/ForwardDecl.h"
 #include "ServerMessages_generated.h"
 #include "network/IProtocolHandler.h"
+#include "network/PacketPool.h"
+#include "network/SendScheduler.h"
 
 #include <unordered_set>
 #include <memory>
@@ -33,10 +35,10 @@ private:
 	core::ReadWriteLock _visibleLock {"Entity"};
 	EntitySet _visible;
 	// they are stored as members to reduce memory allocations
-	mutable flatbuffers::FlatBufferBuilder _attribUpdateFBB;
-	mutable flatbuffers::FlatBufferBuilder _entityUpdateFBB;
-	mutable flatbuffers::FlatBufferBuilder _entitySpawnFBB;
-	mutable flatbuffers::FlatBufferBuilder _entityRemoveFBB;
+	mutable network::PacketBuilder _attribUpdateFBB;
+	mutable network::PacketBuilder _entityUpdateFBB;
+	mutable network::PacketBuilder _entitySpawnFBB;
+	mutable network::PacketBuilder _entityRemoveFBB;
 
 protected:
 	// network stuff
@@ -96,6 +98,10 @@ public:
 	bool dead() const;
 
 	bool attack(EntityId id);
+	/**
+	 * @return The id of the entity this entity has the highest aggro on or @c -1
+	 */
+	virtual EntityId aggroTarget() const;
 
 	ENetPeer* peer() const;
 
@@ -124,6 +130,8 @@ public:
 
 	double max(attrib::Type type) const;
 
+	attrib::Attributes& attribs();
+
 	int visibleCount() const;
 
 	/**
@@ -200,7 +208,13 @@ public:
 
 	const char* type() const;
 
-	void sendToVisible(flatbuffers::FlatBufferBuilder& fbb, network::ServerMsgType type,
+	/**
+	 * @brief The priority of a message about this entity for the given receiver. The priority depends on the
+	 * distance and whether this entity is attacking the receiver.
+	 */
+	network::SendHint sendHint(network::ServerMsgType type, const Entity& receiver) const;
+
+	void sendToVisible(network::PacketBuilder& fbb, network::ServerMsgType type,
 			flatbuffers::Offset<void> data, bool sendToSelf = false, uint32_t flags = ENET_PACKET_FLAG_RELIABLE) const;
 };
 
@@ -234,6 +248,14 @@ inline double Entity::max(attrib::Type type) const {
 	return _attribs.max(type);
 }
 
+inline attrib::Attributes& Entity::attribs() {
+	return _attribs;
+}
+
+inline EntityId Entity::aggroTarget() const {
+	return -1;
+}
+
 inline network::EntityType Entity::entityType() const {
 	return _entityType;
 }
@@ -2,14 +2,13 @@
  * @file
  */
 
-#if 0
-#include "voxelutil/AStarPathfinder.h"
-#endif
 #include "Npc.h"
 #include "ai/AICharacter.h"
 #include "ai/AI.h"
+#include "ai/common/Math.h"
 #include "ai/zone/Zone.h"
 #include "backend/world/Map.h"
+#include "voxelworld/PathService.h"
 
 namespace backend {
 
@@ -20,7 +19,7 @@ Npc::Npc(network::EntityType type, const ai::TreeNodePtr& behaviour,
 		const core::TimeProviderPtr& timeProvider, const attrib::ContainerProviderPtr& containerProvider,
 		const cooldown::CooldownProviderPtr& cooldownProvider) :
 		Super(_nextNpcId++, map, messageSender, timeProvider, containerProvider),
-		_cooldowns(timeProvider, cooldownProvider) {
+		_cooldowns(timeProvider, cooldownProvider, map->timerWheel()) {
 	_entityType = type;
 	_ai = std::make_shared<ai::AI>(behaviour);
 	_aiChr = std::make_shared<AICharacter>(_entityId, *this);
@@ -75,7 +74,9 @@ bool Npc::update(long dt) {
 	if (!Super::update(dt)) {
 		return false;
 	}
-	_cooldowns.update();
+	followRoute(dt);
+	const ai::EntryPtr entry = _ai->getAggroMgr().getHighestEntry();
+	_aggroTarget = entry != nullptr ? (EntityId)entry->getCharacterId() : -1;
 	const ai::ICharacterPtr& character = _ai->getCharacter();
 	character->setSpeed(current(attrib::Type::SPEED));
 	character->setOrientation(orientation());
@@ -83,19 +84,73 @@ bool Npc::update(long dt) {
 }
 
 bool Npc::route(const glm::ivec3& target) {
-#if 0
-	std::list<glm::ivec3> result;
-	const glm::vec3& pos = _aiChr->getPosition();
-	const glm::ivec3 start(pos);
-	const glm::ivec3 end(target.x, target.y, target.z);
-	if (!_map->findPath(start, end, result)) {
+	if (_routeTarget == target && (_pathRequest || _pathIndex < _path.size())) {
+		return true;
+	}
+	const glm::ivec3 start(_aiChr->getPosition());
+	_pathRequest = _map->findPath(start, target);
+	if (!_pathRequest) {
 		return false;
 	}
-	// TODO: use the route
-#endif
+	_routeTarget = target;
+	_path.clear();
+	_pathIndex = 0u;
 	return true;
 }
 
+void Npc::followRoute(long dt) {
+	if (_pathRequest) {
+		if (_pathRequest->pending()) {
+			return;
+		}
+		if (_pathRequest->found()) {
+			_path = std::move(_pathRequest->path);
+			_routeChunks = std::move(_pathRequest->chunks);
+			_routeGeneration = _pathRequest->generation;
+			// validate against the changes that happened since the search
+			_routeCheckedGeneration = _routeGeneration;
+		} else {
+			Log::debug("No route found for npc " PRIEntId " to %i:%i:%i", id(), _routeTarget.x, _routeTarget.y, _routeTarget.z);
+		}
+		_pathIndex = 0u;
+		_pathRequest = voxelworld::PathRequestPtr();
+	}
+	if (_pathIndex >= _path.size()) {
+		return;
+	}
+	const uint32_t navGeneration = _map->navGeneration();
+	if (_routeCheckedGeneration != navGeneration) {
+		_routeCheckedGeneration = navGeneration;
+		if (_map->routeInvalidated(_routeChunks, _routeGeneration)) {
+			// the terrain along the path was modified - the rest of the path might be blocked now
+			const glm::ivec3 target = _routeTarget;
+			_path.clear();
+			_pathIndex = 0u;
+			route(target);
+			return;
+		}
+	}
+	float distance = current(attrib::Type::SPEED) * (float)dt / 1000.0f;
+	glm::vec3 pos = _aiChr->getPosition();
+	while (distance > 0.0f && _pathIndex < _path.size()) {
+		const glm::vec3 waypoint(_path[_pathIndex]);
+		const glm::vec3& delta = waypoint - pos;
+		const float length = glm::length(delta);
+		if (length > 0.0f) {
+			setOrientation(ai::angle(delta));
+		}
+		if (length <= distance) {
+			pos = waypoint;
+			distance -= length;
+			++_pathIndex;
+			continue;
+		}
+		pos += delta * (distance / length);
+		break;
+	}
+	_aiChr->setPosition(pos);
+}
+
 void Npc::moveToGround() {
 	glm::vec3 pos = _aiChr->getPosition();
 	pos.y = _map->findFloor(pos);
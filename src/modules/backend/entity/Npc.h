@@ -12,6 +12,7 @@
 #include "backend/entity/EntityId.h"
 
 #include <atomic>
+#include <vector>
 
 namespace backend {
 
@@ -30,7 +31,21 @@ private:
 	// cooldowns
 	cooldown::CooldownMgr _cooldowns;
 
+	// the route that is currently followed - see route()
+	voxelworld::PathRequestPtr _pathRequest;
+	std::vector<glm::ivec3> _path;
+	size_t _pathIndex = 0u;
+	glm::ivec3 _routeTarget { 0 };
+	// the chunks the path leads through and the nav generation of the search
+	std::vector<glm::ivec3> _routeChunks;
+	uint32_t _routeGeneration = 0u;
+	// the nav generation of the map at the last validation of the route
+	uint32_t _routeCheckedGeneration = 0u;
+	// the entity with the highest aggro - refreshed in update() as the aggro manager isn't thread safe
+	std::atomic<EntityId> _aggroTarget { -1 };
+
 	void moveToGround();
+	void followRoute(long dt);
 
 	void init() override;
 
@@ -49,6 +64,13 @@ public:
 
 	void setHomePosition(const glm::ivec3& pos);
 	const glm::ivec3& homePosition() const;
+	/**
+	 * @brief Requests a path to the given target and moves the npc along it in @c update()
+	 * @return @c false if no path could get requested
+	 * @note The path is resolved asynchronously - requesting the same target again while
+	 * it's still pending or followed doesn't queue a new request. If the voxels of the map are
+	 * modified while the path is followed, a new path is requested.
+	 */
 	bool route(const glm::ivec3& target);
 	const ai::AIPtr& ai();
 
@@ -65,6 +87,11 @@ public:
 	 */
 	double applyDamage(Entity* attacker, double damage);
 
+	/**
+	 * @return The id of the entity with the highest aggro or @c -1 if the aggro decayed
+	 */
+	EntityId aggroTarget() const override;
+
 	bool update(long dt) override;
 };
 
@@ -80,6 +107,10 @@ inline const ai::AIPtr& Npc::ai() {
 	return _ai;
 }
 
+inline EntityId Npc::aggroTarget() const {
+	return _aggroTarget;
+}
+
 inline cooldown::CooldownMgr& Npc::cooldownMgr() {
 	return _cooldowns;
 }
@@ -27,9 +27,9 @@ User::User(ENetPeer* peer, EntityId id,
 		_timeProvider(timeProvider),
 		_cooldownProvider(cooldownProvider),
 		_stockMgr(this, stockDataProvider, dbHandler),
-		_cooldownMgr(this, timeProvider, cooldownProvider, dbHandler, persistenceMgr),
+		_cooldownMgr(this, timeProvider, cooldownProvider, map->timerWheel(), dbHandler, persistenceMgr),
 		_attribMgr(id, _attribs, dbHandler, persistenceMgr),
-		_logoutMgr(_cooldownMgr),
+		_logoutMgr(_cooldownMgr, timeProvider, map->timerWheel()),
 		_movementMgr(this) {
 	setPeer(peer);
 	_entityType = network::EntityType::PLAYER;
@@ -83,25 +83,23 @@ bool User::update(long dt) {
 	}
 
 	_stockMgr.update(dt);
-	_cooldownMgr.update();
 	_movementMgr.update(dt);
-	_logoutMgr.update(dt);
 
 	return true;
 }
 
 void User::sendSeed(long seed) const {
-	flatbuffers::FlatBufferBuilder fbb;
+	network::PacketBuilder fbb;
 	sendMessage(fbb, network::ServerMsgType::Seed, network::CreateSeed(fbb, seed).Union());
 }
 
 void User::sendUserSpawn() const {
-	flatbuffers::FlatBufferBuilder fbb;
+	network::PacketBuilder fbb;
 	const network::Vec3 pos { _pos.x, _pos.y, _pos.z };
 	sendToVisible(fbb, network::ServerMsgType::UserSpawn, network::CreateUserSpawn(fbb, id(), fbb.CreateString(_name), &pos).Union(), true);
 }
 
-void User::sendMessage(flatbuffers::FlatBufferBuilder& fbb, network::ServerMsgType type, flatbuffers::Offset<void> msg) const {
+void User::sendMessage(network::PacketBuilder& fbb, network::ServerMsgType type, flatbuffers::Offset<void> msg) const {
 	if (_peer == nullptr) {
 		return;
 	}
@@ -24,6 +24,7 @@ void UserAttribMgr::onAttribChange(const attrib::DirtyValue& v) {
 		return;
 	}
 	_dirtyAttributeTypes.insert(v);
+	markDirty();
 }
 
 bool UserAttribMgr::init() {
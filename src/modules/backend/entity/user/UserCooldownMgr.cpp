@@ -14,9 +14,10 @@ namespace backend {
 UserCooldownMgr::UserCooldownMgr(User* user,
 		const core::TimeProviderPtr& timeProvider,
 		const cooldown::CooldownProviderPtr& cooldownProvider,
+		const core::TimerWheelPtr& timerWheel,
 		const persistence::DBHandlerPtr& dbHandler,
 		const persistence::PersistenceMgrPtr& persistenceMgr) :
-		Super(timeProvider, cooldownProvider), _dbHandler(dbHandler),
+		Super(timeProvider, cooldownProvider, timerWheel), _dbHandler(dbHandler),
 		_persistenceMgr(persistenceMgr), _user(user) {
 }
 
@@ -28,7 +29,7 @@ bool UserCooldownMgr::init() {
 		const cooldown::CooldownPtr& cooldown = createCooldown(type, millis);
 		_cooldowns[type] = cooldown;
 		if (cooldown->running()) {
-			_queue.push(cooldown);
+			schedule(cooldown);
 		}
 	})) {
 		Log::warn("Could not load cooldowns for user " PRIEntId, _user->id());
@@ -49,6 +50,7 @@ void UserCooldownMgr::shutdown() {
 	const EntityId userId = _user->id();
 	Log::info("Shutdown cooldown manager for user " PRIEntId, userId);
 	_persistenceMgr->unregisterSavable(FOURCC, this);
+	Super::shutdown();
 }
 
 cooldown::CooldownTriggerState UserCooldownMgr::triggerCooldown(cooldown::Type type, cooldown::CooldownCallback callback) {
@@ -57,6 +59,7 @@ cooldown::CooldownTriggerState UserCooldownMgr::triggerCooldown(cooldown::Type t
 			callback(callbackType);
 		}
 		sendCooldown(type, callbackType == cooldown::CallbackType::Started);
+		markDirty();
 	});
 }
 
@@ -27,12 +27,13 @@ private:
 	persistence::DBHandlerPtr _dbHandler;
 	persistence::PersistenceMgrPtr _persistenceMgr;
 	User* _user;
-	mutable flatbuffers::FlatBufferBuilder _cooldownFBB;
+	mutable network::PacketBuilder _cooldownFBB;
 	std::vector<db::CooldownModel> _dirtyModels;
 public:
 	UserCooldownMgr(User* user,
 			const core::TimeProviderPtr& timeProvider,
 			const cooldown::CooldownProviderPtr& cooldownProvider,
+			const core::TimerWheelPtr& timerWheel,
 			const persistence::DBHandlerPtr& dbHandler,
 			const persistence::PersistenceMgrPtr& persistenceMgr);
 
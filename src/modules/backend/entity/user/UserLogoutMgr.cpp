@@ -9,8 +9,12 @@
 
 namespace backend {
 
-UserLogoutMgr::UserLogoutMgr(UserCooldownMgr& cooldownMgr) :
-		_cooldownMgr(cooldownMgr) {
+UserLogoutMgr::UserLogoutMgr(UserCooldownMgr& cooldownMgr, const core::TimeProviderPtr& timeProvider, const core::TimerWheelPtr& timerWheel) :
+		_cooldownMgr(cooldownMgr), _timeProvider(timeProvider), _timerWheel(timerWheel) {
+}
+
+UserLogoutMgr::~UserLogoutMgr() {
+	_timerWheel->cancel(_inactivityTimer);
 }
 
 void UserLogoutMgr::triggerLogout() {
@@ -22,24 +26,37 @@ void UserLogoutMgr::triggerLogout() {
 }
 
 void UserLogoutMgr::updateLastActionTime() {
-	_lastAction = _time;
+	_lastAction = _timeProvider->tickMillis();
 }
 
-void UserLogoutMgr::update(long dt) {
-	_time += dt;
+void UserLogoutMgr::scheduleInactivityTimer() {
+	_inactivityTimer = _timerWheel->add(_lastAction + _userTimeout->ulongVal(), onInactivityTimer, this);
+}
 
-	if (_time - _lastAction > _userTimeout->ulongVal()) {
-		triggerLogout();
+void UserLogoutMgr::onInactivityTimer(const core::TimerWheel::Timer* timers, size_t amount) {
+	for (size_t i = 0; i < amount; ++i) {
+		UserLogoutMgr* mgr = (UserLogoutMgr*)timers[i].target;
+		mgr->_inactivityTimer = core::TimerWheel::InvalidTimerId;
+		if (mgr->_timeProvider->tickMillis() - mgr->_lastAction >= mgr->_userTimeout->ulongVal()) {
+			mgr->triggerLogout();
+			continue;
+		}
+		// there was an action in the meantime
+		mgr->scheduleInactivityTimer();
 	}
 }
 
 bool UserLogoutMgr::init() {
 	_userTimeout = core::Var::getSafe(cfg::ServerUserTimeout);
+	updateLastActionTime();
+	scheduleInactivityTimer();
 	return true;
 }
 
 void UserLogoutMgr::shutdown() {
 	Log::info("Shutdown logout manager");
+	_timerWheel->cancel(_inactivityTimer);
+	_inactivityTimer = core::TimerWheel::InvalidTimerId;
 }
 
 }
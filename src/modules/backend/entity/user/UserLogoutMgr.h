@@ -6,24 +6,37 @@
 
 #include "core/Var.h"
 #include "core/IComponent.h"
+#include "core/TimerWheel.h"
+#include "core/TimeProvider.h"
 
 namespace backend {
 
 class UserCooldownMgr;
 
 /**
+ * @brief Triggers the logout cooldown on request or after the user was inactive for too long
+ *
+ * There is only one inactivity timer per user - a user action just records the time. Once the timer
+ * fires it either triggers the logout or is rearmed for the remaining time.
+ *
  * @see UserConnectHandler
  */
 class UserLogoutMgr : public core::IComponent {
 private:
 	UserCooldownMgr& _cooldownMgr;
+	core::TimeProviderPtr _timeProvider;
+	core::TimerWheelPtr _timerWheel;
+	core::TimerWheel::TimerId _inactivityTimer = core::TimerWheel::InvalidTimerId;
 	bool _disconnect = false;
 	uint64_t _lastAction = 0u;
-	uint64_t _time = 0u;
 	core::VarPtr _userTimeout;
 
+	void scheduleInactivityTimer();
+	static void onInactivityTimer(const core::TimerWheel::Timer* timers, size_t amount);
+
 public:
-	UserLogoutMgr(UserCooldownMgr& cooldownMgr);
+	UserLogoutMgr(UserCooldownMgr& cooldownMgr, const core::TimeProviderPtr& timeProvider, const core::TimerWheelPtr& timerWheel);
+	~UserLogoutMgr();
 
 	/**
 	 * @brief The client wants to disconnect - the user object itself will stay in the server until
@@ -37,7 +50,6 @@ public:
 	 */
 	void updateLastActionTime();
 
-	void update(long dt);
 	bool init() override;
 	void shutdown() override;
 };
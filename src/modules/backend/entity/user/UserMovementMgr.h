@@ -16,7 +16,7 @@ class UserMovementMgr : public core::IComponent {
 private:
 	shared::SharedMovement _movement;
 	User* _user;
-	flatbuffers::FlatBufferBuilder _entityUpdateFBB;
+	network::PacketBuilder _entityUpdateFBB;
 public:
 	UserMovementMgr(User* user);
 
@@ -22,13 +22,12 @@ bool UserStockMgr::init() {
 	_stock.init();
 	const EntityId userId = _user->id();
 	if (!_dbHandler->select(db::InventoryModel(), db::DBConditionInventoryModelUserid(userId), [this] (db::InventoryModel&& model) {
-		stock::Inventory& inventory = _stock.inventory();
-		const stock::ItemPtr& item = _stockDataProvider->createItem(model.itemid());
-		if (!item) {
+		const stock::Item& item = _stockDataProvider->createItem(model.itemid(), 1);
+		if (!item.isValid()) {
 			Log::warn("Could not get item for %i", model.itemid());
 			return;
 		}
-		inventory.add(model.containerid(), item, model.x(), model.y());
+		_stock.add(item, model.containerid(), model.x(), model.y());
 	})) {
 		Log::warn("Could not load inventory for user " PRIEntId, userId);
 	}
@@ -50,7 +49,7 @@ void UserStockMgr::shutdown() {
 			db::InventoryModel model;
 			model.setContainerid(i);
 			model.setUserid(userId);
-			model.setItemid(item.item->id());
+			model.setItemid(item.data->id());
 			model.setX(item.x);
 			model.setY(item.y);
 			_dbHandler->insert(model);
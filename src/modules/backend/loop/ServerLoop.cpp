@@ -25,8 +25,11 @@
 #include "backend/network/UserDisconnectHandler.h"
 #include "backend/network/AttackHandler.h"
 #include "backend/network/MoveHandler.h"
+#include "network/PacketPool.h"
 #include "persistence/PersistenceMgr.h"
 #include "backend/world/World.h"
+#include "backend/world/MapProvider.h"
+#include "backend/world/Map.h"
 #include "core/command/CommandHandler.h"
 #include "voxel/MaterialColor.h"
 #include "voxelformat/VolumeCache.h"
@@ -36,7 +39,7 @@
 
 namespace backend {
 
-ServerLoop::ServerLoop(const core::TimeProviderPtr& timeProvider, const MapProviderPtr& mapProvider,
+ServerLoop::ServerLoop(const core::TimeProviderPtr& timeProvider, const core::TimerWheelPtr& timerWheel, const MapProviderPtr& mapProvider,
 		const network::ServerMessageSenderPtr& messageSender,
 		const WorldPtr& world, const persistence::DBHandlerPtr& dbHandler,
 		const network::ServerNetworkPtr& network, const io::FilesystemPtr& filesystem,
@@ -46,12 +49,13 @@ ServerLoop::ServerLoop(const core::TimeProviderPtr& timeProvider, const MapProvi
 		const stock::StockDataProviderPtr& stockDataProvider, const MetricMgrPtr& metricMgr,
 		const persistence::PersistenceMgrPtr& persistenceMgr,
 		const voxelformat::VolumeCachePtr& volumeCache) :
-		_network(network), _timeProvider(timeProvider), _mapProvider(mapProvider), _messageSender(messageSender),
+		_network(network), _timeProvider(timeProvider), _timerWheel(timerWheel), _mapProvider(mapProvider), _messageSender(messageSender),
 		_world(world),
 		_entityStorage(entityStorage), _eventBus(eventBus), _attribContainerProvider(containerProvider),
 		_cooldownProvider(cooldownProvider), _eventMgr(eventMgr), _dbHandler(dbHandler),
 		_stockDataProvider(stockDataProvider), _metricMgr(metricMgr), _filesystem(filesystem),
-		_persistenceMgr(persistenceMgr), _volumeCache(volumeCache) {
+		_persistenceMgr(persistenceMgr), _volumeCache(volumeCache),
+		_tickProfiler("server loop", {"network", "loop", "timers", "events"}) {
 	_eventBus->subscribe<network::DisconnectEvent>(*this);
 }
 
@@ -72,6 +76,18 @@ void ServerLoop::signalCallback(uv_signal_t* handle, int signum) {
 		core::App::getInstance()->requestQuit();
 		return;
 	}
+
+#ifdef SIGUSR1
+	if (signum == SIGUSR1) {
+		core::TraceRecorder& recorder = core::App::getInstance()->traceRecorder();
+		if (recorder.capturing()) {
+			recorder.stop();
+		} else {
+			recorder.requestCapture(100);
+		}
+		return;
+	}
+#endif
 }
 
 void ServerLoop::onIdle(uv_idle_t* handle) {
@@ -90,6 +106,45 @@ void ServerLoop::onIdle(uv_idle_t* handle) {
 	if (lifetimeSeconds != loop->_lifetimeSeconds) {
 		metric->gauge("uptime", lifetimeSeconds);
 		loop->_lifetimeSeconds = lifetimeSeconds;
+		const network::ServerNetwork::Stats& stats = loop->_network->stats();
+		metric->gauge("network.inbound.depth", stats.inboundDepth);
+		metric->gauge("network.outbound.depth", stats.outboundDepth);
+		metric->gauge("network.applied", (uint32_t)stats.applied);
+		metric->gauge("network.latency.max", (uint32_t)stats.maxLatencyMicros);
+		metric->gauge("network.latency.avg", (uint32_t)stats.avgLatencyMicros);
+		metric->gauge("network.stalls.inbound", (uint32_t)stats.inboundStalls);
+		metric->gauge("network.stalls.outbound", (uint32_t)stats.outboundStalls);
+		metric->gauge("network.stale", (uint32_t)stats.stale);
+		const network::PacketPool::Stats& poolStats = network::PacketPool::get().stats();
+		metric->gauge("network.packetpool.misses", (uint32_t)poolStats.misses);
+		metric->gauge("network.packetpool.oversized", (uint32_t)poolStats.oversized);
+		metric->gauge("network.packetpool.dropped", (uint32_t)poolStats.dropped);
+		metric->gauge("network.scheduler.sent.bytes", (uint32_t)stats.sentBytes);
+		metric->gauge("network.scheduler.coalesced", (uint32_t)stats.coalesced);
+		metric->gauge("network.scheduler.dropped", (uint32_t)stats.dropped);
+		metric->gauge("network.scheduler.deferred", stats.deferred);
+		metric->gauge("network.scheduler.congested", stats.congestedPeers);
+		const core::TimerWheel::Stats& timerStats = loop->_timerWheel->stats();
+		metric->gauge("timers.active", (uint32_t)timerStats.active);
+		metric->gauge("timers.fired", (uint32_t)timerStats.fired);
+		metric->gauge("timers.canceled", (uint32_t)timerStats.canceled);
+		metric->gauge("timers.batches", (uint32_t)timerStats.batches);
+		for (const auto& e : loop->_persistenceMgr->stats()) {
+			uint8_t buf[4];
+			FourCCRev(buf, e.first);
+			const metric::TagMap tags {{"fourcc", std::string((const char*)buf, sizeof(buf))}};
+			metric->gauge("persistence.dirty", e.second.dirty, tags);
+			metric->gauge("persistence.rows", (uint32_t)e.second.rows, tags);
+			metric->gauge("persistence.flush", (uint32_t)e.second.flushMicros, tags);
+		}
+		loop->_tickProfiler.publish(*metric, {{"loop", "server"}});
+		for (const auto& e : loop->_mapProvider->worldMaps()) {
+			e.second->tickProfiler().publish(*metric, {{"map", e.second->idStr()}});
+		}
+		if (loop->_peerBudget && loop->_peerBudget->isDirty()) {
+			loop->_network->setSendBudget((uint32_t)loop->_peerBudget->intVal());
+			loop->_peerBudget->markClean();
+		}
 	}
 }
 
@@ -214,6 +269,7 @@ bool ServerLoop::init() {
 	uv_timer_init(_loop, &_persistenceMgrTimer);
 	uv_idle_init(_loop, &_idleTimer);
 	uv_signal_init(_loop, &_signal);
+	uv_signal_init(_loop, &_traceSignal);
 
 	if (!_metricMgr->init()) {
 		Log::warn("Failed to init metric sender");
@@ -317,6 +373,10 @@ bool ServerLoop::init() {
 	_signal.data = this;
 	uv_signal_start(&_signal, signalCallback, SIGHUP);
 	uv_signal_start(&_signal, signalCallback, SIGINT);
+#ifdef SIGUSR1
+	_traceSignal.data = this;
+	uv_signal_start(&_traceSignal, signalCallback, SIGUSR1);
+#endif
 
 	if (!_input.init(_loop)) {
 		Log::warn("Could not init console input");
@@ -331,11 +391,23 @@ bool ServerLoop::init() {
 	const core::VarPtr& port = core::Var::getSafe(cfg::ServerPort);
 	const core::VarPtr& host = core::Var::getSafe(cfg::ServerHost);
 	const core::VarPtr& maxclients = core::Var::getSafe(cfg::ServerMaxClients);
-	if (!_network->bind(port->intVal(), host->strVal(), maxclients->intVal(), 2)) {
+	const core::VarPtr& bandwidth = core::Var::getSafe(cfg::ServerBandwidth);
+	if (!_network->bind(port->intVal(), host->strVal(), maxclients->intVal(), std::enum_value(network::Channel::Max), (uint32_t)bandwidth->intVal())) {
 		Log::error("Failed to bind the server socket on %s:%i", host->strVal().c_str(), port->intVal());
 		return false;
 	}
 	Log::info("Server socket is up at %s:%i", host->strVal().c_str(), port->intVal());
+	_peerBudget = core::Var::getSafe(cfg::ServerPeerBudget);
+	_tickProfiler.setBudget(core::Var::getSafe(cfg::ServerTickBudget));
+	_network->setSendBudget((uint32_t)_peerBudget->intVal());
+	_peerBudget->markClean();
+	if (core::Var::getSafe(cfg::ServerNetworkThread)->boolVal()) {
+		if (!_network->start()) {
+			Log::error("Failed to start the network thread");
+			return false;
+		}
+		Log::info("Network is serviced on a dedicated thread");
+	}
 
 	return true;
 }
@@ -343,6 +415,7 @@ bool ServerLoop::init() {
 void ServerLoop::shutdown() {
 	_persistenceMgr->shutdown();
 	_world->shutdown();
+	_timerWheel->clear();
 	_dbHandler->shutdown();
 	_metricMgr->shutdown();
 	_volumeCache->shutdown();
@@ -350,6 +423,7 @@ void ServerLoop::shutdown() {
 	_network->shutdown();
 	if (_loop != nullptr) {
 		uv_signal_stop(&_signal);
+		uv_signal_stop(&_traceSignal);
 		uv_timer_stop(&_worldTimer);
 		uv_timer_stop(&_persistenceMgrTimer);
 		uv_idle_stop(&_idleTimer);
@@ -362,10 +436,20 @@ void ServerLoop::shutdown() {
 
 void ServerLoop::update(long dt) {
 	core_trace_scoped(ServerLoop);
+	_tickProfiler.begin();
+	// this is the point where the received messages are applied - the handlers
+	// run before the timers tick the world and their events are dispatched below
+	_network->update();
+	_tickProfiler.mark(PhaseNetwork);
 	// not everything is ticked in here directly, a lot is handled by libuv timers
 	uv_run(_loop, UV_RUN_NOWAIT);
-	_network->update();
+	_tickProfiler.mark(PhaseLoop);
+	// cooldowns, logouts, spawns and events
+	_timerWheel->update(_timeProvider->tickMillis());
+	_tickProfiler.mark(PhaseTimers);
 	const int eventSkip = _eventBus->update(200);
+	_tickProfiler.mark(PhaseEvents);
+	_tickProfiler.end();
 	if (eventSkip != _lastEventSkip) {
 		_metricMgr->metric()->gauge("events.skip", eventSkip);
 		_lastEventSkip = eventSkip;
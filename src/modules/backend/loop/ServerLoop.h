@@ -6,6 +6,8 @@
 
 #include "core/EventBus.h"
 #include "core/Trace.h"
+#include "core/TimerWheel.h"
+#include "core/Var.h"
 #include "core/Input.h"
 #include "core/EventBus.h"
 #include "core/IComponent.h"
@@ -13,6 +15,7 @@
 #include "network/NetworkEvents.h"
 #include "backend/ForwardDecl.h"
 #include "backend/world/World.h"
+#include "backend/metric/TickProfiler.h"
 #include "network/ProtocolHandlerRegistry.h"
 #include "backend/entity/EntityStorage.h"
 #include "persistence/DBHandler.h"
@@ -27,6 +30,7 @@ class ServerLoop:
 private:
 	network::ServerNetworkPtr _network;
 	core::TimeProviderPtr _timeProvider;
+	core::TimerWheelPtr _timerWheel;
 	MapProviderPtr _mapProvider;
 	network::ServerMessageSenderPtr _messageSender;
 	WorldPtr _world;
@@ -48,16 +52,23 @@ private:
 	uv_timer_t _persistenceMgrTimer;
 	uv_idle_t _idleTimer;
 	uv_signal_t _signal;
+	// SIGUSR1 captures the trace scopes of the next frames
+	uv_signal_t _traceSignal;
 
 	int _lastEventSkip = 0;
 	int _lastDeltaFrame = 0;
 	uint64_t _lifetimeSeconds = 0u;
+	core::VarPtr _peerBudget;
+	enum Phase {
+		PhaseNetwork, PhaseLoop, PhaseTimers, PhaseEvents
+	};
+	TickProfiler _tickProfiler;
 
 	static void onIdle(uv_idle_t* handle);
 	static void signalCallback(uv_signal_t* handle, int signum);
 	bool addTimer(uv_timer_t* timer, uv_timer_cb cb, uint64_t repeatMillis, uint64_t initialDelayMillis = 0);
 public:
-	ServerLoop(const core::TimeProviderPtr& timeProvider, const MapProviderPtr& mapProvider,
+	ServerLoop(const core::TimeProviderPtr& timeProvider, const core::TimerWheelPtr& timerWheel, const MapProviderPtr& mapProvider,
 			const network::ServerMessageSenderPtr& messageSender,
 			const WorldPtr& world, const persistence::DBHandlerPtr& dbHandler,
 			const network::ServerNetworkPtr& network, const io::FilesystemPtr& filesystem,
@@ -71,6 +82,9 @@ public:
 	void construct() override;
 	bool init() override;
 	void shutdown() override;
+	/**
+	 * @brief Applies the received messages, runs the timers of the loop and expires the timers of the timer wheel
+	 */
 	void update(long dt);
 	void onEvent(const network::DisconnectEvent& event) override;
 };
@@ -0,0 +1,144 @@
+/**
+ * @file
+ */
+
+#include "TickProfiler.h"
+#include "core/Assert.h"
+#include "core/Log.h"
+#include "core/Common.h"
+#include <chrono>
+#include <cmath>
+#include <string.h>
+
+namespace backend {
+
+TickHistogram::TickHistogram() {
+	reset();
+}
+
+int TickHistogram::index(uint64_t value) {
+	if (value < (uint64_t)LinearValues) {
+		return (int)value;
+	}
+	int msb = 63;
+	while ((value >> msb) == 0u) {
+		--msb;
+	}
+	// the three bits below the most significant one select the sub bucket
+	const int sub = (int)((value >> (msb - 3)) & (SubBuckets - 1));
+	return LinearValues + (msb - 4) * SubBuckets + sub;
+}
+
+uint64_t TickHistogram::upperBound(int index) {
+	if (index < LinearValues) {
+		return (uint64_t)index;
+	}
+	const int msb = (index - LinearValues) / SubBuckets + 4;
+	const int sub = (index - LinearValues) % SubBuckets;
+	return ((uint64_t)(SubBuckets + sub + 1) << (msb - 3)) - 1u;
+}
+
+void TickHistogram::add(uint64_t value) {
+	++_buckets[index(value)];
+	++_count;
+	_max = core_max(_max, value);
+}
+
+void TickHistogram::reset() {
+	memset(_buckets, 0, sizeof(_buckets));
+	_count = 0u;
+	_max = 0u;
+}
+
+uint64_t TickHistogram::percentile(double percentile) const {
+	if (_count == 0u) {
+		return 0u;
+	}
+	const uint32_t target = core_max(1u, (uint32_t)std::ceil(percentile * _count));
+	uint32_t sum = 0u;
+	for (int i = 0; i < Buckets; ++i) {
+		sum += _buckets[i];
+		if (sum >= target) {
+			return core_min(upperBound(i), _max);
+		}
+	}
+	return _max;
+}
+
+TickProfiler::TickProfiler(const std::string& name, std::initializer_list<const char*> phaseNames) :
+		_name(name), _phases((int)phaseNames.size()) {
+	core_assert_always(_phases <= MaxPhases);
+	int i = 0;
+	for (const char *phaseName : phaseNames) {
+		_phaseNames[i++] = phaseName;
+	}
+	memset(_current, 0, sizeof(_current));
+}
+
+uint64_t TickProfiler::nanos() {
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void TickProfiler::setBudget(const core::VarPtr& budgetMillis) {
+	_budgetMillis = budgetMillis;
+}
+
+void TickProfiler::begin() {
+	_startNanos = _lastNanos = nanos();
+}
+
+void TickProfiler::mark(int phase) {
+	core_assert(phase >= 0 && phase < _phases);
+	const uint64_t now = nanos();
+	_current[phase] += now - _lastNanos;
+	_lastNanos = now;
+}
+
+void TickProfiler::end() {
+	const uint64_t totalMicros = (nanos() - _startNanos) / 1000u;
+	_total.add(totalMicros);
+	for (int i = 0; i < _phases; ++i) {
+		_histograms[i].add(_current[i] / 1000u);
+	}
+	const int budgetMillis = _budgetMillis ? _budgetMillis->intVal() : 0;
+	if (budgetMillis > 0 && totalMicros > (uint64_t)budgetMillis * 1000u) {
+		++_slowTicks;
+		if (!_slowTickLogged) {
+			_slowTickLogged = true;
+			std::string breakdown;
+			for (int i = 0; i < _phases; ++i) {
+				if (i > 0) {
+					breakdown += ", ";
+				}
+				breakdown += core::string::format("%s: %.2fms", _phaseNames[i], (double)_current[i] / 1000000.0);
+			}
+			Log::warn("Slow %s tick: %.2fms (budget: %ims) - %s", _name.c_str(), (double)totalMicros / 1000.0,
+					budgetMillis, breakdown.c_str());
+		}
+	}
+	memset(_current, 0, sizeof(_current));
+}
+
+void TickProfiler::publish(const metric::Metric& metric, const metric::TagMap& tags) {
+	if (_total.count() == 0u) {
+		return;
+	}
+	metric::TagMap phaseTags = tags;
+	auto send = [&] (const char *phase, const TickHistogram& histogram) {
+		phaseTags.put("phase", phase);
+		metric.gauge("tick.p50", (uint32_t)histogram.percentile(0.5), phaseTags);
+		metric.gauge("tick.p99", (uint32_t)histogram.percentile(0.99), phaseTags);
+		metric.gauge("tick.max", (uint32_t)histogram.max(), phaseTags);
+	};
+	for (int i = 0; i < _phases; ++i) {
+		send(_phaseNames[i], _histograms[i]);
+		_histograms[i].reset();
+	}
+	send("total", _total);
+	_total.reset();
+	metric.gauge("tick.slow", _slowTicks, tags);
+	_slowTicks = 0u;
+	_slowTickLogged = false;
+}
+
+}
@@ -0,0 +1,128 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/metric/Metric.h"
+#include "core/Var.h"
+#include <stdint.h>
+#include <string>
+
+namespace backend {
+
+/**
+ * @brief Log-linear histogram of microsecond values - a power of two range is split into 8 buckets,
+ * this keeps the error of the reported percentiles below 12.5 percent.
+ */
+class TickHistogram {
+private:
+	static constexpr int SubBuckets = 8;
+	// the values below are stored exactly
+	static constexpr int LinearValues = 2 * SubBuckets;
+	static constexpr int Buckets = LinearValues + (64 - 4) * SubBuckets;
+	uint32_t _buckets[Buckets];
+	uint32_t _count = 0u;
+	uint64_t _max = 0u;
+
+	static int index(uint64_t value);
+	// the highest value that is put into the given bucket
+	static uint64_t upperBound(int index);
+public:
+	TickHistogram();
+
+	void add(uint64_t value);
+	void reset();
+
+	/**
+	 * @param[in] percentile [0,1]
+	 * @return The upper bound of the bucket that contains the given percentile of all values - but
+	 * never more than the max value
+	 */
+	uint64_t percentile(double percentile) const;
+	uint64_t max() const;
+	uint32_t count() const;
+};
+
+inline uint64_t TickHistogram::max() const {
+	return _max;
+}
+
+inline uint32_t TickHistogram::count() const {
+	return _count;
+}
+
+/**
+ * @brief Measures the time that is spent in the phases of a tick.
+ *
+ * Call @c begin() at the start of the tick and @c mark() after each phase - the time since the
+ * previous mark is added to the given phase. @c end() puts the phase timings into their histograms
+ * and logs the breakdown if the tick exceeded the budget.
+ *
+ * @c publish() sends p50, p99 and max of every phase and of the whole tick as gauges (in microseconds)
+ * with a @c phase tag and starts a new aggregation window.
+ */
+class TickProfiler {
+public:
+	static constexpr int MaxPhases = 8;
+private:
+	const std::string _name;
+	const char *_phaseNames[MaxPhases];
+	const int _phases;
+	TickHistogram _histograms[MaxPhases];
+	TickHistogram _total;
+	uint64_t _current[MaxPhases];
+	uint64_t _startNanos = 0u;
+	uint64_t _lastNanos = 0u;
+	core::VarPtr _budgetMillis;
+	uint32_t _slowTicks = 0u;
+	// the slow ticks are only logged once per publish window
+	bool _slowTickLogged = false;
+
+	static uint64_t nanos();
+public:
+	/**
+	 * @param[in] name Used in the slow tick log message
+	 * @param[in] phaseNames String literals that are used for the @c phase metric tag
+	 */
+	TickProfiler(const std::string& name, std::initializer_list<const char*> phaseNames);
+
+	/**
+	 * @param[in] budgetMillis Ticks that take longer than this are logged with their breakdown. If @c nullptr
+	 * or @c 0 the ticks are not checked.
+	 */
+	void setBudget(const core::VarPtr& budgetMillis);
+
+	void begin();
+	/**
+	 * @brief Adds the time since the last mark (or @c begin()) to the given phase
+	 */
+	void mark(int phase);
+	void end();
+
+	/**
+	 * @brief Sends the aggregated timings as @c tick.p50, @c tick.p99 and @c tick.max gauges and
+	 * the slow ticks as @c tick.slow - then the aggregation is restarted
+	 * @param[in] tags Added to every metric - the @c phase tag is added for each phase. The whole
+	 * tick is sent with the phase @c total.
+	 */
+	void publish(const metric::Metric& metric, const metric::TagMap& tags = {});
+
+	const TickHistogram& histogram(int phase) const;
+	const TickHistogram& total() const;
+	uint32_t slowTicks() const;
+};
+
+inline const TickHistogram& TickProfiler::histogram(int phase) const {
+	return _histograms[phase];
+}
+
+inline const TickHistogram& TickProfiler::total() const {
+	return _total;
+}
+
+inline uint32_t TickProfiler::slowTicks() const {
+	return _slowTicks;
+}
+
+}
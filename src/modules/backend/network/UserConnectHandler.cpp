@@ -17,7 +17,7 @@
 namespace backend {
 
 UserConnectHandler::UserConnectHandler(
-		const network::NetworkPtr& network,
+		const network::ServerNetworkPtr& network,
 		const MapProviderPtr& mapProvider,
 		const persistence::DBHandlerPtr& dbHandler,
 		const persistence::PersistenceMgrPtr& persistenceMgr,
@@ -5,7 +5,7 @@
 #pragma once
 
 #include "backend/ForwardDecl.h"
-#include "network/Network.h"
+#include "network/ServerNetwork.h"
 #include "core/TimeProvider.h"
 #include "core/Log.h"
 #include "ai/common/CharacterId.h"
@@ -20,7 +20,7 @@ namespace backend {
 class UserConnectHandler: public network::IProtocolHandler {
 private:
 	static constexpr auto logid = Log::logid("UserConnectHandler");
-	network::NetworkPtr _network;
+	network::ServerNetworkPtr _network;
 	MapProviderPtr _mapProvider;
 	persistence::DBHandlerPtr _dbHandler;
 	persistence::PersistenceMgrPtr _persistenceMgr;
@@ -37,7 +37,7 @@ private:
 
 public:
 	UserConnectHandler(
-			const network::NetworkPtr& network,
+			const network::ServerNetworkPtr& network,
 			const MapProviderPtr& mapProvider,
 			const persistence::DBHandlerPtr& dbHandler,
 			const persistence::PersistenceMgrPtr& persistenceMgr,
@@ -31,12 +31,24 @@ SpawnMgr::SpawnMgr(Map* map,
 }
 
 void SpawnMgr::shutdown() {
+	_map->timerWheel()->cancel(_spawnTimer);
+	_spawnTimer = core::TimerWheel::InvalidTimerId;
 }
 
 bool SpawnMgr::init() {
+	_spawnTimer = _map->timerWheel()->add(_timeProvider->tickMillis(), onSpawnTimer, this);
 	return true;
 }
 
+void SpawnMgr::onSpawnTimer(const core::TimerWheel::Timer* timers, size_t amount) {
+	for (size_t i = 0; i < amount; ++i) {
+		SpawnMgr* mgr = (SpawnMgr*)timers[i].target;
+		mgr->spawnAnimals();
+		mgr->spawnCharacters();
+		mgr->_spawnTimer = mgr->_map->timerWheel()->add(mgr->_timeProvider->tickMillis() + spawnTime, onSpawnTimer, mgr);
+	}
+}
+
 void SpawnMgr::spawnCharacters() {
 	// TODO: let this number come from the map lua script
 	spawnEntity(network::EntityType::BEGIN_CHARACTERS, network::EntityType::MAX_CHARACTERS, 1);
@@ -125,13 +137,4 @@ int SpawnMgr::spawn(network::EntityType type, int amount, const glm::ivec3* pos)
 	return amount;
 }
 
-void SpawnMgr::update(long dt) {
-	_time += dt;
-	if (_time >= spawnTime) {
-		_time -= spawnTime;
-		spawnAnimals();
-		spawnCharacters();
-	}
-}
-
 }
@@ -7,6 +7,7 @@
 #include "ServerMessages_generated.h"
 #include "backend/ForwardDecl.h"
 #include "core/IComponent.h"
+#include "core/TimerWheel.h"
 #include <glm/fwd.hpp>
 #include <glm/vec3.hpp>
 
@@ -22,7 +23,7 @@ private:
 	attrib::ContainerProviderPtr _containerProvider;
 	cooldown::CooldownProviderPtr _cooldownProvider;
 	io::FilesystemPtr _filesystem;
-	long _time = 15000L;
+	core::TimerWheel::TimerId _spawnTimer = core::TimerWheel::InvalidTimerId;
 
 	void spawnEntity(network::EntityType start, network::EntityType end, int maxAmount);
 	void spawnAnimals();
@@ -30,6 +31,10 @@ private:
 
 	NpcPtr createNpc(network::EntityType type, const ai::TreeNodePtr& behaviour);
 	bool onSpawn(const NpcPtr& npc, const glm::ivec3* pos);
+	/**
+	 * @brief Spawns the missing entities and rearms the timer
+	 */
+	static void onSpawnTimer(const core::TimerWheel::Timer* timers, size_t amount);
 
 public:
 	SpawnMgr(Map* map,
@@ -40,12 +45,15 @@ public:
 			const AILoaderPtr& loader,
 			const attrib::ContainerProviderPtr& containerProvider,
 			const cooldown::CooldownProviderPtr& cooldownProvider);
+	/**
+	 * @brief Starts the periodic spawn timer on the timer wheel of the map - the first spawn happens
+	 * with the next update of the wheel
+	 */
 	bool init() override;
 	void shutdown() override;
 
 	NpcPtr spawn(network::EntityType type, const glm::ivec3* pos = nullptr);
 	int spawn(network::EntityType type, int amount, const glm::ivec3* pos = nullptr);
-	void update(long dt);
 };
 
 typedef std::shared_ptr<SpawnMgr> SpawnMgrPtr;
@@ -149,4 +149,18 @@ TEST_F(AITest, testActionAttackOnSelection) {
 	EXPECT_EQ(ai::TreeNodeStatus::FINISHED, action->execute(npc->ai(), 0L));
 }
 
+TEST_F(AITest, testAggroTargetSendPriority) {
+	const NpcPtr& npc = create();
+	const NpcPtr& partner = create();
+	const network::ServerMsgType type = network::ServerMsgType::EntityUpdate;
+	EXPECT_EQ(-1, npc->aggroTarget());
+	EXPECT_EQ(npc->sendHint(type, *partner).priority, partner->sendHint(type, *npc).priority);
+
+	npc->applyDamage(partner.get(), 1.0);
+	npc->update(0L);
+	EXPECT_EQ(partner->id(), npc->aggroTarget());
+	EXPECT_GT(npc->sendHint(type, *partner).priority, partner->sendHint(type, *npc).priority)
+		<< "Updates of the npc that has the partner as aggro target should be more important for the partner";
+}
+
 }
@@ -12,6 +12,8 @@
 #include "network/ProtocolHandlerRegistry.h"
 
 #include "network/ServerNetwork.h"
+#include <chrono>
+#include <thread>
 
 namespace backend {
 
@@ -134,4 +136,22 @@ TEST_F(ConnectTest, testConnect) {
 	EXPECT_EQ(1, _userConnectHandlerCalled);
 }
 
+TEST_F(ConnectTest, testConnectNetworkThread) {
+	ASSERT_TRUE(listen()) << "Failed to bind to port " << _port;
+	ASSERT_TRUE(_serverNetwork->start());
+	ASSERT_TRUE(_serverNetwork->threaded());
+	ASSERT_TRUE(connect()) << "Failed to connect to port " << _port;
+
+	for (int i = 0; i < 1000 && _userConnectHandlerCalled == 0; ++i) {
+		update();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	EXPECT_EQ(0, _disconnectEvent);
+	EXPECT_EQ(1, _connectEvent);
+	EXPECT_EQ(1, _userConnectHandlerCalled);
+	const network::ServerNetwork::Stats& stats = _serverNetwork->stats();
+	EXPECT_GE(stats.applied, 2u) << "Expected the connect event and the user connect message";
+	EXPECT_EQ(0u, stats.inboundDepth);
+}
+
 }
@@ -3,6 +3,7 @@
  */
 
 #include "core/tests/AbstractTest.h"
+#include "core/TimerWheel.h"
 #include "backend/entity/ai/AIRegistry.h"
 #include "backend/world/MapProvider.h"
 #include "backend/world/Map.h"
@@ -65,6 +66,7 @@ protected:
 	core::EventBusPtr eventBus;
 	io::FilesystemPtr filesystem;
 	core::TimeProviderPtr timeProvider;
+	core::TimerWheelPtr timerWheel;
 	std::shared_ptr<persistence::PersistenceMgrMock> persistenceMgr;
 	MapProviderPtr mapProvider;
 	MapPtr map;
@@ -88,11 +90,12 @@ protected:
 		eventBus = _testApp->eventBus();
 		voxelformat::VolumeCachePtr volumeCache = std::make_shared<voxelformat::VolumeCache>();
 		timeProvider = _testApp->timeProvider();
+		timerWheel = std::make_shared<core::TimerWheel>();
 		persistenceMgr = std::make_shared<persistence::PersistenceMgrMock>();
 		EXPECT_CALL(*persistenceMgr, registerSavable(testing::_, testing::_)).WillRepeatedly(testing::Return(true));
 		EXPECT_CALL(*persistenceMgr, unregisterSavable(testing::_, testing::_)).WillRepeatedly(testing::Return(true));
 		testing::Mock::AllowLeak(persistenceMgr.get());
-		mapProvider = std::make_shared<MapProvider>(filesystem, eventBus, timeProvider,
+		mapProvider = std::make_shared<MapProvider>(filesystem, eventBus, timeProvider, timerWheel,
 				entityStorage, messageSender, loader, containerProvider, cooldownProvider, persistenceMgr, volumeCache);
 		ASSERT_TRUE(mapProvider->init()) << "Failed to initialize the map provider";
 		map = mapProvider->map(1);
@@ -3,6 +3,7 @@
  */
 
 #include "core/tests/AbstractTest.h"
+#include "core/TimerWheel.h"
 #include "backend/world/MapProvider.h"
 #include "network/ProtocolHandlerRegistry.h"
 #include "network/ServerNetwork.h"
@@ -29,6 +30,7 @@ public:
 	cooldown::CooldownProviderPtr _cooldownProvider;
 	std::shared_ptr<persistence::PersistenceMgrMock> _persistenceMgr;
 	voxelformat::VolumeCachePtr _volumeCache;
+	core::TimerWheelPtr _timerWheel;
 
 	void SetUp() override {
 		core::AbstractTest::SetUp();
@@ -46,6 +48,7 @@ public:
 		_cooldownProvider = std::make_shared<cooldown::CooldownProvider>();
 		_persistenceMgr = std::make_shared<persistence::PersistenceMgrMock>();
 		_volumeCache = std::make_shared<voxelformat::VolumeCache>();
+		_timerWheel = std::make_shared<core::TimerWheel>();
 		EXPECT_CALL(*_persistenceMgr, registerSavable(testing::_, testing::_)).WillRepeatedly(testing::Return(true));
 		EXPECT_CALL(*_persistenceMgr, unregisterSavable(testing::_, testing::_)).WillRepeatedly(testing::Return(true));
 		testing::Mock::AllowLeak(_persistenceMgr.get());
@@ -53,7 +56,7 @@ public:
 };
 
 #define create(name) \
-	MapProvider name(_testApp->filesystem(), _testApp->eventBus(), _testApp->timeProvider(), \
+	MapProvider name(_testApp->filesystem(), _testApp->eventBus(), _testApp->timeProvider(), _timerWheel, \
 			_entityStorage, _messageSender, _loader, _containerProvider, _cooldownProvider, _persistenceMgr, _volumeCache);
 
 TEST_F(MapProviderTest, testInitShutdown) {
@@ -3,6 +3,7 @@
  */
 
 #include "core/tests/AbstractTest.h"
+#include "core/TimerWheel.h"
 #include "backend/world/Map.h"
 #include "network/ProtocolHandlerRegistry.h"
 #include "network/ServerNetwork.h"
@@ -28,6 +29,7 @@ public:
 	attrib::ContainerProviderPtr _containerProvider;
 	cooldown::CooldownProviderPtr _cooldownProvider;
 	voxelformat::VolumeCachePtr _volumeCache;
+	core::TimerWheelPtr _timerWheel;
 	std::shared_ptr<persistence::PersistenceMgrMock> _persistenceMgr;
 
 	void SetUp() override {
@@ -45,6 +47,7 @@ public:
 		_containerProvider = std::make_shared<attrib::ContainerProvider>();
 		_cooldownProvider = std::make_shared<cooldown::CooldownProvider>();
 		_volumeCache = std::make_shared<voxelformat::VolumeCache>();
+		_timerWheel = std::make_shared<core::TimerWheel>();
 		_persistenceMgr = std::make_shared<persistence::PersistenceMgrMock>();
 		EXPECT_CALL(*_persistenceMgr, registerSavable(testing::_, testing::_)).WillRepeatedly(testing::Return(true));
 		EXPECT_CALL(*_persistenceMgr, unregisterSavable(testing::_, testing::_)).WillRepeatedly(testing::Return(true));
@@ -53,7 +56,7 @@ public:
 };
 
 #define create(name, id) \
-	Map name(id, _testApp->eventBus(), _testApp->timeProvider(), _testApp->filesystem(), _entityStorage, \
+	Map name(id, _testApp->eventBus(), _testApp->timeProvider(), _timerWheel, _testApp->filesystem(), _entityStorage, \
 			_messageSender, _volumeCache, _loader, _containerProvider, _cooldownProvider, _persistenceMgr);
 
 TEST_F(MapTest, testInitShutdown) {
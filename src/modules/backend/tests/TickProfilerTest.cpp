@@ -0,0 +1,106 @@
+/**
+ * @file
+ */
+
+#include "core/tests/AbstractTest.h"
+#include "backend/metric/TickProfiler.h"
+#include "core/metric/IMetricSender.h"
+#include "core/GameConfig.h"
+#include <thread>
+#include <vector>
+
+namespace backend {
+
+class TickProfilerTest: public core::AbstractTest {
+protected:
+	class BufferedMetricSender : public metric::IMetricSender {
+	public:
+		mutable std::vector<std::string> _metrics;
+		bool send(const char* metric) const override {
+			_metrics.emplace_back(metric);
+			return true;
+		}
+	};
+};
+
+TEST_F(TickProfilerTest, testHistogramPercentiles) {
+	TickHistogram histogram;
+	EXPECT_EQ(0u, histogram.percentile(0.5));
+	for (uint64_t i = 1u; i <= 1000u; ++i) {
+		histogram.add(i);
+	}
+	EXPECT_EQ(1000u, histogram.count());
+	EXPECT_EQ(1000u, histogram.max());
+	const uint64_t p50 = histogram.percentile(0.5);
+	EXPECT_GE(p50, 500u);
+	EXPECT_LE(p50, 500u + 500u / 8u);
+	const uint64_t p99 = histogram.percentile(0.99);
+	EXPECT_GE(p99, 990u);
+	EXPECT_LE(p99, 1000u) << "Never more than the max value";
+	histogram.reset();
+	EXPECT_EQ(0u, histogram.count());
+	EXPECT_EQ(0u, histogram.max());
+}
+
+TEST_F(TickProfilerTest, testHistogramSmallValues) {
+	TickHistogram histogram;
+	histogram.add(0u);
+	histogram.add(3u);
+	histogram.add(3u);
+	histogram.add(7u);
+	EXPECT_EQ(3u, histogram.percentile(0.5));
+	EXPECT_EQ(7u, histogram.percentile(1.0));
+}
+
+TEST_F(TickProfilerTest, testPhases) {
+	TickProfiler profiler("test", {"first", "second"});
+	for (int i = 0; i < 3; ++i) {
+		profiler.begin();
+		profiler.mark(0);
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		profiler.mark(1);
+		profiler.end();
+	}
+	EXPECT_EQ(3u, profiler.histogram(0).count());
+	EXPECT_EQ(3u, profiler.histogram(1).count());
+	EXPECT_GE(profiler.histogram(1).percentile(0.5), 2000u);
+	EXPECT_LT(profiler.histogram(0).max(), profiler.histogram(1).max());
+	EXPECT_GE(profiler.total().max(), profiler.histogram(1).max());
+	EXPECT_EQ(0u, profiler.slowTicks()) << "No budget was set";
+}
+
+TEST_F(TickProfilerTest, testBudgetAndPublish) {
+	TickProfiler profiler("test", {"phase"});
+	const core::VarPtr budget = core::Var::get("test_tickbudget", "1");
+	profiler.setBudget(budget);
+	profiler.begin();
+	profiler.mark(0);
+	profiler.end();
+	profiler.begin();
+	std::this_thread::sleep_for(std::chrono::milliseconds(3));
+	profiler.mark(0);
+	profiler.end();
+	EXPECT_EQ(1u, profiler.slowTicks());
+
+	const std::shared_ptr<BufferedMetricSender> sender = std::make_shared<BufferedMetricSender>();
+	core::Var::get(cfg::MetricFlavor, "telegraf")->setVal("telegraf");
+	metric::Metric metric;
+	ASSERT_TRUE(metric.init("test", sender));
+	profiler.publish(metric, {{"map", "1"}});
+	// p50, p99 and max for the phase and the total - and the slow ticks
+	ASSERT_EQ(7u, sender->_metrics.size());
+	for (const std::string& m : sender->_metrics) {
+		EXPECT_NE(std::string::npos, m.find("map=1")) << m;
+	}
+	EXPECT_NE(std::string::npos, sender->_metrics[0].find("phase=phase")) << sender->_metrics[0];
+	EXPECT_NE(std::string::npos, sender->_metrics[3].find("phase=total")) << sender->_metrics[3];
+	EXPECT_EQ(0u, profiler.slowTicks());
+	EXPECT_EQ(0u, profiler.total().count());
+
+	sender->_metrics.clear();
+	profiler.publish(metric);
+	EXPECT_TRUE(sender->_metrics.empty()) << "Nothing was measured since the last publish";
+	metric.shutdown();
+}
+
+}
@@ -3,6 +3,9 @@
  */
 
 #include "core/tests/AbstractTest.h"
+#include "core/TimerWheel.h"
+#include "core/TraceRecorder.h"
+#include "core/JSON.h"
 #include "backend/world/World.h"
 #include "backend/world/MapProvider.h"
 #include "network/ProtocolHandlerRegistry.h"
@@ -55,7 +58,7 @@ public:
 		EXPECT_CALL(*_persistenceMgr, unregisterSavable(testing::_, testing::_)).WillRepeatedly(testing::Return(true));
 		testing::Mock::AllowLeak(_persistenceMgr.get());
 		_mapProvider = std::make_shared<MapProvider>(_testApp->filesystem(), _testApp->eventBus(), _testApp->timeProvider(),
-				_entityStorage, _messageSender, _loader, _containerProvider, _cooldownProvider, _persistenceMgr, _volumeCache);
+				std::make_shared<core::TimerWheel>(), _entityStorage, _messageSender, _loader, _containerProvider, _cooldownProvider, _persistenceMgr, _volumeCache);
 	}
 };
 
@@ -75,6 +78,43 @@ TEST_F(WorldTest, testUpdate) {
 	world.shutdown();
 }
 
+TEST_F(WorldTest, testTraceCapture) {
+	create(world);
+	ASSERT_TRUE(world.init());
+	core::TraceRecorder recorder;
+	const int frames = 10;
+	recorder.requestCapture(frames);
+	bool finished = false;
+	// one more frame than captured - the finished capture is reported by the next update
+	for (int i = 0; i <= frames; ++i) {
+		finished = recorder.update();
+		core_trace_begin_frame();
+		world.update(50l);
+		core_trace_end_frame();
+	}
+	ASSERT_TRUE(finished);
+	EXPECT_FALSE(recorder.capturing());
+	world.shutdown();
+
+	const core::json root = core::json::parse(recorder.toJSON());
+	int frameEvents = 0;
+	int worldUpdates = 0;
+	int mapUpdates = 0;
+	for (const core::json& event : root["traceEvents"]) {
+		const std::string& name = event["name"].get<std::string>();
+		if (name == "Frame") {
+			++frameEvents;
+		} else if (name == "WorldUpdate") {
+			++worldUpdates;
+		} else if (name == "MapUpdate") {
+			++mapUpdates;
+		}
+	}
+	EXPECT_EQ(frames, frameEvents);
+	EXPECT_EQ(frames, worldUpdates);
+	EXPECT_GE(mapUpdates, frames);
+}
+
 #undef create
 
 }
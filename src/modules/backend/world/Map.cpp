@@ -5,9 +5,11 @@
 #include "Map.h"
 #include "voxelworld/WorldPager.h"
 #include "voxelworld/WorldMgr.h"
+#include "voxelworld/PathService.h"
 #include "core/String.h"
 #include "core/EventBus.h"
 #include "core/App.h"
+#include "core/Trace.h"
 #include "math/QuadTree.h"
 #include "core/io/Filesystem.h"
 #include "backend/entity/Npc.h"
@@ -32,6 +34,7 @@ bool Map::QuadTreeNode::operator==(const QuadTreeNode& rhs) const {
 Map::Map(MapId mapId,
 		const core::EventBusPtr& eventBus,
 		const core::TimeProviderPtr& timeProvider,
+		const core::TimerWheelPtr& timerWheel,
 		const io::FilesystemPtr& filesystem,
 		const EntityStoragePtr& entityStorage,
 		const network::ServerMessageSenderPtr& messageSender,
@@ -41,8 +44,9 @@ Map::Map(MapId mapId,
 		const cooldown::CooldownProviderPtr& cooldownProvider,
 		const persistence::PersistenceMgrPtr& persistenceMgr) :
 		_mapId(mapId), _mapIdStr(std::to_string(mapId)),
-		_eventBus(eventBus), _filesystem(filesystem), _persistenceMgr(persistenceMgr),
+		_eventBus(eventBus), _timerWheel(timerWheel), _filesystem(filesystem), _persistenceMgr(persistenceMgr),
 		_volumeCache(volumeCache), _attackMgr(this),
+		_tickProfiler("map " + _mapIdStr, {"poi", "zone", "attack", "attribs", "users", "npcs"}),
 		_quadTree(math::RectFloat::getMaxRect(), 100.0f) {
 	_poiProvider = std::make_shared<poi::PoiProvider>(timeProvider);
 	_spawnMgr = std::make_shared<backend::SpawnMgr>(this, filesystem, entityStorage, messageSender,
@@ -79,9 +83,26 @@ bool Map::updateEntity(const EntityPtr& entity, long dt) {
 }
 
 void Map::update(long dt) {
-	_spawnMgr->update(dt);
+	core_trace_scoped(MapUpdate);
+	_tickProfiler.begin();
+	_poiProvider->update(dt);
+	_tickProfiler.mark(PhasePoi);
 	_zone->update(dt);
+	_tickProfiler.mark(PhaseZone);
 	_attackMgr.update(dt);
+	_tickProfiler.mark(PhaseAttack);
+
+	// recalculate the dirty attributes of all entities in one pass - the entity updates are no-ops then
+	_attribs.clear();
+	_attribs.reserve(_users.size() + _npcs.size());
+	for (const auto& e : _users) {
+		_attribs.push_back(&e.second->attribs());
+	}
+	for (const auto& e : _npcs) {
+		_attribs.push_back(&e.second->attribs());
+	}
+	attrib::Attributes::update(_attribs.data(), _attribs.size(), dt);
+	_tickProfiler.mark(PhaseAttribs);
 
 	for (auto i = _users.begin(); i != _users.end();) {
 		UserPtr user = i->second;
@@ -94,6 +115,7 @@ void Map::update(long dt) {
 		i = _users.erase(i);
 		_eventBus->enqueue(std::make_shared<EntityDeleteEvent>(user->id(), user->entityType()));
 	}
+	_tickProfiler.mark(PhaseUsers);
 	for (auto i = _npcs.begin(); i != _npcs.end();) {
 		NpcPtr npc = i->second;
 		if (updateEntity(npc, dt)) {
@@ -106,6 +128,8 @@ void Map::update(long dt) {
 		_zone->removeAI(npc->ai());
 		_eventBus->enqueue(std::make_shared<EntityDeleteEvent>(npc->id(), npc->entityType()));
 	}
+	_tickProfiler.mark(PhaseNpcs);
+	_tickProfiler.end();
 }
 
 bool Map::init() {
@@ -113,6 +137,7 @@ bool Map::init() {
 		Log::error("Failed to init attack mgr");
 		return false;
 	}
+	_tickProfiler.setBudget(core::Var::get(cfg::ServerTickBudget, "50"));
 
 	_pager = std::make_shared<voxelworld::WorldPager>(_volumeCache);
 	_voxelWorldMgr = new voxelworld::WorldMgr(_pager);
@@ -130,7 +155,15 @@ bool Map::init() {
 	_pager->setNoiseOffset(glm::zero<glm::vec2>());
 
 	_voxelWorldMgr->setSeed(seed->longVal());
+
+	_pathService = new voxelworld::PathService(_voxelWorldMgr->volumeData());
+	if (!_pathService->init()) {
+		Log::error("Failed to init the path service for map %i", _mapId);
+		return false;
+	}
+
 	_zone = new ai::Zone(core::string::format("Zone %i", _mapId));
+	_zone->setBatchedMovement(core::Var::get(cfg::ServerBatchedMovement, "true")->boolVal());
 
 	if (!_spawnMgr->init()) {
 		Log::error("Failed to init the spawn manager");
@@ -142,6 +175,11 @@ bool Map::init() {
 void Map::shutdown() {
 	_attackMgr.shutdown();
 	_spawnMgr->shutdown();
+	if (_pathService != nullptr) {
+		_pathService->shutdown();
+		delete _pathService;
+		_pathService = nullptr;
+	}
 	if (_pager != nullptr) {
 		_pager->shutdown();
 		_pager = voxelworld::WorldPagerPtr();
@@ -237,6 +275,18 @@ int Map::findFloor(const glm::vec3& pos, float maxDistanceY) const {
 	return _voxelWorldMgr->findWalkableFloor(pos, maxDistanceY);
 }
 
+voxelworld::PathRequestPtr Map::findPath(const glm::ivec3& start, const glm::ivec3& end) {
+	return _pathService->request(start, end);
+}
+
+uint32_t Map::navGeneration() const {
+	return _pathService->navMesh().generation();
+}
+
+bool Map::routeInvalidated(const std::vector<glm::ivec3>& chunks, uint32_t generation) const {
+	return _pathService->navMesh().invalidatedSince(chunks, generation);
+}
+
 glm::ivec3 Map::randomPos() const {
 	return _voxelWorldMgr->randomPos();
 }
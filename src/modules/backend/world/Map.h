@@ -11,12 +11,14 @@
 #include "ai/common/CharacterId.h"
 #include "core/IComponent.h"
 #include "backend/attack/AttackMgr.h"
+#include "backend/metric/TickProfiler.h"
 #include "persistence/ISavable.h"
 #include "persistence/ForwardDecl.h"
 #include "voxel/Constants.h"
 #include "MapId.h"
 #include <memory>
 #include <unordered_map>
+#include <vector>
 #include <glm/fwd.hpp>
 #include <glm/vec3.hpp>
 
@@ -31,9 +33,11 @@ private:
 	MapId _mapId;
 	std::string _mapIdStr;
 	voxelworld::WorldMgr* _voxelWorldMgr = nullptr;
+	voxelworld::PathService* _pathService = nullptr;
 	voxelworld::WorldPagerPtr _pager;
 
 	core::EventBusPtr _eventBus;
+	core::TimerWheelPtr _timerWheel;
 	SpawnMgrPtr _spawnMgr;
 	poi::PoiProviderPtr _poiProvider;
 	io::FilesystemPtr _filesystem;
@@ -51,6 +55,12 @@ private:
 	Users _users;
 
 	AttackMgr _attackMgr;
+	enum Phase {
+		PhasePoi, PhaseZone, PhaseAttack, PhaseAttribs, PhaseUsers, PhaseNpcs
+	};
+	TickProfiler _tickProfiler;
+	// reused buffer for the batched attribute update
+	std::vector<attrib::Attributes*> _attribs;
 
 	struct QuadTreeNode {
 		EntityPtr entity;
@@ -72,6 +82,7 @@ public:
 	Map(MapId mapId,
 			const core::EventBusPtr& eventBus,
 			const core::TimeProviderPtr& timeProvider,
+			const core::TimerWheelPtr& timerWheel,
 			const io::FilesystemPtr& filesystem,
 			const EntityStoragePtr& entityStorage,
 			const network::ServerMessageSenderPtr& messageSender,
@@ -125,14 +136,39 @@ public:
 	int userCount() const;
 
 	int findFloor(const glm::vec3& pos, float maxDistanceY = (float)voxel::MAX_HEIGHT) const;
+	/**
+	 * @brief Queues an async path request - poll the returned request until it's no longer pending
+	 */
+	voxelworld::PathRequestPtr findPath(const glm::ivec3& start, const glm::ivec3& end);
+	/**
+	 * @brief Changed whenever voxels of the map were modified - if it didn't change, @c routeInvalidated()
+	 * doesn't have to be asked
+	 */
+	uint32_t navGeneration() const;
+	/**
+	 * @param[in] chunks The chunks of a found path - see @c voxelworld::PathRequest::chunks
+	 * @param[in] generation The nav generation of the search
+	 * @return @c true if voxels in one of the chunks were modified since the path was found
+	 */
+	bool routeInvalidated(const std::vector<glm::ivec3>& chunks, uint32_t generation) const;
 	glm::ivec3 randomPos() const;
 
 	const AttackMgr& attackMgr() const;
 	AttackMgr& attackMgr();
 
+	/**
+	 * @brief The timers of the map entities (cooldowns, logouts, spawns) are expired by this wheel
+	 */
+	const core::TimerWheelPtr& timerWheel() const;
+
 	const SpawnMgrPtr& spawnMgr() const;
 	SpawnMgrPtr& spawnMgr();
 
+	/**
+	 * @brief The timings of the phases of @c update()
+	 */
+	TickProfiler& tickProfiler();
+
 	const poi::PoiProviderPtr& poiProvider() const;
 	poi::PoiProviderPtr& poiProvider();
 };
@@ -157,6 +193,14 @@ inline const std::string& Map::idStr() const {
 	return _mapIdStr;
 }
 
+inline const core::TimerWheelPtr& Map::timerWheel() const {
+	return _timerWheel;
+}
+
+inline TickProfiler& Map::tickProfiler() {
+	return _tickProfiler;
+}
+
 inline const SpawnMgrPtr& Map::spawnMgr() const {
 	return _spawnMgr;
 }
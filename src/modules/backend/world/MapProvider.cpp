@@ -15,6 +15,7 @@ MapProvider::MapProvider(
 		const io::FilesystemPtr& filesystem,
 		const core::EventBusPtr& eventBus,
 		const core::TimeProviderPtr& timeProvider,
+		const core::TimerWheelPtr& timerWheel,
 		const EntityStoragePtr& entityStorage,
 		const network::ServerMessageSenderPtr& messageSender,
 		const AILoaderPtr& loader,
@@ -22,7 +23,7 @@ MapProvider::MapProvider(
 		const cooldown::CooldownProviderPtr& cooldownProvider,
 		const persistence::PersistenceMgrPtr& persistenceMgr,
 		const voxelformat::VolumeCachePtr& volumeCache) :
-		_filesystem(filesystem), _eventBus(eventBus), _timeProvider(timeProvider),
+		_filesystem(filesystem), _eventBus(eventBus), _timeProvider(timeProvider), _timerWheel(timerWheel),
 		_entityStorage(entityStorage), _messageSender(messageSender), _loader(loader),
 		_containerProvider(containerProvider), _cooldownProvider(cooldownProvider),
 		_persistenceMgr(persistenceMgr), _volumeCache(volumeCache) {
@@ -59,7 +60,7 @@ bool MapProvider::init() {
 		return false;
 	}
 
-	const MapPtr& map = std::make_shared<Map>(1, _eventBus, _timeProvider,
+	const MapPtr& map = std::make_shared<Map>(1, _eventBus, _timeProvider, _timerWheel,
 			_filesystem, _entityStorage, _messageSender, _volumeCache,
 			_loader, _containerProvider, _cooldownProvider, _persistenceMgr);
 	if (!map->init()) {
@@ -22,6 +22,7 @@ private:
 	io::FilesystemPtr _filesystem;
 	core::EventBusPtr _eventBus;
 	core::TimeProviderPtr _timeProvider;
+	core::TimerWheelPtr _timerWheel;
 	EntityStoragePtr _entityStorage;
 	network::ServerMessageSenderPtr _messageSender;
 	AILoaderPtr _loader;
@@ -36,6 +37,7 @@ public:
 			const io::FilesystemPtr& filesystem,
 			const core::EventBusPtr& eventBus,
 			const core::TimeProviderPtr& timeProvider,
+			const core::TimerWheelPtr& timerWheel,
 			const EntityStoragePtr& entityStorage,
 			const network::ServerMessageSenderPtr& messageSender,
 			const AILoaderPtr& loader,
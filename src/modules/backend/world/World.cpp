@@ -13,6 +13,8 @@
 #include "core/Log.h"
 #include "core/String.h"
 #include "core/Common.h"
+#include "core/Trace.h"
+#include "core/GameConfig.h"
 #include "LUAFunctions.h"
 #include <SimpleAI.h>
 
@@ -32,13 +34,24 @@ World::~World() {
 }
 
 void World::update(long dt) {
+	core_trace_scoped(WorldUpdate);
 	for (auto& e : _maps) {
 		const MapPtr& map = e.second;
 		map->update(dt);
 	}
+	if (_aiDebugInterval->isDirty() || _aiDebugMaxPending->isDirty()) {
+		updateAIServerSettings();
+	}
 	_aiServer->update(dt);
 }
 
+void World::updateAIServerSettings() {
+	_aiServer->setBroadcastInterval((int64_t)core_max(0, _aiDebugInterval->intVal()));
+	_aiServer->setMaxPendingBytes((size_t)core_max(0, _aiDebugMaxPending->intVal()));
+	_aiDebugInterval->markClean();
+	_aiDebugMaxPending->markClean();
+}
+
 void World::construct() {
 	core::Command::registerCommand("sv_maplist", [this] (const core::CmdArgs& args) {
 		for (auto& e : _maps) {
@@ -71,6 +84,16 @@ void World::construct() {
 		const int amount = args.size() == 3 ? core::string::toInt(args[2]) : 1;
 		map->spawnMgr()->spawn((network::EntityType)type, amount);
 	}).setHelp("Spawns a given amount of npcs of a particular type on the specified map");
+
+	core::Command::registerCommand("sv_aidebugstats", [this] (const core::CmdArgs& args) {
+		if (_aiServer == nullptr) {
+			return;
+		}
+		const ai::Server::Stats& stats = _aiServer->getStats();
+		Log::info("broadcasts: %" SDL_PRIu64 ", full: %" SDL_PRIu64 ", delta: %" SDL_PRIu64 ", throttled: %" SDL_PRIu64,
+				stats.broadcasts, stats.fullMessages, stats.deltaMessages, stats.throttled);
+		Log::info("broadcast time: %" SDL_PRIu64 "us, sent: %" SDL_PRIu64 " bytes", stats.broadcastMicros, stats.sentBytes);
+	}).setHelp("Show the costs of the ai debug server");
 }
 
 bool World::init() {
@@ -82,6 +105,9 @@ bool World::init() {
 	}
 
 	_aiServer = new ai::Server(*_registry, aiDebugServerPort, aiDebugServerInterface);
+	_aiDebugInterval = core::Var::get(cfg::ServerAIDebugInterval, "100");
+	_aiDebugMaxPending = core::Var::get(cfg::ServerAIDebugMaxPending, "1048576");
+	updateAIServerSettings();
 	if (_aiServer->start()) {
 		Log::info("Start the ai debug server on %s:%i", aiDebugServerInterface, aiDebugServerPort);
 	} else {
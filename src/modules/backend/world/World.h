@@ -6,6 +6,7 @@
 
 #include "Map.h"
 #include "core/IComponent.h"
+#include "core/Var.h"
 #include "backend/ForwardDecl.h"
 #include "ai/server/Server.h"
 #include <unordered_map>
@@ -22,7 +23,11 @@ private:
 	core::EventBusPtr _eventBus;
 	io::FilesystemPtr _filesystem;
 	ai::Server* _aiServer = nullptr;
+	core::VarPtr _aiDebugInterval;
+	core::VarPtr _aiDebugMaxPending;
 	std::unordered_map<MapId, MapPtr> _maps;
+
+	void updateAIServerSettings();
 public:
 	World(const MapProviderPtr& mapProvider, const AIRegistryPtr& registry,
 			const core::EventBusPtr& eventBus, const io::FilesystemPtr& filesystem);
@@ -3,7 +3,8 @@
  * @defgroup Compute
  * @{
  *
- * The compute module contains wrappers around OpenCL.
+ * The compute module contains wrappers around OpenCL. Without OpenCL the kernels are executed on the
+ * host - see registerHostKernel().
  *
  * @see compute::Shader
  * @see ComputeShaderTool
@@ -17,6 +18,7 @@
 #include <vector>
 #include "Types.h"
 #include "Texture.h"
+#include "HostKernel.h"
 #include "cl/CLTypes.h"
 #include "core/Vector.h"
 #include "core/Log.h"
@@ -97,6 +99,14 @@ size_t requiredAlignment();
 bool configureProgram(Id program);
 bool deleteProgram(Id& program);
 
+/**
+ * @brief Makes the c++ version of a kernel known to the backend. The host backend executes these instead
+ * of the kernel source of the program. The other backends ignore them.
+ * @param[in] arguments The amount of kernel arguments
+ * @note The computeshadertool generates these implementations and registers them in the shader setup.
+ * @return @c true if the backend is going to execute the host implementation
+ */
+bool registerHostKernel(Id program, const char *name, HostKernel kernel, uint32_t arguments);
 Id createKernel(Id program, const char *name);
 bool deleteKernel(Id& kernel);
 bool kernelArg(Id kernel, uint32_t index, const Texture& texture, int32_t samplerIndex = -1);
@@ -0,0 +1,278 @@
+/**
+ * @file
+ *
+ * The subset of the OpenCL C language that is needed to compile the kernel sources as C++ code
+ * for the host backend. The generated host code lives in a namespace below @c compute::host - that
+ * way the builtins below are found before the functions of the C math library.
+ *
+ * @ingroup Compute
+ */
+#pragma once
+
+#include "HostKernel.h"
+#include <cmath>
+#include <type_traits>
+#include <glm/common.hpp>
+#include <glm/exponential.hpp>
+#include <glm/geometric.hpp>
+#include <glm/trigonometric.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+namespace compute {
+namespace host {
+
+/**
+ * @brief OpenCL vector type. In opposite to the glm vectors a scalar is implicitly converted into a
+ * vector with all components set to the scalar value.
+ */
+template<glm::length_t L, typename T>
+struct clvec : public glm::vec<L, T, glm::defaultp> {
+	using Super = glm::vec<L, T, glm::defaultp>;
+	using Super::Super;
+
+	clvec() : Super(T(0)) {
+	}
+
+	clvec(T scalar) : Super(scalar) {
+	}
+
+	template<typename U, glm::qualifier Q>
+	clvec(const glm::vec<L, U, Q>& v) : Super(v) {
+	}
+
+	inline const Super& vec() const {
+		return *this;
+	}
+};
+
+typedef unsigned char uchar;
+typedef unsigned short ushort;
+typedef unsigned int uint;
+typedef unsigned long ulong;
+
+#define COMPUTE_HOST_VECTOR_TYPE(type) \
+	typedef clvec<2, type> type##2; \
+	typedef clvec<3, type> type##3; \
+	typedef clvec<4, type> type##4;
+
+COMPUTE_HOST_VECTOR_TYPE(char)
+COMPUTE_HOST_VECTOR_TYPE(uchar)
+COMPUTE_HOST_VECTOR_TYPE(short)
+COMPUTE_HOST_VECTOR_TYPE(ushort)
+COMPUTE_HOST_VECTOR_TYPE(int)
+COMPUTE_HOST_VECTOR_TYPE(uint)
+COMPUTE_HOST_VECTOR_TYPE(long)
+COMPUTE_HOST_VECTOR_TYPE(ulong)
+COMPUTE_HOST_VECTOR_TYPE(float)
+COMPUTE_HOST_VECTOR_TYPE(double)
+
+#undef COMPUTE_HOST_VECTOR_TYPE
+
+inline size_t get_global_id(uint dim) {
+	return dim < 3u ? (size_t)workItem.globalId[dim] : 0u;
+}
+
+inline size_t get_global_size(uint dim) {
+	return dim < 3u ? (size_t)workItem.globalSize[dim] : 1u;
+}
+
+inline uint get_work_dim() {
+	return (uint)workItem.workDim;
+}
+
+// the scalar versions of the builtins - the glm functions for the vectors are found by
+// argument dependent lookup. But glm also has generic templates for some of them (like
+// min(genType, genType)) that would be a better match for clvec than the glm vector
+// functions. That's why there are explicit clvec overloads, too.
+
+#define COMPUTE_HOST_UNARY(name, impl) \
+	inline float name(float v) { \
+		return std::impl(v); \
+	} \
+	inline double name(double v) { \
+		return std::impl(v); \
+	} \
+	template<glm::length_t L, typename T> \
+	inline clvec<L, T> name(const clvec<L, T>& v) { \
+		return glm::impl(v.vec()); \
+	}
+
+COMPUTE_HOST_UNARY(floor, floor)
+COMPUTE_HOST_UNARY(ceil, ceil)
+COMPUTE_HOST_UNARY(round, round)
+COMPUTE_HOST_UNARY(trunc, trunc)
+COMPUTE_HOST_UNARY(fabs, abs)
+COMPUTE_HOST_UNARY(sqrt, sqrt)
+COMPUTE_HOST_UNARY(sin, sin)
+COMPUTE_HOST_UNARY(cos, cos)
+COMPUTE_HOST_UNARY(tan, tan)
+COMPUTE_HOST_UNARY(asin, asin)
+COMPUTE_HOST_UNARY(acos, acos)
+COMPUTE_HOST_UNARY(atan, atan)
+COMPUTE_HOST_UNARY(exp, exp)
+COMPUTE_HOST_UNARY(exp2, exp2)
+COMPUTE_HOST_UNARY(log, log)
+COMPUTE_HOST_UNARY(log2, log2)
+
+#undef COMPUTE_HOST_UNARY
+
+inline float rsqrt(float v) {
+	return 1.0f / std::sqrt(v);
+}
+
+inline double rsqrt(double v) {
+	return 1.0 / std::sqrt(v);
+}
+
+template<glm::length_t L, typename T>
+inline clvec<L, T> rsqrt(const clvec<L, T>& v) {
+	return glm::inversesqrt(v.vec());
+}
+
+inline float atan2(float y, float x) {
+	return std::atan2(y, x);
+}
+
+inline float pow(float x, float y) {
+	return std::pow(x, y);
+}
+
+inline float fmod(float x, float y) {
+	return std::fmod(x, y);
+}
+
+template<glm::length_t L, typename T>
+inline clvec<L, T> pow(const clvec<L, T>& x, const clvec<L, T>& y) {
+	return glm::pow(x.vec(), y.vec());
+}
+
+/**
+ * @brief OpenCL fract() - returns the fractional part and stores the floor in the second argument
+ */
+inline float fract(float v, float* iptr) {
+	const float f = std::floor(v);
+	*iptr = f;
+	return glm::min(v - f, 0x1.fffffep-1f);
+}
+
+template<glm::length_t L, typename T>
+inline clvec<L, T> fract(const clvec<L, T>& v, clvec<L, T>* iptr) {
+	const clvec<L, T> f = glm::floor(v.vec());
+	*iptr = f;
+	return glm::min(v.vec() - f.vec(), T(0x1.fffffep-1f));
+}
+
+template<typename T, typename std::enable_if<std::is_arithmetic<T>::value, int>::type = 0>
+inline T min(T a, T b) {
+	return b < a ? b : a;
+}
+
+template<typename T, typename std::enable_if<std::is_arithmetic<T>::value, int>::type = 0>
+inline T max(T a, T b) {
+	return a < b ? b : a;
+}
+
+template<typename T, typename std::enable_if<std::is_arithmetic<T>::value, int>::type = 0>
+inline T clamp(T v, T minVal, T maxVal) {
+	return min(max(v, minVal), maxVal);
+}
+
+template<typename T, typename std::enable_if<std::is_arithmetic<T>::value, int>::type = 0>
+inline T sign(T v) {
+	return T((T(0) < v) - (v < T(0)));
+}
+
+inline float mix(float x, float y, float a) {
+	return x + (y - x) * a;
+}
+
+inline float step(float edge, float x) {
+	return x < edge ? 0.0f : 1.0f;
+}
+
+inline float smoothstep(float edge0, float edge1, float x) {
+	return glm::smoothstep(edge0, edge1, x);
+}
+
+inline float mad(float a, float b, float c) {
+	return a * b + c;
+}
+
+inline float dot(float a, float b) {
+	return a * b;
+}
+
+template<glm::length_t L, typename T>
+inline clvec<L, T> min(const clvec<L, T>& a, const clvec<L, T>& b) {
+	return glm::min(a.vec(), b.vec());
+}
+
+template<glm::length_t L, typename T>
+inline clvec<L, T> min(const clvec<L, T>& a, T b) {
+	return glm::min(a.vec(), b);
+}
+
+template<glm::length_t L, typename T>
+inline clvec<L, T> max(const clvec<L, T>& a, const clvec<L, T>& b) {
+	return glm::max(a.vec(), b.vec());
+}
+
+template<glm::length_t L, typename T>
+inline clvec<L, T> max(const clvec<L, T>& a, T b) {
+	return glm::max(a.vec(), b);
+}
+
+template<glm::length_t L, typename T>
+inline clvec<L, T> clamp(const clvec<L, T>& v, const clvec<L, T>& minVal, const clvec<L, T>& maxVal) {
+	return glm::clamp(v.vec(), minVal.vec(), maxVal.vec());
+}
+
+template<glm::length_t L, typename T>
+inline clvec<L, T> clamp(const clvec<L, T>& v, T minVal, T maxVal) {
+	return glm::clamp(v.vec(), minVal, maxVal);
+}
+
+template<glm::length_t L, typename T>
+inline clvec<L, T> sign(const clvec<L, T>& v) {
+	return glm::sign(v.vec());
+}
+
+template<glm::length_t L, typename T>
+inline clvec<L, T> mix(const clvec<L, T>& x, const clvec<L, T>& y, T a) {
+	return glm::mix(x.vec(), y.vec(), a);
+}
+
+template<glm::length_t L, typename T>
+inline clvec<L, T> mix(const clvec<L, T>& x, const clvec<L, T>& y, const clvec<L, T>& a) {
+	return glm::mix(x.vec(), y.vec(), a.vec());
+}
+
+template<glm::length_t L, typename T>
+inline T dot(const clvec<L, T>& a, const clvec<L, T>& b) {
+	return glm::dot(a.vec(), b.vec());
+}
+
+template<glm::length_t L, typename T>
+inline T length(const clvec<L, T>& v) {
+	return glm::length(v.vec());
+}
+
+template<glm::length_t L, typename T>
+inline T distance(const clvec<L, T>& a, const clvec<L, T>& b) {
+	return glm::distance(a.vec(), b.vec());
+}
+
+template<glm::length_t L, typename T>
+inline clvec<L, T> normalize(const clvec<L, T>& v) {
+	return glm::normalize(v.vec());
+}
+
+template<typename T>
+inline clvec<3, T> cross(const clvec<3, T>& a, const clvec<3, T>& b) {
+	return glm::cross(a.vec(), b.vec());
+}
+
+}
+}
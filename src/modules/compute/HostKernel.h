@@ -0,0 +1,88 @@
+/**
+ * @file
+ *
+ * @ingroup Compute
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <glm/vec3.hpp>
+
+namespace compute {
+
+/**
+ * @brief A kernel argument as it was set via compute::kernelArg()
+ *
+ * @c buffer is only filled if the argument is the handle of a buffer that was created
+ * by the host backend. It points to the memory of that buffer. For @c __local arguments it
+ * points to the local memory of the work group.
+ */
+struct HostKernelArg {
+	const void* value = nullptr;
+	size_t size = 0u;
+	void* buffer = nullptr;
+};
+
+/**
+ * @brief The part of the global work range [begin, end) that one worker executes
+ */
+struct HostWorkRange {
+	glm::ivec3 begin { 0 };
+	glm::ivec3 end { 1 };
+	glm::ivec3 globalSize { 1 };
+	int workDim = 1;
+};
+
+/**
+ * @brief Host implementation of a kernel. Executes all work items of the given range.
+ * @see registerHostKernel()
+ */
+typedef void (*HostKernel)(const HostKernelArg* args, const HostWorkRange& range);
+
+namespace host {
+
+/**
+ * @brief The work item that is currently executed by the calling thread
+ */
+struct WorkItem {
+	glm::ivec3 globalId { 0 };
+	glm::ivec3 globalSize { 1 };
+	int workDim = 1;
+};
+
+inline thread_local WorkItem workItem;
+
+template<class FUNC>
+inline void forEachWorkItem(const HostWorkRange& range, FUNC&& func) {
+	WorkItem& item = workItem;
+	item.globalSize = range.globalSize;
+	item.workDim = range.workDim;
+	for (int z = range.begin.z; z < range.end.z; ++z) {
+		item.globalId.z = z;
+		for (int y = range.begin.y; y < range.end.y; ++y) {
+			item.globalId.y = y;
+			for (int x = range.begin.x; x < range.end.x; ++x) {
+				item.globalId.x = x;
+				func();
+			}
+		}
+	}
+}
+
+template<class T>
+inline T value(const HostKernelArg& arg) {
+	T v {};
+	memcpy((void*)&v, arg.value, arg.size < sizeof(T) ? arg.size : sizeof(T));
+	return v;
+}
+
+template<class T>
+inline T* buffer(const HostKernelArg& arg) {
+	return (T*)arg.buffer;
+}
+
+}
+
+}
@@ -0,0 +1,385 @@
+/**
+ * @file
+ *
+ * Host backend for machines without OpenCL. Buffers live in host memory and the kernels are the
+ * c++ versions that the computeshadertool generates next to the shader wrappers. They are registered
+ * via registerHostKernel() and executed as tiled parallel loops on a thread pool.
+ *
+ * @ingroup Compute
+ */
+#include "compute/Compute.h"
+#include "core/Assert.h"
+#include "core/Common.h"
+#include "core/Concurrency.h"
+#include "core/Log.h"
+#include "core/ThreadPool.h"
+#include "core/Trace.h"
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace compute {
+
+namespace _priv {
+
+struct HostBuffer {
+	std::vector<uint8_t> data;
+	// the size of the last write - like the opencl backend the reads are validated against it
+	size_t size = 0u;
+};
+
+struct HostKernelEntry {
+	HostKernel func = nullptr;
+	uint32_t arguments = 0u;
+};
+
+struct HostProgram {
+	std::unordered_map<std::string, HostKernelEntry> kernels;
+};
+
+struct HostKernelObject {
+	HostKernelEntry entry;
+	std::string name;
+	std::vector<std::vector<uint8_t>> args;
+	std::vector<bool> argsSet;
+	// __local arguments - every work group gets its own scratch memory of the size of the argument
+	std::vector<bool> argsLocal;
+};
+
+struct Context {
+	std::unique_ptr<core::ThreadPool> threadPool;
+	core_trace_mutex(std::mutex, mutex);
+	// the buffer handles that are passed as kernel arguments are resolved to the buffer memory
+	std::unordered_set<Id> buffers;
+};
+
+static Context _ctx;
+
+/**
+ * @brief Don't hand out tiles that are too small to be worth a task
+ */
+static constexpr int MinWorkItemsPerTask = 256;
+
+/**
+ * @brief Executes a tile of the work range. A tile is a work group - the @c __local arguments
+ * point to scratch memory that is only shared by the work items of the tile.
+ */
+static void runTile(HostKernel func, const std::vector<HostKernelArg>& args, const std::vector<uint32_t>& localArgs, const HostWorkRange& tile) {
+	if (localArgs.empty()) {
+		func(args.data(), tile);
+		return;
+	}
+	std::vector<HostKernelArg> tileArgs(args);
+	std::vector<std::vector<uint8_t>> scratch(localArgs.size());
+	for (size_t i = 0; i < localArgs.size(); ++i) {
+		HostKernelArg& arg = tileArgs[localArgs[i]];
+		scratch[i].resize(arg.size);
+		arg.buffer = scratch[i].data();
+	}
+	func(tileArgs.data(), tile);
+}
+
+}
+
+size_t requiredAlignment() {
+	// cache line size
+	return 64;
+}
+
+bool configureProgram(Id program) {
+	return program != InvalidId;
+}
+
+bool deleteProgram(Id& program) {
+	if (program == InvalidId) {
+		return true;
+	}
+	delete (_priv::HostProgram*)program;
+	program = InvalidId;
+	return true;
+}
+
+Id createBuffer(BufferFlag flags, size_t size, void* data) {
+	if (!supported()) {
+		return InvalidId;
+	}
+	core_assert(size > 0);
+	_priv::HostBuffer* buffer = new _priv::HostBuffer();
+	buffer->data.resize(size);
+	buffer->size = size;
+	// there is no device memory - the host pointer is always copied. This also means that the
+	// caller is free to release the memory after the buffer was created.
+	if (data != nullptr) {
+		memcpy(buffer->data.data(), data, size);
+	}
+	std::unique_lock lock(_priv::_ctx.mutex);
+	_priv::_ctx.buffers.insert((Id)buffer);
+	return (Id)buffer;
+}
+
+bool deleteBuffer(Id& buffer) {
+	if (buffer == InvalidId) {
+		return true;
+	}
+	{
+		std::unique_lock lock(_priv::_ctx.mutex);
+		_priv::_ctx.buffers.erase(buffer);
+	}
+	delete (_priv::HostBuffer*)buffer;
+	buffer = InvalidId;
+	return true;
+}
+
+bool updateBuffer(Id buffer, size_t size, const void* data, bool blockingWrite) {
+	if (buffer == InvalidId) {
+		return false;
+	}
+	if (data == nullptr) {
+		return false;
+	}
+	_priv::HostBuffer* hostBuffer = (_priv::HostBuffer*)buffer;
+	if (size > hostBuffer->data.size()) {
+		hostBuffer->data.resize(size);
+	}
+	memcpy(hostBuffer->data.data(), data, size);
+	hostBuffer->size = size;
+	return true;
+}
+
+bool readBuffer(Id buffer, size_t size, void* data) {
+	if (buffer == InvalidId) {
+		return false;
+	}
+	if (size <= 0) {
+		return false;
+	}
+	if (data == nullptr) {
+		return false;
+	}
+	const _priv::HostBuffer* hostBuffer = (const _priv::HostBuffer*)buffer;
+	if (size > hostBuffer->data.size()) {
+		Log::error("Expected to read %i bytes, but the buffer only has %i", (int)size, (int)hostBuffer->data.size());
+		return false;
+	}
+	if (data != hostBuffer->data.data()) {
+		memcpy(data, hostBuffer->data.data(), size);
+	}
+	return true;
+}
+
+Id createTexture(const Texture& texture, const uint8_t* data) {
+	return InvalidId;
+}
+
+void deleteTexture(Id& id) {
+}
+
+Id createSampler(const TextureConfig& config) {
+	return InvalidId;
+}
+
+void deleteSampler(Id& id) {
+}
+
+bool readTexture(compute::Texture& texture, void *data, const glm::ivec3& origin, const glm::ivec3& region, bool blocking) {
+	return false;
+}
+
+bool copyBufferToImage(compute::Id buffer, compute::Id image, size_t bufferOffset, const glm::ivec3& origin, const glm::ivec3& region) {
+	return false;
+}
+
+Id createProgram(const std::string& source) {
+	if (!supported()) {
+		return InvalidId;
+	}
+	// the source is not needed - the kernels are registered by the generated shader wrappers
+	return (Id)new _priv::HostProgram();
+}
+
+bool registerHostKernel(Id program, const char *name, HostKernel kernel, uint32_t arguments) {
+	if (program == InvalidId) {
+		return false;
+	}
+	core_assert(name != nullptr);
+	_priv::HostProgram* hostProgram = (_priv::HostProgram*)program;
+	hostProgram->kernels[name] = _priv::HostKernelEntry{kernel, arguments};
+	return true;
+}
+
+Id createKernel(Id program, const char *name) {
+	if (program == InvalidId) {
+		return InvalidId;
+	}
+	core_assert(name != nullptr);
+	const _priv::HostProgram* hostProgram = (const _priv::HostProgram*)program;
+	auto i = hostProgram->kernels.find(name);
+	if (i == hostProgram->kernels.end()) {
+		Log::error("There is no host implementation for kernel %s", name);
+		return InvalidId;
+	}
+	_priv::HostKernelObject* kernel = new _priv::HostKernelObject();
+	kernel->entry = i->second;
+	kernel->name = name;
+	kernel->args.resize(i->second.arguments);
+	kernel->argsSet.resize(i->second.arguments, false);
+	kernel->argsLocal.resize(i->second.arguments, false);
+	return (Id)kernel;
+}
+
+bool deleteKernel(Id& kernel) {
+	if (kernel == InvalidId) {
+		return false;
+	}
+	delete (_priv::HostKernelObject*)kernel;
+	kernel = InvalidId;
+	return true;
+}
+
+bool kernelArg(Id kernel, uint32_t index, const Texture& texture, int32_t samplerIndex) {
+	return false;
+}
+
+bool kernelArg(Id kernel, uint32_t index, size_t size, const void* data) {
+	if (kernel == InvalidId) {
+		return false;
+	}
+	_priv::HostKernelObject* hostKernel = (_priv::HostKernelObject*)kernel;
+	if (index >= hostKernel->args.size()) {
+		Log::error("Invalid argument index %u for kernel %s", index, hostKernel->name.c_str());
+		return false;
+	}
+	std::vector<uint8_t>& arg = hostKernel->args[index];
+	// a null pointer declares local memory of the given size like in opencl
+	const bool local = data == nullptr;
+	if (local && size == 0u) {
+		Log::error("Local memory argument %u of kernel %s needs a size", index, hostKernel->name.c_str());
+		return false;
+	}
+	arg.resize(size);
+	if (!local) {
+		memcpy(arg.data(), data, size);
+	}
+	hostKernel->argsSet[index] = true;
+	hostKernel->argsLocal[index] = local;
+	return true;
+}
+
+bool kernelRun(Id kernel, const glm::ivec3& workSize, int workDim, bool blocking) {
+	if (kernel == InvalidId) {
+		Log::error("Given kernel handle is invalid");
+		return false;
+	}
+	core_assert_always(workDim > 0);
+	core_assert_always(workDim <= 3);
+	core_trace_scoped(ComputeKernelRun);
+	_priv::HostKernelObject* hostKernel = (_priv::HostKernelObject*)kernel;
+	const uint32_t arguments = hostKernel->entry.arguments;
+	std::vector<HostKernelArg> args(arguments);
+	std::vector<uint32_t> localArgs;
+	{
+		std::unique_lock lock(_priv::_ctx.mutex);
+		for (uint32_t i = 0u; i < arguments; ++i) {
+			if (!hostKernel->argsSet[i]) {
+				Log::error("Argument %u of kernel %s is not set", i, hostKernel->name.c_str());
+				return false;
+			}
+			const std::vector<uint8_t>& arg = hostKernel->args[i];
+			args[i].value = arg.data();
+			args[i].size = arg.size();
+			if (hostKernel->argsLocal[i]) {
+				localArgs.push_back(i);
+				continue;
+			}
+			if (arg.size() != sizeof(Id)) {
+				continue;
+			}
+			Id id;
+			memcpy(&id, arg.data(), sizeof(id));
+			if (_priv::_ctx.buffers.find(id) != _priv::_ctx.buffers.end()) {
+				args[i].buffer = ((_priv::HostBuffer*)id)->data.data();
+			}
+		}
+	}
+
+	HostWorkRange range;
+	range.workDim = workDim;
+	for (int i = 0; i < workDim; ++i) {
+		if (workSize[i] <= 0) {
+			return true;
+		}
+		range.globalSize[i] = workSize[i];
+	}
+	range.end = range.globalSize;
+
+	// split the outermost dimension into tiles for the workers
+	const int dim = workDim - 1;
+	const int extent = range.globalSize[dim];
+	const int workItems = range.globalSize.x * range.globalSize.y * range.globalSize.z;
+	const int maxTasks = _priv::_ctx.threadPool ? (int)_priv::_ctx.threadPool->size() * 4 : 1;
+	const int tasks = core_min(extent, core_min(maxTasks, core_max(1, workItems / _priv::MinWorkItemsPerTask)));
+	const HostKernel func = hostKernel->entry.func;
+	if (tasks <= 1) {
+		_priv::runTile(func, args, localArgs, range);
+		return true;
+	}
+
+	std::vector<std::future<void>> futures;
+	futures.reserve(tasks);
+	for (int i = 0; i < tasks; ++i) {
+		HostWorkRange tile = range;
+		tile.begin[dim] = (int)((int64_t)extent * i / tasks);
+		tile.end[dim] = (int)((int64_t)extent * (i + 1) / tasks);
+		std::future<void> future = _priv::_ctx.threadPool->enqueue([func, &args, &localArgs, tile] () {
+			core_trace_scoped(ComputeKernelTile);
+			_priv::runTile(func, args, localArgs, tile);
+		});
+		if (!future.valid()) {
+			// the pool is already shut down
+			_priv::runTile(func, args, localArgs, tile);
+			continue;
+		}
+		futures.push_back(std::move(future));
+	}
+	for (std::future<void>& future : futures) {
+		future.wait();
+	}
+	return true;
+}
+
+bool finish() {
+	// the kernels are always executed before kernelRun() returns
+	return supported();
+}
+
+bool supported() {
+	return (bool)_priv::_ctx.threadPool;
+}
+
+bool init() {
+	if (supported()) {
+		return true;
+	}
+	_priv::_ctx.threadPool = std::make_unique<core::ThreadPool>(core::cpus(), "Compute");
+	_priv::_ctx.threadPool->init();
+	Log::info("Use the host backend for compute with %i threads", (int)_priv::_ctx.threadPool->size());
+	return true;
+}
+
+void shutdown() {
+	if (!supported()) {
+		return;
+	}
+	_priv::_ctx.threadPool->shutdown(true);
+	_priv::_ctx.threadPool.reset();
+}
+
+bool hasFeature(Feature f) {
+	return false;
+}
+
+}
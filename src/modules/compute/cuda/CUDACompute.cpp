@@ -96,6 +96,11 @@ bool kernelRun(Id kernel, const glm::ivec3& workSize, int workDim, bool blocking
 	return false;
 }
 
+bool registerHostKernel(Id program, const char *name, HostKernel kernel, uint32_t arguments) {
+	// the kernels are compiled from the program source
+	return false;
+}
+
 Id createKernel(Id program, const char *name) {
 	return InvalidId;
 }
@@ -7,11 +7,25 @@
 
 namespace compute {
 
+/**
+ * @brief Uses the local memory of the work group as scratch memory for every work item
+ */
+static void localMemoryKernel(const HostKernelArg* args, const HostWorkRange& range) {
+	int32_t* scratch = host::buffer<int32_t>(args[0]);
+	int32_t* out = host::buffer<int32_t>(args[1]);
+	host::forEachWorkItem(range, [&] () {
+		const int x = host::workItem.globalId.x;
+		scratch[x % 16] = x;
+		out[x] = scratch[x % 16] * 2;
+	});
+}
+
 class ComputeShaderTest: public core::AbstractTest {
 private:
 	using Super = core::AbstractTest;
 protected:
 	bool _supported = false;
+	compute::TestShader _shader;
 public:
 	void SetUp() override {
 		Super::SetUp();
@@ -22,6 +36,8 @@ public:
 	}
 
 	void TearDown() override {
+		// the kernels and buffers of the shader must be released before the compute context
+		_shader.shutdown();
 		compute::shutdown();
 		Super::TearDown();
 	}
@@ -44,11 +60,10 @@ TEST_F(ComputeShaderTest, testExecuteExample) {
 	if (!_supported) {
 		return;
 	}
-	compute::TestShader shader;
-	ASSERT_TRUE(shader.setup());
+	ASSERT_TRUE(_shader.setup());
 	const std::vector<int8_t> foo { '1', '2', '3', '4', '5', '6' };
 	std::vector<int8_t> foo2(foo.size(), '0');
-	ASSERT_TRUE(shader.example(foo, foo2, glm::ivec1(foo.size())));
+	ASSERT_TRUE(_shader.example(foo, foo2, glm::ivec1(foo.size())));
 	ASSERT_EQ(foo, foo2);
 }
 
@@ -56,11 +71,10 @@ TEST_F(ComputeShaderTest, testExecuteExample2) {
 	if (!_supported) {
 		return;
 	}
-	compute::TestShader shader;
-	ASSERT_TRUE(shader.setup());
+	ASSERT_TRUE(_shader.setup());
 	const std::vector<int8_t> foo { '1', '2', '3', '4', '5', '6', '7', '8', '9', '0' };
 	std::vector<int8_t> foo2(foo.size(), '0');
-	ASSERT_TRUE(shader.example2(foo, foo2, 42, glm::ivec1(foo.size())));
+	ASSERT_TRUE(_shader.example2(foo, foo2, 42, glm::ivec1(foo.size())));
 	EXPECT_EQ(foo, foo2);
 }
 
@@ -68,12 +82,11 @@ TEST_F(ComputeShaderTest, testExecuteExampleBig) {
 	if (!_supported) {
 		return;
 	}
-	compute::TestShader shader;
-	ASSERT_TRUE(shader.setup());
+	ASSERT_TRUE(_shader.setup());
 	constexpr int size = 10000;
 	std::vector<int8_t> source(size, 'a');
 	std::vector<int8_t> target(size, ' ');
-	ASSERT_TRUE(shader.example(source, target, glm::ivec1(source.size())));
+	ASSERT_TRUE(_shader.example(source, target, glm::ivec1(source.size())));
 	EXPECT_EQ(source, target);
 }
 
@@ -81,12 +94,11 @@ TEST_F(ComputeShaderTest, testExecuteExampleVectorAddFloat3NoPointer) {
 	if (!_supported) {
 		return;
 	}
-	compute::TestShader shader;
-	ASSERT_TRUE(shader.setup());
+	ASSERT_TRUE(_shader.setup());
 	const glm::vec3 A(0.0f, 1.0f, 2.0f);
 	const glm::vec3 B(0.0f, 2.0f, 4.0f);
 	glm::vec3 C(0.0f);
-	ASSERT_TRUE(shader.exampleVectorAddFloat3NoPointer(A, B, C, glm::ivec1(3)));
+	ASSERT_TRUE(_shader.exampleVectorAddFloat3NoPointer(A, B, C, glm::ivec1(3)));
 #if 0
 	// TODO: this kernel is a nop
 	EXPECT_FLOAT_EQ(C.x, 0.0f);
@@ -99,14 +111,14 @@ TEST_F(ComputeShaderTest, testExecuteExampleVectorAddFloat3) {
 	if (!_supported) {
 		return;
 	}
-	compute::TestShader shader;
-	ASSERT_TRUE(shader.setup());
-	const std::vector<glm::vec3> A {glm::vec3{0.0f, 1.0f, 2.0f}, glm::vec3{0.0f, 1.0f, 2.0f}};
-	const std::vector<glm::vec3> B {glm::vec3{0.0f, 2.0f, 4.0f}, glm::vec3{0.0f, 2.0f, 4.0f}};
-	std::vector<glm::vec3> C(2);
-	ASSERT_TRUE(shader.exampleVectorAddFloat3(A, B, C, glm::ivec1(3)));
+	ASSERT_TRUE(_shader.setup());
+	const std::vector<glm::vec3> A {glm::vec3{0.0f, 1.0f, 2.0f}, glm::vec3{0.0f, 1.0f, 2.0f}, glm::vec3{1.0f, 2.0f, 3.0f}};
+	const std::vector<glm::vec3> B {glm::vec3{0.0f, 2.0f, 4.0f}, glm::vec3{0.0f, 2.0f, 4.0f}, glm::vec3{1.0f, 2.0f, 3.0f}};
+	std::vector<glm::vec3> C(A.size());
+	ASSERT_TRUE(_shader.exampleVectorAddFloat3(A, B, C, glm::ivec1(C.size())));
 	ASSERT_FLOAT_EQ(C[0][0], 0.0f);
-	ASSERT_FLOAT_EQ(C[2][1], 6.0f);
+	ASSERT_FLOAT_EQ(C[1][1], 3.0f);
+	ASSERT_FLOAT_EQ(C[2][2], 6.0f);
 }
 
 // just for comparing runtimes
@@ -123,8 +135,7 @@ TEST_F(ComputeShaderTest, testExecuteVectorAdd) {
 	if (!_supported) {
 		return;
 	}
-	compute::TestShader shader;
-	ASSERT_TRUE(shader.setup());
+	ASSERT_TRUE(_shader.setup());
 	constexpr int size = 1000;
 	ASSERT_GT(size, 2);
 	constexpr int initA = 1;
@@ -132,7 +143,7 @@ TEST_F(ComputeShaderTest, testExecuteVectorAdd) {
 	std::vector<int> a(size, initA);
 	std::vector<int> b(size, initB);
 	std::vector<int> c(size, 0);
-	ASSERT_TRUE(shader.exampleVectorAddInt(a, b, c, glm::ivec1(size)));
+	ASSERT_TRUE(_shader.exampleVectorAddInt(a, b, c, glm::ivec1(size)));
 	for (int i = 0; i < size; ++i) {
 		SCOPED_TRACE(core::string::format("index: %i", i));
 		EXPECT_EQ(c[i], initA + initB);
@@ -157,4 +168,31 @@ TEST_F(ComputeShaderTest, testExecuteVectorAddNonOpenCL) {
 	}
 }
 
+TEST_F(ComputeShaderTest, testHostKernelLocalMemory) {
+	if (!_supported) {
+		return;
+	}
+	Id program = compute::createProgram("");
+	ASSERT_NE(InvalidId, program);
+	if (!compute::registerHostKernel(program, "localMemory", localMemoryKernel, 2)) {
+		compute::deleteProgram(program);
+		return;
+	}
+	Id kernel = compute::createKernel(program, "localMemory");
+	ASSERT_NE(InvalidId, kernel);
+	std::vector<int32_t> out(4096, 0);
+	Id buffer = compute::createBuffer(BufferFlag::ReadWrite, out.size() * sizeof(int32_t), nullptr);
+	EXPECT_FALSE(compute::kernelArg(kernel, 0, 0u, nullptr)) << "Local memory needs a size";
+	EXPECT_TRUE(compute::kernelArg(kernel, 0, 16u * sizeof(int32_t), nullptr));
+	EXPECT_TRUE(compute::kernelArg(kernel, 1, buffer));
+	EXPECT_TRUE(compute::kernelRun(kernel, glm::ivec3((int)out.size(), 1, 1), 1));
+	EXPECT_TRUE(compute::readBuffer(buffer, out.size() * sizeof(int32_t), out.data()));
+	for (size_t i = 0; i < out.size(); ++i) {
+		ASSERT_EQ((int32_t)i * 2, out[i]) << "Unexpected value at " << i;
+	}
+	compute::deleteBuffer(buffer);
+	compute::deleteKernel(kernel);
+	compute::deleteProgram(program);
+}
+
 }
@@ -29,16 +29,19 @@ void Cooldown::reset() {
 }
 
 void Cooldown::expire() {
+	// reset() clears the callback
+	const CooldownCallback callback = _callback;
 	reset();
-	if (_callback) {
-		_callback(CallbackType::Expired);
+	if (callback) {
+		callback(CallbackType::Expired);
 	}
 }
 
 void Cooldown::cancel() {
+	const CooldownCallback callback = _callback;
 	reset();
-	if (_callback) {
-		_callback(CallbackType::Canceled);
+	if (callback) {
+		callback(CallbackType::Canceled);
 	}
 }
 
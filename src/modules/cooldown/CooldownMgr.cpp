@@ -8,8 +8,64 @@
 
 namespace cooldown {
 
-CooldownMgr::CooldownMgr(const core::TimeProviderPtr& timeProvider, const cooldown::CooldownProviderPtr& cooldownProvider) :
-		_timeProvider(timeProvider), _cooldownProvider(cooldownProvider), _lock("CooldownMgr") {
+CooldownMgr::CooldownMgr(const core::TimeProviderPtr& timeProvider, const cooldown::CooldownProviderPtr& cooldownProvider,
+		const core::TimerWheelPtr& timerWheel) :
+		_timeProvider(timeProvider), _cooldownProvider(cooldownProvider), _timerWheel(timerWheel), _lock("CooldownMgr") {
+}
+
+CooldownMgr::~CooldownMgr() {
+	CooldownMgr::shutdown();
+}
+
+void CooldownMgr::shutdown() {
+	core::ScopedWriteLock lock(_lock);
+	for (const auto& e : _timers) {
+		_timerWheel->cancel(e.second);
+	}
+	_timers.clear();
+}
+
+void CooldownMgr::schedule(const CooldownPtr& cooldown) {
+	unschedule(cooldown->type());
+	const uint64_t expireMillis = cooldown->startMillis() + cooldown->duration();
+	_timers[cooldown->type()] = _timerWheel->add(expireMillis, onExpired, this, (uint64_t)cooldown->type());
+}
+
+void CooldownMgr::unschedule(Type type) {
+	auto i = _timers.find(type);
+	if (i == _timers.end()) {
+		return;
+	}
+	_timerWheel->cancel(i->second);
+	_timers.erase(i);
+}
+
+void CooldownMgr::onExpired(const core::TimerWheel::Timer* timers, size_t amount) {
+	for (size_t i = 0; i < amount; ++i) {
+		CooldownMgr* mgr = (CooldownMgr*)timers[i].target;
+		mgr->expire((Type)timers[i].payload, timers[i].id);
+	}
+}
+
+void CooldownMgr::expire(Type type, core::TimerWheel::TimerId id) {
+	CooldownPtr cooldown;
+	{
+		core::ScopedWriteLock lock(_lock);
+		auto i = _timers.find(type);
+		// the cooldown was canceled or triggered again in the meantime
+		if (i == _timers.end() || i->second != id) {
+			return;
+		}
+		_timers.erase(i);
+		auto c = _cooldowns.find(type);
+		if (c == _cooldowns.end()) {
+			return;
+		}
+		cooldown = c->second;
+	}
+	Log::debug("Cooldown of type %i has just expired at %li",
+			std::enum_value(type), _timeProvider->tickMillis());
+	cooldown->expire();
 }
 
 CooldownPtr CooldownMgr::createCooldown(Type type, long startMillis) const {
@@ -35,7 +91,7 @@ CooldownTriggerState CooldownMgr::triggerCooldown(Type type, CooldownCallback ca
 		return CooldownTriggerState::ALREADY_RUNNING;
 	}
 	cooldown->start(callback);
-	_queue.push(cooldown);
+	schedule(cooldown);
 	Log::debug("Triggered the cooldown of type %i (expires in %lims, started at %li)",
 			std::enum_value(type), cooldown->duration(), cooldown->startMillis());
 	return CooldownTriggerState::SUCCESS;
@@ -59,6 +115,10 @@ bool CooldownMgr::resetCooldown(Type type) {
 	if (!c) {
 		return false;
 	}
+	{
+		core::ScopedWriteLock lock(_lock);
+		unschedule(type);
+	}
 	c->reset();
 	return true;
 }
@@ -68,6 +128,10 @@ bool CooldownMgr::cancelCooldown(Type type) {
 	if (!c) {
 		return false;
 	}
+	{
+		core::ScopedWriteLock lock(_lock);
+		unschedule(type);
+	}
 	c->cancel();
 	return true;
 }
@@ -83,25 +147,4 @@ bool CooldownMgr::isCooldown(Type type) {
 	return true;
 }
 
-void CooldownMgr::update() {
-	for (;;) {
-		_lock.lockRead();
-		if (_queue.empty()) {
-			_lock.unlockRead();
-			break;
-		}
-		CooldownPtr cooldown = _queue.top();
-		_lock.unlockRead();
-		if (cooldown->running()) {
-			break;
-		}
-
-		_lock.lockWrite();
-		_queue.pop();
-		_lock.unlockWrite();
-		Log::debug("Cooldown of type %i has just expired at %li",
-				std::enum_value(cooldown->type()), _timeProvider->tickMillis());
-		cooldown->expire();
-	}
-}
 }
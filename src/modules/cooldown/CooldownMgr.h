@@ -8,39 +8,35 @@
 #include "Cooldown.h"
 #include "core/IComponent.h"
 #include "core/TimeProvider.h"
-#include "core/ReadWriteLock.h"
+#include "core/TimerWheel.h"
 #include "CooldownProvider.h"
 
 #include <memory>
 #include <unordered_map>
-#include <queue>
 #include <functional>
-#include <vector>
 
 namespace cooldown {
 
 /**
  * @brief Cooldown manager that handles cooldowns for one entity
+ *
+ * The running cooldowns are expired by the shared @c core::TimerWheel - there is no per entity polling.
+ * @note The manager must not be destroyed while the timer wheel is executing its callbacks.
  * @ingroup Cooldowns
  */
 class CooldownMgr: public core::IComponent {
 protected:
 	core::TimeProviderPtr _timeProvider;
 	cooldown::CooldownProviderPtr _cooldownProvider;
+	core::TimerWheelPtr _timerWheel;
 	core::ReadWriteLock _lock;
 
-	struct CooldownComparatorLess {
-		inline bool operator()(const CooldownPtr& x, const CooldownPtr& y) const {
-			return std::less<Cooldown>()(*x.get(), *y.get());
-		}
-	};
-
-	typedef std::priority_queue<CooldownPtr, std::vector<CooldownPtr>, CooldownComparatorLess> CooldownQueue;
+	typedef std::unordered_map<Type, core::TimerWheel::TimerId, network::EnumHash<Type> > Timers;
 	/**
-	 * @brief Running cooldowns - sorted by expire time. There can only be one cooldown of the same
+	 * @brief The expire timers of the running cooldowns. There can only be one cooldown of the same
 	 * type at the same time.
 	 */
-	CooldownQueue _queue;
+	Timers _timers;
 
 	typedef std::unordered_map<Type, CooldownPtr, network::EnumHash<Type> > Cooldowns;
 	/**
@@ -55,9 +51,24 @@ protected:
 	 * If this is less than @c 0 the @c TimeProvider will be used to resolve the time
 	 */
 	CooldownPtr createCooldown(Type type, long startMillis = -1l) const;
+
+	/**
+	 * @brief Adds the expire timer for the given running cooldown
+	 * @note The write lock must be held
+	 */
+	void schedule(const CooldownPtr& cooldown);
+	/**
+	 * @brief Removes the expire timer of the given cooldown type
+	 * @note The write lock must be held
+	 */
+	void unschedule(Type type);
+
+	void expire(Type type, core::TimerWheel::TimerId id);
+	static void onExpired(const core::TimerWheel::Timer* timers, size_t amount);
 public:
-	CooldownMgr(const core::TimeProviderPtr& timeProvider, const cooldown::CooldownProviderPtr& cooldownProvider);
-	virtual ~CooldownMgr() {}
+	CooldownMgr(const core::TimeProviderPtr& timeProvider, const cooldown::CooldownProviderPtr& cooldownProvider,
+			const core::TimerWheelPtr& timerWheel);
+	virtual ~CooldownMgr();
 
 	/**
 	 * @brief Tries to trigger the specified cooldown for the given entity
@@ -89,13 +100,10 @@ public:
 		return true;
 	}
 
-	virtual void shutdown() override {
-	}
-
 	/**
-	 * @brief Update cooldown states
+	 * @brief Removes the expire timers of all running cooldowns
 	 */
-	void update();
+	virtual void shutdown() override;
 };
 
 typedef std::shared_ptr<CooldownMgr> CooldownMgrPtr;
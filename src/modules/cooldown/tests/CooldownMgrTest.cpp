@@ -14,12 +14,18 @@ class CooldownMgrTest : public core::AbstractTest {
 protected:
 	core::TimeProviderPtr _timeProvider;
 	cooldown::CooldownProviderPtr _cooldownProvider;
+	core::TimerWheelPtr _timerWheel;
 	CooldownMgr _mgr;
 public:
 	CooldownMgrTest() :
 		_timeProvider(std::make_shared<core::TimeProvider>()),
 		_cooldownProvider(std::make_shared<cooldown::CooldownProvider>()),
-		_mgr(_timeProvider, _cooldownProvider) {
+		_timerWheel(std::make_shared<core::TimerWheel>()),
+		_mgr(_timeProvider, _cooldownProvider, _timerWheel) {
+	}
+
+	void update() {
+		_timerWheel->update(_timeProvider->tickMillis());
 	}
 
 	void SetUp() override {
@@ -46,13 +52,13 @@ TEST_F(CooldownMgrTest, testExpireCooldown) {
 	ASSERT_TRUE(_mgr.cooldown(Type::LOGOUT)->started()) << "Cooldown is not started";
 	ASSERT_TRUE(_mgr.cooldown(Type::LOGOUT)->running()) << "Cooldown is not running";
 	ASSERT_TRUE(_mgr.isCooldown(Type::LOGOUT));
-	_mgr.update();
+	update();
 	ASSERT_TRUE(_mgr.cooldown(Type::LOGOUT)->started()) << "Cooldown is not started";
 	ASSERT_TRUE(_mgr.cooldown(Type::LOGOUT)->running()) << "Cooldown is not running";
 	ASSERT_TRUE(_mgr.isCooldown(Type::LOGOUT));
 	_timeProvider->update(_mgr.defaultDuration(Type::LOGOUT));
 	ASSERT_FALSE(_mgr.isCooldown(Type::LOGOUT));
-	_mgr.update();
+	update();
 	ASSERT_FALSE(_mgr.cooldown(Type::LOGOUT)->running()) << "Cooldown is still running";
 	ASSERT_FALSE(_mgr.isCooldown(Type::LOGOUT));
 	ASSERT_TRUE(_mgr.resetCooldown(Type::LOGOUT)) << "Failed to reset the logout cooldown";
@@ -64,7 +70,7 @@ TEST_F(CooldownMgrTest, testMultipleCooldown) {
 	ASSERT_EQ(CooldownTriggerState::SUCCESS, _mgr.triggerCooldown(Type::INCREASE)) << "Increase cooldown couldn't get triggered";
 	ASSERT_TRUE(_mgr.isCooldown(Type::LOGOUT));
 	ASSERT_TRUE(_mgr.isCooldown(Type::INCREASE));
-	_mgr.update();
+	update();
 	ASSERT_TRUE(_mgr.isCooldown(Type::LOGOUT));
 	ASSERT_TRUE(_mgr.isCooldown(Type::INCREASE));
 
@@ -73,17 +79,52 @@ TEST_F(CooldownMgrTest, testMultipleCooldown) {
 
 	if (logoutDuration > increaseDuration) {
 		_timeProvider->update(increaseDuration);
-		_mgr.update();
+		update();
 		ASSERT_TRUE(_mgr.isCooldown(Type::LOGOUT));
 		ASSERT_FALSE(_mgr.isCooldown(Type::INCREASE));
 	} else {
 		_timeProvider->update(logoutDuration);
-		_mgr.update();
+		update();
 		ASSERT_TRUE(_mgr.isCooldown(Type::INCREASE));
 		ASSERT_FALSE(_mgr.isCooldown(Type::LOGOUT));
 	}
 }
 
+TEST_F(CooldownMgrTest, testExpireCallback) {
+	_timeProvider->update(0ul);
+	update();
+	int expired = 0;
+	ASSERT_EQ(CooldownTriggerState::SUCCESS, _mgr.triggerCooldown(Type::LOGOUT, [&] (CallbackType type) {
+		if (type == CallbackType::Expired) {
+			++expired;
+		}
+	}));
+	_timeProvider->update(_mgr.defaultDuration(Type::LOGOUT) - 1ul);
+	update();
+	EXPECT_EQ(0, expired);
+	_timeProvider->update(_mgr.defaultDuration(Type::LOGOUT));
+	update();
+	EXPECT_EQ(1, expired);
+	EXPECT_EQ(0u, _timerWheel->stats().active);
+}
+
+TEST_F(CooldownMgrTest, testCancelRemovesTimer) {
+	_timeProvider->update(0ul);
+	update();
+	int expired = 0;
+	ASSERT_EQ(CooldownTriggerState::SUCCESS, _mgr.triggerCooldown(Type::LOGOUT, [&] (CallbackType type) {
+		if (type == CallbackType::Expired) {
+			++expired;
+		}
+	}));
+	EXPECT_EQ(1u, _timerWheel->stats().active);
+	ASSERT_TRUE(_mgr.cancelCooldown(Type::LOGOUT));
+	EXPECT_EQ(0u, _timerWheel->stats().active);
+	_timeProvider->update(_mgr.defaultDuration(Type::LOGOUT));
+	update();
+	EXPECT_EQ(0, expired);
+}
+
 TEST_F(CooldownMgrTest, testTriggerCooldownTwice) {
 	ASSERT_EQ(CooldownTriggerState::SUCCESS, _mgr.triggerCooldown(Type::LOGOUT)) << "Logout cooldown couldn't get triggered";
 	ASSERT_EQ(CooldownTriggerState::ALREADY_RUNNING, _mgr.triggerCooldown(Type::LOGOUT)) << "Logout cooldown was triggered twice";
@@ -105,6 +105,13 @@ void App::traceEndFrame(const char *threadName) {
 }
 
 void App::onFrame() {
+	if (_traceRecorder.update()) {
+		if (_filesystem->write(_traceCaptureFile, _traceRecorder.toJSON())) {
+			Log::info("Wrote trace capture to %s", _traceCaptureFile.c_str());
+		} else {
+			Log::warn("Failed to write trace capture to %s", _traceCaptureFile.c_str());
+		}
+	}
 	core_trace_begin_frame();
 	if (_nextState != AppState::InvalidAppState && _nextState != _curState) {
 		if (_blockers[(int)_nextState]) {
@@ -223,6 +230,18 @@ AppState App::onConstruct() {
 		}
 	}).setHelp("Toggle application tracing via statsd");
 
+	core::Command::registerCommand("core_trace_capture", [&] (const core::CmdArgs& args) {
+		if (_traceRecorder.capturing()) {
+			_traceRecorder.stop();
+			return;
+		}
+		const int frames = args.empty() ? 100 : core::string::toInt(args[0]);
+		if (args.size() > 1) {
+			_traceCaptureFile = args[1];
+		}
+		_traceRecorder.requestCapture(frames);
+	}).setHelp("Capture the trace scopes of the given amount of frames (0 until called again) into a chrome trace json file - usage: [frames] [file]");
+
 	AppCommand::init(_timeProvider);
 
 	for (int i = 0; i < _argc; ++i) {
@@ -7,6 +7,7 @@
 #include "Common.h"
 #include "metric/Metric.h"
 #include "Trace.h"
+#include "TraceRecorder.h"
 #include "EventBus.h"
 #include "TimeProvider.h"
 #include "ThreadPool.h"
@@ -119,6 +120,9 @@ protected:
 		uint64_t nanos;
 	};
 	static thread_local std::stack<TraceData> _traceData;
+	core::TraceRecorder _traceRecorder;
+	// the file the next finished trace capture is written to
+	std::string _traceCaptureFile = "trace.json";
 
 	bool toggleTrace();
 
@@ -258,6 +262,11 @@ public:
 
 	core::ThreadPool& threadPool();
 
+	/**
+	 * @brief Records the trace scopes of all threads - see the @c core_trace_capture command
+	 */
+	core::TraceRecorder& traceRecorder();
+
 	/**
 	 * @brief Access to the global TimeProvider
 	 */
@@ -324,6 +333,10 @@ inline core::ThreadPool& App::threadPool() {
 	return _threadPool;
 }
 
+inline core::TraceRecorder& App::traceRecorder() {
+	return _traceRecorder;
+}
+
 inline core::EventBusPtr App::eventBus() const {
 	return _eventBus;
 }
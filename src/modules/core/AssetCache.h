@@ -0,0 +1,276 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "ThreadPool.h"
+#include "Trace.h"
+#include <functional>
+#include <future>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace core {
+
+/**
+ * @brief Thread safe cache for immutable assets that are loaded by their name
+ *
+ * Concurrent requests for the same key are coalesced - the asset is only loaded once, every other
+ * request waits for that load (single flight). The assets are handed out as shared pointers, an evicted
+ * asset stays alive as long as somebody still references it.
+ *
+ * The least recently used assets are evicted if the size of all cached assets exceeds the memory budget.
+ * Assets that are still loading are never evicted.
+ *
+ * The assets are usually identified by their name - but every hashable key type can be used.
+ */
+template<class T, class KEY = std::string, class HASH = std::hash<KEY>>
+class AssetCache {
+public:
+	using AssetPtr = std::shared_ptr<const T>;
+	using AssetFuture = std::shared_future<AssetPtr>;
+	/**
+	 * @brief Loads the asset for the given key - returns @c nullptr on failure
+	 * @note Called without holding any lock of the cache - maybe from a worker thread
+	 */
+	using Loader = std::function<std::shared_ptr<T>(const KEY& key)>;
+	/**
+	 * @brief The amount of bytes the asset occupies
+	 */
+	using Sizer = std::function<size_t(const T& asset)>;
+
+	struct Stats {
+		uint32_t hits = 0u;
+		uint32_t misses = 0u;
+		// requests that waited for a load that was already running
+		uint32_t coalesced = 0u;
+		uint32_t evictions = 0u;
+	};
+private:
+	struct Entry {
+		AssetFuture future;
+		// unique per load - an entry that was removed and loaded again is not touched by the old load
+		uint64_t id = 0u;
+		size_t size = 0u;
+		bool loaded = false;
+		typename std::list<KEY>::iterator lru;
+	};
+
+	mutable core_trace_mutex(std::mutex, _mutex);
+	std::unordered_map<KEY, Entry, HASH> _entries;
+	// most recently used first - only contains loaded entries
+	std::list<KEY> _lru;
+	size_t _memory = 0u;
+	size_t _memoryBudget;
+	uint64_t _nextId = 1u;
+	Stats _stats;
+	const Loader _loader;
+	const Sizer _sizer;
+	const bool _cacheFailures;
+	ThreadPool *_threadPool;
+
+	void evict() {
+		while (_memory > _memoryBudget && !_lru.empty()) {
+			auto i = _entries.find(_lru.back());
+			_memory -= i->second.size;
+			_lru.pop_back();
+			_entries.erase(i);
+			++_stats.evictions;
+		}
+	}
+
+	void erase(typename std::unordered_map<KEY, Entry, HASH>::iterator i) {
+		if (i->second.loaded) {
+			_memory -= i->second.size;
+			_lru.erase(i->second.lru);
+		}
+		_entries.erase(i);
+	}
+
+	void finish(const KEY& key, uint64_t id, std::promise<AssetPtr>& promise) {
+		core_trace_scoped(AssetCacheLoad);
+		std::shared_ptr<T> asset = _loader(key);
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			auto i = _entries.find(key);
+			if (i != _entries.end() && i->second.id == id) {
+				if (!asset && !_cacheFailures) {
+					_entries.erase(i);
+				} else {
+					Entry& entry = i->second;
+					entry.size = asset ? _sizer(*asset) : 0u;
+					entry.loaded = true;
+					_lru.push_front(key);
+					entry.lru = _lru.begin();
+					_memory += entry.size;
+					evict();
+				}
+			}
+		}
+		promise.set_value(std::move(asset));
+	}
+
+	/**
+	 * @param[out] promise Set if the caller has to load the asset
+	 */
+	AssetFuture lookup(const KEY& key, std::shared_ptr<std::promise<AssetPtr>>& promise, uint64_t& id) {
+		std::unique_lock<std::mutex> lock(_mutex);
+		auto i = _entries.find(key);
+		if (i != _entries.end()) {
+			Entry& entry = i->second;
+			if (entry.loaded) {
+				_lru.splice(_lru.begin(), _lru, entry.lru);
+				++_stats.hits;
+			} else {
+				++_stats.coalesced;
+			}
+			return entry.future;
+		}
+		++_stats.misses;
+		promise = std::make_shared<std::promise<AssetPtr>>();
+		Entry& entry = _entries[key];
+		entry.future = promise->get_future().share();
+		entry.id = id = _nextId++;
+		return entry.future;
+	}
+public:
+	/**
+	 * @param[in] threadPool Used by @c getAsync() - if @c nullptr the asynchronous loads are performed on the
+	 * calling thread
+	 * @param[in] cacheFailures If @c true a failed load is cached, too - otherwise the next request tries again
+	 */
+	AssetCache(const Loader& loader, const Sizer& sizer, ThreadPool* threadPool = nullptr,
+			size_t memoryBudget = std::numeric_limits<size_t>::max(), bool cacheFailures = false) :
+			_memoryBudget(memoryBudget), _loader(loader), _sizer(sizer), _cacheFailures(cacheFailures), _threadPool(threadPool) {
+	}
+
+	/**
+	 * @brief Returns the cached asset or loads it on the calling thread. If the asset is already loading, this
+	 * blocks until the load finished.
+	 */
+	AssetPtr get(const KEY& key) {
+		std::shared_ptr<std::promise<AssetPtr>> promise;
+		uint64_t id = 0u;
+		const AssetFuture future = lookup(key, promise, id);
+		if (promise) {
+			finish(key, id, *promise);
+		}
+		return future.get();
+	}
+
+	/**
+	 * @brief Starts to load the asset on the thread pool if it isn't cached or loading yet
+	 */
+	AssetFuture getAsync(const KEY& key) {
+		std::shared_ptr<std::promise<AssetPtr>> promise;
+		uint64_t id = 0u;
+		const AssetFuture future = lookup(key, promise, id);
+		if (!promise) {
+			return future;
+		}
+		if (_threadPool != nullptr) {
+			std::future<void> queued = _threadPool->enqueue([this, key, id, promise] () {
+				finish(key, id, *promise);
+			});
+			if (queued.valid()) {
+				return future;
+			}
+		}
+		finish(key, id, *promise);
+		return future;
+	}
+
+	/**
+	 * @brief Loads the given assets in the background - a hint for assets that are going to be requested soon
+	 */
+	void prefetch(const std::vector<KEY>& keys) {
+		for (const KEY& key : keys) {
+			getAsync(key);
+		}
+	}
+
+	/**
+	 * @brief Replaces the cached asset for the given key
+	 */
+	void put(const KEY& key, const std::shared_ptr<T>& asset) {
+		std::promise<AssetPtr> promise;
+		promise.set_value(asset);
+		std::unique_lock<std::mutex> lock(_mutex);
+		auto i = _entries.find(key);
+		if (i != _entries.end()) {
+			erase(i);
+		}
+		Entry& entry = _entries[key];
+		entry.future = promise.get_future().share();
+		entry.id = _nextId++;
+		entry.size = asset ? _sizer(*asset) : 0u;
+		entry.loaded = true;
+		_lru.push_front(key);
+		entry.lru = _lru.begin();
+		_memory += entry.size;
+		evict();
+	}
+
+	/**
+	 * @brief Removes the asset from the cache - a running load is detached from the cache
+	 */
+	bool remove(const KEY& key) {
+		std::unique_lock<std::mutex> lock(_mutex);
+		auto i = _entries.find(key);
+		if (i == _entries.end()) {
+			return false;
+		}
+		erase(i);
+		return true;
+	}
+
+	void clear() {
+		std::unique_lock<std::mutex> lock(_mutex);
+		_entries.clear();
+		_lru.clear();
+		_memory = 0u;
+	}
+
+	void setMemoryBudget(size_t bytes) {
+		std::unique_lock<std::mutex> lock(_mutex);
+		_memoryBudget = bytes;
+		evict();
+	}
+
+	/**
+	 * @return The bytes of all cached assets
+	 */
+	size_t memoryUsage() const {
+		std::unique_lock<std::mutex> lock(_mutex);
+		return _memory;
+	}
+
+	size_t size() const {
+		std::unique_lock<std::mutex> lock(_mutex);
+		return _entries.size();
+	}
+
+	Stats stats() const {
+		std::unique_lock<std::mutex> lock(_mutex);
+		return _stats;
+	}
+
+	/**
+	 * @brief Visits all loaded assets - most recently used first
+	 */
+	void visit(const std::function<void(const KEY& key, const AssetPtr& asset, size_t size)>& func) const {
+		std::unique_lock<std::mutex> lock(_mutex);
+		for (const KEY& key : _lru) {
+			const Entry& entry = _entries.find(key)->second;
+			func(key, entry.future.get(), entry.size);
+		}
+	}
+};
+
+}
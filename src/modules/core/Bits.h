@@ -0,0 +1,43 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "Assert.h"
+#include <stdint.h>
+
+namespace core {
+
+/**
+ * @return The amount of set bits
+ */
+inline int bitCount(uint64_t bits) {
+#if defined(__clang__) || defined(__GNUC__)
+	return __builtin_popcountll(bits);
+#else
+	int n = 0;
+	for (; bits != 0u; bits &= bits - 1u) {
+		++n;
+	}
+	return n;
+#endif
+}
+
+/**
+ * @return The index of the lowest set bit - the given value must not be @c 0
+ */
+inline int lowestBit(uint64_t bits) {
+	core_assert(bits != 0u);
+#if defined(__clang__) || defined(__GNUC__)
+	return __builtin_ctzll(bits);
+#else
+	int n = 0;
+	for (; (bits & 1u) == 0u; bits >>= 1) {
+		++n;
+	}
+	return n;
+#endif
+}
+
+}
@@ -54,6 +54,20 @@ constexpr const char *ServerHost = "sv_host";
 constexpr const char *ServerPort = "sv_port";
 constexpr const char *ServerMaxClients = "sv_maxclients";
 constexpr const char *ServerPostgresLib = "sv_postgreslib";
+// service the network on a dedicated thread and hand the messages over to the server loop
+constexpr const char *ServerNetworkThread = "sv_networkthread";
+// evaluate the batchable npc steerings of a zone in one simd pass after the behaviour tree tick
+constexpr const char *ServerBatchedMovement = "sv_batchedmovement";
+// bytes per peer per send scheduler tick - 0 sends everything immediately
+constexpr const char *ServerPeerBudget = "sv_peerbudget";
+// outgoing bandwidth of the server host in bytes per second - 0 is unlimited
+constexpr const char *ServerBandwidth = "sv_bandwidth";
+// ticks that take longer than this amount of millis are logged with the time spent in each phase
+constexpr const char *ServerTickBudget = "sv_tickbudget";
+// minimum millis between two world state broadcasts of the ai debug server
+constexpr const char *ServerAIDebugInterval = "sv_aidebuginterval";
+// unsent bytes an ai debug client may queue before it gets no further world states
+constexpr const char *ServerAIDebugMaxPending = "sv_aidebugmaxpending";
 
 constexpr const char *CoreMaxFPS = "core_maxfps";
 constexpr const char *CoreLogLevel = "core_loglevel";
@@ -0,0 +1,286 @@
+/**
+ * @file
+ */
+
+#include "TimerWheel.h"
+#include "Assert.h"
+#include "Bits.h"
+#include "Common.h"
+#include <algorithm>
+
+namespace core {
+
+TimerWheel::TimerWheel(uint64_t resolutionMillis) :
+		_resolutionMillis(resolutionMillis > 0u ? resolutionMillis : 1u) {
+	for (int i = 0; i < Levels * Slots; ++i) {
+		_buckets[i] = InvalidIndex;
+	}
+}
+
+uint32_t TimerWheel::node(TimerId id) const {
+	const uint32_t index = (uint32_t)(id & 0xFFFFFFFFu);
+	if (index >= _nodes.size()) {
+		return InvalidIndex;
+	}
+	if (_nodes[index].generation != (uint32_t)(id >> 32)) {
+		return InvalidIndex;
+	}
+	return index;
+}
+
+void TimerWheel::link(uint32_t index) {
+	Node& n = _nodes[index];
+	const uint64_t delta = n.expireTick - _tick;
+	int level = 0;
+	while (level < Levels - 1 && delta >= ((uint64_t)1 << (SlotBits * (level + 1)))) {
+		++level;
+	}
+	uint64_t slot;
+	if (level == Levels - 1 && delta >= ((uint64_t)1 << (SlotBits * Levels))) {
+		// beyond the range of the wheel - park it in the current slot of the highest level, this slot is
+		// reached last. The timer is placed again from there.
+		slot = (_tick >> (SlotBits * level)) & SlotMask;
+	} else {
+		slot = (n.expireTick >> (SlotBits * level)) & SlotMask;
+	}
+	const int bucket = level * Slots + (int)slot;
+	n.bucket = (int16_t)bucket;
+	n.prev = InvalidIndex;
+	n.next = _buckets[bucket];
+	if (n.next != InvalidIndex) {
+		_nodes[n.next].prev = index;
+	}
+	_buckets[bucket] = index;
+	_occupied[level] |= (uint64_t)1 << slot;
+}
+
+void TimerWheel::unlink(uint32_t index) {
+	Node& n = _nodes[index];
+	core_assert(n.bucket >= 0);
+	if (n.prev != InvalidIndex) {
+		_nodes[n.prev].next = n.next;
+	} else {
+		_buckets[n.bucket] = n.next;
+		if (n.next == InvalidIndex) {
+			_occupied[n.bucket / Slots] &= ~((uint64_t)1 << (n.bucket % Slots));
+		}
+	}
+	if (n.next != InvalidIndex) {
+		_nodes[n.next].prev = n.prev;
+	}
+	n.prev = n.next = InvalidIndex;
+	n.bucket = -1;
+}
+
+void TimerWheel::release(uint32_t index) {
+	Node& n = _nodes[index];
+	// old ids don't match anymore
+	++n.generation;
+	if (n.generation == 0u) {
+		n.generation = 1u;
+	}
+	n.callback = nullptr;
+	_freeNodes.push_back(index);
+	--_stats.active;
+}
+
+void TimerWheel::fire(uint32_t index) {
+	const Node& n = _nodes[index];
+	_fired.push_back(Fired{n.callback, n.timer});
+	release(index);
+}
+
+void TimerWheel::cascade(int level) {
+	const int bucket = level * Slots + (int)((_tick >> (SlotBits * level)) & SlotMask);
+	uint32_t index = _buckets[bucket];
+	_buckets[bucket] = InvalidIndex;
+	_occupied[level] &= ~((uint64_t)1 << (bucket % Slots));
+	while (index != InvalidIndex) {
+		const uint32_t next = _nodes[index].next;
+		Node& n = _nodes[index];
+		n.bucket = -1;
+		if (n.expireTick <= _tick) {
+			fire(index);
+		} else {
+			link(index);
+		}
+		index = next;
+	}
+}
+
+uint64_t TimerWheel::nextCascadeTick() const {
+	uint64_t next = UINT64_MAX;
+	for (int level = 1; level < Levels; ++level) {
+		const uint64_t bits = _occupied[level];
+		if (bits == 0u) {
+			continue;
+		}
+		const int shift = SlotBits * level;
+		const uint64_t current = _tick >> shift;
+		const int slot = (int)(current & SlotMask);
+		// the occupied slots after the current one - or the first occupied slot of the next revolution
+		const uint64_t upper = slot == Slots - 1 ? 0u : bits & ~(((uint64_t)2u << slot) - 1u);
+		uint64_t index = current & ~SlotMask;
+		if (upper != 0u) {
+			index += lowestBit(upper);
+		} else {
+			index += Slots + lowestBit(bits);
+		}
+		if (index < (UINT64_MAX >> shift)) {
+			next = core_min(next, index << shift);
+		}
+	}
+	return next;
+}
+
+void TimerWheel::advance(uint64_t targetTick) {
+	while (_tick < targetTick) {
+		if (_occupied[0] == 0u) {
+			// nothing to fire on the lowest level - jump to the next tick where an occupied slot
+			// of a higher level is cascaded or to the target tick
+			const uint64_t next = nextCascadeTick();
+			if (next > targetTick) {
+				_tick = targetTick;
+				break;
+			}
+			_tick = next;
+		} else {
+			++_tick;
+		}
+		if ((_tick & SlotMask) == 0u) {
+			// the highest level that wrapped around is cascaded first
+			int level = 1;
+			while (level < Levels - 1 && ((_tick >> (SlotBits * level)) & SlotMask) == 0u) {
+				++level;
+			}
+			for (; level >= 1; --level) {
+				cascade(level);
+			}
+		}
+		cascade(0);
+	}
+}
+
+TimerWheel::TimerId TimerWheel::add(uint64_t expireMillis, Callback callback, void* target, uint64_t payload) {
+	core_assert(callback != nullptr);
+	std::unique_lock lock(_mutex);
+	uint32_t index;
+	if (_freeNodes.empty()) {
+		index = (uint32_t)_nodes.size();
+		_nodes.emplace_back();
+	} else {
+		index = _freeNodes.back();
+		_freeNodes.pop_back();
+	}
+	Node& n = _nodes[index];
+	const TimerId id = timerId(index, n.generation);
+	n.timer = Timer{id, target, payload, expireMillis};
+	n.callback = callback;
+	// round up - a timer never fires too early
+	n.expireTick = (expireMillis + _resolutionMillis - 1u) / _resolutionMillis;
+	++_stats.active;
+	if (!_started || n.expireTick <= _tick) {
+		// the wheel doesn't know the current time before the first update
+		n.bucket = -1;
+		_expired.push_back(index);
+	} else {
+		link(index);
+	}
+	return id;
+}
+
+bool TimerWheel::cancel(TimerId id) {
+	std::unique_lock lock(_mutex);
+	const uint32_t index = node(id);
+	if (index == InvalidIndex || _nodes[index].callback == nullptr) {
+		return false;
+	}
+	if (_nodes[index].bucket >= 0) {
+		unlink(index);
+	} else {
+		// not yet linked - the entry in the expired list is skipped because the generation changes
+		_nodes[index].callback = nullptr;
+	}
+	release(index);
+	++_stats.canceled;
+	return true;
+}
+
+size_t TimerWheel::update(uint64_t nowMillis) {
+	core_trace_scoped(TimerWheelUpdate);
+	std::vector<Fired> fired;
+	{
+		std::unique_lock lock(_mutex);
+		const uint64_t nowTick = nowMillis / _resolutionMillis;
+		if (!_started) {
+			_started = true;
+			_tick = nowTick;
+		}
+		if (nowTick > _tick) {
+			advance(nowTick);
+		}
+		if (!_expired.empty()) {
+			std::vector<uint32_t> expired;
+			expired.swap(_expired);
+			for (uint32_t index : expired) {
+				Node& n = _nodes[index];
+				if (n.callback == nullptr || n.bucket >= 0) {
+					// canceled in the meantime
+					continue;
+				}
+				if (n.expireTick <= _tick) {
+					fire(index);
+				} else {
+					link(index);
+				}
+			}
+		}
+		_stats.fired += _fired.size();
+		fired.swap(_fired);
+	}
+	if (fired.empty()) {
+		return 0u;
+	}
+	// group by callback - the expire order within one callback is kept
+	std::stable_sort(fired.begin(), fired.end(), [] (const Fired& a, const Fired& b) {
+		return std::less<Callback>()(a.callback, b.callback);
+	});
+	std::vector<Timer> batch;
+	batch.reserve(fired.size());
+	size_t batches = 0u;
+	for (size_t i = 0u; i < fired.size();) {
+		const Callback callback = fired[i].callback;
+		batch.clear();
+		for (; i < fired.size() && fired[i].callback == callback; ++i) {
+			batch.push_back(fired[i].timer);
+		}
+		callback(batch.data(), batch.size());
+		++batches;
+	}
+	std::unique_lock lock(_mutex);
+	_stats.batches += batches;
+	return fired.size();
+}
+
+void TimerWheel::clear() {
+	std::unique_lock lock(_mutex);
+	for (uint32_t index = 0u; index < _nodes.size(); ++index) {
+		Node& n = _nodes[index];
+		if (n.callback == nullptr) {
+			continue;
+		}
+		if (n.bucket >= 0) {
+			unlink(index);
+		}
+		release(index);
+		++_stats.canceled;
+	}
+	_expired.clear();
+}
+
+TimerWheel::Stats TimerWheel::stats() const {
+	std::unique_lock lock(_mutex);
+	return _stats;
+}
+
+}
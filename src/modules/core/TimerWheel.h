@@ -0,0 +1,139 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "Trace.h"
+#include <stdint.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace core {
+
+/**
+ * @brief Hierarchical timing wheel for a lot of expirations (cooldowns, logouts, spawns, events)
+ *
+ * Each level has 64 slots, a slot of level @c n covers 64^n ticks. A timer is put into the level that
+ * matches the distance to its expire tick and is moved down one level whenever the lower level wraps around.
+ * Adding and canceling a timer is @c O(1) - advancing the wheel only touches the occupied slots of the elapsed
+ * ticks, empty stretches are skipped with the occupancy masks of the levels.
+ *
+ * The timers don't carry an allocated closure - each timer has a plain function pointer plus two values.
+ * All timers that expired in one @c update() call are handed over in batches - one call per callback function.
+ *
+ * @note Adding and canceling timers is thread safe, @c update() should only be called from one thread. The
+ * callbacks are executed in @c update() - without holding the lock, so they may add new timers.
+ */
+class TimerWheel {
+public:
+	typedef uint64_t TimerId;
+	static constexpr TimerId InvalidTimerId = 0u;
+
+	struct Timer {
+		TimerId id;
+		void* target;
+		uint64_t payload;
+		/** the millisecond timestamp that the timer was added for */
+		uint64_t expireMillis;
+	};
+
+	/**
+	 * @brief Gets all the expired timers that were added with this callback
+	 */
+	typedef void (*Callback)(const Timer* timers, size_t amount);
+
+	static constexpr int SlotBits = 6;
+	static constexpr int Slots = 1 << SlotBits;
+	static constexpr int Levels = 6;
+
+	struct Stats {
+		uint64_t active = 0u;
+		uint64_t fired = 0u;
+		uint64_t canceled = 0u;
+		uint64_t batches = 0u;
+	};
+
+private:
+	static constexpr uint32_t InvalidIndex = 0xFFFFFFFFu;
+	static constexpr uint64_t SlotMask = Slots - 1;
+
+	struct Node {
+		Timer timer;
+		Callback callback = nullptr;
+		uint64_t expireTick = 0u;
+		uint32_t prev = InvalidIndex;
+		uint32_t next = InvalidIndex;
+		uint32_t generation = 1u;
+		// level * Slots + slot or -1 if not linked into the wheel
+		int16_t bucket = -1;
+	};
+
+	struct Fired {
+		Callback callback;
+		Timer timer;
+	};
+
+	const uint64_t _resolutionMillis;
+	core_trace_mutex(mutable std::mutex, _mutex);
+	std::vector<Node> _nodes;
+	std::vector<uint32_t> _freeNodes;
+	uint32_t _buckets[Levels * Slots];
+	uint64_t _occupied[Levels] {};
+	uint64_t _tick = 0u;
+	bool _started = false;
+	// timers that were already expired when they were added - fired with the next update
+	std::vector<uint32_t> _expired;
+	std::vector<Fired> _fired;
+	Stats _stats;
+
+	static inline TimerId timerId(uint32_t index, uint32_t generation) {
+		return ((TimerId)generation << 32) | (TimerId)index;
+	}
+
+	uint32_t node(TimerId id) const;
+	void link(uint32_t index);
+	void unlink(uint32_t index);
+	void release(uint32_t index);
+	void fire(uint32_t index);
+	void cascade(int level);
+	uint64_t nextCascadeTick() const;
+	void advance(uint64_t targetTick);
+public:
+	/**
+	 * @param[in] resolutionMillis The duration of one tick of the lowest level
+	 */
+	TimerWheel(uint64_t resolutionMillis = 1u);
+
+	/**
+	 * @brief Adds a timer that expires at the given millisecond timestamp. Timestamps in the past expire
+	 * with the next @c update() call.
+	 * @param[in] target Passed to the callback - usually the instance that added the timer
+	 * @param[in] payload Passed to the callback
+	 * @return The id to cancel the timer - never @c InvalidTimerId
+	 */
+	TimerId add(uint64_t expireMillis, Callback callback, void* target, uint64_t payload = 0u);
+
+	/**
+	 * @return @c false if the timer already expired or was canceled
+	 */
+	bool cancel(TimerId id);
+
+	/**
+	 * @brief Executes the callbacks for all timers that expired until the given millisecond timestamp
+	 * @return The amount of expired timers
+	 */
+	size_t update(uint64_t nowMillis);
+
+	/**
+	 * @brief Cancels all timers
+	 */
+	void clear();
+
+	Stats stats() const;
+};
+
+typedef std::shared_ptr<TimerWheel> TimerWheelPtr;
+
+}
@@ -7,6 +7,7 @@
 #include "core/Log.h"
 #include "core/Common.h"
 #include "core/command/Command.h"
+#include <atomic>
 
 #ifdef USE_EMTRACE
 #include <emscripten/trace.h>
@@ -16,7 +17,7 @@ namespace core {
 
 namespace {
 
-static TraceCallback* _callback = nullptr;
+static std::atomic<TraceCallback*> _callback { nullptr };
 static thread_local const char* _threadName = "Unknown";
 
 }
@@ -53,9 +54,7 @@ TraceGLScoped::~TraceGLScoped() {
 }
 
 TraceCallback* traceSet(TraceCallback* callback) {
-	TraceCallback* old = _callback;
-	_callback = callback;
-	return old;
+	return _callback.exchange(callback);
 }
 
 void traceInit() {
@@ -77,8 +76,9 @@ void traceBeginFrame() {
 #ifdef USE_EMTRACE
 	emscripten_trace_record_frame_start();
 #else
-	if (_callback != nullptr) {
-		_callback->traceBeginFrame(_threadName);
+	TraceCallback* callback = _callback.load(std::memory_order_relaxed);
+	if (callback != nullptr) {
+		callback->traceBeginFrame(_threadName);
 	} else {
 		traceBegin("Frame");
 	}
@@ -89,8 +89,9 @@ void traceEndFrame() {
 #ifdef USE_EMTRACE
 	emscripten_trace_record_frame_end();
 #else
-	if (_callback != nullptr) {
-		_callback->traceEndFrame(_threadName);
+	TraceCallback* callback = _callback.load(std::memory_order_relaxed);
+	if (callback != nullptr) {
+		callback->traceEndFrame(_threadName);
 	} else {
 		traceEnd();
 	}
@@ -101,8 +102,9 @@ void traceBegin(const char* name) {
 #ifdef USE_EMTRACE
 	emscripten_trace_enter_context(name);
 #else
-	if (_callback != nullptr) {
-		_callback->traceBegin(_threadName, name);
+	TraceCallback* callback = _callback.load(std::memory_order_relaxed);
+	if (callback != nullptr) {
+		callback->traceBegin(_threadName, name);
 	}
 #endif
 }
@@ -111,8 +113,9 @@ void traceEnd() {
 #ifdef USE_EMTRACE
 	emscripten_trace_exit_context();
 #else
-	if (_callback != nullptr) {
-		_callback->traceEnd(_threadName);
+	TraceCallback* callback = _callback.load(std::memory_order_relaxed);
+	if (callback != nullptr) {
+		callback->traceEnd(_threadName);
 	}
 #endif
 }
@@ -0,0 +1,220 @@
+/**
+ * @file
+ */
+
+#include "TraceRecorder.h"
+#include "JSON.h"
+#include "Log.h"
+#include <chrono>
+
+namespace core {
+
+namespace {
+
+static std::atomic<uint32_t> _nextRecorderId { 1u };
+
+struct LocalBuffer {
+	uint32_t recorderId = 0u;
+	void *buffer = nullptr;
+};
+static thread_local LocalBuffer _localBuffer;
+
+}
+
+TraceRecorder::TraceRecorder(size_t capacity) :
+		_capacity(capacity), _id(_nextRecorderId++) {
+}
+
+TraceRecorder::~TraceRecorder() {
+	stop();
+}
+
+uint64_t TraceRecorder::nanos() {
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+TraceRecorder::ThreadBuffer* TraceRecorder::buffer(const char *threadName) {
+	if (_localBuffer.recorderId == _id) {
+		return (ThreadBuffer*)_localBuffer.buffer;
+	}
+	std::unique_lock<std::mutex> lock(_buffersMutex);
+	_buffers.emplace_back(new ThreadBuffer((uint32_t)_buffers.size() + 1u, threadName, _capacity));
+	ThreadBuffer* threadBuffer = _buffers.back().get();
+	_localBuffer.recorderId = _id;
+	_localBuffer.buffer = threadBuffer;
+	return threadBuffer;
+}
+
+void TraceRecorder::record(const char *threadName, const char *name, bool begin) {
+	if (!_capturing.load(std::memory_order_relaxed)) {
+		return;
+	}
+	ThreadBuffer* threadBuffer = buffer(threadName);
+	const uint64_t head = threadBuffer->head.load(std::memory_order_relaxed);
+	Event& event = threadBuffer->events[head % _capacity];
+	event.name = name;
+	event.nanos = nanos();
+	event.begin = begin;
+	threadBuffer->head.store(head + 1u, std::memory_order_release);
+}
+
+bool TraceRecorder::start(int frames) {
+	if (_capturing || _stopRequested) {
+		return false;
+	}
+	{
+		std::unique_lock<std::mutex> lock(_buffersMutex);
+		for (auto& threadBuffer : _buffers) {
+			threadBuffer->head = 0u;
+		}
+	}
+	_framesLeft = frames;
+	_captureThread = std::this_thread::get_id();
+	_finished = false;
+	_startNanos = nanos();
+	_stopNanos = _startNanos;
+	_capturing = true;
+	_previous = traceSet(this);
+	Log::info("Started trace capture (frames: %i)", frames);
+	return true;
+}
+
+bool TraceRecorder::stop() {
+	// the recording already ended with the last captured frame
+	if (!_stopRequested.exchange(false)) {
+		if (!_capturing) {
+			return false;
+		}
+		_capturing = false;
+		_stopNanos = nanos();
+	}
+	traceSet(_previous);
+	_previous = nullptr;
+	_finished = true;
+	Log::info("Stopped trace capture with %i events", (int)events());
+	return true;
+}
+
+void TraceRecorder::requestCapture(int frames) {
+	_requestedFrames = frames;
+}
+
+bool TraceRecorder::update() {
+	if (_stopRequested) {
+		stop();
+	}
+	const bool finished = _finished.exchange(false);
+	const int frames = _requestedFrames.exchange(-1);
+	if (frames >= 0) {
+		start(frames);
+	}
+	return finished;
+}
+
+void TraceRecorder::visit(const std::function<void(uint32_t tid, const std::string& threadName, const Event& event)>& func) const {
+	std::unique_lock<std::mutex> lock(_buffersMutex);
+	for (const auto& threadBuffer : _buffers) {
+		const uint64_t head = threadBuffer->head.load(std::memory_order_acquire);
+		const uint64_t first = head > _capacity ? head - _capacity : 0u;
+		for (uint64_t i = first; i < head; ++i) {
+			func(threadBuffer->tid, threadBuffer->name, threadBuffer->events[i % _capacity]);
+		}
+	}
+}
+
+size_t TraceRecorder::events() const {
+	size_t amount = 0u;
+	std::unique_lock<std::mutex> lock(_buffersMutex);
+	for (const auto& threadBuffer : _buffers) {
+		const uint64_t head = threadBuffer->head.load(std::memory_order_acquire);
+		amount += (size_t)(head > _capacity ? _capacity : head);
+	}
+	return amount;
+}
+
+std::string TraceRecorder::toJSON() const {
+	core::json traceEvents = core::json::array();
+	struct Open {
+		uint32_t tid;
+		std::vector<Event> stack;
+	};
+	std::vector<Open> open;
+	auto micros = [this] (uint64_t nanos) {
+		return (double)(nanos - _startNanos) / 1000.0;
+	};
+	auto complete = [&] (uint32_t tid, const Event& begin, uint64_t endNanos) {
+		traceEvents.push_back({
+			{"name", begin.name},
+			{"ph", "X"},
+			{"ts", micros(begin.nanos)},
+			{"dur", (double)(endNanos - begin.nanos) / 1000.0},
+			{"pid", 1},
+			{"tid", tid}
+		});
+	};
+	visit([&] (uint32_t tid, const std::string& threadName, const Event& event) {
+		if (open.empty() || open.back().tid != tid) {
+			traceEvents.push_back({
+				{"name", "thread_name"},
+				{"ph", "M"},
+				{"pid", 1},
+				{"tid", tid},
+				{"args", {{"name", threadName}}}
+			});
+			open.push_back(Open{tid, {}});
+		}
+		std::vector<Event>& stack = open.back().stack;
+		if (event.begin) {
+			stack.push_back(event);
+			return;
+		}
+		// the begin was recorded before the capture started or was overwritten
+		if (stack.empty()) {
+			return;
+		}
+		complete(tid, stack.back(), event.nanos);
+		stack.pop_back();
+	});
+	for (const Open& o : open) {
+		for (const Event& event : o.stack) {
+			complete(o.tid, event, _stopNanos.load());
+		}
+	}
+	const core::json root = {
+		{"traceEvents", traceEvents},
+		{"displayTimeUnit", "ms"}
+	};
+	return root.dump();
+}
+
+void TraceRecorder::traceBeginFrame(const char *threadName) {
+	const bool captureThread = std::this_thread::get_id() == _captureThread.load(std::memory_order_relaxed);
+	record(threadName, captureThread ? "Frame" : "Task", true);
+}
+
+void TraceRecorder::traceBegin(const char *threadName, const char *name) {
+	record(threadName, name, true);
+}
+
+void TraceRecorder::traceEnd(const char *threadName) {
+	record(threadName, nullptr, false);
+}
+
+void TraceRecorder::traceEndFrame(const char *threadName) {
+	record(threadName, nullptr, false);
+	if (_framesLeft.load(std::memory_order_relaxed) <= 0) {
+		return;
+	}
+	if (std::this_thread::get_id() != _captureThread.load(std::memory_order_relaxed)) {
+		return;
+	}
+	if (_framesLeft.fetch_sub(1) != 1) {
+		return;
+	}
+	// the trace callback is restored in update() - this might be called from within a trace callback
+	_stopNanos = nanos();
+	_capturing = false;
+	_stopRequested = true;
+}
+
+}
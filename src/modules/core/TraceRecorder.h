@@ -0,0 +1,133 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "Trace.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace core {
+
+/**
+ * @brief Tracing backend that records the begin and end events of @c core_trace_scoped into per thread ring buffers
+ * and exports them in the chrome trace event format (chrome://tracing, perfetto).
+ *
+ * The recorder is only installed as @c TraceCallback while a capture is running - if nothing is captured the
+ * trace macros are just a check for the callback pointer.
+ *
+ * Every thread writes into its own buffer without any lock. The buffer is allocated on the first event of the
+ * thread and reused for later captures. If a thread records more events than the capacity, the oldest events
+ * are overwritten.
+ *
+ * Only the frames of the thread that started the capture are counted - the frame markers of other threads
+ * (e.g. the tasks of the thread pool workers) are recorded as @c Task. Once the requested frames are captured
+ * no further events are recorded and the capture is finalized by the next @c update().
+ */
+class TraceRecorder : public TraceCallback {
+public:
+	static constexpr size_t DefaultCapacity = 1u << 16;
+
+	struct Event {
+		// the trace macros only pass string literals
+		const char *name;
+		uint64_t nanos;
+		bool begin;
+	};
+private:
+	struct ThreadBuffer {
+		ThreadBuffer(uint32_t _tid, const char *_name, size_t capacity) :
+				tid(_tid), name(_name), events(capacity) {
+		}
+		const uint32_t tid;
+		std::string name;
+		std::vector<Event> events;
+		// only written by the owning thread
+		std::atomic<uint64_t> head { 0u };
+	};
+
+	const size_t _capacity;
+	// unique over all recorder instances - identifies the thread local buffer of this recorder
+	const uint32_t _id;
+	mutable core_trace_mutex(std::mutex, _buffersMutex);
+	std::vector<std::unique_ptr<ThreadBuffer>> _buffers;
+
+	std::atomic_bool _capturing { false };
+	std::atomic_bool _finished { false };
+	// the requested frames were captured - stop() is called in the next update()
+	std::atomic_bool _stopRequested { false };
+	// frames that are still captured - 0 means until stop() is called
+	std::atomic_int _framesLeft { 0 };
+	// the thread that started the capture - only its frames are counted
+	std::atomic<std::thread::id> _captureThread;
+	// a capture of this amount of frames starts with the next update() - -1 if nothing was requested
+	std::atomic_int _requestedFrames { -1 };
+	TraceCallback *_previous = nullptr;
+	uint64_t _startNanos = 0u;
+	std::atomic<uint64_t> _stopNanos { 0u };
+
+	ThreadBuffer* buffer(const char *threadName);
+	void record(const char *threadName, const char *name, bool begin);
+public:
+	TraceRecorder(size_t capacity = DefaultCapacity);
+	~TraceRecorder();
+
+	static uint64_t nanos();
+
+	/**
+	 * @brief Installs the recorder as trace callback and drops the events of a previous capture
+	 * @param[in] frames Stop the capture after this amount of frames of the calling thread - @c 0 captures
+	 * until @c stop() is called
+	 * @return @c false if a capture is already running
+	 */
+	bool start(int frames = 0);
+	/**
+	 * @brief Restores the previous trace callback - the recorded events can be exported afterwards
+	 * @return @c false if no capture was running
+	 */
+	bool stop();
+	bool capturing() const;
+
+	/**
+	 * @brief Starts a capture with the next call to @c update()
+	 * @note Only touches an atomic - safe to call from a signal handler
+	 */
+	void requestCapture(int frames);
+	/**
+	 * @brief Call this once per frame outside of any trace scope on the thread that owns the recorder - finalizes
+	 * captures that reached their frame count and starts requested captures
+	 * @return @c true if a capture finished in the last frame and the events can be exported
+	 */
+	bool update();
+
+	/**
+	 * @brief Visits the recorded events of every thread in the order they were recorded
+	 */
+	void visit(const std::function<void(uint32_t tid, const std::string& threadName, const Event& event)>& func) const;
+	/**
+	 * @return The amount of events of the last capture
+	 */
+	size_t events() const;
+	/**
+	 * @brief The events of the last capture in the chrome trace event format. A begin and its end are merged into
+	 * a complete event - scopes that were still open when the capture was stopped end at the stop time.
+	 */
+	std::string toJSON() const;
+
+	void traceBeginFrame(const char *threadName) override;
+	void traceBegin(const char *threadName, const char *name) override;
+	void traceEnd(const char *threadName) override;
+	void traceEndFrame(const char *threadName) override;
+};
+
+inline bool TraceRecorder::capturing() const {
+	return _capturing;
+}
+
+}
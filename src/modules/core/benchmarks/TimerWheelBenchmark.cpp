@@ -0,0 +1,123 @@
+/**
+ * @file
+ */
+
+#include "core/benchmark/AbstractBenchmark.h"
+#include "core/TimerWheel.h"
+#include "core/ReadWriteLock.h"
+#include <memory>
+#include <queue>
+#include <vector>
+
+/**
+ * @brief Users with a few running cooldowns - compares polling the locked cooldown queue of every user
+ * per tick (like the cooldown manager did before) with one timer wheel for all users
+ */
+class TimerWheelBenchmark: public core::AbstractBenchmark {
+protected:
+	static constexpr int CooldownsPerUser = 4;
+	static constexpr uint64_t TickMillis = 50u;
+	static constexpr int Ticks = 200;
+
+	static inline uint64_t duration(int64_t user, int cooldown) {
+		return 500u + (uint64_t)((user * 7919 + cooldown * 104729) % 15000);
+	}
+};
+
+namespace {
+
+struct PolledCooldown {
+	uint64_t expireMillis;
+	int user;
+	int cooldown;
+};
+
+struct PolledCooldownGreater {
+	inline bool operator()(const std::shared_ptr<PolledCooldown>& x, const std::shared_ptr<PolledCooldown>& y) const {
+		return x->expireMillis > y->expireMillis;
+	}
+};
+
+typedef std::priority_queue<std::shared_ptr<PolledCooldown>, std::vector<std::shared_ptr<PolledCooldown>>, PolledCooldownGreater> PolledQueue;
+
+struct PolledUser {
+	core::ReadWriteLock lock {"PolledUser"};
+	PolledQueue queue;
+};
+
+struct WheelUsers {
+	core::TimerWheel* wheel;
+	uint64_t now;
+	int64_t expired;
+};
+
+}
+
+BENCHMARK_DEFINE_F(TimerWheelBenchmark, PerUserPolling) (benchmark::State& state) {
+	const int64_t users = state.range(0);
+	int64_t expired = 0;
+	for (auto _ : state) {
+		state.PauseTiming();
+		std::vector<PolledUser> polledUsers(users);
+		for (int64_t u = 0; u < users; ++u) {
+			for (int c = 0; c < CooldownsPerUser; ++c) {
+				polledUsers[u].queue.push(std::make_shared<PolledCooldown>(PolledCooldown{duration(u, c), (int)u, c}));
+			}
+		}
+		state.ResumeTiming();
+		for (int tick = 1; tick <= Ticks; ++tick) {
+			const uint64_t now = (uint64_t)tick * TickMillis;
+			for (PolledUser& user : polledUsers) {
+				core::ScopedWriteLock lock(user.lock);
+				PolledQueue& queue = user.queue;
+				while (!queue.empty() && queue.top()->expireMillis <= now) {
+					// rearm - the cooldown is triggered again right away
+					std::shared_ptr<PolledCooldown> cooldown = queue.top();
+					queue.pop();
+					cooldown->expireMillis = now + duration(cooldown->user, cooldown->cooldown);
+					queue.push(cooldown);
+					++expired;
+				}
+			}
+		}
+	}
+	benchmark::DoNotOptimize(expired);
+	state.counters["cooldowns"] = (double)(users * CooldownsPerUser);
+}
+
+static void onWheelExpired(const core::TimerWheel::Timer* timers, size_t amount) {
+	WheelUsers* users = (WheelUsers*)timers[0].target;
+	for (size_t i = 0; i < amount; ++i) {
+		const uint64_t payload = timers[i].payload;
+		const uint64_t duration = 500u + ((payload >> 8) * 7919 + (payload & 0xFF) * 104729) % 15000;
+		users->wheel->add(users->now + duration, onWheelExpired, users, payload);
+	}
+	users->expired += (int64_t)amount;
+}
+
+BENCHMARK_DEFINE_F(TimerWheelBenchmark, TimerWheel) (benchmark::State& state) {
+	const int64_t users = state.range(0);
+	int64_t expired = 0;
+	for (auto _ : state) {
+		state.PauseTiming();
+		core::TimerWheel wheel;
+		WheelUsers ctx{&wheel, 0u, 0};
+		wheel.update(0u);
+		for (int64_t u = 0; u < users; ++u) {
+			for (int c = 0; c < CooldownsPerUser; ++c) {
+				wheel.add(duration(u, c), onWheelExpired, &ctx, ((uint64_t)u << 8) | (uint64_t)c);
+			}
+		}
+		state.ResumeTiming();
+		for (int tick = 1; tick <= Ticks; ++tick) {
+			ctx.now = (uint64_t)tick * TickMillis;
+			wheel.update(ctx.now);
+		}
+		expired += ctx.expired;
+	}
+	benchmark::DoNotOptimize(expired);
+	state.counters["cooldowns"] = (double)(users * CooldownsPerUser);
+}
+
+BENCHMARK_REGISTER_F(TimerWheelBenchmark, PerUserPolling)->RangeMultiplier(10)->Range(100, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(TimerWheelBenchmark, TimerWheel)->RangeMultiplier(10)->Range(100, 100000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,44 @@
+/**
+ * @file
+ */
+
+#include "core/benchmark/AbstractBenchmark.h"
+#include "core/TraceRecorder.h"
+
+/**
+ * @brief The overhead of the trace macros in a frame with a few nested scopes - without a capture the
+ * macros only check the callback pointer, during a capture every scope writes two events.
+ */
+class TraceRecorderBenchmark: public core::AbstractBenchmark {
+protected:
+	static constexpr int ScopesPerFrame = 64;
+
+	static void frame() {
+		core_trace_begin_frame();
+		for (int i = 0; i < ScopesPerFrame; ++i) {
+			core_trace_scoped(TraceRecorderBenchmarkScope);
+			benchmark::ClobberMemory();
+		}
+		core_trace_end_frame();
+	}
+};
+
+BENCHMARK_DEFINE_F(TraceRecorderBenchmark, Idle) (benchmark::State& state) {
+	for (auto _ : state) {
+		frame();
+	}
+	state.SetItemsProcessed(state.iterations() * ScopesPerFrame);
+}
+
+BENCHMARK_DEFINE_F(TraceRecorderBenchmark, Capturing) (benchmark::State& state) {
+	core::TraceRecorder recorder;
+	recorder.start();
+	for (auto _ : state) {
+		frame();
+	}
+	recorder.stop();
+	state.SetItemsProcessed(state.iterations() * ScopesPerFrame);
+}
+
+BENCHMARK_REGISTER_F(TraceRecorderBenchmark, Idle);
+BENCHMARK_REGISTER_F(TraceRecorderBenchmark, Capturing);
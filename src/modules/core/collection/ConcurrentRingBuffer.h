@@ -0,0 +1,104 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <array>
+#include <utility>
+
+namespace core {
+
+/**
+ * @brief Bounded lock-free single-producer/single-consumer ring buffer.
+ *
+ * Exactly one thread may call @c push() and exactly one (other) thread may call @c pop(). The
+ * read and write positions are kept on different cache lines and each side caches the last seen
+ * position of the other side - so the shared atomics are only touched if the ring looks full or empty.
+ *
+ * @note One slot is always kept free to distinguish the full from the empty state - the usable capacity
+ * is @c SIZE - 1.
+ */
+template<class Data, size_t SIZE>
+class ConcurrentRingBuffer {
+private:
+	static_assert(SIZE >= 2 && (SIZE & (SIZE - 1)) == 0, "Size must be a power of two");
+	static constexpr size_t Mask = SIZE - 1;
+	static constexpr size_t CacheLine = 64;
+
+	std::array<Data, SIZE> _data;
+	// written by the producer
+	alignas(CacheLine) std::atomic_size_t _write { 0u };
+	size_t _readCache = 0u;
+	// written by the consumer
+	alignas(CacheLine) std::atomic_size_t _read { 0u };
+	size_t _writeCache = 0u;
+
+public:
+	using Key = Data;
+
+	/**
+	 * @return @c false if the ring is full - the data is not moved in this case
+	 * @note Producer side only
+	 */
+	bool push(Data&& data) {
+		const size_t write = _write.load(std::memory_order_relaxed);
+		const size_t next = (write + 1) & Mask;
+		if (next == _readCache) {
+			_readCache = _read.load(std::memory_order_acquire);
+			if (next == _readCache) {
+				return false;
+			}
+		}
+		_data[write] = std::move(data);
+		_write.store(next, std::memory_order_release);
+		return true;
+	}
+
+	bool push(const Data& data) {
+		Data copy(data);
+		return push(std::move(copy));
+	}
+
+	/**
+	 * @return @c false if the ring is empty
+	 * @note Consumer side only
+	 */
+	bool pop(Data& poppedValue) {
+		const size_t read = _read.load(std::memory_order_relaxed);
+		if (read == _writeCache) {
+			_writeCache = _write.load(std::memory_order_acquire);
+			if (read == _writeCache) {
+				return false;
+			}
+		}
+		poppedValue = std::move(_data[read]);
+		_read.store((read + 1) & Mask, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * @note Only a snapshot if called while the other side is active
+	 */
+	inline uint32_t size() const {
+		const size_t write = _write.load(std::memory_order_acquire);
+		const size_t read = _read.load(std::memory_order_acquire);
+		return (uint32_t)((write - read) & Mask);
+	}
+
+	inline bool empty() const {
+		return size() == 0u;
+	}
+
+	/**
+	 * @return The amount of elements that can be queued - the free slots are @c capacity() - @c size()
+	 */
+	static constexpr uint32_t capacity() {
+		return (uint32_t)(SIZE - 1);
+	}
+};
+
+}
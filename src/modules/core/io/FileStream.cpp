@@ -22,6 +22,58 @@ FileStream::FileStream(SDL_RWops* rwops) :
 FileStream::~FileStream() {
 }
 
+bool FileStream::readDirect(uint8_t *buf, size_t bufSize) const {
+	if (SDL_RWseek(_rwops, _pos, RW_SEEK_SET) < 0) {
+		return false;
+	}
+	size_t completeBytesRead = 0;
+	size_t bytesRead = 1;
+	while (completeBytesRead < bufSize && bytesRead != 0) {
+		bytesRead = SDL_RWread(_rwops, buf + completeBytesRead, 1, bufSize - completeBytesRead);
+		completeBytesRead += bytesRead;
+	}
+	return completeBytesRead == bufSize;
+}
+
+bool FileStream::fillReadBuffer(int64_t position) const {
+	_readBufferSize = 0u;
+	_readBufferPos = position;
+	const size_t bufSize = (size_t)core_min((int64_t)ReadBufferSize, _size - position);
+	if (bufSize == 0u) {
+		return false;
+	}
+	if (_readBuffer.size() < ReadBufferSize) {
+		_readBuffer.resize(ReadBufferSize);
+	}
+	if (SDL_RWseek(_rwops, position, RW_SEEK_SET) < 0) {
+		return false;
+	}
+	size_t bytesRead = 1;
+	while (_readBufferSize < bufSize && bytesRead != 0) {
+		bytesRead = SDL_RWread(_rwops, _readBuffer.data() + _readBufferSize, 1, bufSize - _readBufferSize);
+		_readBufferSize += bytesRead;
+	}
+	return _readBufferSize > 0u;
+}
+
+int FileStream::peekBuf(uint8_t *buf, size_t bufSize) const {
+	if (remaining() < (int64_t)bufSize) {
+		return -1;
+	}
+	const int64_t end = _pos + (int64_t)bufSize;
+	if (_pos < _readBufferPos || end > _readBufferPos + (int64_t)_readBufferSize) {
+		if (bufSize > ReadBufferSize) {
+			// big chunks (like compressed voxel data) are not worth to be copied twice
+			return readDirect(buf, bufSize) ? 0 : -1;
+		}
+		if (!fillReadBuffer(_pos) || end > _readBufferPos + (int64_t)_readBufferSize) {
+			return -1;
+		}
+	}
+	memcpy(buf, _readBuffer.data() + (_pos - _readBufferPos), bufSize);
+	return 0;
+}
+
 int FileStream::peekInt(uint32_t& val) const {
 	const int retVal = peek(val);
 	if (retVal == 0) {
@@ -218,11 +270,10 @@ int FileStream::readInt(uint32_t& val) {
 }
 
 int FileStream::readBuf(uint8_t *buf, size_t bufSize) {
-	for (size_t i = 0; i < bufSize; ++i) {
-		if (readByte(buf[i]) != 0) {
-			return -1;
-		}
+	if (peekBuf(buf, bufSize) != 0) {
+		return -1;
 	}
+	_pos += (int64_t)bufSize;
 	return 0;
 }
 
@@ -237,6 +288,7 @@ int FileStream::readLong(uint64_t& val) {
 }
 
 bool FileStream::addByte(uint8_t val) {
+	invalidateReadBuffer();
 	SDL_RWseek(_rwops, _pos, RW_SEEK_SET);
 	if (SDL_RWwrite(_rwops, &val, 1, 1) != 1) {
 		return false;
@@ -249,6 +301,7 @@ bool FileStream::addByte(uint8_t val) {
 }
 
 bool FileStream::append(const uint8_t *buf, size_t size) {
+	invalidateReadBuffer();
 	SDL_RWseek(_rwops, _pos, RW_SEEK_SET);
 	size_t completeBytesWritten = 0;
 	int32_t bytesWritten = 1;
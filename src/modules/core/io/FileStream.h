@@ -13,6 +13,7 @@
 #include "core/Common.h"
 #include <limits.h>
 #include <memory>
+#include <vector>
 
 namespace io {
 
@@ -24,10 +25,31 @@ typedef std::shared_ptr<File> FilePtr;
  */
 class FileStream {
 private:
+	/**
+	 * @brief The reads are served from a window of the file of this size - this saves the seek and read
+	 * calls on the @c SDL_RWops for every single value.
+	 */
+	static constexpr size_t ReadBufferSize = 64 * 1024;
+
 	int64_t _pos = 0;
 	int64_t _size = 0;
 	mutable SDL_RWops *_rwops;
 
+	mutable std::vector<uint8_t> _readBuffer;
+	// file offset of the first byte in the read buffer
+	mutable int64_t _readBufferPos = 0;
+	// amount of valid bytes in the read buffer
+	mutable size_t _readBufferSize = 0u;
+
+	bool fillReadBuffer(int64_t position) const;
+	bool readDirect(uint8_t *buf, size_t bufSize) const;
+	/**
+	 * @brief Any write might modify the bytes in the read buffer
+	 */
+	inline void invalidateReadBuffer() {
+		_readBufferSize = 0u;
+	}
+
 public:
 	FileStream(File* file);
 	FileStream(const FilePtr& file) : FileStream(file.get()) {}
@@ -50,36 +72,24 @@ public:
 
 	int seek(int64_t position);
 
+	/**
+	 * @brief Copies the given amount of bytes at the current position into the buffer without
+	 * advancing the position
+	 * @return A value of @c 0 indicates no error
+	 */
+	int peekBuf(uint8_t *buf, size_t bufSize) const;
+
 	/**
 	 * @return A value of @c 0 indicates no error
 	 */
 	template<class Ret>
 	int peek(Ret& val) const {
-		const size_t bufSize = sizeof(Ret);
-		if (remaining() < (int64_t)bufSize) {
-			return -1;
-		}
-		uint8_t buf[bufSize];
-		SDL_RWseek(_rwops, _pos, RW_SEEK_SET);
-		uint8_t *b = buf;
-
-		size_t completeBytesRead = 0;
-		size_t bytesRead = 1;
-		while (completeBytesRead < bufSize && bytesRead != 0) {
-			bytesRead = SDL_RWread(_rwops, b, 1, (bufSize - completeBytesRead));
-			b += bytesRead;
-			completeBytesRead += bytesRead;
-		}
-		if (completeBytesRead != bufSize) {
-			return -1;
-		}
-		const Ret *word = (const Ret*) (void*) buf;
-		val = *word;
-		return 0;
+		return peekBuf((uint8_t*)&val, sizeof(Ret));
 	}
 
 	template<class Type>
 	inline bool write(Type val) {
+		invalidateReadBuffer();
 		SDL_RWseek(_rwops, _pos, RW_SEEK_SET);
 		const size_t bufSize = sizeof(Type);
 		uint8_t buf[bufSize];
@@ -114,6 +124,10 @@ public:
 		return retVal;
 	}
 
+	/**
+	 * @brief Reads the given amount of bytes at once
+	 * @return A value of @c 0 indicates no error
+	 */
 	int readBuf(uint8_t *buf, size_t bufSize);
 
 	bool readBool();
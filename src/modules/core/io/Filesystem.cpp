@@ -68,6 +68,17 @@ bool Filesystem::removeFile(const std::string& file) const {
 	return uv_fs_unlink(_loop, &req, file.c_str(), nullptr) == 0;
 }
 
+bool Filesystem::move(const std::string& from, const std::string& to) const {
+	if (from.empty() || to.empty()) {
+		return false;
+	}
+	uv_fs_t req;
+	// synchronous request without a loop - the filesystem might be used from any thread
+	const int retVal = uv_fs_rename(nullptr, &req, from.c_str(), to.c_str(), nullptr);
+	uv_fs_req_cleanup(&req);
+	return retVal == 0;
+}
+
 bool Filesystem::removeDir(const std::string& dir, bool recursive) const {
 	if (dir.empty()) {
 		return false;
@@ -138,6 +138,10 @@ public:
 
 	bool removeDir(const std::string& dir, bool recursive = false) const;
 	bool removeFile(const std::string& file) const;
+	/**
+	 * @brief Renames the given file - an existing file at the target location is replaced atomically
+	 */
+	bool move(const std::string& from, const std::string& to) const;
 private:
 	static bool _list(const std::string& directory, std::vector<DirEntry>& entities);
 	static bool _list(const std::string& directory, std::vector<DirEntry>& entities, const std::string& filter);
@@ -0,0 +1,131 @@
+/**
+ * @file
+ */
+
+#include "AbstractTest.h"
+#include "core/AssetCache.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace core {
+
+class AssetCacheTest: public AbstractTest {
+protected:
+	std::atomic_int _loads { 0 };
+
+	AssetCache<std::string>::Loader loader(int sleepMillis = 0) {
+		return [this, sleepMillis] (const std::string& key) -> std::shared_ptr<std::string> {
+			++_loads;
+			if (sleepMillis > 0) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(sleepMillis));
+			}
+			if (key == "fail") {
+				return std::shared_ptr<std::string>();
+			}
+			return std::make_shared<std::string>("asset-" + key);
+		};
+	}
+
+	static size_t sizer(const std::string& asset) {
+		return asset.size();
+	}
+};
+
+TEST_F(AssetCacheTest, testGet) {
+	AssetCache<std::string> cache(loader(), sizer);
+	const AssetCache<std::string>::AssetPtr& a = cache.get("a");
+	ASSERT_NE(nullptr, a.get());
+	EXPECT_EQ("asset-a", *a);
+	EXPECT_EQ(a, cache.get("a"));
+	EXPECT_EQ(1, _loads);
+	EXPECT_EQ(7u, cache.memoryUsage());
+	EXPECT_EQ(1u, cache.stats().hits);
+	EXPECT_EQ(1u, cache.stats().misses);
+}
+
+TEST_F(AssetCacheTest, testFailures) {
+	AssetCache<std::string> cache(loader(), sizer);
+	EXPECT_EQ(nullptr, cache.get("fail").get());
+	EXPECT_EQ(nullptr, cache.get("fail").get());
+	EXPECT_EQ(2, _loads) << "Failed loads should be retried";
+	EXPECT_EQ(0u, cache.size());
+
+	AssetCache<std::string> failureCache(loader(), sizer, nullptr, std::numeric_limits<size_t>::max(), true);
+	EXPECT_EQ(nullptr, failureCache.get("fail").get());
+	EXPECT_EQ(nullptr, failureCache.get("fail").get());
+	EXPECT_EQ(3, _loads) << "Failed loads should be cached";
+}
+
+TEST_F(AssetCacheTest, testSingleFlight) {
+	AssetCache<std::string> cache(loader(50), sizer);
+	std::vector<std::thread> threads;
+	std::vector<AssetCache<std::string>::AssetPtr> results(8);
+	for (int i = 0; i < (int)results.size(); ++i) {
+		threads.emplace_back([&cache, &results, i] () {
+			results[i] = cache.get("tree");
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	EXPECT_EQ(1, _loads) << "Concurrent requests for the same key should only load once";
+	for (const auto& result : results) {
+		ASSERT_NE(nullptr, result.get());
+		EXPECT_EQ(results[0], result) << "Every request should get the same instance";
+	}
+	const AssetCache<std::string>::Stats& stats = cache.stats();
+	EXPECT_EQ(1u, stats.misses);
+	EXPECT_EQ(7u, stats.hits + stats.coalesced);
+}
+
+TEST_F(AssetCacheTest, testLRU) {
+	// every asset is 7 bytes - three of them fit into the budget
+	AssetCache<std::string> cache(loader(), sizer, nullptr, 21u);
+	const AssetCache<std::string>::AssetPtr& a = cache.get("a");
+	cache.get("b");
+	cache.get("c");
+	// a is now the most recently used one - b should get evicted
+	cache.get("a");
+	cache.get("d");
+	EXPECT_EQ(3u, cache.size());
+	EXPECT_EQ(21u, cache.memoryUsage());
+	EXPECT_EQ(1u, cache.stats().evictions);
+	std::vector<std::string> keys;
+	cache.visit([&] (const std::string& key, const AssetCache<std::string>::AssetPtr& asset, size_t size) {
+		keys.push_back(key);
+	});
+	ASSERT_EQ(3u, keys.size());
+	EXPECT_EQ("d", keys[0]);
+	EXPECT_EQ("a", keys[1]);
+	EXPECT_EQ("c", keys[2]);
+
+	cache.setMemoryBudget(7u);
+	EXPECT_EQ(1u, cache.size());
+	EXPECT_EQ("asset-a", *a) << "Evicted assets stay alive as long as they are referenced";
+}
+
+TEST_F(AssetCacheTest, testAsync) {
+	ThreadPool pool(2);
+	pool.init();
+	AssetCache<std::string> cache(loader(20), sizer, &pool);
+	cache.prefetch({"a", "b"});
+	const AssetCache<std::string>::AssetFuture& future = cache.getAsync("a");
+	ASSERT_NE(nullptr, future.get().get());
+	EXPECT_EQ("asset-b", *cache.get("b"));
+	EXPECT_EQ(2, _loads);
+	pool.shutdown(true);
+}
+
+TEST_F(AssetCacheTest, testPutAndRemove) {
+	AssetCache<std::string> cache(loader(), sizer);
+	cache.put("a", std::make_shared<std::string>("replaced"));
+	EXPECT_EQ("replaced", *cache.get("a"));
+	EXPECT_EQ(0, _loads);
+	EXPECT_TRUE(cache.remove("a"));
+	EXPECT_FALSE(cache.remove("a"));
+	EXPECT_EQ("asset-a", *cache.get("a"));
+	EXPECT_EQ(1, _loads);
+}
+
+}
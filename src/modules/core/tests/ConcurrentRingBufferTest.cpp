@@ -0,0 +1,88 @@
+/**
+ * @file
+ */
+
+#include <gtest/gtest.h>
+#include "core/collection/ConcurrentRingBuffer.h"
+#include <thread>
+#include <memory>
+
+namespace collection {
+
+class ConcurrentRingBufferTest : public testing::Test {
+};
+
+TEST_F(ConcurrentRingBufferTest, testPushPop) {
+	core::ConcurrentRingBuffer<int, 16> ring;
+	int v;
+	ASSERT_TRUE(ring.empty());
+	ASSERT_FALSE(ring.pop(v));
+	for (int i = 0; i < 10; ++i) {
+		ASSERT_TRUE(ring.push(i));
+	}
+	ASSERT_EQ(10u, ring.size());
+	for (int i = 0; i < 10; ++i) {
+		ASSERT_TRUE(ring.pop(v));
+		ASSERT_EQ(i, v);
+	}
+	ASSERT_TRUE(ring.empty());
+}
+
+TEST_F(ConcurrentRingBufferTest, testFull) {
+	core::ConcurrentRingBuffer<int, 8> ring;
+	for (uint32_t i = 0; i < ring.capacity(); ++i) {
+		ASSERT_TRUE(ring.push((int)i));
+	}
+	ASSERT_FALSE(ring.push(100));
+	ASSERT_EQ(ring.capacity(), ring.size());
+	int v;
+	ASSERT_TRUE(ring.pop(v));
+	EXPECT_EQ(0, v);
+	ASSERT_TRUE(ring.push(100));
+	ASSERT_FALSE(ring.push(101));
+}
+
+TEST_F(ConcurrentRingBufferTest, testWrapAround) {
+	core::ConcurrentRingBuffer<int, 4> ring;
+	for (int i = 0; i < 100; ++i) {
+		ASSERT_TRUE(ring.push(i));
+		ASSERT_TRUE(ring.push(i + 1000));
+		int v;
+		ASSERT_TRUE(ring.pop(v));
+		ASSERT_EQ(i, v);
+		ASSERT_TRUE(ring.pop(v));
+		ASSERT_EQ(i + 1000, v);
+	}
+}
+
+TEST_F(ConcurrentRingBufferTest, testMoveOnly) {
+	core::ConcurrentRingBuffer<std::unique_ptr<int>, 4> ring;
+	ASSERT_TRUE(ring.push(std::unique_ptr<int>(new int(42))));
+	std::unique_ptr<int> v;
+	ASSERT_TRUE(ring.pop(v));
+	ASSERT_TRUE(v);
+	EXPECT_EQ(42, *v);
+}
+
+TEST_F(ConcurrentRingBufferTest, testProducerConsumer) {
+	core::ConcurrentRingBuffer<int, 64> ring;
+	const int n = 100000;
+	std::thread producer([&] () {
+		for (int i = 0; i < n; ++i) {
+			while (!ring.push(i)) {
+				std::this_thread::yield();
+			}
+		}
+	});
+	for (int i = 0; i < n; ++i) {
+		int v;
+		while (!ring.pop(v)) {
+			std::this_thread::yield();
+		}
+		ASSERT_EQ(i, v);
+	}
+	producer.join();
+	ASSERT_TRUE(ring.empty());
+}
+
+}
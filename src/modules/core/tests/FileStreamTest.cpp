@@ -56,4 +56,38 @@ TEST_F(FileStreamTest, testFileStreamWrite) {
 	EXPECT_EQ(8l, file->length());
 }
 
+TEST_F(FileStreamTest, testFileStreamReadBuffered) {
+	const io::FilesystemPtr& fs = io::filesystem();
+	const FilePtr& file = fs->open(fs->homePath() + "/filestream-readbufferedtest", io::FileMode::Write);
+	ASSERT_TRUE(file->validHandle());
+	// more than the read buffer of the stream
+	const uint32_t values = 40000u;
+	{
+		FileStream stream(file.get());
+		for (uint32_t i = 0u; i < values; ++i) {
+			ASSERT_TRUE(stream.addInt(i));
+		}
+	}
+	file->close();
+	file->open(io::FileMode::Read);
+	FileStream stream(file.get());
+	ASSERT_EQ((int64_t)(values * sizeof(uint32_t)), stream.size());
+	uint8_t chr;
+	ASSERT_EQ(0, stream.readByte(chr));
+	// reads that cross the border of the buffer
+	for (uint32_t i = 0u; i < values - 1u; ++i) {
+		uint32_t val;
+		ASSERT_EQ(0, stream.readInt(val));
+		ASSERT_EQ((i >> 8) | ((i + 1u) << 24), val) << "at index " << i;
+	}
+	ASSERT_EQ(0, stream.seek(0));
+	std::vector<uint8_t> buf(values * sizeof(uint32_t));
+	ASSERT_EQ(0, stream.readBuf(buf.data(), buf.size()));
+	EXPECT_EQ(0, stream.remaining());
+	uint32_t last;
+	memcpy(&last, &buf[(values - 1u) * sizeof(uint32_t)], sizeof(last));
+	EXPECT_EQ(values - 1u, last);
+	EXPECT_NE(0, stream.readByte(chr));
+}
+
 }
@@ -0,0 +1,172 @@
+/**
+ * @file
+ */
+
+#include "AbstractTest.h"
+#include "core/TimerWheel.h"
+#include <vector>
+
+namespace core {
+
+class TimerWheelTest: public AbstractTest {
+protected:
+	struct Expired {
+		uint64_t payload;
+		uint64_t expireMillis;
+		uint64_t nowMillis;
+	};
+	std::vector<Expired> _expired;
+	std::vector<size_t> _batches;
+	uint64_t _now = 0u;
+
+	static void onExpired(const TimerWheel::Timer* timers, size_t amount) {
+		TimerWheelTest* test = (TimerWheelTest*)timers[0].target;
+		test->_batches.push_back(amount);
+		for (size_t i = 0; i < amount; ++i) {
+			test->_expired.push_back(Expired{timers[i].payload, timers[i].expireMillis, test->_now});
+		}
+	}
+
+	static void onOtherExpired(const TimerWheel::Timer* timers, size_t amount) {
+		onExpired(timers, amount);
+	}
+
+	void update(TimerWheel& wheel, uint64_t now) {
+		_now = now;
+		wheel.update(now);
+	}
+
+	void SetUp() override {
+		AbstractTest::SetUp();
+		_expired.clear();
+		_batches.clear();
+		_now = 0u;
+	}
+};
+
+TEST_F(TimerWheelTest, testExpire) {
+	TimerWheel wheel;
+	update(wheel, 1000u);
+	wheel.add(1010u, onExpired, this, 1u);
+	wheel.add(1005u, onExpired, this, 2u);
+	update(wheel, 1004u);
+	EXPECT_TRUE(_expired.empty());
+	update(wheel, 1005u);
+	ASSERT_EQ(1u, _expired.size());
+	EXPECT_EQ(2u, _expired[0].payload);
+	update(wheel, 2000u);
+	ASSERT_EQ(2u, _expired.size());
+	EXPECT_EQ(1u, _expired[1].payload);
+	EXPECT_EQ(0u, wheel.stats().active);
+}
+
+TEST_F(TimerWheelTest, testExpireBeforeFirstUpdate) {
+	TimerWheel wheel;
+	wheel.add(10u, onExpired, this, 1u);
+	wheel.add(5000u, onExpired, this, 2u);
+	update(wheel, 100u);
+	ASSERT_EQ(1u, _expired.size());
+	EXPECT_EQ(1u, _expired[0].payload);
+	update(wheel, 4999u);
+	EXPECT_EQ(1u, _expired.size());
+	update(wheel, 5000u);
+	EXPECT_EQ(2u, _expired.size());
+}
+
+TEST_F(TimerWheelTest, testCancel) {
+	TimerWheel wheel;
+	update(wheel, 0u);
+	const TimerWheel::TimerId id = wheel.add(100u, onExpired, this, 1u);
+	const TimerWheel::TimerId expiredId = wheel.add(0u, onExpired, this, 2u);
+	wheel.add(100u, onExpired, this, 3u);
+	EXPECT_NE(id, expiredId);
+	EXPECT_TRUE(wheel.cancel(id));
+	EXPECT_FALSE(wheel.cancel(id)) << "The timer was already canceled";
+	EXPECT_TRUE(wheel.cancel(expiredId)) << "Timers that are waiting for the next update can be canceled, too";
+	// the slot of the canceled timer is reused - the old id must not cancel the new timer
+	const TimerWheel::TimerId reused = wheel.add(100u, onExpired, this, 4u);
+	EXPECT_NE(id, reused);
+	EXPECT_FALSE(wheel.cancel(id));
+	update(wheel, 200u);
+	ASSERT_EQ(2u, _expired.size());
+	EXPECT_EQ(3u, _expired[0].payload);
+	EXPECT_EQ(4u, _expired[1].payload);
+	EXPECT_FALSE(wheel.cancel(reused)) << "The timer already expired";
+	EXPECT_EQ(2u, wheel.stats().canceled);
+}
+
+TEST_F(TimerWheelTest, testCascade) {
+	TimerWheel wheel;
+	const uint64_t start = 123456u;
+	update(wheel, start);
+	// covers all levels and the wrap arounds in between
+	const uint64_t delays[] = { 1u, 63u, 64u, 65u, 4095u, 4096u, 4097u, 262143u, 262144u, 300000u, 16777216u + 5u,
+			((uint64_t)1 << 36) + 17u };
+	for (uint64_t delay : delays) {
+		wheel.add(start + delay, onExpired, this, delay);
+	}
+	uint64_t now = start;
+	// advance in irregular steps - no timer may fire too early or too late
+	for (uint64_t step = 1u; _expired.size() < sizeof(delays) / sizeof(delays[0]); step = step * 3u + 7u) {
+		now += step;
+		update(wheel, now);
+		for (const Expired& e : _expired) {
+			ASSERT_GE(e.nowMillis, e.expireMillis) << "Timer with delay " << e.payload << " fired too early";
+		}
+	}
+	for (const Expired& e : _expired) {
+		EXPECT_EQ(start + e.payload, e.expireMillis);
+	}
+	// exact expiry when every millisecond is visited
+	_expired.clear();
+	wheel.add(now + 70000u, onExpired, this, 1u);
+	for (uint64_t i = 1u; i <= 70000u; ++i) {
+		update(wheel, now + i);
+		if (!_expired.empty()) {
+			EXPECT_EQ(70000u, i);
+			break;
+		}
+	}
+	ASSERT_EQ(1u, _expired.size());
+}
+
+TEST_F(TimerWheelTest, testBatches) {
+	TimerWheel wheel;
+	update(wheel, 0u);
+	for (uint64_t i = 0u; i < 10u; ++i) {
+		wheel.add(10u + i, (i & 1u) ? onExpired : onOtherExpired, this, i);
+	}
+	update(wheel, 100u);
+	ASSERT_EQ(2u, _batches.size()) << "Expected one call per callback function";
+	EXPECT_EQ(5u, _batches[0]);
+	EXPECT_EQ(5u, _batches[1]);
+	ASSERT_EQ(10u, _expired.size());
+	// the expire order is kept within one batch
+	for (size_t i = 1u; i < 5u; ++i) {
+		EXPECT_LT(_expired[i - 1].payload, _expired[i].payload);
+		EXPECT_LT(_expired[i + 4].payload, _expired[i + 5].payload);
+	}
+}
+
+TEST_F(TimerWheelTest, testResolution) {
+	TimerWheel wheel(10u);
+	update(wheel, 0u);
+	wheel.add(15u, onExpired, this, 1u);
+	update(wheel, 15u);
+	EXPECT_TRUE(_expired.empty()) << "The expire time is rounded up to the next tick";
+	update(wheel, 20u);
+	EXPECT_EQ(1u, _expired.size());
+}
+
+TEST_F(TimerWheelTest, testClear) {
+	TimerWheel wheel;
+	update(wheel, 0u);
+	wheel.add(10u, onExpired, this, 1u);
+	wheel.add(100000u, onExpired, this, 2u);
+	wheel.clear();
+	update(wheel, 200000u);
+	EXPECT_TRUE(_expired.empty());
+	EXPECT_EQ(0u, wheel.stats().active);
+}
+
+}
@@ -0,0 +1,150 @@
+/**
+ * @file
+ */
+
+#include "AbstractTest.h"
+#include "core/TraceRecorder.h"
+#include "core/JSON.h"
+#include <thread>
+
+namespace core {
+
+class TraceRecorderTest: public AbstractTest {
+protected:
+	static void frame(int inner) {
+		core_trace_begin_frame();
+		{
+			core_trace_scoped(TraceRecorderTestOuter);
+			for (int i = 0; i < inner; ++i) {
+				core_trace_scoped(TraceRecorderTestInner);
+			}
+		}
+		core_trace_end_frame();
+	}
+
+	static int count(const json& root, const std::string& name) {
+		int n = 0;
+		for (const json& event : root["traceEvents"]) {
+			if (event["name"].get<std::string>() == name) {
+				++n;
+			}
+		}
+		return n;
+	}
+};
+
+TEST_F(TraceRecorderTest, testNotCapturing) {
+	TraceRecorder recorder;
+	frame(2);
+	EXPECT_EQ(0u, recorder.events());
+	EXPECT_FALSE(recorder.update());
+	EXPECT_FALSE(recorder.stop());
+}
+
+TEST_F(TraceRecorderTest, testCaptureFrames) {
+	TraceRecorder recorder;
+	recorder.requestCapture(3);
+	EXPECT_FALSE(recorder.capturing());
+	EXPECT_FALSE(recorder.update());
+	EXPECT_TRUE(recorder.capturing());
+	for (int i = 0; i < 5; ++i) {
+		frame(2);
+	}
+	EXPECT_FALSE(recorder.capturing()) << "The capture should stop after 3 frames";
+	EXPECT_TRUE(recorder.update());
+	EXPECT_FALSE(recorder.update());
+	// frame, outer and two inner scopes per frame
+	EXPECT_EQ(3u * 4u * 2u, recorder.events());
+
+	const json root = json::parse(recorder.toJSON());
+	ASSERT_TRUE(root["traceEvents"].is_array());
+	EXPECT_EQ(3, count(root, "Frame"));
+	EXPECT_EQ(3, count(root, "TraceRecorderTestOuter"));
+	EXPECT_EQ(6, count(root, "TraceRecorderTestInner"));
+	EXPECT_EQ(1, count(root, "thread_name"));
+	double frameEnd = 0.0;
+	for (const json& event : root["traceEvents"]) {
+		if (event["ph"] == "M") {
+			continue;
+		}
+		EXPECT_EQ("X", event["ph"].get<std::string>());
+		const double ts = event["ts"].get<double>();
+		const double dur = event["dur"].get<double>();
+		EXPECT_GE(ts, 0.0);
+		EXPECT_GE(dur, 0.0);
+		if (event["name"] == "Frame") {
+			EXPECT_GE(ts, frameEnd) << "Frames must not overlap";
+			frameEnd = ts + dur;
+		}
+	}
+}
+
+TEST_F(TraceRecorderTest, testCaptureFramesOfCaptureThread) {
+	TraceRecorder recorder;
+	recorder.requestCapture(2);
+	EXPECT_FALSE(recorder.update());
+	std::thread thread([] () {
+		for (int i = 0; i < 5; ++i) {
+			frame(0);
+		}
+	});
+	thread.join();
+	EXPECT_TRUE(recorder.capturing()) << "The frames of other threads must not be counted";
+	frame(0);
+	frame(0);
+	EXPECT_FALSE(recorder.capturing());
+	EXPECT_TRUE(recorder.update());
+	const json root = json::parse(recorder.toJSON());
+	EXPECT_EQ(2, count(root, "Frame"));
+	EXPECT_EQ(5, count(root, "Task"));
+}
+
+TEST_F(TraceRecorderTest, testThreads) {
+	TraceRecorder recorder;
+	ASSERT_TRUE(recorder.start());
+	EXPECT_FALSE(recorder.start()) << "A capture is already running";
+	std::thread thread([] () {
+		core_trace_thread("TraceRecorderTestThread");
+		for (int i = 0; i < 10; ++i) {
+			core_trace_scoped(TraceRecorderTestThreadScope);
+		}
+	});
+	thread.join();
+	frame(1);
+	ASSERT_TRUE(recorder.stop());
+
+	int threadEvents = 0;
+	int mainEvents = 0;
+	recorder.visit([&] (uint32_t tid, const std::string& threadName, const TraceRecorder::Event& event) {
+		if (threadName == "TraceRecorderTestThread") {
+			++threadEvents;
+		} else {
+			++mainEvents;
+		}
+	});
+	EXPECT_EQ(20, threadEvents);
+	EXPECT_EQ(6, mainEvents);
+	const json root = json::parse(recorder.toJSON());
+	EXPECT_EQ(10, count(root, "TraceRecorderTestThreadScope"));
+	EXPECT_EQ(2, count(root, "thread_name"));
+}
+
+TEST_F(TraceRecorderTest, testOverwriteAndOpenScopes) {
+	TraceRecorder recorder(8);
+	ASSERT_TRUE(recorder.start());
+	// 4 events per frame - the oldest frames are overwritten
+	for (int i = 0; i < 10; ++i) {
+		frame(0);
+	}
+	core_trace_begin(TraceRecorderTestOpen);
+	ASSERT_TRUE(recorder.stop());
+	core_trace_end();
+	EXPECT_EQ(8u, recorder.events());
+	const json root = json::parse(recorder.toJSON());
+	// ends without a begin are dropped, the open scope ends with the capture
+	EXPECT_EQ(1, count(root, "TraceRecorderTestOpen"));
+	EXPECT_EQ(1, count(root, "Frame"));
+	EXPECT_EQ(2, count(root, "TraceRecorderTestOuter"));
+}
+
+}
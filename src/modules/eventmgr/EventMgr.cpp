@@ -13,8 +13,8 @@
 
 namespace eventmgr {
 
-EventMgr::EventMgr(const EventProviderPtr& eventProvider, const core::TimeProviderPtr& timeProvider) :
-		_eventProvider(eventProvider), _timeProvider(timeProvider) {
+EventMgr::EventMgr(const EventProviderPtr& eventProvider, const core::TimeProviderPtr& timeProvider, const core::TimerWheelPtr& timerWheel) :
+		_eventProvider(eventProvider), _timeProvider(timeProvider), _timerWheel(timerWheel) {
 }
 
 bool EventMgr::init(const std::string& luaScript) {
@@ -47,41 +47,62 @@ bool EventMgr::init(const std::string& luaScript) {
 		return false;
 	}
 
+	scheduleEvents();
 	return true;
 }
 
-void EventMgr::update(long dt) {
-	core_trace_scoped(EventMgrUpdate);
-	const auto currentMillis = _timeProvider->tickMillis();
+void EventMgr::scheduleEvents() {
+	const uint64_t currentMillis = _timeProvider->tickMillis();
 	const EventProvider::EventData& eventData = _eventProvider->eventData();
+	_timers.reserve(_timers.size() + eventData.size() * 2);
 	for (const auto& entry : eventData) {
 		const db::EventModelPtr& data = entry.second;
-		const auto i = _events.find(data->id());
-		const persistence::Timestamp& endTime = data->enddate();
-		if (endTime.millis() < currentMillis) {
+		const uint64_t endMillis = data->enddate().millis();
+		if (endMillis < currentMillis) {
 			continue;
 		}
-		if (i == _events.end()) {
-			const persistence::Timestamp& startTime = data->startdate();
-			const auto eventStartMillis = startTime.millis();
-			const long delta = eventStartMillis - currentMillis;
-			if (delta <= 0) {
-				core_trace_scoped(EventStart);
-				startEvent(data);
-			}
+		// events that should already run are started with the next update of the wheel
+		_timers.push_back(_timerWheel->add(data->startdate().millis(), onEventStart, this, (uint64_t)data->id()));
+		_timers.push_back(_timerWheel->add(endMillis, onEventStop, this, (uint64_t)data->id()));
+	}
+}
+
+void EventMgr::onEventStart(const core::TimerWheel::Timer* timers, size_t amount) {
+	core_trace_scoped(EventStart);
+	for (size_t i = 0; i < amount; ++i) {
+		EventMgr* mgr = (EventMgr*)timers[i].target;
+		const EventId id = (EventId)timers[i].payload;
+		if (mgr->_events.find(id) != mgr->_events.end()) {
 			continue;
 		}
-
-		const auto eventEndMillis = endTime.millis();
-		if (eventEndMillis <= currentMillis) {
-			core_trace_scoped(EventStop);
-			const EventPtr& event = i->second;
-			Log::info("Stop event of type " PRIEventId, (EventId)data->id());
-			event->stop();
-			_events.erase(i);
+		const db::EventModelPtr& data = mgr->_eventProvider->get(id);
+		if (!data) {
 			continue;
 		}
+		mgr->startEvent(data);
 	}
+}
+
+void EventMgr::onEventStop(const core::TimerWheel::Timer* timers, size_t amount) {
+	core_trace_scoped(EventStop);
+	for (size_t i = 0; i < amount; ++i) {
+		EventMgr* mgr = (EventMgr*)timers[i].target;
+		mgr->stopEvent((EventId)timers[i].payload);
+	}
+}
+
+void EventMgr::stopEvent(EventId id) {
+	auto i = _events.find(id);
+	if (i == _events.end()) {
+		return;
+	}
+	Log::info("Stop event of type " PRIEventId, id);
+	i->second->stop();
+	_events.erase(i);
+}
+
+void EventMgr::update(long dt) {
+	core_trace_scoped(EventMgrUpdate);
 	for (auto i = _events.begin(); i != _events.end(); ++i)  {
 		Log::debug("Tick event %i", (int)i->first);
 		core_trace_scoped(EventUpdate);
@@ -98,6 +119,10 @@ EventPtr EventMgr::runningEvent(EventId id) const {
 }
 
 void EventMgr::shutdown() {
+	for (core::TimerWheel::TimerId id : _timers) {
+		_timerWheel->cancel(id);
+	}
+	_timers.clear();
 	for (auto& e : _events) {
 		e.second->shutdown();
 	}
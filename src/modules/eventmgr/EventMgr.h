@@ -9,8 +9,10 @@
 #include "persistence/DBHandler.h"
 #include "commonlua/LUA.h"
 #include "core/TimeProvider.h"
+#include "core/TimerWheel.h"
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace io {
 class Filesystem;
@@ -26,6 +28,9 @@ namespace eventmgr {
 
 /**
  * @brief The event manager deals with starting, ticking and ending game events.
+ *
+ * The start and end of each configured event is a timer on the @c core::TimerWheel - the configured
+ * events are not polled.
  */
 class EventMgr {
 private:
@@ -34,18 +39,25 @@ private:
 
 	EventProviderPtr _eventProvider;
 	core::TimeProviderPtr _timeProvider;
+	core::TimerWheelPtr _timerWheel;
+	std::vector<core::TimerWheel::TimerId> _timers;
 	lua::LUA _lua;
 
 	EventPtr createEvent(const std::string& nameId, EventId id) const;
 
 	bool startEvent(const db::EventModelPtr& model);
+	void stopEvent(EventId id);
+	void scheduleEvents();
+
+	static void onEventStart(const core::TimerWheel::Timer* timers, size_t amount);
+	static void onEventStop(const core::TimerWheel::Timer* timers, size_t amount);
 public:
-	EventMgr(const EventProviderPtr& eventProvider, const core::TimeProviderPtr& timeProvider);
+	EventMgr(const EventProviderPtr& eventProvider, const core::TimeProviderPtr& timeProvider, const core::TimerWheelPtr& timerWheel);
 
 	bool init(const std::string& luaScript);
 	/**
-	 * @brief Call this in your main loop
-	 * Starts all events that are configured to run at the current time of the @c core::TimeProvider
+	 * @brief Call this in your main loop to tick the running events
+	 * @note The events are started and stopped by the timer wheel
 	 */
 	void update(long dt);
 	/**
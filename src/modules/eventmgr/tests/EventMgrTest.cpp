@@ -65,7 +65,7 @@ TEST_F(EventMgrTest, testEventMgrInit) {
 	if (!_supported) {
 		return;
 	}
-	EventMgr mgr(_eventProvider, _testApp->timeProvider());
+	EventMgr mgr(_eventProvider, _testApp->timeProvider(), std::make_shared<core::TimerWheel>());
 	ASSERT_TRUE(_testApp->filesystem()->exists("test-events.lua"));
 	const std::string& events = _testApp->filesystem()->load("test-events.lua");
 	ASSERT_NE("", events) << "Failed to load test-events.lua";
@@ -164,7 +164,8 @@ TEST_F(EventMgrTest, testEventMgrUpdateStartStop) {
 	db::EventModel model;
 	createEvent(Type::GENERIC, model, eventStartSeconds, eventStopTime);
 
-	EventMgr mgr(_eventProvider, timeProvider);
+	const core::TimerWheelPtr& timerWheel = std::make_shared<core::TimerWheel>();
+	EventMgr mgr(_eventProvider, timeProvider, timerWheel);
 	ASSERT_TRUE(_testApp->filesystem()->exists("test-events.lua"));
 	const std::string& events = _testApp->filesystem()->load("test-events.lua");
 	ASSERT_NE("", events) << "Failed to load test-events.lua";
@@ -172,16 +173,19 @@ TEST_F(EventMgrTest, testEventMgrUpdateStartStop) {
 	ASSERT_EQ(0, mgr.runningEvents());
 
 	// current tick time is 1s, event starts at 2s
+	timerWheel->update(timeProvider->tickMillis());
 	mgr.update(0L);
 	ASSERT_EQ(0, mgr.runningEvents()) << "At " << timeProvider->toString(timeProvider->tickMillis()) << " should be no running event " << model.startdate().toString();
 
 	// current tick time: 2000ms
 	timeProvider->update(eventStartSeconds * 1000UL);
+	timerWheel->update(timeProvider->tickMillis());
 	mgr.update(0L);
 	ASSERT_EQ(1, mgr.runningEvents()) << "At " << timeProvider->toString(timeProvider->tickMillis()) << " should be a running event " << model.startdate().toString();
 
 	// current tick time: 52000ms
 	timeProvider->update(eventStopTime * 1000UL);
+	timerWheel->update(timeProvider->tickMillis());
 	mgr.update(0L);
 	ASSERT_EQ(0, mgr.runningEvents()) << "At " << timeProvider->toString(timeProvider->tickMillis()) << " should be no running event " << model.enddate().toString();
 
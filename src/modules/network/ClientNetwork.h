@@ -5,6 +5,7 @@
 #pragma once
 
 #include "Network.h"
+#include "core/Enum.h"
 
 namespace network {
 
@@ -16,7 +17,7 @@ private:
 public:
 	ClientNetwork(const ProtocolHandlerRegistryPtr& protocolHandlerRegistry, const core::EventBusPtr& eventBus);
 
-	ENetPeer* connect(uint16_t port, const std::string& hostname, int maxChannels = 1);
+	ENetPeer* connect(uint16_t port, const std::string& hostname, int maxChannels = std::enum_value(Channel::Max));
 	void disconnect();
 	bool packetReceived(ENetEvent& event) override;
 
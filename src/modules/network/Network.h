@@ -25,6 +25,21 @@ enum class DisconnectReason {
 	Unknown
 };
 
+/**
+ * @brief The enet channels the messages are sent on. Reliable messages are ordered per channel - a resend
+ * of e.g. a spawn doesn't hold back the movement updates that are sent on their own channel.
+ */
+enum class Channel : uint8_t {
+	// connection, spawn and remove messages
+	Session,
+	// entity updates
+	Movement,
+	// attributes and cooldowns
+	State,
+
+	Max
+};
+
 /**
  * @brief Network implementation based on enet and flatbuffers
  */
@@ -50,7 +65,10 @@ public:
 
 	const ProtocolHandlerRegistryPtr& registry();
 
-	bool sendMessage(ENetPeer* peer, ENetPacket* packet, int channel = 0);
+	/**
+	 * @note The packet is owned by the network after this call
+	 */
+	virtual bool sendMessage(ENetPeer* peer, ENetPacket* packet, int channel = 0);
 };
 
 inline bool Network::sendMessage(ENetPeer* peer, ENetPacket* packet, int channel) {
@@ -0,0 +1,232 @@
+/**
+ * @file
+ */
+
+#include "PacketPool.h"
+#include "core/Common.h"
+#include "core/Assert.h"
+#include "core/Log.h"
+#include <string.h>
+
+namespace network {
+
+uint8_t *PacketPool::Allocator::allocate(size_t size) {
+	return _pool.allocate(size < _sizeHint ? _sizeHint : size);
+}
+
+void PacketPool::Allocator::deallocate(uint8_t *p, size_t) {
+	PacketPool::deallocate(p);
+}
+
+uint8_t *PacketPool::Allocator::reallocate_downward(uint8_t *old_p, size_t old_size, size_t new_size, size_t in_use_back, size_t in_use_front) {
+	core_assert(new_size > old_size);
+	if (new_size > capacity(old_p)) {
+		return flatbuffers::Allocator::reallocate_downward(old_p, old_size, new_size, in_use_back, in_use_front);
+	}
+	// the buffer of the size class is big enough - the builder grows downwards, so only the used
+	// back part has to get moved to the end of the new size. The front part (scratch) stays where it is.
+	memmove(old_p + new_size - in_use_back, old_p + old_size - in_use_back, in_use_back);
+	return old_p;
+}
+
+PacketPool::ThreadCache::~ThreadCache() {
+	reset(nullptr);
+}
+
+void PacketPool::ThreadCache::reset(const PacketPool* newPool) {
+	// the blocks don't belong to a particular pool - the old pool might already be gone, so they are just freed
+	for (int i = 0; i < SizeClasses; ++i) {
+		freeList(free[i]);
+		free[i] = nullptr;
+		tail[i] = nullptr;
+		freeCount[i] = 0u;
+	}
+	pool = newPool;
+}
+
+PacketPool::ThreadCache& PacketPool::threadCache() {
+	static thread_local ThreadCache cache;
+	return cache;
+}
+
+void PacketPool::freeList(Block* b) {
+	while (b != nullptr) {
+		Block* next = b->next;
+		core_free(b);
+		b = next;
+	}
+}
+
+void PacketPool::push(int index, Block* head, Block* tail, size_t count) {
+	SizeClass& sc = _sizeClasses[index];
+	if (sc.freeCount.load(std::memory_order_relaxed) >= _maxFreeBlocks[index]) {
+		_dropped += count;
+		freeList(head);
+		return;
+	}
+	sc.freeCount.fetch_add(count, std::memory_order_relaxed);
+	tail->next = sc.free.load(std::memory_order_relaxed);
+	while (!sc.free.compare_exchange_weak(tail->next, head, std::memory_order_release, std::memory_order_relaxed)) {
+	}
+}
+
+PacketPool::PacketPool(size_t maxFreeBytes) {
+	for (int i = 0; i < SizeClasses; ++i) {
+		_maxFreeBlocks[i] = maxFreeBytes / sizeClassSize(i);
+	}
+}
+
+PacketPool::~PacketPool() {
+	// the pool must outlive all packets that were created from it. The thread caches are
+	// not touched here, the global pool is destroyed after them.
+	for (SizeClass& sc : _sizeClasses) {
+		freeList(sc.free.exchange(nullptr));
+	}
+}
+
+PacketPool& PacketPool::get() {
+	static PacketPool pool;
+	return pool;
+}
+
+int PacketPool::sizeClass(size_t size) {
+	if (size > ((size_t)1u << MaxSizeClassShift)) {
+		return -1;
+	}
+	int index = 0;
+	while (sizeClassSize(index) < size) {
+		++index;
+	}
+	return index;
+}
+
+size_t PacketPool::capacity(const uint8_t* p) {
+	const Block* b = block(p);
+	if (b->sizeClass < 0) {
+		return b->capacity;
+	}
+	return sizeClassSize(b->sizeClass);
+}
+
+uint8_t* PacketPool::allocate(size_t size) {
+	const int index = sizeClass(size);
+	Block* b = nullptr;
+	if (index < 0) {
+		++_oversized;
+		b = (Block*)core_malloc(sizeof(Block) + size);
+		b->capacity = size;
+	} else {
+		ThreadCache& cache = threadCache();
+		if (cache.pool != this) {
+			cache.reset(this);
+		}
+		if (cache.free[index] == nullptr) {
+			// take over all the blocks that were freed by the other threads
+			SizeClass& sc = _sizeClasses[index];
+			Block* head = sc.free.exchange(nullptr, std::memory_order_acquire);
+			if (head != nullptr) {
+				size_t count = 1u;
+				Block* tail = head;
+				for (; tail->next != nullptr; tail = tail->next) {
+					++count;
+				}
+				sc.freeCount.fetch_sub(count, std::memory_order_relaxed);
+				cache.free[index] = head;
+				cache.tail[index] = tail;
+				cache.freeCount[index] = count;
+			}
+		}
+		b = cache.free[index];
+		if (b != nullptr) {
+			cache.free[index] = b->next;
+			if (--cache.freeCount[index] == 0u) {
+				cache.tail[index] = nullptr;
+			}
+		} else {
+			++_misses;
+			b = (Block*)core_malloc(sizeof(Block) + sizeClassSize(index));
+		}
+	}
+	b->pool = this;
+	b->sizeClass = index;
+	return (uint8_t*)(b + 1);
+}
+
+void PacketPool::deallocate(uint8_t* p) {
+	if (p == nullptr) {
+		return;
+	}
+	Block* b = block(p);
+	PacketPool* pool = b->pool;
+	const int index = b->sizeClass;
+	if (index < 0) {
+		core_free(b);
+		return;
+	}
+	ThreadCache& cache = threadCache();
+	if (cache.pool == nullptr) {
+		cache.pool = pool;
+	} else if (cache.pool != pool) {
+		pool->push(index, b, b, 1u);
+		return;
+	}
+	b->next = cache.free[index];
+	if (b->next == nullptr) {
+		cache.tail[index] = b;
+	}
+	cache.free[index] = b;
+	if (++cache.freeCount[index] < MaxThreadCacheBlocks) {
+		return;
+	}
+	pool->push(index, cache.free[index], cache.tail[index], cache.freeCount[index]);
+	cache.free[index] = nullptr;
+	cache.tail[index] = nullptr;
+	cache.freeCount[index] = 0u;
+}
+
+void PacketPool::freePacket(ENetPacket* packet) {
+	deallocate((uint8_t*)packet->userData);
+	packet->userData = nullptr;
+}
+
+ENetPacket* PacketPool::createPacket(uint8_t* raw, size_t offset, size_t size, uint32_t flags) {
+	ENetPacket* packet = enet_packet_create(raw + offset, size, flags | ENET_PACKET_FLAG_NO_ALLOCATE);
+	if (packet == nullptr) {
+		Log::error("Failed to create packet of size %i", (int)size);
+		deallocate(raw);
+		return nullptr;
+	}
+	packet->userData = raw;
+	packet->freeCallback = freePacket;
+	return packet;
+}
+
+void PacketPool::shrink() {
+	ThreadCache& cache = threadCache();
+	if (cache.pool == this) {
+		cache.reset(nullptr);
+	}
+	for (SizeClass& sc : _sizeClasses) {
+		freeList(sc.free.exchange(nullptr, std::memory_order_acquire));
+		sc.freeCount = 0u;
+	}
+}
+
+PacketPool::Stats PacketPool::stats() const {
+	Stats s;
+	s.misses = _misses;
+	s.oversized = _oversized;
+	s.dropped = _dropped;
+	return s;
+}
+
+ENetPacket* PacketBuilder::createPacket(uint32_t flags) {
+	const size_t size = GetSize();
+	size_t reserved;
+	size_t offset;
+	uint8_t* raw = ReleaseRaw(reserved, offset);
+	_allocator.setSizeHint(reserved);
+	return PacketPool::createPacket(raw, offset, size, flags);
+}
+
+}
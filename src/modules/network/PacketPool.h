@@ -0,0 +1,203 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include <flatbuffers/flatbuffers.h>
+#include <enet/enet.h>
+#include <atomic>
+#include <stdint.h>
+
+namespace network {
+
+/**
+ * @brief Thread safe pool of packet buffers in size classes of powers of two and the steps in between (256, 384, 512, 768, ...)
+ *
+ * The flatbuffers of the outgoing messages are built directly into these buffers (see @c PacketBuilder)
+ * and the buffer is handed over to enet without copying it. Once enet destroyed the packet - this usually
+ * happens on the network thread - the buffer is returned to the free list of its size class.
+ *
+ * Buffers that are bigger than the biggest size class are not pooled.
+ */
+class PacketPool {
+public:
+	static constexpr int MinSizeClassShift = 8;
+	static constexpr int MaxSizeClassShift = 16;
+	static constexpr int SizeClasses = (MaxSizeClassShift - MinSizeClassShift) * 2 + 1;
+
+	/**
+	 * @brief Only the slow paths are counted - the pool hits don't touch any shared state
+	 */
+	struct Stats {
+		// allocations that were not served from a free list
+		uint64_t misses = 0u;
+		// allocations that were too big for the biggest size class
+		uint64_t oversized = 0u;
+		// freed buffers that didn't fit into the free lists anymore
+		uint64_t dropped = 0u;
+	};
+
+	/**
+	 * @brief Lets flatbuffers allocate the builder memory from the pool
+	 *
+	 * The first allocation of a message is at least as big as the size hint - the builder can then
+	 * grow in place instead of moving the message through several size classes.
+	 */
+	class Allocator : public flatbuffers::Allocator {
+	private:
+		PacketPool& _pool;
+		size_t _sizeHint = 0u;
+	public:
+		Allocator(PacketPool& pool) : _pool(pool) {
+		}
+		uint8_t *allocate(size_t size) override;
+		void deallocate(uint8_t *p, size_t size) override;
+		uint8_t *reallocate_downward(uint8_t *old_p, size_t old_size, size_t new_size, size_t in_use_back, size_t in_use_front) override;
+
+		inline void setSizeHint(size_t sizeHint) {
+			_sizeHint = sizeHint;
+		}
+
+		inline PacketPool& pool() const {
+			return _pool;
+		}
+	};
+
+private:
+	/**
+	 * @brief Hidden in front of every buffer - also used as free list node
+	 */
+	struct alignas(16) Block {
+		PacketPool* pool;
+		union {
+			Block* next;
+			size_t capacity;
+		};
+		int sizeClass;
+	};
+
+	/**
+	 * @brief Buffers that were freed by any thread. Blocks are only pushed one by one and taken
+	 * out as a whole list by the allocating threads - this keeps the stack free of the ABA problem.
+	 */
+	struct SizeClass {
+		std::atomic<Block*> free { nullptr };
+		std::atomic_size_t freeCount { 0u };
+	};
+
+	/**
+	 * @brief Per thread free lists - the allocating thread (usually the game loop) only touches the
+	 * shared lists if its own list is empty. A thread that only frees (the network thread) hands its
+	 * list over to the shared list once it is full.
+	 */
+	struct ThreadCache {
+		const PacketPool* pool = nullptr;
+		Block* free[SizeClasses] {};
+		Block* tail[SizeClasses] {};
+		size_t freeCount[SizeClasses] {};
+		~ThreadCache();
+		void reset(const PacketPool* newPool);
+	};
+	static constexpr size_t MaxThreadCacheBlocks = 64u;
+
+	SizeClass _sizeClasses[SizeClasses];
+	size_t _maxFreeBlocks[SizeClasses];
+
+	std::atomic_uint64_t _misses { 0u };
+	std::atomic_uint64_t _oversized { 0u };
+	std::atomic_uint64_t _dropped { 0u };
+
+	static ThreadCache& threadCache();
+	static void freeList(Block* b);
+	void push(int index, Block* head, Block* tail, size_t count);
+	static inline Block* block(const uint8_t* p) {
+		return (Block*)p - 1;
+	}
+
+	static void freePacket(ENetPacket* packet);
+public:
+	/**
+	 * @param[in] maxFreeBytes The amount of memory that is (roughly) kept in the free list of each size class
+	 */
+	PacketPool(size_t maxFreeBytes = 4u * 1024u * 1024u);
+	~PacketPool();
+
+	/**
+	 * @brief The pool that is shared by all @c PacketBuilder instances by default
+	 */
+	static PacketPool& get();
+
+	/**
+	 * @return The size class index for the given buffer size or @c -1 if the buffer is too big to get pooled
+	 */
+	static int sizeClass(size_t size);
+
+	/**
+	 * @return The buffer size of the given size class index
+	 */
+	static constexpr size_t sizeClassSize(int index) {
+		return (index & 1) ? (size_t)3u << (MinSizeClassShift + index / 2 - 1) : (size_t)1u << (MinSizeClassShift + index / 2);
+	}
+
+	/**
+	 * @return The usable size of a buffer returned by @c allocate()
+	 */
+	static size_t capacity(const uint8_t* p);
+
+	uint8_t* allocate(size_t size);
+	/**
+	 * @note The buffer is returned to the pool it was allocated from
+	 */
+	static void deallocate(uint8_t* p);
+
+	/**
+	 * @brief Creates an enet packet that takes over the given buffer without copying it. The
+	 * buffer is returned to its pool once enet destroys the packet.
+	 * @param[in] raw Buffer that was allocated by a pool
+	 * @param[in] offset The offset of the packet data in the buffer
+	 * @param[in] size The size of the packet data
+	 * @return @c nullptr on error - the buffer is freed in this case
+	 */
+	static ENetPacket* createPacket(uint8_t* raw, size_t offset, size_t size, uint32_t flags);
+
+	/**
+	 * @brief Frees all pooled buffers
+	 */
+	void shrink();
+
+	Stats stats() const;
+};
+
+namespace priv {
+/**
+ * @brief Makes sure that the allocator is constructed before and destroyed after the builder
+ */
+struct PacketBuilderAllocator {
+	PacketPool::Allocator _allocator;
+	PacketBuilderAllocator(PacketPool& pool) : _allocator(pool) {
+	}
+};
+}
+
+/**
+ * @brief FlatBufferBuilder that builds the messages directly into pooled packet buffers
+ * @sa PacketPool
+ */
+class PacketBuilder : private priv::PacketBuilderAllocator, public flatbuffers::FlatBufferBuilder {
+private:
+	using Super = flatbuffers::FlatBufferBuilder;
+public:
+	PacketBuilder(size_t initialSize = 256u, PacketPool& pool = PacketPool::get()) :
+			priv::PacketBuilderAllocator(pool), Super(initialSize, &_allocator) {
+	}
+
+	/**
+	 * @brief Moves the finished buffer into a new enet packet without copying it. The builder can be reused
+	 * for the next message - which is built into a buffer of the size of this one.
+	 * @return @c nullptr on error
+	 */
+	ENetPacket* createPacket(uint32_t flags);
+};
+
+}
@@ -0,0 +1,185 @@
+/**
+ * @file
+ */
+
+#include "SendScheduler.h"
+#include "core/Common.h"
+
+namespace network {
+
+Channel channel(ServerMsgType type) {
+	switch (type) {
+	case ServerMsgType::EntityUpdate:
+		return Channel::Movement;
+	case ServerMsgType::AttribUpdate:
+	case ServerMsgType::StartCooldown:
+	case ServerMsgType::StopCooldown:
+		return Channel::State;
+	default:
+		return Channel::Session;
+	}
+}
+
+static inline uint64_t entityKey(ServerMsgType type, int64_t entityId) {
+	return ((uint64_t)std::enum_value(type) << 56) | ((uint64_t)entityId & 0x00FFFFFFFFFFFFFFull);
+}
+
+SendHint sendHint(ServerMsgType type, int64_t entityId) {
+	SendHint hint;
+	switch (type) {
+	case ServerMsgType::EntityUpdate:
+		hint.priority = SendPriorityLow;
+		// the update contains the complete state - only the latest one is needed
+		hint.key = entityKey(type, entityId);
+		break;
+	case ServerMsgType::EntityRemove:
+		hint.priority = SendPriorityCritical;
+		// don't send updates for an entity that is removed anyway
+		if (entityId != 0) {
+			hint.cancels = entityKey(ServerMsgType::EntityUpdate, entityId);
+		}
+		break;
+	case ServerMsgType::AttribUpdate:
+		// only the dirty values are part of the message - this can't get replaced
+		hint.priority = SendPriorityNormal;
+		break;
+	case ServerMsgType::StartCooldown:
+	case ServerMsgType::StopCooldown:
+		hint.priority = SendPriorityHigh;
+		break;
+	default:
+		hint.priority = SendPriorityCritical;
+		break;
+	}
+	return hint;
+}
+
+SendHint relevance(const SendHint& hint, float distance, bool attacking) {
+	if (hint.priority >= SendPriorityCritical) {
+		return hint;
+	}
+	// lose one priority point per two units of distance - but not more than half the way down to the next priority
+	constexpr float StepsPerUnit = 0.5f;
+	constexpr int MaxFalloff = (SendPriorityNormal - SendPriorityLow) / 2;
+	const int falloff = core_min((int)(core_max(distance, 0.0f) * StepsPerUnit), MaxFalloff);
+	int priority = (int)hint.priority - falloff;
+	if (attacking) {
+		priority += SendPriorityHigh - SendPriorityNormal;
+	}
+	SendHint h = hint;
+	h.priority = (uint8_t)core_max(1, core_min(priority, SendPriorityCritical - 1));
+	return h;
+}
+
+SendScheduler::SendScheduler(uint32_t budget, uint32_t maxAgeTicks) :
+		_budget(budget), _maxAgeTicks(maxAgeTicks) {
+}
+
+SendScheduler::~SendScheduler() {
+	clear();
+}
+
+void SendScheduler::setBudget(uint32_t budget) {
+	_budget = budget;
+}
+
+void SendScheduler::release(ENetPacket* packet) {
+	--packet->referenceCount;
+	if (packet->referenceCount == 0) {
+		enet_packet_destroy(packet);
+	}
+}
+
+uint8_t SendScheduler::effectivePriority(const Entry& entry, uint32_t tick) {
+	const uint32_t aging = (tick - entry.firstTick) * AgingPerTick;
+	return (uint8_t)core_min((uint32_t)entry.priority + aging, (uint32_t)SendPriorityCritical);
+}
+
+void SendScheduler::queue(ENetPeer* peer, ENetPacket* packet, uint8_t channel, const SendHint& hint) {
+	++packet->referenceCount;
+	std::vector<Entry>& entries = _queues[peer].entries;
+	if (hint.key != 0u) {
+		for (Entry& e : entries) {
+			if (e.cancels == hint.key) {
+				// a queued packet made this one obsolete
+				release(packet);
+				++_stats.coalesced;
+				return;
+			}
+			if (e.key != hint.key) {
+				continue;
+			}
+			release(e.packet);
+			e.packet = packet;
+			e.queuedTick = _tick;
+			e.channel = channel;
+			e.priority = core_max(e.priority, hint.priority);
+			++_stats.coalesced;
+			return;
+		}
+	}
+	if (hint.cancels != 0u) {
+		auto keep = entries.begin();
+		for (auto e = entries.begin(); e != entries.end(); ++e) {
+			if (e->key == hint.cancels) {
+				release(e->packet);
+				++_stats.coalesced;
+				continue;
+			}
+			*keep++ = *e;
+		}
+		entries.erase(keep, entries.end());
+	}
+	Entry e;
+	e.packet = packet;
+	e.key = hint.key;
+	e.cancels = hint.cancels;
+	e.sequence = _sequence++;
+	e.firstTick = _tick;
+	e.queuedTick = _tick;
+	e.priority = hint.priority;
+	e.channel = channel;
+	e.effectivePriority = hint.priority;
+	entries.push_back(e);
+}
+
+void SendScheduler::remove(ENetPeer* peer) {
+	auto i = _queues.find(peer);
+	if (i == _queues.end()) {
+		return;
+	}
+	for (Entry& e : i->second.entries) {
+		release(e.packet);
+	}
+	_queues.erase(i);
+}
+
+void SendScheduler::clear() {
+	for (auto& i : _queues) {
+		for (Entry& e : i.second.entries) {
+			release(e.packet);
+		}
+	}
+	_queues.clear();
+}
+
+size_t SendScheduler::size(ENetPeer* peer) const {
+	auto i = _queues.find(peer);
+	if (i == _queues.end()) {
+		return 0u;
+	}
+	return i->second.entries.size();
+}
+
+SendScheduler::Stats SendScheduler::stats(bool reset) {
+	const Stats stats = _stats;
+	if (reset) {
+		_stats.sentPackets = 0u;
+		_stats.sentBytes = 0u;
+		_stats.coalesced = 0u;
+		_stats.dropped = 0u;
+	}
+	return stats;
+}
+
+}
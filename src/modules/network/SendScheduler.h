@@ -0,0 +1,224 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "Network.h"
+#include "ServerMessages_generated.h"
+#include <enet/enet.h>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+#include <stdint.h>
+
+namespace network {
+
+/**
+ * @brief Higher priorities are sent first if the send budget of a peer is exhausted
+ */
+enum SendPriority : uint8_t {
+	SendPriorityLow = 64u,
+	SendPriorityNormal = 128u,
+	SendPriorityHigh = 192u,
+	SendPriorityCritical = 255u
+};
+
+/**
+ * @brief Tells the @c SendScheduler how to handle a packet for a particular peer
+ */
+struct SendHint {
+	uint8_t priority = SendPriorityNormal;
+	// queued packets with the same key replace each other - 0 means that the packet is never replaced
+	uint64_t key = 0u;
+	// queued packets with this key are obsolete once this packet is queued - and are not queued anymore
+	// as long as this packet waits in the queue. E.g. the updates of an entity that is removed.
+	uint64_t cancels = 0u;
+};
+
+/**
+ * @return The channel the given message type is sent on
+ */
+extern Channel channel(ServerMsgType type);
+
+/**
+ * @brief The hint for the given message type. Entity updates for the same entity replace each other and
+ * are dropped once the remove message of the entity is queued.
+ * @param[in] entityId The entity the message is about
+ */
+extern SendHint sendHint(ServerMsgType type, int64_t entityId = 0);
+
+/**
+ * @brief Lowers the priority of messages about far away entities and raises it for the entities that
+ * have the receiver as their aggro target.
+ * @param[in] distance The distance between the receiver and the entity the message is about
+ * @param[in] attacking @c true if the receiver is the aggro target of the entity the message is about
+ */
+extern SendHint relevance(const SendHint& hint, float distance, bool attacking);
+
+/**
+ * @brief Per peer send queues with a byte budget per tick
+ *
+ * The queued packets of a peer are sent by priority until the budget of the tick is used up. The rest
+ * stays queued and gains priority with every tick it has to wait. Queued packets with the same key are
+ * replaced by the newer one - e.g. the position updates of an entity. Unreliable packets that waited for
+ * too long are dropped - reliable packets are never dropped.
+ *
+ * A packet that is bigger than the remaining budget is still sent if there is budget left - the
+ * peer is in debt for the next ticks then.
+ *
+ * @note Not thread safe - this must be used by the thread that owns the enet host
+ */
+class SendScheduler {
+public:
+	// the interval of the scheduler ticks
+	static constexpr uint32_t TickMillis = 50u;
+	// the priority that a queued packet gains for every tick it has to wait
+	static constexpr uint8_t AgingPerTick = 8u;
+
+	struct Stats {
+		uint64_t sentPackets = 0u;
+		uint64_t sentBytes = 0u;
+		// packets that were replaced by a newer packet with the same key or canceled by a newer packet
+		uint64_t coalesced = 0u;
+		// unreliable packets that waited too long
+		uint64_t dropped = 0u;
+		// packets that were left in the queues at the end of the last tick
+		uint32_t deferred = 0u;
+		// peers with packets left in the queue at the end of the last tick
+		uint32_t congestedPeers = 0u;
+	};
+
+private:
+	struct Entry {
+		ENetPacket* packet;
+		uint64_t key;
+		uint64_t cancels;
+		// used to keep the order of the packets with the same priority
+		uint64_t sequence;
+		// the tick the entry was queued first - a replaced packet keeps its age
+		uint32_t firstTick;
+		// the tick the current packet was queued
+		uint32_t queuedTick;
+		uint8_t priority;
+		uint8_t channel;
+		// the priority including the aging - only valid while sorting
+		uint8_t effectivePriority;
+	};
+
+	struct PeerQueue {
+		std::vector<Entry> entries;
+		int64_t credit = 0;
+	};
+
+	std::unordered_map<ENetPeer*, PeerQueue> _queues;
+	uint32_t _budget;
+	uint32_t _maxAgeTicks;
+	uint32_t _tick = 0u;
+	uint64_t _sequence = 0u;
+	Stats _stats;
+
+	static void release(ENetPacket* packet);
+	static uint8_t effectivePriority(const Entry& entry, uint32_t tick);
+public:
+	/**
+	 * @param[in] budget The bytes that can be sent to a peer per tick - @c 0 means unlimited
+	 * @param[in] maxAgeTicks Unreliable packets that were queued for more than this amount of ticks are dropped
+	 */
+	SendScheduler(uint32_t budget = 0u, uint32_t maxAgeTicks = 20u);
+	~SendScheduler();
+
+	void setBudget(uint32_t budget);
+	uint32_t budget() const;
+
+	/**
+	 * @brief Queues the packet for the peer and increases the reference count of the packet
+	 */
+	void queue(ENetPeer* peer, ENetPacket* packet, uint8_t channel, const SendHint& hint);
+
+	/**
+	 * @brief Sends the queued packets of all peers with respect to the budget
+	 * @param[in] send The functor that hands a packet over to enet: bool(ENetPeer*, uint8_t channel, ENetPacket*)
+	 */
+	template<class FUNC>
+	void tick(FUNC&& send);
+
+	/**
+	 * @brief Releases the queued packets of the peer
+	 */
+	void remove(ENetPeer* peer);
+	void clear();
+
+	/**
+	 * @return The amount of queued packets for the given peer
+	 */
+	size_t size(ENetPeer* peer) const;
+
+	/**
+	 * @param[in] reset Reset the counters - the values of the last tick are kept
+	 */
+	Stats stats(bool reset = true);
+};
+
+inline uint32_t SendScheduler::budget() const {
+	return _budget;
+}
+
+template<class FUNC>
+void SendScheduler::tick(FUNC&& send) {
+	++_tick;
+	_stats.deferred = 0u;
+	_stats.congestedPeers = 0u;
+	for (auto i = _queues.begin(); i != _queues.end();) {
+		PeerQueue& queue = i->second;
+		std::vector<Entry>& entries = queue.entries;
+		// unused budget is not carried over to the next tick - but the debt is
+		queue.credit = _budget == 0u ? INT64_MAX : std::min(queue.credit + (int64_t)_budget, (int64_t)_budget);
+		if (entries.empty()) {
+			if (queue.credit >= (int64_t)_budget) {
+				i = _queues.erase(i);
+			} else {
+				++i;
+			}
+			continue;
+		}
+		ENetPeer* peer = i->first;
+		for (Entry& e : entries) {
+			e.effectivePriority = effectivePriority(e, _tick);
+		}
+		std::sort(entries.begin(), entries.end(), [] (const Entry& a, const Entry& b) {
+			if (a.effectivePriority != b.effectivePriority) {
+				return a.effectivePriority > b.effectivePriority;
+			}
+			return a.sequence < b.sequence;
+		});
+		size_t sent = 0u;
+		for (; sent < entries.size() && queue.credit > 0; ++sent) {
+			Entry& e = entries[sent];
+			if (send(peer, e.channel, e.packet)) {
+				++_stats.sentPackets;
+				_stats.sentBytes += e.packet->dataLength;
+			}
+			queue.credit -= (int64_t)e.packet->dataLength;
+			release(e.packet);
+		}
+		auto keep = entries.begin();
+		for (auto e = entries.begin() + sent; e != entries.end(); ++e) {
+			const bool reliable = (e->packet->flags & ENET_PACKET_FLAG_RELIABLE) != 0;
+			if (!reliable && _tick - e->queuedTick > _maxAgeTicks) {
+				++_stats.dropped;
+				release(e->packet);
+				continue;
+			}
+			*keep++ = *e;
+		}
+		entries.erase(keep, entries.end());
+		if (!entries.empty()) {
+			_stats.deferred += (uint32_t)entries.size();
+			++_stats.congestedPeers;
+		}
+		++i;
+	}
+}
+
+}
@@ -9,44 +9,51 @@
 
 namespace network {
 
-inline ENetPacket* createServerPacket(FlatBufferBuilder& fbb, ServerMsgType type, Offset<void> data, uint32_t flags) {
+inline ENetPacket* createServerPacket(PacketBuilder& fbb, ServerMsgType type, Offset<void> data, uint32_t flags) {
 	auto msg = CreateServerMessage(fbb, type, data);
 	FinishServerMessageBuffer(fbb, msg);
-	ENetPacket* packet = enet_packet_create(fbb.GetBufferPointer(), fbb.GetSize(), flags);
 	Log::trace("Create server package: %s - size %ui", EnumNameServerMsgType(type), fbb.GetSize());
-	return packet;
+	return fbb.createPacket(flags);
 }
 
 ServerMessageSender::ServerMessageSender(const ServerNetworkPtr& network) :
 		_network(network) {
 }
 
-void ServerMessageSender::sendServerMessage(ENetPeer* peer, FlatBufferBuilder& fbb, ServerMsgType type, Offset<void> data, uint32_t flags) {
+void ServerMessageSender::sendServerMessage(ENetPeer* peer, PacketBuilder& fbb, ServerMsgType type, Offset<void> data, uint32_t flags) {
 	core_assert(peer != nullptr);
 	sendServerMessage(&peer, 1, fbb, type, data, flags);
 }
 
-void ServerMessageSender::sendServerMessage(ENetPeer** peers, int numPeers, FlatBufferBuilder& fbb, ServerMsgType type, Offset<void> data, uint32_t flags) {
+void ServerMessageSender::sendServerMessage(ENetPeer** peers, int numPeers, PacketBuilder& fbb, ServerMsgType type, Offset<void> data, uint32_t flags) {
+	sendServerMessage(peers, nullptr, numPeers, fbb, type, data, flags);
+}
+
+void ServerMessageSender::sendServerMessage(ENetPeer* peer, const SendHint& hint, PacketBuilder& fbb, ServerMsgType type, Offset<void> data, uint32_t flags) {
+	core_assert(peer != nullptr);
+	sendServerMessage(&peer, &hint, 1, fbb, type, data, flags);
+}
+
+void ServerMessageSender::sendServerMessage(ENetPeer** peers, const SendHint* hints, int numPeers, PacketBuilder& fbb, ServerMsgType type, Offset<void> data, uint32_t flags) {
 	Log::debug("Send %s", EnumNameServerMsgType(type));
 	core_assert(numPeers > 0);
 	auto packet = createServerPacket(fbb, type, data, flags);
-	{
-		// TODO: lock
-		for (int i = 0; i < numPeers; ++i) {
-			if (!_network->sendMessage(peers[i], packet)) {
-				Log::warn("Could not send message of type %i to peer %i", (int)type, i);
-			}
-		}
+	const int channelId = std::enum_value(channel(type));
+	bool sent;
+	if (hints == nullptr) {
+		sent = _network->sendMessage(peers, numPeers, packet, channelId, sendHint(type));
+	} else {
+		sent = _network->sendMessage(peers, numPeers, packet, channelId, hints);
+	}
+	if (!sent) {
+		Log::warn("Could not send message of type %i to %i peers", (int)type, numPeers);
 	}
 	fbb.Clear();
 }
 
-void ServerMessageSender::broadcastServerMessage(FlatBufferBuilder& fbb, ServerMsgType type, Offset<void> data, int channel, uint32_t flags) {
+void ServerMessageSender::broadcastServerMessage(PacketBuilder& fbb, ServerMsgType type, Offset<void> data, int channel, uint32_t flags) {
 	Log::debug("Broadcast %s", EnumNameServerMsgType(type));
-	{
-		// TODO: lock
-		_network->broadcast(createServerPacket(fbb, type, data, flags), channel);
-	}
+	_network->broadcast(createServerPacket(fbb, type, data, flags), channel);
 	fbb.Clear();
 }
 
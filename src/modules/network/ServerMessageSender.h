@@ -6,6 +6,7 @@
 
 #include "ServerMessages_generated.h"
 #include "ServerNetwork.h"
+#include "PacketPool.h"
 #include <memory>
 
 namespace network {
@@ -14,6 +15,12 @@ using namespace flatbuffers;
 
 /**
  * @brief Send messages from the server to the client(s)
+ *
+ * The messages are built into pooled buffers by the @c PacketBuilder and are handed over to enet without
+ * copying them. The builder can be reused for the next message after sending.
+ *
+ * The channel is picked by the message type (see @c network::channel()). Without explicit @c SendHint
+ * the priority is derived from the message type, too.
  */
 class ServerMessageSender {
 private:
@@ -22,15 +29,20 @@ private:
 public:
 	ServerMessageSender(const ServerNetworkPtr& network);
 
-	void sendServerMessage(ENetPeer* peer, FlatBufferBuilder& fbb, ServerMsgType type, Offset<void> data, uint32_t flags = ENET_PACKET_FLAG_RELIABLE);
-	void sendServerMessage(std::vector<ENetPeer*> peers, FlatBufferBuilder& fbb, ServerMsgType type, Offset<void> data, uint32_t flags = ENET_PACKET_FLAG_RELIABLE);
-	void sendServerMessage(ENetPeer** peers, int numPeers, FlatBufferBuilder& fbb, ServerMsgType type, Offset<void> data, uint32_t flags = ENET_PACKET_FLAG_RELIABLE);
-	void broadcastServerMessage(FlatBufferBuilder& fbb, ServerMsgType type, Offset<void> data, int channel = 0, uint32_t flags = ENET_PACKET_FLAG_RELIABLE);
+	void sendServerMessage(ENetPeer* peer, PacketBuilder& fbb, ServerMsgType type, Offset<void> data, uint32_t flags = ENET_PACKET_FLAG_RELIABLE);
+	void sendServerMessage(std::vector<ENetPeer*> peers, PacketBuilder& fbb, ServerMsgType type, Offset<void> data, uint32_t flags = ENET_PACKET_FLAG_RELIABLE);
+	void sendServerMessage(ENetPeer** peers, int numPeers, PacketBuilder& fbb, ServerMsgType type, Offset<void> data, uint32_t flags = ENET_PACKET_FLAG_RELIABLE);
+	/**
+	 * @param[in] hints One @c SendHint per peer
+	 */
+	void sendServerMessage(ENetPeer** peers, const SendHint* hints, int numPeers, PacketBuilder& fbb, ServerMsgType type, Offset<void> data, uint32_t flags = ENET_PACKET_FLAG_RELIABLE);
+	void sendServerMessage(ENetPeer* peer, const SendHint& hint, PacketBuilder& fbb, ServerMsgType type, Offset<void> data, uint32_t flags = ENET_PACKET_FLAG_RELIABLE);
+	void broadcastServerMessage(PacketBuilder& fbb, ServerMsgType type, Offset<void> data, int channel = 0, uint32_t flags = ENET_PACKET_FLAG_RELIABLE);
 };
 
 typedef std::shared_ptr<ServerMessageSender> ServerMessageSenderPtr;
 
-inline void ServerMessageSender::sendServerMessage(std::vector<ENetPeer*> peers, FlatBufferBuilder& fbb, ServerMsgType type, Offset<void> data, uint32_t flags) {
+inline void ServerMessageSender::sendServerMessage(std::vector<ENetPeer*> peers, PacketBuilder& fbb, ServerMsgType type, Offset<void> data, uint32_t flags) {
 	sendServerMessage(&peers.front(), peers.size(), fbb, type, data, flags);
 }
 
@@ -4,15 +4,27 @@
 
 #include "ClientMessages_generated.h"
 #include "ServerNetwork.h"
+#include "NetworkEvents.h"
+#include "core/Concurrency.h"
+#include "core/Common.h"
 #include "core/Trace.h"
 #include "core/Log.h"
+#include <chrono>
 
 namespace network {
 
+static inline uint64_t nowNanos() {
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 ServerNetwork::ServerNetwork(const ProtocolHandlerRegistryPtr& protocolHandlerRegistry, const core::EventBusPtr& eventBus) :
 		Super(protocolHandlerRegistry, eventBus) {
 }
 
+ServerNetwork::~ServerNetwork() {
+	shutdown();
+}
+
 bool ServerNetwork::packetReceived(ENetEvent& event) {
 	flatbuffers::Verifier v(event.packet->data, event.packet->dataLength);
 
@@ -29,11 +41,23 @@ bool ServerNetwork::packetReceived(ENetEvent& event) {
 		return false;
 	}
 	Log::debug("Received %s", clientMsgType);
-	handler->execute(event.peer, reinterpret_cast<const flatbuffers::Table*>(req->data()));
+	Inbound inbound;
+	inbound.type = Inbound::Type::Receive;
+	inbound.peer = event.peer;
+	inbound.packet = event.packet;
+	inbound.handler = std::move(handler);
+	inbound.message = req->data();
+	inbound.receivedNanos = nowNanos();
+	// the caller made sure that there is room in the ring - the packet is owned by the entry now
+	if (!_inbound.push(std::move(inbound))) {
+		Log::error("Inbound network queue is full - dropping %s", clientMsgType);
+		enet_packet_destroy(event.packet);
+	}
+	event.packet = nullptr;
 	return true;
 }
 
-bool ServerNetwork::bind(uint16_t port, const std::string& hostname, int maxPeers, int maxChannels) {
+bool ServerNetwork::bind(uint16_t port, const std::string& hostname, int maxPeers, int maxChannels, uint32_t outgoingBandwidth) {
 	if (_server) {
 		Log::error("There is already a server socket opened");
 		return false;
@@ -60,40 +84,361 @@ bool ServerNetwork::bind(uint16_t port, const std::string& hostname, int maxPeer
 			maxPeers,
 			maxChannels,
 			0, /* assume any amount of incoming bandwidth */
-			0 /* assume any amount of outgoing bandwidth */
+			outgoingBandwidth
 			);
 	if (_server == nullptr) {
 		Log::error("Failed to create host");
 		return false;
 	}
 	enet_host_compress_with_range_coder(_server);
+	_connections.assign(_server->peerCount, 0u);
+	_appliedConnections.reset(new std::atomic_uint32_t[_server->peerCount]);
+	for (size_t i = 0; i < _server->peerCount; ++i) {
+		_appliedConnections[i] = 0u;
+	}
 	return true;
 }
 
-bool ServerNetwork::broadcast(ENetPacket* packet, int channel) {
+uint32_t ServerNetwork::nextConnection(ENetPeer* peer) {
+	return ++_connections[peer->incomingPeerID];
+}
+
+bool ServerNetwork::start() {
 	if (_server == nullptr) {
+		Log::error("The server socket must be bound before the network thread is started");
+		return false;
+	}
+	if (_running) {
+		return true;
+	}
+	_running = true;
+	_thread = std::thread([this] () {
+		run();
+	});
+	return true;
+}
+
+void ServerNetwork::run() {
+	core::setThreadName("network");
+	core_trace_thread("network");
+	while (_running) {
+		core_trace_scoped(NetworkThread);
+		// wait a little bit for events to not burn the cpu - but short enough to keep the outbound latency low
+		service(1);
+	}
+}
+
+void ServerNetwork::service(uint32_t timeoutMillis) {
+	flushOutbound();
+	schedule();
+	ENetEvent event;
+	for (;;) {
+		// stop servicing if the game loop doesn't keep up - enet keeps the packets until there is room again
+		if (_inbound.size() >= _inbound.capacity()) {
+			_inboundStalls.fetch_add(1u, std::memory_order_relaxed);
+			break;
+		}
+		if (enet_host_service(_server, &event, timeoutMillis) <= 0) {
+			break;
+		}
+		timeoutMillis = 0u;
+		core_trace_scoped(NetworkEventHandling);
+		switch (event.type) {
+		case ENET_EVENT_TYPE_CONNECT: {
+			Log::info("New connection event received");
+			// the peer slot might have been used by a previous connection
+			_scheduler.remove(event.peer);
+			Inbound inbound;
+			inbound.type = Inbound::Type::Connect;
+			inbound.generation = nextConnection(event.peer);
+			inbound.peer = event.peer;
+			inbound.receivedNanos = nowNanos();
+			_inbound.push(std::move(inbound));
+			break;
+		}
+		case ENET_EVENT_TYPE_RECEIVE: {
+			core_trace_scoped(NetworkPacket);
+			Log::trace("Package received");
+			if (!packetReceived(event)) {
+				Log::error("Failure while receiving a package - disconnecting now...");
+				enet_packet_destroy(event.packet);
+				enet_peer_disconnect(event.peer, std::enum_value(DisconnectReason::ProtocolError));
+				if (event.peer->state == ENET_PEER_STATE_DISCONNECTED) {
+					nextConnection(event.peer);
+					Inbound inbound;
+					inbound.type = Inbound::Type::Disconnect;
+					inbound.reason = DisconnectReason::ProtocolError;
+					inbound.peer = event.peer;
+					inbound.receivedNanos = nowNanos();
+					_inbound.push(std::move(inbound));
+				}
+			}
+			break;
+		}
+		case ENET_EVENT_TYPE_DISCONNECT: {
+			Log::info("New disconnect event received");
+			_scheduler.remove(event.peer);
+			nextConnection(event.peer);
+			Inbound inbound;
+			inbound.type = Inbound::Type::Disconnect;
+			inbound.reason = (DisconnectReason)event.data;
+			inbound.peer = event.peer;
+			inbound.receivedNanos = nowNanos();
+			_inbound.push(std::move(inbound));
+			break;
+		}
+		case ENET_EVENT_TYPE_NONE: {
+			break;
+		}
+		}
+	}
+	flushOutbound();
+	enet_host_flush(_server);
+}
+
+bool ServerNetwork::send(ENetPeer* peer, uint8_t channel, ENetPacket* packet) {
+	if (packet->dataLength >= peer->host->maximumPacketSize) {
+		Log::error("Packet is too big: %i - max allowed is %i", (int)packet->dataLength, (int)peer->host->maximumPacketSize);
 		return false;
 	}
+	// clients that requested less channels get everything on the first one
+	if (channel >= peer->channelCount) {
+		channel = 0u;
+	}
+	if (enet_peer_send(peer, channel, packet) != 0) {
+		Log::warn("Could not send message to peer %u", peer->connectID);
+		return false;
+	}
+	return true;
+}
+
+void ServerNetwork::flushOutbound() {
+	core_trace_scoped(NetworkFlushOutbound);
+	const bool scheduled = _scheduler.budget() != 0u;
+	Outbound outbound;
+	while (_outbound.pop(outbound)) {
+		ENetPacket* packet = outbound.packet;
+		if (outbound.type == Outbound::Type::Broadcast) {
+			Log::debug("Broadcasting a message on channel %i", (int)outbound.channel);
+			enet_host_broadcast(_server, outbound.channel, packet);
+			continue;
+		}
+		if (outbound.first) {
+			++packet->referenceCount;
+		}
+		if (outbound.generation != _connections[outbound.peer->incomingPeerID]) {
+			// queued for a previous connection of this peer slot
+			_stale.fetch_add(1u, std::memory_order_relaxed);
+		} else if (scheduled) {
+			_scheduler.queue(outbound.peer, packet, outbound.channel, outbound.hint);
+		} else {
+			send(outbound.peer, outbound.channel, packet);
+		}
+		if (outbound.last) {
+			--packet->referenceCount;
+			if (packet->referenceCount == 0) {
+				enet_packet_destroy(packet);
+			}
+		}
+	}
+}
+
+void ServerNetwork::schedule() {
+	const uint64_t now = nowNanos();
+	if (now - _lastScheduleNanos < SendScheduler::TickMillis * 1000000u) {
+		return;
+	}
+	core_trace_scoped(NetworkSchedule);
+	_lastScheduleNanos = now;
+	// a disabled scheduler still sends what is left in the queues
+	_scheduler.setBudget(_sendBudget.load(std::memory_order_relaxed));
+	_scheduler.tick([this] (ENetPeer* peer, uint8_t channel, ENetPacket* packet) {
+		return send(peer, channel, packet);
+	});
+	const SendScheduler::Stats& stats = _scheduler.stats(true);
+	_sentBytes.fetch_add(stats.sentBytes, std::memory_order_relaxed);
+	_coalesced.fetch_add(stats.coalesced, std::memory_order_relaxed);
+	_dropped.fetch_add(stats.dropped, std::memory_order_relaxed);
+	_deferred.store(stats.deferred, std::memory_order_relaxed);
+	_congestedPeers.store(stats.congestedPeers, std::memory_order_relaxed);
+}
+
+void ServerNetwork::queue(Outbound&& outbound) {
+	std::unique_lock lock(_outboundMutex);
+	while (!_outbound.push(std::move(outbound))) {
+		_outboundStalls.fetch_add(1u, std::memory_order_relaxed);
+		if (!_running) {
+			// no network thread - we are the consumer, too
+			flushOutbound();
+			continue;
+		}
+		std::this_thread::yield();
+	}
+}
+
+bool ServerNetwork::sendMessage(ENetPeer* peer, ENetPacket* packet, int channel) {
+	return sendMessage(&peer, 1, packet, channel);
+}
+
+bool ServerNetwork::sendMessage(ENetPeer** peers, int numPeers, ENetPacket* packet, int channel, const SendHint* hints) {
+	return queue(peers, numPeers, packet, channel, hints, hints != nullptr);
+}
+
+bool ServerNetwork::sendMessage(ENetPeer** peers, int numPeers, ENetPacket* packet, int channel, const SendHint& hint) {
+	return queue(peers, numPeers, packet, channel, &hint, false);
+}
+
+bool ServerNetwork::queue(ENetPeer** peers, int numPeers, ENetPacket* packet, int channel, const SendHint* hints, bool hintPerPeer) {
 	if (packet == nullptr) {
 		return false;
 	}
-	Log::debug("Broadcasting a message on channel %i", channel);
-	enet_host_broadcast(_server, channel, packet);
+	if (_server == nullptr || numPeers <= 0) {
+		enet_packet_destroy(packet);
+		return false;
+	}
+	for (int i = 0; i < numPeers; ++i) {
+		Outbound outbound;
+		outbound.type = Outbound::Type::Send;
+		outbound.channel = (uint8_t)channel;
+		outbound.first = i == 0;
+		outbound.last = i == numPeers - 1;
+		outbound.peer = peers[i];
+		outbound.generation = _appliedConnections[peers[i]->incomingPeerID].load(std::memory_order_acquire);
+		outbound.packet = packet;
+		if (hints != nullptr) {
+			outbound.hint = hintPerPeer ? hints[i] : *hints;
+		}
+		queue(std::move(outbound));
+	}
 	return true;
 }
 
+bool ServerNetwork::broadcast(ENetPacket* packet, int channel) {
+	if (packet == nullptr) {
+		return false;
+	}
+	if (_server == nullptr) {
+		enet_packet_destroy(packet);
+		return false;
+	}
+	Outbound outbound;
+	outbound.type = Outbound::Type::Broadcast;
+	outbound.channel = (uint8_t)channel;
+	outbound.packet = packet;
+	queue(std::move(outbound));
+	return true;
+}
+
+void ServerNetwork::setSendBudget(uint32_t bytesPerTick) {
+	_sendBudget = bytesPerTick;
+}
+
+void ServerNetwork::apply(Inbound& inbound) {
+	switch (inbound.type) {
+	case Inbound::Type::Connect: {
+		core_trace_scoped(NetworkConnect);
+		// the packets that are queued from now on belong to this connection
+		_appliedConnections[inbound.peer->incomingPeerID].store(inbound.generation, std::memory_order_release);
+		_eventBus->publish(NewConnectionEvent(inbound.peer));
+		break;
+	}
+	case Inbound::Type::Receive: {
+		core_trace_scoped(NetworkPacket);
+		inbound.handler->execute(inbound.peer, inbound.message);
+		break;
+	}
+	case Inbound::Type::Disconnect: {
+		core_trace_scoped(NetworkDisconnect);
+		_eventBus->publish(DisconnectEvent(inbound.peer, inbound.reason));
+		// drop everything that is still sent to this connection
+		_appliedConnections[inbound.peer->incomingPeerID].store(0u, std::memory_order_release);
+		break;
+	}
+	}
+}
+
+void ServerNetwork::update() {
+	core_trace_scoped(Network);
+	if (_server == nullptr) {
+		return;
+	}
+	if (!_running) {
+		service(0);
+	}
+	// only apply what was queued when the tick reached this point - everything else is handled in the next tick
+	uint32_t n = _inbound.size();
+	Inbound inbound;
+	while (n-- > 0u && _inbound.pop(inbound)) {
+		const uint64_t latencyMicros = (nowNanos() - inbound.receivedNanos) / 1000u;
+		apply(inbound);
+		if (inbound.packet != nullptr) {
+			// the packet is not linked to the host anymore - no need to hand it back to the network thread
+			enet_packet_destroy(inbound.packet);
+		}
+		inbound = Inbound();
+		_latencySumMicros += latencyMicros;
+		if (latencyMicros > _maxLatencyMicros) {
+			_maxLatencyMicros = latencyMicros;
+		}
+		++_applied;
+	}
+}
+
+void ServerNetwork::clearInbound() {
+	Inbound inbound;
+	while (_inbound.pop(inbound)) {
+		if (inbound.packet != nullptr) {
+			enet_packet_destroy(inbound.packet);
+		}
+	}
+}
+
+ServerNetwork::Stats ServerNetwork::stats(bool reset) {
+	Stats stats;
+	stats.inboundDepth = _inbound.size();
+	stats.outboundDepth = _outbound.size();
+	stats.maxLatencyMicros = _maxLatencyMicros;
+	stats.avgLatencyMicros = _applied > 0u ? _latencySumMicros / _applied : 0u;
+	stats.applied = _applied;
+	stats.inboundStalls = _inboundStalls.load(std::memory_order_relaxed);
+	stats.outboundStalls = _outboundStalls.load(std::memory_order_relaxed);
+	stats.deferred = _deferred.load(std::memory_order_relaxed);
+	stats.congestedPeers = _congestedPeers.load(std::memory_order_relaxed);
+	if (reset) {
+		_maxLatencyMicros = 0u;
+		_latencySumMicros = 0u;
+		_applied = 0u;
+		stats.sentBytes = _sentBytes.exchange(0u, std::memory_order_relaxed);
+		stats.coalesced = _coalesced.exchange(0u, std::memory_order_relaxed);
+		stats.dropped = _dropped.exchange(0u, std::memory_order_relaxed);
+		stats.stale = _stale.exchange(0u, std::memory_order_relaxed);
+	} else {
+		stats.sentBytes = _sentBytes.load(std::memory_order_relaxed);
+		stats.coalesced = _coalesced.load(std::memory_order_relaxed);
+		stats.dropped = _dropped.load(std::memory_order_relaxed);
+		stats.stale = _stale.load(std::memory_order_relaxed);
+	}
+	return stats;
+}
+
 void ServerNetwork::shutdown() {
+	if (_running) {
+		_running = false;
+		_thread.join();
+	}
 	if (_server != nullptr) {
+		flushOutbound();
+		// send what is left in the queues
+		_scheduler.setBudget(0u);
+		_scheduler.tick([this] (ENetPeer* peer, uint8_t channel, ENetPacket* packet) {
+			return send(peer, channel, packet);
+		});
 		enet_host_flush(_server);
+		clearInbound();
 		enet_host_destroy(_server);
 	}
 	_server = nullptr;
 	Super::shutdown();
 }
 
-void ServerNetwork::update() {
-	core_trace_scoped(Network);
-	updateHost(_server);
-}
-
 }
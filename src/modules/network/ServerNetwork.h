@@ -5,23 +5,202 @@
 #pragma once
 
 #include "Network.h"
+#include "SendScheduler.h"
+#include "core/collection/ConcurrentRingBuffer.h"
+#include "core/Trace.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace network {
 
+/**
+ * @brief The server side of the network.
+ *
+ * The enet host can be serviced on a dedicated thread (see @c start()). The network thread verifies
+ * the received messages and hands them over to the game loop via a single-producer/single-consumer
+ * ring. The handlers and the network events are executed in @c update() - this is the point in the
+ * tick where the inbound messages are applied. Outgoing packets travel through a second ring back
+ * to the network thread - enet is never touched by the game loop while the thread is running.
+ *
+ * Enet reuses the peer slots. Every connection of a slot gets a new generation and the queued packets
+ * are tagged with the generation the game loop knows - packets that were queued for a previous
+ * connection of the slot are dropped instead of being delivered to the new client.
+ *
+ * Without the dedicated thread, @c update() services the host inline and then applies the messages.
+ */
 class ServerNetwork : public Network {
+public:
+	struct Stats {
+		// messages that are waiting to be applied in the game loop
+		uint32_t inboundDepth = 0u;
+		// packets that are waiting to be sent by the network thread
+		uint32_t outboundDepth = 0u;
+		// receive to apply latency of the messages that were applied since the last reset
+		uint64_t maxLatencyMicros = 0u;
+		uint64_t avgLatencyMicros = 0u;
+		uint64_t applied = 0u;
+		// how often the network thread stopped servicing the host because the game loop didn't keep up
+		uint64_t inboundStalls = 0u;
+		// how often a sender had to wait for the network thread
+		uint64_t outboundStalls = 0u;
+		// send scheduler values since the last reset - see @c setSendBudget()
+		uint64_t sentBytes = 0u;
+		uint64_t coalesced = 0u;
+		uint64_t dropped = 0u;
+		// packets that were queued for a previous connection of the peer slot
+		uint64_t stale = 0u;
+		// packets and peers that had to wait for the next scheduler tick
+		uint32_t deferred = 0u;
+		uint32_t congestedPeers = 0u;
+	};
+
 private:
-	ENetHost* _server = nullptr;
 	using Super = Network;
+
+	struct Inbound {
+		enum class Type : uint8_t {
+			Connect, Receive, Disconnect
+		};
+		Type type = Type::Receive;
+		DisconnectReason reason = DisconnectReason::Unknown;
+		ENetPeer* peer = nullptr;
+		ENetPacket* packet = nullptr;
+		ProtocolHandlerPtr handler;
+		const void* message = nullptr;
+		uint64_t receivedNanos = 0u;
+		// the connection generation of the peer slot for connect events
+		uint32_t generation = 0u;
+	};
+
+	struct Outbound {
+		enum class Type : uint8_t {
+			Send, Broadcast
+		};
+		Type type = Type::Send;
+		uint8_t channel = 0u;
+		// a packet that is sent to several peers is kept alive from the first to the last entry
+		bool first = true;
+		bool last = true;
+		ENetPeer* peer = nullptr;
+		ENetPacket* packet = nullptr;
+		SendHint hint;
+		// the connection generation of the peer slot at the time the packet was queued
+		uint32_t generation = 0u;
+	};
+
+	ENetHost* _server = nullptr;
+	core::ConcurrentRingBuffer<Inbound, 4096> _inbound;
+	core::ConcurrentRingBuffer<Outbound, 8192> _outbound;
+	// serializes the producers of the outbound ring - the entities might send from worker threads
+	core_trace_mutex(std::mutex, _outboundMutex);
+	std::thread _thread;
+	std::atomic_bool _running { false };
+
+	// the connection generations per peer slot as seen by the network thread
+	std::vector<uint32_t> _connections;
+	// the connection generations per peer slot as seen by the game loop - the queued packets are tagged with these
+	std::unique_ptr<std::atomic_uint32_t[]> _appliedConnections;
+	std::atomic_uint64_t _stale { 0u };
+
+	uint64_t _latencySumMicros = 0u;
+	uint64_t _maxLatencyMicros = 0u;
+	uint64_t _applied = 0u;
+	std::atomic_uint64_t _inboundStalls { 0u };
+	std::atomic_uint64_t _outboundStalls { 0u };
+
+	// owned by the network thread
+	SendScheduler _scheduler;
+	uint64_t _lastScheduleNanos = 0u;
+	std::atomic_uint32_t _sendBudget { 0u };
+	std::atomic_uint64_t _sentBytes { 0u };
+	std::atomic_uint64_t _coalesced { 0u };
+	std::atomic_uint64_t _dropped { 0u };
+	std::atomic_uint32_t _deferred { 0u };
+	std::atomic_uint32_t _congestedPeers { 0u };
+
+	void run();
+	/**
+	 * @brief Sends the queued packets and collects the host events into the inbound ring
+	 * @param[in] timeoutMillis The time to wait for the first event
+	 * @note Network thread (or game loop if the thread isn't running)
+	 */
+	void service(uint32_t timeoutMillis);
+	void flushOutbound();
+	/**
+	 * @brief Runs a tick of the send scheduler if the tick interval is over
+	 */
+	void schedule();
+	bool send(ENetPeer* peer, uint8_t channel, ENetPacket* packet);
+	/**
+	 * @brief Starts a new connection generation for the slot of the given peer
+	 * @note Network thread
+	 */
+	uint32_t nextConnection(ENetPeer* peer);
+	void queue(Outbound&& outbound);
+	bool queue(ENetPeer** peers, int numPeers, ENetPacket* packet, int channel, const SendHint* hints, bool hintPerPeer);
+	void apply(Inbound& inbound);
+	void clearInbound();
+
+protected:
+	/**
+	 * @brief Verifies the message and queues it for the game loop
+	 */
+	bool packetReceived(ENetEvent& event) override;
+
 public:
 	ServerNetwork(const ProtocolHandlerRegistryPtr& protocolHandlerRegistry, const core::EventBusPtr& eventBus);
+	~ServerNetwork();
 
-	bool bind(uint16_t port, const std::string& hostname = "", int maxPeers = 1024, int maxChannels = 1);
-	bool packetReceived(ENetEvent& event) override;
+	/**
+	 * @param[in] outgoingBandwidth Bytes per second - @c 0 means unlimited
+	 */
+	bool bind(uint16_t port, const std::string& hostname = "", int maxPeers = 1024, int maxChannels = 1, uint32_t outgoingBandwidth = 0u);
+
+	/**
+	 * @brief Starts the dedicated network thread - call after @c bind()
+	 */
+	bool start();
+	inline bool threaded() const {
+		return _running;
+	}
 
+	/**
+	 * @brief Queues the packet for the given peer
+	 * @note The packet is owned by the network after this call
+	 */
+	bool sendMessage(ENetPeer* peer, ENetPacket* packet, int channel = 0) override;
+	/**
+	 * @brief Queues the packet once for all the given peers
+	 * @param[in] hints One @c SendHint for each peer - or @c nullptr
+	 */
+	bool sendMessage(ENetPeer** peers, int numPeers, ENetPacket* packet, int channel = 0, const SendHint* hints = nullptr);
+	/**
+	 * @brief Queues the packet once for all the given peers - all with the same hint
+	 */
+	bool sendMessage(ENetPeer** peers, int numPeers, ENetPacket* packet, int channel, const SendHint& hint);
 	bool broadcast(ENetPacket* packet, int channel = 0);
 
+	/**
+	 * @brief The bytes that are sent to a peer per @c SendScheduler tick. If more is queued, the packets
+	 * are sent by priority and the rest waits for the next tick.
+	 * @param[in] bytesPerTick @c 0 disables the scheduler and sends everything immediately
+	 */
+	void setSendBudget(uint32_t bytesPerTick);
+
+	/**
+	 * @brief Applies the received messages by executing the protocol handlers and publishing the
+	 * connection events.
+	 */
 	void update();
 	void shutdown() override;
+
+	/**
+	 * @param[in] reset Reset the latency values that are collected in @c update()
+	 */
+	Stats stats(bool reset = true);
 };
 
 typedef std::shared_ptr<ServerNetwork> ServerNetworkPtr;
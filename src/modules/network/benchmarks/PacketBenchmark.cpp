@@ -0,0 +1,122 @@
+/**
+ * @file
+ */
+
+#include "core/benchmark/AbstractBenchmark.h"
+#include "network/PacketPool.h"
+#include "core/collection/ConcurrentRingBuffer.h"
+#include "ServerMessages_generated.h"
+#include <atomic>
+#include <string>
+#include <thread>
+
+/**
+ * @brief Compares building a server message into a builder and copying it into a new enet
+ * packet with building it directly into a pooled packet buffer.
+ *
+ * The cross thread variants destroy the packets on a second thread - like the network thread of the
+ * server does.
+ */
+class PacketBenchmark: public core::AbstractBenchmark {
+protected:
+	core::ConcurrentRingBuffer<ENetPacket*, 1024> _packets;
+	std::atomic_bool _running { false };
+	std::thread _thread;
+
+	void startDestroyThread() {
+		_running = true;
+		_thread = std::thread([this] () {
+			ENetPacket* packet;
+			for (;;) {
+				if (_packets.pop(packet)) {
+					enet_packet_destroy(packet);
+				} else if (!_running) {
+					break;
+				} else {
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+
+	void stopDestroyThread() {
+		_running = false;
+		_thread.join();
+	}
+
+	void destroy(ENetPacket* packet) {
+		while (!_packets.push(packet)) {
+			std::this_thread::yield();
+		}
+	}
+
+	template<class BUILDER>
+	static void build(BUILDER& fbb, const std::string& name) {
+		const network::Vec3 pos { 1.0f, 2.0f, 3.0f };
+		auto spawn = network::CreateUserSpawn(fbb, 1, fbb.CreateString(name), &pos);
+		auto msg = network::CreateServerMessage(fbb, network::ServerMsgType::UserSpawn, spawn.Union());
+		network::FinishServerMessageBuffer(fbb, msg);
+	}
+};
+
+BENCHMARK_DEFINE_F(PacketBenchmark, Copy) (benchmark::State& state) {
+	const std::string name(state.range(0), 'x');
+	flatbuffers::FlatBufferBuilder fbb;
+	for (auto _ : state) {
+		build(fbb, name);
+		ENetPacket* packet = enet_packet_create(fbb.GetBufferPointer(), fbb.GetSize(), ENET_PACKET_FLAG_RELIABLE);
+		fbb.Clear();
+		enet_packet_destroy(packet);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_DEFINE_F(PacketBenchmark, Pooled) (benchmark::State& state) {
+	const std::string name(state.range(0), 'x');
+	network::PacketBuilder fbb;
+	for (auto _ : state) {
+		build(fbb, name);
+		ENetPacket* packet = fbb.createPacket(ENET_PACKET_FLAG_RELIABLE);
+		fbb.Clear();
+		enet_packet_destroy(packet);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_DEFINE_F(PacketBenchmark, CopyCrossThread) (benchmark::State& state) {
+	const std::string name(state.range(0), 'x');
+	flatbuffers::FlatBufferBuilder fbb;
+	startDestroyThread();
+	for (auto _ : state) {
+		build(fbb, name);
+		ENetPacket* packet = enet_packet_create(fbb.GetBufferPointer(), fbb.GetSize(), ENET_PACKET_FLAG_RELIABLE);
+		fbb.Clear();
+		destroy(packet);
+	}
+	stopDestroyThread();
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_DEFINE_F(PacketBenchmark, PooledCrossThread) (benchmark::State& state) {
+	const std::string name(state.range(0), 'x');
+	network::PacketPool pool;
+	network::PacketBuilder fbb(256u, pool);
+	startDestroyThread();
+	for (auto _ : state) {
+		build(fbb, name);
+		ENetPacket* packet = fbb.createPacket(ENET_PACKET_FLAG_RELIABLE);
+		fbb.Clear();
+		destroy(packet);
+	}
+	stopDestroyThread();
+	state.SetItemsProcessed(state.iterations());
+	state.counters["misses"] = (double)pool.stats().misses;
+	state.counters["dropped"] = (double)pool.stats().dropped;
+}
+
+BENCHMARK_REGISTER_F(PacketBenchmark, Copy)->Arg(16)->Arg(1024)->Arg(16384);
+BENCHMARK_REGISTER_F(PacketBenchmark, Pooled)->Arg(16)->Arg(1024)->Arg(16384);
+BENCHMARK_REGISTER_F(PacketBenchmark, CopyCrossThread)->Arg(16)->Arg(1024)->Arg(16384);
+BENCHMARK_REGISTER_F(PacketBenchmark, PooledCrossThread)->Arg(16)->Arg(1024)->Arg(16384);
+
+BENCHMARK_MAIN();
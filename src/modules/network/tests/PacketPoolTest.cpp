@@ -0,0 +1,73 @@
+/**
+ * @file
+ */
+
+#include "core/tests/AbstractTest.h"
+#include "network/PacketPool.h"
+#include "ServerMessages_generated.h"
+
+namespace network {
+
+class PacketPoolTest: public core::AbstractTest {
+};
+
+TEST_F(PacketPoolTest, testSizeClass) {
+	EXPECT_EQ(0, PacketPool::sizeClass(1));
+	EXPECT_EQ(0, PacketPool::sizeClass(256));
+	EXPECT_EQ(1, PacketPool::sizeClass(257));
+	EXPECT_EQ(384u, PacketPool::sizeClassSize(1));
+	EXPECT_EQ(2, PacketPool::sizeClass(385));
+	EXPECT_EQ(512u, PacketPool::sizeClassSize(2));
+	EXPECT_EQ(PacketPool::SizeClasses - 1, PacketPool::sizeClass(1 << PacketPool::MaxSizeClassShift));
+	EXPECT_EQ(-1, PacketPool::sizeClass((1 << PacketPool::MaxSizeClassShift) + 1));
+}
+
+TEST_F(PacketPoolTest, testReuse) {
+	PacketPool pool;
+	uint8_t* first = pool.allocate(100);
+	EXPECT_EQ(256u, PacketPool::capacity(first));
+	PacketPool::deallocate(first);
+	uint8_t* second = pool.allocate(200);
+	EXPECT_EQ(first, second);
+	PacketPool::deallocate(second);
+	uint8_t* oversized = pool.allocate(100000);
+	EXPECT_EQ(100000u, PacketPool::capacity(oversized));
+	PacketPool::deallocate(oversized);
+	const PacketPool::Stats& stats = pool.stats();
+	EXPECT_EQ(1u, stats.misses);
+	EXPECT_EQ(1u, stats.oversized);
+	EXPECT_EQ(0u, stats.dropped);
+}
+
+TEST_F(PacketPoolTest, testCreatePacket) {
+	PacketPool pool;
+	PacketBuilder fbb(64u, pool);
+	// force the builder to grow
+	const std::string name(5000, 'x');
+	const Vec3 pos { 1.0f, 2.0f, 3.0f };
+	auto spawn = CreateUserSpawn(fbb, 42, fbb.CreateString(name), &pos);
+	FinishServerMessageBuffer(fbb, CreateServerMessage(fbb, ServerMsgType::UserSpawn, spawn.Union()));
+	const size_t size = fbb.GetSize();
+	ENetPacket* packet = fbb.createPacket(ENET_PACKET_FLAG_RELIABLE);
+	ASSERT_NE(nullptr, packet);
+	fbb.Clear();
+	EXPECT_EQ(size, packet->dataLength);
+
+	flatbuffers::Verifier verifier(packet->data, packet->dataLength);
+	ASSERT_TRUE(VerifyServerMessageBuffer(verifier));
+	const ServerMessage* msg = GetServerMessage(packet->data);
+	ASSERT_EQ(ServerMsgType::UserSpawn, msg->data_type());
+	const UserSpawn* userSpawn = static_cast<const UserSpawn*>(msg->data());
+	EXPECT_EQ(42, userSpawn->id());
+	EXPECT_EQ(name, userSpawn->name()->str());
+
+	enet_packet_destroy(packet);
+	// the packet buffer is reused for the next message
+	const uint64_t misses = pool.stats().misses;
+	FinishServerMessageBuffer(fbb, CreateServerMessage(fbb, ServerMsgType::UserSpawn, CreateUserSpawn(fbb, 42, fbb.CreateString(name), &pos).Union()));
+	packet = fbb.createPacket(ENET_PACKET_FLAG_RELIABLE);
+	EXPECT_EQ(misses, pool.stats().misses);
+	enet_packet_destroy(packet);
+}
+
+}
@@ -0,0 +1,156 @@
+/**
+ * @file
+ */
+
+#include "core/tests/AbstractTest.h"
+#include "network/SendScheduler.h"
+#include <vector>
+
+namespace network {
+
+class SendSchedulerTest: public core::AbstractTest {
+protected:
+	ENetPeer _peer {};
+	std::vector<uint8_t> _sent;
+
+	static ENetPacket* packet(uint8_t id, size_t size, uint32_t flags = ENET_PACKET_FLAG_RELIABLE) {
+		ENetPacket* p = enet_packet_create(nullptr, size, flags);
+		p->data[0] = id;
+		return p;
+	}
+
+	static SendHint hint(uint8_t priority, uint64_t key = 0u) {
+		SendHint h;
+		h.priority = priority;
+		h.key = key;
+		return h;
+	}
+
+	void tick(SendScheduler& scheduler) {
+		scheduler.tick([this] (ENetPeer* peer, uint8_t channel, ENetPacket* p) {
+			EXPECT_EQ(&_peer, peer);
+			_sent.push_back(p->data[0]);
+			return true;
+		});
+	}
+};
+
+TEST_F(SendSchedulerTest, testBudget) {
+	SendScheduler scheduler(100u);
+	scheduler.queue(&_peer, packet(1, 60), 0, hint(SendPriorityNormal));
+	scheduler.queue(&_peer, packet(2, 60), 0, hint(SendPriorityNormal));
+	scheduler.queue(&_peer, packet(3, 60), 0, hint(SendPriorityNormal));
+	tick(scheduler);
+	// the second packet is sent into debt
+	ASSERT_EQ(2u, _sent.size());
+	EXPECT_EQ(1u, scheduler.size(&_peer));
+	EXPECT_EQ(1u, scheduler.stats(false).congestedPeers);
+	tick(scheduler);
+	ASSERT_EQ(3u, _sent.size());
+	EXPECT_EQ(1, _sent[0]);
+	EXPECT_EQ(2, _sent[1]);
+	EXPECT_EQ(3, _sent[2]);
+	EXPECT_EQ(180u, scheduler.stats().sentBytes);
+}
+
+TEST_F(SendSchedulerTest, testUnlimited) {
+	SendScheduler scheduler;
+	for (uint8_t i = 0; i < 10; ++i) {
+		scheduler.queue(&_peer, packet(i, 1000), 0, hint(SendPriorityNormal));
+	}
+	tick(scheduler);
+	EXPECT_EQ(10u, _sent.size());
+	EXPECT_EQ(0u, scheduler.size(&_peer));
+}
+
+TEST_F(SendSchedulerTest, testPriority) {
+	SendScheduler scheduler(10u);
+	scheduler.queue(&_peer, packet(1, 10), 0, hint(SendPriorityLow));
+	scheduler.queue(&_peer, packet(2, 10), 0, hint(SendPriorityCritical));
+	scheduler.queue(&_peer, packet(3, 10), 0, hint(SendPriorityNormal));
+	tick(scheduler);
+	tick(scheduler);
+	tick(scheduler);
+	ASSERT_EQ(3u, _sent.size());
+	EXPECT_EQ(2, _sent[0]);
+	EXPECT_EQ(3, _sent[1]);
+	EXPECT_EQ(1, _sent[2]);
+}
+
+TEST_F(SendSchedulerTest, testCoalesce) {
+	SendScheduler scheduler(10u);
+	scheduler.queue(&_peer, packet(1, 10), 0, hint(SendPriorityLow, 42u));
+	scheduler.queue(&_peer, packet(2, 10), 0, hint(SendPriorityLow, 42u));
+	scheduler.queue(&_peer, packet(3, 10), 0, hint(SendPriorityLow, 43u));
+	EXPECT_EQ(2u, scheduler.size(&_peer));
+	tick(scheduler);
+	tick(scheduler);
+	ASSERT_EQ(2u, _sent.size());
+	EXPECT_EQ(2, _sent[0]) << "The newer packet should replace the queued one";
+	EXPECT_EQ(3, _sent[1]);
+	EXPECT_EQ(1u, scheduler.stats().coalesced);
+}
+
+TEST_F(SendSchedulerTest, testCancel) {
+	SendScheduler scheduler(1000u);
+	const SendHint& update = sendHint(ServerMsgType::EntityUpdate, 42);
+	const SendHint& remove = sendHint(ServerMsgType::EntityRemove, 42);
+	scheduler.queue(&_peer, packet(1, 10), 0, update);
+	scheduler.queue(&_peer, packet(2, 10), 0, sendHint(ServerMsgType::EntityUpdate, 43));
+	scheduler.queue(&_peer, packet(3, 10), 0, remove);
+	EXPECT_EQ(2u, scheduler.size(&_peer)) << "The queued update of the removed entity should be dropped";
+	scheduler.queue(&_peer, packet(4, 10), 0, update);
+	EXPECT_EQ(2u, scheduler.size(&_peer)) << "Updates of the removed entity should not be queued";
+	tick(scheduler);
+	ASSERT_EQ(2u, _sent.size());
+	EXPECT_EQ(3, _sent[0]);
+	EXPECT_EQ(2, _sent[1]);
+	EXPECT_EQ(2u, scheduler.stats().coalesced);
+}
+
+TEST_F(SendSchedulerTest, testAging) {
+	SendScheduler scheduler(10u);
+	scheduler.queue(&_peer, packet(1, 10), 0, hint(SendPriorityLow));
+	int ticks = 0;
+	// a steady stream of more important packets must not starve the low priority packet
+	while (std::find(_sent.begin(), _sent.end(), 1) == _sent.end()) {
+		ASSERT_LT(ticks, 20) << "The low priority packet was never sent";
+		scheduler.queue(&_peer, packet(2, 10), 0, hint(SendPriorityNormal));
+		tick(scheduler);
+		++ticks;
+	}
+	scheduler.clear();
+}
+
+TEST_F(SendSchedulerTest, testDropUnreliable) {
+	SendScheduler scheduler(1u, 2u);
+	// puts the peer into debt for the next ticks
+	scheduler.queue(&_peer, packet(1, 100), 0, hint(SendPriorityCritical));
+	scheduler.queue(&_peer, packet(2, 10, 0u), 0, hint(SendPriorityLow));
+	scheduler.queue(&_peer, packet(3, 10), 0, hint(SendPriorityLow));
+	for (int i = 0; i < 5; ++i) {
+		tick(scheduler);
+	}
+	ASSERT_EQ(1u, _sent.size());
+	EXPECT_EQ(1u, scheduler.size(&_peer)) << "Only the reliable packet should be left";
+	EXPECT_EQ(1u, scheduler.stats().dropped);
+	scheduler.remove(&_peer);
+	EXPECT_EQ(0u, scheduler.size(&_peer));
+}
+
+TEST_F(SendSchedulerTest, testRelevance) {
+	const SendHint& update = sendHint(ServerMsgType::EntityUpdate, 1);
+	EXPECT_NE(0u, update.key);
+	EXPECT_NE(update.key, sendHint(ServerMsgType::EntityUpdate, 2).key);
+	EXPECT_EQ(0u, sendHint(ServerMsgType::AttribUpdate, 1).key);
+	const SendHint& near = relevance(update, 1.0f, false);
+	const SendHint& far = relevance(update, 100.0f, false);
+	const SendHint& attacking = relevance(update, 100.0f, true);
+	EXPECT_GT(near.priority, far.priority);
+	EXPECT_GT(attacking.priority, far.priority);
+	EXPECT_GT(attacking.priority, near.priority);
+	const SendHint& spawn = sendHint(ServerMsgType::EntitySpawn, 1);
+	EXPECT_EQ(spawn.priority, relevance(spawn, 100.0f, false).priority);
+}
+
+}
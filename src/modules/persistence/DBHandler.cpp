@@ -86,8 +86,8 @@ bool DBHandler::truncate(Model&& model) const {
 	return exec(createTruncateTableStatement(model));
 }
 
-MassQuery DBHandler::massQuery() const {
-	return MassQuery(this);
+MassQuery DBHandler::massQuery(size_t commitSize) const {
+	return MassQuery(this, commitSize);
 }
 
 bool DBHandler::dropTable(const Model& model) const {
@@ -241,7 +241,10 @@ public:
 	 */
 	bool truncate(Model&& model) const;
 
-	MassQuery massQuery() const;
+	/**
+	 * @param[in] commitSize The amount of models that are written with one statement
+	 */
+	MassQuery massQuery(size_t commitSize = 1000u) const;
 
 	bool dropTable(const Model& model) const;
 	bool dropTable(Model&& model) const;
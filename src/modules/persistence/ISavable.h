@@ -4,11 +4,14 @@
 
 #pragma once
 
+#include <atomic>
 #include <vector>
 
 namespace persistence {
 
 class Model;
+class PersistenceMgr;
+struct SavableState;
 
 /**
  * @brief Interface used in combination with @c PersistenceMgr to do mass updates on dirty
@@ -17,11 +20,23 @@ class Model;
  * @see @c LongCounter For use in relative updates
  */
 class ISavable {
+private:
+	friend class PersistenceMgr;
+	// set while the instance is registered at a PersistenceMgr
+	std::atomic<SavableState*> _savableState { nullptr };
 protected:
 	using Models = std::vector<const Model*>;
 public:
 	virtual ~ISavable() {}
 
+	/**
+	 * @brief Queues the instance for the next persistence tick - only queued instances are asked
+	 * for their dirty models. Call this whenever the state that should be persisted changes.
+	 * @note This is lock free and can be called from any thread - but not at the same time as
+	 * @c PersistenceMgr::unregisterSavable() for this instance.
+	 */
+	void markDirty();
+
 	/**
 	 * @brief Returns pointers to the @c Model instances that you are about to push
 	 * to the database.
@@ -32,11 +32,11 @@ void MassQuery::commit() {
 	}
 }
 
-void MassQuery::add(ISavable* savable) {
+size_t MassQuery::add(ISavable* savable) {
 	core_assert(savable != nullptr);
 	std::vector<const Model*> models;
 	if (!savable->getDirtyModels(models)) {
-		return;
+		return 0u;
 	}
 	for (const Model* m : models) {
 		if (m->shouldBeDeleted()) {
@@ -48,6 +48,7 @@ void MassQuery::add(ISavable* savable) {
 	if (_insertOrUpdate.size() + _delete.size() >= _commitSize) {
 		commit();
 	}
+	return models.size();
 }
 
 }
@@ -28,7 +28,10 @@ private:
 public:
 	~MassQuery();
 
-	void add(ISavable* savable);
+	/**
+	 * @return The amount of models that were added for the given savable
+	 */
+	size_t add(ISavable* savable);
 	void commit();
 };
 
@@ -7,17 +7,66 @@
 #include "MassQuery.h"
 #include "core/Common.h"
 #include "core/Trace.h"
+#include "core/TimeProvider.h"
+#include <vector>
 
 namespace persistence {
 
-PersistenceMgr::PersistenceMgr(const DBHandlerPtr& dbHandler) :
-		_lock("persistencemgr"), _dbHandler(dbHandler) {
+void ISavable::markDirty() {
+	SavableState* state = _savableState.load(std::memory_order_acquire);
+	if (state == nullptr) {
+		return;
+	}
+	state->mgr->markDirty(state);
+}
+
+PersistenceMgr::PersistenceMgr(const DBHandlerPtr& dbHandler, size_t chunkSize) :
+		_lock("persistencemgr"), _dbHandler(dbHandler), _chunkSize(chunkSize) {
+}
+
+PersistenceMgr::~PersistenceMgr() {
+	// only if shutdown() wasn't called
+	for (auto& collection : _savables) {
+		for (auto& entry : collection.second) {
+			if (!entry.second->queued.exchange(true)) {
+				delete entry.second;
+			}
+		}
+	}
+	freeStates();
+}
+
+void PersistenceMgr::markDirty(SavableState* state) {
+	if (state->queued.exchange(true, std::memory_order_acq_rel)) {
+		return;
+	}
+	SavableState* head = _dirty.load(std::memory_order_relaxed);
+	do {
+		state->next = head;
+	} while (!_dirty.compare_exchange_weak(head, state, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void PersistenceMgr::freeStates() {
+	SavableState* state = _dirty.exchange(nullptr, std::memory_order_acquire);
+	while (state != nullptr) {
+		SavableState* next = state->next;
+		delete state;
+		state = next;
+	}
 }
 
 bool PersistenceMgr::registerSavable(uint32_t fourcc, ISavable *savable) {
 	Log::trace(logid, "Register savable (fourcc: %u, savable: %p)", fourcc, savable);
 	core::ScopedWriteLock lock(_lock);
-	_savables[fourcc].insert(savable);
+	SavableState*& state = _savables[fourcc][savable];
+	if (state != nullptr) {
+		return true;
+	}
+	state = new SavableState();
+	state->mgr = this;
+	state->savable = savable;
+	state->fourcc = fourcc;
+	savable->_savableState.store(state, std::memory_order_release);
 	return true;
 }
 
@@ -32,11 +81,16 @@ bool PersistenceMgr::unregisterSavable(uint32_t fourcc, ISavable *savable) {
 	}
 	auto s = i->second.find(savable);
 	if (s != i->second.end()) {
+		SavableState* state = s->second;
 		i->second.erase(s);
 		// make sure to persist the dirty state
-		MassQuery stmt = _dbHandler->massQuery();
+		MassQuery stmt = _dbHandler->massQuery(_chunkSize);
 		stmt.add(savable);
 		stmt.commit();
+		savable->_savableState.store(nullptr, std::memory_order_release);
+		state->savable = nullptr;
+		// the state might still be in the dirty list - it's freed by the next update
+		markDirty(state);
 		Log::trace(logid, "Removed savable (fourcc: %u, savable: %p)", fourcc, savable);
 		return true;
 	}
@@ -51,24 +105,70 @@ bool PersistenceMgr::init() {
 void PersistenceMgr::shutdown() {
 	core_trace_scoped(PersistenceMgrShutdown);
 	update(0l);
-	core::ScopedWriteLock lock(_lock);
-	_savables.clear();
+	{
+		core::ScopedWriteLock lock(_lock);
+		for (auto& collection : _savables) {
+			for (auto& entry : collection.second) {
+				entry.first->_savableState.store(nullptr, std::memory_order_release);
+				entry.second->savable = nullptr;
+				markDirty(entry.second);
+			}
+		}
+		_savables.clear();
+	}
+	freeStates();
 }
 
 void PersistenceMgr::update(long dt) {
 	core_trace_scoped(PersistenceMgrUpdate);
-	core::ScopedReadLock lock(_lock);
-	for (auto& collection : _savables) {
-		if (collection.second.empty()) {
-			continue;
+	SavableState* state = _dirty.exchange(nullptr, std::memory_order_acquire);
+	std::map<uint32_t, std::vector<SavableState*>> dirty;
+	for (; state != nullptr; state = state->next) {
+		dirty[state->fourcc].push_back(state);
+	}
+	std::map<uint32_t, Stats> stats;
+	int savables = 0;
+	{
+		core::ScopedReadLock lock(_lock);
+		for (const auto& collection : _savables) {
+			stats[collection.first];
 		}
-		MassQuery stmt = _dbHandler->massQuery();
-		for (ISavable *savable : collection.second) {
-			stmt.add(savable);
+		for (auto& collection : dirty) {
+			Stats& s = stats[collection.first];
+			const uint64_t start = core::TimeProvider::systemNanos();
+			MassQuery stmt = _dbHandler->massQuery(_chunkSize);
+			for (SavableState* savableState : collection.second) {
+				ISavable* savable = savableState->savable;
+				if (savable == nullptr) {
+					// unregistered in the meantime - unregisterSavable() already persisted it
+					delete savableState;
+					continue;
+				}
+				// clear the flag before the models are collected - a change from now on queues it again
+				savableState->queued.store(false, std::memory_order_release);
+				s.rows += stmt.add(savable);
+				++s.dirty;
+			}
+			stmt.commit();
+			s.flushMicros = (core::TimeProvider::systemNanos() - start) / 1000u;
+			savables += (int)s.dirty;
+		}
+	}
+	std::unique_lock<std::mutex> lock(_statsMutex);
+	for (auto& e : stats) {
+		const auto i = _stats.find(e.first);
+		e.second.flushes = i == _stats.end() ? 0u : i->second.flushes;
+		if (e.second.dirty > 0u) {
+			++e.second.flushes;
 		}
-		stmt.commit();
 	}
-	Log::debug(logid, "Persisted dirty states of %i savables", (int)_savables.size());
+	_stats = std::move(stats);
+	Log::debug(logid, "Persisted dirty states of %i savables", savables);
+}
+
+std::map<uint32_t, PersistenceMgr::Stats> PersistenceMgr::stats() const {
+	std::unique_lock<std::mutex> lock(_statsMutex);
+	return _stats;
 }
 
 }
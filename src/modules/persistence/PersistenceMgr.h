@@ -4,32 +4,77 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <map>
-#include <unordered_set>
+#include <mutex>
+#include <unordered_map>
 #include "ISavable.h"
 #include "DBHandler.h"
 #include "core/IComponent.h"
 #include "core/ReadWriteLock.h"
+#include "core/Trace.h"
 
 namespace persistence {
 
+/**
+ * @brief The registration of an @c ISavable - this is the node that is put into the dirty list.
+ */
+struct SavableState {
+	PersistenceMgr* mgr;
+	// nullptr once the savable was unregistered - the state is freed by the next update
+	ISavable* savable;
+	uint32_t fourcc;
+	std::atomic_bool queued { false };
+	SavableState* next = nullptr;
+};
+
 /**
  * @brief This class is responsible for calling the update mechanisms for the single components of each player.
  * It will collect all database actions in prepared statements to write delta values into the database.
+ *
+ * Only the savables that called @c ISavable::markDirty() since the last update are asked for their dirty
+ * models. They are pushed onto a lock free list that is swapped out by @c update(). The models are written
+ * in chunks of the configured size - so a single statement never blocks a connection for too long.
+ *
  * @note Your @c ISavable instances must be registered and unregistered.
  */
 class PersistenceMgr : public core::IComponent {
+public:
+	/**
+	 * @brief Per fourcc values of the last @c update() call
+	 */
+	struct Stats {
+		/** the amount of savables that were marked dirty */
+		uint32_t dirty = 0u;
+		/** the amount of models that were written */
+		uint64_t rows = 0u;
+		uint64_t flushMicros = 0u;
+		/** the amount of updates that flushed anything for this fourcc */
+		uint64_t flushes = 0u;
+	};
 private:
+	friend class ISavable;
 	static constexpr uint32_t logid = FourCC('P','E','R','M');
-	using Savables = std::unordered_set<ISavable*>;
+	using Savables = std::unordered_map<ISavable*, SavableState*>;
 	using Map = std::map<uint32_t, Savables>;
 	Map _savables;
 	core::ReadWriteLock _lock;
 	const DBHandlerPtr _dbHandler;
+	const size_t _chunkSize;
+	std::atomic<SavableState*> _dirty { nullptr };
+
+	mutable core_trace_mutex(std::mutex, _statsMutex);
+	std::map<uint32_t, Stats> _stats;
+
+	void markDirty(SavableState* state);
+	void freeStates();
 public:
-	PersistenceMgr(const DBHandlerPtr& dbHandler);
-	virtual ~PersistenceMgr() {}
+	/**
+	 * @param[in] chunkSize The max amount of models that are written with one statement
+	 */
+	PersistenceMgr(const DBHandlerPtr& dbHandler, size_t chunkSize = 100u);
+	virtual ~PersistenceMgr();
 
 	virtual bool registerSavable(uint32_t fourcc, ISavable *savable);
 	virtual bool unregisterSavable(uint32_t fourcc, ISavable *savable);
@@ -40,7 +85,15 @@ public:
 	 */
 	void shutdown() override;
 
+	/**
+	 * @brief Persists the dirty models of all savables that were marked dirty since the last call
+	 */
 	void update(long dt);
+
+	/**
+	 * @return The stats of the last update per fourcc
+	 */
+	std::map<uint32_t, Stats> stats() const;
 };
 
 typedef std::shared_ptr<PersistenceMgr> PersistenceMgrPtr;
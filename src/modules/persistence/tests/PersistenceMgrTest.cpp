@@ -50,6 +50,7 @@ public:
 		EXPECT_TRUE(mgr.init());
 		EXPECT_TRUE(mgr.registerSavable(FourCC('F','O','O','O'), this));
 		_dirtyModels.push_back(&in);
+		markDirty();
 		mgr.update(0l);
 		EXPECT_TRUE(_dirtyModels.empty());
 		EXPECT_TRUE(mgr.unregisterSavable(FourCC('F','O','O','O'), this));
@@ -97,14 +98,61 @@ TEST_F(PersistenceMgrTest, testSavable) {
 	PersistenceMgr mgr(_dbHandler);
 	EXPECT_TRUE(mgr.init());
 	EXPECT_TRUE(mgr.registerSavable(FourCC('F','O','O','O'), this));
+	markDirty();
 	mgr.update(0l);
 	EXPECT_EQ(_executeStateUpdate, 1);
+	markDirty();
 	mgr.update(0l);
 	EXPECT_EQ(_executeStateUpdate, 2);
 	EXPECT_TRUE(mgr.unregisterSavable(FourCC('F','O','O','O'), this));
 	mgr.shutdown();
 }
 
+TEST_F(PersistenceMgrTest, testOnlyDirtySavablesAreVisited) {
+	PersistenceMgr mgr(_dbHandler);
+	EXPECT_TRUE(mgr.init());
+	EXPECT_TRUE(mgr.registerSavable(FourCC('F','O','O','O'), this));
+	mgr.update(0l);
+	EXPECT_EQ(_executeStateUpdate, 0) << "The savable wasn't marked dirty";
+	markDirty();
+	markDirty();
+	mgr.update(0l);
+	EXPECT_EQ(_executeStateUpdate, 1) << "The savable should only be queued once";
+	mgr.update(0l);
+	EXPECT_EQ(_executeStateUpdate, 1);
+	const auto stats = mgr.stats();
+	ASSERT_EQ(1u, stats.size());
+	EXPECT_EQ(0u, stats.begin()->second.dirty);
+	EXPECT_EQ(1u, stats.begin()->second.flushes);
+	// unregistering persists the savable - marking it dirty afterwards is a no-op
+	EXPECT_TRUE(mgr.unregisterSavable(FourCC('F','O','O','O'), this));
+	EXPECT_EQ(_executeStateUpdate, 2);
+	markDirty();
+	mgr.update(0l);
+	EXPECT_EQ(_executeStateUpdate, 2);
+	mgr.shutdown();
+}
+
+TEST_F(PersistenceMgrTest, testUnregisterWhileQueued) {
+	PersistenceMgr mgr(_dbHandler);
+	EXPECT_TRUE(mgr.init());
+	EXPECT_TRUE(mgr.registerSavable(FourCC('F','O','O','O'), this));
+	markDirty();
+	EXPECT_TRUE(mgr.unregisterSavable(FourCC('F','O','O','O'), this));
+	EXPECT_EQ(_executeStateUpdate, 1);
+	mgr.update(0l);
+	EXPECT_EQ(_executeStateUpdate, 1);
+	EXPECT_TRUE(mgr.registerSavable(FourCC('F','O','O','O'), this));
+	markDirty();
+	mgr.update(0l);
+	EXPECT_EQ(_executeStateUpdate, 2);
+	const auto stats = mgr.stats();
+	ASSERT_EQ(1u, stats.size());
+	EXPECT_EQ(1u, stats.begin()->second.dirty);
+	EXPECT_EQ(0u, stats.begin()->second.rows);
+	mgr.shutdown();
+}
+
 TEST_F(PersistenceMgrTest, testSavableUpdate) {
 	if (!_supported) {
 		return;
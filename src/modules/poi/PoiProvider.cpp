@@ -4,9 +4,12 @@
 
 #include "PoiProvider.h"
 #include "core/TimeProvider.h"
-#include "math/Random.h"
-#include "core/Var.h"
+#include "core/Common.h"
+#include "core/Assert.h"
+#include "core/Trace.h"
 #include "core/GLM.h"
+#include <glm/geometric.hpp>
+#include <cmath>
 
 namespace poi {
 
@@ -14,44 +17,198 @@ PoiProvider::PoiProvider(const core::TimeProviderPtr& timeProvider) :
 		_timeProvider(timeProvider), _lock("PoiProvider") {
 }
 
+int PoiProvider::cellCoord(float v) {
+	return (int)std::floor(v / (float)CellSize);
+}
+
+uint64_t PoiProvider::cellKey(int x, int z) {
+	return ((uint64_t)(uint32_t)x << 32) | (uint64_t)(uint32_t)z;
+}
+
+void PoiProvider::swapRemove(std::vector<uint32_t>& list, uint32_t index, std::vector<Poi>& pois, uint32_t Poi::*member) {
+	const uint32_t last = list.back();
+	list[index] = last;
+	pois[last].*member = index;
+	list.pop_back();
+}
+
+void PoiProvider::remove(uint32_t index) {
+	const Poi& poi = _pois[index];
+	swapRemove(_all, poi.allIndex, _pois, &Poi::allIndex);
+	swapRemove(_types[(int)poi.type], poi.typeIndex, _pois, &Poi::typeIndex);
+	Grid& grid = _grids[(int)poi.type];
+	auto i = grid.find(poi.cell);
+	core_assert(i != grid.end());
+	swapRemove(i->second, poi.cellIndex, _pois, &Poi::cellIndex);
+	if (i->second.empty()) {
+		grid.erase(i);
+	}
+	swapRemove(_buckets[(poi.time / BucketMillis) % Buckets], poi.bucketIndex, _pois, &Poi::bucketIndex);
+	_freePois.push_back(index);
+}
+
 void PoiProvider::update(long /*dt*/) {
-	constexpr uint64_t seconds = 60L * 1000L;
+	core_trace_scoped(PoiProviderUpdate);
 	const uint64_t currentMillis = _timeProvider->tickMillis();
+	if (currentMillis < LifetimeMillis) {
+		return;
+	}
+	const uint64_t lastSecond = (currentMillis - LifetimeMillis) / BucketMillis;
 	core::ScopedWriteLock scoped(_lock);
-	// even if this is timed out - if we only have one, keep it.
-	while (_pois.size() > 1) {
-		Poi& poi = _pois.front();
-		if (poi.time + seconds > currentMillis) {
-			break;
+	uint64_t second = _expireSecond;
+	if (second > lastSecond) {
+		return;
+	}
+	if (lastSecond - second >= (uint64_t)Buckets) {
+		// every bucket is visited once
+		second = lastSecond - Buckets + 1;
+	}
+	for (; second <= lastSecond; ++second) {
+		std::vector<uint32_t>& bucket = _buckets[second % Buckets];
+		// backwards - the removal swaps the last entry into the current slot
+		for (size_t i = bucket.size(); i-- > 0;) {
+			const uint32_t index = bucket[i];
+			// even if this is timed out - if we only have one, keep it. The newest POI
+			// is the last one that expires.
+			if (index == _newest) {
+				continue;
+			}
+			if (_pois[index].time + LifetimeMillis > currentMillis) {
+				// added within this second or in a later revolution of the buckets
+				continue;
+			}
+			remove(index);
 		}
-		_pois.pop_front();
 	}
+	// the last second might not be completely expired yet
+	_expireSecond = lastSecond;
 }
 
 void PoiProvider::add(const glm::vec3& pos, Type type) {
+	const uint64_t time = _timeProvider->tickMillis();
+	const uint64_t cell = cellKey(cellCoord(pos.x), cellCoord(pos.z));
 	core::ScopedWriteLock scoped(_lock);
-	_pois.emplace_back(Poi{pos, type, _timeProvider->tickMillis()});
+	uint32_t index;
+	if (_freePois.empty()) {
+		index = (uint32_t)_pois.size();
+		_pois.emplace_back();
+	} else {
+		index = _freePois.back();
+		_freePois.pop_back();
+	}
+	std::vector<uint32_t>& typeList = _types[(int)type];
+	std::vector<uint32_t>& cellList = _grids[(int)type][cell];
+	std::vector<uint32_t>& bucket = _buckets[(time / BucketMillis) % Buckets];
+	Poi& poi = _pois[index];
+	poi.pos = pos;
+	poi.type = type;
+	poi.time = time;
+	poi.cell = cell;
+	poi.allIndex = (uint32_t)_all.size();
+	poi.typeIndex = (uint32_t)typeList.size();
+	poi.cellIndex = (uint32_t)cellList.size();
+	poi.bucketIndex = (uint32_t)bucket.size();
+	_all.push_back(index);
+	typeList.push_back(index);
+	cellList.push_back(index);
+	bucket.push_back(index);
+	_newest = index;
 }
 
 size_t PoiProvider::count() const {
 	core::ScopedReadLock scoped(_lock);
-	return _pois.size();
+	return _all.size();
+}
+
+size_t PoiProvider::count(Type type) const {
+	core::ScopedReadLock scoped(_lock);
+	if (type == Type::NONE) {
+		return _all.size();
+	}
+	return _types[(int)type].size();
 }
 
 PoiResult PoiProvider::query(Type type) const {
-	static PoiResult empty{glm::zero<glm::vec3>(), false};
+	static const PoiResult empty{glm::zero<glm::vec3>(), false};
 	core::ScopedReadLock scoped(_lock);
-	if (_pois.empty()) {
+	const std::vector<uint32_t>& list = type == Type::NONE ? _all : _types[(int)type];
+	if (list.empty()) {
 		return empty;
 	}
-	if (type == Type::NONE) {
-		return PoiResult{_random.randomElement(_pois.begin(), _pois.end())->pos, true};
+	return PoiResult{_pois[*_random.randomElement(list.begin(), list.end())].pos, true};
+}
+
+template<class FUNC>
+void PoiProvider::visitCells(Type type, int minX, int minZ, int maxX, int maxZ, FUNC&& func) const {
+	const int firstType = type == Type::NONE ? 0 : (int)type;
+	const int lastType = type == Type::NONE ? Types - 1 : (int)type;
+	for (int t = firstType; t <= lastType; ++t) {
+		const Grid& grid = _grids[t];
+		if (grid.empty()) {
+			continue;
+		}
+		for (int x = minX; x <= maxX; ++x) {
+			for (int z = minZ; z <= maxZ; ++z) {
+				auto i = grid.find(cellKey(x, z));
+				if (i == grid.end()) {
+					continue;
+				}
+				for (uint32_t index : i->second) {
+					func(_pois[index]);
+				}
+			}
+		}
 	}
-	auto i = std::find_if(_pois.begin(), _pois.end(), [=] (const Poi& poi) {return poi.type == type;});
-	if (i != _pois.end()) {
-		return PoiResult{i->pos, true};
+}
+
+PoiResult PoiProvider::nearest(const glm::vec3& pos, Type type, float maxDistance) const {
+	core_trace_scoped(PoiProviderNearest);
+	const int cx = cellCoord(pos.x);
+	const int cz = cellCoord(pos.z);
+	const int maxRing = (int)std::ceil(maxDistance / (float)CellSize);
+	float bestDistance = maxDistance * maxDistance;
+	PoiResult result{glm::zero<glm::vec3>(), false};
+	auto check = [&] (const Poi& poi) {
+		const glm::vec3 delta = poi.pos - pos;
+		const float distance = glm::dot(delta, delta);
+		if (distance <= bestDistance) {
+			bestDistance = distance;
+			result.pos = poi.pos;
+			result.valid = true;
+		}
+	};
+	core::ScopedReadLock scoped(_lock);
+	for (int ring = 0; ring <= maxRing; ++ring) {
+		if (ring == 0) {
+			visitCells(type, cx, cz, cx, cz, check);
+		} else {
+			// the rows above and below and the columns in between
+			visitCells(type, cx - ring, cz - ring, cx + ring, cz - ring, check);
+			visitCells(type, cx - ring, cz + ring, cx + ring, cz + ring, check);
+			visitCells(type, cx - ring, cz - ring + 1, cx - ring, cz + ring - 1, check);
+			visitCells(type, cx + ring, cz - ring + 1, cx + ring, cz + ring - 1, check);
+		}
+		// all cells of the next ring are at least this far away
+		const float ringDistance = (float)(ring * CellSize);
+		if (result.valid && bestDistance <= ringDistance * ringDistance) {
+			break;
+		}
 	}
-	return empty;
+	return result;
+}
+
+size_t PoiProvider::inRadius(const glm::vec3& pos, float radius, std::vector<glm::vec3>& out, Type type) const {
+	core_trace_scoped(PoiProviderInRadius);
+	const float radiusSquare = radius * radius;
+	const size_t before = out.size();
+	core::ScopedReadLock scoped(_lock);
+	visitCells(type, cellCoord(pos.x - radius), cellCoord(pos.z - radius), cellCoord(pos.x + radius), cellCoord(pos.z + radius), [&] (const Poi& poi) {
+		const glm::vec3 delta = poi.pos - pos;
+		if (glm::dot(delta, delta) <= radiusSquare) {
+			out.push_back(poi.pos);
+		}
+	});
+	return out.size() - before;
 }
 
 }
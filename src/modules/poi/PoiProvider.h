@@ -10,8 +10,9 @@
 #include "Type.h"
 #include <glm/fwd.hpp>
 #include <glm/vec3.hpp>
-#include <stack>
+#include <unordered_map>
 #include <memory>
+#include <vector>
 
 namespace poi {
 
@@ -26,23 +27,64 @@ struct PoiResult {
 /**
  * @brief Maintains a list of points of interest that are only valid for a particular time.
  *
- * @note One can add new POIs by calling @c PoiProvider::addPointOfInterest() and get a random,
- * not yet expired POI by calling @c PoiProvider::getPointOfInterest().
+ * @note One can add new POIs by calling @c PoiProvider::add() and get a random, not yet
+ * expired POI by calling @c PoiProvider::query().
+ *
+ * The POIs are partitioned by type and put into a grid of cells on the x-z plane - @c nearest() and
+ * @c inRadius() only visit the cells around the given position. The expiry is bucketed by the second
+ * the POI was added in - @c update() only visits the buckets that expired since the last call.
  */
 class PoiProvider {
+public:
+	/**
+	 * @brief The time after which a POI expires
+	 */
+	static constexpr uint64_t LifetimeMillis = 60u * 1000u;
+	/**
+	 * @brief The size of the grid cells in world units
+	 */
+	static constexpr int CellSize = 32;
 private:
+	static constexpr int Types = (int)Type::MAX + 1;
+	static constexpr uint64_t BucketMillis = 1000u;
+	// must cover the lifetime - the buckets are reused for later seconds
+	static constexpr int Buckets = 64;
+	static constexpr uint32_t InvalidIndex = 0xFFFFFFFFu;
+
 	struct Poi {
 		glm::vec3 pos;
 		Type type;
 		uint64_t time;
+		uint64_t cell;
+		// the positions in the dense lists - to remove a POI with a swap
+		uint32_t allIndex;
+		uint32_t typeIndex;
+		uint32_t cellIndex;
+		uint32_t bucketIndex;
 	};
 
-	typedef std::deque<Poi> PoiQueue;
-	PoiQueue _pois;
+	std::vector<Poi> _pois;
+	std::vector<uint32_t> _freePois;
+	std::vector<uint32_t> _all;
+	std::vector<uint32_t> _types[Types];
+	typedef std::unordered_map<uint64_t, std::vector<uint32_t>> Grid;
+	Grid _grids[Types];
+	std::vector<uint32_t> _buckets[Buckets];
+	// the first second that was not completely expired yet
+	uint64_t _expireSecond = 0u;
+	uint32_t _newest = InvalidIndex;
 
 	core::TimeProviderPtr _timeProvider;
 	core::ReadWriteLock _lock;
 	math::Random _random;
+
+	static int cellCoord(float v);
+	static uint64_t cellKey(int x, int z);
+	static void swapRemove(std::vector<uint32_t>& list, uint32_t index, std::vector<Poi>& pois, uint32_t Poi::*member);
+
+	void remove(uint32_t index);
+	template<class FUNC>
+	void visitCells(Type type, int minX, int minZ, int maxX, int maxZ, FUNC&& func) const;
 public:
 	PoiProvider(const core::TimeProviderPtr& timeProvider);
 
@@ -59,11 +101,27 @@ public:
 	 * @brief The overall amount of POIs
 	 */
 	size_t count() const;
+	/**
+	 * @brief The amount of POIs of the given type - @c Type::NONE counts all POIs
+	 */
+	size_t count(Type type) const;
 	/**
 	 * @brief Get a POI either randomly or by specifying a type.
 	 * @param[in] type If @c Type::NONE is given here we are just looking for any type of POI
 	 */
 	PoiResult query(Type type = Type::NONE) const;
+	/**
+	 * @brief Get the POI that is closest to the given position
+	 * @param[in] type If @c Type::NONE is given here we are just looking for any type of POI
+	 * @param[in] maxDistance Only POIs within this distance are taken into account
+	 */
+	PoiResult nearest(const glm::vec3& pos, Type type = Type::NONE, float maxDistance = 256.0f) const;
+	/**
+	 * @brief Collects the positions of all POIs within the given radius
+	 * @param[in] type If @c Type::NONE is given here we are just looking for any type of POI
+	 * @return The amount of POIs that were added to @c out
+	 */
+	size_t inRadius(const glm::vec3& pos, float radius, std::vector<glm::vec3>& out, Type type = Type::NONE) const;
 };
 
 typedef std::shared_ptr<PoiProvider> PoiProviderPtr;
@@ -0,0 +1,131 @@
+/**
+ * @file
+ */
+
+#include "core/benchmark/AbstractBenchmark.h"
+#include "core/TimeProvider.h"
+#include "poi/PoiProvider.h"
+#include "math/Random.h"
+#include <glm/geometric.hpp>
+#include <vector>
+
+/**
+ * @brief 100k POIs of mixed types spread over a 4096x4096 map. The nearest POI of a type is looked up
+ * with the grid - and with a scan over all POIs for comparison.
+ */
+class PoiProviderBenchmark: public core::AbstractBenchmark {
+protected:
+	static constexpr int Pois = 100000;
+	static constexpr int Queries = 1000;
+	static constexpr float MapSize = 4096.0f;
+	static constexpr float MaxDistance = 256.0f;
+
+	struct Poi {
+		glm::vec3 pos;
+		poi::Type type;
+	};
+
+	core::TimeProviderPtr _timeProvider;
+	poi::PoiProviderPtr _poiProvider;
+	std::vector<Poi> _pois;
+	std::vector<glm::vec3> _queries;
+
+	static inline poi::Type type(int i) {
+		return (poi::Type)(1 + i % (int)poi::Type::MAX);
+	}
+
+	void SetUp(benchmark::State& st) override {
+		core::AbstractBenchmark::SetUp(st);
+		math::Random random(1);
+		_timeProvider = std::make_shared<core::TimeProvider>();
+		_poiProvider = std::make_shared<poi::PoiProvider>(_timeProvider);
+		_pois.clear();
+		_pois.reserve(Pois);
+		for (int i = 0; i < Pois; ++i) {
+			// spread the POIs over the lifetime of a POI
+			_timeProvider->update((uint64_t)i * poi::PoiProvider::LifetimeMillis / Pois);
+			const glm::vec3 pos(random.randomf(0.0f, MapSize), random.randomf(0.0f, 64.0f), random.randomf(0.0f, MapSize));
+			_pois.push_back(Poi{pos, type(i)});
+			_poiProvider->add(pos, type(i));
+		}
+		_queries.clear();
+		for (int i = 0; i < Queries; ++i) {
+			_queries.emplace_back(random.randomf(0.0f, MapSize), random.randomf(0.0f, 64.0f), random.randomf(0.0f, MapSize));
+		}
+	}
+
+	void TearDown(benchmark::State& st) override {
+		_poiProvider = poi::PoiProviderPtr();
+		core::AbstractBenchmark::TearDown(st);
+	}
+};
+
+BENCHMARK_DEFINE_F(PoiProviderBenchmark, NearestLinearScan) (benchmark::State& state) {
+	int found = 0;
+	for (auto _ : state) {
+		for (int i = 0; i < Queries; ++i) {
+			const glm::vec3& pos = _queries[i];
+			const poi::Type t = type(i);
+			float best = MaxDistance * MaxDistance;
+			bool valid = false;
+			for (const Poi& p : _pois) {
+				if (p.type != t) {
+					continue;
+				}
+				const glm::vec3 delta = p.pos - pos;
+				const float distance = glm::dot(delta, delta);
+				if (distance <= best) {
+					best = distance;
+					valid = true;
+				}
+			}
+			found += valid;
+		}
+	}
+	benchmark::DoNotOptimize(found);
+	state.SetItemsProcessed(state.iterations() * Queries);
+}
+
+BENCHMARK_DEFINE_F(PoiProviderBenchmark, NearestGrid) (benchmark::State& state) {
+	int found = 0;
+	for (auto _ : state) {
+		for (int i = 0; i < Queries; ++i) {
+			found += _poiProvider->nearest(_queries[i], type(i), MaxDistance).valid;
+		}
+	}
+	benchmark::DoNotOptimize(found);
+	state.SetItemsProcessed(state.iterations() * Queries);
+}
+
+BENCHMARK_DEFINE_F(PoiProviderBenchmark, InRadius) (benchmark::State& state) {
+	std::vector<glm::vec3> out;
+	for (auto _ : state) {
+		for (int i = 0; i < Queries; ++i) {
+			out.clear();
+			_poiProvider->inRadius(_queries[i], 64.0f, out);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * Queries);
+}
+
+BENCHMARK_DEFINE_F(PoiProviderBenchmark, AddAndExpire) (benchmark::State& state) {
+	math::Random random(2);
+	uint64_t time = poi::PoiProvider::LifetimeMillis;
+	for (auto _ : state) {
+		// one tick of 50ms with as many new POIs as expire in that time
+		time += 50u;
+		_timeProvider->update(time);
+		for (int i = 0; i < Pois * 50 / (int)poi::PoiProvider::LifetimeMillis; ++i) {
+			_poiProvider->add(glm::vec3(random.randomf(0.0f, MapSize), 0.0f, random.randomf(0.0f, MapSize)), type(i));
+		}
+		_poiProvider->update(50);
+	}
+	state.counters["pois"] = (double)_poiProvider->count();
+}
+
+BENCHMARK_REGISTER_F(PoiProviderBenchmark, NearestLinearScan)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(PoiProviderBenchmark, NearestGrid)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(PoiProviderBenchmark, InRadius)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(PoiProviderBenchmark, AddAndExpire)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -76,4 +76,95 @@ TEST_F(PoiProviderTest, testNoExpire) {
 	EXPECT_EQ(3u, _poiProvider->count()) << "We should still have all three left";
 }
 
+TEST_F(PoiProviderTest, testCountType) {
+	_poiProvider->add(glm::vec3(0.0), Type::GENERIC);
+	_poiProvider->add(glm::vec3(1.0), Type::QUEST);
+	_poiProvider->add(glm::vec3(2.0), Type::QUEST);
+	EXPECT_EQ(3u, _poiProvider->count(Type::NONE));
+	EXPECT_EQ(1u, _poiProvider->count(Type::GENERIC));
+	EXPECT_EQ(2u, _poiProvider->count(Type::QUEST));
+	EXPECT_EQ(0u, _poiProvider->count(Type::FIGHT));
+	EXPECT_FALSE(_poiProvider->query(Type::FIGHT).valid);
+}
+
+TEST_F(PoiProviderTest, testNearest) {
+	_poiProvider->add(glm::vec3(0.0f, 0.0f, 0.0f), Type::GENERIC);
+	_poiProvider->add(glm::vec3(100.0f, 0.0f, 0.0f), Type::FIGHT);
+	_poiProvider->add(glm::vec3(-40.0f, 0.0f, 10.0f), Type::FIGHT);
+	_poiProvider->add(glm::vec3(-500.0f, 0.0f, -500.0f), Type::QUEST);
+
+	PoiResult result = _poiProvider->nearest(glm::vec3(1.0f, 0.0f, 1.0f));
+	ASSERT_TRUE(result.valid);
+	EXPECT_EQ(glm::vec3(0.0f), result.pos);
+
+	result = _poiProvider->nearest(glm::vec3(1.0f, 0.0f, 1.0f), Type::FIGHT);
+	ASSERT_TRUE(result.valid);
+	EXPECT_EQ(glm::vec3(-40.0f, 0.0f, 10.0f), result.pos);
+
+	result = _poiProvider->nearest(glm::vec3(70.0f, 0.0f, 1.0f), Type::FIGHT);
+	ASSERT_TRUE(result.valid);
+	EXPECT_EQ(glm::vec3(100.0f, 0.0f, 0.0f), result.pos);
+
+	EXPECT_FALSE(_poiProvider->nearest(glm::vec3(0.0f), Type::QUEST).valid) << "The quest POI is out of the default range";
+	result = _poiProvider->nearest(glm::vec3(0.0f), Type::QUEST, 1000.0f);
+	ASSERT_TRUE(result.valid);
+	EXPECT_EQ(glm::vec3(-500.0f, 0.0f, -500.0f), result.pos);
+}
+
+TEST_F(PoiProviderTest, testNearestMatchesLinearScan) {
+	math::Random random(42);
+	std::vector<glm::vec3> positions;
+	for (int i = 0; i < 1000; ++i) {
+		const glm::vec3 pos(random.randomf(-512.0f, 512.0f), random.randomf(0.0f, 64.0f), random.randomf(-512.0f, 512.0f));
+		positions.push_back(pos);
+		_poiProvider->add(pos, Type::GENERIC);
+	}
+	for (int i = 0; i < 100; ++i) {
+		const glm::vec3 pos(random.randomf(-512.0f, 512.0f), random.randomf(0.0f, 64.0f), random.randomf(-512.0f, 512.0f));
+		float best = 100.0f * 100.0f;
+		for (const glm::vec3& p : positions) {
+			const glm::vec3 delta = p - pos;
+			best = glm::min(best, glm::dot(delta, delta));
+		}
+		const PoiResult& result = _poiProvider->nearest(pos, Type::GENERIC, 100.0f);
+		ASSERT_TRUE(result.valid);
+		const glm::vec3 delta = result.pos - pos;
+		EXPECT_FLOAT_EQ(best, glm::dot(delta, delta));
+	}
+}
+
+TEST_F(PoiProviderTest, testInRadius) {
+	_poiProvider->add(glm::vec3(0.0f, 0.0f, 0.0f), Type::GENERIC);
+	_poiProvider->add(glm::vec3(30.0f, 0.0f, 0.0f), Type::GENERIC);
+	_poiProvider->add(glm::vec3(0.0f, 0.0f, -50.0f), Type::FIGHT);
+	_poiProvider->add(glm::vec3(200.0f, 0.0f, 0.0f), Type::GENERIC);
+	std::vector<glm::vec3> out;
+	EXPECT_EQ(3u, _poiProvider->inRadius(glm::vec3(0.0f), 60.0f, out));
+	EXPECT_EQ(3u, out.size());
+	out.clear();
+	EXPECT_EQ(2u, _poiProvider->inRadius(glm::vec3(0.0f), 60.0f, out, Type::GENERIC));
+	out.clear();
+	EXPECT_EQ(0u, _poiProvider->inRadius(glm::vec3(100.0f, 0.0f, 100.0f), 20.0f, out));
+}
+
+TEST_F(PoiProviderTest, testExpireBuckets) {
+	// one POI per second for more than one revolution of the expiry buckets
+	for (uint64_t i = 0u; i < 200u; ++i) {
+		_timeProvider->update(i * 1000UL);
+		_poiProvider->add(glm::vec3((float)i), i % 2u ? Type::GENERIC : Type::FIGHT);
+		_poiProvider->update(0UL);
+		const uint64_t expected = i < 60u ? i + 1u : 60u;
+		ASSERT_EQ(expected, _poiProvider->count()) << "After " << i << " seconds";
+	}
+	EXPECT_EQ(30u, _poiProvider->count(Type::GENERIC));
+	EXPECT_EQ(30u, _poiProvider->count(Type::FIGHT));
+	std::vector<glm::vec3> out;
+	_poiProvider->inRadius(glm::vec3(0.0f), 200.0f, out);
+	EXPECT_TRUE(out.empty()) << "Expired POIs must be removed from the grid";
+	_timeProvider->update(1000000UL);
+	_poiProvider->update(0UL);
+	EXPECT_EQ(1u, _poiProvider->count());
+	EXPECT_EQ(glm::vec3(199.0f), _poiProvider->query().pos) << "The newest POI should be kept";
+}
+
 }
@@ -4,7 +4,6 @@
 
 #include "Container.h"
 #include "core/Log.h"
-#include "Item.h"
 #include <algorithm>
 
 namespace stock {
@@ -15,126 +14,167 @@ void Container::init(const ContainerShape& shape, uint32_t flags) {
 	_items.reserve(64);
 }
 
-bool Container::canAdd(const ItemPtr& item, uint8_t x, uint8_t y) const {
-	if (item == nullptr) {
-		return false;
-	}
+bool Container::checkFlags(const ItemData& item) const {
 	if ((_flags & Single) != 0 && !items().empty()) {
 		Log::debug("Can't add item. Container can only hold a single item - but it is not empty.");
 		return false;
 	}
-	if ((_flags & Unique) != 0 && hasItemOfType(item->type())) {
+	if ((_flags & Unique) != 0 && hasItemOfType(item.type())) {
 		Log::debug("Can't add item. There is already an item with the same type.");
 		return false;
 	}
+	return true;
+}
+
+bool Container::canAdd(const ItemData& item, uint8_t x, uint8_t y) const {
+	if (!checkFlags(item)) {
+		return false;
+	}
 	if ((_flags & Scrollable) != 0) {
 		return true;
 	}
-	if (!_shape.isFree(item->shape(), x, y)) {
+	if (!_shape.isFree(item.shape(), x, y)) {
 		Log::debug("Can't add item. It doesn't fit into the container shape.");
 		return false;
 	}
 	return true;
 }
 
-bool Container::add(const ItemPtr& item) {
+bool Container::add(ItemHandle handle, const ItemData& item) {
 	uint8_t x;
 	uint8_t y;
 	if (!findSpace(item, x, y)) {
 		return false;
 	}
-	if (!canAdd(item, x, y)) {
-		return false;
+	return add(handle, item, x, y);
+}
+
+size_t Container::add(const ContainerItem* items, size_t amount) {
+	std::vector<const ContainerItem*> sorted;
+	sorted.reserve(amount);
+	for (size_t i = 0; i < amount; ++i) {
+		sorted.push_back(&items[i]);
+	}
+	std::stable_sort(sorted.begin(), sorted.end(), [] (const ContainerItem* a, const ContainerItem* b) {
+		return a->data->shape().size() > b->data->shape().size();
+	});
+	_items.reserve(_items.size() + amount);
+	size_t added = 0u;
+	for (const ContainerItem* ci : sorted) {
+		if (add(ci->handle, *ci->data)) {
+			++added;
+		}
 	}
-	return add(item, x, y);
+	return added;
 }
 
-auto Container::findById(ItemId id) const {
-	return std::find_if(_items.begin(), _items.end(), [id] (const ContainerItem& item) { return item.item->id() == id; });
+auto Container::findByHandle(ItemHandle handle) const {
+	return std::find_if(_items.begin(), _items.end(), [handle] (const ContainerItem& item) { return item.handle == handle; });
 }
 
 auto Container::findByType(const ItemType& type) const {
-	return std::find_if(_items.begin(), _items.end(), [type] (const ContainerItem& item) { return item.item->type() == type; });
+	return std::find_if(_items.begin(), _items.end(), [type] (const ContainerItem& item) { return item.data->type() == type; });
 }
 
 bool Container::hasItemOfType(const ItemType& itemType) const {
 	return findByType(itemType) != _items.end();
 }
 
-bool Container::add(const ItemPtr& item, uint8_t x, uint8_t y) {
+bool Container::hasItem(ItemHandle handle) const {
+	return findByHandle(handle) != _items.end();
+}
+
+bool Container::add(ItemHandle handle, const ItemData& item, uint8_t x, uint8_t y) {
 	if (!canAdd(item, x, y)) {
 		return false;
 	}
-	const ContainerItem ci = {item, x, y};
+	const ContainerItem ci = {&item, handle, x, y};
 	_items.push_back(ci);
-	_shape.addShape(static_cast<ItemShapeType>(item->shape()), x, y);
+	if ((_flags & Scrollable) == 0) {
+		_shape.addShape(static_cast<ItemShapeType>(item.shape()), x, y);
+	}
 	return true;
 }
 
-bool Container::notifyRemove(const ItemPtr& item) {
-	const ItemId id = item->id();
-	auto i = findById(id);
+bool Container::notifyRemove(ItemHandle handle) {
+	auto i = findByHandle(handle);
 	if (i == _items.end()) {
 		return false;
 	}
-	_shape.removeShape(static_cast<ItemShapeType>(item->shape()), i->x, i->y);
+	if ((_flags & Scrollable) == 0) {
+		_shape.removeShape(static_cast<ItemShapeType>(i->data->shape()), i->x, i->y);
+	}
 	_items.erase(i);
 	return true;
 }
 
-ItemPtr Container::remove(uint8_t x, uint8_t y) {
-	const ItemPtr& item = get(x, y);
+ItemHandle Container::remove(uint8_t x, uint8_t y) {
+	const ContainerItem* item = get(x, y);
 	if (item == nullptr) {
-		return nullptr;
+		return ItemHandle();
 	}
-	if (!notifyRemove(item)) {
-		return nullptr;
+	const ItemHandle handle = item->handle;
+	if (!notifyRemove(handle)) {
+		return ItemHandle();
 	}
-	return item;
+	return handle;
 }
 
-ItemPtr Container::get(uint8_t x, uint8_t y) const {
+const Container::ContainerItem* Container::get(uint8_t x, uint8_t y) const {
 	if (!_shape.isInShape(x, y)) {
-		return ItemPtr();
+		return nullptr;
 	}
 	if ((_flags & Single) != 0) {
 		if (_items.empty()) {
-			return ItemPtr();
+			return nullptr;
 		}
-		return _items.front().item;
+		return &_items.front();
 	}
 	for (const ContainerItem& item : _items) {
-		const ItemShape& shape = item.item->shape();
-		if (shape.isInShape(x - item.x, y - y)) {
-			return item.item;
+		if (x < item.x || y < item.y) {
+			continue;
+		}
+		const int itemX = x - item.x;
+		const int itemY = y - item.y;
+		if (itemX >= ItemMaxWidth || itemY >= ItemMaxHeight) {
+			continue;
 		}
+		if (item.data->shape().isInShape(itemX, itemY)) {
+			return &item;
+		}
+	}
+	return nullptr;
+}
+
+bool Container::defragment() {
+	if ((_flags & (Scrollable | Single)) != 0) {
+		return true;
+	}
+	ContainerItems old;
+	old.swap(_items);
+	_shape.clearItems();
+	if (add(old.data(), old.size()) == old.size()) {
+		return true;
+	}
+	Log::debug("Could not defragment the container - restore the old placement");
+	_items.swap(old);
+	_shape.clearItems();
+	for (const ContainerItem& item : _items) {
+		_shape.addShape(static_cast<ItemShapeType>(item.data->shape()), item.x, item.y);
 	}
-	return ItemPtr();
+	return false;
 }
 
-bool Container::findSpace(const ItemPtr& item, uint8_t& targetX, uint8_t& targetY) const {
+bool Container::findSpace(const ItemData& item, uint8_t& targetX, uint8_t& targetY) const {
 	// always fits into scrollable container
 	if ((_flags & Scrollable) != 0) {
 		targetX = targetY = 0u;
 		return true;
 	}
-
-	// there is already an item.
-	if ((_flags & Single) != 0 && !_items.empty()) {
+	if (!checkFlags(item)) {
 		return false;
 	}
-	for (uint8_t y = 0; y < ContainerMaxHeight; ++y) {
-		for (uint8_t x = 0; x < ContainerMaxWidth; ++x) {
-			if (!canAdd(item, x, y)) {
-				continue;
-			}
-			targetX = x;
-			targetY = y;
-			return true;
-		}
-	}
-
-	return false;
+	return _shape.findFree(item.shape(), targetX, targetY);
 }
 
 }
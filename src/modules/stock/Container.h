@@ -5,23 +5,25 @@
 #pragma once
 
 #include "Shape.h"
-#include "ItemData.h"
+#include "Item.h"
+#include <vector>
 
 namespace stock {
 
-class Item;
-typedef std::shared_ptr<Item> ItemPtr;
-
 /**
  * @brief A container is a collection of items. They are packed into a @c ContainerItem.
  * Each Container instance has a @c ContainerShape assigned which defines the valid area to place
  * items at.
+ *
+ * The items themselves are owned by the @c Stock - the container only stores the @c ItemHandle
+ * and the static @c ItemData that is needed for the placement.
  * @ingroup Stock
  */
 class Container {
 public:
 	struct ContainerItem {
-		ItemPtr item;
+		const ItemData* data;
+		ItemHandle handle;
 		uint8_t x;
 		uint8_t y;
 	};
@@ -45,6 +47,11 @@ public:
 
 	bool hasItemOfType(const ItemType& itemType) const;
 
+	/**
+	 * @return @c true if the item with the given handle is placed in this container
+	 */
+	bool hasItem(ItemHandle handle) const;
+
 	/**
 	 * @brief Compute the overall item count
 	 */
@@ -56,32 +63,56 @@ public:
 	 * @param[out] y The y location to place the item
 	 * @return @c true if a free location was found, @c false otherwise
 	 */
-	bool findSpace(const ItemPtr& item, uint8_t& x, uint8_t& y) const;
+	bool findSpace(const ItemData& item, uint8_t& x, uint8_t& y) const;
 
 	/**
 	 * @brief Check whether the given item can be added to the specified location in the container
 	 * @return @c true if the placement would work, @c false if not
 	 */
-	bool canAdd(const ItemPtr& item, uint8_t x, uint8_t y) const;
+	bool canAdd(const ItemData& item, uint8_t x, uint8_t y) const;
 
-	bool add(const ItemPtr& item, uint8_t x, uint8_t y);
+	bool add(ItemHandle handle, const ItemData& item, uint8_t x, uint8_t y);
 
-	bool add(const ItemPtr& item);
+	/**
+	 * @brief Adds the item at the first free location
+	 */
+	bool add(ItemHandle handle, const ItemData& item);
 
-	bool notifyRemove(const ItemPtr& item);
+	/**
+	 * @brief Adds all the given items at the first free locations - the locations of the given entries are ignored.
+	 * The biggest items are placed first to keep the container less fragmented.
+	 * @return The amount of items that were added
+	 */
+	size_t add(const ContainerItem* items, size_t amount);
 
-	ItemPtr remove(uint8_t x, uint8_t y);
+	bool notifyRemove(ItemHandle handle);
 
-	ItemPtr get(uint8_t x, uint8_t y) const;
+	/**
+	 * @return The handle of the removed item - or an invalid handle if there is no item at the given location
+	 */
+	ItemHandle remove(uint8_t x, uint8_t y);
+
+	/**
+	 * @return @c nullptr if there is no item at the given location
+	 */
+	const ContainerItem* get(uint8_t x, uint8_t y) const;
+
+	/**
+	 * @brief Places all items again - biggest items first - to get rid of the holes between them
+	 * @return @c false if the items don't fit into the container in the new order - the old placement is kept in this case
+	 */
+	bool defragment();
 
 	int size() const;
 
 	int free() const;
 private:
-	auto findById(ItemId id) const;
+	auto findByHandle(ItemHandle handle) const;
 
 	auto findByType(const ItemType& type) const;
 
+	bool checkFlags(const ItemData& item) const;
+
 	ContainerShape _shape;
 	uint32_t _flags = 0u;
 	ContainerItems _items;
@@ -97,6 +128,7 @@ inline int Container::free() const {
 
 inline void Container::clear() {
 	_items.clear();
+	_shape.clearItems();
 }
 
 inline size_t Container::itemCount() const {
@@ -27,36 +27,102 @@ void Inventory::clear() {
 	}
 }
 
-bool Inventory::notifyRemove(const ItemPtr& item) {
-	if (item == nullptr) {
+bool Inventory::notifyRemove(ItemHandle handle) {
+	if (!handle.isValid()) {
 		return false;
 	}
+	bool removed = false;
 	for (int i = 0; i < maxContainers(); ++i) {
 		Container& c = _containers[i];
-		if (c.notifyRemove(item)) {
-			return true;
+		while (c.notifyRemove(handle)) {
+			removed = true;
 		}
 	}
-	return false;
+	return removed;
 }
 
-bool Inventory::add(uint8_t containerId, const ItemPtr& item, uint8_t x, uint8_t y) {
-	if (!item) {
+bool Inventory::add(uint8_t containerId, ItemHandle handle, const ItemData& item, uint8_t x, uint8_t y) {
+	if (!handle.isValid()) {
 		return false;
 	}
 	if (containerId >= maxContainers()) {
 		return false;
 	}
 	Container& c = _containers[containerId];
-	return c.add(item, x, y);
+	return c.add(handle, item, x, y);
+}
+
+bool Inventory::isPlaced(ItemHandle handle) const {
+	for (int i = 0; i < maxContainers(); ++i) {
+		if (_containers[i].hasItem(handle)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+size_t Inventory::add(uint8_t containerId, const Container::ContainerItem* items, size_t amount) {
+	if (containerId >= maxContainers()) {
+		return 0u;
+	}
+	Container& c = _containers[containerId];
+	return c.add(items, amount);
 }
 
-ItemPtr Inventory::remove(uint8_t containerId, uint8_t x, uint8_t y) {
+ItemHandle Inventory::remove(uint8_t containerId, uint8_t x, uint8_t y) {
 	if (containerId >= maxContainers()) {
-		return ItemPtr();
+		return ItemHandle();
 	}
 	Container& c = _containers[containerId];
 	return c.remove(x, y);
 }
 
+bool Inventory::move(uint8_t containerId, uint8_t x, uint8_t y, uint8_t targetContainerId, uint8_t targetX, uint8_t targetY) {
+	if (containerId >= maxContainers() || targetContainerId >= maxContainers()) {
+		return false;
+	}
+	Container& source = _containers[containerId];
+	const Container::ContainerItem* item = source.get(x, y);
+	if (item == nullptr) {
+		return false;
+	}
+	const Container::ContainerItem ci = *item;
+	source.notifyRemove(ci.handle);
+	Container& target = _containers[targetContainerId];
+	if (target.add(ci.handle, *ci.data, targetX, targetY)) {
+		return true;
+	}
+	const bool restored = source.add(ci.handle, *ci.data, ci.x, ci.y);
+	core_assert_always(restored);
+	return false;
+}
+
+bool Inventory::move(uint8_t containerId, uint8_t x, uint8_t y, uint8_t targetContainerId) {
+	if (containerId >= maxContainers() || targetContainerId >= maxContainers()) {
+		return false;
+	}
+	Container& source = _containers[containerId];
+	const Container::ContainerItem* item = source.get(x, y);
+	if (item == nullptr) {
+		return false;
+	}
+	const Container::ContainerItem ci = *item;
+	source.notifyRemove(ci.handle);
+	Container& target = _containers[targetContainerId];
+	if (target.add(ci.handle, *ci.data)) {
+		return true;
+	}
+	const bool restored = source.add(ci.handle, *ci.data, ci.x, ci.y);
+	core_assert_always(restored);
+	return false;
+}
+
+bool Inventory::defragment(uint8_t containerId) {
+	if (containerId >= maxContainers()) {
+		return false;
+	}
+	Container& c = _containers[containerId];
+	return c.defragment();
+}
+
 }
@@ -30,11 +30,39 @@ public:
 	 * @brief Remove the item from the highest order Container instances
 	 * until all of the linked items are removed.
 	 */
-	bool notifyRemove(const ItemPtr& item);
+	bool notifyRemove(ItemHandle handle);
 
-	bool add(uint8_t containerId, const ItemPtr& item, uint8_t x, uint8_t y);
+	bool add(uint8_t containerId, ItemHandle handle, const ItemData& item, uint8_t x, uint8_t y);
 
-	ItemPtr remove(uint8_t containerId, uint8_t x, uint8_t y);
+	/**
+	 * @return @c true if the item with the given handle is placed in any of the containers
+	 */
+	bool isPlaced(ItemHandle handle) const;
+
+	/**
+	 * @sa Container::add()
+	 * @return The amount of items that were added
+	 */
+	size_t add(uint8_t containerId, const Container::ContainerItem* items, size_t amount);
+
+	ItemHandle remove(uint8_t containerId, uint8_t x, uint8_t y);
+
+	/**
+	 * @brief Moves the item at the given location to the target location of the target container. The target
+	 * container may be the same container - the item doesn't block itself.
+	 * @return @c false if the item can't be placed at the target location - it stays where it is in this case
+	 */
+	bool move(uint8_t containerId, uint8_t x, uint8_t y, uint8_t targetContainerId, uint8_t targetX, uint8_t targetY);
+
+	/**
+	 * @brief Moves the item at the given location to the first free location of the target container
+	 */
+	bool move(uint8_t containerId, uint8_t x, uint8_t y, uint8_t targetContainerId);
+
+	/**
+	 * @sa Container::defragment()
+	 */
+	bool defragment(uint8_t containerId);
 
 	const Container* container(uint8_t containerId) const;
 
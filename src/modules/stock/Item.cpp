@@ -2,8 +2,8 @@
 
 namespace stock {
 
-Item::Item(const ItemData& data) :
-		_data(data) {
+Item::Item(const ItemData& data, ItemAmount amount) :
+		_data(&data), _amount(amount) {
 }
 
 }
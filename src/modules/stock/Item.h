@@ -5,22 +5,54 @@
 #pragma once
 
 #include "ItemData.h"
-#include "Container.h"
-#include <memory>
+#include <stdint.h>
 
 namespace stock {
 
 using ItemAmount = int64_t;
 
 /**
+ * @brief Stable reference to an @c Item that is owned by a @c Stock. Removed items give their slot
+ * back to the stock - the generation makes sure that old handles don't resolve to the item that
+ * reuses the slot.
+ * @ingroup Stock
+ */
+struct ItemHandle {
+	static constexpr uint32_t InvalidIndex = 0xFFFFFFFFu;
+	uint32_t index = InvalidIndex;
+	uint32_t generation = 0u;
+
+	inline bool isValid() const {
+		return index != InvalidIndex;
+	}
+
+	inline bool operator==(const ItemHandle& other) const {
+		return index == other.index && generation == other.generation;
+	}
+
+	inline bool operator!=(const ItemHandle& other) const {
+		return !(*this == other);
+	}
+};
+
+/**
+ * @brief An amount of things of the same @c ItemData. Items are plain values that are owned by
+ * the @c Stock - the containers only reference them by @c ItemHandle.
  * @ingroup Stock
  */
 class Item {
 protected:
-	const ItemData& _data;
+	const ItemData* _data = nullptr;
 	ItemAmount _amount = 0;
 public:
-	Item(const ItemData& data);
+	/**
+	 * @brief Creates an invalid item
+	 */
+	Item() {
+	}
+	Item(const ItemData& data, ItemAmount amount = 0);
+
+	bool isValid() const;
 
 	ItemId id() const;
 
@@ -43,12 +75,16 @@ public:
 	bool operator==(ItemId id) const;
 };
 
+inline bool Item::isValid() const {
+	return _data != nullptr;
+}
+
 inline ItemAmount Item::amount() const {
 	return _amount;
 }
 
 inline const char *Item::label(const char *key) const {
-	return _data.label(key);
+	return _data->label(key);
 }
 
 inline ItemAmount Item::changeAmount(ItemAmount delta) {
@@ -81,13 +117,11 @@ inline const char* Item::name() const {
 }
 
 inline const ItemData& Item::data() const {
-	return _data;
+	return *_data;
 }
 
 inline bool operator==(const Item* item, ItemType type) {
 	return item->type() == type;
 }
 
-typedef std::shared_ptr<Item> ItemPtr;
-
 }
@@ -4,6 +4,7 @@
 
 #include "Shape.h"
 #include "core/Assert.h"
+#include "core/Bits.h"
 
 namespace stock {
 
@@ -78,13 +79,7 @@ bool ContainerShape::isFree(const ItemShape& itemShape, uint8_t x, uint8_t y) co
 int ContainerShape::free() const {
 	int bitCounter = 0;
 	for (int row = 0; row < ContainerMaxHeight; ++row) {
-		for (uint8_t i = 0; i < ContainerBitsPerRow; ++i) {
-			if ((_containerShape[row] & ((ItemShapeType)1 << i)) != 0) {
-				if ((_itemShape[row] & ((ItemShapeType)1 << i)) == 0) {
-					++bitCounter;
-				}
-			}
-		}
+		bitCounter += core::bitCount(freeRow(row));
 	}
 	return bitCounter;
 }
@@ -92,13 +87,43 @@ int ContainerShape::free() const {
 int ContainerShape::size() const {
 	int bitCounter = 0;
 	for (int row = 0; row < ContainerMaxHeight; ++row) {
-		for (uint8_t i = 0; i < ContainerBitsPerRow; ++i) {
-			if ((_containerShape[row] & ((ItemShapeType)1 << i)) != 0) {
-				++bitCounter;
+		bitCounter += core::bitCount(_containerShape[row]);
+	}
+	return bitCounter;
+}
+
+bool ContainerShape::findFree(const ItemShape& itemShape, uint8_t& targetX, uint8_t& targetY) const {
+	const ItemShapeType shape = static_cast<ItemShapeType>(itemShape);
+	const int height = itemShape.height();
+	ContainerShapeType itemRows[ItemMaxHeight];
+	for (int row = 0; row < height; ++row) {
+		itemRows[row] = (shape >> (row * ItemMaxWidth)) & ItemRowLength;
+	}
+	for (int y = 0; y < ContainerMaxHeight && y + height <= ContainerMaxHeight; ++y) {
+		/* Bit x of the candidates is set if the item can be placed at column x. Like in isFree()
+		 * the anchor has to be part of the container shape. */
+		ContainerShapeType candidates = _containerShape[y];
+		for (int row = 0; row < height && candidates != (ContainerShapeType)0; ++row) {
+			const ContainerShapeType free = freeRow(y + row);
+			/* Every set bit b of the item row needs the field x + b to be free - the bits that are
+			 * shifted out on the right are the locations where the item would exceed the row. */
+			for (ContainerShapeType bits = itemRows[row]; bits != (ContainerShapeType)0; bits &= bits - 1) {
+				candidates &= free >> core::lowestBit(bits);
 			}
 		}
+		if (candidates != (ContainerShapeType)0) {
+			targetX = (uint8_t)core::lowestBit(candidates);
+			targetY = (uint8_t)y;
+			return true;
+		}
+	}
+	return false;
+}
+
+void ContainerShape::clearItems() {
+	for (int row = 0; row < ContainerMaxHeight; ++row) {
+		_itemShape[row] = (ContainerShapeType)0;
 	}
-	return bitCounter;
 }
 
 void ContainerShape::addShape(ItemShapeType shape, uint8_t x, uint8_t y) {
@@ -113,7 +138,7 @@ void ContainerShape::removeShape(ItemShapeType shape, uint8_t x, uint8_t y) {
 	core_assert(isInShape(x, y));
 	core_assert_always(y < ContainerMaxHeight && y < ContainerMaxWidth);
 	for (uint8_t row = 0; row < ItemMaxHeight && y + row < ContainerMaxHeight; ++row) {
-		_itemShape[y + row] &= ~((shape >> row * ItemMaxWidth) & ItemRowLength) << x;
+		_itemShape[y + row] &= ~(((shape >> row * ItemMaxWidth) & ItemRowLength) << x);
 	}
 }
 
@@ -131,37 +156,31 @@ ItemShapeType ItemShape::set(uint8_t x, uint8_t y) {
 }
 
 int ItemShape::size() const {
-	int bitCounter = 0;
-	for (uint8_t i = 0; i < ItemBits; ++i) {
-		if ((_shape & ((ItemShapeType)1 << i)) != 0) {
-			++bitCounter;
-		}
-	}
-	return bitCounter;
-}
-
-static inline constexpr uint64_t calcItemShapeHeightMask() {
-	ItemShapeType heightMask = 0;
-	for (int i = 0; i < ItemMaxWidth; ++i) {
-		heightMask |= (ItemShapeType)1 << (i * CHAR_BIT);
-	}
-	return heightMask;
+	return core::bitCount(_shape);
 }
 
 int ItemShape::height() const {
 	int i;
-	for (i = ItemMaxWidth - 1; i >= 0; --i) {
-		if (_shape & (calcItemShapeHeightMask() << i)) {
+	for (i = ItemMaxHeight - 1; i >= 0; --i) {
+		if (_shape & (ItemRowLength << (i * ItemMaxWidth))) {
 			break;
 		}
 	}
 	return i + 1;
 }
 
+static inline constexpr uint64_t calcItemShapeColumnMask() {
+	ItemShapeType columnMask = 0;
+	for (int i = 0; i < ItemMaxHeight; ++i) {
+		columnMask |= (ItemShapeType)1 << (i * ItemMaxWidth);
+	}
+	return columnMask;
+}
+
 int ItemShape::width() const {
 	int i;
-	for (i = ItemMaxHeight - 1; i >= 0; --i) {
-		if (_shape & (ItemRowLength << (i * ItemMaxWidth))) {
+	for (i = ItemMaxWidth - 1; i >= 0; --i) {
+		if (_shape & (calcItemShapeColumnMask() << i)) {
 			break;
 		}
 	}
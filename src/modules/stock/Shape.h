@@ -103,6 +103,26 @@ public:
 
 	bool isFree(uint8_t x, uint8_t y) const;
 
+	/**
+	 * @brief Finds the first location (row by row, column by column) where the given item shape fits in
+	 *
+	 * The candidate columns of a row are not tested one by one - the free bits of the rows that are covered
+	 * by the item are shifted by each set bit of the item row and combined, so all columns of a row are checked
+	 * with a few word operations.
+	 * @return @c true if a location was found, @c false otherwise
+	 */
+	bool findFree(const ItemShape& shape, uint8_t& x, uint8_t& y) const;
+
+	/**
+	 * @brief Bitmask of the fields in the given row that are part of the shape and not occupied by an item
+	 */
+	ContainerShapeType freeRow(uint8_t y) const;
+
+	/**
+	 * @brief Removes all item shapes - the container shape itself is kept
+	 */
+	void clearItems();
+
 	int free() const;
 
 	int size() const;
@@ -113,4 +133,8 @@ inline bool ContainerShape::isInShape(uint8_t x, uint8_t y) const {
 	return (_containerShape[y] & ((ContainerShapeType)1 << x)) != 0;
 }
 
+inline ContainerShapeType ContainerShape::freeRow(uint8_t y) const {
+	return _containerShape[y] & ~_itemShape[y];
+}
+
 }
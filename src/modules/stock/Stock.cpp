@@ -28,7 +28,9 @@ bool Stock::init() {
 
 void Stock::shutdown() {
 	_inventory.clear();
-	_items.clear();
+	_slots.clear();
+	_freeSlots.clear();
+	_slotIndices.clear();
 }
 
 int Stock::containerId(const std::string& name) const {
@@ -40,53 +42,103 @@ int Stock::containerId(const std::string& name) const {
 	return data->id;
 }
 
-ItemPtr Stock::add(const ItemPtr& item) {
-	Log::debug("Add item %s", item->data().name());
-	if (item->amount() == 0) {
+const Item* Stock::item(ItemHandle handle) const {
+	if (handle.index >= _slots.size()) {
+		return nullptr;
+	}
+	const Slot& slot = _slots[handle.index];
+	if (slot.generation != handle.generation || !slot.item.isValid()) {
+		return nullptr;
+	}
+	return &slot.item;
+}
+
+Item* Stock::get(ItemHandle handle) {
+	return const_cast<Item*>(item(handle));
+}
+
+ItemHandle Stock::add(const Item& item) {
+	Log::debug("Add item %s", item.data().name());
+	if (item.amount() == 0) {
 		Log::debug("Given amount was 0 - ignore item add");
-		return ItemPtr();
+		return ItemHandle();
+	}
+	auto i = _slotIndices.find(item.id());
+	if (i != _slotIndices.end()) {
+		_slots[i->second].item.changeAmount(item.amount());
+		return handle(i->second);
+	}
+	uint32_t index;
+	if (_freeSlots.empty()) {
+		index = (uint32_t)_slots.size();
+		_slots.emplace_back();
+	} else {
+		index = _freeSlots.back();
+		_freeSlots.pop_back();
 	}
-	auto i = find(item->id());
-	if (i == _items.end()) {
-		_items.insert(std::make_pair(item->id(), item));
-		return item;
+	_slots[index].item = item;
+	_slotIndices.insert(std::make_pair(item.id(), index));
+	return handle(index);
+}
+
+ItemHandle Stock::add(const Item& item, uint8_t containerId, uint8_t x, uint8_t y) {
+	auto i = _slotIndices.find(item.id());
+	if (i != _slotIndices.end() && _inventory.isPlaced(handle(i->second))) {
+		// the item is already placed - the amount is added to the existing placement
+		return add(item);
+	}
+	const ItemHandle h = add(item);
+	if (!h.isValid()) {
+		return h;
+	}
+	if (!_inventory.add(containerId, h, item.data(), x, y)) {
+		remove(h, item.amount());
+		return ItemHandle();
+	}
+	return h;
+}
+
+void Stock::add(const Item* items, size_t amount, ItemHandle* handles) {
+	_slots.reserve(_slots.size() + amount);
+	_slotIndices.reserve(_slotIndices.size() + amount);
+	for (size_t i = 0; i < amount; ++i) {
+		handles[i] = add(items[i]);
 	}
-	ItemPtr alreadyExisting = i->second;
-	alreadyExisting->changeAmount(item->amount());
-	return alreadyExisting;
 }
 
-int Stock::remove(const ItemPtr& item) {
-	auto i = find(item->id());
-	if (i == _items.end()) {
+ItemAmount Stock::remove(ItemHandle handle, ItemAmount amount) {
+	Item* i = get(handle);
+	if (i == nullptr) {
 		return 0;
 	}
-	const ItemAmount amount = i->second->changeAmount(-item->amount());
-	if (amount <= 0) {
-		_items.erase(i);
-		_inventory.notifyRemove(item);
+	const ItemAmount remaining = i->changeAmount(-amount);
+	if (remaining <= 0) {
+		_slotIndices.erase(i->id());
+		*i = Item();
+		++_slots[handle.index].generation;
+		_freeSlots.push_back(handle.index);
+		_inventory.notifyRemove(handle);
 		return 0;
 	}
-	return amount;
+	return remaining;
 }
 
 int Stock::count(const ItemType& itemType) const {
 	int n = 0;
-	for (const auto& entry : _items) {
-		const ItemPtr& i = entry.second;
-		if (i->type() == itemType) {
-			n += i->amount();
+	for (const Slot& slot : _slots) {
+		if (slot.item.isValid() && slot.item.type() == itemType) {
+			n += slot.item.amount();
 		}
 	}
 	return n;
 }
 
 int Stock::count(ItemId itemId) const {
-	auto i = find(itemId);
-	if (i == _items.end()) {
+	auto i = _slotIndices.find(itemId);
+	if (i == _slotIndices.end()) {
 		return 0;
 	}
-	return i->second->amount();
+	return _slots[i->second].item.amount();
 }
 
 }
@@ -25,23 +25,33 @@ typedef std::shared_ptr<StockDataProvider> StockDataProviderPtr;
  * @brief The Stock class manages Items. All the items that someone owns are stored in this class.
  *
  * The stock handler is taking responsibility for putting the items into it's Inventory. The Inventory itself
- * only has access to pointers over all of the items.
+ * only has handles to the items.
+ *
+ * The items are stored by value in slots - an @c ItemHandle stays valid until the item is removed. Items
+ * with the same @c ItemId are merged into one item.
  */
 class Stock : public core::IComponent {
 private:
-	/** All the items this instance can deal with */
-	std::unordered_map<ItemId, ItemPtr> _items;
-	/** The inventory has pointers to all the items distributed over all the Container instances in the Inventory. */
+	struct Slot {
+		Item item;
+		uint32_t generation = 0u;
+	};
+	/** All the items this instance can deal with - unused slots have an invalid item */
+	std::vector<Slot> _slots;
+	std::vector<uint32_t> _freeSlots;
+	std::unordered_map<ItemId, uint32_t> _slotIndices;
+	/** The inventory has handles to all the items distributed over all the Container instances in the Inventory. */
 	Inventory _inventory;
 	StockDataProviderPtr _stockDataProvider;
 
-	inline auto find(const ItemId& itemId) const {
-		return _items.find(itemId);
+	inline ItemHandle handle(uint32_t index) const {
+		ItemHandle h;
+		h.index = index;
+		h.generation = _slots[index].generation;
+		return h;
 	}
 
-	inline auto find(const ItemId& itemId) {
-		return _items.find(itemId);
-	}
+	Item* get(ItemHandle handle);
 public:
 	Stock(const StockDataProviderPtr& stockDataProvider);
 
@@ -54,16 +64,38 @@ public:
 	int containerId(const std::string& name) const;
 
 	/**
-	 * @brief Adds a new item to the stock
+	 * @brief Adds a new item to the stock - or increases the amount of the item with the same id
 	 * @param[in] item The @c Item to add.
+	 * @return The handle of the stock item - invalid if the given amount was @c 0
+	 */
+	ItemHandle add(const Item& item);
+
+	/**
+	 * @brief Adds the item to the stock and places it in the given container
+	 * @note If an item with the same id is already placed, only the amount is increased - the item
+	 * keeps its existing placement.
+	 * @return The handle of the stock item - invalid if the item could not be placed. The amount
+	 * is not added to the stock in that case.
 	 */
-	ItemPtr add(const ItemPtr& item);
+	ItemHandle add(const Item& item, uint8_t containerId, uint8_t x, uint8_t y);
 
 	/**
-	 * @brief Removes a particular amount of items
+	 * @brief Adds all the given items to the stock
+	 * @param[out] handles The handles for the given items - must have room for @c amount entries
+	 */
+	void add(const Item* items, size_t amount, ItemHandle* handles);
+
+	/**
+	 * @brief Removes a particular amount of the item. If nothing is left, the item is also removed
+	 * from the inventory and the handle gets invalid.
 	 * @return The remaining amount
 	 */
-	int remove(const ItemPtr& item);
+	ItemAmount remove(ItemHandle handle, ItemAmount amount);
+
+	/**
+	 * @return @c nullptr if the handle is no longer valid
+	 */
+	const Item* item(ItemHandle handle) const;
 
 	/**
 	 * @brief Count how many items of the given @c ItemType are in the @c Stock
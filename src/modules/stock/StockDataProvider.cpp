@@ -89,18 +89,18 @@ bool StockDataProvider::init(const std::string& luaScript) {
 	return true;
 }
 
-ItemPtr StockDataProvider::createItem(ItemId itemId) {
+Item StockDataProvider::createItem(ItemId itemId, ItemAmount amount) {
 	if (itemId > _itemData.size()) {
 		Log::error("Invalid item id %i", (int)itemId);
-		return ItemPtr();
+		return Item();
 	}
 	const ItemData* data = itemData(itemId);
 	if (data == nullptr) {
 		Log::error("Could not find item for id %i", (int)itemId);
-		return ItemPtr();
+		return Item();
 	}
 	Log::trace("Create item with id %i", (int)itemId);
-	return std::make_shared<Item>(*data);
+	return Item(*data, amount);
 }
 
 bool StockDataProvider::addItemData(ItemData* data) {
@@ -69,8 +69,9 @@ public:
 
 	/**
 	 * @brief Creates a new item.
+	 * @return An invalid @c Item if there is no @c ItemData for the given id
 	 */
-	ItemPtr createItem(ItemId itemId);
+	Item createItem(ItemId itemId, ItemAmount amount = 0);
 
 	/**
 	 * @return The last error that occurred in an init() call
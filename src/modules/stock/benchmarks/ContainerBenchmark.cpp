@@ -0,0 +1,146 @@
+/**
+ * @file
+ */
+
+#include "core/benchmark/AbstractBenchmark.h"
+#include "stock/Container.h"
+#include "stock/Stock.h"
+#include "stock/StockDataProvider.h"
+#include <memory>
+#include <vector>
+
+class ContainerBenchmark: public core::AbstractBenchmark {
+protected:
+	std::vector<std::unique_ptr<stock::ItemData>> _itemData;
+	stock::ContainerShape _shape;
+
+	void SetUp(benchmark::State& st) override {
+		core::AbstractBenchmark::SetUp(st);
+		static const uint8_t sizes[][2] = { {1, 1}, {1, 2}, {2, 2}, {2, 3}, {3, 1}, {1, 1}, {2, 1} };
+		_itemData.clear();
+		stock::ItemId id = 1;
+		for (const uint8_t* size : sizes) {
+			std::unique_ptr<stock::ItemData> data(new stock::ItemData(id++, stock::ItemType::WEAPON));
+			data->setSize(size[0], size[1]);
+			_itemData.push_back(std::move(data));
+		}
+		_shape = stock::ContainerShape();
+		// the biggest container that addRect allows
+		_shape.addRect(0, 0, stock::ContainerMaxWidth - 1, stock::ContainerMaxHeight - 1);
+	}
+
+	inline const stock::ItemData& itemData(uint32_t i) const {
+		return *_itemData[i % _itemData.size()];
+	}
+
+	static inline stock::ItemHandle handle(uint32_t i) {
+		stock::ItemHandle h;
+		h.index = i;
+		return h;
+	}
+
+	/**
+	 * @brief The placement search that tests every location
+	 */
+	static bool findSpaceBruteForce(const stock::Container& c, const stock::ItemData& item, uint8_t& targetX, uint8_t& targetY) {
+		for (uint8_t y = 0; y < stock::ContainerMaxHeight; ++y) {
+			for (uint8_t x = 0; x < stock::ContainerMaxWidth; ++x) {
+				if (!c.canAdd(item, x, y)) {
+					continue;
+				}
+				targetX = x;
+				targetY = y;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * @brief Fills the container and removes every second item
+	 */
+	void fragment(stock::Container& c) {
+		c.init(_shape);
+		for (uint32_t i = 0; c.add(handle(i), itemData(i)); ++i) {
+		}
+		const stock::Container::ContainerItems items = c.items();
+		for (size_t i = 0; i < items.size(); i += 2) {
+			c.notifyRemove(items[i].handle);
+		}
+	}
+};
+
+BENCHMARK_DEFINE_F(ContainerBenchmark, FillBruteForce) (benchmark::State& state) {
+	int64_t items = 0;
+	for (auto _ : state) {
+		stock::Container c;
+		c.init(_shape);
+		uint8_t x, y;
+		for (uint32_t i = 0; findSpaceBruteForce(c, itemData(i), x, y); ++i) {
+			c.add(handle(i), itemData(i), x, y);
+		}
+		items += c.itemCount();
+	}
+	state.SetItemsProcessed(items);
+}
+
+BENCHMARK_DEFINE_F(ContainerBenchmark, Fill) (benchmark::State& state) {
+	int64_t items = 0;
+	for (auto _ : state) {
+		stock::Container c;
+		c.init(_shape);
+		for (uint32_t i = 0; c.add(handle(i), itemData(i)); ++i) {
+		}
+		items += c.itemCount();
+	}
+	state.SetItemsProcessed(items);
+}
+
+BENCHMARK_DEFINE_F(ContainerBenchmark, FillBulk) (benchmark::State& state) {
+	std::vector<stock::Container::ContainerItem> input;
+	for (uint32_t i = 0; i < stock::ContainerMaxWidth * stock::ContainerMaxHeight; ++i) {
+		input.push_back({&itemData(i), handle(i), 0u, 0u});
+	}
+	int64_t items = 0;
+	for (auto _ : state) {
+		stock::Container c;
+		c.init(_shape);
+		items += c.add(input.data(), input.size());
+	}
+	state.SetItemsProcessed(items);
+}
+
+BENCHMARK_DEFINE_F(ContainerBenchmark, Defragment) (benchmark::State& state) {
+	stock::Container fragmented;
+	fragment(fragmented);
+	int64_t items = 0;
+	for (auto _ : state) {
+		stock::Container c = fragmented;
+		c.defragment();
+		items += c.itemCount();
+	}
+	state.SetItemsProcessed(items);
+}
+
+BENCHMARK_DEFINE_F(ContainerBenchmark, StockBulkAdd) (benchmark::State& state) {
+	const stock::StockDataProviderPtr provider = std::make_shared<stock::StockDataProvider>();
+	std::vector<stock::Item> input;
+	std::vector<stock::ItemHandle> handles(state.range(0));
+	for (int i = 0; i < state.range(0); ++i) {
+		input.emplace_back(itemData(i), 1);
+	}
+	for (auto _ : state) {
+		stock::Stock s(provider);
+		s.add(input.data(), input.size(), handles.data());
+		benchmark::DoNotOptimize(handles.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_REGISTER_F(ContainerBenchmark, FillBruteForce);
+BENCHMARK_REGISTER_F(ContainerBenchmark, Fill);
+BENCHMARK_REGISTER_F(ContainerBenchmark, FillBulk);
+BENCHMARK_REGISTER_F(ContainerBenchmark, Defragment);
+BENCHMARK_REGISTER_F(ContainerBenchmark, StockBulkAdd)->Arg(1000);
+
+BENCHMARK_MAIN();
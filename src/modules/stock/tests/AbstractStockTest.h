@@ -19,8 +19,11 @@ protected:
 	Inventory _inv;
 	const uint8_t _containerId = 0u;
 	const Container* _container;
-	ItemPtr _item1;
-	ItemPtr _item2;
+	Item _item1;
+	Item _item2;
+	// the inventory is used without a stock here - so the handles are just made up
+	ItemHandle _handle1;
+	ItemHandle _handle2;
 public:
 	virtual void SetUp() override {
 		core::AbstractTest::SetUp();
@@ -47,11 +50,11 @@ public:
 
 		_container = _inv.container(_containerId);
 
-		_item1 = _provider->createItem(_itemData1->id());
-		_item1->changeAmount(1);
+		_item1 = _provider->createItem(_itemData1->id(), 1);
+		_handle1.index = 1u;
 
-		_item2 = _provider->createItem(_itemData2->id());
-		_item2->changeAmount(1);
+		_item2 = _provider->createItem(_itemData2->id(), 1);
+		_handle2.index = 2u;
 	}
 
 	virtual void TearDown() override {
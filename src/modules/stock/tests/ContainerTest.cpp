@@ -15,13 +15,14 @@ TEST_F(ContainerTest, testAddAndRemove) {
 	ContainerShape shape;
 	EXPECT_TRUE(shape.addRect(0, 1, 1, 1));
 	c.init(shape);
-	EXPECT_FALSE(c.add(_item1, 0, 0));
-	EXPECT_TRUE(c.add(_item1, 0, 1));
-	EXPECT_FALSE(c.add(_item2, 0, 0));
-	EXPECT_FALSE(c.add(_item2, 0, 1));
-	EXPECT_EQ(_item1, c.remove(0, 1));
+	EXPECT_FALSE(c.add(_handle1, *_itemData1, 0, 0));
+	EXPECT_FALSE(c.add(_handle1, *_itemData1, 0, 1)) << "The item is two fields high";
+	EXPECT_TRUE(c.add(_handle2, *_itemData2, 0, 1));
+	EXPECT_FALSE(c.add(_handle2, *_itemData2, 0, 0));
+	EXPECT_FALSE(c.add(_handle2, *_itemData2, 0, 1));
+	EXPECT_EQ(_handle2, c.remove(0, 1));
 	EXPECT_EQ(1, c.free());
-	EXPECT_TRUE(c.add(_item2, 0, 1));
+	EXPECT_TRUE(c.add(_handle2, *_itemData2, 0, 1));
 	EXPECT_EQ(1, c.size());
 	EXPECT_EQ(0, c.free());
 }
@@ -31,8 +32,8 @@ TEST_F(ContainerTest, testNotUnique) {
 	EXPECT_TRUE(shape.addRect(0, 0, 2, 2));
 	Container c;
 	c.init(shape);
-	EXPECT_TRUE(c.add(_item2, 0, 0));
-	EXPECT_TRUE(c.add(_item2, 0, 1));
+	EXPECT_TRUE(c.add(_handle2, *_itemData2, 0, 0));
+	EXPECT_TRUE(c.add(_handle2, *_itemData2, 0, 1));
 }
 
 TEST_F(ContainerTest, testSingle) {
@@ -40,8 +41,8 @@ TEST_F(ContainerTest, testSingle) {
 	EXPECT_TRUE(shape.addRect(0, 0, 30, 30));
 	Container c;
 	c.init(shape, Container::Single);
-	EXPECT_TRUE(c.add(_item2, 0, 0));
-	EXPECT_FALSE(c.add(_item1, 0, 1));
+	EXPECT_TRUE(c.add(_handle2, *_itemData2, 0, 0));
+	EXPECT_FALSE(c.add(_handle1, *_itemData1, 0, 1));
 }
 
 TEST_F(ContainerTest, testUnique) {
@@ -49,8 +50,73 @@ TEST_F(ContainerTest, testUnique) {
 	EXPECT_TRUE(shape.addRect(0, 0, 2, 2));
 	Container c;
 	c.init(shape, Container::Unique);
-	EXPECT_TRUE(c.add(_item2, 0, 0));
-	EXPECT_FALSE(c.add(_item2, 0, 1));
+	EXPECT_TRUE(c.add(_handle2, *_itemData2, 0, 0));
+	EXPECT_FALSE(c.add(_handle2, *_itemData2, 0, 1));
+	uint8_t x, y;
+	EXPECT_FALSE(c.findSpace(*_itemData2, x, y));
+}
+
+TEST_F(ContainerTest, testFindSpace) {
+	ContainerShape shape;
+	EXPECT_TRUE(shape.addRect(0, 0, 3, 2));
+	Container c;
+	c.init(shape);
+	uint8_t x, y;
+	ASSERT_TRUE(c.findSpace(*_itemData1, x, y));
+	EXPECT_EQ(0, x);
+	EXPECT_EQ(0, y);
+	ASSERT_TRUE(c.add(_handle1, *_itemData1));
+	ASSERT_TRUE(c.add(_handle2, *_itemData2));
+	EXPECT_EQ(_handle2, c.get(1, 0)->handle);
+	ASSERT_TRUE(c.findSpace(*_itemData1, x, y));
+	EXPECT_EQ(2, x) << "The first column is taken by the first item and the second column is blocked in the first row";
+	EXPECT_EQ(0, y);
+	ASSERT_TRUE(c.add(_handle1, *_itemData1, x, y));
+	EXPECT_FALSE(c.findSpace(*_itemData1, x, y));
+	ASSERT_TRUE(c.findSpace(*_itemData2, x, y));
+	EXPECT_EQ(1, x);
+	EXPECT_EQ(1, y);
+}
+
+TEST_F(ContainerTest, testBulkAdd) {
+	ContainerShape shape;
+	EXPECT_TRUE(shape.addRect(0, 0, 2, 3));
+	Container c;
+	c.init(shape);
+	const ItemHandle handles[] = { {10u, 0u}, {11u, 0u}, {12u, 0u}, {13u, 0u} };
+	const Container::ContainerItem items[] = {
+		{_itemData2, handles[0], 0u, 0u},
+		{_itemData1, handles[1], 0u, 0u},
+		{_itemData2, handles[2], 0u, 0u},
+		{_itemData1, handles[3], 0u, 0u}
+	};
+	// the bigger items are placed first - otherwise the last of them would not fit anymore
+	ASSERT_EQ(4u, c.add(items, 4));
+	EXPECT_EQ(0, c.free());
+	EXPECT_EQ(handles[1], c.get(0, 1)->handle);
+	EXPECT_EQ(handles[3], c.get(1, 1)->handle);
+	EXPECT_EQ(handles[0], c.get(0, 2)->handle);
+	EXPECT_EQ(handles[2], c.get(1, 2)->handle);
+}
+
+TEST_F(ContainerTest, testDefragment) {
+	ContainerShape shape;
+	EXPECT_TRUE(shape.addRect(0, 0, 2, 2));
+	Container c;
+	c.init(shape);
+	ItemData wide(3, ItemType::WEAPON);
+	wide.setSize(2, 1);
+	const ItemHandle handle3 = {3u, 0u};
+	ASSERT_TRUE(c.add(_handle1, *_itemData2, 0, 0));
+	ASSERT_TRUE(c.add(_handle2, *_itemData2, 1, 1));
+	uint8_t x, y;
+	ASSERT_FALSE(c.findSpace(wide, x, y)) << "The free fields are fragmented";
+	ASSERT_TRUE(c.defragment());
+	EXPECT_EQ(2, c.free());
+	EXPECT_EQ(2u, c.itemCount());
+	ASSERT_TRUE(c.add(handle3, wide));
+	EXPECT_EQ(handle3, c.get(1, 1)->handle);
+	EXPECT_EQ(0, c.free());
 }
 
 }
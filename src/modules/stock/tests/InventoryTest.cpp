@@ -10,31 +10,46 @@ class InventoryTest: public AbstractStockTest {
 };
 
 TEST_F(InventoryTest, testAddValidLocation) {
-	ASSERT_TRUE(_inv.add(_containerId, _item1, 1, 1)) << "Could not place item to valid container position";
+	ASSERT_TRUE(_inv.add(_containerId, _handle1, *_itemData1, 1, 1)) << "Could not place item to valid container position";
 	ASSERT_TRUE(_container->hasItemOfType(_itemData1->type()));
 	ASSERT_EQ(15, _container->free());
 }
 
 TEST_F(InventoryTest, testAddInvalidLocation) {
-	ASSERT_FALSE(_inv.add(_containerId, _item1, 0, 0)) << "Could place item to invalid container position";
+	ASSERT_FALSE(_inv.add(_containerId, _handle1, *_itemData1, 0, 0)) << "Could place item to invalid container position";
 	ASSERT_FALSE(_container->hasItemOfType(_itemData1->type()));
 	ASSERT_EQ(17, _container->free());
 }
 
 TEST_F(InventoryTest, testAddAndRemove) {
-	ASSERT_TRUE(_inv.add(_containerId, _item1, 1, 1)) << "Could not place item to valid container position";
+	ASSERT_TRUE(_inv.add(_containerId, _handle1, *_itemData1, 1, 1)) << "Could not place item to valid container position";
 	ASSERT_TRUE(_container->hasItemOfType(_itemData1->type()));
 	ASSERT_EQ(15, _container->free());
-	ASSERT_EQ(_item1, _inv.remove(_containerId, 1, 2)) << "Could not remove item from container 1, 2 - even though the item with a size of two should also occupy this field";
+	ASSERT_EQ(_handle1, _inv.remove(_containerId, 1, 2)) << "Could not remove item from container 1, 2 - even though the item with a size of two should also occupy this field";
 	ASSERT_EQ(17, _container->free());
 }
 
 TEST_F(InventoryTest, testRemoveFromInvalidLocation) {
-	ASSERT_TRUE(_inv.add(_containerId, _item1, 1, 1)) << "Could not place item to valid container position";
-	ASSERT_EQ(nullptr, _inv.remove(_containerId, 3, 3)) << "Removed item from invalid position 3, 3";
-	ASSERT_EQ(nullptr, _inv.remove(_containerId, 3, 1)) << "Removed item from invalid position 3, 1";
-	ASSERT_EQ(nullptr, _inv.remove(_containerId, 2, 1)) << "Removed item from invalid position 2, 1";
+	ASSERT_TRUE(_inv.add(_containerId, _handle1, *_itemData1, 1, 1)) << "Could not place item to valid container position";
+	ASSERT_FALSE(_inv.remove(_containerId, 3, 3).isValid()) << "Removed item from invalid position 3, 3";
+	ASSERT_FALSE(_inv.remove(_containerId, 3, 1).isValid()) << "Removed item from invalid position 3, 1";
+	ASSERT_FALSE(_inv.remove(_containerId, 2, 1).isValid()) << "Removed item from invalid position 2, 1";
 	ASSERT_EQ(15, _container->free());
 }
 
+TEST_F(InventoryTest, testMove) {
+	ContainerShape shape;
+	shape.addRect(0, 0, 2, 2);
+	ASSERT_TRUE(_inv.initContainer(1, shape));
+	ASSERT_TRUE(_inv.add(_containerId, _handle1, *_itemData1, 1, 1));
+	ASSERT_TRUE(_inv.move(_containerId, 1, 2, _containerId, 1, 2)) << "The item should not block itself";
+	EXPECT_EQ(nullptr, _inv.container(_containerId)->get(1, 1));
+	ASSERT_FALSE(_inv.move(_containerId, 1, 2, 1, 1, 1)) << "The item doesn't fit at this location";
+	EXPECT_EQ(_handle1, _inv.container(_containerId)->get(1, 3)->handle) << "A failed move must keep the old location";
+	ASSERT_TRUE(_inv.move(_containerId, 1, 2, 1));
+	EXPECT_EQ(17, _container->free());
+	EXPECT_EQ(_handle1, _inv.container(1)->get(0, 1)->handle);
+	EXPECT_FALSE(_inv.move(_containerId, 1, 2, 1)) << "There is no item to move";
+}
+
 }
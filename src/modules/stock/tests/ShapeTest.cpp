@@ -5,6 +5,7 @@
 #include "stock/tests/AbstractStockTest.h"
 #include "stock/Shape.h"
 #include "core/Common.h"
+#include <random>
 
 namespace stock {
 
@@ -91,4 +92,52 @@ TEST_F(ShapeTest, testContainerShape) {
 	EXPECT_TRUE(containerShape.isFree(itemShape, 0, 0));
 }
 
+TEST_F(ShapeTest, testItemShapeWidthAndHeight) {
+	ItemShape shape;
+	shape.addRect(0, 0, 1, 3);
+	EXPECT_EQ(1, shape.width());
+	EXPECT_EQ(3, shape.height());
+}
+
+TEST_F(ShapeTest, testFindFree) {
+	ContainerShape containerShape;
+	EXPECT_TRUE(containerShape.addRect(0, 0, 40, 20));
+	ItemShape itemShape;
+	itemShape.addRect(0, 0, 2, 3);
+	itemShape.set(2, 2);
+	std::minstd_rand random(1u);
+	// compare the bitmask search with testing every location
+	for (int i = 0; i < 200; ++i) {
+		uint8_t x = 0u, y = 0u;
+		const bool found = containerShape.findFree(itemShape, x, y);
+		bool expected = false;
+		uint8_t expectedX = 0u, expectedY = 0u;
+		for (int cy = 0; cy < ContainerMaxHeight && !expected; ++cy) {
+			for (int cx = 0; cx < ContainerMaxWidth; ++cx) {
+				if (containerShape.isFree(itemShape, cx, cy)) {
+					expected = true;
+					expectedX = cx;
+					expectedY = cy;
+					break;
+				}
+			}
+		}
+		ASSERT_EQ(expected, found) << "Iteration " << i;
+		if (!found) {
+			break;
+		}
+		ASSERT_EQ(expectedX, x) << "Iteration " << i;
+		ASSERT_EQ(expectedY, y) << "Iteration " << i;
+		containerShape.addShape(itemShape, x, y);
+		// block a few random fields to get a fragmented container
+		ItemShape blocker;
+		blocker.set(0, 0);
+		const uint8_t bx = random() % 40;
+		const uint8_t by = random() % 20;
+		if (containerShape.isFree(blocker, bx, by)) {
+			containerShape.addShape(blocker, bx, by);
+		}
+	}
+}
+
 }
@@ -12,15 +12,73 @@ class StockTest: public AbstractStockTest {
 
 TEST_F(StockTest, testAddAndRemove) {
 	Stock stock(_provider);
-	ASSERT_EQ(1, _item1->amount());
-	ASSERT_EQ(_item1, stock.add(_item1)) << "Could not add item to stock";
-	const ItemPtr& item3 = _provider->createItem(_itemData1->id());
-	item3->changeAmount(1);
-	ASSERT_EQ(_item1, stock.add(item3)) << "Got wrong item from stock - item1 and item3 are the same";
-	ASSERT_EQ(2, stock.count(_item1->type()));
-	ASSERT_EQ(2, _item1->amount());
-	ASSERT_EQ(0, stock.remove(_item1)) << "Could not remove from stock";
-	ASSERT_EQ(0, stock.count(_item1->type()));
+	ASSERT_EQ(1, _item1.amount());
+	const ItemHandle handle = stock.add(_item1);
+	ASSERT_TRUE(handle.isValid()) << "Could not add item to stock";
+	const Item& item3 = _provider->createItem(_itemData1->id(), 1);
+	ASSERT_EQ(handle, stock.add(item3)) << "Got wrong item from stock - item1 and item3 are the same";
+	ASSERT_EQ(2, stock.count(_item1.type()));
+	ASSERT_EQ(2, stock.item(handle)->amount());
+	ASSERT_EQ(1, stock.remove(handle, 1));
+	ASSERT_EQ(0, stock.remove(handle, 1)) << "Could not remove from stock";
+	ASSERT_EQ(0, stock.count(_item1.type()));
+}
+
+TEST_F(StockTest, testHandles) {
+	Stock stock(_provider);
+	const ItemHandle handle1 = stock.add(_item1);
+	const ItemHandle handle2 = stock.add(_item2);
+	ASSERT_NE(handle1, handle2);
+	ASSERT_EQ(0, stock.remove(handle1, 1));
+	EXPECT_EQ(nullptr, stock.item(handle1)) << "The handle of a removed item must not resolve";
+	ASSERT_NE(nullptr, stock.item(handle2));
+	EXPECT_EQ(_itemData2->id(), stock.item(handle2)->id());
+	const ItemHandle handle3 = stock.add(_item1);
+	EXPECT_EQ(handle1.index, handle3.index) << "The slot of the removed item should get reused";
+	EXPECT_NE(handle1, handle3);
+	EXPECT_EQ(nullptr, stock.item(handle1));
+	EXPECT_FALSE(stock.add(_provider->createItem(_itemData1->id())).isValid()) << "Items without an amount should not be added";
+}
+
+TEST_F(StockTest, testBulkAdd) {
+	Stock stock(_provider);
+	const Item items[] = { _item1, _item2, _item1 };
+	ItemHandle handles[3];
+	stock.add(items, 3, handles);
+	EXPECT_EQ(handles[0], handles[2]);
+	EXPECT_NE(handles[0], handles[1]);
+	EXPECT_EQ(2, stock.count(_itemData1->id()));
+	EXPECT_EQ(1, stock.count(_itemData2->id()));
+}
+
+TEST_F(StockTest, testRemoveFromInventory) {
+	Stock stock(_provider);
+	ContainerShape shape;
+	shape.addRect(0, 0, 4, 4);
+	ASSERT_TRUE(stock.inventory().initContainer(_containerId, shape));
+	const ItemHandle handle = stock.add(_item2, _containerId, 1, 1);
+	ASSERT_TRUE(handle.isValid());
+	const Container* container = stock.inventory().container(_containerId);
+	ASSERT_EQ(1u, container->itemCount());
+	ASSERT_EQ(0, stock.remove(handle, 1));
+	EXPECT_EQ(0u, container->itemCount()) << "Removing the item from the stock should remove it from the containers";
+	EXPECT_FALSE(stock.add(_item2, _containerId, 5, 5).isValid()) << "Placed the item outside of the container shape";
+	EXPECT_EQ(0, stock.count(_itemData2->id())) << "Failed placements must not change the stock";
+}
+
+TEST_F(StockTest, testAddPlacedItem) {
+	Stock stock(_provider);
+	ContainerShape shape;
+	shape.addRect(0, 0, 4, 4);
+	ASSERT_TRUE(stock.inventory().initContainer(_containerId, shape));
+	const ItemHandle handle = stock.add(_item2, _containerId, 1, 1);
+	ASSERT_TRUE(handle.isValid());
+	EXPECT_EQ(handle, stock.add(_item2, _containerId, 2, 2)) << "The existing item should be returned";
+	const Container* container = stock.inventory().container(_containerId);
+	ASSERT_EQ(1u, container->itemCount()) << "The item must not be placed twice";
+	EXPECT_EQ(1, container->items()[0].x);
+	EXPECT_EQ(1, container->items()[0].y);
+	EXPECT_EQ(2, stock.count(_itemData2->id()));
 }
 
 }
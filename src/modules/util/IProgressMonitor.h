@@ -4,12 +4,17 @@
 
 #pragma once
 
+#include <atomic>
+
 namespace util {
 
+/**
+ * @note The steps are atomic - the progress can be queried while a worker thread is stepping
+ */
 class IProgressMonitor {
 protected:
-	long _max;
-	long _steps;
+	std::atomic_long _max;
+	std::atomic_long _steps;
 public:
 	IProgressMonitor(long max = 100l):
 			_max(max), _steps(0l) {
@@ -20,6 +25,7 @@ public:
 
 	void init(long max) {
 		_max = max;
+		_steps = 0l;
 	}
 
 	virtual void step(long steps = 1l) {
@@ -79,6 +79,12 @@ public:
 	void unmapData(int32_t idx) const;
 
 	bool update(int32_t idx, const void* data, size_t size);
+	/**
+	 * @brief Only updates a part of the buffer - the buffer keeps its size
+	 * @param[in] offset The offset in bytes
+	 * @note The range must be inside of the current buffer size
+	 */
+	bool update(int32_t idx, size_t offset, const void* data, size_t size);
 
 	/**
 	 * @return -1 on error - otherwise the index [0,n) of the created buffer (not the Id)
@@ -15,6 +15,7 @@
 #include <glm/fwd.hpp>
 #include <glm/vec3.hpp>
 #include <list>
+#include <type_traits>
 #include "core/Trace.h"
 #include "Face.h"
 
@@ -112,6 +113,21 @@ SDL_FORCE_INLINE bool isQuadFlipped(const VoxelVertex& v00, const VoxelVertex& v
 
 extern void meshify(Mesh* result, bool mergeQuads, QuadListVector& vecListQuads);
 
+namespace _priv {
+
+/**
+ * @brief Detects volumes that can tell whether a brick of voxels is empty (e.g. SparseVolume)
+ */
+template<typename VolumeType, typename = void>
+struct HasEmptyBricks : std::false_type {
+};
+
+template<typename VolumeType>
+struct HasEmptyBricks<VolumeType, std::void_t<decltype(std::declval<const VolumeType&>().isEmptyBrick(glm::ivec3()))>> : std::true_type {
+};
+
+}
+
 /**
  * The CubicSurfaceExtractor creates a mesh in which each voxel appears to be rendered as a cube
  * Introduction
@@ -248,7 +264,33 @@ void extractCubicMesh(VolumeType* volData, const Region& region, Mesh* result, I
 
 			volumeSampler.setPosition(offset.x, y, z);
 
+			// quads are only generated between the current voxel and its left, below and before neighbours - and
+			// only if one of them is not air. If the row doesn't touch the lower y or z face of a brick, all
+			// these neighbours of the brick's inner voxels are in the same brick. For an empty brick they can be
+			// skipped.
+			glm::ivec3 brickMins(0);
+			bool innerRow = false;
+			if constexpr (_priv::HasEmptyBricks<VolumeType>::value) {
+				brickMins = volData->brickLowerCorner(glm::ivec3(offset.x, y, z));
+				innerRow = y != brickMins.y && z != brickMins.z;
+			}
+
 			for (int32_t x = offset.x; x <= upper.x; ++x) {
+				if constexpr (_priv::HasEmptyBricks<VolumeType>::value) {
+					const glm::ivec3 pos(x, y, z);
+					if (innerRow && volData->region().containsPoint(pos)) {
+						brickMins = volData->brickLowerCorner(pos);
+						if (x != brickMins.x && volData->isEmptyBrick(pos)) {
+							const int32_t lastX = core_min(brickMins.x + VolumeType::BrickSize - 1, upper.x);
+							if (lastX == upper.x) {
+								break;
+							}
+							x = lastX;
+							volumeSampler.setPosition(x + 1, y, z);
+							continue;
+						}
+					}
+				}
 				const uint32_t regX = x - offset.x;
 
 				/**
@@ -126,7 +126,16 @@ void PagedVolume::setVoxel(int32_t uXPos, int32_t uYPos, int32_t uZPos, const Vo
 	const uint16_t yOffset = static_cast<uint16_t>(uYPos - (chunkY << _chunkSideLengthPower));
 	const uint16_t zOffset = static_cast<uint16_t>(uZPos - (chunkZ << _chunkSideLengthPower));
 
-	chunk(chunkX, chunkY, chunkZ)->setVoxel(xOffset, yOffset, zOffset, tValue);
+	const ChunkPtr& chunkPtr = chunk(chunkX, chunkY, chunkZ);
+	chunkPtr->setVoxel(xOffset, yOffset, zOffset, tValue);
+	notifyModified(chunkPtr);
+}
+
+void PagedVolume::notifyModified(const ChunkPtr& chunk) const {
+	core::RecursiveScopedReadLock readLock(_listenerLock);
+	for (IChunkListener* l : _listener) {
+		l->onModified(chunk);
+	}
 }
 
 /**
@@ -164,6 +173,7 @@ void PagedVolume::setVoxels(int32_t uXPos, int32_t uYPos, int32_t uZPos, int nx,
 				const int32_t n = core_min(left, int32_t(chunkPtr->_sideLength));
 
 				chunkPtr->setVoxels(xOffset, yOffset, zOffset, array, n);
+				notifyModified(chunkPtr);
 				left -= n;
 				array += ptrdiff_t(n);
 				y += n;
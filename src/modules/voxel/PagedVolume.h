@@ -66,6 +66,14 @@ public:
 		void setVoxels(uint32_t uXPos, uint32_t uYPos, uint32_t uZPos, const Voxel* tValues, int amount);
 		void setVoxel(const glm::i16vec3& v3dPos, const Voxel& tValue);
 
+		/**
+		 * @brief Calls the given function with the voxel data while the write lock of the chunk is held. Use this
+		 * to write many voxels at once without locking for each of them.
+		 * @note The voxels are stored in morton order - see @c Morton.h
+		 */
+		template<class FUNC>
+		void modify(FUNC&& func);
+
 	private:
 		// This is updated by the PagedVolume and used to discard the least recently used chunks.
 		uint32_t _chunkLastAccessed = 0u;
@@ -95,6 +103,12 @@ public:
 		virtual void onCreate(const ChunkPtr& ptr) {};
 
 		virtual void onRemove(const ChunkPtr& ptr) {};
+
+		/**
+		 * @brief Called after voxels of the chunk were changed via @c PagedVolume::setVoxel() or
+		 * @c PagedVolume::setVoxels() - writes into the chunk while it's paged in are not reported
+		 */
+		virtual void onModified(const ChunkPtr& ptr) {};
 	};
 
 	struct PagerContext {
@@ -340,6 +354,7 @@ private:
 	ChunkPtr chunk(int32_t uChunkX, int32_t uChunkY, int32_t uChunkZ) const;
 	ChunkPtr existingChunk(int32_t uChunkX, int32_t uChunkY, int32_t uChunkZ) const;
 	ChunkPtr createNewChunk(int32_t uChunkX, int32_t uChunkY, int32_t uChunkZ) const;
+	void notifyModified(const ChunkPtr& chunk) const;
 	void deleteOldestChunkIfNeeded() const;
 
 	// Storing these properties individually has proved to be faster than keeping
@@ -780,6 +795,14 @@ inline Region PagedVolume::Chunk::region() const {
 	 return Region(mins, maxs);
 }
 
+template<class FUNC>
+inline void PagedVolume::Chunk::modify(FUNC&& func) {
+	core_assert_msg(_data, "No uncompressed data - chunk must be decompressed before accessing voxels.");
+	core::RecursiveScopedWriteLock writeLock(_rwLock);
+	func(_data);
+	_dataModified = true;
+}
+
 inline const Region& PagedVolume::region() const {
 	return _region;
 }
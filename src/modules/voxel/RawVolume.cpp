@@ -127,6 +127,51 @@ bool RawVolume::setVoxel(const glm::ivec3& pos, const Voxel& voxel) {
 	return true;
 }
 
+int RawVolume::setVoxels(const glm::ivec3& pos, const Voxel* voxels, int32_t amount) {
+	if (amount <= 0) {
+		return 0;
+	}
+	const bool inside = _region.containsPoint(pos) && _region.containsPointInX(pos.x + amount - 1);
+	core_assert_msg(inside, "Row %i:%i:%i with %i voxels is outside valid region (mins[%i:%i:%i], maxs[%i:%i:%i])",
+			pos.x, pos.y, pos.z, amount, _region.getLowerX(), _region.getLowerY(), _region.getLowerZ(),
+			_region.getUpperX(), _region.getUpperY(), _region.getUpperZ());
+	if (!inside) {
+		return 0;
+	}
+	const glm::ivec3& lowerCorner = _region.getLowerCorner();
+	const int32_t localXPos = pos.x - lowerCorner.x;
+	const int32_t localYPos = pos.y - lowerCorner.y;
+	const int32_t localZPos = pos.z - lowerCorner.z;
+	Voxel* row = _data + localXPos + localYPos * width() + localZPos * width() * height();
+	int32_t first = -1;
+	int32_t last = -1;
+	int changed = 0;
+	for (int32_t i = 0; i < amount; ++i) {
+		if (row[i].isSame(voxels[i])) {
+			continue;
+		}
+		if (first == -1) {
+			first = i;
+		}
+		last = i;
+		row[i] = voxels[i];
+		++changed;
+	}
+	if (changed == 0) {
+		return 0;
+	}
+	_mins = (glm::min)(_mins, glm::ivec3(pos.x + first, pos.y, pos.z));
+	_maxs = (glm::max)(_maxs, glm::ivec3(pos.x + last, pos.y, pos.z));
+	_boundsValid = true;
+	return changed;
+}
+
+void RawVolume::extendBounds(const glm::ivec3& mins, const glm::ivec3& maxs) {
+	_mins = (glm::min)(_mins, mins);
+	_maxs = (glm::max)(_maxs, maxs);
+	_boundsValid = true;
+}
+
 /**
  * This function should probably be made internal...
  */
@@ -175,7 +220,7 @@ bool RawVolume::Sampler::setVoxel(const Voxel& voxel) {
 	}
 	*_currentVoxel = voxel;
 	_volume->_mins = (glm::min)(_volume->_mins, _posInVolume);
-	_volume->_mins = (glm::max)(_volume->_maxs, _posInVolume);
+	_volume->_maxs = (glm::max)(_volume->_maxs, _posInVolume);
 	_volume->_boundsValid = true;
 	return true;
 }
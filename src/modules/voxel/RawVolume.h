@@ -134,6 +134,8 @@ public:
 	/// the vector that describes the maxs value of an aabb where a voxel is set in this volume
 	/// deleting a voxel afterwards might lead to invalid results
 	glm::ivec3 maxs() const;
+	/// @c false if no voxel was set yet - mins() and maxs() return the region in that case
+	bool boundsValid() const;
 
 	/// Gets a voxel at the position given by <tt>x,y,z</tt> coordinates
 	const Voxel& voxel(int32_t x, int32_t y, int32_t z) const;
@@ -146,6 +148,15 @@ public:
 	bool setVoxel(int32_t x, int32_t y, int32_t z, const Voxel& voxel);
 	/// Sets the voxel at the position given by a 3D vector
 	bool setVoxel(const glm::ivec3& pos, const Voxel& voxel);
+	/**
+	 * @brief Copies a row of voxels along the x axis into the volume memory
+	 * @param[in] pos The position of the first voxel of the row
+	 * @param[in] voxels The voxels to copy
+	 * @param[in] amount The amount of voxels - the row must be inside the volume region
+	 * @return The amount of voxels that were changed
+	 * @note Same result as calling setVoxel() for every voxel in the row
+	 */
+	int setVoxels(const glm::ivec3& pos, const Voxel* voxels, int32_t amount);
 
 	/// Calculates approximatly how many bytes of memory the volume is currently using.
 	uint32_t calculateSizeInBytes();
@@ -156,6 +167,28 @@ public:
 		return (const uint8_t*)_data;
 	}
 
+	/**
+	 * @brief Direct access to the voxel memory for bulk operations. The x axis is the fastest
+	 * changing index, followed by y and z: <tt>x + y * width() + z * width() * height()</tt>
+	 * relative to the lower corner of the region.
+	 * @note Writing to the memory doesn't update the bounds - see extendBounds()
+	 */
+	inline Voxel* voxels() {
+		return _data;
+	}
+
+	inline const Voxel* voxels() const {
+		return _data;
+	}
+
+	/**
+	 * @brief Extends the bounds of the set voxels by the given area. Needed after the memory
+	 * was modified via voxels().
+	 * @sa mins()
+	 * @sa maxs()
+	 */
+	void extendBounds(const glm::ivec3& mins, const glm::ivec3& maxs);
+
 	/**
 	 * @brief Shift the region of the volume by the given coordinates
 	 */
@@ -236,6 +269,10 @@ inline glm::ivec3 RawVolume::maxs() const {
 	return _maxs;
 }
 
+inline bool RawVolume::boundsValid() const {
+	return _boundsValid;
+}
+
 /**
  * @brief This version of the function is provided so that the wrap mode does not need
  * to be specified as a template parameter, as it may be confusing to some users.
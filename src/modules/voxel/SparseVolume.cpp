@@ -0,0 +1,203 @@
+/**
+ * @file
+ */
+
+#include "SparseVolume.h"
+#include "RawVolume.h"
+#include "core/Assert.h"
+#include "core/Common.h"
+#include <limits>
+
+namespace voxel {
+
+SparseVolume::SparseVolume(const Region& region) :
+		_region(region), _mins((std::numeric_limits<int>::max)()), _maxs((std::numeric_limits<int>::min)()) {
+	core_assert_msg(width() > 0, "Volume width must be greater than zero.");
+	core_assert_msg(height() > 0, "Volume height must be greater than zero.");
+	core_assert_msg(depth() > 0, "Volume depth must be greater than zero.");
+	_bricksDim = (_region.getDimensionsInVoxels() + BrickMask) >> BrickBits;
+	_bricks.resize(_bricksDim.x * _bricksDim.y * _bricksDim.z, nullptr);
+}
+
+SparseVolume::SparseVolume(const RawVolume* volume) :
+		SparseVolume(volume->region()) {
+	setBorderValue(volume->borderValue());
+	const Voxel* data = volume->voxels();
+	const glm::ivec3& lowerCorner = _region.getLowerCorner();
+	const int32_t w = width();
+	const int32_t h = height();
+	const int32_t d = depth();
+	for (int32_t z = 0; z < d; ++z) {
+		for (int32_t y = 0; y < h; ++y) {
+			const Voxel* row = data + y * w + z * w * h;
+			for (int32_t x = 0; x < w; ++x) {
+				if (row[x].isSame(_emptyVoxel)) {
+					continue;
+				}
+				setVoxel(lowerCorner.x + x, lowerCorner.y + y, lowerCorner.z + z, row[x]);
+			}
+		}
+	}
+}
+
+SparseVolume::~SparseVolume() {
+	clear();
+}
+
+void SparseVolume::setBorderValue(const Voxel& voxel) {
+	_borderVoxel = voxel;
+}
+
+bool SparseVolume::setVoxel(const glm::ivec3& pos, const Voxel& voxel) {
+	const bool inside = _region.containsPoint(pos);
+	core_assert_msg(inside, "Position is outside valid region %i:%i:%i (mins[%i:%i:%i], maxs[%i:%i:%i])",
+			pos.x, pos.y, pos.z, _region.getLowerX(), _region.getLowerY(), _region.getLowerZ(),
+			_region.getUpperX(), _region.getUpperY(), _region.getUpperZ());
+	if (!inside) {
+		return false;
+	}
+	Brick*& brick = _bricks[brickIndex(pos)];
+	if (brick == nullptr) {
+		if (voxel.isSame(_emptyVoxel)) {
+			return false;
+		}
+		brick = new Brick();
+		++_allocatedBricks;
+	}
+	const glm::ivec3 local = (pos - _region.getLowerCorner()) & BrickMask;
+	Voxel& current = brick->voxels[local.x + local.y * BrickSize + local.z * BrickSize * BrickSize];
+	if (current.isSame(voxel)) {
+		return false;
+	}
+	// the brick is not released if the counter drops to zero - this keeps the samplers valid.
+	// See compact()
+	if (current.isSame(_emptyVoxel)) {
+		++brick->count;
+	} else if (voxel.isSame(_emptyVoxel)) {
+		--brick->count;
+	}
+	current = voxel;
+	_mins = (glm::min)(_mins, pos);
+	_maxs = (glm::max)(_maxs, pos);
+	_boundsValid = true;
+	return true;
+}
+
+bool SparseVolume::isEmptyBrick(const glm::ivec3& pos) const {
+	if (!_region.containsPoint(pos)) {
+		return false;
+	}
+	const Brick* brick = _bricks[brickIndex(pos)];
+	return brick == nullptr || brick->count == 0;
+}
+
+glm::ivec3 SparseVolume::brickLowerCorner(const glm::ivec3& pos) const {
+	const glm::ivec3& lowerCorner = _region.getLowerCorner();
+	return lowerCorner + (((pos - lowerCorner) >> BrickBits) << BrickBits);
+}
+
+bool SparseVolume::empty() const {
+	for (const Brick* brick : _bricks) {
+		if (brick != nullptr && brick->count > 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+int SparseVolume::compact() {
+	int released = 0;
+	for (Brick*& brick : _bricks) {
+		if (brick == nullptr || brick->count > 0) {
+			continue;
+		}
+		delete brick;
+		brick = nullptr;
+		++released;
+	}
+	_allocatedBricks -= released;
+	return released;
+}
+
+int SparseVolume::copyTo(RawVolume* volume) const {
+	const Region& target = volume->region();
+	const glm::ivec3& lowerCorner = _region.getLowerCorner();
+	int changed = 0;
+	for (int32_t bz = 0; bz < _bricksDim.z; ++bz) {
+		for (int32_t by = 0; by < _bricksDim.y; ++by) {
+			for (int32_t bx = 0; bx < _bricksDim.x; ++bx) {
+				const Brick* brick = _bricks[bx + by * _bricksDim.x + bz * _bricksDim.x * _bricksDim.y];
+				if (brick == nullptr || brick->count == 0) {
+					continue;
+				}
+				const glm::ivec3 brickMins = lowerCorner + glm::ivec3(bx, by, bz) * BrickSize;
+				const glm::ivec3 brickMaxs = brickMins + BrickMask;
+				const glm::ivec3 mins = (glm::max)((glm::max)(brickMins, lowerCorner), target.getLowerCorner());
+				const glm::ivec3 maxs = (glm::min)((glm::min)(brickMaxs, _region.getUpperCorner()), target.getUpperCorner());
+				if (glm::any(glm::greaterThan(mins, maxs))) {
+					continue;
+				}
+				const int32_t amount = maxs.x - mins.x + 1;
+				for (int32_t z = mins.z; z <= maxs.z; ++z) {
+					for (int32_t y = mins.y; y <= maxs.y; ++y) {
+						const glm::ivec3 local = glm::ivec3(mins.x, y, z) - brickMins;
+						const Voxel* row = brick->voxels + local.x + local.y * BrickSize + local.z * BrickSize * BrickSize;
+						changed += volume->setVoxels(glm::ivec3(mins.x, y, z), row, amount);
+					}
+				}
+			}
+		}
+	}
+	return changed;
+}
+
+size_t SparseVolume::calculateSizeInBytes() const {
+	return sizeof(*this) + _bricks.capacity() * sizeof(Brick*) + _allocatedBricks * sizeof(Brick);
+}
+
+void SparseVolume::clear() {
+	for (Brick*& brick : _bricks) {
+		delete brick;
+		brick = nullptr;
+	}
+	_allocatedBricks = 0;
+	_mins = glm::ivec3((std::numeric_limits<int>::max)());
+	_maxs = glm::ivec3((std::numeric_limits<int>::min)());
+	_boundsValid = false;
+}
+
+SparseVolume::Sampler::Sampler(const SparseVolume* volume) :
+		_volume(const_cast<SparseVolume*>(volume)) {
+}
+
+SparseVolume::Sampler::Sampler(const SparseVolume& volume) :
+		_volume(const_cast<SparseVolume*>(&volume)) {
+}
+
+bool SparseVolume::Sampler::setVoxel(const Voxel& voxel) {
+	if (!_valid) {
+		return false;
+	}
+	_volume->setVoxel(_posInVolume, voxel);
+	// the brick might have been allocated
+	setPosition(_posInVolume);
+	return true;
+}
+
+bool SparseVolume::Sampler::setPosition(int32_t x, int32_t y, int32_t z) {
+	_posInVolume = glm::ivec3(x, y, z);
+	const Region& region = _volume->region();
+	_valid = region.containsPoint(_posInVolume);
+	if (!_valid) {
+		_brick = nullptr;
+		return false;
+	}
+	const glm::ivec3 brickMins = _volume->brickLowerCorner(_posInVolume);
+	_brick = _volume->_bricks[_volume->brickIndex(_posInVolume)];
+	_local = _posInVolume - brickMins;
+	_localMaxs = (glm::min)(glm::ivec3(BrickMask), region.getUpperCorner() - brickMins);
+	_index = _local.x + _local.y * BrickSize + _local.z * BrickSize * BrickSize;
+	return true;
+}
+
+}
@@ -0,0 +1,478 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "Voxel.h"
+#include "Region.h"
+#include "core/NonCopyable.h"
+#include <vector>
+
+namespace voxel {
+
+class RawVolume;
+
+/**
+ * @brief Volume implementation that stores the voxels in bricks of BrickSize^3 voxels.
+ *
+ * The bricks are only allocated once a voxel is set inside of them - areas without voxels only cost
+ * one pointer per brick. The volume has the same voxel(), setVoxel() and Sampler interface as the
+ * RawVolume and can be used with the same templates (e.g. the surface extractor).
+ *
+ * @note The bricks are aligned to the lower corner of the region.
+ * @sa RawVolume
+ */
+class SparseVolume : public core::NonCopyable {
+public:
+	static constexpr int BrickBits = 4;
+	static constexpr int BrickSize = 1 << BrickBits;
+	static constexpr int BrickMask = BrickSize - 1;
+	static constexpr int BrickVoxels = BrickSize * BrickSize * BrickSize;
+
+private:
+	struct Brick {
+		Voxel voxels[BrickVoxels];
+		/** The amount of voxels that are not the default voxel */
+		int32_t count = 0;
+	};
+
+public:
+	/**
+	 * @brief The sampler caches the brick of the current position - moving inside of a brick doesn't need
+	 * any lookup.
+	 * @note Setting voxels via the volume might allocate new bricks - the sampler picks them up with the
+	 * next setPosition() call.
+	 */
+	class Sampler {
+	public:
+		Sampler(const SparseVolume& volume);
+		Sampler(const SparseVolume* volume);
+
+		const Voxel& voxel() const;
+
+		bool currentPositionValid() const;
+
+		bool setPosition(const glm::ivec3& pos);
+		bool setPosition(int32_t x, int32_t y, int32_t z);
+		bool setVoxel(const Voxel& voxel);
+		const glm::ivec3& position() const;
+
+		void movePositiveX();
+		void movePositiveY();
+		void movePositiveZ();
+
+		void moveNegativeX();
+		void moveNegativeY();
+		void moveNegativeZ();
+
+		const Voxel& peekVoxel1nx1ny1nz() const;
+		const Voxel& peekVoxel1nx1ny0pz() const;
+		const Voxel& peekVoxel1nx1ny1pz() const;
+		const Voxel& peekVoxel1nx0py1nz() const;
+		const Voxel& peekVoxel1nx0py0pz() const;
+		const Voxel& peekVoxel1nx0py1pz() const;
+		const Voxel& peekVoxel1nx1py1nz() const;
+		const Voxel& peekVoxel1nx1py0pz() const;
+		const Voxel& peekVoxel1nx1py1pz() const;
+
+		const Voxel& peekVoxel0px1ny1nz() const;
+		const Voxel& peekVoxel0px1ny0pz() const;
+		const Voxel& peekVoxel0px1ny1pz() const;
+		const Voxel& peekVoxel0px0py1nz() const;
+		const Voxel& peekVoxel0px0py0pz() const;
+		const Voxel& peekVoxel0px0py1pz() const;
+		const Voxel& peekVoxel0px1py1nz() const;
+		const Voxel& peekVoxel0px1py0pz() const;
+		const Voxel& peekVoxel0px1py1pz() const;
+
+		const Voxel& peekVoxel1px1ny1nz() const;
+		const Voxel& peekVoxel1px1ny0pz() const;
+		const Voxel& peekVoxel1px1ny1pz() const;
+		const Voxel& peekVoxel1px0py1nz() const;
+		const Voxel& peekVoxel1px0py0pz() const;
+		const Voxel& peekVoxel1px0py1pz() const;
+		const Voxel& peekVoxel1px1py1nz() const;
+		const Voxel& peekVoxel1px1py0pz() const;
+		const Voxel& peekVoxel1px1py1pz() const;
+
+	protected:
+		const Voxel& peek(int32_t dx, int32_t dy, int32_t dz) const;
+
+		SparseVolume* _volume;
+
+		glm::ivec3 _posInVolume { 0, 0, 0 };
+		/** The brick of the current position - @c nullptr if it's not allocated */
+		const Brick* _brick = nullptr;
+		/** The position inside the brick */
+		glm::ivec3 _local { 0, 0, 0 };
+		/** The part of the brick that is inside the volume region - the bricks are aligned to the lower corner */
+		glm::ivec3 _localMaxs { -1, -1, -1 };
+		int32_t _index = 0;
+		bool _valid = false;
+	};
+
+	class BufferedSampler : public Sampler {
+	public:
+		BufferedSampler(const SparseVolume& volume, const Region& region = Region()) : Sampler(volume) {}
+		BufferedSampler(const SparseVolume* volume, const Region& region = Region()) : Sampler(volume) {}
+	};
+
+	SparseVolume(const Region& region);
+	/**
+	 * @brief Only the voxels that differ from the default voxel are copied
+	 */
+	SparseVolume(const RawVolume* volume);
+	~SparseVolume();
+
+	/// Gets the value used for voxels which are outside the volume
+	const Voxel& borderValue() const;
+	/// Sets the value used for voxels which are outside the volume
+	void setBorderValue(const Voxel& voxel);
+	/// Gets a Region representing the extents of the Volume.
+	const Region& region() const;
+
+	int32_t width() const;
+	int32_t height() const;
+	int32_t depth() const;
+
+	/// the vector that describes the mins value of an aabb where a voxel is set in this volume
+	/// deleting a voxel afterwards might lead to invalid results
+	glm::ivec3 mins() const;
+	/// the vector that describes the maxs value of an aabb where a voxel is set in this volume
+	/// deleting a voxel afterwards might lead to invalid results
+	glm::ivec3 maxs() const;
+
+	const Voxel& voxel(int32_t x, int32_t y, int32_t z) const;
+	const Voxel& voxel(const glm::ivec3& pos) const;
+
+	bool setVoxel(int32_t x, int32_t y, int32_t z, const Voxel& voxel);
+	/**
+	 * @return @c true if the voxel was placed, @c false if it was already the same voxel
+	 */
+	bool setVoxel(const glm::ivec3& pos, const Voxel& voxel);
+
+	/**
+	 * @return @c true if no voxel in the brick of the given position differs from the default voxel
+	 */
+	bool isEmptyBrick(const glm::ivec3& pos) const;
+	/**
+	 * @return The lower corner of the brick of the given position
+	 */
+	glm::ivec3 brickLowerCorner(const glm::ivec3& pos) const;
+	/**
+	 * @return The amount of bricks that are allocated
+	 */
+	int bricks() const;
+
+	/**
+	 * @return @c true if no voxel differs from the default voxel
+	 */
+	bool empty() const;
+
+	/**
+	 * @brief Releases the memory of the bricks that only contain default voxels (e.g. because all their
+	 * voxels were removed again)
+	 * @note The samplers of this volume must be re-positioned afterwards
+	 * @return The amount of released bricks
+	 */
+	int compact();
+
+	/**
+	 * @brief Copies the voxels of the allocated bricks into the given volume - only the part that is inside
+	 * the region of both volumes is copied.
+	 * @return The amount of changed voxels in the given volume
+	 */
+	int copyTo(RawVolume* volume) const;
+
+	/// Calculates approximatly how many bytes of memory the volume is currently using.
+	size_t calculateSizeInBytes() const;
+
+	void clear();
+
+private:
+	int32_t brickIndex(const glm::ivec3& pos) const;
+
+	Region _region;
+	Voxel _borderVoxel;
+	/** The voxel that is returned for positions in bricks that are not allocated */
+	const Voxel _emptyVoxel;
+	glm::ivec3 _bricksDim;
+	std::vector<Brick*> _bricks;
+	int _allocatedBricks = 0;
+
+	glm::ivec3 _mins;
+	glm::ivec3 _maxs;
+	bool _boundsValid = false;
+};
+
+inline const Region& SparseVolume::region() const {
+	return _region;
+}
+
+inline const Voxel& SparseVolume::borderValue() const {
+	return _borderVoxel;
+}
+
+inline int32_t SparseVolume::width() const {
+	return _region.getWidthInVoxels();
+}
+
+inline int32_t SparseVolume::height() const {
+	return _region.getHeightInVoxels();
+}
+
+inline int32_t SparseVolume::depth() const {
+	return _region.getDepthInVoxels();
+}
+
+inline int SparseVolume::bricks() const {
+	return _allocatedBricks;
+}
+
+inline glm::ivec3 SparseVolume::mins() const {
+	if (!_boundsValid) {
+		return _region.getLowerCorner();
+	}
+	return _mins;
+}
+
+inline glm::ivec3 SparseVolume::maxs() const {
+	if (!_boundsValid) {
+		return _region.getUpperCorner();
+	}
+	return _maxs;
+}
+
+/**
+ * @note The position must be inside the region
+ */
+inline int32_t SparseVolume::brickIndex(const glm::ivec3& pos) const {
+	const glm::ivec3 brick = (pos - _region.getLowerCorner()) >> BrickBits;
+	return brick.x + brick.y * _bricksDim.x + brick.z * _bricksDim.x * _bricksDim.y;
+}
+
+inline const Voxel& SparseVolume::voxel(int32_t x, int32_t y, int32_t z) const {
+	const glm::ivec3 pos(x, y, z);
+	if (!_region.containsPoint(pos)) {
+		return _borderVoxel;
+	}
+	const Brick* brick = _bricks[brickIndex(pos)];
+	if (brick == nullptr) {
+		return _emptyVoxel;
+	}
+	const glm::ivec3 local = (pos - _region.getLowerCorner()) & BrickMask;
+	return brick->voxels[local.x + local.y * BrickSize + local.z * BrickSize * BrickSize];
+}
+
+inline const Voxel& SparseVolume::voxel(const glm::ivec3& pos) const {
+	return voxel(pos.x, pos.y, pos.z);
+}
+
+inline bool SparseVolume::setVoxel(int32_t x, int32_t y, int32_t z, const Voxel& voxel) {
+	return setVoxel(glm::ivec3(x, y, z), voxel);
+}
+
+inline const glm::ivec3& SparseVolume::Sampler::position() const {
+	return _posInVolume;
+}
+
+inline bool SparseVolume::Sampler::currentPositionValid() const {
+	return _valid;
+}
+
+inline bool SparseVolume::Sampler::setPosition(const glm::ivec3& pos) {
+	return setPosition(pos.x, pos.y, pos.z);
+}
+
+inline const Voxel& SparseVolume::Sampler::voxel() const {
+	if (!_valid) {
+		return _volume->voxel(_posInVolume);
+	}
+	if (_brick == nullptr) {
+		return _volume->_emptyVoxel;
+	}
+	return _brick->voxels[_index];
+}
+
+inline const Voxel& SparseVolume::Sampler::peek(int32_t dx, int32_t dy, int32_t dz) const {
+	const glm::ivec3 local = _local + glm::ivec3(dx, dy, dz);
+	if (_valid && local.x >= 0 && local.y >= 0 && local.z >= 0
+			&& local.x <= _localMaxs.x && local.y <= _localMaxs.y && local.z <= _localMaxs.z) {
+		if (_brick == nullptr) {
+			return _volume->_emptyVoxel;
+		}
+		return _brick->voxels[_index + dx + dy * BrickSize + dz * BrickSize * BrickSize];
+	}
+	return _volume->voxel(_posInVolume.x + dx, _posInVolume.y + dy, _posInVolume.z + dz);
+}
+
+inline void SparseVolume::Sampler::movePositiveX() {
+	++_posInVolume.x;
+	if (_valid && _local.x < _localMaxs.x) {
+		++_local.x;
+		++_index;
+		return;
+	}
+	setPosition(_posInVolume);
+}
+
+inline void SparseVolume::Sampler::movePositiveY() {
+	++_posInVolume.y;
+	if (_valid && _local.y < _localMaxs.y) {
+		++_local.y;
+		_index += BrickSize;
+		return;
+	}
+	setPosition(_posInVolume);
+}
+
+inline void SparseVolume::Sampler::movePositiveZ() {
+	++_posInVolume.z;
+	if (_valid && _local.z < _localMaxs.z) {
+		++_local.z;
+		_index += BrickSize * BrickSize;
+		return;
+	}
+	setPosition(_posInVolume);
+}
+
+inline void SparseVolume::Sampler::moveNegativeX() {
+	--_posInVolume.x;
+	if (_valid && _local.x > 0) {
+		--_local.x;
+		--_index;
+		return;
+	}
+	setPosition(_posInVolume);
+}
+
+inline void SparseVolume::Sampler::moveNegativeY() {
+	--_posInVolume.y;
+	if (_valid && _local.y > 0) {
+		--_local.y;
+		_index -= BrickSize;
+		return;
+	}
+	setPosition(_posInVolume);
+}
+
+inline void SparseVolume::Sampler::moveNegativeZ() {
+	--_posInVolume.z;
+	if (_valid && _local.z > 0) {
+		--_local.z;
+		_index -= BrickSize * BrickSize;
+		return;
+	}
+	setPosition(_posInVolume);
+}
+
+inline const Voxel& SparseVolume::Sampler::peekVoxel1nx1ny1nz() const {
+	return peek(-1, -1, -1);
+}
+
+inline const Voxel& SparseVolume::Sampler::peekVoxel1nx1ny0pz() const {
+	return peek(-1, -1, 0);
+}
+
+inline const Voxel& SparseVolume::Sampler::peekVoxel1nx1ny1pz() const {
+	return peek(-1, -1, 1);
+}
+
+inline const Voxel& SparseVolume::Sampler::peekVoxel1nx0py1nz() const {
+	return peek(-1, 0, -1);
+}
+
+inline const Voxel& SparseVolume::Sampler::peekVoxel1nx0py0pz() const {
+	return peek(-1, 0, 0);
+}
+
+inline const Voxel& SparseVolume::Sampler::peekVoxel1nx0py1pz() const {
+	return peek(-1, 0, 1);
+}
+
+inline const Voxel& SparseVolume::Sampler::peekVoxel1nx1py1nz() const {
+	return peek(-1, 1, -1);
+}
+
+inline const Voxel& SparseVolume::Sampler::peekVoxel1nx1py0pz() const {
+	return peek(-1, 1, 0);
+}
+
+inline const Voxel& SparseVolume::Sampler::peekVoxel1nx1py1pz() const {
+	return peek(-1, 1, 1);
+}
+
+inline const Voxel& SparseVolume::Sampler::peekVoxel0px1ny1nz() const {
+	return peek(0, -1, -1);
+}
+
+inline const Voxel& SparseVolume::Sampler::peekVoxel0px1ny0pz() const {
+	return peek(0, -1, 0);
+}
+
+inline const Voxel& SparseVolume::Sampler::peekVoxel0px1ny1pz() const {
+	return peek(0, -1, 1);
+}
+
+inline const Voxel& SparseVolume::Sampler::peekVoxel0px0py1nz() const {
+	return peek(0, 0, -1);
+}
+
+inline const Voxel& SparseVolume::Sampler::peekVoxel0px0py0pz() const {
+	return voxel();
+}
+
+inline const Voxel& SparseVolume::Sampler::peekVoxel0px0py1pz() const {
+	return peek(0, 0, 1);
+}
+
+inline const Voxel& SparseVolume::Sampler::peekVoxel0px1py1nz() const {
+	return peek(0, 1, -1);
+}
+
+inline const Voxel& SparseVolume::Sampler::peekVoxel0px1py0pz() const {
+	return peek(0, 1, 0);
+}
+
+inline const Voxel& SparseVolume::Sampler::peekVoxel0px1py1pz() const {
+	return peek(0, 1, 1);
+}
+
+inline const Voxel& SparseVolume::Sampler::peekVoxel1px1ny1nz() const {
+	return peek(1, -1, -1);
+}
+
+inline const Voxel& SparseVolume::Sampler::peekVoxel1px1ny0pz() const {
+	return peek(1, -1, 0);
+}
+
+inline const Voxel& SparseVolume::Sampler::peekVoxel1px1ny1pz() const {
+	return peek(1, -1, 1);
+}
+
+inline const Voxel& SparseVolume::Sampler::peekVoxel1px0py1nz() const {
+	return peek(1, 0, -1);
+}
+
+inline const Voxel& SparseVolume::Sampler::peekVoxel1px0py0pz() const {
+	return peek(1, 0, 0);
+}
+
+inline const Voxel& SparseVolume::Sampler::peekVoxel1px0py1pz() const {
+	return peek(1, 0, 1);
+}
+
+inline const Voxel& SparseVolume::Sampler::peekVoxel1px1py1nz() const {
+	return peek(1, 1, -1);
+}
+
+inline const Voxel& SparseVolume::Sampler::peekVoxel1px1py0pz() const {
+	return peek(1, 1, 0);
+}
+
+inline const Voxel& SparseVolume::Sampler::peekVoxel1px1py1pz() const {
+	return peek(1, 1, 1);
+}
+
+}
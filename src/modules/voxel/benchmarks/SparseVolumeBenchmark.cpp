@@ -0,0 +1,83 @@
+/**
+ * @file
+ */
+
+#include "core/benchmark/AbstractBenchmark.h"
+#include "voxel/CubicSurfaceExtractor.h"
+#include "voxel/IsQuadNeeded.h"
+#include "voxel/MaterialColor.h"
+#include "voxel/RawVolume.h"
+#include "voxel/SparseVolume.h"
+
+/**
+ * @brief A mostly empty scene like a voxedit layer: a ground plate and a few small objects in a cube
+ * of the size given by the benchmark argument.
+ */
+class SparseVolumeBenchmark: public core::AbstractBenchmark {
+protected:
+	voxel::RawVolume* _raw = nullptr;
+	voxel::SparseVolume* _sparse = nullptr;
+
+	void createScene(int size) {
+		if (_raw != nullptr && _raw->width() == size) {
+			return;
+		}
+		delete _raw;
+		delete _sparse;
+		_raw = new voxel::RawVolume(voxel::Region(0, size - 1));
+		for (int z = 0; z < size; ++z) {
+			for (int x = 0; x < size; ++x) {
+				_raw->setVoxel(x, 0, z, voxel::createVoxel(voxel::VoxelType::Grass, 1));
+			}
+		}
+		const int objectSize = 12;
+		for (int i = 0; i < 8; ++i) {
+			const glm::ivec3 mins((i * 37) % (size - objectSize), 1 + (i * 23) % (size / 2), (i * 53) % (size - objectSize));
+			for (int z = 0; z < objectSize; ++z) {
+				for (int y = 0; y < objectSize; ++y) {
+					for (int x = 0; x < objectSize; ++x) {
+						_raw->setVoxel(mins + glm::ivec3(x, y, z), voxel::createVoxel(voxel::VoxelType::Generic, i));
+					}
+				}
+			}
+		}
+		_sparse = new voxel::SparseVolume(_raw);
+	}
+
+public:
+	void onCleanupApp() override {
+		delete _raw;
+		_raw = nullptr;
+		delete _sparse;
+		_sparse = nullptr;
+	}
+
+	bool onInitApp() override {
+		voxel::initDefaultMaterialColors();
+		return true;
+	}
+};
+
+BENCHMARK_DEFINE_F(SparseVolumeBenchmark, extractRawVolume) (benchmark::State& state) {
+	createScene((int)state.range(0));
+	voxel::Mesh mesh(65536, 65536, true);
+	for (auto _ : state) {
+		voxel::extractCubicMesh(_raw, _raw->region(), &mesh, voxel::IsQuadNeeded());
+	}
+	state.counters["bytes"] = (double)_raw->calculateSizeInBytes();
+}
+
+BENCHMARK_DEFINE_F(SparseVolumeBenchmark, extractSparseVolume) (benchmark::State& state) {
+	createScene((int)state.range(0));
+	voxel::Mesh mesh(65536, 65536, true);
+	for (auto _ : state) {
+		voxel::extractCubicMesh(_sparse, _sparse->region(), &mesh, voxel::IsQuadNeeded());
+	}
+	state.counters["bytes"] = (double)_sparse->calculateSizeInBytes();
+	state.counters["bricks"] = (double)_sparse->bricks();
+}
+
+BENCHMARK_REGISTER_F(SparseVolumeBenchmark, extractRawVolume)->Arg(128)->Arg(256)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(SparseVolumeBenchmark, extractSparseVolume)->Arg(128)->Arg(256)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,200 @@
+/**
+ * @file
+ */
+
+#include "AbstractVoxelTest.h"
+#include "voxel/SparseVolume.h"
+#include "voxel/CubicSurfaceExtractor.h"
+#include "voxel/IsQuadNeeded.h"
+
+namespace voxel {
+
+class SparseVolumeTest: public AbstractVoxelTest {
+protected:
+	// not aligned to the bricks of the region and crossing the origin
+	const Region _sparseRegion { glm::ivec3(-13, -7, -21), glm::ivec3(27, 18, 12) };
+
+	/**
+	 * @brief A few scattered voxels and a small solid block that spans several bricks
+	 */
+	template<class VOLUME>
+	void fill(VOLUME& volume) {
+		volume.setVoxel(-13, -7, -21, createVoxel(VoxelType::Generic, 1));
+		volume.setVoxel(27, 18, 12, createVoxel(VoxelType::Generic, 2));
+		volume.setVoxel(0, 0, 0, createVoxel(VoxelType::Grass, 3));
+		volume.setVoxel(2, 8, -5, createVoxel(VoxelType::Rock, 4));
+		for (int z = -6; z <= 5; ++z) {
+			for (int y = 1; y <= 4; ++y) {
+				for (int x = 10; x <= 22; ++x) {
+					if ((x + y + z) % 7 == 0) {
+						continue;
+					}
+					volume.setVoxel(x, y, z, createVoxel(VoxelType::Generic, (x + z) & 0xff));
+				}
+			}
+		}
+	}
+
+	void compareMesh(const Mesh& expected, const Mesh& mesh) const {
+		ASSERT_EQ(expected.getNoOfVertices(), mesh.getNoOfVertices());
+		ASSERT_EQ(expected.getNoOfIndices(), mesh.getNoOfIndices());
+		const VoxelVertex* expectedVertices = expected.getRawVertexData();
+		const VoxelVertex* vertices = mesh.getRawVertexData();
+		for (size_t i = 0; i < mesh.getNoOfVertices(); ++i) {
+			ASSERT_EQ(expectedVertices[i].position, vertices[i].position) << "vertex " << i;
+			ASSERT_EQ(expectedVertices[i].colorIndex, vertices[i].colorIndex) << "vertex " << i;
+			ASSERT_EQ(expectedVertices[i].ambientOcclusion, vertices[i].ambientOcclusion) << "vertex " << i;
+			ASSERT_EQ(expectedVertices[i].material, vertices[i].material) << "vertex " << i;
+		}
+		const IndexType* expectedIndices = expected.getRawIndexData();
+		const IndexType* indices = mesh.getRawIndexData();
+		for (size_t i = 0; i < mesh.getNoOfIndices(); ++i) {
+			ASSERT_EQ(expectedIndices[i], indices[i]) << "index " << i;
+		}
+	}
+};
+
+TEST_F(SparseVolumeTest, testSetVoxel) {
+	SparseVolume volume(_sparseRegion);
+	EXPECT_EQ(0, volume.bricks());
+	EXPECT_FALSE(volume.setVoxel(0, 0, 0, Voxel())) << "Setting the empty voxel must not allocate a brick";
+	EXPECT_EQ(0, volume.bricks());
+	const Voxel voxel = createVoxel(VoxelType::Generic, 1);
+	EXPECT_TRUE(volume.setVoxel(0, 0, 0, voxel));
+	EXPECT_FALSE(volume.setVoxel(0, 0, 0, voxel));
+	EXPECT_EQ(1, volume.bricks());
+	EXPECT_TRUE(volume.voxel(0, 0, 0).isSame(voxel));
+	EXPECT_TRUE(volume.voxel(1, 0, 0).isSame(Voxel()));
+	EXPECT_TRUE(volume.voxel(-100, 0, 0).isSame(volume.borderValue()));
+	EXPECT_EQ(glm::ivec3(0), volume.mins());
+	EXPECT_EQ(glm::ivec3(0), volume.maxs());
+
+	EXPECT_TRUE(volume.setVoxel(20, -3, 5, voxel));
+	EXPECT_EQ(2, volume.bricks());
+	EXPECT_EQ(glm::ivec3(0, -3, 0), volume.mins());
+	EXPECT_EQ(glm::ivec3(20, 0, 5), volume.maxs());
+}
+
+TEST_F(SparseVolumeTest, testEmptyBrick) {
+	SparseVolume volume(_sparseRegion);
+	const glm::ivec3 pos(3, 4, 5);
+	EXPECT_TRUE(volume.isEmptyBrick(pos));
+	EXPECT_EQ(glm::ivec3(3, -7, -5), volume.brickLowerCorner(pos));
+	volume.setVoxel(pos, createVoxel(VoxelType::Generic, 1));
+	EXPECT_FALSE(volume.isEmptyBrick(pos));
+	EXPECT_FALSE(volume.isEmptyBrick(volume.brickLowerCorner(pos)));
+	EXPECT_TRUE(volume.isEmptyBrick(volume.brickLowerCorner(pos) - glm::ivec3(1, 0, 0)));
+
+	volume.setVoxel(pos, Voxel());
+	EXPECT_TRUE(volume.isEmptyBrick(pos));
+	EXPECT_EQ(1, volume.bricks()) << "The brick should only be released by compact()";
+	const size_t size = volume.calculateSizeInBytes();
+	EXPECT_EQ(1, volume.compact());
+	EXPECT_EQ(0, volume.bricks());
+	EXPECT_LT(volume.calculateSizeInBytes(), size);
+}
+
+TEST_F(SparseVolumeTest, testMemory) {
+	RawVolume raw(_sparseRegion);
+	fill(raw);
+	const SparseVolume volume(&raw);
+	EXPECT_LT(volume.calculateSizeInBytes(), (size_t)raw.calculateSizeInBytes());
+	EXPECT_EQ(raw.mins(), volume.mins());
+	EXPECT_EQ(raw.maxs(), volume.maxs());
+}
+
+TEST_F(SparseVolumeTest, testCopyTo) {
+	RawVolume raw(_sparseRegion);
+	fill(raw);
+	const SparseVolume volume(&raw);
+	RawVolume copy(_sparseRegion);
+	EXPECT_GT(volume.copyTo(&copy), 0);
+	EXPECT_EQ(raw, copy);
+
+	// only the overlapping part is copied
+	const Region partial(glm::ivec3(11, 2, -5), glm::ivec3(40, 40, 40));
+	RawVolume partialCopy(partial);
+	volume.copyTo(&partialCopy);
+	for (int z = partial.getLowerZ(); z <= partial.getUpperZ(); ++z) {
+		for (int y = partial.getLowerY(); y <= partial.getUpperY(); ++y) {
+			for (int x = partial.getLowerX(); x <= partial.getUpperX(); ++x) {
+				ASSERT_TRUE(volume.voxel(x, y, z).isSame(partialCopy.voxel(x, y, z))) << x << ":" << y << ":" << z;
+			}
+		}
+	}
+}
+
+TEST_F(SparseVolumeTest, testSampler) {
+	RawVolume raw(_sparseRegion);
+	fill(raw);
+	const SparseVolume volume(&raw);
+	RawVolume::Sampler rawSampler(raw);
+	SparseVolume::Sampler sampler(volume);
+	// one voxel more than the region on each side to also check the border voxels
+	const Region& region = _sparseRegion;
+	for (int z = region.getLowerZ() - 1; z <= region.getUpperZ() + 1; ++z) {
+		for (int y = region.getLowerY() - 1; y <= region.getUpperY() + 1; ++y) {
+			rawSampler.setPosition(region.getLowerX() - 1, y, z);
+			sampler.setPosition(region.getLowerX() - 1, y, z);
+			for (int x = region.getLowerX() - 1; x <= region.getUpperX() + 1; ++x) {
+				ASSERT_EQ(rawSampler.currentPositionValid(), sampler.currentPositionValid()) << x << ":" << y << ":" << z;
+				ASSERT_TRUE(rawSampler.voxel().isSame(sampler.voxel())) << x << ":" << y << ":" << z;
+				ASSERT_TRUE(rawSampler.peekVoxel1nx1ny1nz().isSame(sampler.peekVoxel1nx1ny1nz())) << x << ":" << y << ":" << z;
+				ASSERT_TRUE(rawSampler.peekVoxel1px1py1pz().isSame(sampler.peekVoxel1px1py1pz())) << x << ":" << y << ":" << z;
+				ASSERT_TRUE(rawSampler.peekVoxel1nx0py1pz().isSame(sampler.peekVoxel1nx0py1pz())) << x << ":" << y << ":" << z;
+				ASSERT_TRUE(rawSampler.peekVoxel0px1ny0pz().isSame(sampler.peekVoxel0px1ny0pz())) << x << ":" << y << ":" << z;
+				ASSERT_TRUE(rawSampler.peekVoxel1px0py1nz().isSame(sampler.peekVoxel1px0py1nz())) << x << ":" << y << ":" << z;
+				rawSampler.movePositiveX();
+				sampler.movePositiveX();
+			}
+		}
+	}
+
+	rawSampler.setPosition(20, 3, 1);
+	sampler.setPosition(20, 3, 1);
+	for (int i = 0; i < 20; ++i) {
+		rawSampler.moveNegativeX();
+		sampler.moveNegativeX();
+		rawSampler.moveNegativeZ();
+		sampler.moveNegativeZ();
+		rawSampler.movePositiveY();
+		sampler.movePositiveY();
+		ASSERT_EQ(rawSampler.position(), sampler.position());
+		ASSERT_TRUE(rawSampler.voxel().isSame(sampler.voxel())) << i;
+	}
+}
+
+TEST_F(SparseVolumeTest, testSamplerSetVoxel) {
+	SparseVolume volume(_sparseRegion);
+	SparseVolume::Sampler sampler(volume);
+	sampler.setPosition(5, 5, 5);
+	const Voxel voxel = createVoxel(VoxelType::Generic, 1);
+	EXPECT_TRUE(sampler.setVoxel(voxel));
+	EXPECT_TRUE(sampler.voxel().isSame(voxel));
+	sampler.moveNegativeX();
+	EXPECT_TRUE(sampler.peekVoxel1px0py0pz().isSame(voxel));
+	sampler.setPosition(_sparseRegion.getUpperCorner() + 1);
+	EXPECT_FALSE(sampler.setVoxel(voxel));
+}
+
+TEST_F(SparseVolumeTest, testExtractSurface) {
+	RawVolume raw(_sparseRegion);
+	fill(raw);
+	SparseVolume volume(&raw);
+	// the full region, a region that exceeds the volume and one that starts inside of a brick
+	const Region regions[] = {
+		_sparseRegion,
+		Region(_sparseRegion.getLowerCorner() - 2, _sparseRegion.getUpperCorner() + 2),
+		Region(glm::ivec3(5, 2, -3), glm::ivec3(19, 9, 4))
+	};
+	for (const Region& region : regions) {
+		Mesh expected(128, 128, true);
+		extractCubicMesh(&raw, region, &expected, IsQuadNeeded());
+		Mesh mesh(128, 128, true);
+		extractCubicMesh(&volume, region, &mesh, IsQuadNeeded());
+		ASSERT_GT(expected.getNoOfIndices(), 0u);
+		compareMesh(expected, mesh);
+	}
+}
+
+}
@@ -33,26 +33,29 @@ bool CubFormat::loadGroups(const io::FilePtr& file, VoxelVolumes& volumes) {
 
 	// TODO: support loading own palette
 
-	const MaterialColorArray& materialColors = getMaterialColors();
+	ClosestIndexCache closestIndexCache;
+	std::vector<uint8_t> rgbRow(width * 3);
+	std::vector<Voxel> row(width);
 
 	for (uint32_t h = 0u; h < height; ++h) {
 		for (uint32_t d = 0u; d < depth; ++d) {
-			for (uint32_t w = 0u; w < width; ++w) {
-				uint8_t r, g, b;
-				wrap(stream.readByte(r))
-				wrap(stream.readByte(g))
-				wrap(stream.readByte(b))
+			wrap(stream.readBuf(rgbRow.data(), rgbRow.size()))
+			const uint8_t* rgb = rgbRow.data();
+			for (uint32_t w = 0u; w < width; ++w, rgb += 3) {
+				const uint8_t r = rgb[0];
+				const uint8_t g = rgb[1];
+				const uint8_t b = rgb[2];
 				if (r == 0u && g == 0u && b == 0u) {
 					// empty voxel
+					row[w] = voxel::Voxel();
 					continue;
 				}
-				const glm::vec4& color = core::Color::fromRGBA(r, g, b, 255);
-				int index = core::Color::getClosestMatch(color, materialColors);
+				const uint8_t index = findClosestIndex(r, g, b, 255, closestIndexCache);
 				voxel::VoxelType voxelType = voxel::VoxelType::Generic;
-				const voxel::Voxel& voxel = voxel::createVoxel(voxelType, index);
-				// we have to flip depth with height for our own coordinate system
-				volume->setVoxel(w, h, d, voxel);
+				row[w] = voxel::createVoxel(voxelType, index);
 			}
+			// we have to flip depth with height for our own coordinate system
+			volume->setVoxels(glm::ivec3(0, h, d), row.data(), width);
 		}
 	}
 
@@ -50,4 +50,24 @@ bool loadVolumeFormat(const io::FilePtr& filePtr, voxel::VoxelVolumes& newVolume
 	return true;
 }
 
+bool saveVolumeFormat(const io::FilePtr& filePtr, const std::string& ext, const voxel::VoxelVolumes& volumes) {
+	if (ext == "qbt") {
+		voxel::QBTFormat f;
+		return f.saveGroups(volumes, filePtr);
+	}
+	if (ext == "qb") {
+		voxel::QBFormat f;
+		return f.saveGroups(volumes, filePtr);
+	}
+	if (ext == "cub") {
+		voxel::CubFormat f;
+		return f.saveGroups(volumes, filePtr);
+	}
+	if (ext != "vox") {
+		Log::warn("Failed to save file with unknown type: %s - saving as vox instead", ext.c_str());
+	}
+	voxel::VoxFormat f;
+	return f.saveGroups(volumes, filePtr);
+}
+
 }
@@ -10,5 +10,9 @@
 namespace voxelformat {
 
 extern bool loadVolumeFormat(const io::FilePtr& filePtr, voxel::VoxelVolumes& newVolumes);
+/**
+ * @brief Picks the format by the given extension - unknown extensions are saved as vox
+ */
+extern bool saveVolumeFormat(const io::FilePtr& filePtr, const std::string& ext, const voxel::VoxelVolumes& volumes);
 
 }
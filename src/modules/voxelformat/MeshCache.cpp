@@ -13,30 +13,28 @@
 
 namespace voxelformat {
 
-voxel::Mesh& MeshCache::cacheEntry(const char *path) {
-	auto i = _meshes.find(path);
-	if (i == _meshes.end()) {
-		voxel::Mesh* mesh = new voxel::Mesh();
-		_meshes.insert(std::make_pair(path, mesh));
-		Log::debug("New mesh cache entry for path %s", path);
-		return *mesh;
-	}
-	return *i->second;
+MeshCache::MeshCache() :
+		_meshes([] (const std::string& fullPath) {
+			std::shared_ptr<voxel::Mesh> mesh = std::make_shared<voxel::Mesh>();
+			if (!loadMesh(fullPath.c_str(), *mesh)) {
+				return std::shared_ptr<voxel::Mesh>();
+			}
+			return mesh;
+		}, [] (const voxel::Mesh& mesh) {
+			return mesh.getNoOfVertices() * sizeof(voxel::VoxelVertex) + mesh.getNoOfIndices() * sizeof(voxel::IndexType);
+		}) {
+}
+
+MeshPtr MeshCache::mesh(const char *fullPath) {
+	return _meshes.get(fullPath);
 }
 
 bool MeshCache::removeMesh(const char *fullPath) {
-	auto i = _meshes.find(fullPath);
-	if (i != _meshes.end()) {
-		delete i->second;
-		_meshes.erase(i);
-		return true;
-	}
-	return false;
+	return _meshes.remove(fullPath);
 }
 
 bool MeshCache::putMesh(const char* fullPath, const voxel::Mesh& mesh) {
-	removeMesh(fullPath);
-	_meshes.insert(std::make_pair(fullPath, new voxel::Mesh(mesh)));
+	_meshes.put(fullPath, std::make_shared<voxel::Mesh>(mesh));
 	return true;
 }
 
@@ -77,9 +75,6 @@ bool MeshCache::init() {
 }
 
 void MeshCache::shutdown() {
-	for (auto & e : _meshes) {
-		delete e.second;
-	}
 	_meshes.clear();
 }
 
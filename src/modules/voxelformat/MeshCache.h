@@ -6,22 +6,31 @@
 
 #include "voxel/Mesh.h"
 #include "core/IComponent.h"
+#include "core/AssetCache.h"
 #include "core/String.h"
 #include <memory>
-#include <unordered_map>
 
 namespace voxelformat {
 
+using MeshPtr = std::shared_ptr<const voxel::Mesh>;
+
 /**
  * @brief Cache voxel::Mesh instances by their name
+ *
+ * Concurrent requests for the same mesh only load and extract it once.
  */
 class MeshCache : public core::IComponent {
 protected:
-	std::unordered_map<std::string, voxel::Mesh*> _meshes;
+	core::AssetCache<voxel::Mesh> _meshes;
 
 public:
-	voxel::Mesh& cacheEntry(const char *path);
-	bool loadMesh(const char* fullPath, voxel::Mesh& mesh);
+	MeshCache();
+
+	/**
+	 * @return The cached mesh or @c nullptr if it could not get loaded
+	 */
+	MeshPtr mesh(const char *fullPath);
+	static bool loadMesh(const char* fullPath, voxel::Mesh& mesh);
 	bool putMesh(const char* fullPath, const voxel::Mesh& mesh);
 	bool removeMesh(const char *fullPath);
 	bool init() override;
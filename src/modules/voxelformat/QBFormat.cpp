@@ -7,6 +7,7 @@
 #include "core/Zip.h"
 #include "core/Color.h"
 #include "core/Assert.h"
+#include <algorithm>
 
 namespace voxel {
 
@@ -149,38 +150,16 @@ bool QBFormat::saveGroups(const VoxelVolumes& volumes, const io::FilePtr& file)
 	return true;
 }
 
-void QBFormat::setVoxel(voxel::RawVolume* volume, uint32_t x, uint32_t y, uint32_t z, const glm::ivec3& offset, const voxel::Voxel& voxel) {
-	const int32_t fx = offset.x + x;
-	const int32_t fy = offset.y + y;
-	const int32_t fz = offset.z + z;
-	Log::debug("Set voxel %i to %i:%i:%i (z-axis: %i)", (int)voxel.getMaterial(), fx, fy, fz, (int)_zAxisOrientation);
-	volume->setVoxel(fx, fy, fz, voxel);
-}
-
-voxel::Voxel QBFormat::getVoxel(io::FileStream& stream) {
-	uint8_t red;
-	uint8_t green;
-	uint8_t blue;
-	uint8_t alpha;
-	wrapColor(stream.readByte(red))
-	wrapColor(stream.readByte(green))
-	wrapColor(stream.readByte(blue))
-	wrapColor(stream.readByte(alpha))
-	Log::debug("Red: %i, Green: %i, Blue: %i, Alpha: %i", (int)red, (int)green, (int)blue, (int)alpha);
+voxel::Voxel QBFormat::toVoxel(uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha, ClosestIndexCache& cache) {
 	if (alpha == 0) {
 		return voxel::Voxel();
 	}
-	glm::vec4 color(0.0f);
+	uint8_t index;
 	if (_colorFormat == ColorFormat::RGBA) {
-		color.r = red / 255.0f;
-		color.b = blue / 255.0f;
+		index = findClosestIndex(red, green, blue, alpha, cache);
 	} else {
-		color.r = blue / 255.0f;
-		color.b = red / 255.0f;
+		index = findClosestIndex(blue, green, red, alpha, cache);
 	}
-	color.g = green / 255.0f;
-	color.a = alpha / 255.0f;
-	const uint8_t index = findClosestIndex(color);
 	voxel::VoxelType voxelType = voxel::VoxelType::Generic;
 	if (index == 0) {
 		voxelType = voxel::VoxelType::Air;
@@ -188,7 +167,19 @@ voxel::Voxel QBFormat::getVoxel(io::FileStream& stream) {
 	return voxel::createVoxel(voxelType, index);
 }
 
-bool QBFormat::loadMatrix(io::FileStream& stream, VoxelVolumes& volumes) {
+voxel::Voxel QBFormat::getVoxel(io::FileStream& stream, ClosestIndexCache& cache) {
+	uint8_t red;
+	uint8_t green;
+	uint8_t blue;
+	uint8_t alpha;
+	wrapColor(stream.readByte(red))
+	wrapColor(stream.readByte(green))
+	wrapColor(stream.readByte(blue))
+	wrapColor(stream.readByte(alpha))
+	return toVoxel(red, green, blue, alpha, cache);
+}
+
+bool QBFormat::loadMatrix(io::FileStream& stream, VoxelVolumes& volumes, ClosestIndexCache& cache) {
 	char name[260] = "";
 	uint8_t nameLength;
 	wrap(stream.readByte(nameLength));
@@ -224,14 +215,19 @@ bool QBFormat::loadMatrix(io::FileStream& stream, VoxelVolumes& volumes) {
 	}
 	voxel::RawVolume* v = new voxel::RawVolume(region);
 	volumes.push_back(VoxelVolume(v, name, true));
+	std::vector<voxel::Voxel> slice(size.x * size.y);
 	if (_compressed == Compression::None) {
 		Log::debug("qb matrix uncompressed");
+		std::vector<uint8_t> rgbaRow(size.x * 4);
 		for (uint32_t z = 0; z < size.z; ++z) {
 			for (uint32_t y = 0; y < size.y; ++y) {
-				for (uint32_t x = 0; x < size.x; ++x) {
-					const voxel::Voxel& voxel = getVoxel(stream);
-					setVoxel(v, x, y, z, offset, voxel);
+				wrap(stream.readBuf(rgbaRow.data(), rgbaRow.size()))
+				const uint8_t* rgba = rgbaRow.data();
+				voxel::Voxel* row = &slice[y * size.x];
+				for (uint32_t x = 0; x < size.x; ++x, rgba += 4) {
+					row[x] = toVoxel(rgba[0], rgba[1], rgba[2], rgba[3], cache);
 				}
+				v->setVoxels(glm::ivec3(offset.x, offset.y + y, offset.z + z), row, size.x);
 			}
 		}
 		return true;
@@ -239,9 +235,11 @@ bool QBFormat::loadMatrix(io::FileStream& stream, VoxelVolumes& volumes) {
 
 	Log::debug("Matrix rle compressed");
 
+	const uint32_t sliceSize = size.x * size.y;
 	uint32_t z = 0u;
 	while (z < size.z) {
-		int index = 0;
+		std::fill(slice.begin(), slice.end(), voxel::Voxel());
+		uint32_t index = 0;
 		for (;;) {
 			uint32_t data;
 			wrap(stream.peekInt(data))
@@ -257,14 +255,17 @@ bool QBFormat::loadMatrix(io::FileStream& stream, VoxelVolumes& volumes) {
 				Log::debug("%u voxels of the same type", count);
 			}
 
-			const voxel::Voxel& voxel = getVoxel(stream);
-			for (uint32_t j = 0; j < count; ++j) {
-				const int x = (index + j) % size.x;
-				const int y = (index + j) / size.x;
-				setVoxel(v, x, y, z, offset, voxel);
+			const voxel::Voxel& voxel = getVoxel(stream, cache);
+			if (count > sliceSize - core_min(index, sliceSize)) {
+				Log::error("Could not load qb file: Run of %u voxels exceeds the slice", count);
+				return false;
 			}
+			std::fill(slice.begin() + index, slice.begin() + index + count, voxel);
 			index += count;
 		}
+		for (uint32_t y = 0; y < size.y; ++y) {
+			v->setVoxels(glm::ivec3(offset.x, offset.y + y, offset.z + z), &slice[y * size.x], size.x);
+		}
 		++z;
 	}
 	Log::debug("Matrix read");
@@ -297,9 +298,10 @@ bool QBFormat::loadFromStream(io::FileStream& stream, VoxelVolumes& volumes) {
 	Log::debug("NumMatrices: %u", numMatrices);
 
 	volumes.reserve(numMatrices);
+	ClosestIndexCache closestIndexCache;
 	for (uint32_t i = 0; i < numMatrices; i++) {
 		Log::debug("Loading matrix: %u", i);
-		if (!loadMatrix(stream, volumes)) {
+		if (!loadMatrix(stream, volumes, closestIndexCache)) {
 			break;
 		}
 	}
@@ -52,9 +52,9 @@ private:
 		Back
 	};
 
-	void setVoxel(voxel::RawVolume* volume, uint32_t x, uint32_t y, uint32_t z, const glm::ivec3& offset, const voxel::Voxel& voxel);
-	voxel::Voxel getVoxel(io::FileStream& stream);
-	bool loadMatrix(io::FileStream& stream, VoxelVolumes& volumes);
+	voxel::Voxel toVoxel(uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha, ClosestIndexCache& cache);
+	voxel::Voxel getVoxel(io::FileStream& stream, ClosestIndexCache& cache);
+	bool loadMatrix(io::FileStream& stream, VoxelVolumes& volumes, ClosestIndexCache& cache);
 	bool loadFromStream(io::FileStream& stream, VoxelVolumes& volumes);
 
 	bool saveMatrix(io::FileStream& stream, const VoxelVolume& volume) const;
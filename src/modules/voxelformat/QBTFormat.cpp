@@ -8,7 +8,9 @@
 #include "core/Color.h"
 #include "core/GLM.h"
 #include "core/Assert.h"
+#include "core/Trace.h"
 #include "voxel/MaterialColor.h"
+#include <memory>
 
 namespace voxel {
 
@@ -273,63 +275,101 @@ bool QBTFormat::loadMatrix(io::FileStream& stream, VoxelVolumes& volumes) {
 		Log::warn("Size of matrix results in empty space");
 		return false;
 	}
-	uint8_t* voxelData = new uint8_t[voxelDataSize];
-	wrap(stream.readBuf(voxelData, voxelDataSize));
+	Matrix matrix;
+	matrix.volumeIdx = volumes.size();
+	matrix.position = position;
+	matrix.size = size;
+	matrix.voxelData.resize(voxelDataSize);
+	wrap(stream.readBuf(matrix.voxelData.data(), voxelDataSize));
+	_matrices.push_back(std::move(matrix));
+	// the volume is created in decodeMatrix()
+	volumes.push_back(VoxelVolume(nullptr, name, true, glm::ivec3(pivot)));
+	return true;
+}
 
+bool QBTFormat::decodeMatrix(const Matrix& matrix, VoxelVolumes& volumes) const {
+	core_trace_scoped(QBTDecodeMatrix);
+	const glm::uvec3& size = matrix.size;
+	const glm::ivec3& position = matrix.position;
+	const uint32_t voxelDataSize = (uint32_t)matrix.voxelData.size();
 	const uint32_t voxelDataSizeDecompressed = size.x * size.y * size.z * sizeof(uint32_t);
 	core_assert(voxelDataSizeDecompressed > 0);
-	uint8_t* voxelDataDecompressed = new uint8_t[voxelDataSizeDecompressed * 2];
+	std::unique_ptr<uint8_t[]> voxelDataDecompressed(new uint8_t[voxelDataSizeDecompressed * 2]);
 
-	if (!core::zip::uncompress(voxelData, voxelDataSize, voxelDataDecompressed, voxelDataSizeDecompressed * 2)) {
+	size_t realBufSize = 0;
+	if (!core::zip::uncompress(matrix.voxelData.data(), voxelDataSize, voxelDataDecompressed.get(), voxelDataSizeDecompressed * 2, &realBufSize)) {
 		Log::error("Could not load qbt file: Failed to extract zip data of size %i, volume space: %i",
 				(int)voxelDataSize, (int)voxelDataSizeDecompressed);
 		if (voxelDataSize >= 4) {
+			const uint8_t* voxelData = matrix.voxelData.data();
 			Log::debug("First 4 bytes: 0x%x 0x%x 0x%x 0x%x", voxelData[0], voxelData[1], voxelData[2], voxelData[3]);
 		}
-		delete [] voxelData;
-		delete [] voxelDataDecompressed;
+		return false;
+	}
+	if (realBufSize < voxelDataSizeDecompressed) {
+		Log::error("Could not load qbt file: Expected %i bytes of voxel data, but got %i",
+				(int)voxelDataSizeDecompressed, (int)realBufSize);
 		return false;
 	}
 	const voxel::Region region(position, position + glm::ivec3(size) - 1);
 	voxel::RawVolume* volume = new voxel::RawVolume(region);
-	uint32_t byteCounter = 0u;
-	for (uint32_t x = 0; x < size.x; x++) {
-		for (uint32_t z = 0; z < size.z; z++) {
-			for (uint32_t y = 0; y < size.y; y++) {
-				const uint32_t red   = ((uint32_t)voxelDataDecompressed[byteCounter++]) << 0;
-				const uint32_t green = ((uint32_t)voxelDataDecompressed[byteCounter++]) << 8;
-				const uint32_t blue  = ((uint32_t)voxelDataDecompressed[byteCounter++]) << 16;
-				const uint32_t alpha = ((uint32_t)255) << 24;
-				const uint8_t mask   = voxelDataDecompressed[byteCounter++];
+	ClosestIndexCache closestIndexCache;
+	std::vector<Voxel> row(size.x);
+	// the voxel data is stored with y running fastest and x running slowest - but the rows of the
+	// volume memory are along the x axis
+	const uint32_t strideX = size.y * size.z * sizeof(uint32_t);
+	for (uint32_t z = 0; z < size.z; z++) {
+		for (uint32_t y = 0; y < size.y; y++) {
+			const uint8_t* data = voxelDataDecompressed.get() + (z * size.y + y) * sizeof(uint32_t);
+			for (uint32_t x = 0; x < size.x; x++, data += strideX) {
+				const uint8_t red   = data[0];
+				const uint8_t green = data[1];
+				const uint8_t blue  = data[2];
+				const uint8_t mask  = data[3];
 				if (mask == 0u) {
+					row[x] = voxel::Voxel();
 					continue;
 				}
+				uint8_t index;
 				if (_paletteSize > 0) {
-					voxel::VoxelType voxelType = voxel::VoxelType::Generic;
-					if (red == 0) {
-						voxelType = voxel::VoxelType::Air;
-					}
-					const voxel::Voxel& voxel = voxel::createVoxel(voxelType, red);
-					volume->setVoxel(position.x + x, position.y + y, position.z + z, voxel);
+					index = red;
 				} else {
-					const glm::vec4& color = core::Color::fromRGBA(red | green | blue | alpha);
-					const uint8_t index = findClosestIndex(color);
-					voxel::VoxelType voxelType = voxel::VoxelType::Generic;
-					if (index == 0) {
-						voxelType = voxel::VoxelType::Air;
-					}
-					const voxel::Voxel& voxel = voxel::createVoxel(voxelType, index);
-					volume->setVoxel(position.x + x, position.y + y, position.z + z, voxel);
+					index = findClosestIndex(red, green, blue, 255, closestIndexCache);
+				}
+				voxel::VoxelType voxelType = voxel::VoxelType::Generic;
+				if (index == 0) {
+					voxelType = voxel::VoxelType::Air;
 				}
+				row[x] = voxel::createVoxel(voxelType, index);
 			}
+			volume->setVoxels(glm::ivec3(position.x, position.y + y, position.z + z), row.data(), size.x);
 		}
 	}
-	delete [] voxelData;
-	delete [] voxelDataDecompressed;
-	volumes.push_back(VoxelVolume(volume, name, true, glm::ivec3(pivot)));
+	volumes[matrix.volumeIdx].volume = volume;
 	return true;
 }
 
+bool QBTFormat::decodeMatrices(VoxelVolumes& volumes) {
+	std::vector<std::function<bool()>> funcs;
+	funcs.reserve(_matrices.size());
+	for (const Matrix& matrix : _matrices) {
+		funcs.emplace_back([this, &matrix, &volumes] () {
+			return decodeMatrix(matrix, volumes);
+		});
+	}
+	const bool success = decodeParallel(funcs);
+	_matrices.clear();
+	// remove the matrices that failed to decode
+	for (auto i = volumes.volumes.begin(); i != volumes.volumes.end();) {
+		if (i->volume == nullptr) {
+			i = volumes.volumes.erase(i);
+		} else {
+			++i;
+		}
+	}
+	return success;
+}
+
 /**
  * Model Node
  * TypeID 4 bytes, uint = 1
@@ -405,7 +445,7 @@ bool QBTFormat::loadColorMap(io::FileStream& stream) {
 		return false;
 	}
 	_paletteSize = 0;
-	_palette.reserve(colorCount);
+	_palette.resize(colorCount);
 	for (uint32_t i = 0; i < colorCount; ++i) {
 		uint8_t colorByteR;
 		uint8_t colorByteG;
@@ -503,10 +543,12 @@ bool QBTFormat::loadGroups(const io::FilePtr& file, VoxelVolumes& volumes) {
 		return false;
 	}
 	io::FileStream stream(file.get());
-	if (!loadFromStream(stream, volumes)) {
+	_matrices.clear();
+	const bool success = loadFromStream(stream, volumes);
+	if (!decodeMatrices(volumes)) {
 		return false;
 	}
-	return true;
+	return success;
 }
 
 #undef wrapSave
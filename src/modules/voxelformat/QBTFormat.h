@@ -18,6 +18,20 @@ namespace voxel {
  */
 class QBTFormat : public VoxFileFormat {
 private:
+	/**
+	 * @brief The compressed voxel data of a matrix node. The matrices are decompressed and converted
+	 * in parallel after the whole data tree was read from the stream.
+	 */
+	struct Matrix {
+		size_t volumeIdx;
+		glm::ivec3 position;
+		glm::uvec3 size;
+		std::vector<uint8_t> voxelData;
+	};
+	std::vector<Matrix> _matrices;
+
+	bool decodeMatrix(const Matrix& matrix, VoxelVolumes& volumes) const;
+	bool decodeMatrices(VoxelVolumes& volumes);
 	bool skipNode(io::FileStream& stream);
 	bool loadMatrix(io::FileStream& stream, VoxelVolumes& volumes);
 	bool loadCompound(io::FileStream& stream, VoxelVolumes& volumes);
@@ -11,19 +11,21 @@
 
 namespace voxelformat {
 
+const size_t VolumeCache::DefaultMemoryBudget = 64u * 1024u * 1024u;
+
+VolumeCache::VolumeCache(size_t memoryBudget) :
+		_volumes(load, [] (const voxel::RawVolume& volume) {
+			return (size_t)volume.region().voxels() * sizeof(voxel::Voxel);
+		}, &_threadPool, memoryBudget, true), _threadPool(1, "VolumeCache") {
+	_threadPool.init();
+}
+
 VolumeCache::~VolumeCache() {
+	_threadPool.shutdown(true);
 	shutdown();
 }
 
-voxel::RawVolume* VolumeCache::loadVolume(const char* fullPath) {
-	const std::string filename = fullPath;
-	{
-		std::lock_guard<std::mutex> lock(_mutex);
-		auto i = _volumes.find(filename);
-		if (i != _volumes.end()) {
-			return i->second;
-		}
-	}
+std::shared_ptr<voxel::RawVolume> VolumeCache::load(const std::string& filename) {
 	Log::info("Loading volume from %s", filename.c_str());
 	const io::FilesystemPtr& fs = io::filesystem();
 	const io::FilePtr& file = fs->open(filename);
@@ -33,32 +35,51 @@ voxel::RawVolume* VolumeCache::loadVolume(const char* fullPath) {
 		for (auto& v : volumes) {
 			delete v.volume;
 		}
-		std::lock_guard<std::mutex> lock(_mutex);
-		_volumes[filename] = nullptr;
-		return nullptr;
+		return std::shared_ptr<voxel::RawVolume>();
 	}
 	voxel::RawVolume* v = volumes.merge();
 	for (auto& v : volumes) {
 		delete v.volume;
 	}
-	std::lock_guard<std::mutex> lock(_mutex);
-	_volumes[filename] = v;
-	return v;
+	return std::shared_ptr<voxel::RawVolume>(v);
+}
+
+VolumePtr VolumeCache::loadVolume(const char* fullPath) {
+	return _volumes.get(fullPath);
+}
+
+VolumeFuture VolumeCache::loadVolumeAsync(const char* fullPath) {
+	return _volumes.getAsync(fullPath);
+}
+
+void VolumeCache::prefetch(const std::vector<std::string>& fullPaths) {
+	_volumes.prefetch(fullPaths);
+}
+
+void VolumeCache::waitForLoads() {
+	// drain the pool - the asset cache performs the loads inline while it's stopped
+	_threadPool.shutdown(true);
+	_threadPool.init();
+}
+
+void VolumeCache::setMemoryBudget(size_t bytes) {
+	_volumes.setMemoryBudget(bytes);
+}
+
+size_t VolumeCache::memoryUsage() const {
+	return _volumes.memoryUsage();
 }
 
 void VolumeCache::construct() {
 	core::Command::registerCommand("volumecachelist", [&] (const core::CmdArgs& argv) {
-		Log::info("Cache content");
-		std::lock_guard<std::mutex> lock(_mutex);
-		for (auto& e : _volumes) {
-			Log::info(" * %s", e.first.c_str());
-		}
+		const auto& stats = _volumes.stats();
+		Log::info("Cache content (%i kb, hits: %u, misses: %u, coalesced: %u, evictions: %u)",
+				(int)(_volumes.memoryUsage() / 1024u), stats.hits, stats.misses, stats.coalesced, stats.evictions);
+		_volumes.visit([] (const std::string& key, const VolumePtr& volume, size_t size) {
+			Log::info(" * %s (%i kb)", key.c_str(), (int)(size / 1024u));
+		});
 	});
 	core::Command::registerCommand("volumecacheclear", [&] (const core::CmdArgs& argv) {
-		std::lock_guard<std::mutex> lock(_mutex);
-		for (auto & e : _volumes) {
-			delete e.second;
-		}
 		_volumes.clear();
 	});
 }
@@ -68,10 +89,6 @@ bool VolumeCache::init() {
 }
 
 void VolumeCache::shutdown() {
-	std::lock_guard<std::mutex> lock(_mutex);
-	for (auto & e : _volumes) {
-		delete e.second;
-	}
 	_volumes.clear();
 }
 
@@ -5,23 +5,58 @@
 #pragma once
 
 #include "core/IComponent.h"
+#include "core/AssetCache.h"
+#include "core/ThreadPool.h"
 #include "voxel/RawVolume.h"
-#include <unordered_map>
 #include <memory>
-#include <mutex>
+#include <string>
+#include <vector>
 
 namespace voxelformat {
 
+using VolumePtr = std::shared_ptr<const voxel::RawVolume>;
+using VolumeFuture = std::shared_future<VolumePtr>;
+
+/**
+ * @brief Caches the merged volumes of model files by their path
+ *
+ * Concurrent requests for the same file only load it once. The least recently used volumes are dropped
+ * if the cached volumes exceed the memory budget.
+ */
 class VolumeCache : public core::IComponent {
+public:
+	static const size_t DefaultMemoryBudget;
 private:
-	std::unordered_map<std::string, voxel::RawVolume*> _volumes;
-	std::mutex _mutex;
+	core::AssetCache<voxel::RawVolume> _volumes;
+	// declared after the cache - the pending loads are finished before the cache is destroyed
+	core::ThreadPool _threadPool;
+
+	static std::shared_ptr<voxel::RawVolume> load(const std::string& fullPath);
 public:
+	VolumeCache(size_t memoryBudget = DefaultMemoryBudget);
 	~VolumeCache();
+
 	/**
-	 * The returned volume is now owned by the caller. The cache will delete the memory.
+	 * @return The cached volume or @c nullptr if the file could not get loaded. Blocks if the volume is loaded
+	 * by another thread.
 	 */
-	voxel::RawVolume* loadVolume(const char* fullPath);
+	VolumePtr loadVolume(const char* fullPath);
+	/**
+	 * @brief Loads the volume in the background
+	 */
+	VolumeFuture loadVolumeAsync(const char* fullPath);
+	/**
+	 * @brief Hint that the given files are going to be needed soon - they are loaded in the background
+	 */
+	void prefetch(const std::vector<std::string>& fullPaths);
+	/**
+	 * @brief Blocks until the background loads are finished
+	 * @note Requests in the meantime are loaded on the calling thread
+	 */
+	void waitForLoads();
+
+	void setMemoryBudget(size_t bytes);
+	size_t memoryUsage() const;
 
 	bool init() override;
 	void shutdown() override;
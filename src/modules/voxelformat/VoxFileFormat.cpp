@@ -7,7 +7,12 @@
 #include "core/Common.h"
 #include "core/Log.h"
 #include "core/Color.h"
+#include "core/Concurrency.h"
+#include "core/ThreadPool.h"
+#include "core/Trace.h"
+#include <future>
 #include <limits>
+#include <mutex>
 
 namespace voxel {
 
@@ -25,16 +30,59 @@ uint8_t VoxFileFormat::convertPaletteIndex(uint32_t paletteIndex) const {
 
 glm::vec4 VoxFileFormat::findClosestMatch(const glm::vec4& color) const {
 	const int index = findClosestIndex(color);
-	voxel::MaterialColorArray materialColors = voxel::getMaterialColors();
+	const voxel::MaterialColorArray& materialColors = voxel::getMaterialColors();
 	return materialColors[index];
 }
 
 uint8_t VoxFileFormat::findClosestIndex(const glm::vec4& color) const {
-	voxel::MaterialColorArray materialColors = voxel::getMaterialColors();
-	//materialColors.erase(materialColors.begin());
+	const voxel::MaterialColorArray& materialColors = voxel::getMaterialColors();
 	return core::Color::getClosestMatch(color, materialColors);
 }
 
+uint8_t VoxFileFormat::findClosestIndex(uint8_t r, uint8_t g, uint8_t b, uint8_t a, ClosestIndexCache& cache) const {
+	const uint32_t rgba = (uint32_t)r | ((uint32_t)g << 8) | ((uint32_t)b << 16) | ((uint32_t)a << 24);
+	auto i = cache.find(rgba);
+	if (i != cache.end()) {
+		return i->second;
+	}
+	const uint8_t index = findClosestIndex(core::Color::fromRGBA(r, g, b, a));
+	cache.insert(std::make_pair(rgba, index));
+	return index;
+}
+
+/**
+ * @brief The workers are shared by all formats and only started once something is decoded in parallel
+ */
+static core::ThreadPool& decodeThreadPool() {
+	static core::ThreadPool threadPool(core::cpus(), "VoxFileFormat");
+	static std::once_flag initialized;
+	std::call_once(initialized, [] () { threadPool.init(); });
+	return threadPool;
+}
+
+bool VoxFileFormat::decodeParallel(const std::vector<std::function<bool()>>& funcs) const {
+	const size_t threads = core_min((size_t)core::cpus(), funcs.size());
+	if (threads <= 1u) {
+		bool success = true;
+		for (const auto& func : funcs) {
+			success &= func();
+		}
+		return success;
+	}
+	core_trace_scoped(VoxFileFormatDecodeParallel);
+	core::ThreadPool& threadPool = decodeThreadPool();
+	std::vector<std::future<bool>> futures;
+	futures.reserve(funcs.size());
+	for (const auto& func : funcs) {
+		futures.push_back(threadPool.enqueue(func));
+	}
+	bool success = true;
+	for (std::future<bool>& future : futures) {
+		success &= future.get();
+	}
+	return success;
+}
+
 RawVolume* VoxFileFormat::merge(const VoxelVolumes& volumes) const {
 	return volumes.merge();
 }
@@ -8,6 +8,8 @@
 #include "core/io/File.h"
 #include "VoxelVolumes.h"
 #include <glm/fwd.hpp>
+#include <functional>
+#include <unordered_map>
 #include <vector>
 
 namespace voxel {
@@ -17,14 +19,28 @@ protected:
 	std::vector<uint8_t> _palette;
 	size_t _paletteSize = 0;
 
+	/**
+	 * @brief Maps rgba values to the closest palette index. A model usually only uses a few different colors,
+	 * so most of the voxels don't need the search over the whole palette. Not thread safe - use one per decode task.
+	 */
+	typedef std::unordered_map<uint32_t, uint8_t> ClosestIndexCache;
+
 	const glm::vec4& getColor(const Voxel& voxel) const;
 	glm::vec4 findClosestMatch(const glm::vec4& color) const;
 	uint8_t findClosestIndex(const glm::vec4& color) const;
+	uint8_t findClosestIndex(uint8_t r, uint8_t g, uint8_t b, uint8_t a, ClosestIndexCache& cache) const;
 	/**
 	 * @brief Maps a custum palette index to our own 256 color palette by a closest match
 	 */
 	uint8_t convertPaletteIndex(uint32_t paletteIndex) const;
 	RawVolume* merge(const VoxelVolumes& volumes) const;
+	/**
+	 * @brief Executes the given functions in parallel - e.g. one for every layer of a file that
+	 * was already read from the stream
+	 * @return @c false if one of the functions failed. All of them are executed anyway.
+	 * @note The functions must not call decodeParallel() themselves - they run on a shared pool
+	 */
+	bool decodeParallel(const std::vector<std::function<bool()>>& funcs) const;
 public:
 	virtual ~VoxFileFormat() = default;
 
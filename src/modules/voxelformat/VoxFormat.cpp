@@ -8,6 +8,7 @@
 #include "core/ArrayLength.h"
 #include "core/Assert.h"
 #include "core/Log.h"
+#include "core/Trace.h"
 #include "core/String.h"
 #include "core/UTF8.h"
 #include "voxel/MaterialColor.h"
@@ -32,6 +33,11 @@ namespace voxel {
 		return false; \
 	}
 
+struct VoxModelData {
+	// (x, y, z, colorIndex) : 1 byte for each component
+	std::vector<uint8_t> voxels;
+};
+
 struct VoxModel {
 	uint32_t nodeId;
 	uint32_t modelId;
@@ -276,6 +282,29 @@ bool VoxFormat::readAttributes(std::map<std::string, std::string>& attributes, i
 	return true;
 }
 
+RawVolume* VoxFormat::loadModel(const voxel::Region& region, const VoxModelData& modelData) const {
+	core_trace_scoped(VoxLoadModel);
+	RawVolume *volume = new RawVolume(region);
+	const uint8_t* data = modelData.voxels.data();
+	const size_t numVoxels = modelData.voxels.size() / 4;
+	for (size_t i = 0; i < numVoxels; ++i, data += 4) {
+		// we have to flip the axis here
+		const uint8_t x = data[0];
+		const uint8_t z = data[1];
+		const uint8_t y = data[2];
+		const uint8_t colorIndex = data[3];
+		if (!region.containsPoint(x, y, z)) {
+			Log::debug("Voxel %u:%u:%u is outside of the model region", x, y, z);
+			continue;
+		}
+		const uint8_t index = convertPaletteIndex(colorIndex);
+		voxel::VoxelType voxelType = voxel::VoxelType::Generic;
+		const voxel::Voxel& voxel = voxel::createVoxel(voxelType, index);
+		volume->setVoxel(x, y, z, voxel);
+	}
+	return volume;
+}
+
 bool VoxFormat::loadGroups(const io::FilePtr& file, VoxelVolumes& volumes) {
 	if (!(bool)file || !file->exists()) {
 		Log::error("Could not load vox file: File doesn't exist");
@@ -388,7 +417,7 @@ bool VoxFormat::loadGroups(const io::FilePtr& file, VoxelVolumes& volumes) {
 	};
 
 	const int paletteSize = lengthof(palette);
-	_palette.reserve(paletteSize);
+	_palette.resize(paletteSize);
 	_paletteSize = paletteSize;
 	// convert to our palette
 	const MaterialColorArray& materialColors = getMaterialColors();
@@ -462,6 +491,8 @@ bool VoxFormat::loadGroups(const io::FilePtr& file, VoxelVolumes& volumes) {
 
 	std::vector<VoxModel> models;
 	models.resize(regions.size());
+	std::vector<VoxModelData> modelDatas;
+	modelDatas.resize(regions.size());
 	volumes.resize(regions.size());
 	int volumeIdx = 0;
 	do {
@@ -490,28 +521,14 @@ bool VoxFormat::loadGroups(const io::FilePtr& file, VoxelVolumes& volumes) {
 				Log::error("Invalid XYZI chunk without previous SIZE chunk");
 				return false;
 			}
-			RawVolume *volume = new RawVolume(regions[volumeIdx]);
-			int volumeVoxelSet = 0;
-			for (uint32_t i = 0; i < numVoxels; ++i) {
-				// we have to flip the axis here
-				uint8_t x, y, z, colorIndex;
-				wrap(stream.readByte(x))
-				wrap(stream.readByte(z))
-				wrap(stream.readByte(y))
-				wrap(stream.readByte(colorIndex))
-				const uint8_t index = convertPaletteIndex(colorIndex);
-				voxel::VoxelType voxelType = voxel::VoxelType::Generic;
-				const voxel::Voxel& voxel = voxel::createVoxel(voxelType, index);
-				if (volume->setVoxel(x, y, z, voxel)) {
-					++volumeVoxelSet;
-				}
-			}
-			Log::info("Loaded layer %i with %i voxels (%i)", volumeIdx, numVoxels, volumeVoxelSet);
-			if (volumes[volumeIdx].volume != nullptr) {
-				delete volumes[volumeIdx].volume;
+			if (stream.remaining() < (int64_t)numVoxels * 4) {
+				Log::error("Could not load vox file: XYZI chunk with %u voxels exceeds the file size", numVoxels);
+				return false;
 			}
-			volumes[volumeIdx].volume = volume;
-			volumes[volumeIdx].pivot = volume->region().getCentre();
+			// the voxels are read at once and put into the volumes in parallel once all models are read
+			VoxModelData& modelData = modelDatas[volumeIdx];
+			modelData.voxels.resize((size_t)numVoxels * 4);
+			wrap(stream.readBuf(modelData.voxels.data(), modelData.voxels.size()))
 			++volumeIdx;
 		} else if (chunkId == FourCC('n','S','H','P')) {
 			// Shape Node Chunk
@@ -543,6 +560,19 @@ bool VoxFormat::loadGroups(const io::FilePtr& file, VoxelVolumes& volumes) {
 
 	stream.seek(resetPos);
 
+	std::vector<std::function<bool()>> funcs;
+	funcs.reserve(volumeIdx);
+	for (int i = 0; i < volumeIdx; ++i) {
+		funcs.emplace_back([this, i, &regions, &modelDatas, &volumes] () {
+			volumes[i].volume = loadModel(regions[i], modelDatas[i]);
+			volumes[i].pivot = regions[i].getCentre();
+			Log::info("Loaded layer %i with %i voxels", i, (int)(modelDatas[i].voxels.size() / 4));
+			return true;
+		});
+	}
+	decodeParallel(funcs);
+	modelDatas.clear();
+
 	// Scene Graph
 	//
 	// T : Transform Node
@@ -17,8 +17,11 @@ namespace voxel {
  * https://github.com/ephtracy/voxel-model.git
  * https://voxel.codeplex.com/wikipage?title=Sample%20Codes
  */
+struct VoxModelData;
+
 class VoxFormat : public VoxFileFormat {
 private:
+	RawVolume* loadModel(const voxel::Region& region, const VoxModelData& modelData) const;
 	bool readAttributes(std::map<std::string, std::string>& attributes, io::FileStream& stream) const;
 	bool saveAttributes(const std::map<std::string, std::string>& attributes, io::FileStream& stream) const;
 	bool saveChunk_LAYR(io::FileStream& stream, int layerId, const std::string& name, bool visible) const;
@@ -0,0 +1,124 @@
+/**
+ * @file
+ */
+
+#include "core/benchmark/AbstractBenchmark.h"
+#include "core/io/Filesystem.h"
+#include "voxel/MaterialColor.h"
+#include "voxel/RawVolume.h"
+#include "voxelformat/VoxelVolumes.h"
+#include "voxelformat/VoxFormat.h"
+#include "voxelformat/QBTFormat.h"
+#include "voxelformat/QBFormat.h"
+#include "voxelformat/CubFormat.h"
+#include "voxelformat/VXMFormat.h"
+#include "voxelformat/BinVoxFormat.h"
+
+/**
+ * @brief Loads big multi layer models in the different formats. The files are written once with the
+ * save functions of the formats - the formats without save support are loaded from the test files.
+ */
+class VoxelFormatBenchmark: public core::AbstractBenchmark {
+protected:
+	static constexpr int Layers = 4;
+	static constexpr int Size = 128;
+
+	voxel::VoxelVolumes _volumes;
+
+	static std::string path(const char *ext) {
+		return io::filesystem()->homePath() + "/voxelformatbenchmark." + ext;
+	}
+
+	void save(voxel::VoxFileFormat& format, const char *ext) {
+		const io::FilePtr& file = io::filesystem()->open(path(ext), io::FileMode::Write);
+		format.saveGroups(_volumes, file);
+	}
+
+	void load(benchmark::State& state, voxel::VoxFileFormat& format, const std::string& filename) {
+		const io::FilePtr& file = io::filesystem()->open(filename);
+		for (auto _ : state) {
+			voxel::VoxelVolumes volumes;
+			format.loadGroups(file, volumes);
+			benchmark::DoNotOptimize(volumes.size());
+			for (auto& v : volumes) {
+				delete v.volume;
+			}
+		}
+	}
+
+public:
+	void onCleanupApp() override {
+		for (auto& v : _volumes) {
+			delete v.volume;
+		}
+		_volumes.volumes.clear();
+	}
+
+	bool onInitApp() override {
+		voxel::initDefaultMaterialColors();
+		for (int i = 0; i < Layers; ++i) {
+			const voxel::Region region(glm::ivec3(i * Size, 0, 0), glm::ivec3(i * Size + Size - 1, Size - 1, Size - 1));
+			voxel::RawVolume* volume = new voxel::RawVolume(region);
+			const glm::ivec3& mins = region.getLowerCorner();
+			// a terrain like height map with a few different colors
+			for (int z = 0; z < Size; ++z) {
+				for (int x = 0; x < Size; ++x) {
+					const int height = Size / 4 + (x * 7 + z * 3 + i * 11) % (Size / 2);
+					for (int y = 0; y < height; ++y) {
+						const voxel::Voxel& voxel = voxel::createVoxel(voxel::VoxelType::Generic, 1 + (y / 8) % 16);
+						volume->setVoxel(mins.x + x, y, z, voxel);
+					}
+				}
+			}
+			_volumes.push_back(voxel::VoxelVolume(volume, "layer", true));
+		}
+		voxel::VoxFormat vox;
+		save(vox, "vox");
+		voxel::QBTFormat qbt;
+		save(qbt, "qbt");
+		voxel::QBFormat qb;
+		save(qb, "qb");
+		voxel::CubFormat cub;
+		save(cub, "cub");
+		return true;
+	}
+};
+
+BENCHMARK_DEFINE_F(VoxelFormatBenchmark, loadVox) (benchmark::State& state) {
+	voxel::VoxFormat format;
+	load(state, format, path("vox"));
+}
+
+BENCHMARK_DEFINE_F(VoxelFormatBenchmark, loadQBT) (benchmark::State& state) {
+	voxel::QBTFormat format;
+	load(state, format, path("qbt"));
+}
+
+BENCHMARK_DEFINE_F(VoxelFormatBenchmark, loadQB) (benchmark::State& state) {
+	voxel::QBFormat format;
+	load(state, format, path("qb"));
+}
+
+BENCHMARK_DEFINE_F(VoxelFormatBenchmark, loadCub) (benchmark::State& state) {
+	voxel::CubFormat format;
+	load(state, format, path("cub"));
+}
+
+BENCHMARK_DEFINE_F(VoxelFormatBenchmark, loadVXM) (benchmark::State& state) {
+	voxel::VXMFormat format;
+	load(state, format, "test.vxm");
+}
+
+BENCHMARK_DEFINE_F(VoxelFormatBenchmark, loadBinVox) (benchmark::State& state) {
+	voxel::BinVoxFormat format;
+	load(state, format, "test.binvox");
+}
+
+BENCHMARK_REGISTER_F(VoxelFormatBenchmark, loadVox);
+BENCHMARK_REGISTER_F(VoxelFormatBenchmark, loadQBT);
+BENCHMARK_REGISTER_F(VoxelFormatBenchmark, loadQB);
+BENCHMARK_REGISTER_F(VoxelFormatBenchmark, loadCub);
+BENCHMARK_REGISTER_F(VoxelFormatBenchmark, loadVXM);
+BENCHMARK_REGISTER_F(VoxelFormatBenchmark, loadBinVox);
+
+BENCHMARK_MAIN();
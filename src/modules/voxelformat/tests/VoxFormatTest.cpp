@@ -47,4 +47,32 @@ TEST_F(VoxFormatTest, testSave) {
 	delete savedVolume;
 }
 
+TEST_F(VoxFormatTest, testSaveMultipleLayers) {
+	VoxFormat f;
+	VoxelVolumes volumes;
+	for (int i = 0; i < 3; ++i) {
+		const Region region(glm::ivec3(0), glm::ivec3(3, 2, 1));
+		RawVolume* volume = new RawVolume(region);
+		ASSERT_TRUE(volume->setVoxel(0, 0, 0, createVoxel(VoxelType::Generic, 1)));
+		ASSERT_TRUE(volume->setVoxel(3, 2, 1, createVoxel(VoxelType::Generic, 127 + i)));
+		ASSERT_TRUE(volume->setVoxel(i, 1, 0, createVoxel(VoxelType::Generic, 200)));
+		volumes.push_back(VoxelVolume(volume, "layer", true));
+	}
+	ASSERT_TRUE(f.saveGroups(volumes, open("magicavoxel-multiplelayerssavetest.vox", io::FileMode::Write)));
+	f = VoxFormat();
+	VoxelVolumes loaded;
+	ASSERT_TRUE(f.loadGroups(open("magicavoxel-multiplelayerssavetest.vox"), loaded));
+	ASSERT_EQ(volumes.size(), loaded.size());
+	for (size_t i = 0; i < volumes.size(); ++i) {
+		ASSERT_NE(nullptr, loaded[i].volume);
+		EXPECT_EQ(*volumes[i].volume, *loaded[i].volume) << "layer " << i;
+	}
+	for (auto& v : volumes) {
+		delete v.volume;
+	}
+	for (auto& v : loaded) {
+		delete v.volume;
+	}
+}
+
 }
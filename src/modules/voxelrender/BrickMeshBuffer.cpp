@@ -0,0 +1,259 @@
+/**
+ * @file
+ */
+
+#include "BrickMeshBuffer.h"
+#include "core/Assert.h"
+#include "core/Common.h"
+#include "core/Trace.h"
+#include <algorithm>
+
+namespace voxelrender {
+
+static inline uint32_t alignSize(uint32_t size, uint32_t granularity) {
+	return (size + granularity - 1u) / granularity * granularity;
+}
+
+static inline int floorDiv(int value, int divisor) {
+	return value >= 0 ? value / divisor : (value - divisor + 1) / divisor;
+}
+
+template<class T>
+BrickMeshBuffer::Range BrickMeshBuffer::allocate(std::vector<T>& data, FreeBlocks& freeBlocks, uint32_t size, uint32_t granularity) {
+	// leave some space to let the mesh grow a little bit without moving it
+	const uint32_t capacity = alignSize(size + size / 4u, granularity);
+	Range range;
+	range.size = size;
+	range.capacity = capacity;
+	for (auto i = freeBlocks.begin(); i != freeBlocks.end(); ++i) {
+		if (i->capacity < capacity) {
+			continue;
+		}
+		range.offset = i->offset;
+		i->offset += capacity;
+		i->capacity -= capacity;
+		if (i->capacity == 0u) {
+			freeBlocks.erase(i);
+		}
+		return range;
+	}
+
+	// no free block is big enough - grow the buffer by at least the half of its size
+	// to not resize the gpu buffers for every new brick
+	const uint32_t oldSize = (uint32_t)data.size();
+	uint32_t start = oldSize;
+	if (!freeBlocks.empty() && freeBlocks.back().offset + freeBlocks.back().capacity == oldSize) {
+		start = freeBlocks.back().offset;
+		freeBlocks.pop_back();
+	}
+	const uint32_t newSize = alignSize(core_max(start + capacity, oldSize + oldSize / 2u), granularity);
+	data.resize(newSize);
+	_resized = true;
+	range.offset = start;
+	if (newSize > start + capacity) {
+		release(freeBlocks, start + capacity, newSize - start - capacity);
+	}
+	return range;
+}
+
+void BrickMeshBuffer::release(FreeBlocks& freeBlocks, uint32_t offset, uint32_t capacity) {
+	if (capacity == 0u) {
+		return;
+	}
+	// the blocks are sorted by their offset - merge with the neighbours
+	auto i = std::lower_bound(freeBlocks.begin(), freeBlocks.end(), offset, [] (const Block& block, uint32_t value) {
+		return block.offset < value;
+	});
+	i = freeBlocks.insert(i, Block{offset, capacity});
+	auto next = i + 1;
+	if (next != freeBlocks.end() && i->offset + i->capacity == next->offset) {
+		i->capacity += next->capacity;
+		freeBlocks.erase(next);
+	}
+	if (i != freeBlocks.begin()) {
+		auto prev = i - 1;
+		if (prev->offset + prev->capacity == i->offset) {
+			prev->capacity += i->capacity;
+			freeBlocks.erase(i);
+		}
+	}
+}
+
+void BrickMeshBuffer::addDirty(DirtyRanges& ranges, uint32_t begin, uint32_t end) {
+	if (begin >= end) {
+		return;
+	}
+	ranges.push_back(DirtyRange{begin, end});
+}
+
+BrickMeshBuffer::DirtyRanges BrickMeshBuffer::merge(const DirtyRanges& ranges) {
+	DirtyRanges sorted = ranges;
+	std::sort(sorted.begin(), sorted.end(), [] (const DirtyRange& a, const DirtyRange& b) {
+		return a.begin < b.begin;
+	});
+	DirtyRanges merged;
+	merged.reserve(sorted.size());
+	for (const DirtyRange& range : sorted) {
+		if (!merged.empty() && range.begin <= merged.back().end) {
+			merged.back().end = core_max(merged.back().end, range.end);
+			continue;
+		}
+		merged.push_back(range);
+	}
+	return merged;
+}
+
+void BrickMeshBuffer::releaseBrick(Brick& brick) {
+	// the released index range must not render anything anymore
+	const uint32_t indexOffset = brick.indices.offset;
+	std::fill_n(_indices.begin() + indexOffset, brick.indices.size, (voxel::IndexType)0);
+	addDirty(_dirtyIndices, indexOffset, indexOffset + brick.indices.size);
+	release(_freeVertices, brick.vertices.offset, brick.vertices.capacity);
+	release(_freeIndices, brick.indices.offset, brick.indices.capacity);
+	_reservedVertices -= brick.vertices.capacity;
+	_reservedIndices -= brick.indices.capacity;
+	brick = Brick();
+}
+
+void BrickMeshBuffer::update(const glm::ivec3& pos, const voxel::Mesh& mesh) {
+	core_trace_scoped(BrickMeshBufferUpdate);
+	const uint32_t vertexCount = (uint32_t)mesh.getNoOfVertices();
+	const uint32_t indexCount = (uint32_t)mesh.getNoOfIndices();
+	if (indexCount == 0u) {
+		remove(pos);
+		return;
+	}
+	core_assert(indexCount % 3u == 0u);
+	Brick& brick = _bricks[pos];
+	uint32_t oldIndexCount = brick.indices.size;
+	if (vertexCount > brick.vertices.capacity || indexCount > brick.indices.capacity) {
+		releaseBrick(brick);
+		brick.vertices = allocate(_vertices, _freeVertices, vertexCount, VertexGranularity);
+		brick.indices = allocate(_indices, _freeIndices, indexCount, IndexGranularity);
+		_reservedVertices += brick.vertices.capacity;
+		_reservedIndices += brick.indices.capacity;
+		oldIndexCount = 0u;
+	} else {
+		brick.vertices.size = vertexCount;
+		brick.indices.size = indexCount;
+	}
+
+	const uint32_t vertexOffset = brick.vertices.offset;
+	const std::vector<voxel::VoxelVertex>& vertices = mesh.getVertexVector();
+	std::copy(vertices.begin(), vertices.end(), _vertices.begin() + vertexOffset);
+	addDirty(_dirtyVertices, vertexOffset, vertexOffset + vertexCount);
+
+	const uint32_t indexOffset = brick.indices.offset;
+	const std::vector<voxel::IndexType>& indices = mesh.getIndexVector();
+	voxel::IndexType* target = &_indices[indexOffset];
+	for (uint32_t i = 0u; i < indexCount; ++i) {
+		target[i] = indices[i] + vertexOffset;
+	}
+	// the previous mesh of this brick used more indices - turn them into degenerated triangles
+	for (uint32_t i = indexCount; i < oldIndexCount; ++i) {
+		target[i] = (voxel::IndexType)0;
+	}
+	addDirty(_dirtyIndices, indexOffset, indexOffset + core_max(indexCount, oldIndexCount));
+	compactIfNeeded();
+}
+
+bool BrickMeshBuffer::remove(const glm::ivec3& pos) {
+	auto i = _bricks.find(pos);
+	if (i == _bricks.end()) {
+		return false;
+	}
+	releaseBrick(i->second);
+	_bricks.erase(i);
+	compactIfNeeded();
+	return true;
+}
+
+void BrickMeshBuffer::compactIfNeeded() {
+	// the buffers only grow by adding bricks - give the memory back if most of it is not used anymore
+	const bool vertices = _vertices.size() > 4u * VertexGranularity && _reservedVertices * 2u < _vertices.size();
+	const bool indices = _indices.size() > 4u * IndexGranularity && _reservedIndices * 2u < _indices.size();
+	if (vertices || indices || (_bricks.empty() && !_indices.empty())) {
+		compact();
+	}
+}
+
+void BrickMeshBuffer::compact() {
+	core_trace_scoped(BrickMeshBufferCompact);
+	std::vector<voxel::VoxelVertex> vertices(_reservedVertices);
+	std::vector<voxel::IndexType> indices(_reservedIndices);
+	uint32_t vertexOffset = 0u;
+	uint32_t indexOffset = 0u;
+	for (auto& i : _bricks) {
+		Brick& brick = i.second;
+		std::copy_n(_vertices.begin() + brick.vertices.offset, brick.vertices.size, vertices.begin() + vertexOffset);
+		const voxel::IndexType* source = &_indices[brick.indices.offset];
+		for (uint32_t n = 0u; n < brick.indices.size; ++n) {
+			indices[indexOffset + n] = source[n] - brick.vertices.offset + vertexOffset;
+		}
+		brick.vertices.offset = vertexOffset;
+		brick.indices.offset = indexOffset;
+		vertexOffset += brick.vertices.capacity;
+		indexOffset += brick.indices.capacity;
+	}
+	_vertices.swap(vertices);
+	_indices.swap(indices);
+	_freeVertices.clear();
+	_freeIndices.clear();
+	_dirtyVertices.clear();
+	_dirtyIndices.clear();
+	_resized = true;
+}
+
+void BrickMeshBuffer::clear() {
+	_bricks.clear();
+	_vertices.clear();
+	_indices.clear();
+	_freeVertices.clear();
+	_freeIndices.clear();
+	_dirtyVertices.clear();
+	_dirtyIndices.clear();
+	_reservedVertices = 0u;
+	_reservedIndices = 0u;
+	_resized = true;
+}
+
+bool BrickMeshBuffer::ranges(const glm::ivec3& pos, Range& vertices, Range& indices) const {
+	auto i = _bricks.find(pos);
+	if (i == _bricks.end()) {
+		return false;
+	}
+	vertices = i->second.vertices;
+	indices = i->second.indices;
+	return true;
+}
+
+void BrickMeshBuffer::invalidate() {
+	_resized = true;
+}
+
+void BrickMeshBuffer::markClean() {
+	_dirtyVertices.clear();
+	_dirtyIndices.clear();
+	_resized = false;
+}
+
+std::vector<glm::ivec3> BrickMeshBuffer::dirtyBricks(const voxel::Region& region, int brickSize) {
+	core_assert(brickSize > 0);
+	// the meshes of the bricks depend on the voxels [mins - 1, maxs + 2]
+	const glm::ivec3 lower = region.getLowerCorner() - 2;
+	const glm::ivec3 upper = region.getUpperCorner() + 1;
+	const glm::ivec3 mins(floorDiv(lower.x, brickSize), floorDiv(lower.y, brickSize), floorDiv(lower.z, brickSize));
+	const glm::ivec3 maxs(floorDiv(upper.x, brickSize), floorDiv(upper.y, brickSize), floorDiv(upper.z, brickSize));
+	std::vector<glm::ivec3> bricks;
+	bricks.reserve((maxs.x - mins.x + 1) * (maxs.y - mins.y + 1) * (maxs.z - mins.z + 1));
+	for (int z = mins.z; z <= maxs.z; ++z) {
+		for (int y = mins.y; y <= maxs.y; ++y) {
+			for (int x = mins.x; x <= maxs.x; ++x) {
+				bricks.emplace_back(x * brickSize, y * brickSize, z * brickSize);
+			}
+		}
+	}
+	return bricks;
+}
+
+}
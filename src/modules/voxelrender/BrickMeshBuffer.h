@@ -0,0 +1,168 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "voxel/Mesh.h"
+#include "voxel/Region.h"
+#include "core/GLM.h"
+#include <unordered_map>
+#include <vector>
+
+namespace voxelrender {
+
+/**
+ * @brief The cpu side of the vertex and index buffer of one volume
+ *
+ * The volume is split into bricks that have their own mesh. Each brick gets a range in the vertex and in the
+ * index buffer. If the new mesh of a brick fits into its range, the range is patched in place - otherwise the
+ * brick gets a new range and the old one is reused by other bricks. The parts that were modified since the
+ * last upload are tracked, so that only those have to be uploaded to the gpu.
+ *
+ * @note The indices are absolute. The unused parts of the index ranges are filled with degenerated
+ * triangles - that's why the whole index buffer can be rendered with one draw call.
+ */
+class BrickMeshBuffer {
+public:
+	static constexpr uint32_t VertexGranularity = 64u;
+	/** a multiple of 3 to keep the triangles of all ranges aligned */
+	static constexpr uint32_t IndexGranularity = 3u * 64u;
+
+	struct Range {
+		uint32_t offset = 0u;
+		/** the amount of used elements */
+		uint32_t size = 0u;
+		/** the amount of reserved elements */
+		uint32_t capacity = 0u;
+	};
+
+	/**
+	 * @brief Modified elements [begin, end)
+	 */
+	struct DirtyRange {
+		uint32_t begin;
+		uint32_t end;
+	};
+	typedef std::vector<DirtyRange> DirtyRanges;
+
+private:
+	struct Brick {
+		Range vertices;
+		Range indices;
+	};
+	struct Block {
+		uint32_t offset;
+		uint32_t capacity;
+	};
+	typedef std::vector<Block> FreeBlocks;
+
+	std::unordered_map<glm::ivec3, Brick> _bricks;
+	std::vector<voxel::VoxelVertex> _vertices;
+	std::vector<voxel::IndexType> _indices;
+	FreeBlocks _freeVertices;
+	FreeBlocks _freeIndices;
+	DirtyRanges _dirtyVertices;
+	DirtyRanges _dirtyIndices;
+	/** the sum of the reserved elements of all bricks */
+	uint32_t _reservedVertices = 0u;
+	uint32_t _reservedIndices = 0u;
+	bool _resized = false;
+
+	template<class T>
+	Range allocate(std::vector<T>& data, FreeBlocks& freeBlocks, uint32_t size, uint32_t granularity);
+	static void release(FreeBlocks& freeBlocks, uint32_t offset, uint32_t capacity);
+	static void addDirty(DirtyRanges& ranges, uint32_t begin, uint32_t end);
+	static DirtyRanges merge(const DirtyRanges& ranges);
+	void releaseBrick(Brick& brick);
+	void compactIfNeeded();
+	void compact();
+
+public:
+	/**
+	 * @brief Replaces the mesh of the given brick. An empty mesh removes the brick.
+	 * @param[in] brick The lower corner of the brick
+	 */
+	void update(const glm::ivec3& brick, const voxel::Mesh& mesh);
+	/**
+	 * @return @c false if the brick didn't have a mesh
+	 */
+	bool remove(const glm::ivec3& brick);
+	void clear();
+
+	/**
+	 * @return @c true if there is no brick with a mesh
+	 */
+	bool empty() const;
+	int bricks() const;
+	/**
+	 * @return @c false if the brick doesn't have a mesh
+	 */
+	bool ranges(const glm::ivec3& brick, Range& vertices, Range& indices) const;
+
+	const std::vector<voxel::VoxelVertex>& vertices() const;
+	const std::vector<voxel::IndexType>& indices() const;
+
+	/**
+	 * @return @c true if the size of the buffers changed - the whole buffers must be uploaded then
+	 */
+	bool resized() const;
+	/**
+	 * @brief Forces the upload of the whole buffers
+	 */
+	void invalidate();
+	/**
+	 * @return The merged modified vertex ranges since the last markClean() call
+	 */
+	DirtyRanges dirtyVertices() const;
+	/**
+	 * @return The merged modified index ranges since the last markClean() call
+	 */
+	DirtyRanges dirtyIndices() const;
+	/**
+	 * @brief Call this after the modified ranges were uploaded
+	 */
+	void markClean();
+
+	/**
+	 * @brief The lower corners of the bricks whose meshes depend on the voxels in the given region
+	 *
+	 * A brick mesh is extracted for the voxels of the brick plus one voxel in positive direction and
+	 * the extractor looks at the direct neighbours of these voxels. That's why this includes the
+	 * neighbours of the bricks that intersect the region - if the region is close enough to them.
+	 *
+	 * @param[in] region The modified region
+	 * @param[in] brickSize The bricks are aligned to multiples of this size
+	 */
+	static std::vector<glm::ivec3> dirtyBricks(const voxel::Region& region, int brickSize);
+};
+
+inline bool BrickMeshBuffer::empty() const {
+	return _bricks.empty();
+}
+
+inline int BrickMeshBuffer::bricks() const {
+	return (int)_bricks.size();
+}
+
+inline const std::vector<voxel::VoxelVertex>& BrickMeshBuffer::vertices() const {
+	return _vertices;
+}
+
+inline const std::vector<voxel::IndexType>& BrickMeshBuffer::indices() const {
+	return _indices;
+}
+
+inline bool BrickMeshBuffer::resized() const {
+	return _resized;
+}
+
+inline BrickMeshBuffer::DirtyRanges BrickMeshBuffer::dirtyVertices() const {
+	return merge(_dirtyVertices);
+}
+
+inline BrickMeshBuffer::DirtyRanges BrickMeshBuffer::dirtyIndices() const {
+	return merge(_dirtyIndices);
+}
+
+}
@@ -19,7 +19,8 @@
 #include "core/GLM.h"
 #include "core/Var.h"
 #include "core/GameConfig.h"
-#include <unordered_set>
+#include "core/Concurrency.h"
+#include <future>
 
 namespace voxelrender {
 
@@ -70,6 +71,9 @@ bool RawVolumeRenderer::init() {
 			Log::error("Could not create the vertex buffer object for the indices");
 			return false;
 		}
+		// the bricks are patched in place
+		_vertexBuffer[idx].setMode(_vertexBufferIndex[idx], video::BufferMode::Dynamic);
+		_vertexBuffer[idx].setMode(_indexBufferIndex[idx], video::BufferMode::Dynamic);
 	}
 
 	const int shaderMaterialColorsArraySize = lengthof(shader::VoxelData::MaterialblockData::materialcolor);
@@ -104,6 +108,9 @@ bool RawVolumeRenderer::init() {
 
 	_meshSize = core::Var::getSafe(cfg::VoxelMeshSize);
 
+	_threadPool = std::make_unique<core::ThreadPool>(core::halfcpus(), "RawVolumeRenderer");
+	_threadPool->init();
+
 	return true;
 }
 
@@ -112,28 +119,34 @@ bool RawVolumeRenderer::update(int idx) {
 		return false;
 	}
 	core_trace_scoped(RawVolumeRendererUpdate);
-	std::vector<voxel::VoxelVertex> vertices;
-	std::vector<voxel::IndexType> indices;
-
-	voxel::IndexType offset = (voxel::IndexType)0;
-	for (auto& i : _meshes) {
-		const Meshes& meshes = i.second;
-		const voxel::Mesh* mesh = meshes[idx];
-		if (mesh == nullptr || mesh->getNoOfIndices() <= 0) {
-			continue;
+	BrickMeshBuffer& meshBuffer = _meshBuffer[idx];
+	if (meshBuffer.resized()) {
+		if (!update(idx, meshBuffer.vertices(), meshBuffer.indices())) {
+			return false;
 		}
-		const std::vector<voxel::VoxelVertex>& vertexVector = mesh->getVertexVector();
-		const std::vector<voxel::IndexType>& indexVector = mesh->getIndexVector();
-		std::copy(vertexVector.begin(), vertexVector.end(), std::back_inserter(vertices));
+		meshBuffer.markClean();
+		return true;
+	}
 
-		for (const auto& iv : indexVector) {
-			indices.push_back(iv + offset);
+	video::Buffer& buffer = _vertexBuffer[idx];
+	const std::vector<voxel::VoxelVertex>& vertices = meshBuffer.vertices();
+	for (const BrickMeshBuffer::DirtyRange& range : meshBuffer.dirtyVertices()) {
+		const size_t size = (range.end - range.begin) * sizeof(voxel::VoxelVertex);
+		if (!buffer.update(_vertexBufferIndex[idx], range.begin * sizeof(voxel::VoxelVertex), &vertices[range.begin], size)) {
+			Log::error("Failed to update the vertex buffer");
+			return false;
 		}
-
-		offset += vertexVector.size();
 	}
-
-	return update(idx, vertices, indices);
+	const std::vector<voxel::IndexType>& indices = meshBuffer.indices();
+	for (const BrickMeshBuffer::DirtyRange& range : meshBuffer.dirtyIndices()) {
+		const size_t size = (range.end - range.begin) * sizeof(voxel::IndexType);
+		if (!buffer.update(_indexBufferIndex[idx], range.begin * sizeof(voxel::IndexType), &indices[range.begin], size)) {
+			Log::error("Failed to update the index buffer");
+			return false;
+		}
+	}
+	meshBuffer.markClean();
+	return true;
 }
 
 bool RawVolumeRenderer::update(int idx, const std::vector<voxel::VoxelVertex>& vertices, const std::vector<voxel::IndexType>& indices) {
@@ -181,10 +194,10 @@ bool RawVolumeRenderer::swap(int idx1, int idx2) {
 	if (idx1 == idx2) {
 		return true;
 	}
-	for (auto& i : _meshes) {
-		Meshes& meshes = i.second;
-		std::swap(meshes[idx1], meshes[idx2]);
-	}
+	std::swap(_meshBuffer[idx1], _meshBuffer[idx2]);
+	// the gpu buffers are not swapped
+	_meshBuffer[idx1].invalidate();
+	_meshBuffer[idx2].invalidate();
 	std::swap(_hidden[idx1], _hidden[idx2]);
 	std::swap(_model[idx1], _model[idx2]);
 	std::swap(_rawVolume[idx1], _rawVolume[idx2]);
@@ -198,13 +211,7 @@ bool RawVolumeRenderer::empty(int idx) const {
 	if (idx < 0 || idx >= MAX_VOLUMES) {
 		return true;
 	}
-	for (auto& i : _meshes) {
-		const Meshes& meshes = i.second;
-		if (meshes[idx] != nullptr && meshes[idx]->getNoOfIndices() > 0) {
-			return false;
-		}
-	}
-	return true;
+	return _meshBuffer[idx].empty();
 }
 
 bool RawVolumeRenderer::toMesh(voxel::Mesh* mesh) {
@@ -251,14 +258,7 @@ bool RawVolumeRenderer::translate(int idx, const glm::ivec3& m) {
 		return false;
 	}
 	volume->translate(m);
-	for (auto& i : _meshes) {
-		Meshes& meshes = i.second;
-		if (meshes[idx] == nullptr) {
-			continue;
-		}
-		delete meshes[idx];
-		meshes[idx] = nullptr;
-	}
+	_meshBuffer[idx].clear();
 	return true;
 }
 
@@ -271,60 +271,43 @@ bool RawVolumeRenderer::extract(int idx, const voxel::Region& region, bool updat
 		return false;
 	}
 
-	const int s = _meshSize->intVal();
-	glm::ivec3 meshSize(s, s, s);
-	const glm::vec3& size = meshSize;
-
-	const glm::ivec3& lower = region.getLowerCorner();
-	const glm::ivec3& upper = region.getUpperCorner();
-
-	const int border = 1;
+	core_trace_scoped(RawVolumeRendererExtract);
+	const int brickSize = _meshSize->intVal();
 	const voxel::Region& completeRegion = volume->region();
-	const int xGap = lower.x % meshSize.x;
-	const int yGap = lower.y % meshSize.y;
-	const int zGap = lower.z % meshSize.z;
-	const int lowerX = lower.x - ((xGap == 0) ? border : 0);
-	const int lowerY = lower.y - ((yGap == 0) ? border : 0);
-	const int lowerZ = lower.z - ((zGap == 0) ? border : 0);
-
-	const int upperX = upper.x + ((xGap == meshSize.x - 1) ? border : 0);
-	const int upperY = upper.y + ((yGap == meshSize.y - 1) ? border : 0);
-	const int upperZ = upper.z + ((zGap == meshSize.z - 1) ? border : 0);
-
-	std::unordered_set<glm::ivec3, std::hash<glm::ivec3> > extracted;
-
-	for (int cx = lowerX; cx <= upperX; ++cx) {
-		const int x = glm::floor(cx / size.x);
-		for (int cy = lowerY; cy <= upperY; ++cy) {
-			const int y = glm::floor(cy / size.y);
-			for (int cz = lowerZ; cz <= upperZ; ++cz) {
-				const int z = glm::floor(cz / size.z);
-				const glm::ivec3 mins(x * meshSize.x, y * meshSize.y, z * meshSize.z);
-				const glm::ivec3 maxs = mins + meshSize - 1;
-				const voxel::Region region(mins, maxs);
-				if (!voxel::intersects(completeRegion, region)) {
-					auto i = _meshes.find(mins);
-					if (i != _meshes.end()) {
-						Meshes& meshes = i->second;
-						delete meshes[idx];
-						meshes[idx] = nullptr;
-					}
-					continue;
-				}
+	BrickMeshBuffer& meshBuffer = _meshBuffer[idx];
 
-				auto i = extracted.insert(mins);
-				if (!i.second) {
-					continue;
-				}
+	std::vector<glm::ivec3> bricks;
+	for (const glm::ivec3& mins : BrickMeshBuffer::dirtyBricks(region, brickSize)) {
+		const voxel::Region brickRegion(mins, mins + brickSize - 1);
+		if (!voxel::intersects(completeRegion, brickRegion)) {
+			meshBuffer.remove(mins);
+			continue;
+		}
+		bricks.push_back(mins);
+	}
 
-				Meshes& meshes = _meshes[mins];
-				if (meshes[idx] == nullptr) {
-					meshes[idx] = new voxel::Mesh(128, 128, true);
-				}
-				extract(volume, region, meshes[idx]);
-			}
+	std::vector<voxel::Mesh> meshes(bricks.size());
+	if (bricks.size() == 1u || !_threadPool) {
+		for (size_t i = 0u; i < bricks.size(); ++i) {
+			extract(volume, voxel::Region(bricks[i], bricks[i] + brickSize - 1), &meshes[i]);
+		}
+	} else {
+		std::vector<std::future<void>> futures;
+		futures.reserve(bricks.size());
+		for (size_t i = 0u; i < bricks.size(); ++i) {
+			futures.push_back(_threadPool->enqueue([this, volume, brickSize, &bricks, &meshes, i] () {
+				extract(volume, voxel::Region(bricks[i], bricks[i] + brickSize - 1), &meshes[i]);
+			}));
+		}
+		for (std::future<void>& future : futures) {
+			future.wait();
 		}
 	}
+
+	// patching the buffers is done in brick order to get the same layout regardless of the threads
+	for (size_t i = 0u; i < bricks.size(); ++i) {
+		meshBuffer.update(bricks[i], meshes[i]);
+	}
 	if (updateBuffers && !update(idx)) {
 		Log::error("Failed to update the mesh at index %i", idx);
 	}
@@ -483,11 +466,7 @@ voxel::RawVolume* RawVolumeRenderer::setVolume(int idx, voxel::RawVolume* volume
 	voxel::RawVolume* old = _rawVolume[idx];
 	_rawVolume[idx] = volume;
 	if (deleteMesh) {
-		for (auto& i : _meshes) {
-			Meshes& meshes = i.second;
-			delete meshes[idx];
-			meshes[idx] = nullptr;
-		}
+		_meshBuffer[idx].clear();
 	}
 	return old;
 }
@@ -499,12 +478,13 @@ void RawVolumeRenderer::setSunPosition(const glm::vec3& eye, const glm::vec3& ce
 std::vector<voxel::RawVolume*> RawVolumeRenderer::shutdown() {
 	_voxelShader.shutdown();
 	_materialBlock.shutdown();
-	for (auto& iter : _meshes) {
-		for (auto& mesh : iter.second) {
-			delete mesh;
-		}
+	for (int idx = 0; idx < MAX_VOLUMES; ++idx) {
+		_meshBuffer[idx].clear();
+	}
+	if (_threadPool) {
+		_threadPool->shutdown(true);
+		_threadPool.reset();
 	}
-	_meshes.clear();
 	std::vector<voxel::RawVolume*> old(MAX_VOLUMES);
 	for (int idx = 0; idx < MAX_VOLUMES; ++idx) {
 		_vertexBuffer[idx].shutdown();
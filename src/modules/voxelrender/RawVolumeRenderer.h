@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "BrickMeshBuffer.h"
 #include "voxel/RawVolume.h"
 #include "voxel/Region.h"
 #include "video/Buffer.h"
@@ -15,6 +16,8 @@
 #include "core/GLM.h"
 #include "core/Var.h"
 #include "core/collection/Array.h"
+#include "core/ThreadPool.h"
+#include <memory>
 
 namespace video {
 class Camera;
@@ -25,7 +28,12 @@ namespace voxelrender {
 /**
  * @brief Handles the shaders, vertex buffers and rendering of a voxel::RawVolume
  *
+ * The volumes are split into bricks of @c cfg::VoxelMeshSize voxels. The meshes of the bricks are stored in
+ * one persistent vertex and index buffer per volume - modifying a region only re-extracts the affected bricks
+ * and uploads the changed parts of the buffers.
+ *
  * @sa voxel::RawVolume
+ * @sa BrickMeshBuffer
  */
 class RawVolumeRenderer {
 public:
@@ -34,9 +42,9 @@ protected:
 	voxel::RawVolume* _rawVolume[MAX_VOLUMES] {};
 	glm::mat4 _model[MAX_VOLUMES] {};
 	core::Array<bool, MAX_VOLUMES> _hidden {{ false }};
-	typedef core::Array<voxel::Mesh*, MAX_VOLUMES> Meshes;
-	typedef std::unordered_map<glm::ivec3, Meshes> MeshesMap;
-	MeshesMap _meshes;
+	BrickMeshBuffer _meshBuffer[MAX_VOLUMES];
+	/** extracts the bricks of a modified region in parallel */
+	std::unique_ptr<core::ThreadPool> _threadPool;
 
 	video::Buffer _vertexBuffer[MAX_VOLUMES];
 	shader::VoxelData _materialBlock;
@@ -64,13 +72,18 @@ public:
 	const render::Shadow& shadow() const;
 
 	/**
-	 * @brief Updates the vertex buffers manually
+	 * @brief Uploads the modified parts of the vertex buffers manually
 	 * @sa extract()
 	 */
 	bool update(int idx);
 
 	bool update(int idx, const std::vector<voxel::VoxelVertex>& vertices, const std::vector<voxel::IndexType>& indices);
 
+	/**
+	 * @brief Re-extracts the meshes of the bricks that are affected by a modification in the given region
+	 * @param[in] updateBuffers Upload the changes to the gpu - if this is @c false, the changes are collected
+	 * until the next update() call
+	 */
 	bool extract(int idx, const voxel::Region& region, bool updateBuffers = true);
 
 	bool translate(int idx, const glm::ivec3& m);
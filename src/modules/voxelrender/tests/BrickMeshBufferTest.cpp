@@ -0,0 +1,213 @@
+/**
+ * @file
+ */
+
+#include "core/tests/AbstractTest.h"
+#include "voxelrender/BrickMeshBuffer.h"
+#include <map>
+
+namespace voxelrender {
+
+class BrickMeshBufferTest: public core::AbstractTest {
+protected:
+	/**
+	 * @brief Creates a mesh with the given amount of quads. The vertices are tagged with the given id.
+	 */
+	voxel::Mesh createMesh(int quads, int id) const {
+		voxel::Mesh mesh(128, 128, true);
+		for (int i = 0; i < quads; ++i) {
+			voxel::VoxelVertex vertex {};
+			vertex.position = glm::ivec3(id, i, 0);
+			const voxel::IndexType i0 = mesh.addVertex(vertex);
+			vertex.position.z = 1;
+			const voxel::IndexType i1 = mesh.addVertex(vertex);
+			vertex.position.z = 2;
+			const voxel::IndexType i2 = mesh.addVertex(vertex);
+			vertex.position.z = 3;
+			const voxel::IndexType i3 = mesh.addVertex(vertex);
+			mesh.addTriangle(i0, i1, i2);
+			mesh.addTriangle(i0, i2, i3);
+		}
+		return mesh;
+	}
+
+	/**
+	 * @brief Checks that rendering the whole index buffer results in exactly the triangles of the expected
+	 * bricks - given as brick position and the id and quad count of the mesh.
+	 */
+	void validate(const BrickMeshBuffer& buffer, const std::map<glm::ivec3, glm::ivec2, std::function<bool(const glm::ivec3&, const glm::ivec3&)>>& expected) const {
+		ASSERT_EQ((int)expected.size(), buffer.bricks());
+		const std::vector<voxel::VoxelVertex>& vertices = buffer.vertices();
+		const std::vector<voxel::IndexType>& indices = buffer.indices();
+		ASSERT_EQ(0u, indices.size() % 3u);
+		std::map<int, int> triangles;
+		for (size_t i = 0u; i < indices.size(); i += 3u) {
+			const voxel::IndexType i0 = indices[i + 0];
+			const voxel::IndexType i1 = indices[i + 1];
+			const voxel::IndexType i2 = indices[i + 2];
+			ASSERT_LT(i0, vertices.size());
+			ASSERT_LT(i1, vertices.size());
+			ASSERT_LT(i2, vertices.size());
+			if (i0 == i1 && i1 == i2) {
+				// degenerated
+				continue;
+			}
+			const int id = vertices[i0].position.x;
+			ASSERT_EQ(id, vertices[i1].position.x);
+			ASSERT_EQ(id, vertices[i2].position.x);
+			++triangles[id];
+		}
+		ASSERT_EQ(expected.size(), triangles.size());
+		for (const auto& e : expected) {
+			BrickMeshBuffer::Range vertexRange;
+			BrickMeshBuffer::Range indexRange;
+			ASSERT_TRUE(buffer.ranges(e.first, vertexRange, indexRange));
+			EXPECT_EQ((uint32_t)e.second.y * 4u, vertexRange.size);
+			EXPECT_EQ((uint32_t)e.second.y * 6u, indexRange.size);
+			EXPECT_EQ(0u, indexRange.offset % 3u);
+			EXPECT_EQ(e.second.y * 2, triangles[e.second.x]) << "Unexpected amount of triangles for mesh " << e.second.x;
+		}
+	}
+
+	static bool less(const glm::ivec3& a, const glm::ivec3& b) {
+		if (a.x != b.x) {
+			return a.x < b.x;
+		}
+		if (a.y != b.y) {
+			return a.y < b.y;
+		}
+		return a.z < b.z;
+	}
+
+	std::map<glm::ivec3, glm::ivec2, std::function<bool(const glm::ivec3&, const glm::ivec3&)>> _expected { less };
+};
+
+TEST_F(BrickMeshBufferTest, testDirtyBricks) {
+	EXPECT_EQ(1u, BrickMeshBuffer::dirtyBricks(voxel::Region(5, 5), 16).size());
+	EXPECT_EQ(1u, BrickMeshBuffer::dirtyBricks(voxel::Region(14, 14), 16).size());
+	// the meshes of the neighbours in negative direction depend on the voxels at the lower border
+	const std::vector<glm::ivec3>& lower = BrickMeshBuffer::dirtyBricks(voxel::Region(0, 0), 16);
+	ASSERT_EQ(8u, lower.size());
+	EXPECT_EQ(glm::ivec3(-16), lower.front());
+	EXPECT_EQ(glm::ivec3(0), lower.back());
+	// the meshes of the neighbours in positive direction depend on the voxels at the upper border
+	const std::vector<glm::ivec3>& upper = BrickMeshBuffer::dirtyBricks(voxel::Region(15, 15), 16);
+	ASSERT_EQ(8u, upper.size());
+	EXPECT_EQ(glm::ivec3(0), upper.front());
+	EXPECT_EQ(glm::ivec3(16), upper.back());
+	// two bricks and the neighbours around them
+	EXPECT_EQ(64u, BrickMeshBuffer::dirtyBricks(voxel::Region(0, 31), 16).size());
+}
+
+TEST_F(BrickMeshBufferTest, testUpdateInPlace) {
+	BrickMeshBuffer buffer;
+	buffer.update(glm::ivec3(0), createMesh(10, 1));
+	buffer.update(glm::ivec3(16, 0, 0), createMesh(10, 2));
+	_expected[glm::ivec3(0)] = glm::ivec2(1, 10);
+	_expected[glm::ivec3(16, 0, 0)] = glm::ivec2(2, 10);
+	validate(buffer, _expected);
+	EXPECT_TRUE(buffer.resized());
+	buffer.markClean();
+
+	BrickMeshBuffer::Range vertices;
+	BrickMeshBuffer::Range indices;
+	ASSERT_TRUE(buffer.ranges(glm::ivec3(0), vertices, indices));
+
+	// a smaller mesh fits into the range of the brick
+	buffer.update(glm::ivec3(0), createMesh(8, 3));
+	_expected[glm::ivec3(0)] = glm::ivec2(3, 8);
+	validate(buffer, _expected);
+	EXPECT_FALSE(buffer.resized()) << "The buffers should just be patched";
+	BrickMeshBuffer::Range newVertices;
+	BrickMeshBuffer::Range newIndices;
+	ASSERT_TRUE(buffer.ranges(glm::ivec3(0), newVertices, newIndices));
+	EXPECT_EQ(vertices.offset, newVertices.offset);
+	EXPECT_EQ(indices.offset, newIndices.offset);
+
+	// only the range of the brick is modified - including the indices of the old mesh
+	const BrickMeshBuffer::DirtyRanges& dirtyVertices = buffer.dirtyVertices();
+	ASSERT_EQ(1u, dirtyVertices.size());
+	EXPECT_EQ(vertices.offset, dirtyVertices[0].begin);
+	EXPECT_EQ(vertices.offset + 8u * 4u, dirtyVertices[0].end);
+	const BrickMeshBuffer::DirtyRanges& dirtyIndices = buffer.dirtyIndices();
+	ASSERT_EQ(1u, dirtyIndices.size());
+	EXPECT_EQ(indices.offset, dirtyIndices[0].begin);
+	EXPECT_EQ(indices.offset + 10u * 6u, dirtyIndices[0].end);
+
+	buffer.markClean();
+	EXPECT_TRUE(buffer.dirtyVertices().empty());
+	EXPECT_TRUE(buffer.dirtyIndices().empty());
+}
+
+TEST_F(BrickMeshBufferTest, testUpdateMoves) {
+	BrickMeshBuffer buffer;
+	for (int i = 0; i < 4; ++i) {
+		buffer.update(glm::ivec3(i * 16, 0, 0), createMesh(10, i));
+		_expected[glm::ivec3(i * 16, 0, 0)] = glm::ivec2(i, 10);
+	}
+	validate(buffer, _expected);
+	buffer.markClean();
+
+	BrickMeshBuffer::Range vertices;
+	BrickMeshBuffer::Range indices;
+	ASSERT_TRUE(buffer.ranges(glm::ivec3(0), vertices, indices));
+
+	// the mesh doesn't fit into the range anymore
+	buffer.update(glm::ivec3(0), createMesh(40, 10));
+	_expected[glm::ivec3(0)] = glm::ivec2(10, 40);
+	validate(buffer, _expected);
+	BrickMeshBuffer::Range movedVertices;
+	BrickMeshBuffer::Range movedIndices;
+	ASSERT_TRUE(buffer.ranges(glm::ivec3(0), movedVertices, movedIndices));
+	EXPECT_NE(vertices.offset, movedVertices.offset);
+	EXPECT_NE(indices.offset, movedIndices.offset);
+
+	// the free range is used by the next brick
+	buffer.update(glm::ivec3(0, 16, 0), createMesh(5, 11));
+	_expected[glm::ivec3(0, 16, 0)] = glm::ivec2(11, 5);
+	validate(buffer, _expected);
+	BrickMeshBuffer::Range reusedVertices;
+	BrickMeshBuffer::Range reusedIndices;
+	ASSERT_TRUE(buffer.ranges(glm::ivec3(0, 16, 0), reusedVertices, reusedIndices));
+	EXPECT_EQ(vertices.offset, reusedVertices.offset);
+	EXPECT_EQ(indices.offset, reusedIndices.offset);
+}
+
+TEST_F(BrickMeshBufferTest, testRemove) {
+	BrickMeshBuffer buffer;
+	buffer.update(glm::ivec3(0), createMesh(10, 1));
+	buffer.update(glm::ivec3(16), createMesh(10, 2));
+	buffer.markClean();
+
+	EXPECT_TRUE(buffer.remove(glm::ivec3(0)));
+	EXPECT_FALSE(buffer.remove(glm::ivec3(0)));
+	_expected[glm::ivec3(16)] = glm::ivec2(2, 10);
+	validate(buffer, _expected);
+
+	// an empty mesh removes the brick, too
+	buffer.update(glm::ivec3(16), voxel::Mesh(128, 128, true));
+	EXPECT_TRUE(buffer.empty());
+	EXPECT_TRUE(buffer.indices().empty());
+	EXPECT_TRUE(buffer.resized());
+}
+
+TEST_F(BrickMeshBufferTest, testCompact) {
+	BrickMeshBuffer buffer;
+	const int n = 64;
+	for (int i = 0; i < n; ++i) {
+		buffer.update(glm::ivec3(i * 16, 0, 0), createMesh(20, i));
+	}
+	buffer.markClean();
+	const size_t size = buffer.indices().size();
+	for (int i = 0; i < n - 4; ++i) {
+		buffer.remove(glm::ivec3(i * 16, 0, 0));
+	}
+	for (int i = n - 4; i < n; ++i) {
+		_expected[glm::ivec3(i * 16, 0, 0)] = glm::ivec2(i, 20);
+	}
+	validate(buffer, _expected);
+	EXPECT_TRUE(buffer.resized());
+	EXPECT_LT(buffer.indices().size(), size / 2u);
+}
+
+}
@@ -6,6 +6,7 @@
 
 #include "voxel/RawVolume.h"
 #include "VolumeMerger.h"
+#include "VolumeSlabs.h"
 #include "core/Common.h"
 
 namespace voxel {
@@ -36,37 +37,45 @@ RawVolume* cropVolume(const RawVolume* volume, const glm::ivec3& mins, const glm
 
 /**
  * @brief Resizes a volume to cut off empty parts
+ * @note The slabs of the volume are scanned in parallel - the condition must be safe to be called concurrently
  */
 template<class CropSkipCondition = CropSkipEmpty>
 RawVolume* cropVolume(const RawVolume* volume, CropSkipCondition condition = CropSkipCondition()) {
 	core_trace_scoped(CropRawVolume);
 	const glm::ivec3& mins = volume->mins();
 	const glm::ivec3& maxs = volume->maxs();
-	glm::ivec3 newMins((std::numeric_limits<int>::max)());
-	glm::ivec3 newMaxs((std::numeric_limits<int>::min)());
-	voxel::RawVolume::Sampler volumeSampler(volume);
-	for (int32_t z = mins.z; z <= maxs.z; ++z) {
-		for (int32_t y = mins.y; y <= maxs.y; ++y) {
-			for (int32_t x = mins.x; x <= maxs.x; ++x) {
-				volumeSampler.setPosition(x, y, z);
-				const voxel::Voxel& voxel = volumeSampler.voxel();
-				if (condition(voxel)) {
+	const voxel::Region& region = volume->region();
+	const int32_t width = volume->width();
+	const int64_t slice = (int64_t)width * volume->height();
+	const int32_t rowLength = maxs.x - mins.x + 1;
+	const voxel::Voxel* data = volume->voxels();
+	// the slabs are scanned in parallel - every row is scanned from both ends for the first and last
+	// voxel that is not skipped
+	const SlabResult& result = forEachSlab(mins.z, maxs.z, (int64_t)rowLength * (maxs.y - mins.y + 1),
+			[&] (int, int32_t lowerZ, int32_t upperZ, SlabResult& slabResult) {
+		for (int32_t z = lowerZ; z <= upperZ; ++z) {
+			const voxel::Voxel* slicePtr = data + (int64_t)(z - region.getLowerZ()) * slice;
+			for (int32_t y = mins.y; y <= maxs.y; ++y) {
+				const voxel::Voxel* row = slicePtr + (int64_t)(y - region.getLowerY()) * width + (mins.x - region.getLowerX());
+				int32_t first = 0;
+				while (first < rowLength && condition(row[first])) {
+					++first;
+				}
+				if (first == rowLength) {
 					continue;
 				}
-				newMins.x = core_min(newMins.x, x);
-				newMins.y = core_min(newMins.y, y);
-				newMins.z = core_min(newMins.z, z);
-
-				newMaxs.x = core_max(newMaxs.x, x);
-				newMaxs.y = core_max(newMaxs.y, y);
-				newMaxs.z = core_max(newMaxs.z, z);
+				int32_t last = rowLength - 1;
+				while (last > first && condition(row[last])) {
+					--last;
+				}
+				slabResult.addRow(mins.x + first, mins.x + last, y, z);
 			}
 		}
-	}
-	if (newMaxs.z == (std::numeric_limits<int>::min)()) {
+	});
+	if (result.changed <= 0) {
 		return nullptr;
 	}
-	return cropVolume(volume, newMins, newMaxs, condition);
+	return cropVolume(volume, result.mins, result.maxs, condition);
 }
 
 }
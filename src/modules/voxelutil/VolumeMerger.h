@@ -5,8 +5,10 @@
 #pragma once
 
 #include "voxel/RawVolume.h"
+#include "VolumeSlabs.h"
 #include "core/Trace.h"
 #include "core/Assert.h"
+#include <type_traits>
 #include <vector>
 
 namespace voxel {
@@ -20,14 +22,86 @@ struct MergeSkipEmpty {
 	}
 };
 
+namespace _priv {
+
+/**
+ * @brief Merges row by row into the memory of the destination volume. The slabs are processed in parallel.
+ * @note The regions must already be clipped against the volumes
+ */
+template<typename MergeCondition>
+int mergeRawVolumes(RawVolume* destination, const RawVolume* source, const Region& destReg, const Region& sourceReg, MergeCondition& mergeCondition) {
+	const Region& destVolumeRegion = destination->region();
+	const Region& sourceVolumeRegion = source->region();
+	const glm::ivec3& destMins = destReg.getLowerCorner();
+	const glm::ivec3& sourceMins = sourceReg.getLowerCorner();
+	// the voxels of the source region that end up inside the destination region
+	const glm::ivec3 dim = (glm::min)(sourceReg.getDimensionsInVoxels(), destReg.getDimensionsInVoxels());
+	const int32_t destWidth = destination->width();
+	const int64_t destSlice = (int64_t)destWidth * destination->height();
+	const int32_t sourceWidth = source->width();
+	const int64_t sourceSlice = (int64_t)sourceWidth * source->height();
+	Voxel* destData = destination->voxels();
+	const Voxel* sourceData = source->voxels();
+
+	const SlabResult& result = forEachSlab(0, dim.z - 1, (int64_t)dim.x * dim.y, [&] (int, int32_t lowerZ, int32_t upperZ, SlabResult& slabResult) {
+		for (int32_t z = lowerZ; z <= upperZ; ++z) {
+			const int64_t destZ = (destMins.z + z - destVolumeRegion.getLowerZ()) * destSlice;
+			const int64_t sourceZ = (sourceMins.z + z - sourceVolumeRegion.getLowerZ()) * sourceSlice;
+			for (int32_t y = 0; y < dim.y; ++y) {
+				Voxel* destRow = destData + destZ + (int64_t)(destMins.y + y - destVolumeRegion.getLowerY()) * destWidth
+						+ (destMins.x - destVolumeRegion.getLowerX());
+				const Voxel* sourceRow = sourceData + sourceZ + (int64_t)(sourceMins.y + y - sourceVolumeRegion.getLowerY()) * sourceWidth
+						+ (sourceMins.x - sourceVolumeRegion.getLowerX());
+				int32_t first = -1;
+				int32_t last = -1;
+				int changed = 0;
+				for (int32_t x = 0; x < dim.x; ++x) {
+					const Voxel& voxel = sourceRow[x];
+					if (!mergeCondition(voxel)) {
+						continue;
+					}
+					if (destRow[x].isSame(voxel)) {
+						continue;
+					}
+					destRow[x] = voxel;
+					if (first == -1) {
+						first = x;
+					}
+					last = x;
+					++changed;
+				}
+				if (changed > 0) {
+					slabResult.addRow(destMins.x + first, destMins.x + last, destMins.y + y, destMins.z + z, changed);
+				}
+			}
+		}
+	});
+	if (result.changed > 0) {
+		destination->extendBounds(result.mins, result.maxs);
+	}
+	return result.changed;
+}
+
+}
+
 /**
  * @note This version can deal with source volumes that are smaller or equal sized to the destination volume
  * @note The given merge condition function must return false for voxels that should be skipped.
+ * @note Merging two RawVolume instances is done row by row on several threads - the merge condition must be
+ * safe to be called concurrently in that case.
  * @sa MergeSkipEmpty
  */
 template<typename MergeCondition = MergeSkipEmpty, class Volume1, class Volume2>
 int mergeVolumes(Volume1* destination, const Volume2* source, const Region& destReg, const Region& sourceReg, MergeCondition mergeCondition = MergeCondition()) {
 	core_trace_scoped(MergeRawVolumes);
+	if constexpr (std::is_same<Volume1, RawVolume>::value && std::is_same<Volume2, RawVolume>::value) {
+		const Region clippedDestReg(destReg.getLowerCorner(), destReg.getLowerCorner()
+				+ (glm::min)(sourceReg.getDimensionsInCells(), destReg.getDimensionsInCells()));
+		if (sourceReg.isValid() && destReg.isValid() && source->region().containsRegion(sourceReg)
+				&& destination->region().containsRegion(clippedDestReg)) {
+			return _priv::mergeRawVolumes(destination, source, destReg, sourceReg, mergeCondition);
+		}
+	}
 	int cnt = 0;
 	for (int32_t z = sourceReg.getLowerZ(); z <= sourceReg.getUpperZ(); ++z) {
 		const int destZ = destReg.getLowerZ() + z - sourceReg.getLowerZ();
@@ -8,6 +8,9 @@
 #include "voxel/MaterialColor.h"
 #include "voxel/Voxel.h"
 #include "voxel/Region.h"
+#include "VolumeSlabs.h"
+#include <algorithm>
+#include <vector>
 
 namespace voxel {
 
@@ -18,63 +21,78 @@ namespace voxel {
  * @param[in] sourceRegion The region of the source volume to resample
  * @param[in] destRegion The region of the destination volume to resample into. Usually this should
  * be exactly half of the size of the sourceRegion.
+ * @note The slabs of the destination region are computed in parallel - the samplers of both volumes
+ * must support concurrent reads.
  */
 template<typename SourceVolume, typename DestVolume>
 void rescaleVolume(const SourceVolume& sourceVolume, const Region& sourceRegion, DestVolume& destVolume, const Region& destRegion) {
 	core_trace_scoped(RescaleVolume);
-	typename SourceVolume::Sampler srcSampler(sourceVolume);
-
 	const MaterialColorArray& colors = getMaterialColors();
 
 	const int32_t depth = destRegion.getDepthInVoxels();
 	const int32_t height = destRegion.getHeightInVoxels();
 	const int32_t width = destRegion.getWidthInVoxels();
+	const int64_t slice = (int64_t)width * height;
+	const glm::ivec3& srcMins = sourceRegion.getLowerCorner();
+	const glm::ivec3& dstMins = destRegion.getLowerCorner();
+
 	// First of all we iterate over all destination voxels and compute their color as the
 	// avg of the colors of the eight corresponding voxels in the higher resolution version.
-	for (int32_t z = 0; z < depth; ++z) {
-		for (int32_t y = 0; y < height; ++y) {
-			for (int32_t x = 0; x < width; ++x) {
-				const glm::ivec3 curPos(x, y, z);
-				const glm::ivec3 srcPos = sourceRegion.getLowerCorner() + curPos * 2;
-				const glm::ivec3 dstPos = destRegion.getLowerCorner() + curPos;
-
-				float solidVoxels = 0.0f;
-				float avgOf8Red = 0.0f;
-				float avgOf8Green = 0.0f;
-				float avgOf8Blue = 0.0f;
+	// The slabs are computed in parallel into a buffer that is written to the destination volume
+	// afterwards. The children are accumulated row by row - the sampler is only positioned once
+	// per source row.
+	std::vector<Voxel> voxels(slice * depth);
+	forEachSlab(0, depth - 1, slice, [&] (int, int32_t lowerZ, int32_t upperZ, SlabResult&) {
+		typename SourceVolume::Sampler srcSampler(sourceVolume);
+		// rgb sum and the amount of solid voxels
+		std::vector<glm::vec4> accum(width);
+		for (int32_t z = lowerZ; z <= upperZ; ++z) {
+			for (int32_t y = 0; y < height; ++y) {
+				std::fill(accum.begin(), accum.end(), glm::vec4(0.0f));
 				for (int32_t childZ = 0; childZ < 2; ++childZ) {
 					for (int32_t childY = 0; childY < 2; ++childY) {
-						for (int32_t childX = 0; childX < 2; ++childX) {
-							srcSampler.setPosition(srcPos + glm::ivec3(childX, childY, childZ));
-							if (!srcSampler.currentPositionValid()) {
-								continue;
-							}
-							const Voxel& child = srcSampler.voxel();
-
-							if (isBlocked(child.getMaterial())) {
-								++solidVoxels;
-								const glm::vec4& color = colors[child.getColor()];
-								avgOf8Red += color.r;
-								avgOf8Green += color.g;
-								avgOf8Blue += color.b;
+						srcSampler.setPosition(srcMins + glm::ivec3(0, y * 2 + childY, z * 2 + childZ));
+						for (int32_t x = 0; x < width; ++x) {
+							glm::vec4& sum = accum[x];
+							for (int32_t childX = 0; childX < 2; ++childX) {
+								if (srcSampler.currentPositionValid()) {
+									const Voxel& child = srcSampler.voxel();
+									if (isBlocked(child.getMaterial())) {
+										const glm::vec4& color = colors[child.getColor()];
+										sum.r += color.r;
+										sum.g += color.g;
+										sum.b += color.b;
+										++sum.a;
+									}
+								}
+								srcSampler.movePositiveX();
 							}
 						}
 					}
 				}
 
-				// We only make a voxel solid if the eight corresponding voxels are also all solid. This
-				// means that higher LOD meshes actually shrink away which ensures cracks aren't visible.
-				if (solidVoxels >= 7.0f) {
-					const glm::vec4 avgColor(avgOf8Red / solidVoxels, avgOf8Green / solidVoxels, avgOf8Blue / solidVoxels, 1.0f);
-					const int index = core::Color::getClosestMatch(avgColor, colors);
-					Voxel voxel = createVoxel(VoxelType::Generic, index);
-					destVolume.setVoxel(dstPos, voxel);
-				} else {
-					const Voxel voxelAir;
-					destVolume.setVoxel(dstPos, voxelAir);
+				Voxel* row = voxels.data() + z * slice + (int64_t)y * width;
+				for (int32_t x = 0; x < width; ++x) {
+					const glm::vec4& sum = accum[x];
+					const float solidVoxels = sum.a;
+					// We only make a voxel solid if the eight corresponding voxels are also all solid. This
+					// means that higher LOD meshes actually shrink away which ensures cracks aren't visible.
+					if (solidVoxels >= 7.0f) {
+						const glm::vec4 avgColor(sum.r / solidVoxels, sum.g / solidVoxels, sum.b / solidVoxels, 1.0f);
+						const int index = core::Color::getClosestMatch(avgColor, colors);
+						row[x] = createVoxel(VoxelType::Generic, index);
+					}
 				}
 			}
 		}
+	});
+	for (int32_t z = 0; z < depth; ++z) {
+		for (int32_t y = 0; y < height; ++y) {
+			const Voxel* row = voxels.data() + z * slice + (int64_t)y * width;
+			for (int32_t x = 0; x < width; ++x) {
+				destVolume.setVoxel(dstMins + glm::ivec3(x, y, z), row[x]);
+			}
+		}
 	}
 
 	// At this point the results are usable, but we have a problem with thin structures disappearing.
@@ -83,86 +101,99 @@ void rescaleVolume(const SourceVolume& sourceVolume, const Region& sourceRegion,
 	// color changes, as this is very noticable. Our solution is to process again only those voxels
 	// which lie on a material-air boundary, and to recompute their color using a larger naighbourhood
 	// while also accounting for how visible the child voxels are.
-	typename DestVolume::Sampler dstSampler(destVolume);
-	for (int32_t z = 0; z < destRegion.getDepthInVoxels(); ++z) {
-		for (int32_t y = 0; y < destRegion.getHeightInVoxels(); ++y) {
-			for (int32_t x = 0; x < destRegion.getWidthInVoxels(); ++x) {
-				const glm::ivec3 curPos(x, y, z);
-				const glm::ivec3 dstPos = destRegion.getLowerCorner() + curPos;
-
-				dstSampler.setPosition(dstPos);
-
-				// Skip empty voxels
-				if (dstSampler.voxel().getMaterial() == VoxelType::Air) {
-					continue;
-				}
-				// Only process voxels on a material-air boundary.
-				if (dstSampler.peekVoxel0px0py1nz().getMaterial() != VoxelType::Air && dstSampler.peekVoxel0px0py1pz().getMaterial() != VoxelType::Air
-						&& dstSampler.peekVoxel0px1ny0pz().getMaterial() != VoxelType::Air && dstSampler.peekVoxel0px1py0pz().getMaterial() != VoxelType::Air
-						&& dstSampler.peekVoxel1nx0py0pz().getMaterial() != VoxelType::Air && dstSampler.peekVoxel1px0py0pz().getMaterial() != VoxelType::Air) {
-					continue;
-				}
-				const glm::ivec3 srcPos = sourceRegion.getLowerCorner() + curPos * 2;
-
-				float totalRed = 0.0f;
-				float totalGreen = 0.0f;
-				float totalBlue = 0.0f;
-				float totalExposedFaces = 0.0f;
-
-				// Look at the 64 (4x4x4) children
-				for (int32_t childZ = -1; childZ < 3; childZ++) {
-					for (int32_t childY = -1; childY < 3; childY++) {
-						for (int32_t childX = -1; childX < 3; childX++) {
-							srcSampler.setPosition(srcPos + glm::ivec3(childX, childY, childZ));
-
-							const Voxel& child = srcSampler.voxel();
-							if (child.getMaterial() == VoxelType::Air) {
-								continue;
-							}
-
-							// For each small voxel, count the exposed faces and use this
-							// to determine the importance of the color contribution.
-							float exposedFaces = 0.0f;
-							if (srcSampler.peekVoxel0px0py1nz().getMaterial() == VoxelType::Air) {
-								++exposedFaces;
-							}
-							if (srcSampler.peekVoxel0px0py1pz().getMaterial() == VoxelType::Air) {
-								++exposedFaces;
-							}
-							if (srcSampler.peekVoxel0px1ny0pz().getMaterial() == VoxelType::Air) {
-								++exposedFaces;
-							}
-							if (srcSampler.peekVoxel0px1py0pz().getMaterial() == VoxelType::Air) {
-								++exposedFaces;
-							}
-							if (srcSampler.peekVoxel1nx0py0pz().getMaterial() == VoxelType::Air) {
-								++exposedFaces;
-							}
-							if (srcSampler.peekVoxel1px0py0pz().getMaterial() == VoxelType::Air) {
-								++exposedFaces;
-							}
+	// The recomputed colors don't change the material - so the boundary check of a voxel is not
+	// affected by the other voxels of this pass and the slabs can be computed in parallel, too.
+	struct RecoloredVoxel {
+		glm::ivec3 pos;
+		Voxel voxel;
+	};
+	std::vector<std::vector<RecoloredVoxel>> slabVoxels(slabCount(0, depth - 1, slice));
+	forEachSlab(0, depth - 1, slice, [&] (int slab, int32_t lowerZ, int32_t upperZ, SlabResult&) {
+		typename SourceVolume::Sampler srcSampler(sourceVolume);
+		typename DestVolume::Sampler dstSampler(destVolume);
+		std::vector<RecoloredVoxel>& recoloredVoxels = slabVoxels[slab];
+		for (int32_t z = lowerZ; z <= upperZ; ++z) {
+			for (int32_t y = 0; y < height; ++y) {
+				for (int32_t x = 0; x < width; ++x) {
+					const glm::ivec3 curPos(x, y, z);
+					const glm::ivec3 dstPos = dstMins + curPos;
+
+					// Skip empty voxels
+					if (voxels[z * slice + (int64_t)y * width + x].getMaterial() == VoxelType::Air) {
+						continue;
+					}
+					dstSampler.setPosition(dstPos);
+					// Only process voxels on a material-air boundary.
+					if (dstSampler.peekVoxel0px0py1nz().getMaterial() != VoxelType::Air && dstSampler.peekVoxel0px0py1pz().getMaterial() != VoxelType::Air
+							&& dstSampler.peekVoxel0px1ny0pz().getMaterial() != VoxelType::Air && dstSampler.peekVoxel0px1py0pz().getMaterial() != VoxelType::Air
+							&& dstSampler.peekVoxel1nx0py0pz().getMaterial() != VoxelType::Air && dstSampler.peekVoxel1px0py0pz().getMaterial() != VoxelType::Air) {
+						continue;
+					}
+					const glm::ivec3 srcPos = srcMins + curPos * 2;
+
+					float totalRed = 0.0f;
+					float totalGreen = 0.0f;
+					float totalBlue = 0.0f;
+					float totalExposedFaces = 0.0f;
+
+					// Look at the 64 (4x4x4) children
+					for (int32_t childZ = -1; childZ < 3; childZ++) {
+						for (int32_t childY = -1; childY < 3; childY++) {
+							srcSampler.setPosition(srcPos + glm::ivec3(-1, childY, childZ));
+							for (int32_t childX = -1; childX < 3; childX++, srcSampler.movePositiveX()) {
+								const Voxel& child = srcSampler.voxel();
+								if (child.getMaterial() == VoxelType::Air) {
+									continue;
+								}
+
+								// For each small voxel, count the exposed faces and use this
+								// to determine the importance of the color contribution.
+								float exposedFaces = 0.0f;
+								if (srcSampler.peekVoxel0px0py1nz().getMaterial() == VoxelType::Air) {
+									++exposedFaces;
+								}
+								if (srcSampler.peekVoxel0px0py1pz().getMaterial() == VoxelType::Air) {
+									++exposedFaces;
+								}
+								if (srcSampler.peekVoxel0px1ny0pz().getMaterial() == VoxelType::Air) {
+									++exposedFaces;
+								}
+								if (srcSampler.peekVoxel0px1py0pz().getMaterial() == VoxelType::Air) {
+									++exposedFaces;
+								}
+								if (srcSampler.peekVoxel1nx0py0pz().getMaterial() == VoxelType::Air) {
+									++exposedFaces;
+								}
+								if (srcSampler.peekVoxel1px0py0pz().getMaterial() == VoxelType::Air) {
+									++exposedFaces;
+								}
 
-							const glm::vec4& color = colors[child.getColor()];
-							totalRed += color.r * exposedFaces;
-							totalGreen += color.g * exposedFaces;
-							totalBlue += color.b * exposedFaces;
+								const glm::vec4& color = colors[child.getColor()];
+								totalRed += color.r * exposedFaces;
+								totalGreen += color.g * exposedFaces;
+								totalBlue += color.b * exposedFaces;
 
-							totalExposedFaces += exposedFaces;
+								totalExposedFaces += exposedFaces;
+							}
 						}
 					}
-				}
 
-				// Avoid divide by zero if there were no exposed faces.
-				if (totalExposedFaces <= 0.01f) {
-					++totalExposedFaces;
-				}
+					// Avoid divide by zero if there were no exposed faces.
+					if (totalExposedFaces <= 0.01f) {
+						++totalExposedFaces;
+					}
 
-				const glm::vec4 avgColor(totalRed / totalExposedFaces, totalGreen / totalExposedFaces, totalBlue / totalExposedFaces, 1.0f);
-				const int index = core::Color::getClosestMatch(avgColor, colors);
-				const Voxel voxel = createVoxel(VoxelType::Generic, index);
-				destVolume.setVoxel(dstPos, voxel);
+					const glm::vec4 avgColor(totalRed / totalExposedFaces, totalGreen / totalExposedFaces, totalBlue / totalExposedFaces, 1.0f);
+					const int index = core::Color::getClosestMatch(avgColor, colors);
+					recoloredVoxels.push_back(RecoloredVoxel{dstPos, createVoxel(VoxelType::Generic, index)});
+				}
 			}
 		}
+	});
+	for (const std::vector<RecoloredVoxel>& recoloredVoxels : slabVoxels) {
+		for (const RecoloredVoxel& recolored : recoloredVoxels) {
+			destVolume.setVoxel(recolored.pos, recolored.voxel);
+		}
 	}
 }
 
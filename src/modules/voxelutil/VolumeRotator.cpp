@@ -3,10 +3,14 @@
  */
 
 #include "VolumeRotator.h"
+#include "VolumeSlabs.h"
 #include "voxel/RawVolume.h"
 #include "math/AABB.h"
 #include "core/GLM.h"
 #include "core/Assert.h"
+#include "core/Trace.h"
+#include <algorithm>
+#include <vector>
 
 namespace voxel {
 
@@ -20,6 +24,7 @@ namespace voxel {
  * memory.
  */
 RawVolume* rotateVolume(const RawVolume* source, const glm::vec3& angles, const Voxel& empty, const glm::vec3& pivot, bool increaseSize) {
+	core_trace_scoped(RotateVolume);
 	const float pitch = glm::radians(angles.x);
 	const float yaw = glm::radians(angles.y);
 	const float roll = glm::radians(angles.z);
@@ -46,132 +51,171 @@ RawVolume* rotateVolume(const RawVolume* source, const glm::vec3& angles, const
 		destRegion = srcRegion;
 	}
 	voxel::RawVolume* destination = new RawVolume(destRegion);
-	voxel::RawVolume::Sampler destSampler(destination);
-	voxel::RawVolume::Sampler srcSampler(source);
-
-	for (int32_t z = srcRegion.getLowerZ(); z <= srcRegion.getUpperZ(); ++z) {
-		for (int32_t y = srcRegion.getLowerY(); y <= srcRegion.getUpperY(); ++y) {
-			for (int32_t x = srcRegion.getLowerX(); x <= srcRegion.getUpperX(); ++x) {
-				srcSampler.setPosition(x, y, z);
-				const Voxel& v = srcSampler.voxel();
-				if (v == empty) {
-					continue;
-				}
-				const glm::vec3 pos(x - pivot.x, y - pivot.y, z - pivot.z);
-				const glm::vec3 rotatedPos = glm::rotate(rot, pos);
-				const glm::vec3 newPos = rotatedPos + pivot;
-				const glm::ivec3 volumePos(newPos);
-				if (!destRegion.containsPoint(volumePos)) {
-					continue;
-				}
 
-				destSampler.setPosition(volumePos);
-				if (destSampler.voxel() == empty) {
-					destSampler.setVoxel(v);
+	const int32_t srcWidth = source->width();
+	const int64_t srcSlice = (int64_t)srcWidth * source->height();
+	const Voxel* srcData = source->voxels();
+	const glm::ivec3& destMins = destRegion.getLowerCorner();
+	const int32_t destWidth = destination->width();
+	const int64_t destSlice = (int64_t)destWidth * destination->height();
+
+	// the rotated positions are calculated in parallel - but if several source voxels end up at the same
+	// position, the first one in z, y, x order wins. That's why the voxels are written in slab order afterwards.
+	struct RotatedVoxel {
+		int64_t index;
+		Voxel voxel;
+	};
+	const int64_t srcVoxelsPerSlice = (int64_t)srcWidth * source->height();
+	std::vector<std::vector<RotatedVoxel>> slabVoxels(slabCount(srcRegion.getLowerZ(), srcRegion.getUpperZ(), srcVoxelsPerSlice));
+	const SlabResult& result = forEachSlab(srcRegion.getLowerZ(), srcRegion.getUpperZ(), srcVoxelsPerSlice,
+			[&] (int slab, int32_t lowerZ, int32_t upperZ, SlabResult& slabResult) {
+		std::vector<RotatedVoxel>& rotatedVoxels = slabVoxels[slab];
+		for (int32_t z = lowerZ; z <= upperZ; ++z) {
+			for (int32_t y = srcRegion.getLowerY(); y <= srcRegion.getUpperY(); ++y) {
+				const Voxel* row = srcData + (int64_t)(z - srcRegion.getLowerZ()) * srcSlice + (int64_t)(y - srcRegion.getLowerY()) * srcWidth;
+				for (int32_t x = srcRegion.getLowerX(); x <= srcRegion.getUpperX(); ++x) {
+					const Voxel& v = row[x - srcRegion.getLowerX()];
+					if (v == empty) {
+						continue;
+					}
+					const glm::vec3 pos(x - pivot.x, y - pivot.y, z - pivot.z);
+					const glm::vec3 rotatedPos = glm::rotate(rot, pos);
+					const glm::vec3 newPos = rotatedPos + pivot;
+					const glm::ivec3 volumePos(newPos);
+					if (!destRegion.containsPoint(volumePos)) {
+						continue;
+					}
+					const glm::ivec3 local = volumePos - destMins;
+					rotatedVoxels.push_back(RotatedVoxel{local.x + local.y * destWidth + local.z * destSlice, v});
+					slabResult.addRow(volumePos.x, volumePos.x, volumePos.y, volumePos.z);
 				}
 			}
 		}
+	});
+
+	Voxel* destData = destination->voxels();
+	for (const std::vector<RotatedVoxel>& rotatedVoxels : slabVoxels) {
+		for (const RotatedVoxel& rotated : rotatedVoxels) {
+			Voxel& destVoxel = destData[rotated.index];
+			if (destVoxel == empty) {
+				destVoxel = rotated.voxel;
+			}
+		}
+	}
+	if (result.changed > 0) {
+		destination->extendBounds(result.mins, result.maxs);
 	}
 	return destination;
 }
 
-RawVolume* rotateAxis(const RawVolume* source, math::Axis axis) {
-	const voxel::Region& srcRegion = source->region();
-	voxel::Region destRegion = srcRegion;
+/**
+ * @brief Swaps the components of the given vector that belong to the plane of the axis
+ */
+static inline glm::ivec3 swapAxis(const glm::ivec3& v, math::Axis axis) {
+	if (axis == math::Axis::X) {
+		return glm::ivec3(v.x, v.z, v.y);
+	}
 	if (axis == math::Axis::Y) {
-		destRegion.setLowerX(srcRegion.getLowerZ());
-		destRegion.setLowerZ(srcRegion.getLowerX());
-		destRegion.setUpperX(srcRegion.getUpperZ());
-		destRegion.setUpperZ(srcRegion.getUpperX());
-	} else if (axis == math::Axis::X) {
-		destRegion.setLowerY(srcRegion.getLowerZ());
-		destRegion.setLowerZ(srcRegion.getLowerX());
-		destRegion.setUpperY(srcRegion.getUpperZ());
-		destRegion.setUpperZ(srcRegion.getUpperY());
-	} else {
-		destRegion.setLowerY(srcRegion.getLowerX());
-		destRegion.setLowerX(srcRegion.getLowerY());
-		destRegion.setUpperY(srcRegion.getUpperX());
-		destRegion.setUpperX(srcRegion.getUpperY());
+		return glm::ivec3(v.z, v.y, v.x);
 	}
+	return glm::ivec3(v.y, v.x, v.z);
+}
+
+RawVolume* rotateAxis(const RawVolume* source, math::Axis axis) {
+	core_trace_scoped(RotateAxis);
+	const voxel::Region& srcRegion = source->region();
+	const voxel::Region destRegion(swapAxis(srcRegion.getLowerCorner(), axis), swapAxis(srcRegion.getUpperCorner(), axis));
 	core_assert(destRegion.isValid());
 	RawVolume* destination = new RawVolume(destRegion);
-	RawVolume::Sampler destSampler(destination);
-	RawVolume::Sampler srcSampler(source);
-
-	for (int32_t z = srcRegion.getLowerZ(); z <= srcRegion.getUpperZ(); ++z) {
-		for (int32_t y = srcRegion.getLowerY(); y <= srcRegion.getUpperY(); ++y) {
-			for (int32_t x = srcRegion.getLowerX(); x <= srcRegion.getUpperX(); ++x) {
-				srcSampler.setPosition(x, y, z);
-				const Voxel& v = srcSampler.voxel();
-				glm::ivec3 pos(x, y, z);
-				if (axis == math::Axis::X) {
-					const int tmp = pos.y;
-					pos.y = pos.z;
-					pos.z = tmp;
-				} else if (axis == math::Axis::Y) {
-					const int tmp = pos.x;
-					pos.x = pos.z;
-					pos.z = tmp;
-				} else {
-					const int tmp = pos.x;
-					pos.x = pos.y;
-					pos.y = tmp;
+
+	const glm::ivec3& srcMins = srcRegion.getLowerCorner();
+	const int32_t srcWidth = source->width();
+	const int64_t srcSlice = (int64_t)srcWidth * source->height();
+	const Voxel* srcData = source->voxels();
+	const glm::ivec3& destMins = destRegion.getLowerCorner();
+	const int32_t destWidth = destination->width();
+	const int64_t destSlice = (int64_t)destWidth * destination->height();
+	Voxel* destData = destination->voxels();
+	// the source voxels of a destination row along x are a row along the swapped axis
+	const glm::ivec3& srcStep = swapAxis(glm::ivec3(1, 0, 0), axis);
+	const int64_t srcStride = srcStep.x + srcStep.y * srcWidth + srcStep.z * srcSlice;
+
+	forEachSlab(destRegion.getLowerZ(), destRegion.getUpperZ(), destSlice,
+			[&] (int, int32_t lowerZ, int32_t upperZ, SlabResult&) {
+		for (int32_t z = lowerZ; z <= upperZ; ++z) {
+			for (int32_t y = destRegion.getLowerY(); y <= destRegion.getUpperY(); ++y) {
+				const glm::ivec3& srcLocal = swapAxis(glm::ivec3(destMins.x, y, z), axis) - srcMins;
+				const Voxel* srcRow = srcData + srcLocal.x + srcLocal.y * srcWidth + srcLocal.z * srcSlice;
+				Voxel* destRow = destData + (int64_t)(z - destMins.z) * destSlice + (int64_t)(y - destMins.y) * destWidth;
+				if (srcStride == 1) {
+					std::copy(srcRow, srcRow + destWidth, destRow);
+					continue;
+				}
+				for (int32_t x = 0; x < destWidth; ++x) {
+					destRow[x] = srcRow[x * srcStride];
 				}
-				core_assert_always(destSampler.setPosition(pos));
-				core_assert_always(destSampler.setVoxel(v));
 			}
 		}
+	});
+
+	if (source->boundsValid()) {
+		destination->extendBounds(swapAxis(source->mins(), axis), swapAxis(source->maxs(), axis));
 	}
 	return destination;
 }
 
 RawVolume* mirrorAxis(const RawVolume* source, math::Axis axis) {
+	core_trace_scoped(MirrorAxis);
 	const voxel::Region& srcRegion = source->region();
-	RawVolume* destination = new RawVolume(source);
-	RawVolume::Sampler destSampler(destination);
-	RawVolume::Sampler srcSampler(source);
+	RawVolume* destination = new RawVolume(srcRegion);
+	destination->setBorderValue(source->borderValue());
 
 	const glm::ivec3& mins = srcRegion.getLowerCorner();
 	const glm::ivec3& maxs = srcRegion.getUpperCorner();
+	const int32_t width = source->width();
+	const int32_t height = source->height();
+	const int64_t slice = (int64_t)width * height;
+	const Voxel* srcData = source->voxels();
+	Voxel* destData = destination->voxels();
 
-	if (axis == math::Axis::X) {
-		for (int32_t z = mins.z; z <= maxs.z; ++z) {
-			for (int32_t y = mins.y; y <= maxs.y; ++y) {
-				srcSampler.setPosition(mins.x, y, z);
-				destSampler.setPosition(maxs.x, y, z);
-				for (int32_t x = mins.x; x <= maxs.x; ++x) {
-					destSampler.setVoxel(srcSampler.voxel());
-					srcSampler.movePositiveX();
-					destSampler.moveNegativeX();
-				}
+	// every row (or slice for the z axis) of the destination is a (reversed) copy of a source row
+	forEachSlab(mins.z, maxs.z, slice, [&] (int, int32_t lowerZ, int32_t upperZ, SlabResult&) {
+		for (int32_t z = lowerZ - mins.z; z <= upperZ - mins.z; ++z) {
+			Voxel* destSlice = destData + z * slice;
+			if (axis == math::Axis::Z) {
+				const Voxel* srcSlice = srcData + (maxs.z - mins.z - z) * slice;
+				std::copy(srcSlice, srcSlice + slice, destSlice);
+				continue;
 			}
-		}
-	} else if (axis == math::Axis::Y) {
-		for (int32_t z = mins.z; z <= maxs.z; ++z) {
-			for (int32_t x = mins.x; x <= maxs.x; ++x) {
-				srcSampler.setPosition(x, mins.y, z);
-				destSampler.setPosition(x, maxs.y, z);
-				for (int32_t y = mins.y; y <= maxs.y; ++y) {
-					destSampler.setVoxel(srcSampler.voxel());
-					srcSampler.movePositiveY();
-					destSampler.moveNegativeY();
-				}
-			}
-		}
-	} else if (axis == math::Axis::Z) {
-		for (int32_t y = mins.y; y <= maxs.y; ++y) {
-			for (int32_t x = mins.x; x <= maxs.x; ++x) {
-				srcSampler.setPosition(x, y, mins.z);
-				destSampler.setPosition(x, y, maxs.z);
-				for (int32_t z = mins.z; z <= maxs.z; ++z) {
-					destSampler.setVoxel(srcSampler.voxel());
-					srcSampler.movePositiveZ();
-					destSampler.moveNegativeZ();
+			const Voxel* srcSlice = srcData + z * slice;
+			for (int32_t y = 0; y < height; ++y) {
+				Voxel* destRow = destSlice + (int64_t)y * width;
+				if (axis == math::Axis::X) {
+					const Voxel* srcRow = srcSlice + (int64_t)y * width;
+					std::reverse_copy(srcRow, srcRow + width, destRow);
+				} else if (axis == math::Axis::Y) {
+					const Voxel* srcRow = srcSlice + (int64_t)(height - 1 - y) * width;
+					std::copy(srcRow, srcRow + width, destRow);
+				} else {
+					const Voxel* srcRow = srcSlice + (int64_t)y * width;
+					std::copy(srcRow, srcRow + width, destRow);
 				}
 			}
 		}
+	});
+
+	if (!source->boundsValid()) {
+		return destination;
+	}
+	glm::ivec3 boundsMins = source->mins();
+	glm::ivec3 boundsMaxs = source->maxs();
+	const int index = axis == math::Axis::X ? 0 : axis == math::Axis::Y ? 1 : axis == math::Axis::Z ? 2 : -1;
+	if (index != -1) {
+		const int32_t mirroredMins = mins[index] + maxs[index] - boundsMaxs[index];
+		boundsMaxs[index] = mins[index] + maxs[index] - boundsMins[index];
+		boundsMins[index] = mirroredMins;
 	}
+	destination->extendBounds(boundsMins, boundsMaxs);
 	return destination;
 }
 
@@ -0,0 +1,74 @@
+/**
+ * @file
+ */
+
+#include "VolumeSlabs.h"
+#include "core/Concurrency.h"
+#include "core/ThreadPool.h"
+#include "core/Trace.h"
+#include <future>
+#include <mutex>
+#include <vector>
+
+namespace voxel {
+
+/**
+ * @brief Don't hand out slabs that are too small to be worth a task
+ */
+static constexpr int64_t MinVoxelsPerSlab = 64 * 64 * 64;
+
+int slabCount(int32_t lowerZ, int32_t upperZ, int64_t voxelsPerSlice) {
+	const int64_t depth = (int64_t)upperZ - (int64_t)lowerZ + 1;
+	if (depth <= 0) {
+		return 0;
+	}
+	const int64_t voxels = depth * core_max((int64_t)1, voxelsPerSlice);
+	// a few more slabs than threads - the voxels are usually not evenly distributed
+	const int64_t maxSlabs = (int64_t)core::cpus() * 4;
+	return (int)core_max((int64_t)1, core_min(depth, core_min(maxSlabs, voxels / MinVoxelsPerSlab)));
+}
+
+/**
+ * @brief The workers are shared by all callers and only started once a volume is big enough to be split
+ */
+static core::ThreadPool& slabThreadPool() {
+	static core::ThreadPool threadPool(core::cpus(), "VolumeSlabs");
+	static std::once_flag initialized;
+	std::call_once(initialized, [] () { threadPool.init(); });
+	return threadPool;
+}
+
+SlabResult forEachSlab(int32_t lowerZ, int32_t upperZ, int64_t voxelsPerSlice, const SlabFunc& func) {
+	SlabResult result;
+	const int slabs = slabCount(lowerZ, upperZ, voxelsPerSlice);
+	if (slabs <= 0) {
+		return result;
+	}
+	if (slabs == 1) {
+		func(0, lowerZ, upperZ, result);
+		return result;
+	}
+	core_trace_scoped(VolumeSlabs);
+	const int64_t depth = (int64_t)upperZ - (int64_t)lowerZ + 1;
+	std::vector<SlabResult> results(slabs);
+	core::ThreadPool& threadPool = slabThreadPool();
+	std::vector<std::future<void>> futures;
+	futures.reserve(slabs);
+	for (int i = 0; i < slabs; ++i) {
+		const int32_t slabLowerZ = lowerZ + (int32_t)(depth * i / slabs);
+		const int32_t slabUpperZ = lowerZ + (int32_t)(depth * (i + 1) / slabs) - 1;
+		futures.push_back(threadPool.enqueue([&func, &results, i, slabLowerZ, slabUpperZ] () {
+			core_trace_scoped(VolumeSlab);
+			func(i, slabLowerZ, slabUpperZ, results[i]);
+		}));
+	}
+	for (std::future<void>& future : futures) {
+		future.wait();
+	}
+	for (const SlabResult& slabResult : results) {
+		result.add(slabResult);
+	}
+	return result;
+}
+
+}
@@ -0,0 +1,72 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include <glm/vec3.hpp>
+#include <functional>
+#include <limits>
+#include <stdint.h>
+
+namespace voxel {
+
+/**
+ * @brief The area of a volume that was touched while processing one or more slabs
+ */
+struct SlabResult {
+	glm::ivec3 mins { (std::numeric_limits<int32_t>::max)() };
+	glm::ivec3 maxs { (std::numeric_limits<int32_t>::min)() };
+	int changed = 0;
+
+	/**
+	 * @brief Adds @c amount voxels of the row [lowerX, upperX] at the given y and z
+	 */
+	inline void addRow(int32_t lowerX, int32_t upperX, int32_t y, int32_t z, int amount = 1) {
+		mins.x = core_min(mins.x, lowerX);
+		mins.y = core_min(mins.y, y);
+		mins.z = core_min(mins.z, z);
+		maxs.x = core_max(maxs.x, upperX);
+		maxs.y = core_max(maxs.y, y);
+		maxs.z = core_max(maxs.z, z);
+		changed += amount;
+	}
+
+	inline void add(const SlabResult& other) {
+		if (other.changed <= 0) {
+			return;
+		}
+		mins.x = core_min(mins.x, other.mins.x);
+		mins.y = core_min(mins.y, other.mins.y);
+		mins.z = core_min(mins.z, other.mins.z);
+		maxs.x = core_max(maxs.x, other.maxs.x);
+		maxs.y = core_max(maxs.y, other.maxs.y);
+		maxs.z = core_max(maxs.z, other.maxs.z);
+		changed += other.changed;
+	}
+};
+
+/**
+ * @brief Called with the first and the last (inclusive) z slice of a slab
+ * @param[in] slab The index of the slab - the slabs are ordered by z
+ */
+typedef std::function<void(int slab, int32_t lowerZ, int32_t upperZ, SlabResult& result)> SlabFunc;
+
+/**
+ * @brief The amount of slabs that the given z range is split into by forEachSlab()
+ */
+extern int slabCount(int32_t lowerZ, int32_t upperZ, int64_t voxelsPerSlice);
+
+/**
+ * @brief Splits the z range [lowerZ, upperZ] into slabs and processes them in parallel. The slabs
+ * don't overlap - every worker may write the voxels of its own slices without locking.
+ * @param[in] voxelsPerSlice The amount of voxels in one z slice. Small volumes are processed on the
+ * calling thread, because distributing them isn't worth it.
+ * @return The merged results of all slabs
+ * @note @c func must not call forEachSlab() itself - the slabs run on a shared pool
+ * @sa slabCount()
+ */
+extern SlabResult forEachSlab(int32_t lowerZ, int32_t upperZ, int64_t voxelsPerSlice, const SlabFunc& func);
+
+}
@@ -0,0 +1,99 @@
+/**
+ * @file
+ */
+
+#include "core/benchmark/AbstractBenchmark.h"
+#include "voxel/MaterialColor.h"
+#include "voxel/RawVolume.h"
+#include "voxelutil/VolumeCropper.h"
+#include "voxelutil/VolumeMerger.h"
+#include "voxelutil/VolumeRescaler.h"
+#include "voxelutil/VolumeRotator.h"
+
+/**
+ * @brief The transforms that voxedit applies to a whole layer - on a sphere in a 256^3 volume
+ */
+class VolumeTransformBenchmark: public core::AbstractBenchmark {
+protected:
+	static constexpr int Size = 256;
+	voxel::RawVolume* _volume = nullptr;
+
+public:
+	void onCleanupApp() override {
+		delete _volume;
+		_volume = nullptr;
+	}
+
+	bool onInitApp() override {
+		voxel::initDefaultMaterialColors();
+		_volume = new voxel::RawVolume(voxel::Region(0, Size - 1));
+		const glm::ivec3 center(Size / 2);
+		const int radius = Size / 2 - 16;
+		for (int z = 0; z < Size; ++z) {
+			for (int y = 0; y < Size; ++y) {
+				for (int x = 0; x < Size; ++x) {
+					const glm::ivec3 delta = glm::ivec3(x, y, z) - center;
+					if (delta.x * delta.x + delta.y * delta.y + delta.z * delta.z > radius * radius) {
+						continue;
+					}
+					_volume->setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, (x + y + z) & 0xff));
+				}
+			}
+		}
+		return true;
+	}
+};
+
+BENCHMARK_DEFINE_F(VolumeTransformBenchmark, rotateVolume) (benchmark::State& state) {
+	for (auto _ : state) {
+		voxel::RawVolume* v = voxel::rotateVolume(_volume, glm::vec3(0.0f, 45.0f, 0.0f), voxel::Voxel(), _volume->region().getCentref());
+		delete v;
+	}
+}
+
+BENCHMARK_DEFINE_F(VolumeTransformBenchmark, rotateAxis) (benchmark::State& state) {
+	const math::Axis axis = (math::Axis)state.range(0);
+	for (auto _ : state) {
+		voxel::RawVolume* v = voxel::rotateAxis(_volume, axis);
+		delete v;
+	}
+}
+
+BENCHMARK_DEFINE_F(VolumeTransformBenchmark, mirrorAxis) (benchmark::State& state) {
+	const math::Axis axis = (math::Axis)state.range(0);
+	for (auto _ : state) {
+		voxel::RawVolume* v = voxel::mirrorAxis(_volume, axis);
+		delete v;
+	}
+}
+
+BENCHMARK_DEFINE_F(VolumeTransformBenchmark, rescaleVolume) (benchmark::State& state) {
+	for (auto _ : state) {
+		voxel::RawVolume v(voxel::Region(0, Size / 2 - 1));
+		voxel::rescaleVolume(*_volume, v);
+	}
+}
+
+BENCHMARK_DEFINE_F(VolumeTransformBenchmark, mergeVolumes) (benchmark::State& state) {
+	for (auto _ : state) {
+		voxel::RawVolume v(_volume->region());
+		const int voxels = voxel::mergeRawVolumesSameDimension(&v, _volume);
+		benchmark::DoNotOptimize(voxels);
+	}
+}
+
+BENCHMARK_DEFINE_F(VolumeTransformBenchmark, cropVolume) (benchmark::State& state) {
+	for (auto _ : state) {
+		voxel::RawVolume* v = voxel::cropVolume(_volume);
+		delete v;
+	}
+}
+
+BENCHMARK_REGISTER_F(VolumeTransformBenchmark, rotateVolume);
+BENCHMARK_REGISTER_F(VolumeTransformBenchmark, rotateAxis)->Arg((int)math::Axis::X)->Arg((int)math::Axis::Y)->Arg((int)math::Axis::Z);
+BENCHMARK_REGISTER_F(VolumeTransformBenchmark, mirrorAxis)->Arg((int)math::Axis::X)->Arg((int)math::Axis::Y)->Arg((int)math::Axis::Z);
+BENCHMARK_REGISTER_F(VolumeTransformBenchmark, rescaleVolume);
+BENCHMARK_REGISTER_F(VolumeTransformBenchmark, mergeVolumes);
+BENCHMARK_REGISTER_F(VolumeTransformBenchmark, cropVolume);
+
+BENCHMARK_MAIN();
@@ -50,4 +50,33 @@ TEST_F(VolumeCropperTest, testCropBiggerMultiple) {
 	delete croppedVolume;
 }
 
+TEST_F(VolumeCropperTest, testCropParallel) {
+	const voxel::Region region(0, 127);
+	voxel::RawVolume volume(region);
+	const glm::ivec3 mins(12, 40, 7);
+	const glm::ivec3 maxs(100, 41, 120);
+	volume.setVoxel(mins, createVoxel(voxel::VoxelType::Grass, 0));
+	volume.setVoxel(maxs, createVoxel(voxel::VoxelType::Grass, 1));
+	volume.setVoxel(glm::ivec3(50, 41, 60), createVoxel(voxel::VoxelType::Grass, 2));
+	// set and remove a voxel - the bounds of the volume are bigger than the cropped region now
+	volume.setVoxel(region.getUpperCorner(), createVoxel(voxel::VoxelType::Grass, 0));
+	volume.setVoxel(region.getUpperCorner(), voxel::Voxel());
+	voxel::RawVolume *croppedVolume = voxel::cropVolume(&volume);
+	ASSERT_NE(nullptr, croppedVolume) << "Expected to get the cropped raw volume";
+	const voxel::Region& croppedRegion = croppedVolume->region();
+	EXPECT_EQ(croppedRegion.getLowerCorner(), mins) << croppedRegion.toString();
+	EXPECT_EQ(croppedRegion.getUpperCorner(), maxs) << croppedRegion.toString();
+	EXPECT_EQ(croppedVolume->voxel(mins), createVoxel(VoxelType::Grass, 0));
+	EXPECT_EQ(croppedVolume->voxel(maxs), createVoxel(VoxelType::Grass, 1));
+	EXPECT_EQ(croppedVolume->voxel(50, 41, 60), createVoxel(VoxelType::Grass, 2));
+	delete croppedVolume;
+}
+
+TEST_F(VolumeCropperTest, testCropEmpty) {
+	voxel::RawVolume volume(voxel::Region(0, 127));
+	volume.setVoxel(glm::ivec3(10), createVoxel(voxel::VoxelType::Grass, 0));
+	volume.setVoxel(glm::ivec3(10), voxel::Voxel());
+	EXPECT_EQ(nullptr, voxel::cropVolume(&volume)) << "Expected to get no volume for an empty volume";
+}
+
 }
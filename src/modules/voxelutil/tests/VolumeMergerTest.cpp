@@ -57,4 +57,44 @@ TEST_F(VolumeMergerTest, testOffsets) {
 	ASSERT_EQ(smallVolume.voxel(regionSmall.getUpperCorner()), createVoxel(voxel::VoxelType::Grass, 0)) << smallVolume << ", " << bigVolume;
 }
 
+TEST_F(VolumeMergerTest, testMergeParallel) {
+	const voxel::Region srcRegion(0, 95);
+	voxel::RawVolume source(srcRegion);
+	int expected = 0;
+	for (int32_t z = 0; z <= 95; ++z) {
+		for (int32_t y = 0; y <= 95; ++y) {
+			for (int32_t x = 0; x <= 95; ++x) {
+				if ((x * y + z) % 5 != 0) {
+					continue;
+				}
+				ASSERT_TRUE(source.setVoxel(x, y, z, createVoxel(VoxelType::Generic, (x + z) & 0xff)));
+				// the last slice in x, y and z is outside of the destination region
+				if (x < 95 && y < 95 && z < 95) {
+					++expected;
+				}
+			}
+		}
+	}
+
+	voxel::RawVolume destination(voxel::Region(-10, 100));
+	const glm::ivec3 offset(6);
+	const voxel::Region destRegion(offset, offset + srcRegion.getDimensionsInCells() - 1);
+	EXPECT_EQ(expected, voxel::mergeVolumes(&destination, &source, destRegion, srcRegion));
+	EXPECT_EQ(0, voxel::mergeVolumes(&destination, &source, destRegion, srcRegion)) << "The voxels are already merged";
+	for (int32_t z = 0; z <= 95; ++z) {
+		for (int32_t y = 0; y <= 95; ++y) {
+			for (int32_t x = 0; x <= 95; ++x) {
+				const glm::ivec3 destPos = offset + glm::ivec3(x, y, z);
+				if (destRegion.containsPoint(destPos)) {
+					ASSERT_TRUE(destination.voxel(destPos).isSame(source.voxel(x, y, z))) << "Voxel differs at " << x << ":" << y << ":" << z;
+				} else {
+					ASSERT_TRUE(destination.voxel(destPos).isSame(voxel::Voxel())) << "Voxel outside the region at " << x << ":" << y << ":" << z;
+				}
+			}
+		}
+	}
+	EXPECT_EQ(offset, destination.mins());
+	EXPECT_EQ(destRegion.getUpperCorner(), destination.maxs());
+}
+
 }
@@ -0,0 +1,66 @@
+/**
+ * @file
+ */
+
+#include "voxel/tests/AbstractVoxelTest.h"
+#include "voxelutil/VolumeRescaler.h"
+
+namespace voxel {
+
+class VolumeRescalerTest: public AbstractVoxelTest {
+};
+
+TEST_F(VolumeRescalerTest, testRescaleHalfFilled) {
+	const voxel::Region srcRegion(0, 127);
+	voxel::RawVolume source(srcRegion);
+	// the lower half is solid - the upper half is air
+	for (int32_t z = 0; z <= 127; ++z) {
+		for (int32_t y = 0; y < 64; ++y) {
+			for (int32_t x = 0; x <= 127; ++x) {
+				source.setVoxel(x, y, z, createVoxel(VoxelType::Generic, 1));
+			}
+		}
+	}
+	const voxel::Region destRegion(0, 63);
+	voxel::RawVolume destination(destRegion);
+	voxel::rescaleVolume(source, destination);
+	for (int32_t z = 0; z <= 63; ++z) {
+		for (int32_t y = 0; y <= 63; ++y) {
+			for (int32_t x = 0; x <= 63; ++x) {
+				const voxel::Voxel& voxel = destination.voxel(x, y, z);
+				if (y < 32) {
+					ASSERT_EQ(VoxelType::Generic, voxel.getMaterial()) << "Expected a solid voxel at " << x << ":" << y << ":" << z;
+				} else {
+					ASSERT_EQ(VoxelType::Air, voxel.getMaterial()) << "Expected an empty voxel at " << x << ":" << y << ":" << z;
+				}
+			}
+		}
+	}
+	// all the source voxels have the same color - the boundary voxels must keep it
+	const MaterialColorArray& colors = getMaterialColors();
+	const int index = core::Color::getClosestMatch(colors[1], colors);
+	EXPECT_EQ(index, destination.voxel(10, 31, 10).getColor());
+	EXPECT_EQ(index, destination.voxel(0, 0, 0).getColor());
+}
+
+TEST_F(VolumeRescalerTest, testRescaleThinLayer) {
+	const voxel::Region srcRegion(0, 127);
+	voxel::RawVolume source(srcRegion);
+	// a single layer is not enough to get solid voxels in the lower resolution volume
+	for (int32_t z = 0; z <= 127; ++z) {
+		for (int32_t x = 0; x <= 127; ++x) {
+			source.setVoxel(x, 20, z, createVoxel(VoxelType::Generic, 1));
+		}
+	}
+	voxel::RawVolume destination(voxel::Region(0, 63));
+	voxel::rescaleVolume(source, destination);
+	for (int32_t z = 0; z <= 63; ++z) {
+		for (int32_t y = 0; y <= 63; ++y) {
+			for (int32_t x = 0; x <= 63; ++x) {
+				ASSERT_EQ(VoxelType::Air, destination.voxel(x, y, z).getMaterial()) << "Expected an empty voxel at " << x << ":" << y << ":" << z;
+			}
+		}
+	}
+}
+
+}
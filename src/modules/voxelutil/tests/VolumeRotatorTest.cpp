@@ -4,14 +4,33 @@
 
 #include "voxel/tests/AbstractVoxelTest.h"
 #include "voxelutil/VolumeRotator.h"
+#include "core/GLM.h"
 
 namespace voxel {
 
-class VolumeRotatorTest: public core::AbstractTest {
+class VolumeRotatorTest: public AbstractVoxelTest {
 protected:
 	inline std::string str(const voxel::Region& region) const {
 		return "mins(" + glm::to_string(region.getLowerCorner()) + "), maxs(" + glm::to_string(region.getUpperCorner()) + ")";
 	}
+
+	/**
+	 * @brief Fills a volume that is big enough to be processed in parallel slabs with a pattern
+	 * that differs for every axis
+	 */
+	void fill(voxel::RawVolume& volume) const {
+		const voxel::Region& region = volume.region();
+		for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int32_t y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				for (int32_t x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+					if ((x + y + z) % 3 == 0) {
+						continue;
+					}
+					volume.setVoxel(x, y, z, createVoxel(voxel::VoxelType::Generic, (x + y * 3 + z * 7) & 0xff));
+				}
+			}
+		}
+	}
 };
 
 TEST_F(VolumeRotatorTest, testRotateAxisY) {
@@ -82,4 +101,115 @@ TEST_F(VolumeRotatorTest, testRotate90_FourTimes) {
 
 	EXPECT_EQ(*rotated, smallVolume) << "Expected to get the same volume after 360 degree rotation";
 }
+
+TEST_F(VolumeRotatorTest, testRotateAxisParallel) {
+	const voxel::Region region(glm::ivec3(-3, 2, 5), glm::ivec3(92, 73, 68));
+	voxel::RawVolume volume(region);
+	fill(volume);
+	const math::Axis axes[] = {math::Axis::X, math::Axis::Y, math::Axis::Z};
+	for (math::Axis axis : axes) {
+		voxel::RawVolume* rotated = voxel::rotateAxis(&volume, axis);
+		ASSERT_NE(nullptr, rotated) << "No new volume was returned for the desired rotation";
+		const voxel::Region& rotatedRegion = rotated->region();
+		for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int32_t y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				for (int32_t x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+					glm::ivec3 pos(x, y, z);
+					if (axis == math::Axis::X) {
+						std::swap(pos.y, pos.z);
+					} else if (axis == math::Axis::Y) {
+						std::swap(pos.x, pos.z);
+					} else {
+						std::swap(pos.x, pos.y);
+					}
+					ASSERT_TRUE(rotatedRegion.containsPoint(pos)) << str(rotatedRegion);
+					ASSERT_TRUE(rotated->voxel(pos).isSame(volume.voxel(x, y, z))) << "Voxel differs at " << x << ":" << y << ":" << z;
+				}
+			}
+		}
+		delete rotated;
+	}
+}
+
+TEST_F(VolumeRotatorTest, testMirrorAxisParallel) {
+	const voxel::Region region(glm::ivec3(-3, 2, 5), glm::ivec3(92, 73, 68));
+	voxel::RawVolume volume(region);
+	fill(volume);
+	const glm::ivec3& mins = region.getLowerCorner();
+	const glm::ivec3& maxs = region.getUpperCorner();
+	const math::Axis axes[] = {math::Axis::X, math::Axis::Y, math::Axis::Z};
+	for (int i = 0; i < 3; ++i) {
+		voxel::RawVolume* mirrored = voxel::mirrorAxis(&volume, axes[i]);
+		ASSERT_NE(nullptr, mirrored) << "No new volume was returned for the desired mirroring";
+		ASSERT_EQ(region, mirrored->region());
+		for (int32_t z = mins.z; z <= maxs.z; ++z) {
+			for (int32_t y = mins.y; y <= maxs.y; ++y) {
+				for (int32_t x = mins.x; x <= maxs.x; ++x) {
+					glm::ivec3 pos(x, y, z);
+					pos[i] = mins[i] + maxs[i] - pos[i];
+					ASSERT_TRUE(mirrored->voxel(pos).isSame(volume.voxel(x, y, z))) << "Voxel differs at " << x << ":" << y << ":" << z;
+				}
+			}
+		}
+		voxel::RawVolume* mirroredBack = voxel::mirrorAxis(mirrored, axes[i]);
+		EXPECT_EQ(*mirroredBack, volume) << "Mirroring twice should give the source volume";
+		delete mirroredBack;
+		delete mirrored;
+	}
+}
+
+TEST_F(VolumeRotatorTest, testRotateMirrorAxisEmpty) {
+	const voxel::Region region(glm::ivec3(-3, 2, 5), glm::ivec3(12, 7, 9));
+	voxel::RawVolume volume(region);
+	voxel::RawVolume* rotated = voxel::rotateAxis(&volume, math::Axis::Y);
+	ASSERT_NE(nullptr, rotated);
+	EXPECT_FALSE(rotated->boundsValid()) << "Nothing was copied - the bounds must not be extended";
+	EXPECT_EQ(rotated->region().getLowerCorner(), rotated->mins());
+	delete rotated;
+	voxel::RawVolume* mirrored = voxel::mirrorAxis(&volume, math::Axis::X);
+	ASSERT_NE(nullptr, mirrored);
+	EXPECT_FALSE(mirrored->boundsValid()) << "Nothing was copied - the bounds must not be extended";
+	EXPECT_EQ(region.getUpperCorner(), mirrored->maxs());
+	delete mirrored;
+}
+
+TEST_F(VolumeRotatorTest, testRotateVolumeParallel) {
+	const voxel::Region region(0, 95);
+	voxel::RawVolume volume(region);
+	fill(volume);
+	const glm::vec3 angles(10.0f, 30.0f, 0.0f);
+	const glm::vec3& pivot = region.getCentref();
+	voxel::RawVolume* rotated = voxel::rotateVolume(&volume, angles, voxel::Voxel(), pivot);
+	ASSERT_NE(nullptr, rotated) << "No new volume was returned for the desired rotation";
+
+	// the per voxel rotation - if several voxels end up at the same position, the first one wins
+	const glm::mat4& rot = glm::eulerAngleXYZ(glm::radians(angles.x), glm::radians(angles.y), glm::radians(angles.z));
+	voxel::RawVolume expected(rotated->region());
+	for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+		for (int32_t y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+			for (int32_t x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+				const voxel::Voxel& v = volume.voxel(x, y, z);
+				if (v == voxel::Voxel()) {
+					continue;
+				}
+				const glm::ivec3 pos(glm::rotate(rot, glm::vec3(x, y, z) - pivot) + pivot);
+				if (expected.region().containsPoint(pos) && expected.voxel(pos) == voxel::Voxel()) {
+					expected.setVoxel(pos, v);
+				}
+			}
+		}
+	}
+	const voxel::Region& rotatedRegion = rotated->region();
+	for (int32_t z = rotatedRegion.getLowerZ(); z <= rotatedRegion.getUpperZ(); ++z) {
+		for (int32_t y = rotatedRegion.getLowerY(); y <= rotatedRegion.getUpperY(); ++y) {
+			for (int32_t x = rotatedRegion.getLowerX(); x <= rotatedRegion.getUpperX(); ++x) {
+				ASSERT_TRUE(rotated->voxel(x, y, z).isSame(expected.voxel(x, y, z))) << "Voxel differs at " << x << ":" << y << ":" << z;
+			}
+		}
+	}
+	EXPECT_EQ(expected.mins(), rotated->mins());
+	EXPECT_EQ(expected.maxs(), rotated->maxs());
+	delete rotated;
+}
+
 }
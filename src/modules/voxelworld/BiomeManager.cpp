@@ -15,6 +15,8 @@
 #include "voxel/MaterialColor.h"
 #include "BiomeLUAFunctions.h"
 #include "commonlua/LUAFunctions.h"
+#include <algorithm>
+#include <string.h>
 #include <utility>
 
 namespace voxelworld {
@@ -25,7 +27,31 @@ Zone::Zone(const glm::ivec3& pos, float radius, ZoneType type) :
 
 const float BiomeManager::MinCityHeight = (voxel::MAX_WATER_HEIGHT + 1) / (float)(voxel::MAX_TERRAIN_HEIGHT - 1);
 
-BiomeManager::BiomeManager() {
+BiomeManager::BiomeManager() :
+		_treePlacements([this] (const PlacementKey& key) { return createTreePlacement(key); },
+				[] (const TreePlacement& placement) {
+					return sizeof(placement) + placement.treeTypes.size() * sizeof(const char*) + placement.positions.size() * sizeof(glm::vec2);
+				}, nullptr, PlacementCacheBudget) {
+}
+
+bool BiomeManager::PlacementKey::operator==(const PlacementKey& other) const {
+	return mins == other.mins && maxs == other.maxs && seed == other.seed && border == other.border;
+}
+
+size_t BiomeManager::PlacementKeyHash::operator()(const PlacementKey& key) const {
+	size_t seed = 0;
+	auto combine = [&seed] (size_t hash) {
+		hash += 0x9e3779b9 + (seed << 6) + (seed >> 2);
+		seed ^= hash;
+	};
+	const std::hash<int> hasher;
+	for (int i = 0; i < 3; ++i) {
+		combine(hasher(key.mins[i]));
+		combine(hasher(key.maxs[i]));
+	}
+	combine(hasher((int)key.seed));
+	combine(hasher(key.border));
+	return seed;
 }
 
 BiomeManager::~BiomeManager() {
@@ -33,6 +59,7 @@ BiomeManager::~BiomeManager() {
 }
 
 void BiomeManager::shutdown() {
+	clearPlacementCache();
 	_noise.shutdown();
 	_defaultBiome = nullptr;
 	for (const Biome* biome : _biomes) {
@@ -75,6 +102,8 @@ bool BiomeManager::init(const std::string& luaString) {
 		Log::error("Could not execute lua script. Failed with error: %s", lua.error().c_str());
 		return false;
 	}
+	// the biomes might have been modified by the script after they were added
+	clearPlacementCache();
 
 	return !_biomes.empty();
 }
@@ -92,6 +121,7 @@ Biome* BiomeManager::addBiome(int lower, int upper, float humidity, float temper
 	Biome* biome = new Biome(type, int16_t(lower), int16_t(upper),
 			humidity, temperature, underGround, treeDistribution);
 	_biomes.push_back(biome);
+	clearPlacementCache();
 	return biome;
 }
 
@@ -178,6 +208,19 @@ const std::vector<const char*>& BiomeManager::getTreeTypes(const voxel::Region&
 	return biome->treeTypes();
 }
 
+void BiomeManager::getAllTreeTypes(std::vector<const char*>& treeTypes) const {
+	for (const Biome* biome : _biomes) {
+		for (const char *treeType : biome->treeTypes()) {
+			const bool known = std::find_if(treeTypes.begin(), treeTypes.end(), [=] (const char *t) {
+				return strcmp(t, treeType) == 0;
+			}) != treeTypes.end();
+			if (!known) {
+				treeTypes.push_back(treeType);
+			}
+		}
+	}
+}
+
 void BiomeManager::getTreePositions(const voxel::Region& region, std::vector<glm::vec2>& positions, math::Random& random, int border) const {
 	core_trace_scoped(BiomeGetTreePositions);
 	const glm::ivec3& pos = region.getCentre();
@@ -188,6 +231,28 @@ void BiomeManager::getTreePositions(const voxel::Region& region, std::vector<glm
 	distributePointsInRegion(region, positions, random, border, biome->treeDistance);
 }
 
+TreePlacementPtr BiomeManager::getTreePlacement(const voxel::Region& region, unsigned int seed, int border) const {
+	return _treePlacements.get(PlacementKey { region.getLowerCorner(), region.getUpperCorner(), seed, border });
+}
+
+std::shared_ptr<TreePlacement> BiomeManager::createTreePlacement(const PlacementKey& key) const {
+	core_trace_scoped(BiomeCreateTreePlacement);
+	const voxel::Region region(key.mins, key.maxs);
+	const std::shared_ptr<TreePlacement> placement = std::make_shared<TreePlacement>();
+	placement->treeTypes = getTreeTypes(region);
+	if (placement->treeTypes.empty()) {
+		return placement;
+	}
+	math::Random random(key.seed + glm::abs(region.getCentreX() + region.getCentreZ()));
+	random.shuffle(placement->treeTypes.begin(), placement->treeTypes.end());
+	getTreePositions(region, placement->positions, random, key.border);
+	return placement;
+}
+
+void BiomeManager::clearPlacementCache() {
+	_treePlacements.clear();
+}
+
 void BiomeManager::getPlantPositions(const voxel::Region& region, std::vector<glm::vec2>& positions, math::Random& random, int border) const {
 	core_trace_scoped(BiomeGetPlantPositions);
 	const glm::ivec3& pos = region.getCentre();
@@ -262,6 +327,7 @@ int BiomeManager::getCityDensity(const glm::ivec2& pos) const {
 
 void BiomeManager::addZone(const glm::ivec3& pos, float radius, ZoneType type) {
 	_zones[std::enum_value(type)].push_back(new Zone(pos, radius, type));
+	clearPlacementCache();
 }
 
 const Zone* BiomeManager::getZone(const glm::ivec3& pos, ZoneType type) const {
@@ -318,6 +384,7 @@ void BiomeManager::setDefaultBiome(const Biome* biome) {
 		biome = &defaultBiome;
 	}
 	_defaultBiome = biome;
+	clearPlacementCache();
 }
 
 }
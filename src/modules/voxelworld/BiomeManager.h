@@ -7,6 +7,7 @@
 #include "core/Trace.h"
 #include "Biome.h"
 #include "noise/Noise.h"
+#include "core/AssetCache.h"
 #include <glm/glm.hpp>
 #include <memory>
 
@@ -53,15 +54,42 @@ inline float Zone::radius() const {
 	return _radius;
 }
 
+/**
+ * @brief The tree types in the order they are placed and the tree positions of a region
+ */
+struct TreePlacement {
+	std::vector<const char*> treeTypes;
+	std::vector<glm::vec2> positions;
+};
+typedef std::shared_ptr<const TreePlacement> TreePlacementPtr;
+
 class BiomeManager {
 private:
+	struct PlacementKey {
+		glm::ivec3 mins;
+		glm::ivec3 maxs;
+		unsigned int seed;
+		int border;
+
+		bool operator==(const PlacementKey& other) const;
+	};
+	struct PlacementKeyHash {
+		size_t operator()(const PlacementKey& key) const;
+	};
+
 	std::vector<Biome*> _biomes;
 	std::vector<Zone*> _zones[int(ZoneType::Max)];
 	const Biome* _defaultBiome = nullptr;
 	void distributePointsInRegion(const voxel::Region& region, std::vector<glm::vec2>& positions, math::Random& random, int border, float distribution) const;
 	noise::Noise _noise;
+	// the placements are requested by every chunk for itself and its neighbours - from several threads
+	mutable core::AssetCache<TreePlacement, PlacementKey, PlacementKeyHash> _treePlacements;
+
+	std::shared_ptr<TreePlacement> createTreePlacement(const PlacementKey& key) const;
 
 public:
+	static constexpr size_t PlacementCacheBudget = 4u * 1024u * 1024u;
+
 	BiomeManager();
 	~BiomeManager();
 
@@ -96,7 +124,22 @@ public:
 	int getCityDensity(const glm::ivec2& pos) const;
 	float getCityMultiplier(const glm::ivec2& pos, int* targetHeight = nullptr) const;
 	const std::vector<const char*>& getTreeTypes(const voxel::Region& region) const;
+	/**
+	 * @brief The tree types of all biomes - every type is only added once
+	 */
+	void getAllTreeTypes(std::vector<const char*>& treeTypes) const;
 	void getTreePositions(const voxel::Region& region, std::vector<glm::vec2>& positions, math::Random& random, int border) const;
+	/**
+	 * @brief The shuffled tree types and the tree positions for the given region. The random number generator
+	 * is seeded with the given seed and the region position, the result is computed once and shared between
+	 * all callers until it gets evicted from the cache.
+	 * @note If there are no tree types for the region, the positions are not computed.
+	 */
+	TreePlacementPtr getTreePlacement(const voxel::Region& region, unsigned int seed, int border) const;
+	/**
+	 * @brief Drops all cached tree placements - called whenever the biomes change
+	 */
+	void clearPlacementCache();
 	void getPlantPositions(const voxel::Region& region, std::vector<glm::vec2>& positions, math::Random& random, int border) const;
 	void getCloudPositions(const voxel::Region& region, std::vector<glm::vec2>& positions, math::Random& random, int border) const;
 
@@ -0,0 +1,125 @@
+/**
+ * @file
+ */
+
+#include "NavChunk.h"
+#include "voxel/Voxel.h"
+#include "voxel/Constants.h"
+#include "core/Trace.h"
+#include "core/Assert.h"
+
+namespace voxelworld {
+
+NavChunk::NavChunk(const voxel::Region& region) :
+		_region(region), _sideLength(region.getWidthInVoxels()) {
+	core_assert(region.getWidthInVoxels() == region.getDepthInVoxels());
+}
+
+void NavChunk::extract(const voxel::PagedVolume* volume) {
+	core_trace_scoped(NavChunkExtract);
+	const int side = _sideLength;
+	const int height = _region.getHeightInVoxels();
+	const glm::ivec3& mins = _region.getLowerCorner();
+	_columns.resize(side * side + 1);
+	_levels.clear();
+	_nodeColumns.clear();
+	_faces = 0u;
+
+	// don't page in chunks outside of the world height - the space below is solid, the space above is air
+	const int lowerY = (glm::max)(mins.y, voxel::MIN_HEIGHT);
+	const int upperY = (glm::min)(mins.y + height - 1, voxel::MAX_HEIGHT);
+
+	voxel::PagedVolume::Sampler sampler(volume);
+	for (int z = 0; z < side; ++z) {
+		for (int x = 0; x < side; ++x) {
+			const uint32_t column = x + z * side;
+			_columns[column] = (uint32_t)_levels.size();
+			if (lowerY > upperY) {
+				continue;
+			}
+			// walk the column from one voxel below up to one voxel above the region
+			bool below = false;
+			if (lowerY > voxel::MIN_HEIGHT) {
+				sampler.setPosition(mins.x + x, lowerY - 1, mins.z + z);
+				below = voxel::isEnterable(sampler.voxel().getMaterial());
+				sampler.movePositiveY();
+			} else {
+				sampler.setPosition(mins.x + x, lowerY, mins.z + z);
+			}
+			bool current = voxel::isEnterable(sampler.voxel().getMaterial());
+			for (int y = lowerY; y <= upperY; ++y) {
+				bool above = true;
+				if (y < voxel::MAX_HEIGHT) {
+					sampler.movePositiveY();
+					above = voxel::isEnterable(sampler.voxel().getMaterial());
+				}
+				if (current && above && !below) {
+					const int localY = y - mins.y;
+					_levels.push_back((uint16_t)localY);
+					_nodeColumns.push_back(column);
+					if (localY == 0) {
+						_faces |= NegativeY;
+					} else if (localY == height - 1) {
+						_faces |= PositiveY;
+					}
+				}
+				below = current;
+				current = above;
+			}
+			if (_columns[column] != (uint32_t)_levels.size()) {
+				if (x == 0) {
+					_faces |= NegativeX;
+				} else if (x == side - 1) {
+					_faces |= PositiveX;
+				}
+				if (z == 0) {
+					_faces |= NegativeZ;
+				} else if (z == side - 1) {
+					_faces |= PositiveZ;
+				}
+			}
+		}
+	}
+	_columns[side * side] = (uint32_t)_levels.size();
+}
+
+int NavChunk::node(const glm::ivec3& local) const {
+	if (local.x < 0 || local.z < 0 || local.x >= _sideLength || local.z >= _sideLength) {
+		return -1;
+	}
+	const uint32_t column = local.x + local.z * _sideLength;
+	const uint32_t end = _columns[column + 1];
+	for (uint32_t i = _columns[column]; i < end; ++i) {
+		if (_levels[i] == local.y) {
+			return (int)i;
+		}
+	}
+	return -1;
+}
+
+int NavChunk::nodeNear(const glm::ivec3& local, int maxDeltaY) const {
+	if (local.x < 0 || local.z < 0 || local.x >= _sideLength || local.z >= _sideLength) {
+		return -1;
+	}
+	const uint32_t column = local.x + local.z * _sideLength;
+	const uint32_t end = _columns[column + 1];
+	int best = -1;
+	int bestDelta = maxDeltaY + 1;
+	for (uint32_t i = _columns[column]; i < end; ++i) {
+		const int delta = glm::abs((int)_levels[i] - local.y);
+		if (delta < bestDelta) {
+			bestDelta = delta;
+			best = (int)i;
+		}
+	}
+	return best;
+}
+
+glm::ivec3 NavChunk::position(int node) const {
+	const uint32_t column = _nodeColumns[node];
+	const int x = (int)(column % (uint32_t)_sideLength);
+	const int z = (int)(column / (uint32_t)_sideLength);
+	return _region.getLowerCorner() + glm::ivec3(x, _levels[node], z);
+}
+
+}
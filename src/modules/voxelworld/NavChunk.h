@@ -0,0 +1,99 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "voxel/PagedVolume.h"
+#include "voxel/Region.h"
+#include <vector>
+#include <memory>
+#include <stdint.h>
+
+namespace voxelworld {
+
+/**
+ * @brief The walkable surface of one @c voxel::PagedVolume chunk.
+ *
+ * A cell is walkable if the voxel is enterable, the voxel below it is not and there is enough head room
+ * above it (see @c WorldMgr::findWalkableFloor()). The walkable cells are stored per column in flat
+ * arrays: @c _columns holds the offset of the first cell of each (x, z) column in @c _levels, so a node
+ * of the navigation graph is just an index into these arrays.
+ *
+ * @ingroup Voxel
+ */
+class NavChunk {
+public:
+	enum Face : uint8_t {
+		NegativeX = 1 << 0,
+		PositiveX = 1 << 1,
+		NegativeY = 1 << 2,
+		PositiveY = 1 << 3,
+		NegativeZ = 1 << 4,
+		PositiveZ = 1 << 5
+	};
+
+	explicit NavChunk(const voxel::Region& region);
+
+	/**
+	 * @brief Extracts the walkable cells of the region from the given volume
+	 */
+	void extract(const voxel::PagedVolume* volume);
+
+	/**
+	 * @param[in] local The position relative to the lower corner of the region
+	 * @return The node index or @c -1 if the cell isn't walkable
+	 */
+	int node(const glm::ivec3& local) const;
+
+	/**
+	 * @brief Looks for the walkable cell in the column of the given position that is closest to its y value
+	 * @param[in] local The position relative to the lower corner of the region
+	 * @param[in] maxDeltaY The max allowed vertical distance between the given position and the cell
+	 * @return The node index or @c -1 if no such cell exists
+	 */
+	int nodeNear(const glm::ivec3& local, int maxDeltaY) const;
+
+	/**
+	 * @return The world position of the given node
+	 */
+	glm::ivec3 position(int node) const;
+
+	/**
+	 * @return The amount of walkable cells
+	 */
+	inline int nodes() const {
+		return (int)_levels.size();
+	}
+
+	/**
+	 * @return Bitmask of @c Face values for the faces of the region that have walkable cells
+	 * directly at the border - these are the candidates to enter the neighbouring chunks.
+	 */
+	inline uint8_t faces() const {
+		return _faces;
+	}
+
+	inline const voxel::Region& region() const {
+		return _region;
+	}
+
+	inline int sideLength() const {
+		return _sideLength;
+	}
+
+private:
+	voxel::Region _region;
+	int _sideLength;
+	// offset into _levels for every (x, z) column - indexed by x + z * sideLength
+	std::vector<uint32_t> _columns;
+	// the local y coordinate of the walkable cells
+	std::vector<uint16_t> _levels;
+	// the column index of every walkable cell
+	std::vector<uint32_t> _nodeColumns;
+	uint8_t _faces = 0u;
+};
+
+typedef std::shared_ptr<const NavChunk> NavChunkPtr;
+
+}
@@ -0,0 +1,436 @@
+/**
+ * @file
+ */
+
+#include "NavMesh.h"
+#include "core/Trace.h"
+#include "core/Log.h"
+#include "core/Assert.h"
+#include <algorithm>
+#include <functional>
+
+namespace voxelworld {
+
+namespace {
+
+const float DiagonalCost = 1.41421356f;
+const float StepCost = 0.5f;
+
+inline float heuristic(const glm::ivec3& a, const glm::ivec3& b) {
+	const int dx = glm::abs(a.x - b.x);
+	const int dz = glm::abs(a.z - b.z);
+	const int dy = glm::abs(a.y - b.y);
+	const int diagonal = (glm::min)(dx, dz);
+	const int straight = (glm::max)(dx, dz) - diagonal;
+	return (float)straight + (float)diagonal * DiagonalCost + (float)dy * StepCost;
+}
+
+int log2(int value) {
+	int power = 0;
+	while ((1 << power) < value) {
+		++power;
+	}
+	return power;
+}
+
+}
+
+NavMesh::NavMesh(voxel::PagedVolume* volume) :
+		_volume(volume), _sideLengthPower(log2(volume->chunkSideLength())) {
+	core_assert_msg((1 << _sideLengthPower) == volume->chunkSideLength(), "Chunk side length must be a power of two");
+}
+
+glm::ivec3 NavMesh::chunkPos(const glm::ivec3& pos) const {
+	return glm::ivec3(pos.x >> _sideLengthPower, pos.y >> _sideLengthPower, pos.z >> _sideLengthPower);
+}
+
+int NavMesh::size() const {
+	core::ScopedReadLock lock(_lock);
+	return (int)_chunks.size();
+}
+
+NavChunkPtr NavMesh::existingChunk(const glm::ivec3& chunkPos) const {
+	core::ScopedReadLock lock(_lock);
+	auto i = _chunks.find(chunkPos);
+	if (i == _chunks.end()) {
+		return NavChunkPtr();
+	}
+	return i->second;
+}
+
+NavChunkPtr NavMesh::chunk(const glm::ivec3& chunkPos) {
+	NavChunkPtr existing = existingChunk(chunkPos);
+	if (existing) {
+		return existing;
+	}
+	uint32_t sequence;
+	{
+		core::ScopedWriteLock lock(_lock);
+		sequence = ++_extractSequence;
+		_extracting[chunkPos] = sequence;
+	}
+	const int side = 1 << _sideLengthPower;
+	const glm::ivec3 mins = chunkPos * side;
+	const voxel::Region region(mins, mins + side - 1);
+	std::shared_ptr<NavChunk> navChunk = std::make_shared<NavChunk>(region);
+	navChunk->extract(_volume);
+
+	core::ScopedWriteLock lock(_lock);
+	auto i = _extracting.find(chunkPos);
+	if (i == _extracting.end() || i->second != sequence) {
+		// removed, invalidated or extracted again while we were extracting - don't keep the outdated data
+		return navChunk;
+	}
+	_extracting.erase(i);
+	return _chunks.emplace(chunkPos, navChunk).first->second;
+}
+
+bool NavMesh::extract(const glm::ivec3& chunkPos) {
+	if (existingChunk(chunkPos)) {
+		return false;
+	}
+	return (bool)chunk(chunkPos);
+}
+
+void NavMesh::invalidate(const voxel::Region& region) {
+	const glm::ivec3& mins = chunkPos(region.getLowerCorner());
+	const glm::ivec3& maxs = chunkPos(region.getUpperCorner());
+	core::ScopedWriteLock lock(_lock);
+	const uint32_t generation = _generation.fetch_add(1u, std::memory_order_acq_rel) + 1u;
+	// the walkable cells depend on the voxels above and below - so also invalidate the neighbours
+	for (int x = mins.x; x <= maxs.x; ++x) {
+		for (int y = mins.y - 1; y <= maxs.y + 1; ++y) {
+			for (int z = mins.z; z <= maxs.z; ++z) {
+				const glm::ivec3 pos(x, y, z);
+				_chunks.erase(pos);
+				_extracting.erase(pos);
+				_invalidated[pos] = generation;
+			}
+		}
+	}
+}
+
+bool NavMesh::remove(const glm::ivec3& chunkPos) {
+	core::ScopedWriteLock lock(_lock);
+	_extracting.erase(chunkPos);
+	return _chunks.erase(chunkPos) > 0;
+}
+
+void NavMesh::clear() {
+	core::ScopedWriteLock lock(_lock);
+	_chunks.clear();
+	_extracting.clear();
+	// every path is outdated now
+	_invalidated.clear();
+	_generation.fetch_add(1u, std::memory_order_acq_rel);
+	_clearGeneration = _generation.load(std::memory_order_relaxed);
+}
+
+bool NavMesh::invalidatedSince(const std::vector<glm::ivec3>& chunkPositions, uint32_t generation) const {
+	core::ScopedReadLock lock(_lock);
+	if ((int32_t)(_clearGeneration - generation) > 0) {
+		return true;
+	}
+	for (const glm::ivec3& pos : chunkPositions) {
+		auto i = _invalidated.find(pos);
+		if (i != _invalidated.end() && (int32_t)(i->second - generation) > 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool NavMesh::findChunkPath(const glm::ivec3& startChunk, const glm::ivec3& endChunk, std::vector<glm::ivec3>& chunkPath) {
+	core_trace_scoped(NavMeshFindChunkPath);
+	static const struct {
+		glm::ivec3 dir;
+		uint8_t face;
+		uint8_t opposite;
+	} neighbours[] = {
+		{ glm::ivec3(-1, 0, 0), NavChunk::NegativeX, NavChunk::PositiveX },
+		{ glm::ivec3( 1, 0, 0), NavChunk::PositiveX, NavChunk::NegativeX },
+		{ glm::ivec3( 0, 0,-1), NavChunk::NegativeZ, NavChunk::PositiveZ },
+		{ glm::ivec3( 0, 0, 1), NavChunk::PositiveZ, NavChunk::NegativeZ },
+		{ glm::ivec3( 0,-1, 0), NavChunk::NegativeY, NavChunk::PositiveY },
+		{ glm::ivec3( 0, 1, 0), NavChunk::PositiveY, NavChunk::NegativeY }
+	};
+	// the chunk level search is limited to the area around start and end
+	const int margin = 4;
+	const glm::ivec3 mins = (glm::min)(startChunk, endChunk) - glm::ivec3(margin, 1, margin);
+	const glm::ivec3 maxs = (glm::max)(startChunk, endChunk) + glm::ivec3(margin, 1, margin);
+	auto inside = [&] (const glm::ivec3& p) {
+		return glm::all(glm::greaterThanEqual(p, mins)) && glm::all(glm::lessThanEqual(p, maxs));
+	};
+	auto h = [&] (const glm::ivec3& p) {
+		const glm::ivec3& d = glm::abs(p - endChunk);
+		return d.x + d.y + d.z;
+	};
+
+	std::unordered_map<glm::ivec3, int> g;
+	std::unordered_map<glm::ivec3, glm::ivec3> parent;
+	typedef std::pair<int, glm::ivec3> OpenEntry;
+	auto cmp = [] (const OpenEntry& a, const OpenEntry& b) {
+		return a.first > b.first;
+	};
+	std::vector<OpenEntry> open;
+	g[startChunk] = 0;
+	open.emplace_back(h(startChunk), startChunk);
+	while (!open.empty()) {
+		std::pop_heap(open.begin(), open.end(), cmp);
+		const OpenEntry current = open.back();
+		open.pop_back();
+		const glm::ivec3& pos = current.second;
+		if (pos == endChunk) {
+			chunkPath.clear();
+			glm::ivec3 p = pos;
+			chunkPath.push_back(p);
+			while (p != startChunk) {
+				p = parent[p];
+				chunkPath.push_back(p);
+			}
+			std::reverse(chunkPath.begin(), chunkPath.end());
+			return true;
+		}
+		const int currentG = g[pos];
+		if (current.first > currentG + h(pos)) {
+			// outdated entry
+			continue;
+		}
+		const NavChunkPtr& navChunk = chunk(pos);
+		for (const auto& n : neighbours) {
+			if ((navChunk->faces() & n.face) == 0) {
+				continue;
+			}
+			const glm::ivec3& next = pos + n.dir;
+			if (!inside(next)) {
+				continue;
+			}
+			const NavChunkPtr& nextChunk = chunk(next);
+			if ((nextChunk->faces() & n.opposite) == 0) {
+				continue;
+			}
+			const int nextG = currentG + 1;
+			auto gi = g.find(next);
+			if (gi != g.end() && gi->second <= nextG) {
+				continue;
+			}
+			g[next] = nextG;
+			parent[next] = pos;
+			open.emplace_back(nextG + h(next), next);
+			std::push_heap(open.begin(), open.end(), cmp);
+		}
+	}
+	return false;
+}
+
+void NavMesh::addCorridorChunk(const glm::ivec3& chunkPos, SearchContext& ctx) {
+	if (ctx.chunkIndex.find(chunkPos) != ctx.chunkIndex.end()) {
+		return;
+	}
+	const NavChunkPtr& navChunk = chunk(chunkPos);
+	if (navChunk->nodes() == 0) {
+		return;
+	}
+	const int base = ctx.base.empty() ? 0 : ctx.base.back() + ctx.chunks.back()->nodes();
+	ctx.chunkIndex.emplace(chunkPos, (int)ctx.chunks.size());
+	ctx.chunks.push_back(navChunk);
+	ctx.chunkPositions.push_back(chunkPos);
+	ctx.base.push_back(base);
+}
+
+bool NavMesh::findPath(const glm::ivec3& start, const glm::ivec3& end, std::vector<glm::ivec3>& path, SearchContext& ctx, int maxNodes) {
+	core_trace_scoped(NavMeshFindPath);
+	ctx.chunks.clear();
+	ctx.chunkPositions.clear();
+	ctx.base.clear();
+	ctx.chunkIndex.clear();
+
+	const glm::ivec3& startChunk = chunkPos(start);
+	const glm::ivec3& endChunk = chunkPos(end);
+	std::vector<glm::ivec3> chunkPath;
+	if (startChunk == endChunk) {
+		chunkPath.push_back(startChunk);
+	} else if (!findChunkPath(startChunk, endChunk, chunkPath)) {
+		Log::trace("No chunk path from %i:%i:%i to %i:%i:%i", start.x, start.y, start.z, end.x, end.y, end.z);
+		return false;
+	}
+	for (const glm::ivec3& c : chunkPath) {
+		addCorridorChunk(c, ctx);
+	}
+	if (findVoxelPath(start, end, path, ctx, maxNodes)) {
+		return true;
+	}
+	// the path might have to leave the corridor - widen it by the horizontal neighbours and retry
+	const size_t corridorSize = ctx.chunks.size();
+	for (const glm::ivec3& c : chunkPath) {
+		for (int x = -1; x <= 1; ++x) {
+			for (int z = -1; z <= 1; ++z) {
+				for (int y = -1; y <= 1; ++y) {
+					addCorridorChunk(c + glm::ivec3(x, y, z), ctx);
+				}
+			}
+		}
+	}
+	if (corridorSize == ctx.chunks.size()) {
+		return false;
+	}
+	return findVoxelPath(start, end, path, ctx, maxNodes);
+}
+
+bool NavMesh::findVoxelPath(const glm::ivec3& start, const glm::ivec3& end, std::vector<glm::ivec3>& path, SearchContext& ctx, int maxNodes) {
+	core_trace_scoped(NavMeshFindVoxelPath);
+	if (ctx.chunks.empty()) {
+		return false;
+	}
+	const int side = 1 << _sideLengthPower;
+	const int maxDeltaY = 4;
+
+	auto chunkIndex = [&] (const glm::ivec3& pos) {
+		auto i = ctx.chunkIndex.find(chunkPos(pos));
+		if (i == ctx.chunkIndex.end()) {
+			return -1;
+		}
+		return i->second;
+	};
+	const int startIndex = chunkIndex(start);
+	const int endIndex = chunkIndex(end);
+	if (startIndex == -1 || endIndex == -1) {
+		return false;
+	}
+	const int startLocal = ctx.chunks[startIndex]->nodeNear(start - ctx.chunks[startIndex]->region().getLowerCorner(), maxDeltaY);
+	const int endLocal = ctx.chunks[endIndex]->nodeNear(end - ctx.chunks[endIndex]->region().getLowerCorner(), maxDeltaY);
+	if (startLocal == -1 || endLocal == -1) {
+		return false;
+	}
+	const int startNode = ctx.base[startIndex] + startLocal;
+	const int endNode = ctx.base[endIndex] + endLocal;
+	const glm::ivec3& goal = ctx.chunks[endIndex]->position(endLocal);
+
+	const size_t nodes = (size_t)(ctx.base.back() + ctx.chunks.back()->nodes());
+	if (ctx.g.size() < nodes) {
+		ctx.g.resize(nodes);
+		ctx.parent.resize(nodes);
+		ctx.seen.resize(nodes, 0u);
+		ctx.closed.resize(nodes, 0u);
+	}
+	if (++ctx.stamp == 0u) {
+		std::fill(ctx.seen.begin(), ctx.seen.end(), 0u);
+		std::fill(ctx.closed.begin(), ctx.closed.end(), 0u);
+		ctx.stamp = 1u;
+	}
+	const uint32_t stamp = ctx.stamp;
+
+	// the chunk of the current node is checked first - most neighbours are in the same chunk
+	auto lookup = [&] (const glm::ivec3& pos, int hint) {
+		int k = hint;
+		const glm::ivec3& mins = ctx.chunks[k]->region().getLowerCorner();
+		glm::ivec3 local = pos - mins;
+		if (local.x < 0 || local.y < 0 || local.z < 0 || local.x >= side || local.y >= side || local.z >= side) {
+			k = chunkIndex(pos);
+			if (k == -1) {
+				return -1;
+			}
+			local = pos - ctx.chunks[k]->region().getLowerCorner();
+		}
+		const int n = ctx.chunks[k]->node(local);
+		if (n == -1) {
+			return -1;
+		}
+		return ctx.base[k] + n;
+	};
+	auto chunkOf = [&] (int node) {
+		return (int)(std::upper_bound(ctx.base.begin(), ctx.base.end(), node) - ctx.base.begin()) - 1;
+	};
+
+	typedef std::pair<float, int> OpenEntry;
+	std::vector<OpenEntry>& open = ctx.open;
+	open.clear();
+	ctx.g[startNode] = 0.0f;
+	ctx.parent[startNode] = -1;
+	ctx.seen[startNode] = stamp;
+	open.emplace_back(heuristic(ctx.chunks[startIndex]->position(startLocal), goal), startNode);
+
+	static const int dirs[8][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 }, { 1, 1 }, { 1, -1 }, { -1, 1 }, { -1, -1 } };
+	static const int steps[3] = { 0, 1, -1 };
+	int expanded = 0;
+	bool found = false;
+	while (!open.empty()) {
+		std::pop_heap(open.begin(), open.end(), std::greater<OpenEntry>());
+		const int current = open.back().second;
+		open.pop_back();
+		if (ctx.closed[current] == stamp) {
+			continue;
+		}
+		ctx.closed[current] = stamp;
+		if (current == endNode) {
+			found = true;
+			break;
+		}
+		if (++expanded > maxNodes) {
+			break;
+		}
+		const int k = chunkOf(current);
+		const glm::ivec3& pos = ctx.chunks[k]->position(current - ctx.base[k]);
+		const float currentG = ctx.g[current];
+		for (const int* dir : dirs) {
+			const bool diagonal = dir[0] != 0 && dir[1] != 0;
+			if (diagonal) {
+				// don't cut corners
+				if (lookup(pos + glm::ivec3(dir[0], 0, 0), k) == -1 || lookup(pos + glm::ivec3(0, 0, dir[1]), k) == -1) {
+					continue;
+				}
+			}
+			for (int step : steps) {
+				if (diagonal && step != 0) {
+					break;
+				}
+				const glm::ivec3 next(pos.x + dir[0], pos.y + step, pos.z + dir[1]);
+				const int nextNode = lookup(next, k);
+				if (nextNode == -1) {
+					continue;
+				}
+				// there is only one walkable cell in the range [-1, 1] of a column
+				if (ctx.closed[nextNode] == stamp) {
+					break;
+				}
+				const float nextG = currentG + (diagonal ? DiagonalCost : 1.0f) + (step != 0 ? StepCost : 0.0f);
+				if (ctx.seen[nextNode] != stamp || nextG < ctx.g[nextNode]) {
+					ctx.seen[nextNode] = stamp;
+					ctx.g[nextNode] = nextG;
+					ctx.parent[nextNode] = current;
+					open.emplace_back(nextG + heuristic(next, goal), nextNode);
+					std::push_heap(open.begin(), open.end(), std::greater<OpenEntry>());
+				}
+				break;
+			}
+		}
+	}
+	if (!found) {
+		return false;
+	}
+
+	path.clear();
+	for (int node = endNode; node != -1; node = ctx.parent[node]) {
+		const int k = chunkOf(node);
+		path.push_back(ctx.chunks[k]->position(node - ctx.base[k]));
+	}
+	std::reverse(path.begin(), path.end());
+
+	// only keep the positions where the direction changes
+	if (path.size() > 2u) {
+		size_t out = 1u;
+		glm::ivec3 dir = path[1] - path[0];
+		for (size_t i = 1u; i < path.size() - 1u; ++i) {
+			const glm::ivec3 nextDir = path[i + 1u] - path[i];
+			if (nextDir != dir) {
+				path[out++] = path[i];
+				dir = nextDir;
+			}
+		}
+		path[out++] = path.back();
+		path.resize(out);
+	}
+	return true;
+}
+
+}
@@ -0,0 +1,137 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "NavChunk.h"
+#include "voxel/PagedVolume.h"
+#include "core/ReadWriteLock.h"
+#include "core/GLM.h"
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+#include <stdint.h>
+
+namespace voxelworld {
+
+/**
+ * @brief Navigation layer on top of the @c voxel::PagedVolume chunks.
+ *
+ * Every chunk gets a @c NavChunk with its walkable cells. Paths are searched hierarchically: first
+ * on the chunk level to find the corridor of chunks between start and end, then on the voxel level
+ * over the flat node arrays of the chunks in that corridor.
+ *
+ * The nav chunks are immutable once they are extracted - so searches can run on any thread. If voxels
+ * are changed, the affected chunks must be invalidated via @c invalidate(). If a chunk of the volume is
+ * paged out, its nav chunk should be dropped via @c remove() to keep the memory bounded. A nav chunk
+ * that was removed or invalidated while it was extracted is not kept.
+ *
+ * The invalidations are recorded per chunk - a path only has to be searched again if one of the chunks
+ * it was found in was invalidated (see @c invalidatedSince()).
+ *
+ * @ingroup Voxel
+ */
+class NavMesh {
+public:
+	/**
+	 * @brief Scratch memory of a search. Reuse one instance per thread to prevent allocations.
+	 */
+	struct SearchContext {
+		std::vector<NavChunkPtr> chunks;
+		std::vector<glm::ivec3> chunkPositions;
+		std::vector<int> base;
+		std::unordered_map<glm::ivec3, int> chunkIndex;
+		std::vector<float> g;
+		std::vector<int> parent;
+		std::vector<uint32_t> seen;
+		std::vector<uint32_t> closed;
+		std::vector<std::pair<float, int>> open;
+		uint32_t stamp = 0u;
+	};
+
+	explicit NavMesh(voxel::PagedVolume* volume);
+
+	/**
+	 * @return The nav chunk for the given chunk position - extracted on demand
+	 * @note This might page in the volume chunk
+	 */
+	NavChunkPtr chunk(const glm::ivec3& chunkPos);
+
+	/**
+	 * @return The already extracted nav chunk for the given chunk position or an empty pointer
+	 */
+	NavChunkPtr existingChunk(const glm::ivec3& chunkPos) const;
+
+	/**
+	 * @brief Extracts the nav chunk if it's not yet known
+	 * @return @c true if the chunk was extracted
+	 */
+	bool extract(const glm::ivec3& chunkPos);
+
+	/**
+	 * @brief Drops the nav chunks that intersect the given region - they are extracted again on the next access
+	 */
+	void invalidate(const voxel::Region& region);
+
+	/**
+	 * @brief Drops the nav chunk of the given chunk position without changing the generation - the voxels
+	 * are unchanged, so already found paths stay valid.
+	 * @return @c false if there was no nav chunk for the given position
+	 */
+	bool remove(const glm::ivec3& chunkPos);
+
+	/**
+	 * @brief Drops all nav chunks
+	 */
+	void clear();
+
+	/**
+	 * @return @c true if one of the given chunks was invalidated after the given generation
+	 * @sa SearchContext::chunkPositions
+	 */
+	bool invalidatedSince(const std::vector<glm::ivec3>& chunkPositions, uint32_t generation) const;
+
+	/**
+	 * @brief Searches a path between the walkable cells closest to the given positions
+	 * @param[out] path The waypoints from start to end - only the positions where the direction changes are included.
+	 * The chunks that the search used are in @c SearchContext::chunkPositions afterwards.
+	 * @param[in] maxNodes The max amount of voxel nodes that are expanded before the search gives up
+	 * @return @c false if no path was found
+	 * @note This is thread safe
+	 */
+	bool findPath(const glm::ivec3& start, const glm::ivec3& end, std::vector<glm::ivec3>& path, SearchContext& ctx, int maxNodes = 20000);
+
+	/**
+	 * @brief Converts a world position into the chunk position
+	 */
+	glm::ivec3 chunkPos(const glm::ivec3& pos) const;
+
+	/**
+	 * @brief Changed with every invalidation - used to detect outdated cached paths
+	 */
+	inline uint32_t generation() const {
+		return _generation.load(std::memory_order_acquire);
+	}
+
+	int size() const;
+
+private:
+	voxel::PagedVolume* _volume;
+	const int _sideLengthPower;
+	core::ReadWriteLock _lock {"navmesh"};
+	std::unordered_map<glm::ivec3, NavChunkPtr> _chunks;
+	// the nav chunks that are extracted right now - the entry is dropped if the chunk is removed or invalidated meanwhile
+	std::unordered_map<glm::ivec3, uint32_t> _extracting;
+	uint32_t _extractSequence = 0u;
+	// the generation of the last invalidation of a chunk
+	std::unordered_map<glm::ivec3, uint32_t> _invalidated;
+	uint32_t _clearGeneration = 0u;
+	std::atomic_uint _generation { 0u };
+
+	bool findChunkPath(const glm::ivec3& startChunk, const glm::ivec3& endChunk, std::vector<glm::ivec3>& chunkPath);
+	void addCorridorChunk(const glm::ivec3& chunkPos, SearchContext& ctx);
+	bool findVoxelPath(const glm::ivec3& start, const glm::ivec3& end, std::vector<glm::ivec3>& path, SearchContext& ctx, int maxNodes);
+};
+
+}
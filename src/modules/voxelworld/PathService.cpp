@@ -0,0 +1,197 @@
+/**
+ * @file
+ */
+
+#include "PathService.h"
+#include "voxel/Constants.h"
+#include "core/Trace.h"
+#include "core/Log.h"
+
+namespace voxelworld {
+
+PathService::PathService(voxel::PagedVolume* volume, size_t threads, size_t cacheSize) :
+		_navMesh(volume), _volume(volume), _threadPool(threads, "PathService"), _cacheSize(cacheSize) {
+}
+
+PathService::~PathService() {
+	shutdown();
+}
+
+bool PathService::init() {
+	_cancelThreads = false;
+	_jobs.reset();
+	_threadPool.init();
+	for (size_t i = 0u; i < _threadPool.size(); ++i) {
+		_threadPool.enqueue([this] () {work();});
+	}
+	_volume->addChunkListener(this);
+	_initialized = true;
+	return true;
+}
+
+void PathService::shutdown() {
+	if (!_initialized) {
+		return;
+	}
+	_initialized = false;
+	_volume->removeChunkListener(this);
+	_cancelThreads = true;
+	_jobs.clear();
+	_jobs.abortWait();
+	_threadPool.shutdown(true);
+	std::unique_lock lock(_cacheMutex);
+	_cache.clear();
+	_cacheLookup.clear();
+}
+
+void PathService::onCreate(const voxel::PagedVolume::ChunkPtr& chunk) {
+	const voxel::Region& region = chunk->region();
+	// the extraction samples the neighbours above and below - don't page in the whole column
+	if (region.getUpperY() < voxel::MIN_HEIGHT || region.getLowerY() > voxel::MAX_HEIGHT) {
+		return;
+	}
+	Job job;
+	job.type = Job::Type::Extract;
+	job.sequence = _sequence.fetch_add(1u, std::memory_order_relaxed);
+	job.chunkPos = _navMesh.chunkPos(region.getLowerCorner());
+	_jobs.push(std::move(job));
+}
+
+void PathService::onRemove(const voxel::PagedVolume::ChunkPtr& chunk) {
+	if (_navMesh.remove(_navMesh.chunkPos(chunk->region().getLowerCorner()))) {
+		_evictions.fetch_add(1u, std::memory_order_relaxed);
+	}
+}
+
+void PathService::onModified(const voxel::PagedVolume::ChunkPtr& chunk) {
+	_navMesh.invalidate(chunk->region());
+}
+
+bool PathService::valid(const PathRequest& request) const {
+	return !_navMesh.invalidatedSince(request.chunks, request.generation);
+}
+
+PathRequestPtr PathService::request(const glm::ivec3& start, const glm::ivec3& end) {
+	_requests.fetch_add(1u, std::memory_order_relaxed);
+	const PathRequestPtr& request = std::make_shared<PathRequest>(start, end);
+	if (cached(CacheKey{start, end}, *request)) {
+		_cacheHits.fetch_add(1u, std::memory_order_relaxed);
+		request->state.store(PathRequest::State::Found, std::memory_order_release);
+		return request;
+	}
+	Job job;
+	job.type = Job::Type::Path;
+	job.sequence = _sequence.fetch_add(1u, std::memory_order_relaxed);
+	job.request = request;
+	_jobs.push(std::move(job));
+	return request;
+}
+
+bool PathService::findPath(const glm::ivec3& start, const glm::ivec3& end, std::vector<glm::ivec3>& path) {
+	PathRequest request(start, end);
+	NavMesh::SearchContext ctx;
+	resolve(request, ctx);
+	path = std::move(request.path);
+	return request.found();
+}
+
+void PathService::invalidate(const voxel::Region& region) {
+	_navMesh.invalidate(region);
+}
+
+PathService::Stats PathService::stats() const {
+	Stats stats;
+	stats.requests = _requests.load(std::memory_order_relaxed);
+	stats.cacheHits = _cacheHits.load(std::memory_order_relaxed);
+	stats.found = _found.load(std::memory_order_relaxed);
+	stats.failed = _failed.load(std::memory_order_relaxed);
+	stats.extractions = _extractions.load(std::memory_order_relaxed);
+	stats.evictions = _evictions.load(std::memory_order_relaxed);
+	stats.pending = _jobs.size();
+	return stats;
+}
+
+bool PathService::cached(const CacheKey& key, PathRequest& request) {
+	std::unique_lock lock(_cacheMutex);
+	auto i = _cacheLookup.find(key);
+	if (i == _cacheLookup.end()) {
+		return false;
+	}
+	CacheList::iterator entry = i->second;
+	if (_navMesh.invalidatedSince(entry->chunks, entry->generation)) {
+		_cache.erase(entry);
+		_cacheLookup.erase(i);
+		return false;
+	}
+	// move to the front - the back is the least recently used entry
+	_cache.splice(_cache.begin(), _cache, entry);
+	request.path = entry->path;
+	request.chunks = entry->chunks;
+	request.generation = entry->generation;
+	return true;
+}
+
+void PathService::cache(const CacheKey& key, const PathRequest& request) {
+	if (_cacheSize == 0u) {
+		return;
+	}
+	std::unique_lock lock(_cacheMutex);
+	auto i = _cacheLookup.find(key);
+	if (i != _cacheLookup.end()) {
+		i->second->generation = request.generation;
+		i->second->path = request.path;
+		i->second->chunks = request.chunks;
+		_cache.splice(_cache.begin(), _cache, i->second);
+		return;
+	}
+	if (_cache.size() >= _cacheSize) {
+		_cacheLookup.erase(_cache.back().key);
+		_cache.pop_back();
+	}
+	_cache.push_front(CacheEntry{key, request.generation, request.path, request.chunks});
+	_cacheLookup.emplace(key, _cache.begin());
+}
+
+void PathService::resolve(PathRequest& request, NavMesh::SearchContext& ctx) {
+	core_trace_scoped(PathServiceResolve);
+	const CacheKey key{request.start, request.end};
+	if (cached(key, request)) {
+		_cacheHits.fetch_add(1u, std::memory_order_relaxed);
+		request.state.store(PathRequest::State::Found, std::memory_order_release);
+		return;
+	}
+	request.generation = _navMesh.generation();
+	const bool found = _navMesh.findPath(request.start, request.end, request.path, ctx);
+	// don't keep the nav chunks of the corridor alive - they might get evicted
+	ctx.chunks.clear();
+	request.chunks = ctx.chunkPositions;
+	if (!found) {
+		_failed.fetch_add(1u, std::memory_order_relaxed);
+		request.path.clear();
+		request.state.store(PathRequest::State::Failed, std::memory_order_release);
+		return;
+	}
+	_found.fetch_add(1u, std::memory_order_relaxed);
+	cache(key, request);
+	request.state.store(PathRequest::State::Found, std::memory_order_release);
+}
+
+void PathService::work() {
+	NavMesh::SearchContext ctx;
+	while (!_cancelThreads) {
+		Job job;
+		if (!_jobs.waitAndPop(job)) {
+			break;
+		}
+		if (job.type == Job::Type::Path) {
+			resolve(*job.request, ctx);
+			continue;
+		}
+		core_trace_scoped(PathServiceExtract);
+		if (_navMesh.extract(job.chunkPos)) {
+			_extractions.fetch_add(1u, std::memory_order_relaxed);
+		}
+	}
+}
+
+}
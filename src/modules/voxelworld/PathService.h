@@ -0,0 +1,189 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "NavMesh.h"
+#include "voxel/PagedVolume.h"
+#include "core/collection/ConcurrentQueue.h"
+#include "core/ThreadPool.h"
+#include "core/Concurrency.h"
+#include "core/GLM.h"
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace voxelworld {
+
+/**
+ * @brief An async path request. The path is only valid once the request isn't pending anymore.
+ */
+struct PathRequest {
+	enum class State : uint8_t {
+		Pending, Found, Failed
+	};
+
+	PathRequest(const glm::ivec3& _start, const glm::ivec3& _end) :
+			start(_start), end(_end) {
+	}
+
+	const glm::ivec3 start;
+	const glm::ivec3 end;
+	std::vector<glm::ivec3> path;
+	// the chunks the path was found in and the nav mesh generation of the search - see NavMesh::invalidatedSince()
+	std::vector<glm::ivec3> chunks;
+	uint32_t generation = 0u;
+	std::atomic<State> state { State::Pending };
+
+	inline bool pending() const {
+		return state.load(std::memory_order_acquire) == State::Pending;
+	}
+
+	inline bool found() const {
+		return state.load(std::memory_order_acquire) == State::Found;
+	}
+};
+
+typedef std::shared_ptr<PathRequest> PathRequestPtr;
+
+/**
+ * @brief Resolves path requests on worker threads by using the @c NavMesh.
+ *
+ * The nav chunks are extracted in the background whenever a chunk of the volume is paged in and are
+ * dropped again once the chunk is paged out. Path requests are handled before pending chunk extractions. The resolved paths are kept in a
+ * least-recently-used cache that is keyed by start and end position - cached paths are dropped
+ * once one of the chunks they lead through was invalidated. Voxel changes that are done via the volume
+ * invalidate the affected nav chunks automatically.
+ *
+ * @ingroup Voxel
+ */
+class PathService : public voxel::PagedVolume::IChunkListener {
+public:
+	struct Stats {
+		uint64_t requests = 0u;
+		uint64_t cacheHits = 0u;
+		uint64_t found = 0u;
+		uint64_t failed = 0u;
+		uint64_t extractions = 0u;
+		uint64_t evictions = 0u;
+		uint32_t pending = 0u;
+	};
+
+	PathService(voxel::PagedVolume* volume, size_t threads = core::halfcpus(), size_t cacheSize = 4096u);
+	~PathService();
+
+	bool init();
+	void shutdown();
+
+	/**
+	 * @brief Queues a path request. Poll the returned request until it's no longer pending.
+	 * @note Cached paths are returned immediately
+	 */
+	PathRequestPtr request(const glm::ivec3& start, const glm::ivec3& end);
+
+	/**
+	 * @brief Resolves the path on the calling thread
+	 */
+	bool findPath(const glm::ivec3& start, const glm::ivec3& end, std::vector<glm::ivec3>& path);
+
+	/**
+	 * @brief Call this whenever voxels in the given region were changed
+	 */
+	void invalidate(const voxel::Region& region);
+
+	void onCreate(const voxel::PagedVolume::ChunkPtr& chunk) override;
+	void onRemove(const voxel::PagedVolume::ChunkPtr& chunk) override;
+	void onModified(const voxel::PagedVolume::ChunkPtr& chunk) override;
+
+	/**
+	 * @return @c false if one of the chunks of the found path was invalidated since the search
+	 */
+	bool valid(const PathRequest& request) const;
+
+	Stats stats() const;
+
+	inline NavMesh& navMesh() {
+		return _navMesh;
+	}
+
+	inline const NavMesh& navMesh() const {
+		return _navMesh;
+	}
+
+private:
+	struct Job {
+		enum class Type : uint8_t {
+			Extract, Path
+		};
+		Type type = Type::Extract;
+		uint64_t sequence = 0u;
+		PathRequestPtr request;
+		glm::ivec3 chunkPos { 0 };
+	};
+
+	/**
+	 * @brief Path requests come first, then the jobs are handled in the order they were queued.
+	 */
+	struct JobOrder {
+		inline bool operator()(const Job& lhs, const Job& rhs) const {
+			if (lhs.type != rhs.type) {
+				return lhs.type < rhs.type;
+			}
+			return lhs.sequence > rhs.sequence;
+		}
+	};
+
+	struct CacheKey {
+		glm::ivec3 start;
+		glm::ivec3 end;
+		inline bool operator==(const CacheKey& other) const {
+			return start == other.start && end == other.end;
+		}
+	};
+
+	struct CacheKeyHash {
+		inline size_t operator()(const CacheKey& key) const {
+			const std::hash<glm::ivec3> hasher;
+			return hasher(key.start) ^ (hasher(key.end) * 31u);
+		}
+	};
+
+	struct CacheEntry {
+		CacheKey key;
+		uint32_t generation;
+		std::vector<glm::ivec3> path;
+		std::vector<glm::ivec3> chunks;
+	};
+	typedef std::list<CacheEntry> CacheList;
+
+	NavMesh _navMesh;
+	voxel::PagedVolume* _volume;
+	core::ThreadPool _threadPool;
+	core::ConcurrentQueue<Job, JobOrder> _jobs;
+	std::atomic_uint64_t _sequence { 0u };
+	std::atomic_bool _cancelThreads { false };
+	bool _initialized = false;
+
+	const size_t _cacheSize;
+	CacheList _cache;
+	std::unordered_map<CacheKey, CacheList::iterator, CacheKeyHash> _cacheLookup;
+	mutable core_trace_mutex(std::mutex, _cacheMutex);
+
+	std::atomic_uint64_t _requests { 0u };
+	std::atomic_uint64_t _cacheHits { 0u };
+	std::atomic_uint64_t _found { 0u };
+	std::atomic_uint64_t _failed { 0u };
+	std::atomic_uint64_t _extractions { 0u };
+	std::atomic_uint64_t _evictions { 0u };
+
+	void work();
+	bool cached(const CacheKey& key, PathRequest& request);
+	void cache(const CacheKey& key, const PathRequest& request);
+	void resolve(PathRequest& request, NavMesh::SearchContext& ctx);
+};
+
+}
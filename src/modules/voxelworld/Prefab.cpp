@@ -0,0 +1,108 @@
+/**
+ * @file
+ */
+
+#include "Prefab.h"
+#include "voxel/RawVolume.h"
+#include "voxel/Morton.h"
+#include "core/Common.h"
+#include "core/Trace.h"
+#include <algorithm>
+
+namespace voxelworld {
+
+std::shared_ptr<Prefab> Prefab::create(const voxel::RawVolume& volume) {
+	core_trace_scoped(PrefabCreate);
+	const std::shared_ptr<Prefab> prefab = std::make_shared<Prefab>();
+	const voxel::Region& region = volume.region();
+	const glm::ivec3& mins = region.getLowerCorner();
+	const glm::ivec3& maxs = region.getUpperCorner();
+	// x and z outer loops - the columns are sorted by x and then by z
+	for (int x = mins.x; x <= maxs.x; ++x) {
+		for (int z = mins.z; z <= maxs.z; ++z) {
+			Column column { x, z, 0, 0, (uint32_t)prefab->_spans.size(), 0u };
+			Span* span = nullptr;
+			for (int y = mins.y; y <= maxs.y; ++y) {
+				const voxel::Voxel& voxel = volume.voxel(x, y, z);
+				if (voxel::isAir(voxel.getMaterial())) {
+					span = nullptr;
+					continue;
+				}
+				if (span == nullptr) {
+					prefab->_spans.push_back(Span { y, 0, (uint32_t)prefab->_voxels.size() });
+					span = &prefab->_spans.back();
+					if (column.spanCount++ == 0u) {
+						column.lowerY = y;
+					}
+				}
+				prefab->_voxels.push_back(voxel);
+				++span->length;
+				column.upperY = y;
+			}
+			if (column.spanCount == 0u) {
+				continue;
+			}
+			const glm::ivec3 lower(x, column.lowerY, z);
+			const glm::ivec3 upper(x, column.upperY, z);
+			if (prefab->_columns.empty()) {
+				prefab->_region = voxel::Region(lower, upper);
+			} else {
+				prefab->_region.accumulate(lower);
+				prefab->_region.accumulate(upper);
+			}
+			prefab->_columns.push_back(column);
+		}
+	}
+	return prefab;
+}
+
+int Prefab::stamp(voxel::PagedVolume::Chunk& chunk, const glm::ivec3& pos) const {
+	if (_columns.empty()) {
+		return 0;
+	}
+	const voxel::Region& chunkRegion = chunk.region();
+	if (!voxel::intersects(chunkRegion, _region + pos)) {
+		return 0;
+	}
+	core_trace_scoped(PrefabStamp);
+	// the chunk bounds in prefab coordinates
+	const glm::ivec3& mins = chunkRegion.getLowerCorner() - pos;
+	const glm::ivec3& maxs = chunkRegion.getUpperCorner() - pos;
+	const int minX = mins.x;
+	auto first = std::lower_bound(_columns.begin(), _columns.end(), minX, [] (const Column& column, int x) {
+		return column.x < x;
+	});
+	int written = 0;
+	chunk.modify([&] (voxel::Voxel* data) {
+		for (auto i = first; i != _columns.end() && i->x <= maxs.x; ++i) {
+			const Column& column = *i;
+			if (column.z < mins.z || column.z > maxs.z) {
+				continue;
+			}
+			if (column.upperY < mins.y || column.lowerY > maxs.y) {
+				continue;
+			}
+			const uint32_t columnIndex = voxel::morton256_x[column.x - mins.x] | voxel::morton256_z[column.z - mins.z];
+			const Span* span = &_spans[column.spanIndex];
+			const Span* end = span + column.spanCount;
+			for (; span != end; ++span) {
+				const int lowerY = core_max(span->y, mins.y);
+				const int upperY = core_min(span->y + span->length - 1, maxs.y);
+				const voxel::Voxel* voxels = &_voxels[span->voxelIndex + (lowerY - span->y)];
+				for (int y = lowerY; y <= upperY; ++y) {
+					data[columnIndex | voxel::morton256_y[y - mins.y]] = *voxels++;
+				}
+				if (upperY >= lowerY) {
+					written += upperY - lowerY + 1;
+				}
+			}
+		}
+	});
+	return written;
+}
+
+size_t Prefab::sizeInBytes() const {
+	return _columns.size() * sizeof(Column) + _spans.size() * sizeof(Span) + _voxels.size() * sizeof(voxel::Voxel);
+}
+
+}
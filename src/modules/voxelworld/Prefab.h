@@ -0,0 +1,95 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "voxel/PagedVolume.h"
+#include "voxel/Region.h"
+#include "voxel/Voxel.h"
+#include <memory>
+#include <vector>
+
+namespace voxel {
+class RawVolume;
+}
+
+namespace voxelworld {
+
+/**
+ * @brief Sparse, precompiled representation of a model (like a tree) that is stamped into the world chunks.
+ *
+ * Only the runs of non-air voxels along the y axis are stored - grouped by their x and z column. The columns
+ * are sorted by x and z and know their y bounds, this allows to clip a whole prefab against a chunk without
+ * looking at single voxels. The remaining runs are written directly into the chunk memory while the chunk
+ * lock is held only once.
+ */
+class Prefab {
+private:
+	struct Span {
+		int y;
+		int length;
+		// index of the first voxel of this span in the voxel buffer
+		uint32_t voxelIndex;
+	};
+	struct Column {
+		int x;
+		int z;
+		int lowerY;
+		int upperY;
+		uint32_t spanIndex;
+		uint32_t spanCount;
+	};
+	std::vector<Column> _columns;
+	std::vector<Span> _spans;
+	std::vector<voxel::Voxel> _voxels;
+	// the bounds of all non-air voxels
+	voxel::Region _region = voxel::Region::InvalidRegion;
+
+public:
+	/**
+	 * @brief Collects the non-air voxels of the given volume. The prefab coordinates are the volume coordinates.
+	 */
+	static std::shared_ptr<Prefab> create(const voxel::RawVolume& volume);
+
+	/**
+	 * @brief Writes the prefab into the given chunk - the prefab origin is placed at the given world position.
+	 * Everything outside of the chunk is clipped, air voxels of the prefab don't overwrite the chunk voxels.
+	 * @return The amount of voxels that were written into the chunk
+	 */
+	int stamp(voxel::PagedVolume::Chunk& chunk, const glm::ivec3& pos) const;
+
+	/**
+	 * @return The bounds of all non-air voxels - invalid if the prefab is empty
+	 */
+	const voxel::Region& region() const;
+	bool empty() const;
+	size_t columns() const;
+	size_t spans() const;
+	size_t voxels() const;
+	size_t sizeInBytes() const;
+};
+
+inline const voxel::Region& Prefab::region() const {
+	return _region;
+}
+
+inline bool Prefab::empty() const {
+	return _columns.empty();
+}
+
+inline size_t Prefab::columns() const {
+	return _columns.size();
+}
+
+inline size_t Prefab::spans() const {
+	return _spans.size();
+}
+
+inline size_t Prefab::voxels() const {
+	return _voxels.size();
+}
+
+typedef std::shared_ptr<Prefab> PrefabPtr;
+
+}
@@ -2,7 +2,6 @@
  * @file
  */
 #include "WorldPager.h"
-#include "math/Random.h"
 #include "voxel/PagedVolumeWrapper.h"
 #include "voxelutil/Raycast.h"
 #include "noise/Simplex.h"
@@ -13,7 +12,17 @@
 namespace voxelworld {
 
 WorldPager::WorldPager(const voxelformat::VolumeCachePtr& volumeCache) :
-		_volumeCache(volumeCache) {
+		_volumeCache(volumeCache),
+		_prefabs([this] (const std::string& filename) { return loadPrefab(filename); },
+				[] (const Prefab& prefab) { return prefab.sizeInBytes(); }) {
+}
+
+PrefabPtr WorldPager::loadPrefab(const std::string& filename) {
+	const voxelformat::VolumePtr& volume = _volumeCache->loadVolume(filename.c_str());
+	if (!volume) {
+		return PrefabPtr();
+	}
+	return Prefab::create(*volume);
 }
 
 void WorldPager::erase(const voxel::Region& region) {
@@ -61,14 +70,38 @@ bool WorldPager::init(voxel::PagedVolume *volumeData, const std::string& worldPa
 		return false;
 	}
 	_volumeData = volumeData;
+	if (_volumeCache) {
+		// the tree models are needed as soon as the first chunks with trees are paged in
+		std::vector<const char*> treeTypes;
+		_biomeManager.getAllTreeTypes(treeTypes);
+		std::vector<std::string> treeFiles;
+		treeFiles.reserve(treeTypes.size());
+		char filename[64];
+		for (const char *treeType : treeTypes) {
+			if (treeFilename(filename, sizeof(filename), treeType, 1)) {
+				treeFiles.push_back(filename);
+			}
+		}
+		// the cache keeps the loaded volumes - the pending loads are finished by the pool of the cache
+		_volumeCache->prefetch(treeFiles);
+	}
 	return _volumeData != nullptr;
 }
 
+bool WorldPager::treeFilename(char *buf, size_t size, const char *treeType, int treeIndex) {
+	return core::string::formatBuf(buf, size, "models/trees/%s/%i.vox", treeType, treeIndex);
+}
+
 void WorldPager::shutdown() {
 	if (_volumeData != nullptr) {
 		_volumeData->flushAll();
 	}
 	_noise.shutdown();
+	if (_volumeCache) {
+		// the prefetched tree models must not be loaded after the shutdown
+		_volumeCache->waitForLoads();
+	}
+	_prefabs.clear();
 	_volumeData = nullptr;
 	_volumeCache = nullptr;
 	_biomeManager.shutdown();
@@ -187,12 +220,12 @@ static int findFloor(const voxel::PagedVolume* volume, int x, int z) {
 void WorldPager::create(voxel::PagedVolume::PagerContext& pagerCtx) {
 	voxel::PagedVolumeWrapper wrapper(_volumeData, pagerCtx.chunk, pagerCtx.region);
 	core_trace_scoped(CreateWorld);
-	math::Random random(_seed);
 	createWorld(_worldCtx, wrapper, _noiseSeedOffset.x, _noiseSeedOffset.y);
 	placeTrees(pagerCtx);
 }
 
 void WorldPager::placeTrees(voxel::PagedVolume::PagerContext& pagerCtx) {
+	core_trace_scoped(PlaceTrees);
 	// expand region to all surrounding regions by half of the region size.
 	// we do this to be able to limit the generation on the current chunk. Otherwise
 	// we would endlessly generate new chunks just because the trees overlap to
@@ -222,28 +255,22 @@ void WorldPager::placeTrees(voxel::PagedVolume::PagerContext& pagerCtx) {
 	// would have to loop over more regions.
 	core_assert(pagerCtx.region.getLowerY() == 0);
 	core_assert(pagerCtx.region.getUpperY() == voxel::MAX_HEIGHT);
-	voxel::PagedVolumeWrapper wrapper(_volumeData, pagerCtx.chunk, pagerCtx.region);
-	std::vector<const char*> treeTypes;
+	voxel::PagedVolume::Chunk& chunk = *pagerCtx.chunk;
 
 	for (size_t i = 0; i < regions.size(); ++i) {
 		const voxel::Region& region = regions[i];
-		treeTypes = _biomeManager.getTreeTypes(region);
+		const int border = 2;
+		// the placement of a region is shared with the neighbour chunks
+		const TreePlacementPtr& placement = _biomeManager.getTreePlacement(region, _seed, border);
+		const std::vector<const char*>& treeTypes = placement->treeTypes;
 		if (treeTypes.empty()) {
 			Log::debug("No tree types given for region %s", region.toString().c_str());
 			return;
 		}
-		const int border = 2;
-		unsigned int seed = _seed + glm::abs(region.getCentreX() + region.getCentreZ());
-		math::Random random(seed);
-
-		random.shuffle(treeTypes.begin(), treeTypes.end());
-
-		std::vector<glm::vec2> positions;
-		_biomeManager.getTreePositions(region, positions, random, border);
 		int treeTypeIndex = 0;
 		const int regionY = region.getCentreY();
 		const int treeTypeSize = (int)treeTypes.size();
-		for (const glm::vec2& position : positions) {
+		for (const glm::vec2& position : placement->positions) {
 			glm::ivec3 treePos(position.x, regionY, position.y);
 			if (!_volumeData->hasChunk(treePos)) {
 				continue;
@@ -260,40 +287,16 @@ void WorldPager::placeTrees(voxel::PagedVolume::PagerContext& pagerCtx) {
 			// TODO: this hardcoded 10... no way
 			const int treeIndex = 1 ; //random.random(1, 10);
 			char filename[64];
-			if (!core::string::formatBuf(filename, sizeof(filename), "models/trees/%s/%i.vox", treeType, treeIndex)) {
+			if (!treeFilename(filename, sizeof(filename), treeType, treeIndex)) {
 				Log::error("Failed to assemble tree path");
 				continue;
 			}
-			const voxel::RawVolume* v = _volumeCache->loadVolume(filename);
-			if (v == nullptr) {
+			const core::AssetCache<Prefab>::AssetPtr& prefab = _prefabs.get(filename);
+			if (!prefab) {
 				continue;
 			}
 			Log::debug("region %i: final treepos: %3i:%3i:%3i", (int)i, treePos.x, treePos.y, treePos.z);
-			addVolumeToPosition(wrapper, v, treePos);
-		}
-	}
-}
-
-void WorldPager::addVolumeToPosition(voxel::PagedVolumeWrapper& target, const voxel::RawVolume* source, const glm::ivec3& pos) {
-	const voxel::Region& region = source->region();
-	const glm::ivec3& mins = region.getLowerCorner();
-	const glm::ivec3& maxs = region.getUpperCorner();
-	const voxel::Region& targetRegion = target.region();
-	for (int x = mins.x; x <= maxs.x; ++x) {
-		const int nx = pos.x + x;
-		for (int y = mins.y; y <= maxs.y; ++y) {
-			const int ny = pos.y + y;
-			for (int z = mins.z; z <= maxs.z; ++z) {
-				const int nz = pos.z + z;
-				if (!targetRegion.containsPoint(nx, ny, nz)) {
-					continue;
-				}
-				const voxel::Voxel& voxel = source->voxel(x, y, z);
-				if (voxel::isAir(voxel.getMaterial())) {
-					continue;
-				}
-				target.setVoxel(nx, ny, nz, voxel);
-			}
+			prefab->stamp(chunk, treePos);
 		}
 	}
 }
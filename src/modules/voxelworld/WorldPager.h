@@ -12,11 +12,12 @@
 #include "core/Log.h"
 #include "noise/Noise.h"
 #include "BiomeManager.h"
+#include "Prefab.h"
+#include "core/AssetCache.h"
 #include <memory>
 
 namespace voxel {
 class PagedVolumeWrapper;
-class RawVolume;
 }
 
 namespace voxelworld {
@@ -38,6 +39,8 @@ private:
 	WorldContext _worldCtx;
 	noise::Noise _noise;
 	voxelformat::VolumeCachePtr _volumeCache;
+	// the tree models compiled for stamping them into the chunks
+	core::AssetCache<Prefab> _prefabs;
 
 	// don't access the volume in anything that is called here
 	void create(voxel::PagedVolume::PagerContext& pagerCtx);
@@ -45,7 +48,8 @@ private:
 	// use a 2d noise to switch between different noises - to generate steep mountains
 	void createWorld(const WorldContext& worldCtx, voxel::PagedVolumeWrapper& volume, int noiseSeedOffsetX, int noiseSeedOffsetZ) const;
 	void placeTrees(voxel::PagedVolume::PagerContext& pagerCtx);
-	void addVolumeToPosition(voxel::PagedVolumeWrapper& target, const voxel::RawVolume* source, const glm::ivec3& pos);
+	PrefabPtr loadPrefab(const std::string& filename);
+	static bool treeFilename(char *buf, size_t size, const char *treeType, int treeIndex);
 
 	int fillVoxels(int x, int y, int z, const WorldContext& worldCtx, voxel::Voxel* voxels, int noiseSeedOffsetX, int noiseSeedOffsetZ, int maxHeight) const;
 	float getHeight(const glm::vec2& noisePos2d, const WorldContext& worldCtx) const;
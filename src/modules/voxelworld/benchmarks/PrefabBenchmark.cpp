@@ -0,0 +1,105 @@
+/**
+ * @file
+ */
+
+#include "core/benchmark/AbstractBenchmark.h"
+#include "voxelworld/Prefab.h"
+#include "voxel/PagedVolume.h"
+#include "voxel/PagedVolumeWrapper.h"
+#include "voxel/MaterialColor.h"
+#include "voxelformat/VolumeCache.h"
+
+/**
+ * @brief Places the tree models at the positions of a chunk and its eight neighbours - like the WorldPager does
+ * for every new chunk. Only the trees that overlap the chunk in the center end up in the chunk.
+ */
+class PrefabBenchmark: public core::AbstractBenchmark {
+protected:
+	class Pager: public voxel::PagedVolume::Pager {
+	public:
+		bool pageIn(voxel::PagedVolume::PagerContext& ctx) override {
+			return false;
+		}
+
+		void pageOut(voxel::PagedVolume::Chunk* chunk) override {
+		}
+	};
+
+	static constexpr int ChunkSize = 64;
+	Pager _pager;
+	voxel::PagedVolume* _volume = nullptr;
+	voxelformat::VolumeCachePtr _volumeCache;
+	voxelformat::VolumePtr _tree;
+	voxelworld::PrefabPtr _prefab;
+	std::vector<glm::ivec3> _positions;
+
+public:
+	void onCleanupApp() override {
+		delete _volume;
+		_volume = nullptr;
+		_tree = voxelformat::VolumePtr();
+		_prefab = voxelworld::PrefabPtr();
+		if (_volumeCache) {
+			_volumeCache->shutdown();
+		}
+	}
+
+	bool onInitApp() override {
+		voxel::initDefaultMaterialColors();
+		_volumeCache = std::make_shared<voxelformat::VolumeCache>();
+		_tree = _volumeCache->loadVolume("models/trees/pine/1.vox");
+		if (!_tree) {
+			return false;
+		}
+		_prefab = voxelworld::Prefab::create(*_tree);
+		_volume = new voxel::PagedVolume(&_pager, 64 * 1024 * 1024, ChunkSize);
+		// a tree every 8 voxels in the chunk and half of the neighbour chunks
+		for (int x = -ChunkSize / 2; x < ChunkSize + ChunkSize / 2; x += 8) {
+			for (int z = -ChunkSize / 2; z < ChunkSize + ChunkSize / 2; z += 8) {
+				_positions.emplace_back(x, 8, z);
+			}
+		}
+		return true;
+	}
+};
+
+BENCHMARK_DEFINE_F(PrefabBenchmark, stampVoxels) (benchmark::State& state) {
+	const voxel::PagedVolume::ChunkPtr& chunk = _volume->chunk(glm::ivec3(0));
+	voxel::PagedVolumeWrapper wrapper(_volume, chunk, chunk->region());
+	const voxel::Region& region = _tree->region();
+	const glm::ivec3& mins = region.getLowerCorner();
+	const glm::ivec3& maxs = region.getUpperCorner();
+	for (auto _ : state) {
+		// the per voxel approach that was used before the prefabs were compiled
+		for (const glm::ivec3& pos : _positions) {
+			for (int x = mins.x; x <= maxs.x; ++x) {
+				for (int y = mins.y; y <= maxs.y; ++y) {
+					for (int z = mins.z; z <= maxs.z; ++z) {
+						if (!wrapper.region().containsPoint(pos.x + x, pos.y + y, pos.z + z)) {
+							continue;
+						}
+						const voxel::Voxel& voxel = _tree->voxel(x, y, z);
+						if (voxel::isAir(voxel.getMaterial())) {
+							continue;
+						}
+						wrapper.setVoxel(pos.x + x, pos.y + y, pos.z + z, voxel);
+					}
+				}
+			}
+		}
+	}
+}
+
+BENCHMARK_DEFINE_F(PrefabBenchmark, stampPrefab) (benchmark::State& state) {
+	const voxel::PagedVolume::ChunkPtr& chunk = _volume->chunk(glm::ivec3(0));
+	for (auto _ : state) {
+		int voxels = 0;
+		for (const glm::ivec3& pos : _positions) {
+			voxels += _prefab->stamp(*chunk, pos);
+		}
+		benchmark::DoNotOptimize(voxels);
+	}
+}
+
+BENCHMARK_REGISTER_F(PrefabBenchmark, stampVoxels);
+BENCHMARK_REGISTER_F(PrefabBenchmark, stampPrefab);
@@ -95,4 +95,38 @@ TEST_F(BiomeManagerTest, testCityGradient) {
 		<< "Out of the radius of the city - here we should not have any influence on the height anymore";
 }
 
+TEST_F(BiomeManagerTest, testTreePlacement) {
+	BiomeManager mgr;
+	const io::FilesystemPtr& filesystem = _testApp->filesystem();
+	ASSERT_TRUE(mgr.init(filesystem->load("biomes.lua")));
+	const unsigned int seed = 42u;
+	const int border = 2;
+	size_t trees = 0u;
+	for (int x = -1; x <= 1; ++x) {
+		for (int z = -1; z <= 1; ++z) {
+			const voxel::Region region(x * 64, 0, z * 64, x * 64 + 63, voxel::MAX_HEIGHT, z * 64 + 63);
+			const TreePlacementPtr& placement = mgr.getTreePlacement(region, seed, border);
+			ASSERT_NE(nullptr, placement.get());
+			EXPECT_EQ(placement, mgr.getTreePlacement(region, seed, border)) << "The placement should only be computed once";
+
+			// the uncached computation
+			std::vector<const char*> treeTypes = mgr.getTreeTypes(region);
+			if (treeTypes.empty()) {
+				EXPECT_TRUE(placement->treeTypes.empty());
+				continue;
+			}
+			math::Random random(seed + glm::abs(region.getCentreX() + region.getCentreZ()));
+			random.shuffle(treeTypes.begin(), treeTypes.end());
+			std::vector<glm::vec2> positions;
+			mgr.getTreePositions(region, positions, random, border);
+			EXPECT_EQ(treeTypes, placement->treeTypes);
+			EXPECT_EQ(positions, placement->positions);
+			trees += positions.size();
+		}
+	}
+	EXPECT_GT(trees, 0u);
+	const voxel::Region region(0, 0, 0, 63, voxel::MAX_HEIGHT, 63);
+	EXPECT_NE(mgr.getTreePlacement(region, seed, border), mgr.getTreePlacement(region, seed + 1u, border));
+}
+
 }
@@ -0,0 +1,236 @@
+/**
+ * @file
+ */
+
+#include "core/tests/AbstractTest.h"
+#include "voxel/PagedVolume.h"
+#include "voxelworld/NavMesh.h"
+#include "voxelworld/PathService.h"
+#include <chrono>
+#include <functional>
+#include <thread>
+
+namespace voxelworld {
+
+class NavMeshTest: public core::AbstractTest {
+protected:
+	class Pager: public voxel::PagedVolume::Pager {
+		NavMeshTest* _test;
+	public:
+		Pager(NavMeshTest* test) :
+				_test(test) {
+		}
+
+		bool pageIn(voxel::PagedVolume::PagerContext& ctx) override {
+			return _test->pageIn(ctx.region, ctx.chunk);
+		}
+
+		void pageOut(voxel::PagedVolume::Chunk* chunk) override {
+		}
+	};
+
+	Pager _pager;
+	voxel::PagedVolume _volData;
+	// called after a chunk was paged in
+	std::function<void(const voxel::Region&)> _pagedIn;
+
+	NavMeshTest() :
+			_pager(this), _volData(&_pager, 128 * 1024 * 1024, 64) {
+	}
+
+	static constexpr int GroundHeight = 10;
+	static constexpr int WallX = 70;
+	static constexpr int WallMinZ = -64;
+	static constexpr int WallMaxZ = 100;
+	static constexpr int WallHeight = 40;
+
+	bool isWall(const glm::ivec3& pos) const {
+		return pos.x == WallX && pos.z >= WallMinZ && pos.z <= WallMaxZ && pos.y < WallHeight;
+	}
+
+	// flat ground with a wall that must be walked around
+	bool pageIn(const voxel::Region& region, const voxel::PagedVolume::ChunkPtr& chunk) {
+		const voxel::Voxel ground = voxel::createVoxel(voxel::VoxelType::Grass, 0);
+		const glm::ivec3& mins = region.getLowerCorner();
+		for (int z = 0; z < region.getDepthInVoxels(); ++z) {
+			for (int y = 0; y < region.getHeightInVoxels(); ++y) {
+				for (int x = 0; x < region.getWidthInVoxels(); ++x) {
+					const glm::ivec3 pos = mins + glm::ivec3(x, y, z);
+					if ((pos.y >= 0 && pos.y < GroundHeight) || isWall(pos)) {
+						chunk->setVoxel(x, y, z, ground);
+					}
+				}
+			}
+		}
+		if (_pagedIn) {
+			_pagedIn(region);
+		}
+		return true;
+	}
+
+	void validatePath(const std::vector<glm::ivec3>& path, const glm::ivec3& start, const glm::ivec3& end) {
+		ASSERT_GE(path.size(), 2u);
+		EXPECT_EQ(start, path.front());
+		EXPECT_EQ(end, path.back());
+		for (size_t i = 1; i < path.size(); ++i) {
+			const glm::ivec3& from = path[i - 1];
+			const glm::ivec3& to = path[i];
+			const glm::ivec3& delta = to - from;
+			const int steps = (glm::max)(glm::abs(delta.x), glm::abs(delta.z));
+			ASSERT_GT(steps, 0);
+			for (int s = 0; s <= steps; ++s) {
+				const glm::ivec3 pos = from + delta * s / steps;
+				ASSERT_FALSE(isWall(pos)) << "path crosses the wall at " << glm::to_string(pos);
+			}
+		}
+	}
+};
+
+TEST_F(NavMeshTest, testChunkExtraction) {
+	NavMesh navMesh(&_volData);
+	const NavChunkPtr& chunk = navMesh.chunk(glm::ivec3(0));
+	ASSERT_TRUE(chunk);
+	EXPECT_EQ(64 * 64, chunk->nodes());
+	EXPECT_EQ(NavChunk::NegativeX | NavChunk::PositiveX | NavChunk::NegativeZ | NavChunk::PositiveZ, chunk->faces());
+	const int node = chunk->node(glm::ivec3(5, GroundHeight, 7));
+	ASSERT_NE(-1, node);
+	EXPECT_EQ(glm::ivec3(5, GroundHeight, 7), chunk->position(node));
+	EXPECT_EQ(-1, chunk->node(glm::ivec3(5, GroundHeight + 1, 7)));
+	EXPECT_EQ(node, chunk->nodeNear(glm::ivec3(5, GroundHeight + 3, 7), 3));
+	EXPECT_EQ(-1, chunk->nodeNear(glm::ivec3(5, GroundHeight + 4, 7), 3));
+}
+
+TEST_F(NavMeshTest, testFindPathAroundWall) {
+	NavMesh navMesh(&_volData);
+	NavMesh::SearchContext ctx;
+	std::vector<glm::ivec3> path;
+	const glm::ivec3 start(10, GroundHeight, 10);
+	const glm::ivec3 end(120, GroundHeight, 10);
+	ASSERT_TRUE(navMesh.findPath(start, end, path, ctx));
+	validatePath(path, start, end);
+	bool aroundWall = false;
+	for (const glm::ivec3& p : path) {
+		if (p.z > WallMaxZ) {
+			aroundWall = true;
+		}
+	}
+	EXPECT_TRUE(aroundWall);
+}
+
+TEST_F(NavMeshTest, testFindPathSnapsToFloor) {
+	NavMesh navMesh(&_volData);
+	NavMesh::SearchContext ctx;
+	std::vector<glm::ivec3> path;
+	ASSERT_TRUE(navMesh.findPath(glm::ivec3(10, GroundHeight + 2, 10), glm::ivec3(-40, GroundHeight - 1, -20), path, ctx));
+	validatePath(path, glm::ivec3(10, GroundHeight, 10), glm::ivec3(-40, GroundHeight, -20));
+	EXPECT_FALSE(navMesh.findPath(glm::ivec3(10, GroundHeight + 20, 10), glm::ivec3(20, GroundHeight, 10), path, ctx));
+}
+
+TEST_F(NavMeshTest, testInvalidate) {
+	NavMesh navMesh(&_volData);
+	navMesh.chunk(glm::ivec3(0));
+	navMesh.chunk(glm::ivec3(1, 0, 0));
+	EXPECT_EQ(2, navMesh.size());
+	const uint32_t generation = navMesh.generation();
+	navMesh.invalidate(voxel::Region(glm::ivec3(10), glm::ivec3(20)));
+	EXPECT_EQ(1, navMesh.size());
+	EXPECT_NE(generation, navMesh.generation());
+	EXPECT_FALSE(navMesh.existingChunk(glm::ivec3(0)));
+	EXPECT_TRUE(navMesh.existingChunk(glm::ivec3(1, 0, 0)));
+}
+
+TEST_F(NavMeshTest, testPathServiceEviction) {
+	PathService service(&_volData);
+	NavMesh& navMesh = service.navMesh();
+	navMesh.chunk(glm::ivec3(0));
+	navMesh.chunk(glm::ivec3(1, 0, 0));
+	EXPECT_EQ(2, navMesh.size());
+	const uint32_t generation = navMesh.generation();
+	// a paged out chunk drops its nav chunk - but the voxels didn't change
+	service.onRemove(_volData.chunk(glm::ivec3(0)));
+	EXPECT_EQ(1, navMesh.size());
+	EXPECT_EQ(generation, navMesh.generation());
+	EXPECT_FALSE(navMesh.existingChunk(glm::ivec3(0)));
+	EXPECT_EQ(1u, service.stats().evictions);
+	EXPECT_FALSE(navMesh.remove(glm::ivec3(0)));
+}
+
+TEST_F(NavMeshTest, testRemoveWhileExtracting) {
+	NavMesh navMesh(&_volData);
+	// the volume chunk is paged in by the extraction - and paged out again before the nav chunk is finished
+	_pagedIn = [&] (const voxel::Region& region) {
+		if (navMesh.chunkPos(region.getLowerCorner()) == glm::ivec3(0)) {
+			navMesh.remove(glm::ivec3(0));
+		}
+	};
+	EXPECT_TRUE(navMesh.chunk(glm::ivec3(0)));
+	_pagedIn = nullptr;
+	EXPECT_FALSE(navMesh.existingChunk(glm::ivec3(0))) << "The outdated nav chunk must not be kept";
+	EXPECT_EQ(0, navMesh.size());
+	EXPECT_TRUE(navMesh.extract(glm::ivec3(0)));
+	EXPECT_EQ(1, navMesh.size());
+}
+
+TEST_F(NavMeshTest, testPathServiceModified) {
+	PathService service(&_volData);
+	ASSERT_TRUE(service.init());
+	NavMesh& navMesh = service.navMesh();
+	const PathRequestPtr& request = service.request(glm::ivec3(10, GroundHeight, 10), glm::ivec3(20, GroundHeight, 20));
+	while (request->pending()) {
+		std::this_thread::yield();
+	}
+	ASSERT_TRUE(request->found());
+	ASSERT_EQ(std::vector<glm::ivec3>{glm::ivec3(0)}, request->chunks);
+	EXPECT_TRUE(service.valid(*request));
+	navMesh.chunk(glm::ivec3(2, 0, 0));
+	const uint32_t generation = navMesh.generation();
+	const std::vector<glm::ivec3> otherChunks { glm::ivec3(2, 0, 0) };
+
+	// a voxel change via the volume invalidates only the nav chunks around it
+	_volData.setVoxel(glm::ivec3(15, GroundHeight, 15), voxel::createVoxel(voxel::VoxelType::Grass, 0));
+	EXPECT_NE(generation, navMesh.generation());
+	EXPECT_FALSE(navMesh.existingChunk(glm::ivec3(0)));
+	EXPECT_TRUE(navMesh.existingChunk(glm::ivec3(2, 0, 0)));
+	EXPECT_FALSE(service.valid(*request));
+	EXPECT_FALSE(navMesh.invalidatedSince(otherChunks, generation)) << "Paths in other chunks must not be replanned";
+	service.shutdown();
+}
+
+TEST_F(NavMeshTest, testPathServiceRequests) {
+	PathService service(&_volData);
+	ASSERT_TRUE(service.init());
+	const int n = 2000;
+	std::vector<PathRequestPtr> requests;
+	requests.reserve(n);
+	const auto start = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < n; ++i) {
+		const glm::ivec3 from(i % 50, GroundHeight, (i / 50) % 40);
+		const glm::ivec3 to(WallX - 1 - (i % 20), GroundHeight, -20 + (i % 30));
+		requests.push_back(service.request(from, to));
+	}
+	for (const PathRequestPtr& request : requests) {
+		while (request->pending()) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			const std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+			ASSERT_LT(elapsed.count(), 60.0 * 1000.0) << "Took too long to resolve the path requests";
+		}
+		ASSERT_TRUE(request->found());
+		validatePath(request->path, request->start, request->end);
+	}
+	const std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+	Log::info("Resolved %i path requests in %f ms", n, elapsed.count());
+
+	const PathRequestPtr& cached = service.request(requests[0]->start, requests[0]->end);
+	EXPECT_TRUE(cached->found()) << "Expected the path to be cached";
+	const PathService::Stats& stats = service.stats();
+	EXPECT_EQ((uint64_t)n + 1u, stats.requests);
+	EXPECT_GE(stats.cacheHits, 1u);
+	EXPECT_EQ(0u, stats.failed);
+
+	service.invalidate(voxel::Region(requests[0]->start, requests[0]->start));
+	service.request(requests[0]->start, requests[0]->end);
+	EXPECT_EQ(stats.cacheHits, service.stats().cacheHits) << "Expected the cached path to be dropped";
+	service.shutdown();
+}
+
+}
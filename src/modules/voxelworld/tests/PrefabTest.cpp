@@ -0,0 +1,65 @@
+/**
+ * @file
+ */
+
+#include "AbstractVoxelTest.h"
+#include "voxelworld/Prefab.h"
+
+namespace voxelworld {
+
+class PrefabTest: public AbstractVoxelTest {
+protected:
+	voxel::RawVolume _tree { voxel::Region(glm::ivec3(0), glm::ivec3(3)) };
+	const voxel::Voxel _wood = voxel::createVoxel(voxel::VoxelType::Wood, 1);
+	const voxel::Voxel _leaf = voxel::createVoxel(voxel::VoxelType::Leaf, 2);
+
+	void SetUp() override {
+		AbstractVoxelTest::SetUp();
+		// a trunk with a gap at y = 2 and a single leaf
+		_tree.setVoxel(1, 0, 1, _wood);
+		_tree.setVoxel(1, 1, 1, _wood);
+		_tree.setVoxel(1, 3, 1, _wood);
+		_tree.setVoxel(2, 2, 3, _leaf);
+	}
+};
+
+TEST_F(PrefabTest, testCreate) {
+	const PrefabPtr& prefab = Prefab::create(_tree);
+	ASSERT_FALSE(prefab->empty());
+	EXPECT_EQ(2u, prefab->columns());
+	EXPECT_EQ(3u, prefab->spans());
+	EXPECT_EQ(4u, prefab->voxels());
+	EXPECT_EQ(voxel::Region(1, 0, 1, 2, 3, 3), prefab->region());
+
+	const PrefabPtr& empty = Prefab::create(voxel::RawVolume(voxel::Region(glm::ivec3(0), glm::ivec3(3))));
+	EXPECT_TRUE(empty->empty());
+	EXPECT_FALSE(empty->region().isValid());
+	EXPECT_EQ(0, empty->stamp(*_ctx.chunk(), glm::ivec3(0)));
+}
+
+TEST_F(PrefabTest, testStamp) {
+	const PrefabPtr& prefab = Prefab::create(_tree);
+	const voxel::PagedVolume::ChunkPtr& chunk = _ctx.chunk();
+	// the center of the chunk is filled with grass
+	ASSERT_EQ(voxel::VoxelType::Grass, chunk->voxel(32, 33, 32).getMaterial());
+	EXPECT_EQ(4, prefab->stamp(*chunk, glm::ivec3(31)));
+	EXPECT_EQ(_wood, chunk->voxel(32, 31, 32));
+	EXPECT_EQ(_wood, chunk->voxel(32, 32, 32));
+	EXPECT_EQ(voxel::VoxelType::Grass, chunk->voxel(32, 33, 32).getMaterial()) << "Air must not overwrite the chunk voxels";
+	EXPECT_EQ(_wood, chunk->voxel(32, 34, 32));
+	EXPECT_EQ(_leaf, chunk->voxel(33, 33, 34));
+}
+
+TEST_F(PrefabTest, testClip) {
+	const PrefabPtr& prefab = Prefab::create(_tree);
+	const voxel::PagedVolume::ChunkPtr& chunk = _ctx.chunk();
+	EXPECT_EQ(2, prefab->stamp(*chunk, glm::ivec3(-1, 62, -1)));
+	EXPECT_EQ(_wood, chunk->voxel(0, 62, 0));
+	EXPECT_EQ(_wood, chunk->voxel(0, 63, 0));
+	EXPECT_EQ(0, prefab->stamp(*chunk, glm::ivec3(64, 0, 0)));
+	EXPECT_EQ(0, prefab->stamp(*chunk, glm::ivec3(-3, 0, 0)));
+	EXPECT_EQ(1, prefab->stamp(*chunk, glm::ivec3(-2, 0, -3)));
+	EXPECT_EQ(_leaf, chunk->voxel(0, 2, 0));
+}
+
+}
@@ -6,6 +6,7 @@
 
 #include "core/io/Filesystem.h"
 #include "core/Var.h"
+#include "core/TimerWheel.h"
 #include "core/command/Command.h"
 #include "cooldown/CooldownProvider.h"
 #include "network/ServerNetwork.h"
@@ -50,6 +51,13 @@ core::AppState Server::onConstruct() {
 	core::Var::get(cfg::ServerHost, "0.0.0.0");
 	core::Var::get(cfg::ServerMaxClients, "1024");
 	core::Var::get(cfg::ServerSeed, "1");
+	core::Var::get(cfg::ServerBatchedMovement, "true");
+	core::Var::get(cfg::ServerNetworkThread, "true");
+	core::Var::get(cfg::ServerPeerBudget, "4096");
+	core::Var::get(cfg::ServerBandwidth, "0");
+	core::Var::get(cfg::ServerTickBudget, "50");
+	core::Var::get(cfg::ServerAIDebugInterval, "100");
+	core::Var::get(cfg::ServerAIDebugMaxPending, "1048576");
 	core::Var::get(cfg::VoxelMeshSize, "16", core::CV_READONLY);
 	core::Var::get(cfg::DatabaseMinConnections, "2");
 	core::Var::get(cfg::DatabaseMaxConnections, "100");
@@ -93,6 +101,7 @@ core::AppState Server::onRunning() {
 int main(int argc, char *argv[]) {
 	const core::EventBusPtr& eventBus = std::make_shared<core::EventBus>();
 	const core::TimeProviderPtr& timeProvider = std::make_shared<core::TimeProvider>();
+	const core::TimerWheelPtr& timerWheel = std::make_shared<core::TimerWheel>();
 	const io::FilesystemPtr& filesystem = std::make_shared<io::Filesystem>();
 	const backend::AIRegistryPtr& registry = std::make_shared<backend::AIRegistry>();
 	const attrib::ContainerProviderPtr& containerProvider = std::make_shared<attrib::ContainerProvider>();
@@ -110,16 +119,16 @@ int main(int argc, char *argv[]) {
 	const persistence::PersistenceMgrPtr& persistenceMgr = std::make_shared<persistence::PersistenceMgr>(dbHandler);
 	const backend::EntityStoragePtr& entityStorage = std::make_shared<backend::EntityStorage>(eventBus);
 	const voxelformat::VolumeCachePtr& volumeCache = std::make_shared<voxelformat::VolumeCache>();
-	const backend::MapProviderPtr& mapProvider = std::make_shared<backend::MapProvider>(filesystem, eventBus, timeProvider,
+	const backend::MapProviderPtr& mapProvider = std::make_shared<backend::MapProvider>(filesystem, eventBus, timeProvider, timerWheel,
 			entityStorage, messageSender, loader, containerProvider, cooldownProvider, persistenceMgr, volumeCache);
 
 	const eventmgr::EventProviderPtr& eventProvider = std::make_shared<eventmgr::EventProvider>(dbHandler);
-	const eventmgr::EventMgrPtr& eventMgr = std::make_shared<eventmgr::EventMgr>(eventProvider, timeProvider);
+	const eventmgr::EventMgrPtr& eventMgr = std::make_shared<eventmgr::EventMgr>(eventProvider, timeProvider, timerWheel);
 
 	const backend::WorldPtr& world = std::make_shared<backend::World>(mapProvider, registry, eventBus, filesystem);
 	const metric::MetricPtr& metric = std::make_shared<metric::Metric>();
 	const backend::MetricMgrPtr& metricMgr = std::make_shared<backend::MetricMgr>(metric, eventBus);
-	const backend::ServerLoopPtr& serverLoop = std::make_shared<backend::ServerLoop>(timeProvider, mapProvider,
+	const backend::ServerLoopPtr& serverLoop = std::make_shared<backend::ServerLoop>(timeProvider, timerWheel, mapProvider,
 			messageSender, world, dbHandler, network, filesystem, entityStorage, eventBus, containerProvider,
 			cooldownProvider, eventMgr, stockDataProvider, metricMgr, persistenceMgr, volumeCache);
 
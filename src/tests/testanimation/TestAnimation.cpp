@@ -209,9 +209,12 @@ bool TestAnimation::addItem(stock::ItemId id) {
 		Log::error("Failed to get item with id %i", (int)id);
 		return false;
 	}
-	const stock::ItemPtr& item = _stockDataProvider->createItem(itemData->id());
-	_stock.inventory().remove(containerData->id, 0, 0);
-	if (!_stock.inventory().add(containerData->id, item, 0, 0)) {
+	const stock::ItemHandle old = _stock.inventory().remove(containerData->id, 0, 0);
+	if (const stock::Item* oldItem = _stock.item(old)) {
+		_stock.remove(old, oldItem->amount());
+	}
+	const stock::Item& item = _stockDataProvider->createItem(itemData->id(), 1);
+	if (!_stock.add(item, containerData->id, 0, 0).isValid()) {
 		Log::error("Failed to add item to inventory");
 		return false;
 	}
@@ -102,8 +102,13 @@ core::AppState ComputeShaderTool::onRunning() {
 		_exitCode = 1;
 		return core::AppState::Cleanup;
 	}
+	std::string hostSource;
+	if (!computeshadertool::translateHostSource(computeSrcSource, _computeFilename, _structs, hostSource)) {
+		Log::info("No host implementation for %s", _computeFilename.c_str());
+		hostSource.clear();
+	}
 	const std::string& templateShader = filesystem()->load(_shaderTemplateFile);
-	if (!computeshadertool::generateSrc(filesystem(), templateShader, _name, _namespaceSrc, _shaderDirectory, _sourceDirectory, _kernels, _structs, _constants, _postfix, computeBuffer.first)) {
+	if (!computeshadertool::generateSrc(filesystem(), templateShader, _name, _namespaceSrc, _shaderDirectory, _sourceDirectory, _kernels, _structs, _constants, _postfix, computeBuffer.first, hostSource)) {
 		_exitCode = 100;
 		return core::AppState::Cleanup;
 	}
@@ -325,6 +325,96 @@ static void generateStructs(const std::vector<Struct>& _structs, std::stringstre
 	}
 }
 
+/**
+ * @brief The type of the kernel parameter in the host code - without the pointer and the qualifiers
+ */
+static std::string getHostType(const Parameter& p) {
+	std::vector<std::string> tokens;
+	core::string::splitString(core::string::replaceAll(p.type, "*", " "), tokens, " ");
+	std::string type;
+	for (const std::string& token : tokens) {
+		if (token == "struct" || token == "global" || token == "local" || token == "constant" || token == "private") {
+			continue;
+		}
+		if (!type.empty()) {
+			type.append(" ");
+		}
+		type.append(token);
+	}
+	if (p.qualifier == "const") {
+		return "const " + type;
+	}
+	return type;
+}
+
+static void generateHostKernel(const Kernel& k, const std::string& hostNamespace, std::stringstream& hostKernels) {
+	hostKernels << "/**\n";
+	hostKernels << " * @brief Host implementation of the kernel '" << k.name << "'\n";
+	hostKernels << " */\n";
+	hostKernels << "inline void " << k.name << "(const compute::HostKernelArg* args, const compute::HostWorkRange& range) {\n";
+	for (size_t i = 0; i < k.parameters.size(); ++i) {
+		const Parameter& p = k.parameters[i];
+		const std::string& type = getHostType(p);
+		if (isBuffer(p.type)) {
+			hostKernels << "\t" << type << "* " << p.name << " = compute::host::buffer<" << type << ">(args[" << i << "]);\n";
+		} else {
+			std::string valueType = type;
+			if (core::string::startsWith(valueType, "const ")) {
+				valueType = valueType.substr(6);
+			}
+			hostKernels << "\tconst " << valueType << " " << p.name << " = compute::host::value<" << valueType << ">(args[" << i << "]);\n";
+		}
+	}
+	hostKernels << "\tcompute::host::forEachWorkItem(range, [&] () {\n";
+	hostKernels << "\t\t" << hostNamespace << "::" << k.name << "(";
+	for (size_t i = 0; i < k.parameters.size(); ++i) {
+		if (i > 0) {
+			hostKernels << ", ";
+		}
+		hostKernels << k.parameters[i].name;
+	}
+	hostKernels << ");\n";
+	hostKernels << "\t});\n";
+	hostKernels << "}\n";
+}
+
+/**
+ * @brief Generates the c++ version of the kernels for the host backend of the compute module
+ */
+static void generateHostSource(const std::vector<Kernel>& _kernels, const std::vector<Struct>& _structs,
+		const std::string& namespaceSrc, const std::string& name, const std::string& hostSource,
+		std::stringstream& hostKernels, std::stringstream& registerHostKernels) {
+	if (hostSource.empty()) {
+		registerHostKernels << "\t// no host implementation available\n";
+		return;
+	}
+	const std::string hostNamespace = "priv" + name;
+	hostKernels << "namespace compute {\n";
+	hostKernels << "namespace host {\n";
+	hostKernels << "namespace " << hostNamespace << " {\n";
+	// internal linkage for the functions of the kernel source - just like for the shader buffer
+	hostKernels << "namespace {\n\n";
+	for (const Struct& s : _structs) {
+		if (s.isEnum) {
+			continue;
+		}
+		hostKernels << "typedef ::" << namespaceSrc << "::" << name << "::" << s.name << " " << s.name << ";\n";
+	}
+	hostKernels << hostSource << "\n\n";
+	hostKernels << "namespace entry {\n\n";
+	for (const Kernel& k : _kernels) {
+		generateHostKernel(k, hostNamespace, hostKernels);
+		hostKernels << "\n";
+		registerHostKernels << "\tcompute::registerHostKernel(program, \"" << k.name << "\", compute::host::";
+		registerHostKernels << hostNamespace << "::entry::" << k.name << ", " << k.parameters.size() << ");\n";
+	}
+	hostKernels << "}\n\n";
+	hostKernels << "}\n";
+	hostKernels << "}\n";
+	hostKernels << "}\n";
+	hostKernels << "}\n";
+}
+
 static void generateKernel(const Kernel& k, std::stringstream& kernels, BodyType type) {
 	if (type == BodyType::Video) {
 		kernels << "#ifdef COMPUTEVIDEO\n";
@@ -348,7 +438,8 @@ bool generateSrc(const io::FilesystemPtr& filesystem,
 		const std::vector<Struct>& _structs,
 		const std::map<std::string, std::string>& _constants,
 		const std::string& postfix,
-		const std::string& shaderBuffer) {
+		const std::string& shaderBuffer,
+		const std::string& hostSource) {
 	const std::string name = _name + "Shader";
 
 	std::vector<std::string> shaderNameParts;
@@ -414,6 +505,10 @@ bool generateSrc(const io::FilesystemPtr& filesystem,
 	std::stringstream structs;
 	generateStructs(_structs, structs);
 
+	std::stringstream hostKernels;
+	std::stringstream registerHostKernels;
+	generateHostSource(_kernels, _structs, namespaceSrc, filename, hostSource, hostKernels, registerHostKernels);
+
 	std::string src(templateShader);
 	src = core::string::replaceAll(src, "$constant", "//");
 	src = core::string::replaceAll(src, "$name$", filename);
@@ -424,7 +519,10 @@ bool generateSrc(const io::FilesystemPtr& filesystem,
 	src = core::string::replaceAll(src, "$shutdown$", shutdown.str());
 	src = core::string::replaceAll(src, "$structs$", structs.str());
 	src = core::string::replaceAll(src, "$createkernels$", createKernels.str());
+	src = core::string::replaceAll(src, "$registerhostkernels$", registerHostKernels.str());
 	src = core::string::replaceAll(src, "$shaderbuffer$", maxStringLength(shaderBuffer));
+	// last - the kernel code must not be touched by the placeholder replacements
+	src = core::string::replaceAll(src, "$hostkernels$", hostKernels.str());
 	const std::string targetFile = sourceDirectory + filename + ".h" + postfix;
 	Log::info("Generate shader bindings for %s at %s", _name.c_str(), targetFile.c_str());
 	if (!filesystem->syswrite(targetFile, src)) {
@@ -6,6 +6,7 @@
 #include "core/Log.h"
 #include "core/Assert.h"
 #include "core/String.h"
+#include "core/Common.h"
 #include "Types.h"
 #include "Util.h"
 #include <simplecpp.h>
@@ -418,6 +419,158 @@ static const simplecpp::Token *parseKernel(const std::string& filename, const si
 	return tok;
 }
 
+static bool isHostStruct(const std::string& name, const std::vector<Struct>& structs) {
+	for (const Struct& s : structs) {
+		if (!s.isEnum && s.name == name) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief OpenCL features that don't have an equivalent in the host code
+ */
+static bool isHostUnsupported(const std::string& token) {
+	static const char* unsupported[] = {
+		"image1d_t", "image2d_t", "image3d_t", "sampler_t",
+		"barrier", "mem_fence", "read_mem_fence", "write_mem_fence",
+		"get_local_id", "get_local_size", "get_group_id", "get_num_groups",
+		"async_work_group_copy", "__attribute__", nullptr
+	};
+	for (const char** t = unsupported; *t != nullptr; ++t) {
+		if (token == *t) {
+			return true;
+		}
+	}
+	return core::string::startsWith(token, "atomic_") || core::string::startsWith(token, "atom_");
+}
+
+/**
+ * @brief Address space and access qualifiers that are just dropped for the host code
+ */
+static bool isHostIgnored(const std::string& token) {
+	static const char* ignored[] = {
+		"__kernel", "kernel", "__global", "global", "__local", "local", "__private", "private",
+		"__read_only", "read_only", "__write_only", "write_only", "__read_write", "read_write", nullptr
+	};
+	for (const char** t = ignored; *t != nullptr; ++t) {
+		if (token == *t) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool translateHostSource(const std::string& buffer, const std::string& computeFilename,
+		const std::vector<Struct>& structs, std::string& hostSource) {
+	simplecpp::DUI dui;
+	simplecpp::OutputList outputList;
+	std::vector<std::string> files;
+	std::stringstream f(buffer);
+	simplecpp::TokenList rawtokens(f, files, computeFilename, &outputList);
+	std::map<std::string, simplecpp::TokenList*> included = simplecpp::load(rawtokens, files, dui, &outputList);
+	simplecpp::TokenList output(files);
+	simplecpp::preprocess(output, rawtokens, files, included, dui, &outputList);
+
+	std::stringstream src;
+	int depth = 0;
+	bool success = true;
+	const simplecpp::Token *prev = nullptr;
+	for (const simplecpp::Token *tok = output.cfront(); tok != nullptr; tok = tok->next) {
+		if (tok->comment) {
+			continue;
+		}
+		const std::string& token = tok->str();
+		if (isHostUnsupported(token)) {
+			Log::debug("%s:%i:%i: %s is not supported for the host code",
+					tok->location.file().c_str(), tok->location.line, tok->location.col, token.c_str());
+			success = false;
+			break;
+		}
+		if (tok->op == '#' && (prev == nullptr || !prev->location.sameline(tok->location))) {
+			// pragmas and other directives that survived the preprocessor
+			const simplecpp::Token *directive = tok;
+			while (tok->next != nullptr && tok->next->location.sameline(directive->location)) {
+				tok = tok->next;
+			}
+			continue;
+		}
+		if (token == "$constant") {
+			for (int i = 0; i < 2 && tok->next != nullptr; ++i) {
+				tok = tok->next;
+			}
+			continue;
+		}
+		if (isHostIgnored(token)) {
+			continue;
+		}
+		std::string hostToken = token;
+		if (token == "__constant" || token == "constant") {
+			// const variables at namespace scope have internal linkage in c++
+			hostToken = "const";
+		} else if (token == "struct" && tok->next != nullptr && isHostStruct(tok->next->str(), structs)) {
+			const simplecpp::Token *next = tok->next->nextSkipComments();
+			if (next != nullptr && next->op == ';') {
+				// forward declaration
+				tok = next;
+				continue;
+			}
+			if (next != nullptr && next->op == '{') {
+				// the struct definition is replaced by the one of the shader wrapper - it has the
+				// same memory layout as the buffers that are passed to the kernels
+				int structDepth = 0;
+				for (tok = next; tok != nullptr; tok = tok->next) {
+					if (tok->op == '{') {
+						++structDepth;
+					} else if (tok->op == '}' && --structDepth == 0) {
+						break;
+					}
+				}
+				while (tok != nullptr && tok->op != ';') {
+					tok = tok->next;
+				}
+				if (tok == nullptr) {
+					break;
+				}
+				continue;
+			}
+			// not needed in c++ and invalid for a typedef name
+			continue;
+		} else if (token == "(" && tok->next != nullptr && util::isVectorType(tok->next->str())
+				&& tok->next->next != nullptr && tok->next->next->op == ')'
+				&& tok->next->next->next != nullptr && tok->next->next->next->op == '(') {
+			// vector literals like (float2)(1.0f, 2.0f) would be a cast of the comma operator result
+			hostToken = tok->next->str();
+			tok = tok->next->next;
+		}
+
+		if (hostToken == "}") {
+			--depth;
+		}
+		if (prev != nullptr) {
+			if (tok->location.fileIndex != prev->location.fileIndex || tok->location.line > prev->location.line) {
+				src << "\n" << std::string(core_max(depth, 0), '\t');
+			} else if ((prev->name || prev->number) && (tok->name || tok->number)) {
+				src << " ";
+			} else if (prev->location.sameline(tok->location) && prev->location.col + prev->str().size() < tok->location.col) {
+				src << " ";
+			}
+		}
+		if (hostToken == "{") {
+			++depth;
+		}
+		src << hostToken;
+		prev = tok;
+	}
+	simplecpp::cleanup(included);
+	if (!success) {
+		return false;
+	}
+	hostSource = src.str();
+	return true;
+}
+
 bool parse(const std::string& buffer, const std::string& computeFilename, std::vector<Kernel>& kernels,
 		std::vector<Struct>& structs, std::map<std::string, std::string>& constants) {
 	simplecpp::DUI dui;
@@ -17,4 +17,17 @@ extern bool parse(const std::string& buffer,
 		std::vector<Struct>& structs,
 		std::map<std::string, std::string>& constants);
 
+/**
+ * @brief Translates the OpenCL source into C++ code for the host backend of the compute module.
+ *
+ * The code relies on the types and builtins of @c compute/HostBuiltins.h. The definitions of the
+ * given structs are removed - the shader wrapper types are used instead.
+ *
+ * @return @c false if the source uses features that are not available in the host code (like images).
+ */
+extern bool translateHostSource(const std::string& buffer,
+		const std::string& computeFilename,
+		const std::vector<Struct>& structs,
+		std::string& hostSource);
+
 }
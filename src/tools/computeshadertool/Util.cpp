@@ -134,6 +134,24 @@ int alignment(const std::string& type) {
 	return 1;
 }
 
+bool isVectorType(const std::string& token) {
+	const size_t size = token.size();
+	if (size < 2) {
+		return false;
+	}
+	const char components = token[size - 1];
+	if (components != '2' && components != '3' && components != '4') {
+		return false;
+	}
+	const std::string& base = token.substr(0, size - 1);
+	for (const TypeMapping* t = Types; t->computeType != nullptr; ++t) {
+		if (base == t->computeType) {
+			return base != "half";
+		}
+	}
+	return false;
+}
+
 CLTypeMapping vectorType(const std::string& type) {
 	if (type.empty()) {
 		static const CLTypeMapping mapping = CLTypeMapping();
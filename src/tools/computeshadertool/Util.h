@@ -20,6 +20,11 @@ extern CLTypeMapping vectorType(const std::string& type);
 
 extern int alignment(const std::string& type);
 
+/**
+ * @return @c true if the given token is the name of an OpenCL vector type like @c float3
+ */
+extern bool isVectorType(const std::string& token);
+
 /**
  * @brief convert the given input string into lower- or upper-camel-case
  * @param in The string to convert
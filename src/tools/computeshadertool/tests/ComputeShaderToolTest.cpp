@@ -5,6 +5,7 @@
 #include "core/tests/AbstractTest.h"
 #include "compute/Types.h"
 #include "../Util.h"
+#include "../Parser.h"
 
 namespace computeshadertool {
 
@@ -39,4 +40,35 @@ TEST_F(ComputeShaderToolTest, testToString) {
 			util::toString(compute::BufferFlag::ReadWrite | compute::BufferFlag::ReadOnly));
 }
 
+TEST_F(ComputeShaderToolTest, testIsVectorType) {
+	EXPECT_TRUE(util::isVectorType("float3"));
+	EXPECT_TRUE(util::isVectorType("uchar4"));
+	EXPECT_FALSE(util::isVectorType("float"));
+	EXPECT_FALSE(util::isVectorType("half2"));
+}
+
+TEST_F(ComputeShaderToolTest, testTranslateHostSource) {
+	const std::string source = "struct Foo {\n  float x;\n};\n"
+		"__kernel void test(__global float2* out, __global const struct Foo* foo) {\n"
+		"  out[get_global_id(0)] = (float2)(foo[0].x, 1.0f);\n"
+		"}\n";
+	std::vector<Kernel> kernels;
+	std::vector<Struct> structs;
+	std::map<std::string, std::string> constants;
+	ASSERT_TRUE(parse(source, "test.cl", kernels, structs, constants));
+	std::string hostSource;
+	ASSERT_TRUE(translateHostSource(source, "test.cl", structs, hostSource));
+	EXPECT_EQ(std::string::npos, hostSource.find("__kernel"));
+	EXPECT_EQ(std::string::npos, hostSource.find("__global"));
+	EXPECT_EQ(std::string::npos, hostSource.find("struct")) << hostSource;
+	EXPECT_NE(std::string::npos, hostSource.find("float2(")) << hostSource;
+}
+
+TEST_F(ComputeShaderToolTest, testTranslateHostSourceImage) {
+	const std::string source = "__kernel void test(__write_only image2d_t img) {\n"
+		"}\n";
+	std::string hostSource;
+	EXPECT_FALSE(translateHostSource(source, "test.cl", {}, hostSource));
+}
+
 }
@@ -0,0 +1,262 @@
+/**
+ * @file
+ */
+
+#include "LoadGen.h"
+#include "Samples.h"
+#include "network/IProtocolHandler.h"
+#include "core/io/Filesystem.h"
+#include "core/JSON.h"
+#include "core/String.h"
+#include "core/Common.h"
+#include "core/Log.h"
+#include "engine-config.h"
+
+namespace {
+
+/**
+ * @brief Dispatches the server messages to the @c loadgen::SimulatedUser that is attached to the peer
+ */
+class ServerMessageHandler : public network::IProtocolHandler {
+private:
+	const network::ServerMsgType _type;
+public:
+	ServerMessageHandler(network::ServerMsgType type) :
+			_type(type) {
+	}
+
+	void execute(ENetPeer* peer, const void* message) override {
+		loadgen::SimulatedUser* user = getAttachment<loadgen::SimulatedUser>(peer);
+		if (user == nullptr) {
+			return;
+		}
+		user->onMessage(_type, message);
+	}
+};
+
+}
+
+LoadGen::LoadGen(const metric::MetricPtr& metric, const io::FilesystemPtr& filesystem, const core::EventBusPtr& eventBus, const core::TimeProviderPtr& timeProvider) :
+		Super(metric, filesystem, eventBus, timeProvider), _protocolHandlerRegistry(std::make_shared<network::ProtocolHandlerRegistry>()) {
+	init(ORGANISATION, "loadgen");
+}
+
+core::AppState LoadGen::onConstruct() {
+	registerArg("--host").setDescription("The server host").setDefaultValue("127.0.0.1");
+	registerArg("--port").setShort("-p").setDescription("The server port").setDefaultValue(SERVER_PORT);
+	registerArg("--clients").setShort("-c").setDescription("The amount of simulated users").setDefaultValue("100");
+	registerArg("--connectrate").setDescription("The amount of users that connect per second").setDefaultValue("100");
+	registerArg("--duration").setShort("-d").setDescription("Seconds to run after all users are spawned").setDefaultValue("60");
+	registerArg("--interval").setShort("-i").setDescription("Milliseconds between two move or attack messages of a user").setDefaultValue("100");
+	registerArg("--pattern").setDescription("Script with the steps the users execute - random steps if not given");
+	registerArg("--email").setDescription("The email format for the users - %i is replaced with the user index").setDefaultValue("loadgen%i@localhost");
+	registerArg("--password").setDescription("The password of the users").setDefaultValue("loadgen");
+	registerArg("--report").setShort("-r").setDescription("The json report file").setDefaultValue("loadgen-report.json");
+	registerArg("--createusers").setDescription("Writes a server script with the sv_createuser commands for all users and quits");
+	return Super::onConstruct();
+}
+
+bool LoadGen::writeUsersScript(const std::string& file) const {
+	std::string script;
+	for (int i = 0; i < _clients; ++i) {
+		const std::string& email = core::string::format(_emailFormat.c_str(), i);
+		script += core::string::format("sv_createuser %s loadgen%i %s\n", email.c_str(), i, _password.c_str());
+	}
+	return filesystem()->syswrite(file, script);
+}
+
+core::AppState LoadGen::onInit() {
+	const core::AppState state = Super::onInit();
+	if (state != core::AppState::Running) {
+		return state;
+	}
+
+	_host = getArgVal("--host");
+	_port = (uint16_t)core::string::toInt(getArgVal("--port"));
+	_clients = core::string::toInt(getArgVal("--clients"));
+	_connectPerSecond = core_max(1, core::string::toInt(getArgVal("--connectrate")));
+	_durationMillis = (uint64_t)core_max(1, core::string::toInt(getArgVal("--duration"))) * 1000u;
+	_actionIntervalMillis = (uint32_t)core_max(1, core::string::toInt(getArgVal("--interval")));
+	_emailFormat = getArgVal("--email");
+	_password = getArgVal("--password");
+	_reportFile = getArgVal("--report");
+	if (_clients <= 0) {
+		Log::error("At least one client is needed");
+		return core::AppState::InitFailure;
+	}
+
+	const std::string& usersScript = getArgVal("--createusers");
+	if (!usersScript.empty()) {
+		if (!writeUsersScript(usersScript)) {
+			Log::error("Failed to write %s", usersScript.c_str());
+			return core::AppState::InitFailure;
+		}
+		Log::info("Execute 'exec %s' in the server console to create the users", usersScript.c_str());
+		requestQuit();
+		return state;
+	}
+
+	const std::string& patternFile = getArgVal("--pattern");
+	if (patternFile.empty()) {
+		const math::Random random(1u);
+		loadgen::randomPattern(random, 32, _pattern);
+	} else {
+		const std::string& script = filesystem()->load(patternFile);
+		if (!loadgen::parsePattern(script, _pattern)) {
+			Log::error("Failed to parse the pattern %s", patternFile.c_str());
+			return core::AppState::InitFailure;
+		}
+	}
+
+	for (network::ServerMsgType type : network::EnumValuesServerMsgType()) {
+		if (type == network::ServerMsgType::NONE) {
+			continue;
+		}
+		_protocolHandlerRegistry->registerHandler(network::EnumNameServerMsgType(type), std::make_shared<ServerMessageHandler>(type));
+	}
+
+	_users.reserve(_clients);
+	for (int i = 0; i < _clients; ++i) {
+		const std::string& email = core::string::format(_emailFormat.c_str(), i);
+		_users.emplace_back(new loadgen::SimulatedUser(i, email, _password, _protocolHandlerRegistry, eventBus(),
+				_pattern, _actionIntervalMillis));
+	}
+	_startMillis = _timeProvider->tickMillis();
+	Log::info("Spawn %i users for %s:%i", _clients, _host.c_str(), (int)_port);
+
+	return state;
+}
+
+void LoadGen::spawnUsers(uint64_t nowMillis) {
+	const int target = core_min(_clients, (int)((nowMillis - _startMillis) * _connectPerSecond / 1000u) + 1);
+	for (; _spawned < target; ++_spawned) {
+		_users[_spawned]->connect(_port, _host, nowMillis);
+	}
+	if (_spawned == _clients) {
+		_rampUpEndMillis = nowMillis;
+		Log::info("All users are spawned after %i ms", (int)(nowMillis - _startMillis));
+	}
+}
+
+core::AppState LoadGen::onRunning() {
+	Super::onRunning();
+	if (_users.empty()) {
+		return core::AppState::Cleanup;
+	}
+	const uint64_t now = _timeProvider->tickMillis();
+	if (_spawned < _clients) {
+		spawnUsers(now);
+	}
+	for (const SimulatedUserPtr& user : _users) {
+		user->update(now);
+	}
+	if (_rampUpEndMillis != 0u && now - _rampUpEndMillis >= _durationMillis) {
+		if (!writeReport(now)) {
+			_exitCode = 1;
+		}
+		return core::AppState::Cleanup;
+	}
+	return core::AppState::Running;
+}
+
+bool LoadGen::writeReport(uint64_t nowMillis) {
+	loadgen::Samples connect;
+	loadgen::Samples login;
+	loadgen::Samples rtt;
+	std::array<uint64_t, loadgen::SimulatedUser::ServerMsgTypes> received {};
+	std::array<uint64_t, loadgen::SimulatedUser::ClientMsgTypes> sent {};
+	int playing = 0;
+	int authFailed = 0;
+	int failed = 0;
+	int disconnected = 0;
+	for (const SimulatedUserPtr& user : _users) {
+		const loadgen::SimulatedUser::Stats& stats = user->stats();
+		switch (user->state()) {
+		case loadgen::SimulatedUser::State::Playing:
+			++playing;
+			rtt.add(stats.roundTripTimeMillis);
+			break;
+		case loadgen::SimulatedUser::State::AuthFailed:
+			++authFailed;
+			break;
+		case loadgen::SimulatedUser::State::Disconnected:
+			++disconnected;
+			break;
+		default:
+			++failed;
+			break;
+		}
+		if (stats.connectMillis >= 0) {
+			connect.add((uint32_t)stats.connectMillis);
+		}
+		if (stats.loginMillis >= 0) {
+			login.add((uint32_t)stats.loginMillis);
+		}
+		for (size_t i = 0; i < received.size(); ++i) {
+			received[i] += stats.received[i];
+		}
+		for (size_t i = 0; i < sent.size(); ++i) {
+			sent[i] += stats.sent[i];
+		}
+	}
+
+	const double seconds = (double)(nowMillis - _startMillis) / 1000.0;
+	core::json receivedJson = core::json::object();
+	for (size_t i = 1; i < received.size(); ++i) {
+		receivedJson[network::EnumNameServerMsgType((network::ServerMsgType)i)] = {
+			{"count", received[i]},
+			{"perSecond", (double)received[i] / seconds}
+		};
+	}
+	core::json sentJson = core::json::object();
+	for (size_t i = 1; i < sent.size(); ++i) {
+		sentJson[network::EnumNameClientMsgType((network::ClientMsgType)i)] = {
+			{"count", sent[i]},
+			{"perSecond", (double)sent[i] / seconds}
+		};
+	}
+
+	const core::json report = {
+		{"host", _host},
+		{"port", _port},
+		{"clients", _clients},
+		{"rampUpMillis", _rampUpEndMillis - _startMillis},
+		{"durationMillis", nowMillis - _startMillis},
+		{"users", {
+			{"playing", playing},
+			{"authFailed", authFailed},
+			{"disconnected", disconnected},
+			{"failed", failed}
+		}},
+		{"latencyMillis", {
+			{"connect", connect.toJson()},
+			{"login", login.toJson()},
+			{"roundTrip", rtt.toJson()}
+		}},
+		{"received", receivedJson},
+		{"sent", sentJson}
+	};
+	const std::string& json = report.dump(2);
+	Log::info("%s", json.c_str());
+	if (!filesystem()->syswrite(_reportFile, json)) {
+		Log::error("Failed to write the report to %s", _reportFile.c_str());
+		return false;
+	}
+	Log::info("Wrote the report to %s", _reportFile.c_str());
+	return true;
+}
+
+core::AppState LoadGen::onCleanup() {
+	for (const SimulatedUserPtr& user : _users) {
+		user->disconnect();
+	}
+	for (const SimulatedUserPtr& user : _users) {
+		user->shutdown();
+	}
+	_users.clear();
+	_protocolHandlerRegistry->shutdown();
+	enet_deinitialize();
+	return Super::onCleanup();
+}
+
+CONSOLE_APP(LoadGen)
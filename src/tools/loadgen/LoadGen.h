@@ -0,0 +1,55 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/ConsoleApp.h"
+#include "network/ProtocolHandlerRegistry.h"
+#include "Pattern.h"
+#include "SimulatedUser.h"
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Headless load generator for the server. Spawns a lot of simulated users in one process that
+ * log in, move around and attack by following a scripted or a random @c loadgen::Pattern. The received
+ * server messages and the latencies are written into a json report.
+ *
+ * @ingroup Tools
+ */
+class LoadGen: public core::ConsoleApp {
+private:
+	using Super = core::ConsoleApp;
+	typedef std::unique_ptr<loadgen::SimulatedUser> SimulatedUserPtr;
+
+	network::ProtocolHandlerRegistryPtr _protocolHandlerRegistry;
+	std::vector<SimulatedUserPtr> _users;
+	loadgen::Pattern _pattern;
+
+	std::string _host;
+	uint16_t _port = 0u;
+	std::string _reportFile;
+	std::string _emailFormat;
+	std::string _password;
+	int _clients = 0;
+	int _connectPerSecond = 0;
+	uint32_t _actionIntervalMillis = 0u;
+	uint64_t _durationMillis = 0u;
+
+	uint64_t _startMillis = 0u;
+	// the time when the last user was connected - the rates are measured from here
+	uint64_t _rampUpEndMillis = 0u;
+	int _spawned = 0;
+
+	bool writeUsersScript(const std::string& file) const;
+	bool writeReport(uint64_t nowMillis);
+	void spawnUsers(uint64_t nowMillis);
+public:
+	LoadGen(const metric::MetricPtr& metric, const io::FilesystemPtr& filesystem, const core::EventBusPtr& eventBus, const core::TimeProviderPtr& timeProvider);
+
+	core::AppState onConstruct() override;
+	core::AppState onInit() override;
+	core::AppState onRunning() override;
+	core::AppState onCleanup() override;
+};
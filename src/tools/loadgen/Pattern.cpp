@@ -0,0 +1,103 @@
+/**
+ * @file
+ */
+
+#include "Pattern.h"
+#include "Shared_generated.h"
+#include "core/String.h"
+#include "core/Log.h"
+#include "core/Common.h"
+#include "core/GLM.h"
+#include <sstream>
+
+namespace loadgen {
+
+static bool parseDirection(const std::string& str, uint8_t& direction) {
+	std::vector<std::string> tokens;
+	core::string::splitString(str, tokens, "+");
+	direction = 0u;
+	for (const std::string& token : tokens) {
+		if (token == "forward") {
+			direction |= std::enum_value(network::MoveDirection::MOVEFORWARD);
+		} else if (token == "backward") {
+			direction |= std::enum_value(network::MoveDirection::MOVEBACKWARD);
+		} else if (token == "left") {
+			direction |= std::enum_value(network::MoveDirection::MOVELEFT);
+		} else if (token == "right") {
+			direction |= std::enum_value(network::MoveDirection::MOVERIGHT);
+		} else if (token == "jump") {
+			direction |= std::enum_value(network::MoveDirection::JUMP);
+		} else if (token != "none") {
+			Log::error("Unknown move direction '%s'", token.c_str());
+			return false;
+		}
+	}
+	return true;
+}
+
+bool parsePattern(const std::string& script, Pattern& pattern) {
+	std::istringstream stream(script);
+	std::string rawLine;
+	int lineNumber = 0;
+	while (std::getline(stream, rawLine)) {
+		++lineNumber;
+		const std::string line(core::string::trim(rawLine));
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+		std::vector<std::string> args;
+		core::string::splitString(line, args);
+		const std::string& cmd = args[0];
+		Step step;
+		if (cmd == "move") {
+			if (args.size() != 4u) {
+				Log::error("Line %i: Usage: move <directions> <yaw> <millis>", lineNumber);
+				return false;
+			}
+			if (!parseDirection(args[1], step.direction)) {
+				Log::error("Line %i: Invalid move direction", lineNumber);
+				return false;
+			}
+			step.type = Step::Type::Move;
+			step.yaw = glm::radians(core::string::toFloat(args[2]));
+			step.millis = (uint32_t)core::string::toInt(args[3]);
+		} else if (cmd == "attack" || cmd == "idle") {
+			if (args.size() != 2u) {
+				Log::error("Line %i: Usage: %s <millis>", lineNumber, cmd.c_str());
+				return false;
+			}
+			step.type = cmd == "attack" ? Step::Type::Attack : Step::Type::Idle;
+			step.millis = (uint32_t)core::string::toInt(args[1]);
+		} else {
+			Log::error("Line %i: Unknown command '%s'", lineNumber, cmd.c_str());
+			return false;
+		}
+		if (step.millis == 0u) {
+			Log::error("Line %i: The duration must be greater than 0", lineNumber);
+			return false;
+		}
+		pattern.push_back(step);
+	}
+	return !pattern.empty();
+}
+
+void randomPattern(const math::Random& random, int steps, Pattern& pattern) {
+	pattern.reserve(pattern.size() + steps);
+	for (int i = 0; i < steps; ++i) {
+		Step step;
+		const int type = random.random(0, 9);
+		if (type < 7) {
+			step.type = Step::Type::Move;
+			step.direction = (uint8_t)random.random(0, std::enum_value(network::MoveDirection::ANY));
+			step.yaw = random.randomf(0.0f, glm::two_pi<float>());
+		} else if (type < 9) {
+			step.type = Step::Type::Attack;
+		} else {
+			step.type = Step::Type::Idle;
+		}
+		step.millis = (uint32_t)random.random(200, 3000);
+		pattern.push_back(step);
+	}
+}
+
+}
@@ -0,0 +1,54 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "math/Random.h"
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace loadgen {
+
+/**
+ * @brief A single step of the behaviour of a simulated user
+ */
+struct Step {
+	enum class Type : uint8_t {
+		Move, Attack, Idle
+	};
+	Type type = Type::Idle;
+	// network::MoveDirection flags
+	uint8_t direction = 0u;
+	float yaw = 0.0f;
+	uint32_t millis = 0u;
+};
+
+/**
+ * @brief The steps are executed in a loop
+ */
+typedef std::vector<Step> Pattern;
+
+/**
+ * @brief Parses a pattern script. Every line is one step, empty lines and lines starting with @c # are skipped.
+ *
+ * @code
+ * # walk forward and to the left for two seconds with a yaw of 90 degrees
+ * move forward+left 90 2000
+ * # attack a random visible entity for one second
+ * attack 1000
+ * idle 500
+ * @endcode
+ *
+ * The known move directions are @c forward, @c backward, @c left, @c right and @c jump.
+ * @return @c false on parse errors
+ */
+extern bool parsePattern(const std::string& script, Pattern& pattern);
+
+/**
+ * @brief Fills the pattern with random move, attack and idle steps
+ */
+extern void randomPattern(const math::Random& random, int steps, Pattern& pattern);
+
+}
@@ -0,0 +1,62 @@
+/**
+ * @file
+ */
+
+#include "Samples.h"
+#include <algorithm>
+#include <numeric>
+
+namespace loadgen {
+
+void Samples::add(uint32_t value) {
+	_values.push_back(value);
+	_sorted = false;
+}
+
+void Samples::sort() {
+	if (_sorted) {
+		return;
+	}
+	std::sort(_values.begin(), _values.end());
+	_sorted = true;
+}
+
+uint32_t Samples::percentile(float p) {
+	if (_values.empty()) {
+		return 0u;
+	}
+	sort();
+	const size_t index = (size_t)(std::min(std::max(p, 0.0f), 1.0f) * (float)(_values.size() - 1) + 0.5f);
+	return _values[index];
+}
+
+uint32_t Samples::min() {
+	return percentile(0.0f);
+}
+
+uint32_t Samples::max() {
+	return percentile(1.0f);
+}
+
+double Samples::avg() const {
+	if (_values.empty()) {
+		return 0.0;
+	}
+	const uint64_t sum = std::accumulate(_values.begin(), _values.end(), (uint64_t)0u);
+	return (double)sum / (double)_values.size();
+}
+
+core::json Samples::toJson() {
+	return core::json{
+		{"count", _values.size()},
+		{"min", min()},
+		{"max", max()},
+		{"avg", avg()},
+		{"p50", percentile(0.5f)},
+		{"p90", percentile(0.9f)},
+		{"p95", percentile(0.95f)},
+		{"p99", percentile(0.99f)}
+	};
+}
+
+}
@@ -0,0 +1,43 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/JSON.h"
+#include <vector>
+#include <stdint.h>
+
+namespace loadgen {
+
+/**
+ * @brief Collects latency samples (in milliseconds) for the report
+ */
+class Samples {
+private:
+	std::vector<uint32_t> _values;
+	bool _sorted = true;
+
+	void sort();
+public:
+	void add(uint32_t value);
+
+	inline size_t size() const {
+		return _values.size();
+	}
+
+	/**
+	 * @param[in] p The percentile in the range [0,1]
+	 */
+	uint32_t percentile(float p);
+	uint32_t min();
+	uint32_t max();
+	double avg() const;
+
+	/**
+	 * @return The count, min, max, avg and the 50th, 90th, 95th and 99th percentiles
+	 */
+	core::json toJson();
+};
+
+}
@@ -0,0 +1,188 @@
+/**
+ * @file
+ */
+
+#include "SimulatedUser.h"
+#include "core/Password.h"
+#include "core/Common.h"
+#include "core/Log.h"
+#include <algorithm>
+
+namespace loadgen {
+
+SimulatedUser::SimulatedUser(int id, const std::string& email, const std::string& password,
+		const network::ProtocolHandlerRegistryPtr& protocolHandlerRegistry, const core::EventBusPtr& eventBus,
+		const Pattern& pattern, uint32_t actionIntervalMillis) :
+		_id(id), _email(email), _password(password),
+		_network(std::make_shared<network::ClientNetwork>(protocolHandlerRegistry, eventBus)),
+		_messageSender(std::make_shared<network::ClientMessageSender>(_network)),
+		_pattern(pattern), _random((unsigned int)id), _actionIntervalMillis(actionIntervalMillis) {
+	// don't let all users execute the same step at the same time
+	_step = (size_t)_random.random(0, (int)_pattern.size() - 1);
+}
+
+bool SimulatedUser::connect(uint16_t port, const std::string& hostname, uint64_t nowMillis) {
+	if (!_network->init()) {
+		Log::error("Failed to init the network of user %i", _id);
+		_state = State::Failed;
+		return false;
+	}
+	ENetPeer* peer = _network->connect(port, hostname);
+	if (peer == nullptr) {
+		Log::error("User %i failed to connect to %s:%i", _id, hostname.c_str(), (int)port);
+		_state = State::Failed;
+		return false;
+	}
+	peer->data = this;
+	_peer = peer;
+	_connectStart = nowMillis;
+	_state = State::Connecting;
+	return true;
+}
+
+void SimulatedUser::login() {
+	Log::debug("User %i logs in as %s", _id, _email.c_str());
+	_loginStart = _now;
+	_state = State::LoggingIn;
+	++_stats.sent[std::enum_value(network::ClientMsgType::UserConnect)];
+	_messageSender->sendClientMessage(_fbb, network::ClientMsgType::UserConnect,
+			network::CreateUserConnect(_fbb, _fbb.CreateString(_email), _fbb.CreateString(core::pwhash(_password, "TODO"))).Union());
+}
+
+void SimulatedUser::sendMove(const Step& step) {
+	++_stats.sent[std::enum_value(network::ClientMsgType::Move)];
+	const network::MoveDirection direction = (network::MoveDirection)(step.type == Step::Type::Move ? step.direction : 0u);
+	_messageSender->sendClientMessage(_fbb, network::ClientMsgType::Move,
+			network::CreateMove(_fbb, direction, 0.0f, step.yaw).Union());
+}
+
+void SimulatedUser::sendAttack() {
+	if (_visibleEntities.empty()) {
+		return;
+	}
+	const int64_t targetId = _visibleEntities[_random.random(0, (int)_visibleEntities.size() - 1)];
+	++_stats.sent[std::enum_value(network::ClientMsgType::Attack)];
+	_messageSender->sendClientMessage(_fbb, network::ClientMsgType::Attack,
+			network::CreateAttack(_fbb, targetId).Union());
+}
+
+void SimulatedUser::executeStep() {
+	const Step& current = _pattern[_step];
+	if (_now >= _stepEnd) {
+		_step = (_step + 1) % _pattern.size();
+		const Step& next = _pattern[_step];
+		_stepEnd = _now + next.millis;
+		_nextAction = _now;
+		if (current.type == Step::Type::Move && next.type != Step::Type::Move) {
+			// stop moving
+			sendMove(next);
+		}
+	}
+	if (_now < _nextAction) {
+		return;
+	}
+	_nextAction = _now + _actionIntervalMillis;
+	const Step& step = _pattern[_step];
+	switch (step.type) {
+	case Step::Type::Move:
+		sendMove(step);
+		break;
+	case Step::Type::Attack:
+		sendAttack();
+		break;
+	case Step::Type::Idle:
+		break;
+	}
+}
+
+void SimulatedUser::update(uint64_t nowMillis) {
+	_now = nowMillis;
+	if (_state == State::Disconnected || _state == State::Failed || _state == State::AuthFailed) {
+		return;
+	}
+	_network->update();
+	if (_network->isDisconnected()) {
+		Log::debug("User %i lost the connection", _id);
+		_state = _state == State::Playing ? State::Disconnected : State::Failed;
+		++_stats.disconnects;
+		return;
+	}
+	switch (_state) {
+	case State::Connecting:
+		if (_network->isConnected()) {
+			_stats.connectMillis = (int64_t)(_now - _connectStart);
+			login();
+		}
+		break;
+	case State::Playing:
+		executeStep();
+		break;
+	default:
+		break;
+	}
+	if (_network->isConnected()) {
+		_stats.roundTripTimeMillis = _peer->roundTripTime;
+	}
+}
+
+void SimulatedUser::onMessage(network::ServerMsgType type, const void* message) {
+	++_stats.received[std::enum_value(type)];
+	switch (type) {
+	case network::ServerMsgType::UserSpawn: {
+		if (_state != State::LoggingIn) {
+			break;
+		}
+		// the first spawn after the login is our own
+		_stats.loginMillis = (int64_t)(_now - _loginStart);
+		_state = State::Playing;
+		_stepEnd = _now + _pattern[_step].millis;
+		++_stats.sent[std::enum_value(network::ClientMsgType::UserConnected)];
+		_messageSender->sendClientMessage(_fbb, network::ClientMsgType::UserConnected,
+				network::CreateUserConnected(_fbb).Union());
+		break;
+	}
+	case network::ServerMsgType::AuthFailed:
+		Log::warn("User %i: authentication failed for %s", _id, _email.c_str());
+		_state = State::AuthFailed;
+		_network->disconnect();
+		break;
+	case network::ServerMsgType::EntitySpawn: {
+		const network::EntitySpawn* spawn = static_cast<const network::EntitySpawn*>(message);
+		_visibleEntities.push_back(spawn->id());
+		break;
+	}
+	case network::ServerMsgType::EntityRemove: {
+		const network::EntityRemove* remove = static_cast<const network::EntityRemove*>(message);
+		auto i = std::find(_visibleEntities.begin(), _visibleEntities.end(), remove->id());
+		if (i != _visibleEntities.end()) {
+			*i = _visibleEntities.back();
+			_visibleEntities.pop_back();
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void SimulatedUser::disconnect() {
+	if (_state == State::Failed) {
+		return;
+	}
+	if (_state == State::Playing) {
+		++_stats.sent[std::enum_value(network::ClientMsgType::UserDisconnect)];
+		_messageSender->sendClientMessage(_fbb, network::ClientMsgType::UserDisconnect,
+				network::CreateUserDisconnect(_fbb).Union());
+	}
+	_network->disconnect();
+	_state = State::Disconnected;
+}
+
+void SimulatedUser::shutdown() {
+	// flush the disconnect - the network itself isn't shut down as this would also clear the shared protocol handlers
+	_network->update();
+	_network->destroy();
+	_peer = nullptr;
+}
+
+}
@@ -0,0 +1,98 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "Pattern.h"
+#include "ServerMessages_generated.h"
+#include "ClientMessages_generated.h"
+#include "network/ClientNetwork.h"
+#include "network/ClientMessageSender.h"
+#include "math/Random.h"
+#include <array>
+#include <string>
+#include <vector>
+
+namespace loadgen {
+
+/**
+ * @brief A headless client that logs into the server and executes a @c Pattern
+ *
+ * The server messages are dispatched by the protocol handlers to the user that is attached to the peer.
+ */
+class SimulatedUser {
+public:
+	enum class State : uint8_t {
+		Disconnected, Connecting, LoggingIn, Playing, AuthFailed, Failed
+	};
+
+	static constexpr size_t ServerMsgTypes = (size_t)network::ServerMsgType::MAX + 1;
+	static constexpr size_t ClientMsgTypes = (size_t)network::ClientMsgType::MAX + 1;
+
+	struct Stats {
+		std::array<uint64_t, ServerMsgTypes> received {};
+		std::array<uint64_t, ClientMsgTypes> sent {};
+		// time between connecting and the established connection
+		int64_t connectMillis = -1;
+		// time between sending the UserConnect and receiving the Seed
+		int64_t loginMillis = -1;
+		uint32_t roundTripTimeMillis = 0u;
+		uint32_t disconnects = 0u;
+	};
+
+private:
+	const int _id;
+	const std::string _email;
+	const std::string _password;
+	network::ClientNetworkPtr _network;
+	network::ClientMessageSenderPtr _messageSender;
+	ENetPeer* _peer = nullptr;
+	flatbuffers::FlatBufferBuilder _fbb;
+	const Pattern& _pattern;
+	math::Random _random;
+	State _state = State::Disconnected;
+	Stats _stats;
+	std::vector<int64_t> _visibleEntities;
+
+	uint64_t _now = 0u;
+	uint64_t _connectStart = 0u;
+	uint64_t _loginStart = 0u;
+	size_t _step = 0u;
+	uint64_t _stepEnd = 0u;
+	uint64_t _nextAction = 0u;
+	uint32_t _actionIntervalMillis;
+
+	void login();
+	void executeStep();
+	void sendMove(const Step& step);
+	void sendAttack();
+public:
+	SimulatedUser(int id, const std::string& email, const std::string& password,
+			const network::ProtocolHandlerRegistryPtr& protocolHandlerRegistry, const core::EventBusPtr& eventBus,
+			const Pattern& pattern, uint32_t actionIntervalMillis);
+
+	bool connect(uint16_t port, const std::string& hostname, uint64_t nowMillis);
+	void update(uint64_t nowMillis);
+	void disconnect();
+	void shutdown();
+
+	/**
+	 * @brief Called by the protocol handlers for every received server message
+	 */
+	void onMessage(network::ServerMsgType type, const void* message);
+
+	inline int id() const {
+		return _id;
+	}
+
+	inline State state() const {
+		return _state;
+	}
+
+	inline const Stats& stats() const {
+		return _stats;
+	}
+};
+
+}
@@ -0,0 +1,68 @@
+/**
+ * @file
+ */
+
+#include "core/tests/AbstractTest.h"
+#include "Shared_generated.h"
+#include "core/Common.h"
+#include "../Pattern.h"
+#include "../Samples.h"
+
+namespace loadgen {
+
+class LoadGenTest: public core::AbstractTest {
+};
+
+TEST_F(LoadGenTest, testParsePattern) {
+	Pattern pattern;
+	ASSERT_TRUE(parsePattern("# comment\nmove forward+left 90 2000\n\nattack 1000\n  idle 500\n", pattern));
+	ASSERT_EQ(3u, pattern.size());
+	EXPECT_EQ(Step::Type::Move, pattern[0].type);
+	EXPECT_EQ(std::enum_value(network::MoveDirection::MOVEFORWARD) | std::enum_value(network::MoveDirection::MOVELEFT), pattern[0].direction);
+	EXPECT_FLOAT_EQ(glm::half_pi<float>(), pattern[0].yaw);
+	EXPECT_EQ(2000u, pattern[0].millis);
+	EXPECT_EQ(Step::Type::Attack, pattern[1].type);
+	EXPECT_EQ(1000u, pattern[1].millis);
+	EXPECT_EQ(Step::Type::Idle, pattern[2].type);
+	EXPECT_EQ(500u, pattern[2].millis);
+}
+
+TEST_F(LoadGenTest, testParsePatternErrors) {
+	Pattern pattern;
+	EXPECT_FALSE(parsePattern("", pattern));
+	EXPECT_FALSE(parsePattern("move sideways 0 100", pattern));
+	EXPECT_FALSE(parsePattern("move forward 100", pattern));
+	EXPECT_FALSE(parsePattern("attack 0", pattern));
+	EXPECT_FALSE(parsePattern("fly 100", pattern));
+}
+
+TEST_F(LoadGenTest, testRandomPattern) {
+	const math::Random random(1u);
+	Pattern pattern;
+	randomPattern(random, 100, pattern);
+	ASSERT_EQ(100u, pattern.size());
+	for (const Step& step : pattern) {
+		EXPECT_GT(step.millis, 0u);
+		if (step.type != Step::Type::Move) {
+			EXPECT_EQ(0u, step.direction);
+		}
+	}
+}
+
+TEST_F(LoadGenTest, testSamples) {
+	Samples samples;
+	EXPECT_EQ(0u, samples.percentile(0.5f));
+	for (uint32_t i = 100u; i >= 1u; --i) {
+		samples.add(i);
+	}
+	EXPECT_EQ(1u, samples.min());
+	EXPECT_EQ(100u, samples.max());
+	EXPECT_EQ(51u, samples.percentile(0.5f));
+	EXPECT_EQ(99u, samples.percentile(0.99f));
+	EXPECT_DOUBLE_EQ(50.5, samples.avg());
+	const core::json& json = samples.toJson();
+	EXPECT_EQ(100u, json["count"].get<size_t>());
+	EXPECT_EQ(100u, json["max"].get<uint32_t>());
+}
+
+}
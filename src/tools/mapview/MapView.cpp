@@ -151,7 +151,6 @@ core::AppState MapView::onInit() {
 		return core::AppState::InitFailure;
 	}
 	stock::Stock& stock = _entity->stock();
-	stock::Inventory& inv = stock.inventory();
 	const stock::ContainerData* containerData = _stockDataProvider->containerData("tool");
 	if (containerData == nullptr) {
 		Log::error("Could not get container for items");
@@ -162,8 +161,8 @@ core::AppState MapView::onInit() {
 		Log::error("Failed to get item with id 1");
 		return core::AppState::InitFailure;
 	}
-	const stock::ItemPtr& item = _stockDataProvider->createItem(itemData->id());
-	if (!inv.add(containerData->id, item, 0, 0)) {
+	const stock::Item& item = _stockDataProvider->createItem(itemData->id(), 1);
+	if (!stock.add(item, containerData->id, 0, 0).isValid()) {
 		Log::error("Failed to add item to inventory");
 		return core::AppState::InitFailure;
 	}
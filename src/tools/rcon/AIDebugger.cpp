@@ -10,6 +10,8 @@
 #include "Version.h"
 #include "ai/server/IProtocolHandler.h"
 #include "ai/server/AIStateMessage.h"
+#include "ai/server/AIStateDeltaMessage.h"
+#include "ai/server/AICharacterDetailsDeltaMessage.h"
 #include "ai/server/AINamesMessage.h"
 #include "ai/server/AIPauseMessage.h"
 #include "ai/server/AISelectMessage.h"
@@ -42,6 +44,20 @@ public:
 	}
 };
 
+class StateDeltaHandler: public ProtocolHandler<AIStateDeltaMessage> {
+private:
+	AIDebugger& _aiDebugger;
+public:
+	StateDeltaHandler (AIDebugger& aiDebugger) :
+			_aiDebugger(aiDebugger) {
+	}
+
+	void execute(const ClientId& /*clientId*/, const AIStateDeltaMessage* msg) override {
+		_aiDebugger.updateEntities(msg->getStates(), msg->getRemoved());
+		emit _aiDebugger.onEntitiesUpdated();
+	}
+};
+
 class CharacterHandler: public ProtocolHandler<AICharacterDetailsMessage> {
 private:
 	AIDebugger& _aiDebugger;
@@ -56,6 +72,20 @@ public:
 	}
 };
 
+class CharacterDeltaHandler: public ProtocolHandler<AICharacterDetailsDeltaMessage> {
+private:
+	AIDebugger& _aiDebugger;
+public:
+	CharacterDeltaHandler (AIDebugger& aiDebugger) :
+			_aiDebugger(aiDebugger) {
+	}
+
+	void execute(const ClientId& /*clientId*/, const AICharacterDetailsDeltaMessage* msg) override {
+		_aiDebugger.updateCharacterDetails(msg->getCharacterId(), msg->hasAggro() ? &msg->getAggro() : nullptr, msg->getElapsedMillis(), msg->getNodes());
+		emit _aiDebugger.onSelected();
+	}
+};
+
 class CharacterStaticHandler: public ProtocolHandler<AICharacterStaticMessage> {
 private:
 	AIDebugger& _aiDebugger;
@@ -100,7 +130,8 @@ public:
 };
 
 AIDebugger::AIDebugger(AINodeStaticResolver& resolver) :
-		_stateHandler(new StateHandler(*this)), _characterHandler(new CharacterHandler(*this)), _characterStaticHandler(
+		_stateHandler(new StateHandler(*this)), _stateDeltaHandler(new StateDeltaHandler(*this)),
+		_characterHandler(new CharacterHandler(*this)), _characterDeltaHandler(new CharacterDeltaHandler(*this)), _characterStaticHandler(
 				new CharacterStaticHandler(*this)), _pauseHandler(new PauseHandler(*this)), _namesHandler(new NamesHandler(*this)), _nopHandler(
 				new NopHandler()), _selectedId(AI_NOTHING_SELECTED), _socket(this), _pause(false), _resolver(resolver) {
 	connect(&_socket, SIGNAL(readyRead()), SLOT(readTcpData()));
@@ -108,7 +139,9 @@ AIDebugger::AIDebugger(AINodeStaticResolver& resolver) :
 
 	ai::ProtocolHandlerRegistry& r = ai::ProtocolHandlerRegistry::get();
 	r.registerHandler(ai::PROTO_STATE, _stateHandler);
+	r.registerHandler(ai::PROTO_STATE_DELTA, _stateDeltaHandler);
 	r.registerHandler(ai::PROTO_CHARACTER_DETAILS, _characterHandler);
+	r.registerHandler(ai::PROTO_CHARACTER_DETAILS_DELTA, _characterDeltaHandler);
 	r.registerHandler(ai::PROTO_CHARACTER_STATIC, _characterStaticHandler);
 	r.registerHandler(ai::PROTO_PAUSE, _pauseHandler);
 	r.registerHandler(ai::PROTO_NAMES, _namesHandler);
@@ -118,7 +151,9 @@ AIDebugger::AIDebugger(AINodeStaticResolver& resolver) :
 AIDebugger::~AIDebugger() {
 	disconnectFromAIServer();
 	delete _stateHandler;
+	delete _stateDeltaHandler;
 	delete _characterHandler;
+	delete _characterDeltaHandler;
 	delete _characterStaticHandler;
 	delete _pauseHandler;
 	delete _namesHandler;
@@ -140,6 +175,23 @@ void AIDebugger::setCharacterDetails(const CharacterId& id, const AIStateAggro&
 	}
 }
 
+void AIDebugger::updateCharacterDetails(const CharacterId& id, const AIStateAggro* aggro, int64_t elapsedMillis, const std::vector<AIStateNodeStatus>& nodes) {
+	if (_selectedId != id) {
+		// the server will send the full details for the new selection
+		return;
+	}
+	if (aggro != nullptr) {
+		_aggro = aggro->getAggro();
+	}
+	_node.applyDelta(elapsedMillis, nodes);
+	_attributes.clear();
+	const AIStateWorld& state = _entities.value(id);
+	const CharacterAttributes& attributes = state.getAttributes();
+	for (CharacterAttributes::const_iterator i = attributes.begin(); i != attributes.end(); ++i) {
+		_attributes[QString::fromStdString(i->first)] = QString::fromStdString(i->second);
+	}
+}
+
 void AIDebugger::addCharacterStaticData(const AICharacterStaticMessage& msg) {
 	const std::vector<AIStateNodeStatic>& data = msg.getStaticNodeData();
 	_resolver.set(data);
@@ -178,14 +230,15 @@ bool AIDebugger::writeMessage(const IProtocolMessage& msg) {
 	const uint32_t size = out.size();
 	streamContainer sizeC;
 	IProtocolMessage::addInt(sizeC, size);
-	for (streamContainer::iterator i = sizeC.begin(); i != sizeC.end(); ++i) {
-		const uint8_t byte = *i;
-		data << byte;
+	streamContainer::Segment segments[2];
+	int n = sizeC.segments(segments);
+	for (int i = 0; i < n; ++i) {
+		data.writeRawData((const char*)segments[i].data, segments[i].size);
 	}
 	// add the real message
-	for (streamContainer::iterator i = out.begin(); i != out.end(); ++i) {
-		const uint8_t byte = *i;
-		data << byte;
+	n = out.segments(segments);
+	for (int i = 0; i < n; ++i) {
+		data.writeRawData((const char*)segments[i].data, segments[i].size);
 	}
 	// now write everything to the socket
 	_socket.write(temp);
@@ -289,10 +342,7 @@ void AIDebugger::readTcpData() {
 		const QByteArray& data = _socket.readAll();
 		// read everything that is currently available from the socket
 		// and store it in our buffer
-		const int n = data.count();
-		for (int i = 0; i < n; ++i) {
-			_stream.push_back(data[i]);
-		}
+		_stream.append(data.constData(), data.count());
 		ai::ProtocolMessageFactory& mf = ai::ProtocolMessageFactory::get();
 		for (;;) {
 			if (!mf.isNewMessageAvailable(_stream)) {
@@ -330,6 +380,15 @@ void AIDebugger::setNames(const std::vector<std::string>& names) {
 	}
 }
 
+void AIDebugger::updateEntities(const std::vector<AIStateWorld>& entities, const std::vector<CharacterId>& removed) {
+	for (const CharacterId& id : removed) {
+		_entities.remove(id);
+	}
+	for (const AIStateWorld& state : entities) {
+		_entities.insert(state.getId(), state);
+	}
+}
+
 void AIDebugger::setEntities(const std::vector<AIStateWorld>& entities) {
 	_entities.clear();
 	for (const AIStateWorld& state : entities) {
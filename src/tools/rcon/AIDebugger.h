@@ -44,7 +44,9 @@ protected:
 
 	// the network protocol message handlers
 	ai::IProtocolHandler *_stateHandler;
+	ai::IProtocolHandler *_stateDeltaHandler;
 	ai::IProtocolHandler *_characterHandler;
+	ai::IProtocolHandler *_characterDeltaHandler;
 	ai::IProtocolHandler *_characterStaticHandler;
 	ai::IProtocolHandler *_pauseHandler;
 	ai::IProtocolHandler *_namesHandler;
@@ -81,7 +83,16 @@ public:
 	 */
 	const Entities& getEntities() const;
 	void setEntities(const std::vector<AIStateWorld>& entities);
+	/**
+	 * @brief Applies a world state delta to the known entities
+	 */
+	void updateEntities(const std::vector<AIStateWorld>& entities, const std::vector<CharacterId>& removed);
 	void setCharacterDetails(const CharacterId& id, const AIStateAggro& aggro, const AIStateNode& node);
+	/**
+	 * @brief Applies a behaviour tree node delta to the details of the selected entity
+	 * @param[in] aggro The new aggro list - or @c nullptr if it didn't change
+	 */
+	void updateCharacterDetails(const CharacterId& id, const AIStateAggro* aggro, int64_t elapsedMillis, const std::vector<AIStateNodeStatus>& nodes);
 	void addCharacterStaticData(const AICharacterStaticMessage& msg);
 	void setNames(const std::vector<std::string>& names);
 	const QStringList& getNames() const;
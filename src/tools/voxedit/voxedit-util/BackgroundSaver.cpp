@@ -0,0 +1,131 @@
+/**
+ * @file
+ */
+
+#include "BackgroundSaver.h"
+#include "voxelformat/Loader.h"
+#include "voxelformat/VoxelVolumes.h"
+#include "core/io/Filesystem.h"
+#include "core/App.h"
+#include "core/Log.h"
+#include "core/String.h"
+#include "core/Trace.h"
+#include <chrono>
+
+namespace voxedit {
+
+BackgroundSaver::BackgroundSaver() :
+		_threadPool(1, "BackgroundSaver") {
+	_threadPool.init();
+}
+
+BackgroundSaver::~BackgroundSaver() {
+	shutdown();
+	_threadPool.shutdown(true);
+}
+
+void BackgroundSaver::shutdown() {
+	wait();
+	invalidateAll();
+}
+
+std::shared_ptr<voxel::RawVolume> BackgroundSaver::snapshot(int layerId, const voxel::RawVolume* volume) {
+	auto i = _snapshots.find(layerId);
+	if (i != _snapshots.end() && i->second.source == volume) {
+		return i->second.volume;
+	}
+	core_trace_scoped(BackgroundSaverSnapshot);
+	std::shared_ptr<voxel::RawVolume> copy = std::make_shared<voxel::RawVolume>(volume);
+	_snapshots[layerId] = CachedSnapshot{volume, copy};
+	return copy;
+}
+
+void BackgroundSaver::invalidate(int layerId) {
+	_snapshots.erase(layerId);
+}
+
+void BackgroundSaver::invalidateAll() {
+	_snapshots.clear();
+}
+
+bool BackgroundSaver::write(const std::vector<LayerSnapshot>& layers, const std::string& file, util::IProgressMonitor* monitor) {
+	core_trace_scoped(BackgroundSaverWrite);
+	const io::FilesystemPtr& filesystem = io::filesystem();
+	// the target is not opened - opening it for writing would truncate the last save
+	const std::string fileName(core::string::extractFilenameWithExtension(file));
+	const size_t extPos = fileName.rfind('.');
+	std::string ext = extPos == std::string::npos ? "" : fileName.substr(extPos + 1);
+	if (ext.empty()) {
+		Log::warn("No file extension given for saving, assuming vox");
+		ext = "vox";
+	}
+	const std::string tmpName = std::string(core::string::extractPath(file)) + std::string(core::string::extractFilename(fileName)) + ".tmp." + ext;
+	const io::FilePtr& tmpFile = filesystem->open(tmpName, io::FileMode::Write);
+	if (!tmpFile->validHandle()) {
+		Log::warn("Failed to open the file '%s' for writing", tmpName.c_str());
+		return false;
+	}
+	// the temp file is resolved into the same directory as the target
+	const std::string targetName = tmpFile->path() + fileName;
+	voxel::VoxelVolumes volumes;
+	volumes.reserve(layers.size());
+	for (const LayerSnapshot& layer : layers) {
+		volumes.push_back(voxel::VoxelVolume(layer.volume.get(), layer.name, layer.visible, layer.pivot));
+	}
+	const bool saved = voxelformat::saveVolumeFormat(tmpFile, ext, volumes);
+	tmpFile->close();
+	if (monitor != nullptr) {
+		monitor->step();
+	}
+	if (!saved) {
+		filesystem->removeFile(tmpFile->name());
+		return false;
+	}
+	if (!filesystem->move(tmpFile->name(), targetName)) {
+		Log::warn("Failed to move '%s' to '%s'", tmpFile->name().c_str(), targetName.c_str());
+		filesystem->removeFile(tmpFile->name());
+		return false;
+	}
+	if (monitor != nullptr) {
+		monitor->step();
+	}
+	return true;
+}
+
+bool BackgroundSaver::save(std::vector<LayerSnapshot>&& layers, const std::string& file, util::IProgressMonitor* monitor) {
+	if (pending()) {
+		return false;
+	}
+	if (monitor != nullptr) {
+		monitor->init(2);
+	}
+	_file = file;
+	_job = _threadPool.enqueue([monitor, file] (const std::vector<LayerSnapshot>& snapshots) {
+		const bool saved = write(snapshots, file, monitor);
+		if (monitor != nullptr) {
+			monitor->done();
+		}
+		return saved;
+	}, std::move(layers));
+	return true;
+}
+
+bool BackgroundSaver::poll(bool& saved) {
+	if (!pending()) {
+		return false;
+	}
+	if (_job.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+		return false;
+	}
+	saved = _job.get();
+	return true;
+}
+
+bool BackgroundSaver::wait() {
+	if (!pending()) {
+		return false;
+	}
+	return _job.get();
+}
+
+}
@@ -0,0 +1,95 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/ThreadPool.h"
+#include "util/IProgressMonitor.h"
+#include "voxel/RawVolume.h"
+#include <glm/vec3.hpp>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace voxedit {
+
+/**
+ * @brief Saves snapshots of the layer volumes on a worker thread
+ *
+ * The snapshot of a layer is a copy of its volume that is shared with the save job. The copy is reused for
+ * the following saves until the layer is invalidated - only modified layers are copied again. The save job
+ * writes into a temporary file next to the target and renames it afterwards, so an interrupted save never
+ * leaves a broken file behind.
+ */
+class BackgroundSaver {
+public:
+	struct LayerSnapshot {
+		std::shared_ptr<voxel::RawVolume> volume;
+		std::string name;
+		bool visible;
+		glm::ivec3 pivot;
+	};
+private:
+	struct CachedSnapshot {
+		const voxel::RawVolume* source;
+		std::shared_ptr<voxel::RawVolume> volume;
+	};
+	std::unordered_map<int, CachedSnapshot> _snapshots;
+	core::ThreadPool _threadPool;
+	std::future<bool> _job;
+	std::string _file;
+
+	static bool write(const std::vector<LayerSnapshot>& layers, const std::string& file, util::IProgressMonitor* monitor);
+public:
+	BackgroundSaver();
+	~BackgroundSaver();
+
+	void shutdown();
+
+	/**
+	 * @brief The copy of the given layer volume - only copied if the layer was invalidated or the volume
+	 * was replaced since the last call
+	 */
+	std::shared_ptr<voxel::RawVolume> snapshot(int layerId, const voxel::RawVolume* volume);
+	/**
+	 * @brief Call this if the voxels of the given layer were modified
+	 */
+	void invalidate(int layerId);
+	void invalidateAll();
+
+	/**
+	 * @brief Starts to save the given snapshots into the given file
+	 * @param[in] monitor Optional - stepped by the worker thread. Must stay valid until the job finished.
+	 * @return @c false if a save job is still running
+	 */
+	bool save(std::vector<LayerSnapshot>&& layers, const std::string& file, util::IProgressMonitor* monitor = nullptr);
+	bool pending() const;
+	/**
+	 * @brief Checks whether the running save job finished
+	 * @param[out] saved The result of the save job
+	 * @return @c true once for every finished save job
+	 */
+	bool poll(bool& saved);
+	/**
+	 * @brief Blocks until the running save job finished
+	 * @return The result of the save job - @c false if there was no job running
+	 */
+	bool wait();
+	/**
+	 * @return The target file of the last save job
+	 */
+	const std::string& file() const;
+};
+
+inline bool BackgroundSaver::pending() const {
+	return _job.valid();
+}
+
+inline const std::string& BackgroundSaver::file() const {
+	return _file;
+}
+
+}
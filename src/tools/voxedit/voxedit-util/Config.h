@@ -13,5 +13,7 @@ constexpr const char *VoxEditDiffuseColor = "ve_diffusecolor";
 constexpr const char *VoxEditLastPalette = "ve_lastpalette";
 constexpr const char *VoxEditModelSpace = "ve_modelspace";
 constexpr const char *VoxEditCameraZoomSpeed = "ve_camzoomspeed";
+// the memory of the undo history in megabytes
+constexpr const char *VoxEditMementoBudget = "ve_mementobudget";
 
 }
@@ -9,106 +9,144 @@
 #include "voxel/Region.h"
 #include "core/command/Command.h"
 #include "core/Assert.h"
+#include "core/Common.h"
 #include "core/Log.h"
+#include "core/Var.h"
 #include "core/Zip.h"
+#include "Config.h"
+#include <algorithm>
+#include <chrono>
 
 namespace voxedit {
 
 static const MementoState InvalidMementoState{MementoType::Modification, MementoData(), -1, "", voxel::Region::InvalidRegion};
 const int MementoHandler::MaxStates = 64;
+const size_t MementoHandler::DefaultMemoryBudget = 256u * 1024u * 1024u;
 
-MementoData::MementoData(const uint8_t* buf, size_t bufSize,
-		const voxel::Region& _region) :
-		_compressedSize(bufSize), _region(_region) {
-	if (buf != nullptr) {
-		core_assert(_compressedSize > 0);
-		_buffer = new uint8_t[_compressedSize];
-		memcpy(_buffer, buf, _compressedSize);
-	} else {
-		core_assert(_compressedSize == 0);
-	}
+MementoData::MementoData(std::vector<uint8_t>&& voxels, const voxel::Region& region, bool delta) :
+		_buffer(std::make_shared<Buffer>()), _region(region), _delta(delta) {
+	_buffer->data = std::move(voxels);
 }
 
-MementoData::MementoData(MementoData&& o) :
-		_compressedSize(std::exchange(o._compressedSize, 0)),
-		_buffer(std::exchange(o._buffer, nullptr)),
-		_region(o._region) {
+size_t MementoData::size() const {
+	if (!_buffer) {
+		return 0u;
+	}
+	std::unique_lock<std::mutex> lock(_buffer->mutex);
+	return _buffer->data.size();
 }
 
-MementoData::~MementoData() {
-	if (_buffer != nullptr) {
-		delete[] _buffer;
-		_buffer = nullptr;
+bool MementoData::voxels(uint8_t* out, size_t size) const {
+	if (!_buffer) {
+		return false;
+	}
+	std::unique_lock<std::mutex> lock(_buffer->mutex);
+	if (_buffer->compressed) {
+		return core::zip::uncompress(_buffer->data.data(), _buffer->data.size(), out, size);
 	}
+	if (_buffer->data.size() != size) {
+		return false;
+	}
+	memcpy(out, _buffer->data.data(), size);
+	return true;
 }
 
-MementoData::MementoData(const MementoData& o) :
-		_compressedSize(o._compressedSize),
-		_region(o._region) {
-	if (o._buffer != nullptr) {
-		core_assert(_compressedSize > 0);
-		_buffer = new uint8_t[_compressedSize];
-		memcpy(_buffer, o._buffer, _compressedSize);
-	} else {
-		core_assert(_compressedSize == 0);
+MementoData MementoData::fromVolume(const voxel::RawVolume* volume) {
+	if (volume == nullptr) {
+		return MementoData();
 	}
+	const size_t size = volume->region().voxels() * sizeof(voxel::Voxel);
+	std::vector<uint8_t> voxels(volume->data(), volume->data() + size);
+	Log::debug("Memento state. Volume: %i", (int)size);
+	return MementoData(std::move(voxels), volume->region(), false);
 }
 
-MementoData& MementoData::operator=(MementoData &&o) {
-	if (this != &o) {
-		_compressedSize = std::exchange(o._compressedSize, 0);
-		if (_buffer) {
-			delete[] _buffer;
+MementoData MementoData::fromDelta(voxel::RawVolume* previous, const voxel::RawVolume* volume, const voxel::Region& region) {
+	core_assert(previous->region() == volume->region());
+	core_assert(volume->region().containsRegion(region));
+	std::vector<uint8_t> delta(region.voxels() * sizeof(voxel::Voxel));
+	uint8_t *out = delta.data();
+	const glm::ivec3& mins = region.getLowerCorner();
+	const glm::ivec3& maxs = region.getUpperCorner();
+	int changed = 0;
+	for (int32_t z = mins.z; z <= maxs.z; ++z) {
+		for (int32_t y = mins.y; y <= maxs.y; ++y) {
+			for (int32_t x = mins.x; x <= maxs.x; ++x) {
+				const voxel::Voxel& current = volume->voxel(x, y, z);
+				const voxel::Voxel& old = previous->voxel(x, y, z);
+				*out++ = (uint8_t)current.getMaterial() ^ (uint8_t)old.getMaterial();
+				*out++ = current.getColor() ^ old.getColor();
+				if (!current.isSame(old)) {
+					previous->setVoxel(x, y, z, current);
+					++changed;
+				}
+			}
 		}
-		_buffer = std::exchange(o._buffer, nullptr);
-		_region = o._region;
 	}
-	return *this;
+	Log::debug("Memento delta. Region voxels: %i, changed: %i", (int)region.voxels(), changed);
+	return MementoData(std::move(delta), region, true);
 }
 
-MementoData MementoData::fromVolume(const voxel::RawVolume* volume) {
-	if (volume == nullptr) {
-		return MementoData();
+int MementoData::applyDelta(const MementoData& mementoData, voxel::RawVolume* volume) {
+	if (!mementoData._delta || volume == nullptr || !volume->region().containsRegion(mementoData._region)) {
+		return -1;
 	}
-	const size_t uncompressedBufferSize = volume->region().voxels() * sizeof(voxel::Voxel);
-	const uint32_t compressedBufferSize = core::zip::compressBound(uncompressedBufferSize);
-	uint8_t *compressedBuf = new uint8_t[compressedBufferSize];
-	size_t finalBufSize = 0u;
-	if (!core::zip::compress(volume->data(), uncompressedBufferSize, compressedBuf, compressedBufferSize, &finalBufSize)) {
-		delete[] compressedBuf;
-		return MementoData();
+	const voxel::Region& region = mementoData._region;
+	std::vector<uint8_t> delta(region.voxels() * sizeof(voxel::Voxel));
+	if (!mementoData.voxels(delta.data(), delta.size())) {
+		return -1;
 	}
-	const MementoData data(compressedBuf, finalBufSize, volume->region());
-	delete[] compressedBuf;
-
-	Log::debug("Memento state. Volume: %i, compressed: %i",
-			(int)uncompressedBufferSize, (int)data._compressedSize);
-	return data;
+	const uint8_t *in = delta.data();
+	const glm::ivec3& mins = region.getLowerCorner();
+	const glm::ivec3& maxs = region.getUpperCorner();
+	int changed = 0;
+	for (int32_t z = mins.z; z <= maxs.z; ++z) {
+		for (int32_t y = mins.y; y <= maxs.y; ++y) {
+			for (int32_t x = mins.x; x <= maxs.x; ++x, in += 2) {
+				if (in[0] == 0u && in[1] == 0u) {
+					continue;
+				}
+				const voxel::Voxel& v = volume->voxel(x, y, z);
+				volume->setVoxel(x, y, z, voxel::Voxel((voxel::VoxelType)((uint8_t)v.getMaterial() ^ in[0]), v.getColor() ^ in[1]));
+				++changed;
+			}
+		}
+	}
+	return changed;
 }
 
 voxel::RawVolume* MementoData::toVolume(const MementoData& mementoData) {
-	if (mementoData._buffer == nullptr) {
+	if (!mementoData._buffer || mementoData._delta) {
+		return nullptr;
+	}
+	const size_t voxels = mementoData._region.voxels();
+	voxel::Voxel *data = new voxel::Voxel[voxels];
+	if (!mementoData.voxels((uint8_t*)data, voxels * sizeof(voxel::Voxel))) {
+		delete[] data;
 		return nullptr;
 	}
-	const size_t uncompressedBufferSize = mementoData._region.voxels() * sizeof(voxel::Voxel);
-	uint8_t *uncompressedBuf = new uint8_t[uncompressedBufferSize];
-	core::zip::uncompress(mementoData._buffer, mementoData._compressedSize, uncompressedBuf, uncompressedBufferSize);
-	return voxel::RawVolume::createRaw((voxel::Voxel*)uncompressedBuf, mementoData._region);
+	return voxel::RawVolume::createRaw(data, mementoData._region);
 }
 
-MementoHandler::MementoHandler() {
+MementoHandler::MementoHandler() :
+		_memoryBudget(DefaultMemoryBudget), _threadPool(1, "Memento") {
+	_threadPool.init();
 }
 
 MementoHandler::~MementoHandler() {
 	shutdown();
+	_threadPool.shutdown(true);
 }
 
 bool MementoHandler::init() {
 	_states.reserve(MaxStates);
+	const core::VarPtr& budget = core::Var::get(cfg::VoxEditMementoBudget, "256");
+	_memoryBudget = (size_t)core_max(budget->intVal(), 1) * 1024u * 1024u;
 	return true;
 }
 
 void MementoHandler::shutdown() {
+	waitForCompression();
 	clearStates();
 }
 
@@ -124,12 +162,14 @@ void MementoHandler::construct() {
 	core::Command::registerCommand("ve_mementoinfo", [&] (const core::CmdArgs& args) {
 		Log::info("Current memento state index: %i", _statePosition);
 		Log::info("Maximum memento states: %i", MaxStates);
+		Log::info("Memory usage: %i/%i kb", (int)(memoryUsage() / 1024u), (int)(_memoryBudget / 1024u));
 		int i = 0;
 		for (MementoState& state : _states) {
 			const glm::ivec3& mins = state.region.getLowerCorner();
 			const glm::ivec3& maxs = state.region.getUpperCorner();
-			Log::info("%4i: %i - %s (%s) [mins(%i:%i:%i)/maxs(%i:%i:%i)]",
-					i++, state.layer, state.name.c_str(), state.data._buffer == nullptr ? "empty" : "volume",
+			const char *content = state.hasVolumeData() ? (state.data.isDelta() ? "delta" : "volume") : "empty";
+			Log::info("%4i: %i - %s (%s, %i kb) [mins(%i:%i:%i)/maxs(%i:%i:%i)]",
+					i++, state.layer, state.name.c_str(), content, (int)(state.data.size() / 1024u),
 							mins.x, mins.y, mins.z, maxs.x, maxs.y, maxs.z);
 		}
 	});
@@ -137,41 +177,165 @@ void MementoHandler::construct() {
 
 void MementoHandler::clearStates() {
 	_states.clear();
+	_previous.clear();
 	_statePosition = 0u;
 }
 
+void MementoHandler::setMemoryBudget(size_t bytes) {
+	_memoryBudget = bytes;
+}
+
+size_t MementoHandler::memoryUsage() const {
+	size_t bytes = 0u;
+	for (const MementoState& state : _states) {
+		bytes += state.data.size();
+	}
+	for (const auto& e : _previous) {
+		bytes += e.second->region().voxels() * sizeof(voxel::Voxel);
+	}
+	return bytes;
+}
+
+void MementoHandler::compress(const MementoData& data) {
+	_compressions.erase(std::remove_if(_compressions.begin(), _compressions.end(), [] (const std::future<void>& f) {
+		return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	}), _compressions.end());
+	std::shared_ptr<MementoData::Buffer> buffer = data._buffer;
+	_compressions.push_back(_threadPool.enqueue([buffer] () {
+		core_trace_scoped(MementoCompress);
+		// this is the only place where the data is modified - no need to lock for reading it
+		const std::vector<uint8_t>& raw = buffer->data;
+		std::vector<uint8_t> compressed(core::zip::compressBound((uint32_t)raw.size()));
+		size_t compressedSize = 0u;
+		if (!core::zip::compress(raw.data(), raw.size(), compressed.data(), compressed.size(), &compressedSize)) {
+			Log::warn("Failed to compress the memento data");
+			return;
+		}
+		if (compressedSize >= raw.size()) {
+			return;
+		}
+		compressed.resize(compressedSize);
+		compressed.shrink_to_fit();
+		std::unique_lock<std::mutex> lock(buffer->mutex);
+		buffer->data.swap(compressed);
+		buffer->compressed = true;
+	}));
+}
+
+void MementoHandler::waitForCompression() {
+	for (std::future<void>& f : _compressions) {
+		f.wait();
+	}
+	_compressions.clear();
+}
+
+MementoData MementoHandler::reconstruct(int index) const {
+	const int layer = _states[index].layer;
+	int first = index;
+	for (; first >= 0; --first) {
+		const MementoState& s = _states[first];
+		if (s.layer != layer || s.type == MementoType::LayerRenamed) {
+			continue;
+		}
+		if (!s.data.isDelta()) {
+			break;
+		}
+	}
+	if (first < 0 || !_states[first].hasVolumeData()) {
+		Log::error("Could not find the volume of layer %i for memento state %i", layer, index);
+		return MementoData();
+	}
+	voxel::RawVolume* volume = MementoData::toVolume(_states[first].data);
+	if (volume == nullptr) {
+		return MementoData();
+	}
+	for (int i = first + 1; i <= index; ++i) {
+		const MementoState& s = _states[i];
+		if (s.layer == layer && s.data.isDelta()) {
+			MementoData::applyDelta(s.data, volume);
+		}
+	}
+	MementoData data = MementoData::fromVolume(volume);
+	delete volume;
+	return data;
+}
+
+void MementoHandler::applyToPrevious(const MementoState& state) {
+	auto i = _previous.find(state.layer);
+	if (i == _previous.end()) {
+		return;
+	}
+	if (MementoData::applyDelta(state.data, i->second.get()) < 0) {
+		_previous.erase(i);
+	}
+}
+
+void MementoHandler::removeFirst() {
+	const MementoState& first = _states.front();
+	if (first.hasVolumeData() && first.type != MementoType::LayerRenamed) {
+		// the next delta of the layer must become a full state - the deltas are relative to the removed state
+		for (size_t i = 1; i < _states.size(); ++i) {
+			MementoState& s = _states[i];
+			if (s.layer != first.layer || s.type == MementoType::LayerRenamed) {
+				continue;
+			}
+			if (s.data.isDelta()) {
+				s.data = reconstruct((int)i);
+				compress(s.data);
+			}
+			break;
+		}
+	}
+	_states.erase(_states.begin());
+}
+
 MementoState MementoHandler::undo() {
 	if (!canUndo()) {
 		return InvalidMementoState;
 	}
+	core_trace_scoped(MementoUndo);
 	core_assert(_statePosition >= 1);
 	--_statePosition;
-	if (_states[_statePosition].data._buffer != nullptr
+	if (_states[_statePosition].hasVolumeData()
 			&& _states[_statePosition].type == MementoType::LayerAdded
 			&& _states[_statePosition + 1].type != MementoType::Modification) {
 		--_statePosition;
 	}
 	Log::debug("Available states: %i, current index: %i", (int)_states.size(), _statePosition);
+	const MementoState& left = _states[_statePosition + 1];
+	if (left.data.isDelta()) {
+		// applying the delta of the state that is left restores the previous voxels of the region
+		voxel::logRegion("Undo", left.data.region());
+		applyToPrevious(left);
+		return MementoState{left.type, left.data, left.layer, left.name, left.data.region()};
+	}
 	const MementoState& s = state();
-	const voxel::Region region = _states[_statePosition + 1].region;
+	const voxel::Region region = left.region;
 	voxel::logRegion("Undo", region);
-	return MementoState{_states[_statePosition + 1].type, s.data, s.layer, s.name, region};
+	_previous.erase(s.layer);
+	return MementoState{left.type, s.data.isDelta() ? reconstruct(_statePosition) : s.data, s.layer, s.name, region};
 }
 
 MementoState MementoHandler::redo() {
 	if (!canRedo()) {
 		return InvalidMementoState;
 	}
+	core_trace_scoped(MementoRedo);
 	Log::debug("Available states: %i, current index: %i", (int)_states.size(), _statePosition);
 	++_statePosition;
-	if (_states[_statePosition].data._buffer == nullptr && _states[_statePosition].type == MementoType::LayerAdded) {
+	if (!_states[_statePosition].hasVolumeData() && _states[_statePosition].type == MementoType::LayerAdded) {
 		++_statePosition;
 	}
-	if (_states[_statePosition].data._buffer != nullptr && _states[_statePosition].type == MementoType::LayerDeleted) {
+	if (_states[_statePosition].hasVolumeData() && _states[_statePosition].type == MementoType::LayerDeleted) {
 		++_statePosition;
 	}
 	const MementoState& s = state();
 	voxel::logRegion("Redo", s.region);
+	if (s.data.isDelta()) {
+		applyToPrevious(s);
+	} else {
+		_previous.erase(s.layer);
+	}
 	return MementoState{s.type, s.data, s.layer, s.name, s.region};
 }
 
@@ -196,6 +360,7 @@ void MementoHandler::markUndo(int layer, const std::string& name, const voxel::R
 		Log::debug("Don't add undo state - we are currently in locked mode");
 		return;
 	}
+	core_trace_scoped(MementoMarkUndo);
 	if (!_states.empty()) {
 		// if we mark something as new undo state, we can throw away
 		// every other state that follows the new one (everything after
@@ -206,10 +371,28 @@ void MementoHandler::markUndo(int layer, const std::string& name, const voxel::R
 	}
 	Log::debug("New undo state for layer %i with name %s (memento state index: %i)", layer, name.c_str(), (int)_states.size());
 	voxel::logRegion("MarkUndo", region);
-	const MementoData& data = MementoData::fromVolume(volume);
-	_states.emplace_back(type, data, layer, name, region);
-	while (_states.size() > MaxStates) {
-		_states.erase(_states.begin());
+	if (volume == nullptr) {
+		if (type != MementoType::LayerRenamed) {
+			_previous.erase(layer);
+		}
+		_states.emplace_back(type, MementoData(), layer, name, region);
+	} else {
+		auto i = _previous.find(layer);
+		if (type == MementoType::Modification && region.isValid() && i != _previous.end()
+				&& i->second->region() == volume->region() && volume->region().containsRegion(region)) {
+			_states.emplace_back(type, MementoData::fromDelta(i->second.get(), volume, region), layer, name, region);
+		} else {
+			_previous[layer] = std::unique_ptr<voxel::RawVolume>(new voxel::RawVolume(volume));
+			_states.emplace_back(type, MementoData::fromVolume(volume), layer, name, region);
+		}
+		compress(_states.back().data);
+	}
+	if (memoryUsage() > _memoryBudget) {
+		// don't drop states because of data that is about to shrink
+		waitForCompression();
+	}
+	while (_states.size() > (size_t)MaxStates || (_states.size() > 1u && memoryUsage() > _memoryBudget)) {
+		removeFirst();
 	}
 	_statePosition = stateSize() - 1;
 }
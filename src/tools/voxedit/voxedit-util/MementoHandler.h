@@ -5,8 +5,13 @@
 #pragma once
 
 #include "core/IComponent.h"
+#include "core/ThreadPool.h"
+#include "core/Trace.h"
 #include "voxel/Region.h"
 #include "voxel/Voxel.h"
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 #include <string>
 #include <stdint.h>
@@ -28,48 +33,79 @@ enum class MementoType {
 /**
  * @brief Holds the data of a memento state
  *
- * The given buffer is owned by this class and represents a compressed volume
+ * This is either the whole volume or - for modifications - the xor delta of the modified region against the
+ * previous state of the layer. The buffer is shared between the copies of the data and is compressed in the
+ * background by the @c MementoHandler.
  */
 class MementoData {
 	friend struct MementoState;
 	friend class MementoHandler;
 private:
-	/**
-	 * @brief How big is the buffer with the compressed volume data
-	 */
-	size_t _compressedSize = 0;
-	/**
-	 * @brief The compressed volume data
-	 */
-	uint8_t* _buffer = nullptr;
+	struct Buffer {
+		mutable core_trace_mutex(std::mutex, mutex);
+		/**
+		 * @brief The raw voxels or - once the background compression finished - the compressed voxels
+		 */
+		std::vector<uint8_t> data;
+		bool compressed = false;
+	};
+	std::shared_ptr<Buffer> _buffer;
 	/**
 	 * The region the given volume data is for
 	 */
 	voxel::Region _region {};
+	bool _delta = false;
 
-	MementoData(const uint8_t* buf, size_t bufSize, const voxel::Region& _region);
+	MementoData(std::vector<uint8_t>&& voxels, const voxel::Region& region, bool delta);
+
+	/**
+	 * @brief Writes the raw voxels of the data into the given buffer - the size must match the region
+	 */
+	bool voxels(uint8_t* out, size_t size) const;
 public:
-	constexpr MementoData() {}
-	MementoData(MementoData&& o);
-	MementoData(const MementoData& o);
-	~MementoData();
+	MementoData() {}
 
-	MementoData& operator=(MementoData &&o);
+	/**
+	 * @return The amount of bytes the data occupies in memory
+	 */
+	size_t size() const;
+	bool isDelta() const;
+	const voxel::Region& region() const;
 
 	/**
 	 * @brief Converts the given @c mementoData into a volume
 	 * @note Keep in mind that you own the returned memory
 	 * @return The volume from the given memento data or @c null if the memento data
-	 * did not contain a valid volume buffer
+	 * did not contain a valid volume buffer or is only a delta
 	 */
 	static voxel::RawVolume* toVolume(const MementoData& mementoData);
 	/**
-	 * @brief Converts the given volume into a @c MementoData structure (and perform the compression)
+	 * @brief Converts the given volume into a @c MementoData structure
 	 * @param[in] volume The volume to create the memento state for. This might be @c null.
 	 */
 	static MementoData fromVolume(const voxel::RawVolume* volume);
+	/**
+	 * @brief Creates the xor delta of the given region between the previous state and the volume - the
+	 * previous state is updated to the current state
+	 * @note The region must be inside the volume and both volumes must have the same region
+	 */
+	static MementoData fromDelta(voxel::RawVolume* previous, const voxel::RawVolume* volume, const voxel::Region& region);
+	/**
+	 * @brief Applies the xor delta to the given volume. This is the same for undo and redo - applied to the
+	 * previous state it results in the current state and vice versa. Only the changed voxels are written.
+	 * @return The amount of changed voxels or @c -1 if the data is no delta or doesn't fit the volume
+	 */
+	static int applyDelta(const MementoData& mementoData, voxel::RawVolume* volume);
 };
 
+inline bool MementoData::isDelta() const {
+	return _delta;
+}
+
+inline const voxel::Region& MementoData::region() const {
+	return _region;
+}
+
 struct MementoState {
 	MementoType type;
 	MementoData data;
@@ -90,7 +126,7 @@ struct MementoState {
 	}
 
 	MementoState(MementoType _type, MementoData&& _data, int _layer, std::string&& _name, voxel::Region&& _region) :
-			type(_type), data(_data), layer(_layer), name(_name), region(_region) {
+			type(_type), data(std::move(_data)), layer(_layer), name(_name), region(_region) {
 	}
 
 	/**
@@ -107,14 +143,32 @@ struct MementoState {
 
 /**
  * @brief Class that manages the undo and redo steps for the scene
+ *
+ * A copy of the last state of each layer is kept to store modifications of a region as xor delta against it.
+ * Undo and redo of such a state only touch the voxels that were changed - see @c MementoData::applyDelta().
+ * Every other state (and the first state of a layer) holds the whole volume. The data is compressed in the
+ * background, the oldest states are dropped if the history exceeds the memory budget.
  */
 class MementoHandler : public core::IComponent {
 private:
 	std::vector<MementoState> _states;
 	uint8_t _statePosition = 0u;
 	int _locked = 0;
+	size_t _memoryBudget;
+	std::unordered_map<int, std::unique_ptr<voxel::RawVolume>> _previous;
+	core::ThreadPool _threadPool;
+	std::vector<std::future<void>> _compressions;
+
+	void compress(const MementoData& data);
+	void removeFirst();
+	/**
+	 * @brief Creates the whole volume of the given state by applying the deltas of the layer to the last full state
+	 */
+	MementoData reconstruct(int index) const;
+	void applyToPrevious(const MementoState& state);
 public:
 	static const int MaxStates;
+	static const size_t DefaultMemoryBudget;
 
 	MementoHandler();
 	~MementoHandler();
@@ -135,6 +189,22 @@ public:
 	void unlock();
 
 	void clearStates();
+
+	/**
+	 * @brief The oldest states are removed if the memory usage exceeds this amount of bytes. There is always at least
+	 * the current state.
+	 * @note If the budget is exceeded, the running background compressions are finished before any state is removed
+	 * @sa memoryUsage()
+	 */
+	void setMemoryBudget(size_t bytes);
+	/**
+	 * @return The amount of bytes of all states and of the copies of the last state of each layer
+	 */
+	size_t memoryUsage() const;
+	/**
+	 * @brief Blocks until the data of all states is compressed
+	 */
+	void waitForCompression();
 	/**
 	 * @brief Add a new state entry to the memento handler that you can return to.
 	 * @note This is adding the current active state to the handler - you can then undo to the previous state.
@@ -18,10 +18,6 @@
 #include "voxelworld/BiomeManager.h"
 #include "voxelformat/Loader.h"
 #include "voxelformat/VoxFormat.h"
-#include "voxelformat/QBTFormat.h"
-#include "voxelformat/CubFormat.h"
-#include "voxelformat/QBFormat.h"
-#include "voxelformat/VXMFormat.h"
 #include "video/ScopedPolygonMode.h"
 #include "video/ScopedLineWidth.h"
 #include "video/ScopedBlendMode.h"
@@ -138,7 +134,7 @@ bool SceneManager::importHeightmap(const std::string& file) {
 }
 
 void SceneManager::autosave() {
-	if (!_needAutoSave) {
+	if (!_needAutoSave || _backgroundSaver.pending()) {
 		return;
 	}
 	const core::TimeProviderPtr& timeProvider = core::App::getInstance()->timeProvider();
@@ -161,12 +157,42 @@ void SceneManager::autosave() {
 					p.c_str(), f.c_str(), e.c_str());
 		}
 	}
-	if (save(autoSaveFilename, true)) {
-		Log::info("Autosave file %s", autoSaveFilename.c_str());
+	// only the snapshot is taken here - serializing and writing is done by the worker thread
+	core_trace_scoped(AutosaveSnapshot);
+	std::vector<BackgroundSaver::LayerSnapshot> layers;
+	const int layerCnt = (int)_layerMgr.layers().size();
+	for (int idx = 0; idx < layerCnt; ++idx) {
+		const voxel::RawVolume* v = _volumeRenderer.volume(idx);
+		if (v == nullptr || _volumeRenderer.empty(idx)) {
+			continue;
+		}
+		const Layer& layer = _layerMgr.layer(idx);
+		layers.push_back(BackgroundSaver::LayerSnapshot{_backgroundSaver.snapshot(idx, v), layer.name, layer.visible, layer.pivot});
+	}
+	_lastAutoSave = timeProvider->tickSeconds();
+	if (layers.empty()) {
+		Log::warn("No volumes for saving found");
+		return;
+	}
+	if (_backgroundSaver.save(std::move(layers), autoSaveFilename, &_autoSaveProgress)) {
+		// modifications after the snapshot need another autosave
+		_needAutoSave = false;
+	}
+}
+
+void SceneManager::pollAutosave() {
+	bool saved = false;
+	if (!_backgroundSaver.poll(saved)) {
+		return;
+	}
+	const std::string& file = _backgroundSaver.file();
+	if (saved) {
+		Log::info("Autosave file %s", file.c_str());
+		core::Var::get(cfg::VoxEditLastFile)->setVal(file);
 	} else {
 		Log::warn("Failed to autosave");
+		_needAutoSave = true;
 	}
-	_lastAutoSave = timeProvider->tickSeconds();
 }
 
 bool SceneManager::saveLayer(int layerId, const std::string& file) {
@@ -214,7 +240,6 @@ bool SceneManager::save(const std::string& file, bool autosave) {
 		Log::warn("Failed to open the given file '%s' for writing", file.c_str());
 		return false;
 	}
-	bool saved = false;
 	std::string ext = filePtr->extension();
 	if (ext.empty()) {
 		Log::warn("No file extension given for saving, assuming vox");
@@ -242,23 +267,7 @@ bool SceneManager::save(const std::string& file, bool autosave) {
 		return false;
 	}
 
-	if (ext == "qbt") {
-		voxel::QBTFormat f;
-		saved = f.saveGroups(volumes, filePtr);
-	} else if (ext == "vox") {
-		voxel::VoxFormat f;
-		saved = f.saveGroups(volumes, filePtr);
-	} else if (ext == "qb") {
-		voxel::QBFormat f;
-		saved = f.saveGroups(volumes, filePtr);
-	} else if (ext == "cub") {
-		voxel::CubFormat f;
-		saved = f.saveGroups(volumes, filePtr);
-	} else {
-		Log::warn("Failed to save file with unknown type: %s - saving as vox instead", ext.c_str());
-		voxel::VoxFormat f;
-		saved = f.saveGroups(volumes, filePtr);
-	}
+	const bool saved = voxelformat::saveVolumeFormat(filePtr, ext, volumes);
 	if (saved) {
 		if (!autosave) {
 			_dirty = false;
@@ -340,6 +349,7 @@ void SceneManager::modified(int layerId, const voxel::Region& modifiedRegion, bo
 	if (markUndo) {
 		_mementoHandler.markUndo(layerId, _layerMgr.layer(layerId).name, _volumeRenderer.volume(layerId), MementoType::Modification, modifiedRegion);
 	}
+	_backgroundSaver.invalidate(layerId);
 	if (modifiedRegion.isValid()) {
 		bool addNew = true;
 		for (const auto& r : _extractRegions) {
@@ -409,6 +419,12 @@ void SceneManager::undo() {
 		_layerMgr.rename(s.layer, s.name);
 		return;
 	}
+	if (s.data.isDelta()) {
+		if (MementoData::applyDelta(s.data, _volumeRenderer.volume(s.layer)) >= 0) {
+			modified(s.layer, s.region, false);
+		}
+		return;
+	}
 	voxel::RawVolume* v = MementoData::toVolume(s.data);
 	if (v == nullptr) {
 		_layerMgr.deleteLayer(s.layer, false);
@@ -474,6 +490,12 @@ void SceneManager::redo() {
 		_layerMgr.rename(s.layer, s.name);
 		return;
 	}
+	if (s.data.isDelta()) {
+		if (MementoData::applyDelta(s.data, _volumeRenderer.volume(s.layer)) >= 0) {
+			modified(s.layer, s.region, false);
+		}
+		return;
+	}
 	voxel::RawVolume* v = MementoData::toVolume(s.data);
 	if (v == nullptr) {
 		_layerMgr.deleteLayer(s.layer, false);
@@ -565,6 +587,7 @@ bool SceneManager::setNewVolume(int idx, voxel::RawVolume* volume, bool deleteMe
 	}
 	const voxel::Region& region = volume->region();
 	delete _volumeRenderer.setVolume(idx, volume, deleteMesh);
+	_backgroundSaver.invalidate(idx);
 
 	if (volume != nullptr) {
 		_gridRenderer.update(region);
@@ -1458,6 +1481,7 @@ void SceneManager::update(uint64_t time) {
 		_diffuseColor->markClean();
 	}
 	animate(time);
+	pollAutosave();
 	autosave();
 	extractVolume();
 }
@@ -1478,6 +1502,7 @@ void SceneManager::shutdown() {
 		delete v;
 	}
 
+	_backgroundSaver.shutdown();
 	_volumeCache.shutdown();
 	_mementoHandler.shutdown();
 	_modifier.shutdown();
@@ -1855,6 +1880,8 @@ void SceneManager::onLayerDuplicate(int layerId) {
 
 void SceneManager::onLayerSwapped(int layerId1, int layerId2) {
 	// TODO: mementohandler
+	_backgroundSaver.invalidate(layerId1);
+	_backgroundSaver.invalidate(layerId2);
 	if (!_volumeRenderer.swap(layerId1, layerId2)) {
 		Log::error("Failed to swap volumes for layer %i and layer %i", layerId1, layerId2);
 	}
@@ -1923,6 +1950,7 @@ void SceneManager::onLayerAdded(int layerId, const Layer& layer, voxel::RawVolum
 
 void SceneManager::onLayerDeleted(int layerId, const Layer& layer) {
 	voxel::RawVolume* v = _volumeRenderer.setVolume(layerId, nullptr);
+	_backgroundSaver.invalidate(layerId);
 	if (v != nullptr) {
 		Log::debug("Deleted layer %i with name %s", layerId, layer.name.c_str());
 		// Add two states here - one with the filled layer and one with the empty layer.
@@ -23,6 +23,7 @@
 #include "core/command/ActionButton.h"
 #include "math/Axis.h"
 #include "MementoHandler.h"
+#include "BackgroundSaver.h"
 #include "layer/LayerListener.h"
 #include "layer/Layer.h"
 #include "layer/LayerManager.h"
@@ -65,6 +66,8 @@ private:
 	video::ShapeBuilder _shapeBuilder;
 	render::ShapeRenderer _shapeRenderer;
 	MementoHandler _mementoHandler;
+	BackgroundSaver _backgroundSaver;
+	util::IProgressMonitor _autoSaveProgress;
 	LayerManager _layerMgr;
 	Modifier _modifier;
 	voxel::RawVolume* _copy = nullptr;
@@ -157,6 +160,7 @@ private:
 	bool setNewVolume(int idx, voxel::RawVolume* volume, bool deleteMesh = true);
 	bool setNewVolumes(const voxel::VoxelVolumes& volumes);
 	void autosave();
+	void pollAutosave();
 	void setReferencePosition(const glm::ivec3& pos);
 
 	void animate(uint64_t time);
@@ -0,0 +1,97 @@
+/**
+ * @file
+ */
+
+#include "core/benchmark/AbstractBenchmark.h"
+#include "../MementoHandler.h"
+#include "voxel/RawVolume.h"
+
+/**
+ * @brief Compares the latency of the delta states of small modifications with the full states of a layer of the
+ * size given by the benchmark argument.
+ */
+class MementoHandlerBenchmark: public core::AbstractBenchmark {
+protected:
+	voxedit::MementoHandler _mementoHandler;
+	voxel::RawVolume* _volume = nullptr;
+	const voxel::Region _modified { glm::ivec3(0), glm::ivec3(7) };
+
+	void fill(uint8_t color) {
+		const glm::ivec3& mins = _modified.getLowerCorner();
+		const glm::ivec3& maxs = _modified.getUpperCorner();
+		for (int32_t z = mins.z; z <= maxs.z; ++z) {
+			for (int32_t y = mins.y; y <= maxs.y; ++y) {
+				for (int32_t x = mins.x; x <= maxs.x; ++x) {
+					_volume->setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, color));
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Adds the initial state and a modification that can get undone
+	 */
+	void createHistory(int size, bool delta) {
+		_volume = new voxel::RawVolume(voxel::Region(0, size - 1));
+		_mementoHandler.markUndo(0, "Layer 1", _volume);
+		fill(1);
+		if (delta) {
+			_mementoHandler.markUndo(0, "Layer 1", _volume, voxedit::MementoType::Modification, _modified);
+		} else {
+			_mementoHandler.markUndo(0, "Layer 1", _volume);
+		}
+		_mementoHandler.waitForCompression();
+	}
+
+public:
+	void onCleanupApp() override {
+		_mementoHandler.shutdown();
+		delete _volume;
+		_volume = nullptr;
+	}
+
+	bool onInitApp() override {
+		return _mementoHandler.init();
+	}
+};
+
+BENCHMARK_DEFINE_F(MementoHandlerBenchmark, markUndoDelta) (benchmark::State& state) {
+	createHistory((int)state.range(0), true);
+	for (auto _ : state) {
+		_mementoHandler.markUndo(0, "Layer 1", _volume, voxedit::MementoType::Modification, _modified);
+	}
+}
+
+BENCHMARK_DEFINE_F(MementoHandlerBenchmark, markUndoFull) (benchmark::State& state) {
+	createHistory((int)state.range(0), false);
+	for (auto _ : state) {
+		_mementoHandler.markUndo(0, "Layer 1", _volume);
+	}
+}
+
+BENCHMARK_DEFINE_F(MementoHandlerBenchmark, undoRedoDelta) (benchmark::State& state) {
+	createHistory((int)state.range(0), true);
+	for (auto _ : state) {
+		voxedit::MementoState s = _mementoHandler.undo();
+		voxedit::MementoData::applyDelta(s.data, _volume);
+		s = _mementoHandler.redo();
+		voxedit::MementoData::applyDelta(s.data, _volume);
+	}
+}
+
+BENCHMARK_DEFINE_F(MementoHandlerBenchmark, undoRedoFull) (benchmark::State& state) {
+	createHistory((int)state.range(0), false);
+	for (auto _ : state) {
+		voxedit::MementoState s = _mementoHandler.undo();
+		delete voxedit::MementoData::toVolume(s.data);
+		s = _mementoHandler.redo();
+		delete voxedit::MementoData::toVolume(s.data);
+	}
+}
+
+BENCHMARK_REGISTER_F(MementoHandlerBenchmark, markUndoDelta)->Arg(64)->Arg(128)->Unit(benchmark::kMicrosecond);
+BENCHMARK_REGISTER_F(MementoHandlerBenchmark, markUndoFull)->Arg(64)->Arg(128)->Unit(benchmark::kMicrosecond);
+BENCHMARK_REGISTER_F(MementoHandlerBenchmark, undoRedoDelta)->Arg(64)->Arg(128)->Unit(benchmark::kMicrosecond);
+BENCHMARK_REGISTER_F(MementoHandlerBenchmark, undoRedoFull)->Arg(64)->Arg(128)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -5,6 +5,7 @@
 #include "LayerManager.h"
 #include "core/String.h"
 #include "core/command/Command.h"
+#include "voxel/SparseVolume.h"
 #include "voxelutil/VolumeMerger.h"
 
 namespace voxedit {
@@ -402,6 +403,24 @@ int LayerManager::addLayer(const char *name, bool visible, voxel::RawVolume* vol
 	return -1;
 }
 
+int LayerManager::importSparseVolume(const char *name, bool visible, const voxel::SparseVolume* volume, const glm::ivec3& pivot) {
+	if (volume == nullptr) {
+		return -1;
+	}
+	// the renderer and the memento handler work on dense volumes - only allocate the used bounds
+	voxel::Region region(volume->mins(), volume->maxs());
+	if (volume->empty()) {
+		region = voxel::Region(volume->region().getLowerCorner(), volume->region().getLowerCorner());
+	}
+	voxel::RawVolume* v = new voxel::RawVolume(region);
+	volume->copyTo(v);
+	const int layerId = addLayer(name, visible, v, pivot);
+	if (layerId < 0) {
+		delete v;
+	}
+	return layerId;
+}
+
 bool LayerManager::activateLayer(int layerId, const char *name, bool visible, voxel::RawVolume* volume, const voxel::Region& region, const glm::ivec3& pivot) {
 	core_assert_always(layerId >= 0 && layerId < (int)_layers.size());
 	if (name == nullptr || name[0] == '\0') {
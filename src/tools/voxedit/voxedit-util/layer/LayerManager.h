@@ -10,6 +10,10 @@
 #include <set>
 #include <unordered_map>
 
+namespace voxel {
+class SparseVolume;
+}
+
 namespace voxedit {
 
 /**
@@ -61,6 +65,12 @@ public:
 	void lockLayer(int layerId, bool lock);
 	bool deleteLayer(int layerId, bool force = false);
 	int addLayer(const char *name, bool visible, voxel::RawVolume* volume, const glm::ivec3& pivot = glm::zero<glm::ivec3>());
+	/**
+	 * @brief Copies the voxels of a sparse volume into a new layer. The layers are always dense - the new
+	 * @c voxel::RawVolume covers the used bounds of the sparse volume and allocates the empty space within them.
+	 * @note Does not take over ownership of the given volume
+	 */
+	int importSparseVolume(const char *name, bool visible, const voxel::SparseVolume* volume, const glm::ivec3& pivot = glm::zero<glm::ivec3>());
 	bool activateLayer(int layerId, const char *name, bool visible, voxel::RawVolume* volume, const voxel::Region& region, const glm::ivec3& pivot = glm::zero<glm::ivec3>());
 	void addMetadata(int layerId, const LayerMetadata& metadata);
 	const LayerMetadata& metadata(int layerId) const;
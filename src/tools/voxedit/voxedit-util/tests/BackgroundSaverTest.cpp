@@ -0,0 +1,76 @@
+/**
+ * @file
+ */
+
+#include "core/tests/AbstractTest.h"
+#include "../BackgroundSaver.h"
+#include "voxelformat/Loader.h"
+#include "voxelformat/VoxelVolumes.h"
+#include "core/io/Filesystem.h"
+#include "voxel/MaterialColor.h"
+
+namespace voxedit {
+
+class BackgroundSaverTest: public core::AbstractTest {
+protected:
+	voxel::RawVolume _volume { voxel::Region(glm::ivec3(0), glm::ivec3(7)) };
+
+	void SetUp() override {
+		core::AbstractTest::SetUp();
+		ASSERT_TRUE(voxel::initDefaultMaterialColors());
+		_volume.setVoxel(1, 2, 3, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	}
+};
+
+TEST_F(BackgroundSaverTest, testSnapshotIsReused) {
+	BackgroundSaver saver;
+	const std::shared_ptr<voxel::RawVolume>& first = saver.snapshot(0, &_volume);
+	ASSERT_NE(nullptr, first.get());
+	EXPECT_NE(&_volume, first.get());
+	EXPECT_EQ(first, saver.snapshot(0, &_volume)) << "The layer was not modified - the snapshot should be reused";
+
+	_volume.setVoxel(0, 0, 0, voxel::createVoxel(voxel::VoxelType::Generic, 2));
+	saver.invalidate(0);
+	const std::shared_ptr<voxel::RawVolume>& second = saver.snapshot(0, &_volume);
+	EXPECT_NE(first, second);
+	EXPECT_TRUE(voxel::isAir(first->voxel(0, 0, 0).getMaterial())) << "The old snapshot must not see the modification";
+	EXPECT_EQ(2, second->voxel(0, 0, 0).getColor());
+}
+
+TEST_F(BackgroundSaverTest, testSave) {
+	BackgroundSaver saver;
+	util::IProgressMonitor monitor;
+	std::vector<BackgroundSaver::LayerSnapshot> layers;
+	layers.push_back(BackgroundSaver::LayerSnapshot{saver.snapshot(0, &_volume), "layer", true, glm::ivec3(0)});
+	ASSERT_TRUE(saver.save(std::move(layers), "backgroundsaver.vox", &monitor));
+	EXPECT_TRUE(saver.pending());
+	EXPECT_FALSE(saver.save({}, "backgroundsaver.vox")) << "A save job is already running";
+	ASSERT_TRUE(saver.wait());
+	EXPECT_FALSE(saver.pending());
+	EXPECT_DOUBLE_EQ(100.0, monitor.progress());
+
+	const io::FilePtr& file = io::filesystem()->open("backgroundsaver.vox");
+	ASSERT_TRUE(file->exists());
+	EXPECT_FALSE(io::filesystem()->open("backgroundsaver.tmp.vox")->exists()) << "The temporary file should have been renamed";
+	voxel::VoxelVolumes volumes;
+	ASSERT_TRUE(voxelformat::loadVolumeFormat(file, volumes));
+	ASSERT_EQ(1u, volumes.size());
+	EXPECT_FALSE(voxel::isAir(volumes[0].volume->voxel(1, 2, 3).getMaterial()));
+	delete volumes[0].volume;
+}
+
+TEST_F(BackgroundSaverTest, testPoll) {
+	BackgroundSaver saver;
+	bool saved = false;
+	EXPECT_FALSE(saver.poll(saved));
+	std::vector<BackgroundSaver::LayerSnapshot> layers;
+	layers.push_back(BackgroundSaver::LayerSnapshot{saver.snapshot(0, &_volume), "layer", true, glm::ivec3(0)});
+	ASSERT_TRUE(saver.save(std::move(layers), "backgroundsaverpoll.qb"));
+	while (!saver.poll(saved)) {
+	}
+	EXPECT_TRUE(saved);
+	EXPECT_FALSE(saver.poll(saved)) << "The result is only reported once";
+	EXPECT_EQ("backgroundsaverpoll.qb", saver.file());
+}
+
+}
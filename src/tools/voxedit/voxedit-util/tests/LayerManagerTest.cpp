@@ -5,6 +5,7 @@
 #include "core/tests/AbstractTest.h"
 #include "../layer/LayerManager.h"
 #include "voxel/RawVolume.h"
+#include "voxel/SparseVolume.h"
 
 namespace voxedit {
 
@@ -115,4 +116,28 @@ TEST_F(LayerManagerTest, testLockGroupVisit) {
 	EXPECT_EQ(_mgr.validLayers(), cnt) << "Not all lock-group layers were visited";
 }
 
+TEST_F(LayerManagerTest, testImportSparseVolume) {
+	struct VolumeCollector : public LayerListener {
+		std::vector<voxel::RawVolume*>& _volumes;
+		VolumeCollector(std::vector<voxel::RawVolume*>& volumes) : _volumes(volumes) {
+		}
+		void onLayerAdded(int layerId, const Layer& layer, voxel::RawVolume* volume, const voxel::Region& region) override {
+			_volumes.push_back(volume);
+		}
+	} collector(_volumes);
+	_mgr.registerListener(&collector);
+
+	voxel::SparseVolume sparse(voxel::Region(-100, 100));
+	sparse.setVoxel(-10, 2, 3, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	sparse.setVoxel(20, 5, 4, voxel::createVoxel(voxel::VoxelType::Generic, 2));
+	EXPECT_EQ(0, _mgr.importSparseVolume("sparse", true, &sparse));
+	_mgr.unregisterListener(&collector);
+	ASSERT_EQ(1u, _volumes.size());
+	const voxel::RawVolume* volume = _volumes.front();
+	EXPECT_EQ(voxel::Region(glm::ivec3(-10, 2, 3), glm::ivec3(20, 5, 4)), volume->region()) << "Only the used part should be allocated";
+	EXPECT_EQ(1, volume->voxel(-10, 2, 3).getColor());
+	EXPECT_EQ(2, volume->voxel(20, 5, 4).getColor());
+	EXPECT_TRUE(voxel::isAir(volume->voxel(0, 3, 3).getMaterial()));
+}
+
 }
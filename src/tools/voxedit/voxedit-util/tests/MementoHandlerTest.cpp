@@ -17,6 +17,23 @@ protected:
 		EXPECT_EQ(size, region.getWidthInVoxels());
 		return std::make_shared<voxel::RawVolume>(region);
 	}
+	static void fill(voxel::RawVolume* volume, const voxel::Region& region, uint8_t color) {
+		const glm::ivec3& mins = region.getLowerCorner();
+		const glm::ivec3& maxs = region.getUpperCorner();
+		for (int32_t z = mins.z; z <= maxs.z; ++z) {
+			for (int32_t y = mins.y; y <= maxs.y; ++y) {
+				for (int32_t x = mins.x; x <= maxs.x; ++x) {
+					volume->setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, color));
+				}
+			}
+		}
+	}
+
+	static bool same(const voxel::RawVolume* a, const voxel::RawVolume* b) {
+		const size_t size = a->region().voxels() * sizeof(voxel::Voxel);
+		return a->region() == b->region() && memcmp(a->data(), b->data(), size) == 0;
+	}
+
 	void SetUp() override {
 		ASSERT_TRUE(mementoHandler.init());
 	}
@@ -661,4 +678,139 @@ TEST_F(MementoHandlerTest, testAddNewLayerEdit) {
 	EXPECT_FALSE(mementoHandler.canRedo());
 }
 
+TEST_F(MementoHandlerTest, testDeltaMemoryUsage) {
+	std::shared_ptr<voxel::RawVolume> volume = create(64);
+	mementoHandler.markUndo(0, "Layer 1", volume.get());
+	const voxel::Region region(glm::ivec3(2), glm::ivec3(5));
+	fill(volume.get(), region, 1);
+	mementoHandler.markUndo(0, "Layer 1", volume.get(), MementoType::Modification, region);
+	ASSERT_EQ(2u, mementoHandler.stateSize());
+	const MementoState& state = mementoHandler.state();
+	ASSERT_TRUE(state.data.isDelta());
+	EXPECT_EQ(region, state.data.region());
+	const size_t fullSize = volume->region().voxels() * sizeof(voxel::Voxel);
+	EXPECT_EQ(region.voxels() * sizeof(voxel::Voxel), state.data.size());
+	mementoHandler.waitForCompression();
+	// the copy of the last state of the layer is part of the memory usage, too
+	ASSERT_GE(mementoHandler.memoryUsage(), fullSize);
+	EXPECT_LT(mementoHandler.memoryUsage() - fullSize, fullSize / 16u) << "The compressed history should be much smaller than a single volume";
+}
+
+TEST_F(MementoHandlerTest, testDeltaUndoRedo) {
+	std::shared_ptr<voxel::RawVolume> volume = create(16);
+	mementoHandler.markUndo(0, "Layer 1", volume.get());
+	std::unique_ptr<voxel::RawVolume> initial(new voxel::RawVolume(volume.get()));
+	const voxel::Region region1(glm::ivec3(0), glm::ivec3(3));
+	fill(volume.get(), region1, 1);
+	mementoHandler.markUndo(0, "Layer 1", volume.get(), MementoType::Modification, region1);
+	std::unique_ptr<voxel::RawVolume> modified1(new voxel::RawVolume(volume.get()));
+	const voxel::Region region2(glm::ivec3(2), glm::ivec3(8));
+	fill(volume.get(), region2, 2);
+	mementoHandler.markUndo(0, "Layer 1", volume.get(), MementoType::Modification, region2);
+	std::unique_ptr<voxel::RawVolume> modified2(new voxel::RawVolume(volume.get()));
+	mementoHandler.waitForCompression();
+
+	MementoState state = mementoHandler.undo();
+	ASSERT_TRUE(state.data.isDelta());
+	EXPECT_EQ(region2, state.region);
+	EXPECT_EQ(7 * 7 * 7, MementoData::applyDelta(state.data, volume.get())) << "Only the changed voxels should be touched";
+	EXPECT_TRUE(same(modified1.get(), volume.get()));
+
+	state = mementoHandler.undo();
+	ASSERT_TRUE(state.data.isDelta());
+	EXPECT_EQ(4 * 4 * 4, MementoData::applyDelta(state.data, volume.get()));
+	EXPECT_TRUE(same(initial.get(), volume.get()));
+	EXPECT_FALSE(mementoHandler.canUndo());
+
+	state = mementoHandler.redo();
+	ASSERT_TRUE(state.data.isDelta());
+	MementoData::applyDelta(state.data, volume.get());
+	EXPECT_TRUE(same(modified1.get(), volume.get()));
+	state = mementoHandler.redo();
+	MementoData::applyDelta(state.data, volume.get());
+	EXPECT_TRUE(same(modified2.get(), volume.get()));
+
+	// the shadow copy of the layer must follow the undo and redo steps
+	state = mementoHandler.undo();
+	MementoData::applyDelta(state.data, volume.get());
+	const voxel::Region region3(glm::ivec3(10), glm::ivec3(11));
+	fill(volume.get(), region3, 3);
+	mementoHandler.markUndo(0, "Layer 1", volume.get(), MementoType::Modification, region3);
+	EXPECT_EQ(3u, mementoHandler.stateSize());
+	state = mementoHandler.undo();
+	MementoData::applyDelta(state.data, volume.get());
+	EXPECT_TRUE(same(modified1.get(), volume.get()));
+}
+
+TEST_F(MementoHandlerTest, testMemoryBudget) {
+	std::shared_ptr<voxel::RawVolume> volume = create(16);
+	fill(volume.get(), volume->region(), 1);
+	mementoHandler.markUndo(0, "Layer 1", volume.get());
+	mementoHandler.waitForCompression();
+	// the uncompressed copy of the last state of the layer
+	const size_t layerSize = volume->region().voxels() * sizeof(voxel::Voxel);
+	ASSERT_GE(mementoHandler.memoryUsage(), layerSize);
+	const size_t stateSize = mementoHandler.memoryUsage() - layerSize;
+	EXPECT_LT(stateSize, layerSize);
+	const size_t budget = layerSize + stateSize * 3u;
+	mementoHandler.setMemoryBudget(budget);
+	for (int i = 2; i < 10; ++i) {
+		fill(volume.get(), volume->region(), i);
+		mementoHandler.markUndo(0, "Layer 1", volume.get());
+	}
+	EXPECT_LE(mementoHandler.memoryUsage(), budget);
+	EXPECT_GE(mementoHandler.stateSize(), 2u);
+	EXPECT_LE(mementoHandler.stateSize(), 3u);
+	EXPECT_EQ(mementoHandler.stateSize() - 1u, mementoHandler.statePosition());
+}
+
+TEST_F(MementoHandlerTest, testEvictFullState) {
+	std::shared_ptr<voxel::RawVolume> volume = create(16);
+	mementoHandler.markUndo(0, "Layer 1", volume.get());
+	std::unique_ptr<voxel::RawVolume> firstDelta;
+	for (int i = 0; i < MementoHandler::MaxStates; ++i) {
+		const voxel::Region region(glm::ivec3(i % 16, 0, 0), glm::ivec3(i % 16, 1, 1));
+		fill(volume.get(), region, i + 1);
+		mementoHandler.markUndo(0, "Layer 1", volume.get(), MementoType::Modification, region);
+		if (i == 0) {
+			firstDelta.reset(new voxel::RawVolume(volume.get()));
+		}
+	}
+	ASSERT_EQ((size_t)MementoHandler::MaxStates, mementoHandler.stateSize());
+	// the delta that followed the evicted state must have become a full state
+	ASSERT_TRUE(mementoHandler.canUndo());
+	while (mementoHandler.canUndo()) {
+		const MementoState& state = mementoHandler.undo();
+		ASSERT_TRUE(state.data.isDelta());
+		ASSERT_GE(MementoData::applyDelta(state.data, volume.get()), 0);
+	}
+	const MementoState& first = mementoHandler.state();
+	ASSERT_FALSE(first.data.isDelta());
+	std::unique_ptr<voxel::RawVolume> v(MementoData::toVolume(first.data));
+	ASSERT_NE(nullptr, v.get());
+	EXPECT_TRUE(same(firstDelta.get(), v.get()));
+	EXPECT_TRUE(same(firstDelta.get(), volume.get()));
+}
+
+TEST_F(MementoHandlerTest, testDeltaUndoLargeVolume) {
+	std::shared_ptr<voxel::RawVolume> volume = create(128);
+	mementoHandler.markUndo(0, "Layer 1", volume.get());
+	std::unique_ptr<voxel::RawVolume> initial(new voxel::RawVolume(volume.get()));
+	const voxel::Region region(glm::ivec3(0), glm::ivec3(7));
+	fill(volume.get(), region, 1);
+	mementoHandler.markUndo(0, "Layer 1", volume.get(), MementoType::Modification, region);
+
+	const MementoState& state = mementoHandler.undo();
+	ASSERT_TRUE(state.data.isDelta());
+	EXPECT_EQ(8 * 8 * 8, MementoData::applyDelta(state.data, volume.get()));
+	EXPECT_TRUE(same(initial.get(), volume.get()));
+
+	mementoHandler.markUndo(0, "Layer 1", volume.get());
+	const MementoState& fullState = mementoHandler.undo();
+	ASSERT_FALSE(fullState.data.isDelta());
+	std::unique_ptr<voxel::RawVolume> v(MementoData::toVolume(fullState.data));
+	ASSERT_NE(nullptr, v.get());
+	EXPECT_TRUE(same(initial.get(), v.get()));
+}
+
 }